@@ -0,0 +1,21 @@
+local mod = Solution.Util.CreateModuleTable("Game-Bench", { "game-lib" })
+
+Solution.Util.CreateConsoleApp(mod.Name, Solution.Projects.Current.BinDir, mod.Dependencies, function()
+    local defines = { "_SILENCE_ALL_CXX17_DEPRECATION_WARNINGS", "_SILENCE_ALL_MS_EXT_DEPRECATION_WARNINGS" }
+    
+    Solution.Util.SetLanguage("C++")
+    Solution.Util.SetCppDialect(20)
+
+    local projFile = mod.Path .. "/" .. mod.Name .. ".lua"
+    local files = Solution.Util.GetFilesForCpp(mod.Path)
+    table.insert(files, projFile)
+
+    Solution.Util.SetFiles(files)
+    Solution.Util.SetIncludes(mod.Path)
+    Solution.Util.SetDefines(defines)
+
+    vpaths
+    {
+        ["/*"] = { "*.lua", mod.Name .. "/**" }
+    }
+end)
@@ -0,0 +1,190 @@
+#include "ModelBuildBench.h"
+
+#include "Game-Lib/Rendering/Model/ModelBuilder.h"
+#include "Game-Lib/Util/FrameTimeStats.h"
+
+#include <Base/Util/DebugHandler.h>
+#include <Base/Util/Timer.h>
+
+#include <FileFormat/Novus/Model/ComplexModel.h>
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Bench
+{
+    struct ModelBuildBenchSettings
+    {
+    public:
+        u32 gridSize = 127; // Every cell has its own four vertices, 127 is the largest grid u16 indices can address
+        u32 numIterations = 20;
+        u32 seed = 1;
+    };
+
+    static Model::ComplexModel::Vertex MakeVertex(f32 x, f32 y, f32 z, u16 uv)
+    {
+        // Half positions first, like PackedModelVertex
+        u16 packed[12] = { glm::packHalf1x16(x), glm::packHalf1x16(y), glm::packHalf1x16(z), 0, uv, static_cast<u16>(uv >> 4) };
+
+        Model::ComplexModel::Vertex vertex;
+        static_assert(sizeof(vertex) == sizeof(packed));
+        std::memcpy(&vertex, packed, sizeof(vertex));
+
+        return vertex;
+    }
+
+    // A bumpy grid in one render batch where every cell has its own corners and the triangles come in shuffled, what the
+    // mesh optimizations have to work with on unoptimized exports
+    static Model::ComplexModel BuildModel(const ModelBuildBenchSettings& settings)
+    {
+        Model::ComplexModel model;
+
+        std::vector<std::array<u16, 3>> triangles;
+        for (u32 y = 0; y < settings.gridSize; y++)
+        {
+            for (u32 x = 0; x < settings.gridSize; x++)
+            {
+                u16 firstVertex = static_cast<u16>(model.vertices.size());
+                for (u32 corner = 0; corner < 4; corner++)
+                {
+                    u32 vertexX = x + (corner & 1);
+                    u32 vertexY = y + (corner >> 1);
+                    f32 height = std::sin(static_cast<f32>(vertexX) * 0.3f) * std::cos(static_cast<f32>(vertexY) * 0.2f) * 4.0f;
+
+                    model.vertices.push_back(MakeVertex(static_cast<f32>(vertexX), height, static_cast<f32>(vertexY), static_cast<u16>(vertexY * (settings.gridSize + 1) + vertexX)));
+                }
+
+                triangles.push_back({ firstVertex, static_cast<u16>(firstVertex + 2), static_cast<u16>(firstVertex + 1) });
+                triangles.push_back({ static_cast<u16>(firstVertex + 1), static_cast<u16>(firstVertex + 2), static_cast<u16>(firstVertex + 3) });
+            }
+        }
+
+        std::mt19937 random(settings.seed);
+        std::shuffle(triangles.begin(), triangles.end(), random);
+
+        for (const std::array<u16, 3>& triangle : triangles)
+        {
+            model.modelData.indices.insert(model.modelData.indices.end(), triangle.begin(), triangle.end());
+        }
+
+        Model::ComplexModel::Material material;
+        model.materials.push_back(material);
+
+        Model::ComplexModel::Texture texture;
+        texture.type = Model::ComplexModel::Texture::Type::None;
+        model.textures.push_back(texture);
+        model.textureIndexLookupTable.push_back(0);
+        model.textureTransformLookupTable.push_back(0);
+
+        Model::ComplexModel::TextureUnit textureUnit;
+        textureUnit.materialIndex = 0;
+        textureUnit.textureCount = 1;
+        textureUnit.textureIndexStart = 0;
+        textureUnit.textureTransformIndexStart = 0;
+
+        Model::ComplexModel::RenderBatch renderBatch;
+        renderBatch.vertexCount = static_cast<u32>(model.vertices.size());
+        renderBatch.indexCount = static_cast<u32>(model.modelData.indices.size());
+        renderBatch.textureUnits.push_back(textureUnit);
+        model.modelData.renderBatches.push_back(renderBatch);
+
+        model.modelHeader.numVertices = static_cast<u32>(model.vertices.size());
+        model.modelHeader.numIndices = static_cast<u32>(model.modelData.indices.size());
+        model.modelHeader.numRenderBatches = 1;
+        model.modelHeader.numOpaqueRenderBatches = 1;
+        model.modelHeader.numTextures = 1;
+        model.modelHeader.numTextureUnits = 1;
+        model.modelHeader.numMaterials = 1;
+
+        return model;
+    }
+
+    static bool Run(const Model::ComplexModel& model, const ModelLoading::ModelBuildOptions& buildOptions, const ModelBuildBenchSettings& settings, const std::string& timerName, Util::FrameTimeStats& stats)
+    {
+        Timer timer;
+        for (u32 iteration = 0; iteration < settings.numIterations; iteration++)
+        {
+            timer.Reset();
+            ModelLoading::ModelBuildResult result = ModelLoading::BuildPreparedModel("model-build-bench", model, buildOptions);
+            f32 buildMS = timer.GetLifeTime() * 1000.0f;
+
+            if (!result)
+            {
+                NC_LOG_ERROR("Game-Bench : {0} failed, {1}", timerName, result.error);
+                return false;
+            }
+
+            stats.AddSample(timerName, buildMS);
+        }
+
+        return true;
+    }
+
+    i32 RunModelBuildBench(i32 argc, char* argv[])
+    {
+        ModelBuildBenchSettings settings;
+
+        for (i32 argumentIndex = 0; argumentIndex + 1 < argc; argumentIndex += 2)
+        {
+            std::string_view argument = argv[argumentIndex];
+            const char* value = argv[argumentIndex + 1];
+
+            if (argument == "-grid")
+                settings.gridSize = std::clamp(static_cast<u32>(std::strtoul(value, nullptr, 10)), 1u, 127u);
+            else if (argument == "-iterations")
+                settings.numIterations = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-seed")
+                settings.seed = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+
+        Model::ComplexModel model = BuildModel(settings);
+        u32 numTriangles = static_cast<u32>(model.modelData.indices.size() / 3);
+
+        NC_LOG_INFO("Game-Bench : Building a model of {0} triangles and {1} vertices {2} times per configuration", numTriangles, model.vertices.size(), settings.numIterations);
+
+        ModelLoading::ModelBuildOptions plainOptions;
+
+        ModelLoading::ModelBuildOptions optimizeOptions;
+        optimizeOptions.optimizeMeshes = true;
+
+        ModelLoading::ModelBuildOptions meshletOptions = optimizeOptions;
+        meshletOptions.buildMeshlets = true;
+
+        ModelLoading::ModelBuildOptions lodOptions = optimizeOptions;
+        lodOptions.numLods = MODEL_MAX_LODS;
+
+        Util::FrameTimeStats stats;
+        bool succeeded = Run(model, plainOptions, settings, "Build", stats);
+        succeeded &= Run(model, optimizeOptions, settings, "Build (optimized)", stats);
+        succeeded &= Run(model, meshletOptions, settings, "Build (optimized, meshlets)", stats);
+        succeeded &= Run(model, lodOptions, settings, "Build (optimized, LODs)", stats);
+
+        NC_LOG_INFO("{0:<44} {1:>10} {2:>10} {3:>10} {4:>10} {5:>10} {6:>12}", "Timer", "mean ms", "p50 ms", "p95 ms", "p99 ms", "max ms", "M tris/s");
+        for (const Util::FrameTimeStats::Summary& summary : stats.Summarize())
+        {
+            f32 trianglesPerSecond = summary.p50MS > 0.0f ? static_cast<f32>(numTriangles) / summary.p50MS / 1000.0f : 0.0f;
+            NC_LOG_INFO("{0:<44} {1:>10.3f} {2:>10.3f} {3:>10.3f} {4:>10.3f} {5:>10.3f} {6:>12.2f}", summary.name, summary.meanMS, summary.p50MS, summary.p95MS, summary.p99MS, summary.maxMS, trianglesPerSecond);
+        }
+
+        ModelLoading::ModelBuildResult lodResult = ModelLoading::BuildPreparedModel("model-build-bench", model, lodOptions);
+        if (lodResult)
+        {
+            const ModelLoading::PreparedRenderModel& prepared = lodResult.preparedModel;
+            for (u32 level = 0; level < prepared.numLods; level++)
+            {
+                NC_LOG_INFO("Game-Bench : LOD {0} has {1} triangles, error {2:.4f} of the model radius", level + 1, prepared.drawCalls[0].lods[level].indexCount / 3, prepared.lodErrors[level]);
+            }
+        }
+
+        return succeeded ? 0 : 1;
+    }
+}
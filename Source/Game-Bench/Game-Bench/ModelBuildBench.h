@@ -0,0 +1,11 @@
+#pragma once
+#include <Base/Types.h>
+
+namespace Bench
+{
+    // Builds prepared models from a large generated grid with shuffled triangles, once plain, once with the mesh optimizations
+    // and once each with meshlets and LODs on top, and reports the build times and triangle throughput of each.
+    //
+    // Usage: Game-Bench modelBuild [-grid N] [-iterations N] [-seed N]
+    i32 RunModelBuildBench(i32 argc, char* argv[]);
+}
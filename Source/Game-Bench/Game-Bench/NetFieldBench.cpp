@@ -0,0 +1,241 @@
+#include "NetFieldBench.h"
+
+#include "Game-Lib/ECS/Util/MessageBuilderUtil.h"
+#include "Game-Lib/ECS/Util/Network/NetFieldUpdate.h"
+#include "Game-Lib/Util/FrameTimeStats.h"
+
+#include <Base/Memory/Bytebuffer.h>
+#include <Base/Util/DebugHandler.h>
+#include <Base/Util/Timer.h>
+
+#include <Network/Define.h>
+
+#include <entt/entt.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace Bench
+{
+    struct NetFieldBenchSettings
+    {
+    public:
+        u32 numMessages = 20000;
+        u32 numRounds = 10;
+        u32 seed = 17;
+    };
+
+    enum class BenchField : u16 { };
+
+    using Fields = std::vector<std::pair<u16, u32>>;
+
+    static constexpr u32 NumUnits = 64;
+    static constexpr u32 MaxFieldID = 2040;
+
+    // Combat traffic: most updates touch a few health and power fields close together, some carry a wide spread
+    static Fields MakeBurstFields(std::mt19937& random)
+    {
+        std::uniform_int_distribution<u32> kindDistribution(0, 9);
+        std::uniform_int_distribution<u32> valueDistribution;
+
+        u16 first = 0;
+        u16 span = 0;
+        u32 numFields = 0;
+
+        if (kindDistribution(random) < 8)
+        {
+            first = static_cast<u16>(std::uniform_int_distribution<u32>(16, 48)(random));
+            span = 24;
+            numFields = std::uniform_int_distribution<u32>(1, 4)(random);
+        }
+        else
+        {
+            first = static_cast<u16>(std::uniform_int_distribution<u32>(0, 600)(random));
+            span = 700;
+            numFields = std::uniform_int_distribution<u32>(4, 24)(random);
+        }
+
+        std::vector<u16> fieldIDs;
+        while (fieldIDs.size() < numFields)
+        {
+            u16 fieldID = first + static_cast<u16>(std::uniform_int_distribution<u32>(0, span - 1)(random));
+            if (std::find(fieldIDs.begin(), fieldIDs.end(), fieldID) == fieldIDs.end())
+                fieldIDs.push_back(fieldID);
+        }
+        std::sort(fieldIDs.begin(), fieldIDs.end());
+
+        Fields fields;
+        for (u16 fieldID : fieldIDs)
+        {
+            fields.push_back({ fieldID, valueDistribution(random) });
+        }
+
+        return fields;
+    }
+
+    // Decodes like HandleOnUnitNetFieldUpdate, values go to fieldValues and the changes into the batch
+    static bool Decode(Bytebuffer& buffer, u32 unitIndex, std::vector<u32>& fieldValues, ECS::Util::Network::NetFieldChangeBatch<BenchField>& changes)
+    {
+        buffer.readData = 0;
+
+        ::Network::MessageHeader header;
+        ObjectGUID guid;
+        if (!buffer.Get(header) || !buffer.Deserialize(guid))
+            return false;
+
+        ECS::Util::Network::NetFieldMask fieldMask;
+        if (!fieldMask.Read(buffer))
+            return false;
+
+        entt::entity entity = static_cast<entt::entity>(unitIndex);
+
+        return fieldMask.ForEachField([&](u16 fieldID)
+        {
+            u32 data = 0;
+            if (!buffer.GetU32(data))
+                return false;
+
+            fieldValues[unitIndex * MaxFieldID + fieldID] = data;
+            changes.Add(entity, guid, static_cast<BenchField>(fieldID));
+            return true;
+        });
+    }
+
+    // What the handler did before, a mask vector per message and a second pass for the notifications
+    static bool DecodeTwoPass(Bytebuffer& buffer, u32 unitIndex, std::vector<u32>& fieldValues, std::vector<std::pair<u32, u16>>& changes)
+    {
+        buffer.readData = 0;
+
+        ::Network::MessageHeader header;
+        ObjectGUID guid;
+        u8 byteMaskOffset = 0;
+        u8 numMaskBytes = 0;
+        if (!buffer.Get(header) || !buffer.Deserialize(guid) || !buffer.GetU8(byteMaskOffset) || !buffer.GetU8(numMaskBytes))
+            return false;
+
+        std::vector<u8> maskBytes(numMaskBytes);
+        if (!buffer.GetBytes(maskBytes.data(), numMaskBytes))
+            return false;
+
+        for (u32 i = 0; i < numMaskBytes; i++)
+        {
+            u8 maskByte = maskBytes[i];
+            while (maskByte)
+            {
+                u16 bitIndex = static_cast<u16>(std::countr_zero(maskByte));
+                maskByte &= (maskByte - 1);
+
+                u32 data = 0;
+                if (!buffer.GetU32(data))
+                    return false;
+
+                fieldValues[unitIndex * MaxFieldID + (byteMaskOffset + i) * 8 + bitIndex] = data;
+            }
+        }
+
+        for (u32 i = 0; i < numMaskBytes; i++)
+        {
+            u8 maskByte = maskBytes[i];
+            while (maskByte)
+            {
+                u16 bitIndex = static_cast<u16>(std::countr_zero(maskByte));
+                maskByte &= (maskByte - 1);
+
+                changes.push_back({ unitIndex, static_cast<u16>((byteMaskOffset + i) * 8 + bitIndex) });
+            }
+        }
+
+        return true;
+    }
+
+    i32 RunNetFieldBench(i32 argc, char* argv[])
+    {
+        NetFieldBenchSettings settings;
+
+        for (i32 argumentIndex = 0; argumentIndex + 1 < argc; argumentIndex += 2)
+        {
+            std::string_view argument = argv[argumentIndex];
+            const char* value = argv[argumentIndex + 1];
+
+            if (argument == "-messages")
+                settings.numMessages = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-rounds")
+                settings.numRounds = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-seed")
+                settings.seed = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+
+        // Recorded up front so only the decoding is timed
+        std::mt19937 random(settings.seed);
+        std::vector<std::pair<u32, std::shared_ptr<Bytebuffer>>> burst;
+        burst.reserve(settings.numMessages);
+        for (u32 i = 0; i < settings.numMessages; i++)
+        {
+            u32 unitIndex = std::uniform_int_distribution<u32>(0, NumUnits - 1)(random);
+
+            std::shared_ptr<Bytebuffer> buffer = Bytebuffer::BorrowRuntime(2048);
+            if (!ECS::Util::MessageBuilder::Unit::BuildUnitNetFieldUpdateMessage(buffer, ObjectGUID::CreatePlayer(unitIndex + 1), MakeBurstFields(random)))
+            {
+                NC_LOG_ERROR("Game-Bench : Failed to build netfield message {0}", i);
+                return 1;
+            }
+
+            burst.push_back({ unitIndex, std::move(buffer) });
+        }
+
+        NC_LOG_INFO("Game-Bench : Decoding a burst of {0} netfield updates over {1} units {2} times per decoder", settings.numMessages, NumUnits, settings.numRounds);
+
+        std::vector<u32> fieldValues(NumUnits * MaxFieldID, 0);
+        std::vector<u32> twoPassFieldValues(NumUnits * MaxFieldID, 0);
+
+        ECS::Util::Network::NetFieldChangeBatch<BenchField> changes;
+        std::vector<std::pair<u32, u16>> twoPassChanges;
+
+        Util::FrameTimeStats stats;
+        Timer timer;
+        u32 numNotified = 0;
+
+        for (u32 round = 0; round < settings.numRounds; round++)
+        {
+            timer.Reset();
+            for (const auto& [unitIndex, buffer] : burst)
+            {
+                if (!Decode(*buffer, unitIndex, fieldValues, changes))
+                    return 1;
+            }
+            numNotified = 0;
+            changes.Flush([&numNotified](const auto&) { numNotified++; });
+            stats.AddSample("Decode burst (one pass)", timer.GetLifeTime() * 1000.0f);
+
+            timer.Reset();
+            twoPassChanges.clear();
+            for (const auto& [unitIndex, buffer] : burst)
+            {
+                if (!DecodeTwoPass(*buffer, unitIndex, twoPassFieldValues, twoPassChanges))
+                    return 1;
+            }
+            stats.AddSample("Decode burst (two pass)", timer.GetLifeTime() * 1000.0f);
+        }
+
+        NC_LOG_INFO("{0:<32} {1:>10} {2:>10} {3:>10} {4:>10} {5:>10} {6:>14}", "Timer", "mean ms", "p50 ms", "p95 ms", "p99 ms", "max ms", "M messages/s");
+        for (const Util::FrameTimeStats::Summary& summary : stats.Summarize())
+        {
+            f32 messagesPerSecond = summary.p50MS > 0.0f ? static_cast<f32>(settings.numMessages) / summary.p50MS / 1000.0f : 0.0f;
+            NC_LOG_INFO("{0:<32} {1:>10.3f} {2:>10.3f} {3:>10.3f} {4:>10.3f} {5:>10.3f} {6:>14.2f}", summary.name, summary.meanMS, summary.p50MS, summary.p95MS, summary.p99MS, summary.maxMS, messagesPerSecond);
+        }
+
+        // The decoders only count if they agree
+        if (fieldValues != twoPassFieldValues || numNotified != twoPassChanges.size())
+        {
+            NC_LOG_ERROR("Game-Bench : The one pass decoder disagrees with the two pass decoder, {0} notifications against {1}", numNotified, twoPassChanges.size());
+            return 1;
+        }
+
+        return 0;
+    }
+}
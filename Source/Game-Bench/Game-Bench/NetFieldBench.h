@@ -0,0 +1,11 @@
+#pragma once
+#include <Base/Types.h>
+
+namespace Bench
+{
+    // Decodes a recorded burst of combat netfield updates with the one pass NetFieldMask decoder and with the two pass
+    // decoder the handler used before, and reports the time per burst and message throughput of each.
+    //
+    // Usage: Game-Bench netField [-messages N] [-rounds N] [-seed N]
+    i32 RunNetFieldBench(i32 argc, char* argv[]);
+}
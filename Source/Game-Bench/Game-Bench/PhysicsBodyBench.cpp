@@ -0,0 +1,289 @@
+#include "PhysicsBodyBench.h"
+
+#include "Game-Lib/ECS/Singletons/JoltState.h"
+#include "Game-Lib/Util/PhysicsBodyBatcher.h"
+
+#include <Base/Util/DebugHandler.h>
+#include <Base/Util/Timer.h>
+
+#include <FileFormat/Shared.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/RegisterTypes.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace Bench
+{
+    struct PhysicsBodyBenchSettings
+    {
+    public:
+        u32 numBodies = 123000;
+        u32 bodiesPerFrame = 2000;
+        u32 batchSize = Util::PhysicsBodyBatcher::DEFAULT_MAX_BATCH_SIZE;
+        u32 numQueries = 20000;
+        u32 seed = 1;
+    };
+
+    struct BenchBody
+    {
+    public:
+        vec3 position;
+        u32 shapeIndex = 0;
+    };
+
+    struct QueryTimes
+    {
+    public:
+        f32 rayCastUS = 0.0f;
+        f32 boxQueryUS = 0.0f;
+        u32 numRayHits = 0;
+    };
+
+    struct RunResult
+    {
+    public:
+        f32 insertMS = 0.0f;
+        f32 maxInsertFrameMS = 0.0f;
+        f32 stepMS = 0.0f;
+        f32 optimizeMS = 0.0f;
+        f32 removeMS = 0.0f;
+        QueryTimes loadedQueries;
+        QueryTimes optimizedQueries;
+    };
+
+    static constexpr u32 NumShapes = 16;
+    static constexpr u32 NumClusters = 600;
+    static constexpr f32 ClusterRadius = 300.0f;
+
+    // Bodies arrive cluster by cluster the way placements arrive chunk by chunk
+    static std::vector<BenchBody> BuildBodies(const PhysicsBodyBenchSettings& settings, std::vector<vec3>& outClusterCenters)
+    {
+        std::mt19937 random(settings.seed);
+        std::uniform_real_distribution<f32> mapDistribution(-Terrain::MAP_HALF_SIZE * 0.9f, Terrain::MAP_HALF_SIZE * 0.9f);
+        std::uniform_real_distribution<f32> clusterDistribution(-ClusterRadius, ClusterRadius);
+        std::uniform_real_distribution<f32> heightDistribution(-20.0f, 60.0f);
+
+        outClusterCenters.resize(NumClusters);
+        for (vec3& center : outClusterCenters)
+        {
+            center = vec3(mapDistribution(random), 0.0f, mapDistribution(random));
+        }
+
+        std::vector<BenchBody> bodies(settings.numBodies);
+        for (u32 i = 0; i < settings.numBodies; i++)
+        {
+            const vec3& center = outClusterCenters[(static_cast<u64>(i) * NumClusters) / settings.numBodies];
+
+            BenchBody& body = bodies[i];
+            body.position = center + vec3(clusterDistribution(random), heightDistribution(random), clusterDistribution(random));
+            body.shapeIndex = random() % NumShapes;
+        }
+
+        return bodies;
+    }
+
+    static QueryTimes MeasureQueries(JPH::PhysicsSystem& physicsSystem, const std::vector<vec3>& clusterCenters, const PhysicsBodyBenchSettings& settings)
+    {
+        std::mt19937 random(settings.seed ^ 0x9e3779b9u);
+        std::uniform_real_distribution<f32> offsetDistribution(-ClusterRadius, ClusterRadius);
+
+        std::vector<vec3> points(settings.numQueries);
+        for (vec3& point : points)
+        {
+            point = clusterCenters[random() % clusterCenters.size()] + vec3(offsetDistribution(random), 0.0f, offsetDistribution(random));
+        }
+
+        QueryTimes times;
+        Timer timer;
+
+        for (const vec3& point : points)
+        {
+            JPH::RRayCast ray(JPH::RVec3(point.x, 500.0f, point.z), JPH::Vec3(0.0f, -1000.0f, 0.0f));
+            JPH::RayCastResult hit;
+            times.numRayHits += physicsSystem.GetNarrowPhaseQuery().CastRay(ray, hit);
+        }
+        times.rayCastUS = (timer.GetLifeTime() * 1000000.0f) / static_cast<f32>(points.size());
+
+        timer.Reset();
+        JPH::AllHitCollisionCollector<JPH::CollideShapeBodyCollector> collector;
+        for (const vec3& point : points)
+        {
+            collector.Reset();
+
+            JPH::AABox box(JPH::Vec3(point.x - 10.0f, -20.0f, point.z - 10.0f), JPH::Vec3(point.x + 10.0f, 60.0f, point.z + 10.0f));
+            physicsSystem.GetBroadPhaseQuery().CollideAABox(box, collector);
+        }
+        times.boxQueryUS = (timer.GetLifeTime() * 1000000.0f) / static_cast<f32>(points.size());
+
+        return times;
+    }
+
+    // batchSize 0 is the old path, every body is added on its own as soon as it is created
+    static RunResult Run(const std::vector<BenchBody>& bodies, const std::vector<vec3>& clusterCenters, const std::vector<JPH::ShapeRefC>& shapes, const PhysicsBodyBenchSettings& settings, u32 batchSize)
+    {
+        std::unique_ptr<ECS::Singletons::JoltState> joltState = std::make_unique<ECS::Singletons::JoltState>();
+        joltState->CreateJobSystem(nullptr);
+        joltState->physicsSystem.Init(Jolt::Settings::maxBodies, Jolt::Settings::numBodyMutexes, Jolt::Settings::maxBodyPairs, Jolt::Settings::maxContactConstraints, joltState->broadPhaseLayerInterface, joltState->objectVSBroadPhaseLayerFilter, joltState->objectVSObjectLayerFilter);
+
+        JPH::BodyInterface& bodyInterface = joltState->physicsSystem.GetBodyInterface();
+        Util::PhysicsBodyBatcher batcher;
+
+        std::vector<JPH::BodyID> bodyIDs;
+        bodyIDs.reserve(bodies.size());
+
+        RunResult result;
+        Timer timer;
+
+        // Body creation is the same for both paths and not part of the measurement
+        for (size_t frameStart = 0; frameStart < bodies.size(); frameStart += settings.bodiesPerFrame)
+        {
+            size_t frameEnd = std::min(frameStart + settings.bodiesPerFrame, bodies.size());
+            f32 frameInsertMS = 0.0f;
+
+            for (size_t i = frameStart; i < frameEnd; i++)
+            {
+                const BenchBody& benchBody = bodies[i];
+
+                JPH::BodyCreationSettings bodySettings(shapes[benchBody.shapeIndex], JPH::RVec3(benchBody.position.x, benchBody.position.y, benchBody.position.z), JPH::Quat::sIdentity(), JPH::EMotionType::Static, Jolt::Layers::NON_MOVING);
+                JPH::Body* body = bodyInterface.CreateBody(bodySettings);
+                if (!body)
+                    continue;
+
+                bodyIDs.push_back(body->GetID());
+
+                timer.Reset();
+                if (batchSize == 0)
+                    bodyInterface.AddBody(body->GetID(), JPH::EActivation::Activate);
+                else
+                    batcher.QueueAdd(body->GetID(), benchBody.position);
+                frameInsertMS += timer.GetLifeTime() * 1000.0f;
+            }
+
+            timer.Reset();
+            batcher.Flush(bodyInterface, JPH::EActivation::Activate, batchSize);
+            frameInsertMS += timer.GetLifeTime() * 1000.0f;
+
+            result.insertMS += frameInsertMS;
+            result.maxInsertFrameMS = std::max(result.maxInsertFrameMS, frameInsertMS);
+
+            // The game steps physics every frame, which is also where the broad phase tidies up after insertions
+            timer.Reset();
+            joltState->physicsSystem.Update(ECS::Singletons::JoltState::FixedDeltaTime, 1, &joltState->allocator, joltState->jobSystem.get());
+            result.stepMS += timer.GetLifeTime() * 1000.0f;
+        }
+
+        result.loadedQueries = MeasureQueries(joltState->physicsSystem, clusterCenters, settings);
+
+        timer.Reset();
+        joltState->physicsSystem.OptimizeBroadPhase();
+        result.optimizeMS = timer.GetLifeTime() * 1000.0f;
+
+        result.optimizedQueries = MeasureQueries(joltState->physicsSystem, clusterCenters, settings);
+
+        // Unload in the same frames the bodies were loaded in
+        for (size_t frameStart = 0; frameStart < bodyIDs.size(); frameStart += settings.bodiesPerFrame)
+        {
+            size_t frameEnd = std::min(frameStart + settings.bodiesPerFrame, bodyIDs.size());
+
+            timer.Reset();
+            for (size_t i = frameStart; i < frameEnd; i++)
+            {
+                batcher.QueueRemove(bodyIDs[i]);
+            }
+            batcher.Flush(bodyInterface, JPH::EActivation::Activate, batchSize);
+            result.removeMS += timer.GetLifeTime() * 1000.0f;
+        }
+
+        return result;
+    }
+
+    i32 RunPhysicsBodyBench(i32 argc, char* argv[])
+    {
+        PhysicsBodyBenchSettings settings;
+
+        for (i32 argumentIndex = 0; argumentIndex + 1 < argc; argumentIndex += 2)
+        {
+            std::string_view argument = argv[argumentIndex];
+            const char* value = argv[argumentIndex + 1];
+
+            if (argument == "-bodies")
+                settings.numBodies = static_cast<u32>(std::strtoul(value, nullptr, 10));
+            else if (argument == "-bodiesPerFrame")
+                settings.bodiesPerFrame = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-batchSize")
+                settings.batchSize = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-queries")
+                settings.numQueries = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-seed")
+                settings.seed = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+
+        settings.numBodies = std::min(settings.numBodies, Jolt::Settings::maxBodies);
+
+        JPH::RegisterDefaultAllocator();
+        JPH::Factory::sInstance = new JPH::Factory();
+        JPH::RegisterTypes();
+
+        std::vector<JPH::ShapeRefC> shapes(NumShapes);
+        for (u32 i = 0; i < NumShapes; i++)
+        {
+            f32 extent = 0.5f + static_cast<f32>(i) * 0.75f;
+            shapes[i] = new JPH::BoxShape(JPH::Vec3(extent, extent * 0.5f + 0.5f, extent));
+        }
+
+        std::vector<vec3> clusterCenters;
+        std::vector<BenchBody> bodies = BuildBodies(settings, clusterCenters);
+
+        NC_LOG_INFO("Game-Bench : Loading {0} static bodies, {1} per frame, batch size {2}, {3} queries", settings.numBodies, settings.bodiesPerFrame, settings.batchSize, settings.numQueries);
+
+        RunResult individual = Run(bodies, clusterCenters, shapes, settings, 0);
+        RunResult batched = Run(bodies, clusterCenters, shapes, settings, settings.batchSize);
+
+        NC_LOG_INFO("{0:<36} {1:>14} {2:>14}", "", "AddBody", "Batched");
+
+        auto logRow = [](const char* name, f32 individualValue, f32 batchedValue)
+        {
+            NC_LOG_INFO("{0:<36} {1:>14.3f} {2:>14.3f}", name, individualValue, batchedValue);
+        };
+
+        auto bodiesPerSecond = [&settings](f32 insertMS)
+        {
+            return insertMS > 0.0f ? static_cast<f32>(settings.numBodies) / (insertMS / 1000.0f) : 0.0f;
+        };
+
+        logRow("Insert total ms", individual.insertMS, batched.insertMS);
+        logRow("Insert bodies/s", bodiesPerSecond(individual.insertMS), bodiesPerSecond(batched.insertMS));
+        logRow("Insert worst frame ms", individual.maxInsertFrameMS, batched.maxInsertFrameMS);
+        logRow("Physics step total ms", individual.stepMS, batched.stepMS);
+        logRow("Ray cast us (loaded)", individual.loadedQueries.rayCastUS, batched.loadedQueries.rayCastUS);
+        logRow("Box query us (loaded)", individual.loadedQueries.boxQueryUS, batched.loadedQueries.boxQueryUS);
+        logRow("OptimizeBroadPhase ms", individual.optimizeMS, batched.optimizeMS);
+        logRow("Ray cast us (optimized)", individual.optimizedQueries.rayCastUS, batched.optimizedQueries.rayCastUS);
+        logRow("Box query us (optimized)", individual.optimizedQueries.boxQueryUS, batched.optimizedQueries.boxQueryUS);
+        logRow("Remove total ms", individual.removeMS, batched.removeMS);
+
+        // Both paths have to end up with the same bodies in the broad phase
+        bool sameHits = individual.loadedQueries.numRayHits == batched.loadedQueries.numRayHits && individual.optimizedQueries.numRayHits == batched.optimizedQueries.numRayHits;
+        if (!sameHits)
+        {
+            NC_LOG_ERROR("Game-Bench : Ray casts hit {0} bodies after adding them one by one but {1} after batching", individual.loadedQueries.numRayHits, batched.loadedQueries.numRayHits);
+        }
+
+        delete JPH::Factory::sInstance;
+        JPH::Factory::sInstance = nullptr;
+
+        return sameHits ? 0 : 1;
+    }
+}
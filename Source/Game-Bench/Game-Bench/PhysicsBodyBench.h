@@ -0,0 +1,11 @@
+#pragma once
+#include <Base/Types.h>
+
+namespace Bench
+{
+    // Loads a continent's worth of static bodies into a fresh physics system one frame at a time, once adding them one by one
+    // and once through Util::PhysicsBodyBatcher, and reports insertion throughput, query cost once loaded and removal cost.
+    //
+    // Usage: Game-Bench physics [-bodies N] [-bodiesPerFrame N] [-batchSize N] [-queries N] [-seed N]
+    i32 RunPhysicsBodyBench(i32 argc, char* argv[]);
+}
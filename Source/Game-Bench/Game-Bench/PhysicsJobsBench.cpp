@@ -0,0 +1,199 @@
+#include "PhysicsJobsBench.h"
+
+#include "Game-Lib/ECS/Singletons/JoltState.h"
+#include "Game-Lib/Util/FrameTimeStats.h"
+
+#include <Base/Util/DebugHandler.h>
+#include <Base/Util/Timer.h>
+
+#include <enkiTS/TaskScheduler.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/RegisterTypes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Bench
+{
+    struct PhysicsJobsBenchSettings
+    {
+    public:
+        u32 numBodies = 1600;
+        u32 numSteps = 600;
+        u32 numLoadTasks = 4;
+        u32 numLoadItems = 8192;
+        u32 numThreads = 0;
+        u32 seed = 1;
+    };
+
+    // Stands in for the animation and loader task sets, small partitions so the workers get to pick a new task often
+    struct LoadTask : public enki::ITaskSet
+    {
+    public:
+        LoadTask(u32 numItems) : enki::ITaskSet(numItems)
+        {
+            m_MinRange = 64;
+            results.resize(numItems);
+        }
+
+        void ExecuteRange(enki::TaskSetPartition range, u32 threadNum) override
+        {
+            for (u32 i = range.start; i < range.end; i++)
+            {
+                f32 value = static_cast<f32>(i);
+                for (u32 j = 0; j < 64; j++)
+                {
+                    value = std::sin(value) * 0.5f + std::cos(value * 1.5f);
+                }
+
+                results[i] = value;
+            }
+        }
+
+        std::vector<f32> results;
+    };
+
+    static constexpr u32 NumWarmupSteps = 30;
+    static constexpr u32 StackHeight = 4;
+    static constexpr f32 StackSpacing = 4.0f;
+
+    // Stacks of boxes on a floor that are not allowed to sleep, so every step does the same amount of work
+    static void BuildScene(JPH::BodyInterface& bodyInterface, const PhysicsJobsBenchSettings& settings)
+    {
+        JPH::BodyCreationSettings floorSettings(new JPH::BoxShape(JPH::Vec3(1000.0f, 1.0f, 1000.0f)), JPH::RVec3(0.0f, -1.0f, 0.0f), JPH::Quat::sIdentity(), JPH::EMotionType::Static, Jolt::Layers::NON_MOVING);
+        bodyInterface.CreateAndAddBody(floorSettings, JPH::EActivation::DontActivate);
+
+        std::mt19937 random(settings.seed);
+        std::uniform_real_distribution<f32> jitterDistribution(-0.1f, 0.1f);
+
+        JPH::ShapeRefC boxShape = new JPH::BoxShape(JPH::Vec3(0.5f, 0.5f, 0.5f));
+
+        u32 numStacks = (settings.numBodies + StackHeight - 1) / StackHeight;
+        u32 stacksPerRow = static_cast<u32>(std::ceil(std::sqrt(static_cast<f32>(numStacks))));
+
+        for (u32 i = 0; i < settings.numBodies; i++)
+        {
+            u32 stackIndex = i / StackHeight;
+            f32 x = (static_cast<f32>(stackIndex % stacksPerRow) - static_cast<f32>(stacksPerRow) * 0.5f) * StackSpacing;
+            f32 z = (static_cast<f32>(stackIndex / stacksPerRow) - static_cast<f32>(stacksPerRow) * 0.5f) * StackSpacing;
+            f32 y = 0.5f + static_cast<f32>(i % StackHeight) * 1.1f;
+
+            JPH::BodyCreationSettings bodySettings(boxShape, JPH::RVec3(x + jitterDistribution(random), y, z + jitterDistribution(random)), JPH::Quat::sIdentity(), JPH::EMotionType::Dynamic, Jolt::Layers::MOVING);
+            bodySettings.mAllowSleeping = false;
+
+            bodyInterface.CreateAndAddBody(bodySettings, JPH::EActivation::Activate);
+        }
+    }
+
+    static void Run(enki::TaskScheduler& taskScheduler, std::vector<std::unique_ptr<LoadTask>>& loadTasks, const PhysicsJobsBenchSettings& settings, bool useEnkiJobSystem, const std::string& timerName, Util::FrameTimeStats& stats)
+    {
+        std::unique_ptr<ECS::Singletons::JoltState> joltState = std::make_unique<ECS::Singletons::JoltState>();
+        joltState->CreateJobSystem(useEnkiJobSystem ? &taskScheduler : nullptr);
+        joltState->physicsSystem.Init(Jolt::Settings::maxBodies, Jolt::Settings::numBodyMutexes, Jolt::Settings::maxBodyPairs, Jolt::Settings::maxContactConstraints, joltState->broadPhaseLayerInterface, joltState->objectVSBroadPhaseLayerFilter, joltState->objectVSObjectLayerFilter);
+
+        BuildScene(joltState->physicsSystem.GetBodyInterface(), settings);
+        joltState->physicsSystem.OptimizeBroadPhase();
+
+        Timer timer;
+        for (u32 step = 0; step < NumWarmupSteps + settings.numSteps; step++)
+        {
+            for (std::unique_ptr<LoadTask>& loadTask : loadTasks)
+            {
+                taskScheduler.AddTaskSetToPipe(loadTask.get());
+            }
+
+            timer.Reset();
+            joltState->physicsSystem.Update(ECS::Singletons::JoltState::FixedDeltaTime, 1, &joltState->allocator, joltState->jobSystem.get());
+            f32 stepMS = timer.GetLifeTime() * 1000.0f;
+
+            timer.Reset();
+            for (std::unique_ptr<LoadTask>& loadTask : loadTasks)
+            {
+                taskScheduler.WaitforTask(loadTask.get());
+            }
+            f32 loadMS = timer.GetLifeTime() * 1000.0f;
+
+            if (step < NumWarmupSteps)
+                continue;
+
+            stats.AddSample(timerName, stepMS);
+            stats.AddSample(timerName + " load wait", loadMS);
+        }
+    }
+
+    i32 RunPhysicsJobsBench(i32 argc, char* argv[])
+    {
+        PhysicsJobsBenchSettings settings;
+
+        for (i32 argumentIndex = 0; argumentIndex + 1 < argc; argumentIndex += 2)
+        {
+            std::string_view argument = argv[argumentIndex];
+            const char* value = argv[argumentIndex + 1];
+
+            if (argument == "-bodies")
+                settings.numBodies = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-steps")
+                settings.numSteps = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-loadTasks")
+                settings.numLoadTasks = static_cast<u32>(std::strtoul(value, nullptr, 10));
+            else if (argument == "-loadItems")
+                settings.numLoadItems = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-threads")
+                settings.numThreads = static_cast<u32>(std::strtoul(value, nullptr, 10));
+            else if (argument == "-seed")
+                settings.seed = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+
+        settings.numBodies = std::min(settings.numBodies, Jolt::Settings::maxBodies - 1);
+
+        JPH::RegisterDefaultAllocator();
+        JPH::Factory::sInstance = new JPH::Factory();
+        JPH::RegisterTypes();
+
+        // Sized the way Application sizes it from numThreads
+        enki::TaskScheduler taskScheduler;
+        if (settings.numThreads == 0)
+        {
+            taskScheduler.Initialize();
+        }
+        else
+        {
+            taskScheduler.Initialize(settings.numThreads);
+        }
+
+        std::vector<std::unique_ptr<LoadTask>> loadTasks;
+        for (u32 i = 0; i < settings.numLoadTasks; i++)
+        {
+            loadTasks.push_back(std::make_unique<LoadTask>(settings.numLoadItems));
+        }
+
+        NC_LOG_INFO("Game-Bench : Stepping {0} dynamic bodies {1} times on {2} enkiTS threads with {3} load task sets of {4} items running alongside", settings.numBodies, settings.numSteps, taskScheduler.GetNumTaskThreads(), settings.numLoadTasks, settings.numLoadItems);
+
+        Util::FrameTimeStats stats;
+        Run(taskScheduler, loadTasks, settings, false, "Physics step (JobSystemThreadPool)", stats);
+        Run(taskScheduler, loadTasks, settings, true, "Physics step (enkiTS)", stats);
+
+        NC_LOG_INFO("{0:<44} {1:>10} {2:>10} {3:>10} {4:>10} {5:>10} {6:>10}", "Timer", "mean ms", "p50 ms", "p95 ms", "p99 ms", "max ms", "stddev ms");
+        for (const Util::FrameTimeStats::Summary& summary : stats.Summarize())
+        {
+            NC_LOG_INFO("{0:<44} {1:>10.3f} {2:>10.3f} {3:>10.3f} {4:>10.3f} {5:>10.3f} {6:>10.3f}", summary.name, summary.meanMS, summary.p50MS, summary.p95MS, summary.p99MS, summary.maxMS, summary.stddevMS);
+        }
+
+        taskScheduler.WaitforAllAndShutdown();
+
+        delete JPH::Factory::sInstance;
+        JPH::Factory::sInstance = nullptr;
+
+        return 0;
+    }
+}
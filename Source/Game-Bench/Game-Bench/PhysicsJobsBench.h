@@ -0,0 +1,11 @@
+#pragma once
+#include <Base/Types.h>
+
+namespace Bench
+{
+    // Steps a scene of awake dynamic bodies while enkiTS task sets keep the workers busy the way animation and the loaders do,
+    // once with Jolt's own JobSystemThreadPool and once with Util::JoltEnkiJobSystem, and reports how much the step time varies.
+    //
+    // Usage: Game-Bench physicsJobs [-bodies N] [-steps N] [-loadTasks N] [-loadItems N] [-threads N] [-seed N]
+    i32 RunPhysicsJobsBench(i32 argc, char* argv[]);
+}
@@ -0,0 +1,123 @@
+#include "SchedulerBench.h"
+
+#include "Game-Lib/Scripting/Handlers/SchedulerHandler.h"
+#include "Game-Lib/Util/FrameTimeStats.h"
+
+#include <Base/Util/DebugHandler.h>
+#include <Base/Util/Timer.h>
+
+#include <MetaGen/Game/Lua/Lua.h>
+
+#include <Scripting/LuaManager.h>
+#include <Scripting/Zenith.h>
+
+#include <lualib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace Bench
+{
+    struct SchedulerBenchSettings
+    {
+    public:
+        u32 numTimers = 100000;
+        u32 numIdleFrames = 1000;
+    };
+
+    i32 RunSchedulerBench(i32 argc, char* argv[])
+    {
+        SchedulerBenchSettings settings;
+
+        for (i32 argumentIndex = 0; argumentIndex + 1 < argc; argumentIndex += 2)
+        {
+            std::string_view argument = argv[argumentIndex];
+            const char* value = argv[argumentIndex + 1];
+
+            if (argument == "-timers")
+                settings.numTimers = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-frames")
+                settings.numIdleFrames = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+        }
+
+        Scripting::Scheduler::SchedulerHandler::Clock::time_point now = { };
+
+        Scripting::LuaManager luaManager;
+        luaManager.PrepareToAddLuaHandlers(static_cast<u16>(MetaGen::Game::Lua::LuaHandlerTypeEnum::Count));
+
+        Scripting::Scheduler::SchedulerHandler schedulerHandler;
+        schedulerHandler.SetClock([&now]() { return now; });
+        luaManager.SetLuaHandler(static_cast<Scripting::LuaHandlerID>(MetaGen::Game::Lua::LuaHandlerTypeEnum::Scheduler), &schedulerHandler);
+
+        Scripting::ZenithInfoKey key = Scripting::ZenithInfoKey::MakeGlobal(0, 0);
+        if (!luaManager.GetZenithStateManager().Add(key))
+        {
+            NC_LOG_ERROR("Game-Bench : Failed to create the Lua state");
+            return 1;
+        }
+
+        Scripting::Zenith* zenith = luaManager.GetZenithStateManager().Get(key);
+        zenith->SetState(luaL_newstate());
+        luaManager.GetZenithStateManager().Add(key, zenith->state);
+
+        zenith->RegisterDefaultLibraries();
+        zenith->PushLightUserData(&luaManager);
+        zenith->SetGlobalKey("Zenith");
+        schedulerHandler.Register(zenith);
+
+        // Every timer is an hour out, so the idle frames only ever look at the front of the queue
+        std::string source = "numTimers = " + std::to_string(settings.numTimers) + R"(
+            fired = 0
+            for i = 1, numTimers do
+                Scheduler.AfterSeconds(3600, function()
+                    fired += 1
+                end)
+            end
+        )";
+
+        Util::FrameTimeStats stats;
+        Timer timer;
+
+        timer.Reset();
+        if (!luaManager.DoString(zenith, source))
+        {
+            NC_LOG_ERROR("Game-Bench : Failed to schedule the timers");
+            return 1;
+        }
+        stats.AddSample("Schedule timers", timer.GetLifeTime() * 1000.0f);
+
+        for (u32 frame = 0; frame < settings.numIdleFrames; frame++)
+        {
+            now += std::chrono::seconds(1);
+
+            timer.Reset();
+            schedulerHandler.Update(zenith, 0.0f);
+            stats.AddSample("Update (nothing due)", timer.GetLifeTime() * 1000.0f);
+        }
+
+        now += std::chrono::hours(2);
+
+        timer.Reset();
+        schedulerHandler.Update(zenith, 0.0f);
+        stats.AddSample("Update (all due)", timer.GetLifeTime() * 1000.0f);
+
+        zenith->GetGlobalKey("fired");
+        u32 numFired = static_cast<u32>(zenith->Get<f64>(-1));
+        zenith->Pop();
+
+        NC_LOG_INFO("Game-Bench : {0} timers pending over {1} idle frames, {2} fired once due", settings.numTimers, settings.numIdleFrames, numFired);
+        NC_LOG_INFO("{0:<32} {1:>10} {2:>10} {3:>10} {4:>10} {5:>10}", "Timer", "mean ms", "p50 ms", "p95 ms", "p99 ms", "max ms");
+        for (const Util::FrameTimeStats::Summary& summary : stats.Summarize())
+        {
+            NC_LOG_INFO("{0:<32} {1:>10.3f} {2:>10.3f} {3:>10.3f} {4:>10.3f} {5:>10.3f}", summary.name, summary.meanMS, summary.p50MS, summary.p95MS, summary.p99MS, summary.maxMS);
+        }
+
+        schedulerHandler.Clear(zenith);
+        luaManager.GetZenithStateManager().Remove(key);
+
+        return numFired == settings.numTimers ? 0 : 1;
+    }
+}
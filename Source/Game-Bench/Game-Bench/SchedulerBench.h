@@ -0,0 +1,12 @@
+#pragma once
+#include <Base/Types.h>
+
+namespace Bench
+{
+    // Schedules a large number of Lua timers through the Scheduler handler, then reports how long registering them takes,
+    // how long a frame with nothing due takes while they are all pending, and how long the frame that fires them takes.
+    // AfterSeconds deadlines follow a fake clock that every idle frame moves one second forward.
+    //
+    // Usage: Game-Bench scheduler [-timers N] [-frames N]
+    i32 RunSchedulerBench(i32 argc, char* argv[]);
+}
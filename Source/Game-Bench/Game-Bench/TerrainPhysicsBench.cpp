@@ -0,0 +1,168 @@
+#include "TerrainPhysicsBench.h"
+
+#include "Game-Lib/Util/FrameTimeStats.h"
+#include "Game-Lib/Util/TerrainPhysicsUtil.h"
+
+#include <Base/Util/DebugHandler.h>
+#include <Base/Util/Timer.h>
+
+#include <FileFormat/Novus/Map/MapChunk.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/Shape/SubShapeID.h>
+#include <Jolt/RegisterTypes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace Bench
+{
+    struct TerrainPhysicsBenchSettings
+    {
+    public:
+        u32 numRays = 50000;
+        u32 numIterations = 20;
+        u32 seed = 42;
+    };
+
+    // Rolling hills over the whole chunk, every cell has its own inner and outer vertices like a real chunk
+    static std::unique_ptr<Map::Chunk> BuildChunk()
+    {
+        std::unique_ptr<Map::Chunk> chunk = std::make_unique<Map::Chunk>();
+
+        for (u32 cellID = 0; cellID < Terrain::CHUNK_NUM_CELLS; cellID++)
+        {
+            u32 cellX = cellID % Terrain::CHUNK_NUM_CELLS_PER_STRIDE;
+            u32 cellY = cellID / Terrain::CHUNK_NUM_CELLS_PER_STRIDE;
+
+            for (u32 vertexID = 0; vertexID < Terrain::CELL_TOTAL_GRID_SIZE; vertexID++)
+            {
+                u32 vertexX = vertexID % Terrain::CELL_GRID_ROW_SIZE;
+                u32 vertexY = vertexID / Terrain::CELL_GRID_ROW_SIZE;
+                bool isInner = vertexX >= Terrain::CELL_OUTER_GRID_STRIDE;
+
+                f32 gx = static_cast<f32>(cellX * Terrain::CELL_NUM_PATCHES_PER_STRIDE) + (isInner ? static_cast<f32>(vertexX - Terrain::CELL_OUTER_GRID_STRIDE) + 0.5f : static_cast<f32>(vertexX));
+                f32 gy = static_cast<f32>(cellY * Terrain::CELL_NUM_PATCHES_PER_STRIDE + vertexY) + (isInner ? 0.5f : 0.0f);
+
+                f32 x = gx * Terrain::PATCH_SIZE;
+                f32 z = -gy * Terrain::PATCH_SIZE;
+                chunk->cellsData.heightField[cellID][vertexID] = 12.0f * std::sin(x / 45.0f) + 8.0f * std::cos(z / 38.0f) + 0.01f * x;
+            }
+
+            chunk->cellsData.layerTextureIDs[cellID][0] = 1000 + ((cellX / 4) + (cellY / 4) * 4);
+        }
+
+        return chunk;
+    }
+
+    static u32 CastRays(const JPH::Shape& shape, const std::vector<JPH::RayCast>& rays)
+    {
+        u32 numHits = 0;
+        for (const JPH::RayCast& ray : rays)
+        {
+            JPH::RayCastResult hit;
+            numHits += shape.CastRay(ray, JPH::SubShapeIDCreator(), hit);
+        }
+
+        return numHits;
+    }
+
+    i32 RunTerrainPhysicsBench(i32 argc, char* argv[])
+    {
+        TerrainPhysicsBenchSettings settings;
+
+        for (i32 argumentIndex = 0; argumentIndex + 1 < argc; argumentIndex += 2)
+        {
+            std::string_view argument = argv[argumentIndex];
+            const char* value = argv[argumentIndex + 1];
+
+            if (argument == "-rays")
+                settings.numRays = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-iterations")
+                settings.numIterations = std::max(1u, static_cast<u32>(std::strtoul(value, nullptr, 10)));
+            else if (argument == "-seed")
+                settings.seed = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        }
+
+        JPH::RegisterDefaultAllocator();
+        JPH::Factory::sInstance = new JPH::Factory();
+        JPH::RegisterTypes();
+
+        std::unique_ptr<Map::Chunk> chunk = BuildChunk();
+
+        Util::FrameTimeStats stats;
+        Timer timer;
+
+        JPH::ShapeRefC meshShape;
+        JPH::ShapeRefC heightFieldShape;
+        for (u32 iteration = 0; iteration < settings.numIterations; iteration++)
+        {
+            timer.Reset();
+            meshShape = Util::TerrainPhysics::CreateMeshShape(*chunk);
+            stats.AddSample("Build (mesh)", timer.GetLifeTime() * 1000.0f);
+
+            timer.Reset();
+            heightFieldShape = Util::TerrainPhysics::CreateHeightFieldShape(*chunk);
+            stats.AddSample("Build (height field)", timer.GetLifeTime() * 1000.0f);
+        }
+
+        if (meshShape == nullptr || heightFieldShape == nullptr)
+        {
+            NC_LOG_ERROR("Game-Bench : Failed to build the terrain shapes");
+            return 1;
+        }
+
+        // Angled rays so the traversal has to walk more than one block
+        std::mt19937 random(settings.seed);
+        std::uniform_real_distribution<f32> positionDistribution(0.0f, Terrain::CHUNK_SIZE);
+        std::uniform_real_distribution<f32> slopeDistribution(-40.0f, 40.0f);
+
+        std::vector<JPH::RayCast> rays;
+        rays.reserve(settings.numRays);
+        for (u32 i = 0; i < settings.numRays; i++)
+        {
+            JPH::Vec3 origin(positionDistribution(random), 200.0f, -positionDistribution(random));
+            rays.push_back({ origin, JPH::Vec3(slopeDistribution(random), -400.0f, slopeDistribution(random)) });
+        }
+
+        u32 meshHits = 0;
+        u32 heightFieldHits = 0;
+        for (u32 iteration = 0; iteration < settings.numIterations; iteration++)
+        {
+            timer.Reset();
+            meshHits = CastRays(*meshShape, rays);
+            stats.AddSample("Ray casts (mesh)", timer.GetLifeTime() * 1000.0f);
+
+            timer.Reset();
+            heightFieldHits = CastRays(*heightFieldShape, rays);
+            stats.AddSample("Ray casts (height field)", timer.GetLifeTime() * 1000.0f);
+        }
+
+        NC_LOG_INFO("Game-Bench : Mesh shape {0} bytes, height field shape {1} bytes", meshShape->GetStats().mSizeBytes, heightFieldShape->GetStats().mSizeBytes);
+        NC_LOG_INFO("Game-Bench : {0} rays, {1} mesh hits, {2} height field hits", settings.numRays, meshHits, heightFieldHits);
+
+        NC_LOG_INFO("{0:<32} {1:>10} {2:>10} {3:>10} {4:>10} {5:>10} {6:>12}", "Timer", "mean ms", "p50 ms", "p95 ms", "p99 ms", "max ms", "M rays/s");
+        for (const Util::FrameTimeStats::Summary& summary : stats.Summarize())
+        {
+            bool isRayCast = summary.name.starts_with("Ray casts");
+            f32 raysPerSecond = isRayCast && summary.p50MS > 0.0f ? static_cast<f32>(settings.numRays) / summary.p50MS / 1000.0f : 0.0f;
+            NC_LOG_INFO("{0:<32} {1:>10.3f} {2:>10.3f} {3:>10.3f} {4:>10.3f} {5:>10.3f} {6:>12.2f}", summary.name, summary.meanMS, summary.p50MS, summary.p95MS, summary.p99MS, summary.maxMS, raysPerSecond);
+        }
+
+        meshShape = nullptr;
+        heightFieldShape = nullptr;
+
+        delete JPH::Factory::sInstance;
+        JPH::Factory::sInstance = nullptr;
+
+        return 0;
+    }
+}
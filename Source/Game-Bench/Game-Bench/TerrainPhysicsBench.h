@@ -0,0 +1,11 @@
+#pragma once
+#include <Base/Types.h>
+
+namespace Bench
+{
+    // Builds the collision of a generated terrain chunk once as a triangle mesh and once as a height field, and reports the
+    // size of each shape and how fast angled rays are cast against them.
+    //
+    // Usage: Game-Bench terrainPhysics [-rays N] [-iterations N] [-seed N]
+    i32 RunTerrainPhysicsBench(i32 argc, char* argv[]);
+}
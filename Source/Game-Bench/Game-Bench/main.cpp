@@ -0,0 +1,167 @@
+#include "ModelBuildBench.h"
+#include "NetFieldBench.h"
+#include "PhysicsBodyBench.h"
+#include "PhysicsJobsBench.h"
+#include "SchedulerBench.h"
+#include "TerrainPhysicsBench.h"
+
+#include "Game-Lib/Application/Application.h"
+#include "Game-Lib/ECS/Scheduler.h"
+#include "Game-Lib/Util/FakeServer.h"
+#include "Game-Lib/Util/FrameTimeStats.h"
+
+#include <Base/Types.h>
+#include <Base/Util/DebugHandler.h>
+#include <Base/Util/Timer.h>
+
+#include <quill/Backend.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+// Headless load test, spawns bots through an in process fake server and reports how long each ECS system takes. The fake
+// server only builds and queues messages, their handlers run inside NetworkConnection with the same coalescing and
+// per frame dispatch budget as a real connection, so they are part of that system's row.
+// Frames use a fixed deltaTime and run back to back so two runs with the same arguments do the same amount of work.
+// Headless models load their metadata, skeletons and shapes but nothing for the GPU, so the numbers cover Animation along
+// with the message handlers, unit entities, transforms, AABBs, physics, triggers and scripts, but no rendering.
+//
+// Usage: Game-Bench [-units N] [-spawnRate N] [-moveRate N] [-netFieldRate N] [-frames N] [-seed N]
+//        Game-Bench physics [...], see Bench::RunPhysicsBodyBench
+//        Game-Bench physicsJobs [...], see Bench::RunPhysicsJobsBench
+//        Game-Bench modelBuild [...], see Bench::RunModelBuildBench
+//        Game-Bench netField [...], see Bench::RunNetFieldBench
+//        Game-Bench terrainPhysics [...], see Bench::RunTerrainPhysicsBench
+//        Game-Bench scheduler [...], see Bench::RunSchedulerBench
+i32 main(i32 argc, char* argv[])
+{
+    std::setvbuf(stdout, nullptr, _IONBF, 0);
+    std::setvbuf(stderr, nullptr, _IONBF, 0);
+
+    quill::Backend::start();
+
+    auto console_sink = quill::Frontend::create_or_get_sink<quill::ConsoleSink>("console_sink_1", false);
+    quill::Logger* logger = quill::Frontend::create_or_get_logger("root", std::move(console_sink), "%(time:<16) LOG_%(log_level:<11) %(message)", "%H:%M:%S.%Qms", quill::Timezone::LocalTime, quill::ClockSourceType::System);
+
+    if (argc > 1 && std::string_view(argv[1]) == "physics")
+        return Bench::RunPhysicsBodyBench(argc - 2, argv + 2);
+
+    if (argc > 1 && std::string_view(argv[1]) == "physicsJobs")
+        return Bench::RunPhysicsJobsBench(argc - 2, argv + 2);
+
+    if (argc > 1 && std::string_view(argv[1]) == "modelBuild")
+        return Bench::RunModelBuildBench(argc - 2, argv + 2);
+
+    if (argc > 1 && std::string_view(argv[1]) == "netField")
+        return Bench::RunNetFieldBench(argc - 2, argv + 2);
+
+    if (argc > 1 && std::string_view(argv[1]) == "terrainPhysics")
+        return Bench::RunTerrainPhysicsBench(argc - 2, argv + 2);
+
+    if (argc > 1 && std::string_view(argv[1]) == "scheduler")
+        return Bench::RunSchedulerBench(argc - 2, argv + 2);
+
+    static constexpr f32 FixedDeltaTime = 1.0f / 60.0f;
+
+    Util::FakeServerSettings settings;
+    u32 numMeasuredFrames = 3600;
+
+    for (i32 argumentIndex = 1; argumentIndex + 1 < argc; argumentIndex += 2)
+    {
+        std::string_view argument = argv[argumentIndex];
+        const char* value = argv[argumentIndex + 1];
+
+        if (argument == "-units")
+            settings.numUnits = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        else if (argument == "-spawnRate")
+            settings.spawnsPerSecond = std::strtof(value, nullptr);
+        else if (argument == "-moveRate")
+            settings.movesPerSecond = std::strtof(value, nullptr);
+        else if (argument == "-netFieldRate")
+            settings.netFieldUpdatesPerSecond = std::strtof(value, nullptr);
+        else if (argument == "-frames")
+            numMeasuredFrames = static_cast<u32>(std::strtoul(value, nullptr, 10));
+        else if (argument == "-seed")
+            settings.seed = static_cast<u32>(std::strtoul(value, nullptr, 10));
+    }
+
+    Application app;
+    if (!app.StartHeadless())
+    {
+        NC_LOG_ERROR("Game-Bench : Failed to start the headless application");
+        return 1;
+    }
+
+    const ECS::SystemGraph& systemGraph = app.GetECSScheduler()->GetSystemGraph();
+    u32 numSystems = systemGraph.GetNumSystems();
+
+    Util::FakeServer fakeServer(settings);
+    Util::FrameTimeStats stats;
+
+    NC_LOG_INFO("Game-Bench : Spawning {0} units at {1}/s, {2} moves/s and {3} netfield updates/s per unit", settings.numUnits, settings.spawnsPerSecond, settings.movesPerSecond, settings.netFieldUpdatesPerSecond);
+    NC_LOG_INFO("Game-Bench : Models load without GPU data headless, skinning uploads and rendering are not part of these numbers");
+
+    Timer frameTimer;
+    Timer fakeServerTimer;
+
+    u32 numSpawnFrames = 0;
+    u32 numFrames = 0;
+    bool failed = false;
+
+    // Frames during the spawn ramp are run but not measured, the report only covers the steady state at full unit count
+    while (numFrames < numMeasuredFrames)
+    {
+        frameTimer.Reset();
+
+        fakeServerTimer.Reset();
+        if (!fakeServer.Update(FixedDeltaTime))
+        {
+            NC_LOG_ERROR("Game-Bench : Fake server built a message without a handler");
+            failed = true;
+            break;
+        }
+        f32 fakeServerTimeMS = fakeServerTimer.GetLifeTime() * 1000.0f;
+
+        if (!app.Tick(FixedDeltaTime))
+            break;
+
+        if (fakeServer.GetNumRejected() > 0)
+        {
+            NC_LOG_ERROR("Game-Bench : A handler rejected a fake server message");
+            failed = true;
+            break;
+        }
+
+        f32 frameTimeMS = frameTimer.GetLifeTime() * 1000.0f;
+
+        if (fakeServer.GetNumSpawned() < settings.numUnits)
+        {
+            numSpawnFrames++;
+            continue;
+        }
+
+        stats.AddSample("Frame", frameTimeMS);
+        stats.AddSample("FakeServer (Build Messages)", fakeServerTimeMS);
+
+        for (u32 i = 0; i < numSystems; i++)
+        {
+            const ECS::SystemGraph::SystemInfo& system = systemGraph.GetSystem(i);
+            stats.AddSample(system.name, system.lastDurationMS);
+        }
+
+        numFrames++;
+    }
+
+    NC_LOG_INFO("Game-Bench : {0} units, {1} spawn frames, {2} measured frames, {3} messages", fakeServer.GetNumSpawned(), numSpawnFrames, numFrames, fakeServer.GetNumMessagesSent());
+    NC_LOG_INFO("Game-Bench : {0} messages coalesced, {1} still queued behind the dispatch budget", fakeServer.GetNumCoalesced(), fakeServer.GetNumQueued());
+    NC_LOG_INFO("{0:<40} {1:>10} {2:>10} {3:>10} {4:>10} {5:>10}", "System", "mean ms", "p50 ms", "p95 ms", "p99 ms", "max ms");
+
+    for (const Util::FrameTimeStats::Summary& summary : stats.Summarize())
+    {
+        NC_LOG_INFO("{0:<40} {1:>10.3f} {2:>10.3f} {3:>10.3f} {4:>10.3f} {5:>10.3f}", summary.name, summary.meanMS, summary.p50MS, summary.p95MS, summary.p99MS, summary.maxMS);
+    }
+
+    app.Stop();
+    return failed ? 1 : 0;
+}
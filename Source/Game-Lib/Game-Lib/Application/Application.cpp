@@ -8,6 +8,8 @@
 #include "Game-Lib/ECS/Singletons/Database/CameraSaveSingleton.h"
 #include "Game-Lib/ECS/Singletons/Database/ClientDBSingleton.h"
 #include "Game-Lib/ECS/Singletons/Database/MapSingleton.h"
+#include "Game-Lib/ECS/Systems/Animation.h"
+#include "Game-Lib/ECS/Systems/UpdateAreaLights.h"
 #include "Game-Lib/ECS/Util/EventUtil.h"
 #include "Game-Lib/ECS/Util/Database/CameraUtil.h"
 #include "Game-Lib/ECS/Util/Database/CursorUtil.h"
@@ -26,6 +28,7 @@
 #include "Game-Lib/Input/InputPerformanceTest.h"
 #include "Game-Lib/Input/PenInput.h"
 #include "Game-Lib/Rendering/GameRenderer.h"
+#include "Game-Lib/Rendering/RenderSnapshot.h"
 #include "Game-Lib/Rendering/Model/ModelLoader.h"
 #include "Game-Lib/Rendering/Terrain/TerrainLoader.h"
 #include "Game-Lib/Scripting/Handlers/GlobalHandler.h"
@@ -45,6 +48,7 @@
 #include "Game-Lib/Util/AssetPath.h"
 #include "Game-Lib/Util/AssetWriter.h"
 #include "Game-Lib/Util/ClientDBUtil.h"
+#include "Game-Lib/Util/FramePipeline.h"
 #include "Game-Lib/Util/JoltMemoryTelemetry.h"
 #include "Game-Lib/Util/ServiceLocator.h"
 #include "Game-Lib/Util/TextureUtil.h"
@@ -84,6 +88,7 @@
 #include <filesystem>
 #include <limits>
 #include <xxhash/xxhash32.h>
+#include <xxhash/xxhash64.h>
 
 AutoCVar_Int CVAR_FramerateLimit(CVarCategory::Client, "framerateLimit", "enable framerate limit", 1, CVarFlags::EditCheckbox);
 AutoCVar_Int CVAR_IOFramerateLimit(CVarCategory::Client, "ioFramerateLimit", "enable framerate limit", 1, CVarFlags::EditCheckbox);
@@ -95,12 +100,24 @@ AutoCVar_Int CVAR_ClientDBSaveMethod(CVarCategory::Client, "clientDBSaveMethod",
 AutoCVar_Float CVAR_ClientDBSaveTimer(CVarCategory::Client, "clientDBSaveTimer", "specifies how often clientDBs are saved when using save method 1 (Specified in seconds, default is 5 seconds)", 5.0f);
 AutoCVar_String CVAR_ImguiTheme(CVarCategory::Client, "imguiTheme", "specifies the current imgui theme", "Blue Teal", CVarFlags::Hidden);
 AutoCVar_Int CVAR_DeveloperMode(CVarCategory::Client, "developerMode", "enables developer-only Luau APIs (Editor, Time) and dev-tool scripts under Resources/Scripts/Editor", 1, CVarFlags::EditCheckbox);
+AutoCVar_Int CVAR_PipelinedRendering(CVarCategory::Client | CVarCategory::Rendering, "pipelinedRendering", "records and presents each frame on a render thread while the next frame starts, adds one frame of latency", 0, CVarFlags::EditCheckbox);
 AutoCVar_Int CVAR_PhysicsLogJoltTraces(CVarCategory::Client | CVarCategory::Physics, "logJoltTraces", "logs trace output emitted by Jolt Physics", 0, CVarFlags::EditCheckbox);
 
 namespace
 {
     std::atomic_bool JoltTraceLoggingEnabled = false;
 
+    // Fills the handler slots that headless clients can't back with anything, it registers no functions
+    class HeadlessLuaHandler : public Scripting::LuaHandlerBase
+    {
+    private:
+        void Register(Scripting::Zenith* zenith) {}
+        void Clear(Scripting::Zenith* zenith) {}
+
+        void PostLoad(Scripting::Zenith* zenith) {}
+        void Update(Scripting::Zenith* zenith, f32 deltaTime) {}
+    };
+
     void JoltTrace(const char* format, ...)
     {
         if (!JoltTraceLoggingEnabled.load(std::memory_order_relaxed))
@@ -132,7 +149,9 @@ Application::~Application()
 {
     delete _imguiInputBridge;
     delete _penInput;
+    delete _framePipeline;
     delete _gameRenderer;
+    delete _headlessModelLoader;
     delete _editorHandler;
     delete _inputPerformanceTest;
     delete _inputActionSystem;
@@ -161,6 +180,17 @@ void Application::Start(bool startInSeparateThread, bool enableRenderDoc)
     }
 }
 
+bool Application::StartHeadless()
+{
+    if (_isRunning)
+        return false;
+
+    _headless = true;
+    _isRunning = Init(false);
+
+    return _isRunning;
+}
+
 void Application::Stop()
 {
     if (!_isRunning.exchange(false))
@@ -212,6 +242,9 @@ void Application::Cleanup()
             _gameRenderer->GetModelLoader()->Shutdown();
     }
 
+    if (_headlessModelLoader)
+        _headlessModelLoader->Shutdown();
+
     auto* pactStorage = ServiceLocator::GetPactStorage();
     if (!pactStorage->Shutdown())
         NC_LOG_ERROR("Application : PACT shutdown failed because file handles are still alive");
@@ -245,66 +278,135 @@ void Application::Run(bool enableRenderDoc)
         auto& engineStats = ctx.get<ECS::Singletons::EngineStats>();
 
         ECS::Singletons::FrameTimes timings;
+        _framePipeline = new Util::FramePipeline<RenderSnapshot>();
+
+        auto recordFrameTimings = [&](const ECS::Singletons::FrameTimes& frameTimings)
+        {
+            ZoneScopedN("TimeQueries");
+
+            // Get last GPU Frame time
+            Renderer::Renderer* renderer = _gameRenderer->GetRenderer();
+
+            f32 gpuFrameTimeMS = 0.0f;
+            const std::vector<Renderer::TimeQueryID> frameTimeQueries = renderer->GetFrameTimeQueries();
+            if (frameTimeQueries.size() > 0)
+            {
+                for (Renderer::TimeQueryID timeQueryID : frameTimeQueries)
+                {
+                    const std::string& name = renderer->GetTimeQueryName(timeQueryID);
+                    f32 durationMS = renderer->GetLastTimeQueryDuration(timeQueryID);
+
+                    engineStats.AddNamedStat(name, durationMS);
+                }
+
+                Renderer::TimeQueryID totalTimeQuery = frameTimeQueries[0];
+                gpuFrameTimeMS = renderer->GetLastTimeQueryDuration(totalTimeQuery);
+            }
+
+            engineStats.AddTimings(frameTimings.deltaTimeS, frameTimings.simulationFrameTimeS, frameTimings.renderFrameTimeS, frameTimings.renderWaitTimeS, gpuFrameTimeMS);
+        };
+
         while (!_exitRequested)
         {
             ZoneScoped;
             f32 deltaTime = timer.GetDeltaTime();
             timer.Tick();
 
+            // Switching modes happens while no frame is in flight, Stop lets the render thread finish the last one
+            bool pipelined = CVAR_PipelinedRendering.Get() == 1;
+            if (pipelined && !_framePipeline->IsRunning())
+            {
+                _framePipeline->Start("Render Thread", [this](RenderSnapshot& snapshot) { RenderPipelined(snapshot); });
+            }
+            else if (!pipelined && _framePipeline->IsRunning())
+            {
+                _framePipeline->Stop();
+            }
+
             timings.deltaTimeS = deltaTime;
 
             updateTimer.Reset();
             renderState.frameNumber++;
 
-            _inputSystem->BeginFrame();
-            _inputActionSystem->BeginFrame();
+            RenderSnapshot& snapshot = _framePipeline->GetSimulationFrame();
+            snapshot.ResetChanges();
+            renderState.snapshot = &snapshot;
 
-            bool shouldExit = !_gameRenderer->UpdateWindow(deltaTime);
-            if (shouldExit)
-                break;
-
-            if (!Tick(deltaTime))
-                break;
+            if (pipelined)
+            {
+                // Runs while the render thread records the previous frame. The simulation leaves its renderer changes in
+                // the snapshot and the render thread only reads the renderers and the finished ImGui frame, so input,
+                // ImGui and the renderers, EndTick handing them the snapshot included, wait for it below
+                if (!Simulate(deltaTime))
+                    break;
 
-            timings.simulationFrameTimeS = updateTimer.GetLifeTime();
-            renderTimer.Reset();
+                timings.simulationFrameTimeS = updateTimer.GetLifeTime();
 
-            ServiceLocator::GetGameConsole()->Render(deltaTime);
+                {
+                    ZoneScopedN("Wait For Render Thread");
+                    if (RenderSnapshot* renderedFrame = _framePipeline->WaitForRender())
+                    {
+                        recordFrameTimings(renderedFrame->timings);
+                    }
+                }
 
-            _editorHandler->DrawImGuiMenuBar(deltaTime);
+                renderTimer.Reset();
 
-            f32 timeSpentWaiting = 0.0f;
-            if (!Render(deltaTime, timeSpentWaiting))
-                break;
+                _inputSystem->BeginFrame();
+                _inputActionSystem->BeginFrame();
 
-            {
-                ZoneScopedN("TimeQueries");
-                timings.renderFrameTimeS = renderTimer.GetLifeTime() - timeSpentWaiting;
-                timings.renderWaitTimeS = timeSpentWaiting;
+                bool shouldExit = !_gameRenderer->UpdateWindow(deltaTime);
+                if (shouldExit)
+                    break;
 
-                // Get last GPU Frame time
-                Renderer::Renderer* renderer = _gameRenderer->GetRenderer();
+                // Input processed here reaches the simulation next frame, on top of the frame pipelining already adds
+                BeginImGuiFrame(deltaTime);
+                EndTick(deltaTime);
 
-                const std::vector<Renderer::TimeQueryID> frameTimeQueries = renderer->GetFrameTimeQueries();
-                if (frameTimeQueries.size() > 0)
-                {
-                    for (Renderer::TimeQueryID timeQueryID : frameTimeQueries)
-                    {
-                        const std::string& name = renderer->GetTimeQueryName(timeQueryID);
-                        f32 durationMS = renderer->GetLastTimeQueryDuration(timeQueryID);
+                ServiceLocator::GetGameConsole()->Render(deltaTime);
 
-                        engineStats.AddNamedStat(name, durationMS);
-                    }
+                _editorHandler->DrawImGuiMenuBar(deltaTime);
 
-                    Renderer::TimeQueryID totalTimeQuery = frameTimeQueries[0];
-                    timings.gpuFrameTimeMS = renderer->GetLastTimeQueryDuration(totalTimeQuery);
-                }
-                else
+                // Everything that builds the ImGui frame stays on this thread, the render thread only records and presents
+                _gameRenderer->EndImGuiFrame();
                 {
-                    timings.gpuFrameTimeMS = 0;
+                    ZoneScopedN("ImGui::UpdatePlatformWindows");
+                    ImGui::UpdatePlatformWindows();
                 }
 
-                engineStats.AddTimings(timings.deltaTimeS, timings.simulationFrameTimeS, timings.renderFrameTimeS, timings.renderWaitTimeS, timings.gpuFrameTimeMS);
+                snapshot.frameNumber = renderState.frameNumber;
+                snapshot.deltaTime = deltaTime;
+                snapshot.timings = timings;
+
+                _framePipeline->Submit();
+            }
+            else
+            {
+                _inputSystem->BeginFrame();
+                _inputActionSystem->BeginFrame();
+
+                bool shouldExit = !_gameRenderer->UpdateWindow(deltaTime);
+                if (shouldExit)
+                    break;
+
+                if (!Tick(deltaTime))
+                    break;
+
+                timings.simulationFrameTimeS = updateTimer.GetLifeTime();
+                renderTimer.Reset();
+
+                ServiceLocator::GetGameConsole()->Render(deltaTime);
+
+                _editorHandler->DrawImGuiMenuBar(deltaTime);
+
+                f32 timeSpentWaiting = 0.0f;
+                if (!Render(deltaTime, timeSpentWaiting))
+                    break;
+
+                timings.renderFrameTimeS = renderTimer.GetLifeTime() - timeSpentWaiting;
+                timings.renderWaitTimeS = timeSpentWaiting;
+
+                recordFrameTimings(timings);
             }
 
             {
@@ -324,6 +426,9 @@ void Application::Run(bool enableRenderDoc)
 
             FrameMark;
         }
+
+        // Lets the frame in flight finish before shutting down
+        _framePipeline->Stop();
     }
 
     Stop();
@@ -429,18 +534,28 @@ bool Application::Init(bool enableRenderDoc)
     Util::Texture::DiscoverAll();
     Util::ClientDB::DiscoverAll();
 
-    _gameRenderer = new GameRenderer(enableRenderDoc);
-    _penInput = new PenInput();
-    _penInput->Initialize(*_gameRenderer->GetWindow(), *_inputSystem);
-    _imguiInputBridge = new ImGuiInputBridge(*_inputSystem);
-
-    NC_LOG_INFO("EditorHandler : Initializing");
-    _editorHandler = new Editor::EditorHandler();
-    ServiceLocator::SetEditorHandler(_editorHandler);
-    NC_LOG_INFO("EditorHandler : Initialized");
+    if (!_headless)
+    {
+        _gameRenderer = new GameRenderer(enableRenderDoc);
+        _penInput = new PenInput();
+        _penInput->Initialize(*_gameRenderer->GetWindow(), *_inputSystem);
+        _imguiInputBridge = new ImGuiInputBridge(*_inputSystem);
+
+        NC_LOG_INFO("EditorHandler : Initializing");
+        _editorHandler = new Editor::EditorHandler();
+        ServiceLocator::SetEditorHandler(_editorHandler);
+        NC_LOG_INFO("EditorHandler : Initialized");
+    }
+    else
+    {
+        // Units still need their model metadata and skeletons to animate, the loader just has nothing to draw them with
+        _headlessModelLoader = new ModelLoader(nullptr, nullptr);
+        _headlessModelLoader->Init();
+        ServiceLocator::SetModelLoader(_headlessModelLoader);
+    }
 
     _ecsScheduler = new ECS::Scheduler();
-    _ecsScheduler->Init(_registries);
+    _ecsScheduler->Init(_registries, _headless);
 
     ServiceLocator::SetGameConsole(new GameConsole());
     _inputPerformanceTest = new InputPerformanceTest(*_inputSystem, *_inputActionSystem);
@@ -457,16 +572,30 @@ bool Application::Init(bool enableRenderDoc)
         _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Global, new Scripting::GlobalHandler());
         _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Event, new Scripting::EventHandler());
         _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Database, new Scripting::Database::DatabaseHandler());
-        _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::UI, new Scripting::UI::UIHandler());
         _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Game, new Scripting::Game::GameHandler());
         _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Unit, new Scripting::Unit::UnitHandler());
         _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Time, new Scripting::Time::TimeHandler());
         _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Scheduler, new Scripting::Scheduler::SchedulerHandler());
-        _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Camera, new Scripting::Camera::CameraHandler());
-        _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Map, new Scripting::Map::MapHandler());
-        _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Scene, new Scripting::Scene::SceneHandler());
-        _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Editor, new Scripting::Editor::EditorToolHandler());
-        _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Asset, new Scripting::Asset::AssetHandler());
+
+        if (_headless)
+        {
+            // These APIs drive the renderer, window or editor directly, scripts that use them fail to load instead of crashing
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::UI, new HeadlessLuaHandler());
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Camera, new HeadlessLuaHandler());
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Map, new HeadlessLuaHandler());
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Scene, new HeadlessLuaHandler());
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Editor, new HeadlessLuaHandler());
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Asset, new HeadlessLuaHandler());
+        }
+        else
+        {
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::UI, new Scripting::UI::UIHandler());
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Camera, new Scripting::Camera::CameraHandler());
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Map, new Scripting::Map::MapHandler());
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Scene, new Scripting::Scene::SceneHandler());
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Editor, new Scripting::Editor::EditorToolHandler());
+            _luaManager->SetLuaHandler((Scripting::LuaHandlerID)MetaGen::Game::Lua::LuaHandlerTypeEnum::Asset, new Scripting::Asset::AssetHandler());
+        }
 
         auto globalKey = Scripting::ZenithInfoKey::MakeGlobal(0, 0);
         _luaManager->GetZenithStateManager().Add(globalKey);
@@ -488,6 +617,29 @@ bool Application::Init(bool enableRenderDoc)
 bool Application::Tick(f32 deltaTime)
 {
     ZoneScoped;
+
+    if (_headless)
+    {
+        // Run advances the frame number for windowed clients, headless clients are ticked directly
+        auto& renderState = _registries.gameRegistry->ctx().get<ECS::Singletons::RenderState>();
+        renderState.frameNumber++;
+    }
+    else
+    {
+        BeginImGuiFrame(deltaTime);
+    }
+
+    if (!Simulate(deltaTime))
+        return false;
+
+    EndTick(deltaTime);
+    return true;
+}
+
+void Application::BeginImGuiFrame(f32 deltaTime)
+{
+    ZoneScoped;
+
     // Imgui New Frame
     {
         ZoneScopedN("_editorHandler->NewFrame");
@@ -520,6 +672,11 @@ bool Application::Tick(f32 deltaTime)
 
     _editorHandler->BeginImGui();
     _editorHandler->BeginEditor();
+}
+
+bool Application::Simulate(f32 deltaTime)
+{
+    ZoneScoped;
 
     MessageInbound message;
     while (_messagesInbound.try_dequeue(message))
@@ -597,9 +754,28 @@ bool Application::Tick(f32 deltaTime)
         _registries.eventOutgoingRegistry = temp;
     }
 
-    _editorHandler->Update(deltaTime);
+    return true;
+}
+
+void Application::EndTick(f32 deltaTime)
+{
+    ZoneScoped;
+
+    if (!_headless)
+    {
+        _editorHandler->Update(deltaTime);
+
+        // No frame is rendering in either mode here, so this is where the renderers get what the simulation left them
+        const RenderSnapshot& snapshot = *_registries.gameRegistry->ctx().get<ECS::Singletons::RenderState>().snapshot;
+        ECS::Systems::UpdateAreaLights::ApplyToRenderers(snapshot);
+        ECS::Systems::Animation::ApplyToRenderers(*_registries.gameRegistry, snapshot);
 
-    _gameRenderer->UpdateRenderers(deltaTime);
+        _gameRenderer->UpdateRenderers(deltaTime);
+    }
+    else
+    {
+        _headlessModelLoader->Update(deltaTime);
+    }
 
     if (CVarSystem::Get()->IsDirty())
     {
@@ -628,8 +804,6 @@ bool Application::Tick(f32 deltaTime)
             saveClientDBTimer -= maxClientDBTimer;
         }
     }
-
-    return true;
 }
 
 bool Application::Render(f32 deltaTime, f32& timeSpentWaiting)
@@ -649,6 +823,23 @@ bool Application::Render(f32 deltaTime, f32& timeSpentWaiting)
     return true;
 }
 
+void Application::RenderPipelined(RenderSnapshot& snapshot)
+{
+    ZoneScoped;
+
+    Timer renderTimer;
+
+    // The ImGui frame and its platform windows were finished on the simulation thread before the snapshot was submitted
+    f32 timeSpentWaiting = _gameRenderer->Render(false);
+    {
+        ZoneScopedN("ImGui::RenderPlatformWindowsDefault");
+        ImGui::RenderPlatformWindowsDefault();
+    }
+
+    snapshot.timings.renderFrameTimeS = renderTimer.GetLifeTime() - timeSpentWaiting;
+    snapshot.timings.renderWaitTimeS = timeSpentWaiting;
+}
+
 void Application::DatabaseReload()
 {
     NC_LOG_INFO("Application : Database Reload Init");
@@ -692,6 +883,8 @@ void Application::SaveCDB()
             return;
         }
 
+        // Matches what DiscoverAll hashes on the next boot, so lookup snapshots built from the saved data stay valid
+        clientDBSingleton.SetContentHash(dbHash, XXHash64::hash(buffer->GetDataPointer(), buffer->writtenData, 0));
         db->ClearDirty();
     });
 }
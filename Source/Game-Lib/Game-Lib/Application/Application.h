@@ -20,6 +20,7 @@ class InputSystem;
 class PenInput;
 class GameRenderer;
 class ModelLoader;
+struct RenderSnapshot;
 
 namespace enki
 {
@@ -36,6 +37,9 @@ namespace Scripting
 namespace Util
 {
     class AssetWriter;
+
+    template <typename Frame>
+    class FramePipeline;
 }
 
 class Application
@@ -45,6 +49,9 @@ public:
     ~Application();
 
     void Start(bool startInSeparateThread, bool enableRenderDoc = false);
+
+    // Initializes on the calling thread without a window, renderer, ImGui or editor, the caller drives Tick
+    bool StartHeadless();
     void Stop();
     void RequestExit();
 
@@ -52,13 +59,24 @@ public:
     bool TryGetMessageOutbound(MessageOutbound& message);
 
     bool IsRunning() { return _isRunning; }
+    bool IsHeadless() const { return _headless; }
     bool Tick(f32 deltaTime);
 
+    const ECS::Scheduler* GetECSScheduler() const { return _ecsScheduler; }
+
 private:
     void Run(bool enableRenderDoc);
 
     bool Init(bool enableRenderDoc);
+
+    // Tick is these three in order. Pipelined rendering runs Simulate while the render thread records the previous frame
+    // and the other two once it is done, since they touch ImGui and the renderers
+    void BeginImGuiFrame(f32 deltaTime);
+    bool Simulate(f32 deltaTime);
+    void EndTick(f32 deltaTime);
+
     bool Render(f32 deltaTime, f32& timeSpentWaiting);
+    void RenderPipelined(RenderSnapshot& snapshot);
 
     void DatabaseReload();
     void SaveCDB();
@@ -68,6 +86,7 @@ private:
 private:
     std::atomic_bool _isRunning = false;
     std::atomic_bool _exitRequested = false;
+    bool _headless = false;
 
     InputSystem* _inputSystem = nullptr;
     InputActionSystem* _inputActionSystem = nullptr;
@@ -75,6 +94,8 @@ private:
     ImGuiInputBridge* _imguiInputBridge = nullptr;
     PenInput* _penInput = nullptr;
     GameRenderer* _gameRenderer = nullptr;
+    ModelLoader* _headlessModelLoader = nullptr;
+    Util::FramePipeline<RenderSnapshot>* _framePipeline = nullptr;
 
     Editor::EditorHandler* _editorHandler = nullptr;
 
@@ -1,5 +1,7 @@
 #pragma once
 #include "Game-Lib/Gameplay/Animation/Defines.h"
+#include "Game-Lib/Gameplay/Animation/Keyframes.h"
+#include "Game-Lib/Gameplay/Animation/LOD.h"
 
 #include <Base/Types.h>
 
@@ -34,6 +36,25 @@ namespace ECS
             std::vector<mat4x4> boneTransforms;
             std::vector<mat4x4> textureTransforms;
             std::vector<quat> proceduralRotationOffsets;
+
+            // Owned by the AnimationSingleton, shared by every instance of the model
+            const ::Animation::Keyframes::ModelTrackTimes* trackTimes = nullptr;
+
+            // Last sampled key per (bone, component) followed by one per (texture transform, component)
+            std::vector<u32> keyframeCursors;
+
+            ::Animation::LOD::State lodState;
+
+            // Depth of each bone in the skeleton, used to skip the deepest bones at reduced LOD
+            std::vector<u8> boneDepths;
+
+            // The last two evaluated poses, blended between on frames where the LOD skips evaluation
+            std::vector<mat4x4> lodPoseFrom;
+            std::vector<mat4x4> lodPoseTo;
+
+            // xorshift32 state for picking animation variations, kept per instance so units can be updated on any thread
+            // and still pick the same variations as a single threaded update would
+            u32 variationRandomState = 1;
         };
 
 
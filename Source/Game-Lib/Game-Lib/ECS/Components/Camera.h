@@ -31,6 +31,8 @@ namespace ECS::Components
         mat4x4 worldToView;
         mat4x4 worldToClip;
 
+        vec4 frustum[6] = { vec4(0.0f), vec4(0.0f), vec4(0.0f), vec4(0.0f), vec4(0.0f), vec4(0.0f) }; // Culling planes indexed by FrustumPlane, frozen while cameraLockCullingFrustum is set
+
         u32 cameraBindSlot = 0; // Which camera matrix slot this should bind to
     };
 }
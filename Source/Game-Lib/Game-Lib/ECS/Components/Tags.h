@@ -6,6 +6,7 @@ namespace ECS::Components
     struct SkyboxModelTag {};
     struct AnimatingTag {};
     struct UnitRebuildSkinTexture {};
+    struct UnitSkinTexturesLoading {};
     struct UnitRebuildGeosets {};
     struct LocalPlayerTag {};
     struct PlayerTag {};
@@ -5,6 +5,8 @@
 
 #include <Gameplay/GameDefine.h>
 
+#include <array>
+
 namespace ECS::Components
 {
     struct UnitComponentSectionsInUse
@@ -35,6 +37,23 @@ namespace ECS::Components
         u8 hasPantsDress : 1 = 0;
     };
 
+    // Slots in UnitCustomization::textureHashes and pendingTextureHashes, HairModel is bound to the model while the others are composited into the skin
+    namespace UnitCustomizationTexture
+    {
+        enum : u32
+        {
+            BaseSkin,
+            Bra,
+            Underwear,
+            FaceLower,
+            FaceUpper,
+            HairUpper,
+            HairLower,
+            HairModel,
+            Count
+        };
+    }
+
     struct UnitCustomization
     {
     public:
@@ -55,5 +74,8 @@ namespace ECS::Components
         UnitComponentSectionsInUse componentSectionsInUse;
 
         Renderer::TextureID skinTextureID = Renderer::TextureID::Invalid();
+        u64 skinTextureKey = 0; // SkinTextureDesc key of skinTextureID, the skin is shared with every unit that has the same one
+        std::array<u64, UnitCustomizationTexture::Count> textureHashes = {}; // Customization textures referenced in the TextureRenderer, 0 if unused
+        std::array<u64, UnitCustomizationTexture::Count> pendingTextureHashes = {}; // Referenced while they load, replace textureHashes once the skin is composited from them
     };
 }
\ No newline at end of file
@@ -15,5 +15,11 @@ namespace ECS::Components
         f32 displayedSpeed = 0.0f;
         bool hasSnapshot = false;
         bool hasRenderedPosition = false;
+
+        // The last ground sample and the position it was taken at, reused while the unit stays within an epsilon of it
+        vec3 groundQueryPos = vec3(0.0f);
+        vec3 groundPos = vec3(0.0f);
+        vec3 groundNormal = vec3(0.0f, 1.0f, 0.0f);
+        bool hasGroundSample = false;
     };
 }
@@ -1,15 +1,49 @@
 #include "Scheduler.h"
 
+#include "Game-Lib/ECS/Components/AABB.h"
+#include "Game-Lib/ECS/Components/AnimationData.h"
+#include "Game-Lib/ECS/Components/AttachmentData.h"
 #include "Game-Lib/ECS/Components/Camera.h"
+#include "Game-Lib/ECS/Components/CastInfo.h"
+#include "Game-Lib/ECS/Components/Container.h"
+#include "Game-Lib/ECS/Components/DebugRenderTransform.h"
+#include "Game-Lib/ECS/Components/Decal.h"
+#include "Game-Lib/ECS/Components/DisplayInfo.h"
+#include "Game-Lib/ECS/Components/DynamicMesh.h"
+#include "Game-Lib/ECS/Components/Events.h"
+#include "Game-Lib/ECS/Components/InteractionCapabilities.h"
+#include "Game-Lib/ECS/Components/Item.h"
+#include "Game-Lib/ECS/Components/KinematicMesh.h"
+#include "Game-Lib/ECS/Components/Model.h"
+#include "Game-Lib/ECS/Components/MovementInfo.h"
+#include "Game-Lib/ECS/Components/Name.h"
+#include "Game-Lib/ECS/Components/ProximityTrigger.h"
+#include "Game-Lib/ECS/Components/RemoteGroundVisualAlignment.h"
+#include "Game-Lib/ECS/Components/StaticMesh.h"
+#include "Game-Lib/ECS/Components/Tags.h"
+#include "Game-Lib/ECS/Components/Unit.h"
+#include "Game-Lib/ECS/Components/UnitAuraInfo.h"
+#include "Game-Lib/ECS/Components/UnitCustomization.h"
+#include "Game-Lib/ECS/Components/UnitEquipment.h"
+#include "Game-Lib/ECS/Components/UnitFaction.h"
+#include "Game-Lib/ECS/Components/UnitMovementOverTime.h"
+#include "Game-Lib/ECS/Components/UnitPowersComponent.h"
+#include "Game-Lib/ECS/Components/UnitResistancesComponent.h"
+#include "Game-Lib/ECS/Components/UnitStatsComponent.h"
 #include "Game-Lib/ECS/Singletons/ActiveCamera.h"
+#include "Game-Lib/ECS/Singletons/AnimationSingleton.h"
 #include "Game-Lib/ECS/Singletons/AreaLightInfo.h"
 #include "Game-Lib/ECS/Singletons/CharacterSingleton.h"
 #include "Game-Lib/ECS/Singletons/DayNightCycle.h"
 #include "Game-Lib/ECS/Singletons/EditorSelection.h"
 #include "Game-Lib/ECS/Singletons/EngineStats.h"
+#include "Game-Lib/ECS/Singletons/FreeflyingCameraSettings.h"
 #include "Game-Lib/ECS/Singletons/JoltState.h"
+#include "Game-Lib/ECS/Singletons/NetworkState.h"
+#include "Game-Lib/ECS/Singletons/OrbitalCameraSettings.h"
 #include "Game-Lib/ECS/Singletons/ProximityTriggerSingleton.h"
 #include "Game-Lib/ECS/Singletons/RenderState.h"
+#include "Game-Lib/ECS/Singletons/UISingleton.h"
 #include "Game-Lib/ECS/Systems/Animation.h"
 #include "Game-Lib/ECS/Systems/UpdateAreaLights.h"
 #include "Game-Lib/ECS/Systems/CalculateCameraMatrices.h"
@@ -31,8 +65,15 @@
 #include "Game-Lib/ECS/Systems/UI/HandleInput.h"
 #include "Game-Lib/ECS/Systems/UI/UpdateBoundingRects.h"
 #include "Game-Lib/ECS/Util/EventUtil.h"
+#include "Game-Lib/ECS/Util/Transforms.h"
 #include "Game-Lib/Rendering/GameRenderer.h"
 #include "Game-Lib/Rendering/Model/ModelLoader.h"
+#include "Game-Lib/Util/ServiceLocator.h"
+
+#include <Base/CVarSystem/CVarSystem.h>
+
+#include <Gameplay/ECS/Components/ObjectFields.h>
+#include <Gameplay/ECS/Components/UnitFields.h>
 
 #include <Renderer/RenderSettings.h>
 
@@ -40,16 +81,42 @@
 
 #include <tracy/Tracy.hpp>
 
+AutoCVar_Int CVAR_ECSSchedulerSerial(CVarCategory::Client, "ecsSchedulerSerial", "run ECS systems one after another on the main thread in registration order instead of as enkiTS tasks", 0, CVarFlags::EditCheckbox);
+
 namespace ECS
 {
+    // Every game system reads the structure of the game registry, systems that create/destroy entities or
+    // emplace/remove components write it and are therefore ordered against everything else touching the registry
+    static SystemAccess GameSystem()
+    {
+        SystemAccess access;
+        access.Read<Resources::GameRegistryStructure>();
+        return access;
+    }
+
+    static SystemAccess UISystem()
+    {
+        SystemAccess access;
+        access.Read<Resources::UIRegistryStructure>();
+        return access;
+    }
+
+    template <typename... T>
+    static void CreateStorages(entt::registry& registry)
+    {
+        (registry.storage<T>(), ...);
+    }
+
     Scheduler::Scheduler()
     {
 
     }
 
-    void Scheduler::Init(EnttRegistries& registries)
+    void Scheduler::Init(EnttRegistries& registries, bool headless)
     {
-        NC_LOG_INFO("ECS Scheduler : Initializing");
+        NC_LOG_INFO("ECS Scheduler : Initializing{0}", headless ? " (Headless)" : "");
+        _headless = headless;
+
         entt::registry& gameRegistry = *registries.gameRegistry;
 
         Systems::NetworkConnection::Init(gameRegistry);
@@ -63,7 +130,10 @@ namespace ECS
         Systems::UpdateScripts::Init(gameRegistry);
         Systems::UpdateDayNightCycle::Init(gameRegistry);
         Systems::UpdateAreaLights::Init(gameRegistry);
-        Systems::UpdateSkyboxes::Init(gameRegistry);
+
+        if (!_headless)
+            Systems::UpdateSkyboxes::Init(gameRegistry);
+
         Systems::Editor::EditorTools::Init(gameRegistry);
 
         entt::registry::context& ctx = gameRegistry.ctx();
@@ -76,58 +146,233 @@ namespace ECS
         entt::registry& uiRegistry = *registries.uiRegistry;
 
         Systems::UI::HandleInput::Init(uiRegistry);
+
+        // entt creates a storage the first time anything touches its component, which is not safe while systems run concurrently
+        CreateGameStorages(gameRegistry);
+
+        if (_headless)
+            RegisterHeadlessSystems(registries);
+        else
+            RegisterSystems(registries);
+
+        _systemGraph.Build();
+
         NC_LOG_INFO("ECS Scheduler : Initialized");
     }
 
+    void Scheduler::CreateGameStorages(entt::registry& registry)
+    {
+        // Every component the game systems view, emplace or remove. The ui registry needs none of this, all of its systems write UIRegistryStructure
+        CreateStorages<Components::Transform, Components::DirtyTransform, Components::AABB, Components::WorldAABB, Components::DirtyAABB>(registry);
+        CreateStorages<Components::Model, Components::ModelLoadedEvent, Components::ModelQueuedGeometryGroups, Components::SkyboxModelTag, Components::Decal, Components::DirtyDecal>(registry);
+        CreateStorages<Components::AnimationData, Components::AnimationInitData, Components::AnimationStaticInstance, Components::AnimatingTag, Components::AttachmentData>(registry);
+        CreateStorages<Components::Camera, Components::DebugRenderTransform, Components::StaticMesh, Components::KinematicMesh, Components::DynamicMesh, Components::ProximityTrigger>(registry);
+        CreateStorages<Components::Name, Components::Item, Components::Container, Components::InteractionCapabilities, Components::ObjectFields, Components::UnitFields>(registry);
+        CreateStorages<Components::Unit, Components::PlayerTag, Components::LocalPlayerTag, Components::DisplayInfo, Components::MovementInfo, Components::UnitMovementOverTime, Components::RemoteGroundVisualAlignment>(registry);
+        CreateStorages<Components::CastInfo, Components::UnitAuraInfo, Components::UnitFaction, Components::UnitPowersComponent, Components::UnitResistancesComponent, Components::UnitStatsComponent>(registry);
+        CreateStorages<Components::UnitCustomization, Components::UnitEquipment, Components::UnitEquipmentDirty, Components::UnitVisualEquipmentDirty>(registry);
+        CreateStorages<Components::UnitRebuildGeosets, Components::UnitRebuildSkinTexture, Components::UnitSkinTexturesLoading>(registry);
+    }
+
+    void Scheduler::RegisterSystems(EnttRegistries& registries)
+    {
+        entt::registry& gameRegistry = *registries.gameRegistry;
+        entt::registry& uiRegistry = *registries.uiRegistry;
+
+        // Registration order is the serial order, systems that share data keep this order when running in parallel.
+        // Only systems that create or destroy entities write GameRegistryStructure, emplacing/removing a component is declared as a write of that component
+
+        // Day/night cycle is a wall-clock-style timer: pass the unclamped deltaTime so
+        // the in-game time tracks real seconds 1:1. Clamping (as the rest of this
+        // function uses for physics/animation stability) makes the cycle drift behind
+        // wall-clock whenever the framerate dips below 60 FPS.
+        _systemGraph.AddSystem("UpdateDayNightCycle", GameSystem()
+            .Write<Singletons::DayNightCycle, Resources::Scripting>(),
+            [this, &gameRegistry](f32) { Systems::UpdateDayNightCycle::Update(gameRegistry, _unclampedDeltaTime); });
+
+        _systemGraph.AddSystem("NetworkConnection", GameSystem()
+            .Write<Resources::GameRegistryStructure, Resources::ModelLoader, Resources::MapLoader, Resources::DebugRenderer, Resources::Scripting, Resources::Physics, Resources::ClientDB>()
+            .Write<Singletons::NetworkState, Singletons::CharacterSingleton, Components::Transform>(),
+            [&gameRegistry](f32 deltaTime) { Systems::NetworkConnection::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("DrawDebugMesh", GameSystem()
+            .Read<Components::Transform, Components::DebugRenderTransform>()
+            .Write<Resources::DebugRenderer>(),
+            [&gameRegistry](f32 deltaTime) { Systems::DrawDebugMesh::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("Animation", GameSystem()
+            .Read<Components::Transform, Components::Camera, Singletons::ActiveCamera, Singletons::FreeflyingCameraSettings, Singletons::RenderState>()
+            .Write<Resources::GameRegistryStructure, Resources::ModelLoader, Resources::RenderSnapshot, Components::Model, Components::AnimationData, Components::AnimationInitData, Components::AnimationStaticInstance>()
+            .Write<Singletons::AnimationSingleton>(),
+            [&gameRegistry](f32 deltaTime) { Systems::Animation::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("CharacterController", GameSystem()
+            .Read<Resources::Input, Singletons::ActiveCamera, Singletons::NetworkState>()
+            .Write<Resources::GameRegistryStructure, Resources::ModelLoader, Resources::DebugRenderer, Resources::Physics, Components::Transform, Components::MovementInfo>()
+            .Write<Singletons::CharacterSingleton, Singletons::CharacterControllerSingleton, Singletons::JoltState>()
+            .MainThread(),
+            [&gameRegistry](f32 deltaTime) { Systems::CharacterController::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdateUnitEntities", GameSystem()
+            .Read<Resources::ClientDB, Resources::Physics, Singletons::JoltState, Singletons::CharacterSingleton, Singletons::RenderState>()
+            .Write<Resources::GameRegistryStructure, Resources::ModelLoader, Components::Transform, Components::Model, Components::AnimationData, Components::UnitCustomization>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdateUnitEntities::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("FreeflyingCamera", GameSystem()
+            .Read<Resources::Input, Singletons::ActiveCamera>()
+            .Write<Components::Transform, Components::Camera, Singletons::FreeflyingCameraSettings>()
+            .MainThread(),
+            [&gameRegistry](f32 deltaTime) { Systems::FreeflyingCamera::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("OrbitalCamera", GameSystem()
+            .Read<Resources::Input, Resources::Physics, Components::MovementInfo, Components::Unit, Singletons::ActiveCamera, Singletons::CharacterSingleton, Singletons::JoltState>()
+            .Write<Resources::GameRenderer, Components::Transform, Components::Camera, Singletons::OrbitalCameraSettings>()
+            .MainThread(),
+            [&gameRegistry](f32 deltaTime) { Systems::OrbitalCamera::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("CalculateCameraMatrices", GameSystem()
+            .Read<Resources::GameRenderer, Components::Transform, Singletons::ActiveCamera>()
+            .Write<Resources::RenderResources, Resources::Scripting, Components::Camera>(),
+            [&gameRegistry](f32 deltaTime) { Systems::CalculateCameraMatrices::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("CharacterControllerInput::UpdateHoveredUnit", GameSystem()
+            .Read<Resources::GameRenderer, Resources::Physics, Components::Transform, Components::Camera, Components::AABB, Components::WorldAABB, Components::Unit, Components::Model>()
+            .Read<Singletons::ActiveCamera, Singletons::NetworkState, Singletons::JoltState>()
+            .Write<Resources::ModelLoader, Resources::Input, Resources::Scripting, Singletons::CharacterSingleton>()
+            .MainThread(),
+            [&gameRegistry](f32 deltaTime) { Systems::CharacterControllerInput::UpdateHoveredUnit(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdateSkyboxes", GameSystem()
+            .Read<Singletons::ActiveCamera, Components::SkyboxModelTag>()
+            .Write<Components::Transform>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdateSkyboxes::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdateAreaLights", GameSystem()
+            .Read<Resources::ClientDB, Resources::MapLoader, Components::Transform, Singletons::ActiveCamera, Singletons::CharacterSingleton, Singletons::DayNightCycle, Singletons::FreeflyingCameraSettings, Singletons::RenderState>()
+            .Write<Resources::RenderSnapshot, Singletons::AreaLightInfo>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdateAreaLights::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("EditorTools", GameSystem()
+            .Write<Resources::GameRegistryStructure, Resources::GameRenderer, Resources::ModelLoader, Resources::DebugRenderer, Resources::Scripting, Resources::Input, Singletons::EditorSelection>()
+            .MainThread(),
+            [&gameRegistry](f32 deltaTime) { Systems::Editor::EditorTools::Update(gameRegistry, deltaTime); });
+
+        // Drains the transform queue every Transform writer pushes to, so it is ordered after all of them
+        _systemGraph.AddSystem("CalculateTransformMatrices", GameSystem()
+            .Read<Singletons::RenderState>()
+            .Write<Components::Transform, Components::DirtyTransform>(),
+            [&gameRegistry](f32 deltaTime) { Systems::CalculateTransformMatrices::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdateAABBs", GameSystem()
+            .Read<Components::Transform, Components::AABB, Components::DirtyTransform, Components::Unit>()
+            .Write<Components::WorldAABB, Components::DirtyAABB, Singletons::NetworkState>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdateAABBs::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdatePhysics", GameSystem()
+            .Write<Resources::Physics, Singletons::JoltState>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdatePhysics::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdateProximityTriggers", GameSystem()
+            .Read<Components::Transform, Components::AABB, Components::WorldAABB, Components::DirtyTransform, Components::LocalPlayerTag, Singletons::CharacterSingleton, Singletons::NetworkState>()
+            .Write<Resources::DebugRenderer, Resources::Scripting, Components::ProximityTrigger, Singletons::ProximityTriggerSingleton>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdateProximityTriggers::Update(gameRegistry, deltaTime); });
+
+        // Note: For now UpdateScripts should always be run last, scripts may touch anything so it writes everything it can reach
+        _systemGraph.AddSystem("UpdateScripts", GameSystem()
+            .Write<Resources::GameRegistryStructure, Resources::UIRegistryStructure, Resources::GameRenderer, Resources::ModelLoader, Resources::DebugRenderer, Resources::RenderResources, Resources::MapLoader, Resources::Scripting>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdateScripts::Update(gameRegistry, deltaTime); });
+
+        // UI, the ui registry is separate from the game registry so this chain only waits on systems sharing the renderer, input or Lua
+        _systemGraph.AddSystem("UI::UpdateBoundingRects", UISystem()
+            .Read<Resources::GameRenderer>()
+            .Write<Resources::UIRegistryStructure, Singletons::UISingleton>(),
+            [&uiRegistry](f32 deltaTime) { Systems::UI::UpdateBoundingRects::Update(uiRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UI::HandleInput", UISystem()
+            .Read<Resources::GameRenderer>()
+            .Write<Resources::UIRegistryStructure, Resources::DebugRenderer, Resources::Scripting, Resources::Input, Singletons::UISingleton>()
+            .MainThread(),
+            [&uiRegistry](f32 deltaTime) { Systems::UI::HandleInput::Update(uiRegistry, deltaTime); });
+
+        // Picks up entities added or moved by HandleInput, this is close to free when the transform queue is empty
+        _systemGraph.AddSystem("UI::UpdateBoundingRects (Post Input)", UISystem()
+            .Read<Resources::GameRenderer>()
+            .Write<Resources::UIRegistryStructure, Singletons::UISingleton>(),
+            [&uiRegistry](f32 deltaTime) { Systems::UI::UpdateBoundingRects::Update(uiRegistry, deltaTime); });
+    }
+
+    void Scheduler::RegisterHeadlessSystems(EnttRegistries& registries)
+    {
+        entt::registry& gameRegistry = *registries.gameRegistry;
+
+        // The simulation half of RegisterSystems with the same declared access. Cameras, editor and UI need a window and
+        // input to do anything, Animation only reads the camera FreeflyingCamera::Init leaves in place
+        _systemGraph.AddSystem("UpdateDayNightCycle", GameSystem()
+            .Write<Singletons::DayNightCycle, Resources::Scripting>(),
+            [this, &gameRegistry](f32) { Systems::UpdateDayNightCycle::Update(gameRegistry, _unclampedDeltaTime); });
+
+        _systemGraph.AddSystem("NetworkConnection", GameSystem()
+            .Write<Resources::GameRegistryStructure, Resources::ModelLoader, Resources::MapLoader, Resources::DebugRenderer, Resources::Scripting, Resources::Physics, Resources::ClientDB>()
+            .Write<Singletons::NetworkState, Singletons::CharacterSingleton, Components::Transform>(),
+            [&gameRegistry](f32 deltaTime) { Systems::NetworkConnection::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("Animation", GameSystem()
+            .Read<Components::Transform, Components::Camera, Singletons::ActiveCamera, Singletons::FreeflyingCameraSettings, Singletons::RenderState>()
+            .Write<Resources::GameRegistryStructure, Resources::ModelLoader, Resources::RenderSnapshot, Components::Model, Components::AnimationData, Components::AnimationInitData, Components::AnimationStaticInstance>()
+            .Write<Singletons::AnimationSingleton>(),
+            [&gameRegistry](f32 deltaTime) { Systems::Animation::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdateUnitEntities", GameSystem()
+            .Read<Resources::ClientDB, Resources::Physics, Singletons::JoltState, Singletons::CharacterSingleton, Singletons::RenderState>()
+            .Write<Resources::GameRegistryStructure, Resources::ModelLoader, Components::Transform, Components::Model, Components::AnimationData, Components::UnitCustomization>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdateUnitEntities::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("CalculateTransformMatrices", GameSystem()
+            .Read<Singletons::RenderState>()
+            .Write<Components::Transform, Components::DirtyTransform>(),
+            [&gameRegistry](f32 deltaTime) { Systems::CalculateTransformMatrices::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdateAABBs", GameSystem()
+            .Read<Components::Transform, Components::AABB, Components::DirtyTransform, Components::Unit>()
+            .Write<Components::WorldAABB, Components::DirtyAABB, Singletons::NetworkState>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdateAABBs::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdatePhysics", GameSystem()
+            .Write<Resources::Physics, Singletons::JoltState>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdatePhysics::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdateProximityTriggers", GameSystem()
+            .Read<Components::Transform, Components::AABB, Components::WorldAABB, Components::DirtyTransform, Components::LocalPlayerTag, Singletons::CharacterSingleton, Singletons::NetworkState>()
+            .Write<Resources::DebugRenderer, Resources::Scripting, Components::ProximityTrigger, Singletons::ProximityTriggerSingleton>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdateProximityTriggers::Update(gameRegistry, deltaTime); });
+
+        _systemGraph.AddSystem("UpdateScripts", GameSystem()
+            .Write<Resources::GameRegistryStructure, Resources::UIRegistryStructure, Resources::GameRenderer, Resources::ModelLoader, Resources::DebugRenderer, Resources::RenderResources, Resources::MapLoader, Resources::Scripting>(),
+            [&gameRegistry](f32 deltaTime) { Systems::UpdateScripts::Update(gameRegistry, deltaTime); });
+    }
+
     void Scheduler::Update(EnttRegistries& registries, f32 deltaTime)
     {
+        ZoneScopedN("ECS::Scheduler::Update");
+
         // Game
         entt::registry& gameRegistry = *registries.gameRegistry;
 
-        // TODO: You know, actually scheduling stuff and multithreading (enkiTS tasks?)
         entt::registry::context& ctx = gameRegistry.ctx();
         auto& joltState = ctx.get<Singletons::JoltState>();
 
         static constexpr f32 maxDeltaTimeDiff = 1.0f / 60.0f;
         f32 clampedDeltaTime = glm::clamp(deltaTime, 0.0f, maxDeltaTimeDiff);
+        _unclampedDeltaTime = deltaTime;
 
         joltState.updateTimer += glm::clamp(clampedDeltaTime, 0.0f, Singletons::JoltState::FixedDeltaTime);
 
-        // Day/night cycle is a wall-clock-style timer: pass the unclamped deltaTime so
-        // the in-game time tracks real seconds 1:1. Clamping (as the rest of this
-        // function uses for physics/animation stability) makes the cycle drift behind
-        // wall-clock whenever the framerate dips below 60 FPS.
-        Systems::UpdateDayNightCycle::Update(gameRegistry, deltaTime);
-        Systems::NetworkConnection::Update(gameRegistry, clampedDeltaTime);
-        Systems::DrawDebugMesh::Update(gameRegistry, clampedDeltaTime);
-        Systems::Animation::Update(gameRegistry, clampedDeltaTime);
-        Systems::CharacterController::Update(gameRegistry, clampedDeltaTime);
-        Systems::UpdateUnitEntities::Update(gameRegistry, clampedDeltaTime);
-        Systems::FreeflyingCamera::Update(gameRegistry, clampedDeltaTime);
-        Systems::OrbitalCamera::Update(gameRegistry, clampedDeltaTime);
-        Systems::CalculateCameraMatrices::Update(gameRegistry, clampedDeltaTime);
-        Systems::CharacterControllerInput::UpdateHoveredUnit(gameRegistry, clampedDeltaTime);
-        Systems::UpdateSkyboxes::Update(gameRegistry, clampedDeltaTime);
-        Systems::UpdateAreaLights::Update(gameRegistry, clampedDeltaTime);
-        Systems::Editor::EditorTools::Update(gameRegistry, clampedDeltaTime);
-        Systems::CalculateTransformMatrices::Update(gameRegistry, clampedDeltaTime);
-        Systems::UpdateAABBs::Update(gameRegistry, clampedDeltaTime);
-        Systems::UpdatePhysics::Update(gameRegistry, clampedDeltaTime);
-        Systems::UpdateProximityTriggers::Update(gameRegistry, clampedDeltaTime);
-
-        // Note: For now UpdateScripts should always be run last
-        Systems::UpdateScripts::Update(gameRegistry, clampedDeltaTime);
-        
+        bool serial = CVAR_ECSSchedulerSerial.Get() != 0;
+        _systemGraph.Execute(ServiceLocator::GetTaskScheduler(), clampedDeltaTime, serial);
+
         if (joltState.updateTimer >= Singletons::JoltState::FixedDeltaTime)
         {
             joltState.updateTimer -= Singletons::JoltState::FixedDeltaTime;
         }
-
-        // UI
-        entt::registry& uiRegistry = *registries.uiRegistry;
-
-        Systems::UI::UpdateBoundingRects::Update(uiRegistry, clampedDeltaTime);
-        Systems::UI::HandleInput::Update(uiRegistry, clampedDeltaTime);
-        Systems::UI::UpdateBoundingRects::Update(uiRegistry, clampedDeltaTime); // Run Twice to update any entities added during HandleInput::Update
     }
 }
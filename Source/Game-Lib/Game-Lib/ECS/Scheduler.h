@@ -1,4 +1,6 @@
 #pragma once
+#include "Game-Lib/ECS/SystemGraph.h"
+
 #include <Base/Types.h>
 
 #include <entt/fwd.hpp>
@@ -12,8 +14,20 @@ namespace ECS
     public:
         Scheduler();
 
-        void Init(EnttRegistries& registries);
+        // Headless skips every system that needs the GameRenderer, the window or ImGui
+        void Init(EnttRegistries& registries, bool headless = false);
         void Update(EnttRegistries& registries, f32 deltaTime);
 
+        const SystemGraph& GetSystemGraph() const { return _systemGraph; }
+
+    private:
+        void CreateGameStorages(entt::registry& registry);
+        void RegisterSystems(EnttRegistries& registries);
+        void RegisterHeadlessSystems(EnttRegistries& registries);
+
+    private:
+        SystemGraph _systemGraph;
+        f32 _unclampedDeltaTime = 0.0f;
+        bool _headless = false;
     };
 }
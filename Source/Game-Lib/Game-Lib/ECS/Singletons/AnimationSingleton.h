@@ -1,15 +1,19 @@
 #pragma once
 #include "Game-Lib/Gameplay/Animation/Defines.h"
+#include "Game-Lib/Gameplay/Animation/Keyframes.h"
 
 #include <entt/fwd.hpp>
 
 #include <robinhood/robinhood.h>
 
+#include <memory>
+
 namespace ECS::Singletons
 {
     struct AnimationSingleton
     {
     public:
         robin_hood::unordered_map<::Animation::Defines::ModelID, entt::entity> staticModelIDToEntity;
+        robin_hood::unordered_map<u64, std::unique_ptr<::Animation::Keyframes::ModelTrackTimes>> modelHashToTrackTimes;
     };
 }
\ No newline at end of file
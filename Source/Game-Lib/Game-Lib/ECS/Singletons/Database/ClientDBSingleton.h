@@ -163,6 +163,7 @@ namespace ECS
                 _dbHashToIndex.reserve(numDBs);
                 _dbIndexToHash.reserve(numDBs);
                 _dbHashToName.reserve(numDBs);
+                _dbHashToContentHash.reserve(numDBs);
             }
 
             // Preferred overload if T meets the requirements.
@@ -249,6 +250,7 @@ namespace ECS
                 _dbHashToIndex.erase(hash);
                 _dbIndexToHash.erase(index);
                 _dbHashToName.erase(hash);
+                _dbHashToContentHash.erase(hash);
                 return true;
             }
 
@@ -305,6 +307,26 @@ namespace ECS
                 }
             }
 
+            // Hash of the file the DB was read from, lets data derived from it be cached across boots
+            void SetContentHash(ClientDBHash hash, u64 contentHash)
+            {
+                _dbHashToContentHash[hash] = contentHash;
+            }
+
+            // Fails if the DB was never read from a file or has been modified since
+            bool TryGetContentHash(ClientDBHash hash, u64& contentHash)
+            {
+                if (!_dbHashToContentHash.contains(hash) || !_dbHashToIndex.contains(hash))
+                    return false;
+
+                ClientDB::Data* storage = _dbs[_dbHashToIndex[hash]];
+                if (!storage || storage->IsDirty())
+                    return false;
+
+                contentHash = _dbHashToContentHash[hash];
+                return true;
+            }
+
             const std::string& GetDBName(ClientDBHash hash)
             {
                 if (!_dbHashToName.contains(hash))
@@ -327,6 +349,7 @@ namespace ECS
             robin_hood::unordered_map<ClientDBHash, u32> _dbHashToIndex;
             robin_hood::unordered_map<u32, ClientDBHash> _dbIndexToHash;
             robin_hood::unordered_map<ClientDBHash, std::string> _dbHashToName;
+            robin_hood::unordered_map<ClientDBHash, u64> _dbHashToContentHash;
         };
     }
 }
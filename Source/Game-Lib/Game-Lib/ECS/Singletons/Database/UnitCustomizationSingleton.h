@@ -23,8 +23,6 @@ namespace ECS
             robin_hood::unordered_map<u32, std::vector<u32>> unitBaseCustomizationKeyToChoiceIDList;
 
             robin_hood::unordered_map<u32, u64> unitCustomizationKeyToTextureHash;
-            robin_hood::unordered_map<u32, Renderer::TextureID> unitCustomizationKeyToTextureID;
-            robin_hood::unordered_map<u32, Renderer::TextureID> customizationMaterialIDToTextureID;
             robin_hood::unordered_map<u64, Renderer::TextureID> itemTextureHashToTextureID;
 
             robin_hood::unordered_map<u32, u16> geosetIDToGeosetKey;
@@ -1,6 +1,7 @@
 #pragma once
 #include "Game-Lib/Application/EnttRegistries.h"
 #include "Game-Lib/ECS/Singletons/JoltState.h"
+#include "Game-Lib/Util/JoltJobSystem.h"
 #include "Game-Lib/Util/JoltMemoryTelemetry.h"
 #include "Game-Lib/Util/ServiceLocator.h"
 
@@ -19,6 +20,7 @@
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <thread>
 
@@ -237,11 +239,24 @@ namespace ECS::Singletons
     struct JoltState
     {
     public:
-        JoltState() : allocator(64u * 1024u * 1024u), scheduler(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1) { }
+        JoltState() : allocator(64u * 1024u * 1024u) { }
+
+        // Runs the physics jobs on taskScheduler's workers, or on a JobSystemThreadPool of its own when taskScheduler is null
+        void CreateJobSystem(enki::TaskScheduler* taskScheduler)
+        {
+            if (taskScheduler)
+            {
+                jobSystem = std::make_unique<::Util::JoltEnkiJobSystem>(taskScheduler, JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
+            }
+            else
+            {
+                jobSystem = std::make_unique<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1);
+            }
+        }
         
         JPH::PhysicsSystem physicsSystem;
         JPH::TempAllocatorImpl allocator;
-        JPH::JobSystemThreadPool scheduler;
+        std::unique_ptr<JPH::JobSystem> jobSystem;
 
         Jolt::BPLayerInterfaceImpl broadPhaseLayerInterface;
         Jolt::ObjectVsBroadPhaseLayerFilterImpl objectVSBroadPhaseLayerFilter;
@@ -253,6 +268,14 @@ namespace ECS::Singletons
         static constexpr f32 FixedDeltaTime = 1.0f / 60.0f;
         f32 updateTimer = 0.0f;
 
+        // Bumped whenever static bodies enter or leave the world, anything caching static collision queries compares against it
+        std::atomic<u64> staticWorldGeneration = 0;
+
+        void MarkStaticWorldChanged()
+        {
+            staticWorldGeneration.fetch_add(1, std::memory_order_relaxed);
+        }
+
         std::string telemetryMapName = "NoMap";
         std::array<JoltBodyTelemetryCounter, static_cast<std::size_t>(JoltBodyTelemetrySource::Count)> bodyTelemetryCounters;
         std::atomic<u64> peakNumBodies = 0;
@@ -1,5 +1,6 @@
 #pragma once
 #include "Game-Lib/ECS/Singletons/InteractionState.h"
+#include "Game-Lib/ECS/Util/Network/NetFieldUpdate.h"
 
 #include <Gameplay/GameDefine.h>
 #include <Gameplay/Network/Define.h>
@@ -20,6 +21,11 @@ namespace Network
     class GameMessageRouter;
 }
 
+namespace ECS::Util::Network
+{
+    class MessageDispatchQueue;
+}
+
 namespace ECS
 {
     enum class AuthenticationStage : u8
@@ -118,6 +124,9 @@ namespace ECS
             std::shared_ptr<asio::ip::tcp::resolver> resolver;
             std::unique_ptr<Network::Client> client;
             std::unique_ptr<Network::GameMessageRouter> gameMessageRouter;
+            std::unique_ptr<Util::Network::MessageDispatchQueue> messageDispatchQueue;
+            f32 messageDispatchOverrunMS = 0.0f; // Time the previous frame spent past its dispatch budget, paid back next frame
+            u64 numRejectedMessages = 0; // Messages without a handler or whose handler failed, each one closes the connection
 
             bool isLoadingMap = false;
             bool isInWorld = false;
@@ -129,6 +138,8 @@ namespace ECS
 
             Network::ObjectNetFieldsListener objectNetFieldListener;
             Network::UnitNetFieldsListener unitNetFieldListener;
+            Util::Network::NetFieldChangeBatch<MetaGen::Shared::NetField::ObjectNetFieldEnum> objectNetFieldChanges;
+            Util::Network::NetFieldChangeBatch<MetaGen::Shared::NetField::UnitNetFieldEnum> unitNetFieldChanges;
 
             std::vector<vec3> pathToVisualize;
 
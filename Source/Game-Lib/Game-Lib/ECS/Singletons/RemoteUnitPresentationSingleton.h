@@ -0,0 +1,36 @@
+#pragma once
+#include "Game-Lib/Util/GroundRaycastBatch.h"
+
+#include <Base/Types.h>
+
+#include <entt/entt.hpp>
+
+#include <limits>
+#include <vector>
+
+namespace ECS::Singletons
+{
+    struct RemoteUnitPresentationSingleton
+    {
+    public:
+        struct PresentedUnit
+        {
+        public:
+            entt::entity entity = entt::null;
+            vec3 renderedPosition = vec3(0.0f);
+            u32 groundRayIndex = std::numeric_limits<u32>::max();
+            bool isGrounded = false;
+            bool needsGroundSample = false;
+        };
+
+    public:
+        explicit RemoteUnitPresentationSingleton(f32 groundSearchRange) : groundRaycastBatch(groundSearchRange) { }
+
+        // Rebuilt every frame, kept here so the buffers keep their capacity
+        std::vector<PresentedUnit> presentedUnits;
+        ::Util::GroundRaycastBatch groundRaycastBatch;
+
+        // The JoltState static world generation the cached ground samples were taken against
+        u64 groundSampleGeneration = 0;
+    };
+}
@@ -1,11 +1,16 @@
 #pragma once
 #include <Base/Types.h>
 
+struct RenderSnapshot;
+
 namespace ECS::Singletons
 {
     struct RenderState
     {
     public:
         u64 frameNumber = 0;
+
+        // Where systems leave their changes for the renderers this frame, nullptr on headless clients
+        RenderSnapshot* snapshot = nullptr;
     };
-}
\ No newline at end of file
+}
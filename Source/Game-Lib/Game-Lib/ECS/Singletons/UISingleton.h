@@ -1,6 +1,7 @@
 #pragma once
 #include "Game-Lib/ECS/Components/UI/PanelTemplate.h"
 #include "Game-Lib/ECS/Components/UI/TextTemplate.h"
+#include "Game-Lib/ECS/Util/UIHitGrid.h"
 
 #include <Base/Types.h>
 #include <Base/Memory/StackAllocator.h>
@@ -94,6 +95,19 @@ namespace ECS::Singletons
         entt::entity justFocusedEntity = entt::null; // If it was just focused this frame
         entt::entity cursorCanvasEntity = entt::null;
 
+        // Hit testing. hitGrid holds the input rects the canvas walk in HandleInput would find, canvases listed in
+        // hitGridDirtyCanvases (or all of them when hitGridFullyDirty) are collected again before the next lookup.
+        ECS::Util::UIInput::HitGrid hitGrid;
+        robin_hood::unordered_set<entt::entity> hitGridDirtyCanvases;
+        bool hitGridFullyDirty = true;
+        u64 hitGridVersion = 0; // Bumped whenever hitGrid's contents change
+        entt::entity hitGridCursorCanvasEntity = entt::null; // Left out of hitGrid since it follows the cursor
+
+        // What allHoveredEntities was last looked up with, an unchanged cursor over an unchanged grid reuses it
+        bool hoveredEntitiesFromHitGrid = false;
+        u64 hoveredEntitiesHitGridVersion = 0;
+        vec2 hoveredEntitiesMousePosition = vec2(0.0f);
+
         // Cursor canvas
         Scripting::UI::Widget* cursorCanvas = nullptr;
 
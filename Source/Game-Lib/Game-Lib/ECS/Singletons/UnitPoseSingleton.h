@@ -0,0 +1,11 @@
+#pragma once
+#include "Game-Lib/ECS/Util/UnitPose.h"
+
+namespace ECS::Singletons
+{
+    struct UnitPoseSingleton
+    {
+    public:
+        ECS::Util::UnitPose::CommitList commits;
+    };
+}
@@ -0,0 +1,282 @@
+#include "SystemGraph.h"
+
+#include <Base/Util/DebugHandler.h>
+
+#include <enkiTS/TaskScheduler.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+namespace ECS
+{
+    static void InsertSorted(std::vector<u32>& ids, u32 id)
+    {
+        auto itr = std::lower_bound(ids.begin(), ids.end(), id);
+        if (itr != ids.end() && *itr == id)
+            return;
+
+        ids.insert(itr, id);
+    }
+
+    static bool Intersects(const std::vector<u32>& a, const std::vector<u32>& b)
+    {
+        auto aItr = a.begin();
+        auto bItr = b.begin();
+
+        while (aItr != a.end() && bItr != b.end())
+        {
+            if (*aItr == *bItr)
+                return true;
+
+            if (*aItr < *bItr)
+                aItr++;
+            else
+                bItr++;
+        }
+
+        return false;
+    }
+
+    void SystemAccess::AddRead(u32 resourceID)
+    {
+        InsertSorted(_reads, resourceID);
+    }
+
+    void SystemAccess::AddWrite(u32 resourceID)
+    {
+        InsertSorted(_writes, resourceID);
+    }
+
+    bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+    {
+        // Two main thread systems can never overlap anyway, ordering them keeps the serial semantics
+        if (_mainThreadOnly && other._mainThreadOnly)
+            return true;
+
+        return Intersects(_writes, other._writes) || Intersects(_writes, other._reads) || Intersects(_reads, other._writes);
+    }
+
+    struct SystemGraph::SystemTask : enki::ITaskSet
+    {
+    public:
+        SystemTask(SystemGraph* graph, u32 systemIndex) : enki::ITaskSet(1), _graph(graph), _systemIndex(systemIndex) { }
+
+        void ExecuteRange(enki::TaskSetPartition range, u32 threadNum) override
+        {
+            (void)range;
+            (void)threadNum;
+
+            _graph->RunSystem(_systemIndex);
+        }
+
+    private:
+        SystemGraph* _graph = nullptr;
+        u32 _systemIndex = 0;
+    };
+
+    struct SystemGraph::PinnedSystemTask : enki::IPinnedTask
+    {
+    public:
+        PinnedSystemTask(SystemGraph* graph, u32 systemIndex, u32 threadNum) : enki::IPinnedTask(threadNum), _graph(graph), _systemIndex(systemIndex) { }
+
+        void Execute() override
+        {
+            _graph->RunSystem(_systemIndex);
+        }
+
+    private:
+        SystemGraph* _graph = nullptr;
+        u32 _systemIndex = 0;
+    };
+
+    // Empty task used as the single entry and exit point of the graph
+    struct SystemGraph::GraphTask : enki::ITaskSet
+    {
+    public:
+        GraphTask() : enki::ITaskSet(1) { }
+
+        void ExecuteRange(enki::TaskSetPartition range, u32 threadNum) override
+        {
+            (void)range;
+            (void)threadNum;
+        }
+    };
+
+    SystemGraph::SystemGraph() { }
+    SystemGraph::~SystemGraph() { }
+
+    u32 SystemGraph::AddSystem(const std::string& name, const SystemAccess& access, SystemFunc func)
+    {
+        NC_ASSERT(!_isBuilt, "SystemGraph : Tried to add system '{0}' after the graph was built", name);
+
+        u32 index = static_cast<u32>(_systems.size());
+
+        SystemInfo& system = _systems.emplace_back();
+        system.name = name;
+        system.access = access;
+        system.func = std::move(func);
+
+        return index;
+    }
+
+    void SystemGraph::Build()
+    {
+        NC_ASSERT(!_isBuilt, "SystemGraph : Tried to build the graph twice");
+
+        u32 numSystems = static_cast<u32>(_systems.size());
+
+        // reachable[i][j] is true when system j is an ancestor of system i
+        std::vector<std::vector<bool>> reachable(numSystems, std::vector<bool>(numSystems, false));
+        _criticalPathLength = 0;
+
+        for (u32 i = 0; i < numSystems; i++)
+        {
+            SystemInfo& system = _systems[i];
+            system.depth = 1;
+
+            // Walk backwards so the closest conflicting system becomes the direct dependency and any earlier conflict
+            // already ordered through it is skipped, this keeps the graph transitively reduced
+            for (u32 j = i; j-- > 0;)
+            {
+                if (reachable[i][j])
+                    continue;
+
+                SystemInfo& other = _systems[j];
+                if (!system.access.ConflictsWith(other.access))
+                    continue;
+
+                system.dependencies.push_back(j);
+                other.dependents.push_back(i);
+
+                reachable[i][j] = true;
+                for (u32 k = 0; k < j; k++)
+                {
+                    if (reachable[j][k])
+                        reachable[i][k] = true;
+                }
+
+                system.depth = glm::max(system.depth, other.depth + 1);
+            }
+
+            std::sort(system.dependencies.begin(), system.dependencies.end());
+            _criticalPathLength = glm::max(_criticalPathLength, system.depth);
+        }
+
+        // Create the tasks and wire up their dependencies, a single root and sink task makes sure no part of the graph
+        // can start before every dependency count has been initialized by enkiTS
+        _rootTask = std::make_unique<GraphTask>();
+        _sinkTask = std::make_unique<GraphTask>();
+
+        _numDependencies = 0;
+        for (const SystemInfo& system : _systems)
+        {
+            _numDependencies += glm::max(static_cast<u32>(system.dependencies.size()), 1u);
+            _numDependencies += system.dependents.empty() ? 1 : 0;
+        }
+        _dependencies = std::make_unique<enki::Dependency[]>(_numDependencies);
+
+        std::vector<enki::ICompletable*> completables(numSystems, nullptr);
+        _tasks.resize(numSystems);
+        _pinnedTasks.resize(numSystems);
+
+        for (u32 i = 0; i < numSystems; i++)
+        {
+            if (_systems[i].access.IsMainThreadOnly())
+            {
+                // Thread 0 is the thread that initialized the TaskScheduler, which is the thread calling Execute
+                _pinnedTasks[i] = std::make_unique<PinnedSystemTask>(this, i, 0);
+                completables[i] = _pinnedTasks[i].get();
+            }
+            else
+            {
+                _tasks[i] = std::make_unique<SystemTask>(this, i);
+                completables[i] = _tasks[i].get();
+            }
+        }
+
+        u32 dependencyIndex = 0;
+        for (u32 i = 0; i < numSystems; i++)
+        {
+            const SystemInfo& system = _systems[i];
+
+            if (system.dependencies.empty())
+            {
+                completables[i]->SetDependency(_dependencies[dependencyIndex++], _rootTask.get());
+            }
+            else
+            {
+                for (u32 dependency : system.dependencies)
+                {
+                    completables[i]->SetDependency(_dependencies[dependencyIndex++], completables[dependency]);
+                }
+            }
+
+            if (system.dependents.empty())
+            {
+                _sinkTask->SetDependency(_dependencies[dependencyIndex++], completables[i]);
+            }
+        }
+
+        _isBuilt = true;
+        NC_LOG_INFO("SystemGraph : Built graph with {0} systems, critical path is {1} systems long", numSystems, _criticalPathLength);
+    }
+
+    void SystemGraph::Clear()
+    {
+        // Tasks must be destroyed before the dependencies they point into
+        _tasks.clear();
+        _pinnedTasks.clear();
+        _rootTask.reset();
+        _sinkTask.reset();
+        _dependencies.reset();
+        _numDependencies = 0;
+
+        _systems.clear();
+        _criticalPathLength = 0;
+        _isBuilt = false;
+    }
+
+    void SystemGraph::Execute(enki::TaskScheduler* taskScheduler, f32 deltaTime, bool serial)
+    {
+        NC_ASSERT(_isBuilt, "SystemGraph : Tried to execute the graph before it was built");
+
+        if (serial || taskScheduler == nullptr || _systems.empty())
+        {
+            ExecuteSerial(deltaTime);
+            return;
+        }
+
+        ZoneScopedN("ECS::SystemGraph::Execute");
+        _deltaTime = deltaTime;
+
+        taskScheduler->AddTaskSetToPipe(_rootTask.get());
+        taskScheduler->WaitforTask(_sinkTask.get());
+    }
+
+    void SystemGraph::ExecuteSerial(f32 deltaTime)
+    {
+        ZoneScopedN("ECS::SystemGraph::ExecuteSerial");
+        _deltaTime = deltaTime;
+
+        u32 numSystems = static_cast<u32>(_systems.size());
+        for (u32 i = 0; i < numSystems; i++)
+        {
+            RunSystem(i);
+        }
+    }
+
+    void SystemGraph::RunSystem(u32 index)
+    {
+        SystemInfo& system = _systems[index];
+
+        ZoneScopedN("ECS::SystemGraph::RunSystem");
+        ZoneText(system.name.c_str(), system.name.size());
+
+        auto start = std::chrono::steady_clock::now();
+        system.func(_deltaTime);
+        auto end = std::chrono::steady_clock::now();
+
+        system.lastDurationMS = std::chrono::duration<f32, std::milli>(end - start).count();
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <entt/core/type_info.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace enki
+{
+    class Dependency;
+    class TaskScheduler;
+}
+
+namespace ECS
+{
+    // Pseudo-resources for state that lives outside of the registries, systems declare them just like components
+    namespace Resources
+    {
+        struct GameRegistryStructure {}; // Creating/destroying entities in the game registry, emplacing/removing a component is a write of that component
+        struct UIRegistryStructure {}; // Creating/destroying entities or emplacing/removing components in the ui registry
+        struct GameRenderer {}; // GameRenderer state not covered below (window, material/skybox renderers, pixel query, terrain editing)
+        struct ModelLoader {}; // ModelLoader and the ModelRenderer instance data it owns
+        struct RenderSnapshot {}; // The snapshot RenderState points at, systems leave their renderer changes in it
+        struct DebugRenderer {};
+        struct RenderResources {};
+        struct MapLoader {};
+        struct Scripting {};
+        struct Input {};
+        struct Physics {};
+        struct ClientDB {};
+    }
+
+    class SystemAccess
+    {
+    public:
+        template <typename... T>
+        SystemAccess& Read()
+        {
+            (AddRead(entt::type_hash<T>::value()), ...);
+            return *this;
+        }
+
+        template <typename... T>
+        SystemAccess& Write()
+        {
+            (AddWrite(entt::type_hash<T>::value()), ...);
+            return *this;
+        }
+
+        // Pins the system to the thread that calls SystemGraph::Execute (Window, Input and ImGui state)
+        SystemAccess& MainThread()
+        {
+            _mainThreadOnly = true;
+            return *this;
+        }
+
+        void AddRead(u32 resourceID);
+        void AddWrite(u32 resourceID);
+
+        bool ConflictsWith(const SystemAccess& other) const;
+        bool IsMainThreadOnly() const { return _mainThreadOnly; }
+
+        const std::vector<u32>& GetReads() const { return _reads; }
+        const std::vector<u32>& GetWrites() const { return _writes; }
+
+    private:
+        std::vector<u32> _reads; // Sorted
+        std::vector<u32> _writes; // Sorted
+        bool _mainThreadOnly = false;
+    };
+
+    // Builds a dependency DAG from the declared access of every system. Registration order is the serial order,
+    // two systems that conflict keep that order while everything else is free to run concurrently.
+    class SystemGraph
+    {
+    public:
+        using SystemFunc = std::function<void(f32 deltaTime)>;
+
+        struct SystemInfo
+        {
+        public:
+            std::string name;
+            SystemAccess access;
+            SystemFunc func;
+
+            std::vector<u32> dependencies; // Direct predecessors after transitive reduction
+            std::vector<u32> dependents;
+            u32 depth = 0; // Number of systems on the longest chain ending in this system
+
+            f32 lastDurationMS = 0.0f; // Wall time of the most recent run, written by whichever thread ran the system
+        };
+
+    public:
+        SystemGraph();
+        ~SystemGraph();
+
+        u32 AddSystem(const std::string& name, const SystemAccess& access, SystemFunc func);
+        void Build();
+        void Clear();
+
+        // Runs every system once, taskScheduler == nullptr or serial == true runs them in registration order on the calling thread
+        void Execute(enki::TaskScheduler* taskScheduler, f32 deltaTime, bool serial = false);
+        void ExecuteSerial(f32 deltaTime);
+
+        bool IsBuilt() const { return _isBuilt; }
+        u32 GetNumSystems() const { return static_cast<u32>(_systems.size()); }
+        const SystemInfo& GetSystem(u32 index) const { return _systems[index]; }
+        u32 GetCriticalPathLength() const { return _criticalPathLength; }
+
+    private:
+        struct SystemTask;
+        struct PinnedSystemTask;
+        struct GraphTask;
+
+        void RunSystem(u32 index);
+
+    private:
+        std::vector<SystemInfo> _systems;
+        u32 _criticalPathLength = 0;
+        bool _isBuilt = false;
+
+        f32 _deltaTime = 0.0f;
+
+        // Built once in Build, enki::Dependency objects must not move while tasks reference them
+        std::vector<std::unique_ptr<SystemTask>> _tasks;
+        std::vector<std::unique_ptr<PinnedSystemTask>> _pinnedTasks;
+        std::unique_ptr<GraphTask> _rootTask;
+        std::unique_ptr<GraphTask> _sinkTask;
+        std::unique_ptr<enki::Dependency[]> _dependencies;
+        u32 _numDependencies = 0;
+    };
+}
@@ -10,11 +10,15 @@
 #include "Game-Lib/ECS/Singletons/AnimationSingleton.h"
 #include "Game-Lib/ECS/Singletons/FreeflyingCameraSettings.h"
 #include "Game-Lib/ECS/Singletons/CharacterSingleton.h"
+#include "Game-Lib/ECS/Singletons/RenderState.h"
 #include "Game-Lib/ECS/Util/Transforms.h"
 #include "Game-Lib/Gameplay/Animation/Defines.h"
+#include "Game-Lib/Gameplay/Animation/Keyframes.h"
+#include "Game-Lib/Gameplay/Animation/LOD.h"
 #include "Game-Lib/Rendering/GameRenderer.h"
 #include "Game-Lib/Rendering/Model/ModelLoader.h"
 #include "Game-Lib/Rendering/Model/ModelRenderer.h"
+#include "Game-Lib/Rendering/RenderSnapshot.h"
 #include "Game-Lib/Util/AnimationUtil.h"
 #include "Game-Lib/Util/AttachmentUtil.h"
 #include "Game-Lib/Util/ServiceLocator.h"
@@ -25,7 +29,19 @@
 
 #include <glm/gtx/matrix_decompose.hpp>
 
+#include <tracy/Tracy.hpp>
+
+#include <atomic>
+
 AutoCVar_Int CVAR_AnimationSimulationEnabled(CVarCategory::Client | CVarCategory::Rendering, "animationSimulationEnabled", "Enables the Animation Simulation", 1, CVarFlags::EditCheckbox);
+AutoCVar_Int CVAR_AnimationLODEnabled(CVarCategory::Client | CVarCategory::Rendering, "animationLodEnabled", "Lowers the animation update rate with distance and for entities outside the view", 1, CVarFlags::EditCheckbox);
+AutoCVar_Float CVAR_AnimationLODFullDistance(CVarCategory::Client | CVarCategory::Rendering, "animationLodFullDistance", "Distance within which animations are evaluated every frame", 40.0f, CVarFlags::EditFloatDrag);
+AutoCVar_Float CVAR_AnimationLODHalfDistance(CVarCategory::Client | CVarCategory::Rendering, "animationLodHalfDistance", "Distance within which animations are evaluated every second frame", 90.0f, CVarFlags::EditFloatDrag);
+AutoCVar_Float CVAR_AnimationLODQuarterDistance(CVarCategory::Client | CVarCategory::Rendering, "animationLodQuarterDistance", "Distance within which animations are evaluated every fourth frame", 160.0f, CVarFlags::EditFloatDrag);
+AutoCVar_Int CVAR_AnimationLODDistantInterval(CVarCategory::Client | CVarCategory::Rendering, "animationLodDistantInterval", "Frames between animation evaluations beyond the quarter distance", 8);
+AutoCVar_Int CVAR_AnimationLODOffscreenInterval(CVarCategory::Client | CVarCategory::Rendering, "animationLodOffscreenInterval", "Frames between animation evaluations outside the view, 0 freezes them", 0);
+AutoCVar_Int CVAR_AnimationLODSubsetBoneDepth(CVarCategory::Client | CVarCategory::Rendering, "animationLodSubsetBoneDepth", "From the quarter distance, bones deeper than this follow their parent, 0 evaluates all bones", 4);
+AutoCVar_Int CVAR_AnimationLODInterpolate(CVarCategory::Client | CVarCategory::Rendering, "animationLodInterpolate", "Blends between evaluations of animations running at a reduced rate", 1, CVarFlags::EditCheckbox);
 #define ANIMATION_SIMULATION_MT 1
 #define ANIMATION_ENABLE_STATIC_ANIMATION_BILLBOARDING 0
 
@@ -109,58 +125,105 @@ namespace ECS::Systems
     }
 
     template <typename T>
-    static T InterpolateKeyframe(const Model::ComplexModel::AnimationTrack<T>& track, f32 progress)
+    static bool HasKeyframes(const Model::ComplexModel::AnimationTrack<T>& track, std::span<const f32> timestamps)
+    {
+        return track.values.size() > 0 && timestamps.size() > 0 && timestamps.size() == track.timestamps.size();
+    }
+
+    template <typename T>
+    static T BlendKeyframes(const Model::ComplexModel::AnimationTrack<T>& track, const ::Animation::Keyframes::Segment& segment)
     {
-        u32 numTimeStamps = static_cast<u32>(track.timestamps.size());
-        if (numTimeStamps == 1)
+        const T& value1 = track.values[segment.index0];
+        if (segment.index0 == segment.index1)
+            return value1;
+
+        const T& value2 = track.values[segment.index1];
+
+        if constexpr (std::is_same_v<T, quat>)
         {
-            return track.values[0];
+            return glm::slerp(value1, value2, segment.t);
         }
+        else
+        {
+            return glm::mix(value1, value2, segment.t);
+        }
+    }
 
-        f32 lastTimestamp = static_cast<f32>(track.timestamps[numTimeStamps - 1] / 1000.0f);
-        if (progress >= lastTimestamp)
-            return track.values[numTimeStamps - 1];
+    template <typename T>
+    static T InterpolateKeyframe(const Model::ComplexModel::AnimationTrack<T>& track, std::span<const f32> timestamps, f32 progress, u32& cursor)
+    {
+        return BlendKeyframes(track, ::Animation::Keyframes::FindSegment(timestamps, progress, cursor));
+    }
 
-        f32 timestamp1 = static_cast<f32>(track.timestamps[0] / 1000.0f);
-        f32 timestamp2 = static_cast<f32>(track.timestamps[1] / 1000.0f);
+    template <typename T>
+    static T InterpolateKeyframe(const Model::ComplexModel::AnimationTrack<T>& track, std::span<const f32> timestamps, f32 progress)
+    {
+        return BlendKeyframes(track, ::Animation::Keyframes::FindSegment(timestamps, progress));
+    }
 
-        T value1 = track.values[0];
-        T value2 = track.values[1];
+    static ::Animation::LOD::Settings GetLODSettings()
+    {
+        ::Animation::LOD::Settings settings;
+        settings.fullDistance = static_cast<f32>(CVAR_AnimationLODFullDistance.GetFloat());
+        settings.halfDistance = static_cast<f32>(CVAR_AnimationLODHalfDistance.GetFloat());
+        settings.quarterDistance = static_cast<f32>(CVAR_AnimationLODQuarterDistance.GetFloat());
+        settings.distantInterval = static_cast<u8>(glm::clamp(CVAR_AnimationLODDistantInterval.Get(), 1, 255));
+        settings.offscreenInterval = static_cast<u8>(glm::clamp(CVAR_AnimationLODOffscreenInterval.Get(), 0, 255));
+        settings.subsetBoneDepth = static_cast<u8>(glm::clamp(CVAR_AnimationLODSubsetBoneDepth.Get(), 0, 255));
+        settings.interpolate = CVAR_AnimationLODInterpolate.Get() != 0;
+
+        return settings;
+    }
 
-        for (u32 i = 1; i < numTimeStamps; i++)
+    static bool IsSphereInFrustum(const vec4* planes, const vec3& center, f32 radius)
+    {
+        for (u32 i = 0; i < 6; i++)
         {
-            f32 timestamp = static_cast<f32>(track.timestamps[i] / 1000.0f);
-
-            if (progress <= timestamp)
-            {
-                timestamp1 = static_cast<f32>(track.timestamps[i - 1] / 1000.0f);
-                timestamp2 = static_cast<f32>(track.timestamps[i] / 1000.0f);
-
-                value1 = track.values[i - 1];
-                value2 = track.values[i];
-                break;
-            }
+            // Same test as SphereIsForwardPlane in Culling.cs.slang
+            if (glm::dot(vec3(planes[i]), center) - planes[i].w < -radius)
+                return false;
         }
 
-        f32 currentProgress = progress - timestamp1;
-        f32 currentFrameDuration = timestamp2 - timestamp1;
+        return true;
+    }
 
-        if (currentFrameDuration == 0.0f)
-            return value1;
+    static ::Animation::LOD::Level GetLODLevel(entt::registry& registry, entt::entity entity, const ::Animation::LOD::Settings& settings, const Components::AnimationData& animationData, const vec4* frustumPlanes, const vec3& cameraPosition)
+    {
+        const auto& entityTransform = registry.get<Components::Transform>(entity);
+        const mat4x4& entityMatrix = entityTransform.GetMatrix();
 
-        f32 t = currentProgress / currentFrameDuration;
+        vec3 center = entityTransform.GetWorldPosition();
+        f32 radius = 1.0f;
 
-        if constexpr (std::is_same_v<T, quat>)
+        if (const auto* aabb = registry.try_get<Components::AABB>(entity))
         {
-            return glm::slerp(value1, value2, t);
+            f32 maxScale = glm::max(glm::length(vec3(entityMatrix[0])), glm::max(glm::length(vec3(entityMatrix[1])), glm::length(vec3(entityMatrix[2]))));
+
+            center = vec3(entityMatrix * vec4(aabb->centerPos, 1.0f));
+            radius = glm::length(aabb->extents) * maxScale;
         }
-        else
+
+        bool isVisible = IsSphereInFrustum(frustumPlanes, center, radius);
+        f32 distance = glm::max(glm::distance(cameraPosition, center) - radius, 0.0f);
+
+        return ::Animation::LOD::GetLevel(settings, animationData.lodState.level, distance, isVisible);
+    }
+
+    static bool BlendLODPose(Components::AnimationData& animationData, f32 blendFactor)
+    {
+        u32 numBoneTransforms = static_cast<u32>(animationData.boneTransforms.size());
+        if (animationData.lodPoseFrom.size() != numBoneTransforms || animationData.lodPoseTo.size() != numBoneTransforms)
+            return false;
+
+        for (u32 i = 0; i < numBoneTransforms; i++)
         {
-            return glm::mix(value1, value2, t);
+            animationData.boneTransforms[i] = ::Animation::LOD::BlendPose(animationData.lodPoseFrom[i], animationData.lodPoseTo[i], blendFactor);
         }
+
+        return true;
     }
 
-    static mat4x4 GetBoneMatrix(const std::vector<::Animation::Defines::GlobalLoop>& globalLoops, const ::Animation::Defines::State& animationState, const Model::ComplexModel::Bone& bone, const quat& rotationOffset)
+    static mat4x4 GetBoneMatrix(const std::vector<::Animation::Defines::GlobalLoop>& globalLoops, const ::Animation::Defines::State& animationState, const Model::ComplexModel::Bone& bone, const quat& rotationOffset, const ::Animation::Keyframes::ModelTrackTimes& trackTimes, u32 boneIndex, u32* keyframeCursors)
     {
         vec3 translationValue = vec3(0.0f, 0.0f, 0.0f);
         quat rotationValue = quat(1.0f, 0.0f, 0.0f, 0.0f);
@@ -183,6 +246,7 @@ namespace ECS::Systems
                 if (sequenceID < bone.translation.tracks.size())
                 {
                     const Model::ComplexModel::AnimationTrack<vec3>& track = bone.translation.tracks[sequenceID];
+                    std::span<const f32> timestamps = trackTimes.GetBoneTrack(boneIndex, ::Animation::Keyframes::TrackComponent::Translation, sequenceID);
                     f32 progress = animationState.progress;
 
                     if (isTranslationGlobalLoop)
@@ -191,8 +255,8 @@ namespace ECS::Systems
                         progress = globalLoop.currentTime;
                     }
 
-                    if (track.values.size() > 0 && track.timestamps.size() > 0)
-                        translationValue = InterpolateKeyframe(track, progress);
+                    if (HasKeyframes(track, timestamps))
+                        translationValue = InterpolateKeyframe(track, timestamps, progress, keyframeCursors[static_cast<u32>(::Animation::Keyframes::TrackComponent::Translation)]);
                 }
             }
 
@@ -207,6 +271,7 @@ namespace ECS::Systems
                 if (sequenceID < bone.rotation.tracks.size())
                 {
                     const Model::ComplexModel::AnimationTrack<quat>& track = bone.rotation.tracks[sequenceID];
+                    std::span<const f32> timestamps = trackTimes.GetBoneTrack(boneIndex, ::Animation::Keyframes::TrackComponent::Rotation, sequenceID);
                     f32 progress = animationState.progress;
 
                     if (bone.rotation.globalLoopIndex != -1)
@@ -215,8 +280,8 @@ namespace ECS::Systems
                         progress = globalLoop.currentTime;
                     }
 
-                    if (track.values.size() > 0 && track.timestamps.size() > 0)
-                        rotationValue = InterpolateKeyframe(track, progress);
+                    if (HasKeyframes(track, timestamps))
+                        rotationValue = InterpolateKeyframe(track, timestamps, progress, keyframeCursors[static_cast<u32>(::Animation::Keyframes::TrackComponent::Rotation)]);
                 }
             }
         
@@ -231,6 +296,7 @@ namespace ECS::Systems
                 if (sequenceID < bone.scale.tracks.size())
                 {
                     const Model::ComplexModel::AnimationTrack<vec3>& track = bone.scale.tracks[sequenceID];
+                    std::span<const f32> timestamps = trackTimes.GetBoneTrack(boneIndex, ::Animation::Keyframes::TrackComponent::Scale, sequenceID);
                     f32 progress = animationState.progress;
         
                     if (bone.scale.globalLoopIndex != -1)
@@ -239,8 +305,8 @@ namespace ECS::Systems
                         progress = globalLoop.currentTime;
                     }
         
-                    if (track.values.size() > 0 && track.timestamps.size() > 0)
-                        scaleValue = InterpolateKeyframe(track, progress);
+                    if (HasKeyframes(track, timestamps))
+                        scaleValue = InterpolateKeyframe(track, timestamps, progress, keyframeCursors[static_cast<u32>(::Animation::Keyframes::TrackComponent::Scale)]);
                 }
             }
         }
@@ -260,10 +326,11 @@ namespace ECS::Systems
                 if (nextSequenceID < bone.translation.tracks.size())
                 {
                     const Model::ComplexModel::AnimationTrack<vec3>& track = bone.translation.tracks[nextSequenceID];
+                    std::span<const f32> timestamps = trackTimes.GetBoneTrack(boneIndex, ::Animation::Keyframes::TrackComponent::Translation, nextSequenceID);
     
-                    if (track.values.size() > 0 && track.timestamps.size() > 0)
+                    if (HasKeyframes(track, timestamps))
                     {
-                        vec3 translation = InterpolateKeyframe(track, 0.0f);
+                        vec3 translation = InterpolateKeyframe(track, timestamps, 0.0f);
                         translationValue = glm::mix(translationValue, translation, transitionProgress);
                     }
                 }
@@ -278,10 +345,11 @@ namespace ECS::Systems
                 if (nextSequenceID < bone.rotation.tracks.size())
                 {
                     const Model::ComplexModel::AnimationTrack<quat>& track = bone.rotation.tracks[nextSequenceID];
+                    std::span<const f32> timestamps = trackTimes.GetBoneTrack(boneIndex, ::Animation::Keyframes::TrackComponent::Rotation, nextSequenceID);
 
-                    if (track.values.size() > 0 && track.timestamps.size() > 0)
+                    if (HasKeyframes(track, timestamps))
                     {
-                        quat rotation = InterpolateKeyframe(track, 0.0f);
+                        quat rotation = InterpolateKeyframe(track, timestamps, 0.0f);
                         rotationValue = glm::slerp(rotationValue, rotation, transitionProgress);
                     }
                 }
@@ -296,10 +364,11 @@ namespace ECS::Systems
                 if (nextSequenceID < bone.scale.tracks.size())
                 {
                     const Model::ComplexModel::AnimationTrack<vec3>& track = bone.scale.tracks[nextSequenceID];
+                    std::span<const f32> timestamps = trackTimes.GetBoneTrack(boneIndex, ::Animation::Keyframes::TrackComponent::Scale, nextSequenceID);
 
-                    if (track.values.size() > 0 && track.timestamps.size() > 0)
+                    if (HasKeyframes(track, timestamps))
                     {
-                        vec3 scale = InterpolateKeyframe(track, 0.0f);
+                        vec3 scale = InterpolateKeyframe(track, timestamps, 0.0f);
                         scaleValue = glm::mix(translationValue, scaleValue, transitionProgress);
                     }
                 }
@@ -324,7 +393,7 @@ namespace ECS::Systems
         return boneMatrix;
     }
 
-    static mat4x4 GetTextureTransformMatrix(const std::vector<::Animation::Defines::GlobalLoop>& globalLoops, const ::Animation::Defines::State& animationState, const Model::ComplexModel::TextureTransform& textureTransform)
+    static mat4x4 GetTextureTransformMatrix(const std::vector<::Animation::Defines::GlobalLoop>& globalLoops, const ::Animation::Defines::State& animationState, const Model::ComplexModel::TextureTransform& textureTransform, const ::Animation::Keyframes::ModelTrackTimes& trackTimes, u32 textureTransformIndex, u32* keyframeCursors)
     {
         vec3 translationValue = vec3(0.0f, 0.0f, 0.0f);
         quat rotationValue = quat(1.0f, 0.0f, 0.0f, 0.0f);
@@ -347,6 +416,7 @@ namespace ECS::Systems
                 if (sequenceID < textureTransform.translation.tracks.size())
                 {
                     const Model::ComplexModel::AnimationTrack<vec3>& track = textureTransform.translation.tracks[sequenceID];
+                    std::span<const f32> timestamps = trackTimes.GetTextureTransformTrack(textureTransformIndex, ::Animation::Keyframes::TrackComponent::Translation, sequenceID);
                     f32 progress = animationState.progress;
 
                     if (isTranslationGlobalLoop)
@@ -355,8 +425,8 @@ namespace ECS::Systems
                         progress = globalLoop.currentTime;
                     }
 
-                    if (track.values.size() > 0 && track.timestamps.size() > 0)
-                        translationValue = InterpolateKeyframe(track, progress);
+                    if (HasKeyframes(track, timestamps))
+                        translationValue = InterpolateKeyframe(track, timestamps, progress, keyframeCursors[static_cast<u32>(::Animation::Keyframes::TrackComponent::Translation)]);
                 }
             }
 
@@ -371,6 +441,7 @@ namespace ECS::Systems
                 if (sequenceID < textureTransform.rotation.tracks.size())
                 {
                     const Model::ComplexModel::AnimationTrack<quat>& track = textureTransform.rotation.tracks[sequenceID];
+                    std::span<const f32> timestamps = trackTimes.GetTextureTransformTrack(textureTransformIndex, ::Animation::Keyframes::TrackComponent::Rotation, sequenceID);
                     f32 progress = animationState.progress;
 
                     if (textureTransform.rotation.globalLoopIndex != -1)
@@ -379,8 +450,8 @@ namespace ECS::Systems
                         progress = globalLoop.currentTime;
                     }
 
-                    if (track.values.size() > 0 && track.timestamps.size() > 0)
-                        rotationValue = InterpolateKeyframe(track, progress);
+                    if (HasKeyframes(track, timestamps))
+                        rotationValue = InterpolateKeyframe(track, timestamps, progress, keyframeCursors[static_cast<u32>(::Animation::Keyframes::TrackComponent::Rotation)]);
                 }
             }
 
@@ -395,6 +466,7 @@ namespace ECS::Systems
                 if (sequenceID < textureTransform.scale.tracks.size())
                 {
                     const Model::ComplexModel::AnimationTrack<vec3>& track = textureTransform.scale.tracks[sequenceID];
+                    std::span<const f32> timestamps = trackTimes.GetTextureTransformTrack(textureTransformIndex, ::Animation::Keyframes::TrackComponent::Scale, sequenceID);
                     f32 progress = animationState.progress;
 
                     if (textureTransform.scale.globalLoopIndex != -1)
@@ -403,8 +475,8 @@ namespace ECS::Systems
                         progress = globalLoop.currentTime;
                     }
 
-                    if (track.values.size() > 0 && track.timestamps.size() > 0)
-                        scaleValue = InterpolateKeyframe(track, progress);
+                    if (HasKeyframes(track, timestamps))
+                        scaleValue = InterpolateKeyframe(track, timestamps, progress, keyframeCursors[static_cast<u32>(::Animation::Keyframes::TrackComponent::Scale)]);
                 }
             }
         }
@@ -596,6 +668,8 @@ namespace ECS::Systems
     void SetupDynamicAnimationInstance(entt::registry& registry, entt::entity entity, const Components::Model& model, const Model::ComplexModel* modelInfo)
     {
         auto& animationData = registry.get_or_emplace<Components::AnimationData>(entity);
+        animationData.variationRandomState = Util::Animation::GetVariationRandomSeed(entity);
+
         u32 numGlobalLoops = static_cast<u32>(modelInfo->globalLoops.size());
         u32 numBones = static_cast<u32>(modelInfo->bones.size());
         u32 numAttachments = static_cast<u32>(modelInfo->attachments.size());
@@ -632,6 +706,31 @@ namespace ECS::Systems
         animationData.proceduralRotationOffsets.reserve(8);
         animationData.proceduralRotationOffsets.clear();
 
+        auto& animationSingleton = registry.ctx().get<Singletons::AnimationSingleton>();
+        std::unique_ptr<::Animation::Keyframes::ModelTrackTimes>& trackTimes = animationSingleton.modelHashToTrackTimes[model.modelHash];
+        if (!trackTimes)
+        {
+            trackTimes = std::make_unique<::Animation::Keyframes::ModelTrackTimes>();
+            trackTimes->Build(*modelInfo);
+        }
+
+        animationData.trackTimes = trackTimes.get();
+        animationData.keyframeCursors.clear();
+        animationData.keyframeCursors.resize((numBones + numTextureTransforms) * ::Animation::Keyframes::NumTrackComponents, 0);
+
+        animationData.lodState = ::Animation::LOD::State();
+        animationData.lodPoseFrom.clear();
+        animationData.lodPoseTo.clear();
+        animationData.boneDepths.resize(numBones);
+        for (u32 i = 0; i < numBones; i++)
+        {
+            // Parents always come before their children
+            i32 parentBoneID = static_cast<i32>(modelInfo->bones[i].parentBoneID);
+            bool hasParent = parentBoneID >= 0 && static_cast<u32>(parentBoneID) < i;
+
+            animationData.boneDepths[i] = hasParent ? static_cast<u8>(glm::min(animationData.boneDepths[parentBoneID] + 1, 255)) : 0;
+        }
+
         bool hasAnyTransformedBones = false;
 
         for (u32 i = 0; i < numBones; i++)
@@ -669,7 +768,7 @@ namespace ECS::Systems
         }
     }
 
-    void SetupStaticAnimationInstance(entt::registry& registry, entt::entity entity, Singletons::AnimationSingleton& animationSingleton, const Components::Model& model, const Model::ComplexModel* modelInfo, ModelRenderer* modelRenderer)
+    void SetupStaticAnimationInstance(entt::registry& registry, entt::entity entity, Singletons::AnimationSingleton& animationSingleton, const Components::Model& model, const Model::ComplexModel* modelInfo, RenderSnapshot* snapshot)
     {
         entt::entity dynamicEntity = entt::null;
         if (!animationSingleton.staticModelIDToEntity.contains(model.modelID))
@@ -683,10 +782,9 @@ namespace ECS::Systems
             dynamicModel.instanceID = std::numeric_limits<u32>().max();
             dynamicModel.modelHash = model.modelHash;
 
-            if (modelRenderer)
+            if (snapshot)
             {
-                bool result = modelRenderer->AddUninstancedAnimationData(dynamicModel.modelID, animationStaticInstance.boneMatrixOffset, animationStaticInstance.textureMatrixOffset);
-                NC_ASSERT(result, "Failed to add uninstanced animation data.");
+                snapshot->animation.addedStaticEntities.push_back(dynamicEntity);
             }
 
             SetupDynamicAnimationInstance(registry, dynamicEntity, model, modelInfo);
@@ -697,11 +795,9 @@ namespace ECS::Systems
             dynamicEntity = animationSingleton.staticModelIDToEntity[model.modelID];
         }
 
-        if (modelRenderer)
+        if (snapshot)
         {
-            auto& animationStaticInstance = registry.get<Components::AnimationStaticInstance>(dynamicEntity);
-            bool result = modelRenderer->SetInstanceAnimationData(model.instanceID, animationStaticInstance.boneMatrixOffset, animationStaticInstance.textureMatrixOffset);
-            NC_ASSERT(result, "Failed to set instance animation data.");
+            snapshot->animation.staticInstances.push_back({ model.instanceID, dynamicEntity });
         }
     }
 
@@ -729,10 +825,84 @@ namespace ECS::Systems
         }
     }
 
-    void Animation::HandleAnimationDataInit(entt::registry& registry, f32 deltaTime)
+    void Animation::ApplyToRenderers(entt::registry& registry, const RenderSnapshot& snapshot)
     {
+        ZoneScopedN("ECS::Animation::ApplyToRenderers");
+
         ModelRenderer* modelRenderer = ServiceLocator::GetGameRenderer()->GetModelRenderer();
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        const RenderSnapshot::AnimationChanges& changes = snapshot.animation;
+
+        for (u32 instanceID : changes.addedInstances)
+        {
+            modelRenderer->AddAnimationInstance(instanceID);
+        }
+
+        // The shared matrices are allocated before the placements point at them and before their first upload
+        for (entt::entity staticEntity : changes.addedStaticEntities)
+        {
+            const auto& model = registry.get<Components::Model>(staticEntity);
+            auto& animationStaticInstance = registry.get<Components::AnimationStaticInstance>(staticEntity);
+
+            bool result = modelRenderer->AddUninstancedAnimationData(model.modelID, animationStaticInstance.boneMatrixOffset, animationStaticInstance.textureMatrixOffset);
+            NC_ASSERT(result, "Failed to add uninstanced animation data.");
+        }
+
+        for (const RenderSnapshot::StaticAnimationInstance& staticInstance : changes.staticInstances)
+        {
+            const auto& animationStaticInstance = registry.get<Components::AnimationStaticInstance>(staticInstance.staticEntity);
+
+            bool result = modelRenderer->SetInstanceAnimationData(staticInstance.instanceID, animationStaticInstance.boneMatrixOffset, animationStaticInstance.textureMatrixOffset);
+            NC_ASSERT(result, "Failed to set instance animation data.");
+        }
+
+        for (entt::entity entity : changes.dirtyEntities)
+        {
+            // Systems after Animation may have destroyed the entity or unloaded its model since it was simulated
+            if (!registry.valid(entity))
+                continue;
+
+            const auto* model = registry.try_get<Components::Model>(entity);
+            const auto* animationData = registry.try_get<Components::AnimationData>(entity);
+            if (!model || !animationData || !model->flags.loaded)
+                continue;
+
+            u32 numBoneTransforms = static_cast<u32>(animationData->boneTransforms.size());
+            u32 numTextureTransforms = static_cast<u32>(animationData->textureTransforms.size());
+
+            if (model->instanceID == std::numeric_limits<u32>().max())
+            {
+                const auto& animationStaticInstance = registry.get<Components::AnimationStaticInstance>(entity);
+
+                if (numBoneTransforms > 0)
+                {
+                    modelRenderer->SetUninstancedBoneMatricesAsDirty(model->modelID, animationStaticInstance.boneMatrixOffset, 0, numBoneTransforms, animationData->boneTransforms.data());
+                }
+
+                if (numTextureTransforms > 0)
+                {
+                    modelRenderer->SetUninstancedTextureTransformMatricesAsDirty(model->modelID, animationStaticInstance.textureMatrixOffset, 0, numTextureTransforms, animationData->textureTransforms.data());
+                }
+            }
+            else
+            {
+                if (numBoneTransforms > 0)
+                {
+                    modelRenderer->SetBoneMatricesAsDirty(model->instanceID, 0, numBoneTransforms, animationData->boneTransforms.data());
+                }
+
+                if (numTextureTransforms > 0)
+                {
+                    modelRenderer->SetTextureTransformMatricesAsDirty(model->instanceID, 0, numTextureTransforms, animationData->textureTransforms.data());
+                }
+            }
+        }
+    }
+
+    void Animation::HandleAnimationDataInit(entt::registry& registry, f32 deltaTime)
+    {
+        // Headless clients animate without a snapshot, their bone matrices are just never uploaded
+        RenderSnapshot* snapshot = registry.ctx().get<Singletons::RenderState>().snapshot;
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
 
         auto& animationSingleton = registry.ctx().get<Singletons::AnimationSingleton>();
         auto initView = registry.view<Components::Model, Components::AnimationInitData>();
@@ -770,16 +940,16 @@ namespace ECS::Systems
 
             if (isDynamic)
             {
-                if (wasStatic)
+                if (wasStatic && snapshot)
                 {
-                    modelRenderer->AddAnimationInstance(model.instanceID);
+                    snapshot->animation.addedInstances.push_back(model.instanceID);
                 }
 
                 SetupDynamicAnimationInstance(registry, entity, model, modelInfo);
             }
             else
             {
-                SetupStaticAnimationInstance(registry, entity, animationSingleton, model, modelInfo, modelRenderer);
+                SetupStaticAnimationInstance(registry, entity, animationSingleton, model, modelInfo, snapshot);
             }
         });
 
@@ -789,10 +959,10 @@ namespace ECS::Systems
     void Animation::HandleSimulation(entt::registry& registry, f32 deltaTime)
     {
         enki::TaskScheduler* taskScheduler = ServiceLocator::GetTaskScheduler();
-        ModelRenderer* modelRenderer = ServiceLocator::GetGameRenderer()->GetModelRenderer();
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
 
         entt::registry::context& ctx = registry.ctx();
+        RenderSnapshot* snapshot = ctx.get<Singletons::RenderState>().snapshot;
         auto& activeCamera = ctx.get<ECS::Singletons::ActiveCamera>();
         auto simulationView = registry.view<Components::Model, Components::AnimationData, Components::Transform>();
 
@@ -807,9 +977,16 @@ namespace ECS::Systems
         const auto& camera = registry.get<Components::Camera>(activeCamera.entity);
         const mat4x4* viewMatrix = &camera.worldToView;
 
+        bool isLODEnabled = CVAR_AnimationLODEnabled.Get() != 0;
+        ::Animation::LOD::Settings lodSettings = GetLODSettings();
+        vec3 cameraPosition = vec3(camera.viewToWorld[3]);
+        const vec4* frustumPlanes = camera.frustum;
+
+        std::atomic<u32> numSkippedEntities = 0;
+
         const auto& begin = viewHandle->begin();
         moodycamel::ConcurrentQueue<entt::entity> dirtyEntities(numEntitiesToHandle);
-        enki::TaskSet simulateEntitiesTask(numEntitiesToHandle, [&registry, &simulationView, &begin, &modelLoader, &dirtyEntities, viewMatrix, deltaTime](enki::TaskSetPartition range, uint32_t threadNum)
+        enki::TaskSet simulateEntitiesTask(numEntitiesToHandle, [&registry, &simulationView, &begin, &modelLoader, snapshot, &dirtyEntities, &lodSettings, frustumPlanes, &numSkippedEntities, viewMatrix, cameraPosition, isLODEnabled, deltaTime](enki::TaskSetPartition range, uint32_t threadNum)
         {
             mat4x4 identityMatrix = mat4x4(1.0f);
             for (u32 i = range.start; i < range.end; i++)
@@ -829,7 +1006,7 @@ namespace ECS::Systems
                 auto& animationData = std::get<1>(components);
 
                 const auto* modelInfo = modelLoader->GetModelInfo(model.modelHash);
-                if (!modelInfo)
+                if (!modelInfo || !animationData.trackTimes)
                     continue;
 
                 u32 numGlobalLoops = static_cast<u32>(animationData.globalLoops.size());
@@ -890,7 +1067,7 @@ namespace ECS::Systems
                             }
                             else
                             {
-                                animationState.nextSequenceIndex = Util::Animation::GetSequenceIndexForAnimation(modelInfo, animationType, animationState.timesToRepeat);
+                                animationState.nextSequenceIndex = Util::Animation::GetSequenceIndexForAnimation(modelInfo, animationType, animationState.timesToRepeat, animationData.variationRandomState);
                             }
                         }
                         else
@@ -1065,8 +1242,38 @@ namespace ECS::Systems
                 u32 numBoneInstances = static_cast<u32>(animationData.boneInstances.size());
                 if (animationStateDirtyBitMask)
                 {
+                    // Progress above keeps advancing every frame, the LOD only decides how often the pose is evaluated from it.
+                    // Shared static instances drive every placement of the model so they always run at full rate.
+                    ::Animation::LOD::Decision lodDecision;
+                    if (isLODEnabled && model.instanceID != std::numeric_limits<u32>().max())
+                    {
+                        ::Animation::LOD::Level lodLevel = GetLODLevel(registry, entity, lodSettings, animationData, frustumPlanes, cameraPosition);
+                        lodDecision = ::Animation::LOD::Step(lodSettings, animationData.lodState, lodLevel, entt::to_integral(entity));
+                    }
+
+                    if (!lodDecision.evaluate)
+                    {
+                        numSkippedEntities.fetch_add(1, std::memory_order_relaxed);
+
+                        if (lodDecision.interpolate && BlendLODPose(animationData, lodDecision.blendFactor))
+                            dirtyEntities.enqueue(entity);
+
+                        continue;
+                    }
+
                     if (numBoneInstances > 0)
                     {
+                        if (lodDecision.interpolate)
+                        {
+                            // Blend onwards from what is on screen rather than the previous target so there is no pop
+                            animationData.lodPoseFrom = animationData.boneTransforms;
+                        }
+                        else
+                        {
+                            animationData.lodPoseFrom.clear();
+                            animationData.lodPoseTo.clear();
+                        }
+
                         const auto& entityTransform = registry.get<Components::Transform>(entity);
                         mat4x4 modelViewMatrix = mul(entityTransform.GetMatrix(), *viewMatrix);
                         mat4x4 invModelViewMatrix = glm::inverse(modelViewMatrix);
@@ -1082,7 +1289,7 @@ namespace ECS::Systems
                             mat4x4 boneMatrix = mat4x4(1.0f);
                             mat4x4* parentMatrix = &modelViewMatrix;
 
-                            bool isTransformed = boneInstance.flags.Transformed;
+                            bool isTransformed = boneInstance.flags.Transformed && (lodDecision.maxBoneDepth == 0 || animationData.boneDepths[i] <= lodDecision.maxBoneDepth);
                             bool hasParent = bone.parentBoneID != -1;
 
                             if (hasParent)
@@ -1100,7 +1307,7 @@ namespace ECS::Systems
                                     rotationOffset = animationData.proceduralRotationOffsets[boneInstance.proceduralRotationOffsetIndex];
                                 }
 
-                                boneMatrix = GetBoneMatrix(animationData.globalLoops, animationState, bone, rotationOffset);
+                                boneMatrix = GetBoneMatrix(animationData.globalLoops, animationState, bone, rotationOffset, *animationData.trackTimes, i, &animationData.keyframeCursors[i * ::Animation::Keyframes::NumTrackComponents]);
                                 animationData.boneTransforms[i] = mul(boneMatrix, *parentMatrix);
                             }
                             else
@@ -1122,6 +1329,12 @@ namespace ECS::Systems
                             animationData.boneTransforms[i] = mul(animationData.boneTransforms[i], invModelViewMatrix);
                         }
 
+                        if (lodDecision.interpolate)
+                        {
+                            animationData.lodPoseTo = animationData.boneTransforms;
+                            BlendLODPose(animationData, lodDecision.blendFactor);
+                        }
+
                         ::Animation::Defines::BoneInstance& rootBoneInstance = animationData.boneInstances[0];
 
                         u32 numTextureTransforms = static_cast<u32>(animationData.textureTransforms.size());
@@ -1134,14 +1347,13 @@ namespace ECS::Systems
                             for (u32 textureTransformIndex = 0; textureTransformIndex < numTextureTransforms; textureTransformIndex++)
                             {
                                 const Model::ComplexModel::TextureTransform& textureTransform = modelInfo->textureTransforms[textureTransformIndex];
-                                mat4x4 textureTransformMatrix = GetTextureTransformMatrix(animationData.globalLoops, animationState, textureTransform);
+                                mat4x4 textureTransformMatrix = GetTextureTransformMatrix(animationData.globalLoops, animationState, textureTransform, *animationData.trackTimes, textureTransformIndex, &animationData.keyframeCursors[(numBoneInstances + textureTransformIndex) * ::Animation::Keyframes::NumTrackComponents]);
 
                                 animationData.textureTransforms[textureTransformIndex] = textureTransformMatrix;
                             }
                         }
 
-                        ModelRenderer* modelRenderer = ServiceLocator::GetGameRenderer()->GetModelRenderer();
-                        if (modelRenderer)
+                        if (snapshot)
                         {
                             dirtyEntities.enqueue(entity);
                         }
@@ -1153,42 +1365,13 @@ namespace ECS::Systems
         taskScheduler->AddTaskSetToPipe(&simulateEntitiesTask);
         taskScheduler->WaitforTask(&simulateEntitiesTask);
 
+        TracyPlot("Animation LOD Skipped Entities", static_cast<i64>(numSkippedEntities.load()));
+
         entt::entity dirtyEntity = entt::null;
 
         while (dirtyEntities.try_dequeue(dirtyEntity))
         {
-            const auto& model = registry.get<Components::Model>(dirtyEntity);
-            const auto& animationData = registry.get<Components::AnimationData>(dirtyEntity);
-
-            u32 numBoneTransforms = static_cast<u32>(animationData.boneTransforms.size());
-            u32 numTextureTransforms = static_cast<u32>(animationData.textureTransforms.size());
-
-            if (model.instanceID == std::numeric_limits<u32>().max())
-            {
-                auto& animationStaticInstance = registry.get<Components::AnimationStaticInstance>(dirtyEntity);
-
-                if (numBoneTransforms > 0)
-                {
-                    modelRenderer->SetUninstancedBoneMatricesAsDirty(model.modelID, animationStaticInstance.boneMatrixOffset, 0, numBoneTransforms, animationData.boneTransforms.data());
-                }
-
-                if (numTextureTransforms > 0)
-                {
-                    modelRenderer->SetUninstancedTextureTransformMatricesAsDirty(model.modelID, animationStaticInstance.textureMatrixOffset, 0, numTextureTransforms, animationData.textureTransforms.data());
-                }
-            }
-            else
-            {
-                if (numBoneTransforms > 0)
-                {
-                    modelRenderer->SetBoneMatricesAsDirty(model.instanceID, 0, numBoneTransforms, animationData.boneTransforms.data());
-                }
-
-                if (numTextureTransforms > 0)
-                {
-                    modelRenderer->SetTextureTransformMatricesAsDirty(model.instanceID, 0, numTextureTransforms, animationData.textureTransforms.data());
-                }
-            }
+            snapshot->animation.dirtyEntities.push_back(dirtyEntity);
         }
 #else
         simulationView.each([&](entt::entity entity, Components::Model& model, Components::AnimationData& animationData)
@@ -1197,7 +1380,7 @@ namespace ECS::Systems
                 return;
 
             const auto* modelInfo = modelLoader->GetModelInfo(model.modelHash);
-            if (!modelInfo)
+            if (!modelInfo || !animationData.trackTimes)
                 return;
 
             u32 numGlobalLoops = static_cast<u32>(animationData.globalLoops.size());
@@ -1256,7 +1439,7 @@ namespace ECS::Systems
                         }
                         else
                         {
-                            animationState.nextSequenceIndex = Util::Animation::GetSequenceIndexForAnimation(modelInfo, animationType, animationState.timesToRepeat);
+                            animationState.nextSequenceIndex = Util::Animation::GetSequenceIndexForAnimation(modelInfo, animationType, animationState.timesToRepeat, animationData.variationRandomState);
                         }
                     }
                     else
@@ -1458,7 +1641,7 @@ namespace ECS::Systems
                                     rotationOffset = animationData.proceduralRotationOffsets[boneInstance.proceduralRotationOffsetIndex];
                                 }
 
-                                boneMatrix = GetBoneMatrix(animationData.globalLoops, animationState, bone, rotationOffset);
+                                boneMatrix = GetBoneMatrix(animationData.globalLoops, animationState, bone, rotationOffset, *animationData.trackTimes, i, &animationData.keyframeCursors[i * ::Animation::Keyframes::NumTrackComponents]);
                             }
 
                             if (hasParent)
@@ -1483,41 +1666,15 @@ namespace ECS::Systems
                         for (u32 textureTransformIndex = 0; textureTransformIndex < numTextureTransforms; textureTransformIndex++)
                         {
                             const Model::ComplexModel::TextureTransform& textureTransform = modelInfo->textureTransforms[textureTransformIndex];
-                            mat4x4 textureTransformMatrix = GetTextureTransformMatrix(animationData.globalLoops, animationState, textureTransform);
+                            mat4x4 textureTransformMatrix = GetTextureTransformMatrix(animationData.globalLoops, animationState, textureTransform, *animationData.trackTimes, textureTransformIndex, &animationData.keyframeCursors[(numBoneInstances + textureTransformIndex) * ::Animation::Keyframes::NumTrackComponents]);
 
                             animationData.textureTransforms[textureTransformIndex] = textureTransformMatrix;
                         }
                     }
 
-                    ModelRenderer* modelRenderer = ServiceLocator::GetGameRenderer()->GetModelRenderer();
-                    if (modelRenderer)
+                    if (snapshot)
                     {
-                        if (model.instanceID == std::numeric_limits<u32>().max())
-                        {
-                            auto& animationStaticInstance = registry.get<Components::AnimationStaticInstance>(entity);
-
-                            if (numBoneInstances > 0)
-                            {
-                                modelRenderer->SetUninstancedBoneMatricesAsDirty(model.modelID, animationStaticInstance.boneMatrixOffset, 0, numBoneInstances, animationData.boneTransforms.data());
-                            }
-
-                            if (numTextureTransforms > 0)
-                            {
-                                modelRenderer->SetUninstancedTextureTransformMatricesAsDirty(model.modelID, animationStaticInstance.textureMatrixOffset, 0, numTextureTransforms, animationData.textureTransforms.data());
-                            }
-                        }
-                        else
-                        {
-                            if (numBoneInstances > 0)
-                            {
-                                modelRenderer->SetBoneMatricesAsDirty(model.instanceID, 0, numBoneInstances, animationData.boneTransforms.data());
-                            }
-
-                            if (numTextureTransforms > 0)
-                            {
-                                modelRenderer->SetTextureTransformMatricesAsDirty(model.instanceID, 0, numTextureTransforms, animationData.textureTransforms.data());
-                            }
-                        }
+                        snapshot->animation.dirtyEntities.push_back(entity);
                     }
                 }
 
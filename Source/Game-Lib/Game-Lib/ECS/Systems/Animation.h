@@ -2,6 +2,8 @@
 #include <Base/Types.h>
 #include <entt/fwd.hpp>
 
+struct RenderSnapshot;
+
 namespace ECS::Systems
 {
     class Animation
@@ -10,6 +12,9 @@ namespace ECS::Systems
         static void Init(entt::registry& registry);
         static void Update(entt::registry& registry, f32 deltaTime);
 
+        // Allocates and uploads the animation matrices for the changes Update left in the snapshot
+        static void ApplyToRenderers(entt::registry& registry, const RenderSnapshot& snapshot);
+
     private:
         static void HandleAnimationDataInit(entt::registry& registry, f32 deltaTime);
         static void HandleSimulation(entt::registry& registry, f32 deltaTime);
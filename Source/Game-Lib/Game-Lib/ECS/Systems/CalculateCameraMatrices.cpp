@@ -106,12 +106,17 @@ namespace ECS::Systems
                     const float halfHSide = halfVSide * camera.aspectRatio;
                     const glm::vec3 frontMultFar = camera.farClip * Front;
 
-                    gpuCamera.frustum[(size_t)FrustumPlane::Near] = EncodePlane(position + camera.nearClip * Front, Front);
-                    gpuCamera.frustum[(size_t)FrustumPlane::Far] = EncodePlane(position + frontMultFar, -Front);
-                    gpuCamera.frustum[(size_t)FrustumPlane::Right] = EncodePlane(position,glm::cross(Up, frontMultFar - Right * halfHSide));
-                    gpuCamera.frustum[(size_t)FrustumPlane::Left] = EncodePlane(position,glm::cross(frontMultFar + Right * halfHSide, Up));
-                    gpuCamera.frustum[(size_t)FrustumPlane::Top] = EncodePlane(position,glm::cross(frontMultFar - Up * halfVSide, Right));
-                    gpuCamera.frustum[(size_t)FrustumPlane::Bottom] = EncodePlane(position,glm::cross(Right, frontMultFar + Up * halfVSide));
+                    camera.frustum[(size_t)FrustumPlane::Near] = EncodePlane(position + camera.nearClip * Front, Front);
+                    camera.frustum[(size_t)FrustumPlane::Far] = EncodePlane(position + frontMultFar, -Front);
+                    camera.frustum[(size_t)FrustumPlane::Right] = EncodePlane(position,glm::cross(Up, frontMultFar - Right * halfHSide));
+                    camera.frustum[(size_t)FrustumPlane::Left] = EncodePlane(position,glm::cross(frontMultFar + Right * halfHSide, Up));
+                    camera.frustum[(size_t)FrustumPlane::Top] = EncodePlane(position,glm::cross(frontMultFar - Up * halfVSide, Right));
+                    camera.frustum[(size_t)FrustumPlane::Bottom] = EncodePlane(position,glm::cross(Right, frontMultFar + Up * halfVSide));
+                }
+
+                for (u32 i = 0; i < 6; i++)
+                {
+                    gpuCamera.frustum[i] = camera.frustum[i];
                 }
 
                 renderResources.cameras.SetDirtyElement(camera.cameraBindSlot);
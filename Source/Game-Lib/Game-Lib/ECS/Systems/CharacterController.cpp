@@ -1717,7 +1717,7 @@ namespace ECS::Systems
             name.nameHash = StringUtils::fnv1a_32(name.name.c_str(), name.name.size());
 
             transformSystem.SetWorldPosition(state.moverEntity, vec3(0.0f));
-            ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+            ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
             modelLoader->LoadDisplayIDForEntity(state.moverEntity, moverModel, Database::Unit::DisplayInfoType::Creature, 50);
             registry.emplace_or_replace<Components::PlayerTag>(state.moverEntity);
         }
@@ -1826,7 +1826,7 @@ namespace ECS::Systems
             {
                 if (auto* model = registry.try_get<Components::Model>(state->moverEntity))
                 {
-                    ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+                    ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
                     modelLoader->UnloadModelForEntity(state->moverEntity, *model);
                 }
 
@@ -41,6 +41,7 @@
 #include "Game-Lib/ECS/Util/ProximityTriggerUtil.h"
 #include "Game-Lib/ECS/Util/Transforms.h"
 #include "Game-Lib/ECS/Util/Database/SpellUtil.h"
+#include "Game-Lib/ECS/Util/Network/MessageDispatchQueue.h"
 #include "Game-Lib/ECS/Util/Network/NetworkUtil.h"
 #include "Game-Lib/Editor/SpellEditorBackend.h"
 #include "Game-Lib/Editor/CreatureAIEditorBackend.h"
@@ -59,6 +60,7 @@
 
 #include <Base/CVarSystem/CVarSystem.h>
 #include <Base/Util/DebugHandler.h>
+#include <Base/Util/Timer.h>
 
 #include <Gameplay/ECS/Components/ObjectFields.h>
 #include <Gameplay/ECS/Components/UnitFields.h>
@@ -94,6 +96,8 @@
 #include <utility>
 
 AutoCVar_Int CVAR_NetworkDirectRemoteUnitPosition(CVarCategory::Network, "directRemoteUnitPosition", "Applies remote unit movement packet positions directly instead of interpolating", 0, CVarFlags::EditCheckbox | CVarFlags::DoNotSave);
+AutoCVar_Float CVAR_NetworkMessageDispatchBudget(CVarCategory::Network, "messageDispatchBudget", "Milliseconds per frame spent dispatching received messages, the rest carry over to the next frame. 0 dispatches everything", 4.0f, CVarFlags::EditFloatDrag);
+AutoCVar_Int CVAR_NetworkCoalesceMessages(CVarCategory::Network, "coalesceMessages", "Drops unit moves and merges unit netfield updates superseded by newer ones still waiting to be dispatched", 1, CVarFlags::EditCheckbox);
 
 namespace ECS::Systems
 {
@@ -177,7 +181,7 @@ namespace ECS::Systems
         auto* itemStorage = clientDBSingleton.Get(ClientDBHash::Item);
         const auto& itemTemplate = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(itemID);
 
-        if (!ServiceLocator::GetGameRenderer()->GetModelLoader()->GetModelInfo(model->modelHash))
+        if (!ServiceLocator::GetModelLoader()->GetModelInfo(model->modelHash))
             return false;
 
         unit->attackReadyAnimation = ::Util::Unit::GetAttackReadyAnimation(itemTemplate.categoryType);
@@ -321,7 +325,7 @@ namespace ECS::Systems
             if (auto* model = registry.try_get<Components::Model>(entity))
             {
                 if (model->instanceID != std::numeric_limits<u32>().max())
-                    ServiceLocator::GetGameRenderer()->GetModelLoader()->UnloadModelForEntity(entity, *model);
+                    ServiceLocator::GetModelLoader()->UnloadModelForEntity(entity, *model);
             }
 
             registry.destroy(entity);
@@ -425,62 +429,28 @@ namespace ECS::Systems
             return true;
         }
 
-        u8 byteMaskOffset = 0;
-        u8 numMaskBytes = 0;
-
-        if (!message.buffer->GetU8(byteMaskOffset))
-            return false;
-
-        if (!message.buffer->GetU8(numMaskBytes))
-            return false;
-
-        std::vector<u8> maskBytes(numMaskBytes);
-        if (!message.buffer->GetBytes(maskBytes.data(), numMaskBytes))
+        Util::Network::NetFieldMask fieldMask;
+        if (!fieldMask.Read(*message.buffer))
             return false;
 
         auto& objectFields = registry->get<Components::ObjectFields>(entity);
 
-        // Apply NetField Updates
-        for (u32 i = 0; i < numMaskBytes; i++)
+        // The values follow the mask in field order, each one is applied and its change queued for the listeners
+        return fieldMask.ForEachField([&](u16 fieldID)
         {
-            u8 maskByte = maskBytes[i];
-
-            while (maskByte)
+            u32 data = 0;
+            if (!message.buffer->GetU32(data))
             {
-                u16 bitIndex = static_cast<u16>(std::countr_zero(maskByte));
-                maskByte &= (maskByte - 1);
-
-                u16 fieldID = static_cast<u16>(byteMaskOffset * 8 + bitIndex);
-                u32 data = 0;
-
-                if (!message.buffer->GetU32(data))
-                {
-                    NC_LOG_WARNING("Network : Failed to read Object NetField Update data for entity ({0}) fieldID ({1})", objectGUID.ToString(), fieldID);
-                    return false;
-                }
-
-                auto objectField = static_cast<MetaGen::Shared::NetField::ObjectNetFieldEnum>(fieldID);
-                objectFields.fields.SetField(objectField, data);
+                NC_LOG_WARNING("Network : Failed to read Object NetField Update data for entity ({0}) fieldID ({1})", objectGUID.ToString(), fieldID);
+                return false;
             }
-        }
-
-        // Call Field Update Callback Handlers
-        for (u32 i = 0; i < numMaskBytes; i++)
-        {
-            u8 maskByte = maskBytes[i];
-
-            while (maskByte)
-            {
-                u16 bitIndex = static_cast<u16>(std::countr_zero(maskByte));
-                maskByte &= (maskByte - 1);
 
-                u16 fieldID = static_cast<u16>(byteMaskOffset * 8 + bitIndex);
-                auto objectField = static_cast<MetaGen::Shared::NetField::ObjectNetFieldEnum>(fieldID);
-                networkState.objectNetFieldListener.NotifyFieldChanged(entity, objectGUID, objectField);
-            }
-        }
+            auto objectField = static_cast<MetaGen::Shared::NetField::ObjectNetFieldEnum>(fieldID);
+            objectFields.fields.SetField(objectField, data);
+            networkState.objectNetFieldChanges.Add(entity, objectGUID, objectField);
 
-        return true;
+            return true;
+        });
     }
     bool HandleOnUnitNetFieldUpdate(Network::SocketID socketID, Network::Message& message)
     {
@@ -504,62 +474,28 @@ namespace ECS::Systems
             return true;
         }
 
-        u8 byteMaskOffset = 0;
-        u8 numMaskBytes = 0;
-
-        if (!message.buffer->GetU8(byteMaskOffset))
-            return false;
-
-        if (!message.buffer->GetU8(numMaskBytes))
-            return false;
-
-        std::vector<u8> maskBytes(numMaskBytes);
-        if (!message.buffer->GetBytes(maskBytes.data(), numMaskBytes))
+        Util::Network::NetFieldMask fieldMask;
+        if (!fieldMask.Read(*message.buffer))
             return false;
 
         auto& unitFields = registry->get<Components::UnitFields>(entity);
 
-        // Apply NetField Updates
-        for (u32 i = 0; i < numMaskBytes; i++)
+        // The values follow the mask in field order, each one is applied and its change queued for the listeners
+        return fieldMask.ForEachField([&](u16 fieldID)
         {
-            u8 maskByte = maskBytes[i];
-
-            while (maskByte)
+            u32 data = 0;
+            if (!message.buffer->GetU32(data))
             {
-                u16 bitIndex = static_cast<u16>(std::countr_zero(maskByte));
-                maskByte &= (maskByte - 1);
-
-                u16 fieldID = static_cast<u16>(byteMaskOffset * 8 + bitIndex);
-                u32 data = 0;
-
-                if (!message.buffer->GetU32(data))
-                {
-                    NC_LOG_WARNING("Network : Failed to read Unit NetField Update data for entity ({0}) fieldID ({1})", objectGUID.ToString(), fieldID);
-                    return false;
-                }
-
-                auto unitField = static_cast<MetaGen::Shared::NetField::UnitNetFieldEnum>(fieldID);
-                unitFields.fields.SetField(unitField, data);
+                NC_LOG_WARNING("Network : Failed to read Unit NetField Update data for entity ({0}) fieldID ({1})", objectGUID.ToString(), fieldID);
+                return false;
             }
-        }
-
-        // Call Field Update Callback Handlers
-        for (u32 i = 0; i < numMaskBytes; i++)
-        {
-            u8 maskByte = maskBytes[i];
 
-            while (maskByte)
-            {
-                u16 bitIndex = static_cast<u16>(std::countr_zero(maskByte));
-                maskByte &= (maskByte - 1);
-
-                u16 fieldID = static_cast<u16>(byteMaskOffset * 8 + bitIndex);
-                auto unitField = static_cast<MetaGen::Shared::NetField::UnitNetFieldEnum>(fieldID);
-                networkState.unitNetFieldListener.NotifyFieldChanged(entity, objectGUID, unitField);
-            }
-        }
+            auto unitField = static_cast<MetaGen::Shared::NetField::UnitNetFieldEnum>(fieldID);
+            unitFields.fields.SetField(unitField, data);
+            networkState.unitNetFieldChanges.Add(entity, objectGUID, unitField);
 
-        return true;
+            return true;
+        });
     }
     bool HandleOnCombatEvent(Network::SocketID socketID, Network::Message& message)
     {
@@ -1385,8 +1321,7 @@ namespace ECS::Systems
 
         if (auto* model = registry->try_get<Components::Model>(entity))
         {
-            ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
-            modelLoader->UnloadModelForEntity(entity, *model);
+            ServiceLocator::GetModelLoader()->UnloadModelForEntity(entity, *model);
 
             registry->remove<Components::AnimationData>(entity);
         }
@@ -2465,6 +2400,7 @@ namespace ECS::Systems
             networkState.entityToNetworkID.reserve(1024);
             networkState.networkVisTree = std::make_unique<RTree<ObjectGUID, f32, 3>>();
             networkState.gameMessageRouter = std::make_unique<Network::GameMessageRouter>();
+            networkState.messageDispatchQueue = std::make_unique<Util::Network::MessageDispatchQueue>();
 
             networkState.gameMessageRouter->RegisterPacketHandler(Network::ConnectionStatus::Connected, HandleOnAuthChallenge);
             networkState.gameMessageRouter->RegisterPacketHandler(Network::ConnectionStatus::Connected, HandleOnAuthProof);
@@ -2539,7 +2475,6 @@ namespace ECS::Systems
             {
                 auto* registry = ServiceLocator::GetEnttRegistries()->gameRegistry;
                 auto& networkState = registry->ctx().get<Singletons::NetworkState>();
-                ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
 
                 auto& unitFields = registry->get<Components::UnitFields>(entity);
                 u32 levelRaceGenderClassPacked = unitFields.fields.GetField<u32>(MetaGen::Shared::NetField::UnitNetFieldEnum::LevelRaceGenderClassPacked);
@@ -2555,6 +2490,7 @@ namespace ECS::Systems
                 displayInfo.race = race;
                 displayInfo.gender = gender;
 
+                ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
                 if (!modelLoader->LoadDisplayIDForEntity(entity, model, Database::Unit::DisplayInfoType::Creature, displayID))
                 {
                     NC_LOG_WARNING("Network : Failed to load DisplayID({1}) for entity ({0})", guid.ToString(), displayID);
@@ -2684,6 +2620,11 @@ namespace ECS::Systems
                 networkState.characterListInfo.Reset();
                 networkState.pingInfo.Reset();
 
+                networkState.messageDispatchQueue->Clear();
+                networkState.messageDispatchOverrunMS = 0.0f;
+                networkState.objectNetFieldChanges.Clear();
+                networkState.unitNetFieldChanges.Clear();
+
                 networkState.asioContext.stop();
 
                 if (networkState.asioThread.joinable())
@@ -2693,18 +2634,42 @@ namespace ECS::Systems
 
                 MapLoader* mapLoader = ServiceLocator::GetGameRenderer()->GetMapLoader();
                 mapLoader->UnloadMap();
+
+                return;
             }
 
-            return;
+            // Disconnecting clears the queue, anything queued since came from an in process server like Util::FakeServer
+            // and is dispatched the same way as messages from a socket
+            if (networkState.messageDispatchQueue->GetNumQueued() == 0)
+                return;
         }
 
         // Handle 'SocketMessageEvent'
         {
             moodycamel::ConcurrentQueue<Network::SocketMessageEvent>& messageEvents = networkState.client->GetMessageEvents();
+            Util::Network::MessageDispatchQueue& messageDispatchQueue = *networkState.messageDispatchQueue;
+
+            bool coalesce = CVAR_NetworkCoalesceMessages.Get() != 0;
 
             Network::SocketMessageEvent messageEvent;
-            while (!networkState.isLoadingMap && messageEvents.try_dequeue(messageEvent))
+            while (messageEvents.try_dequeue(messageEvent))
+            {
+                messageDispatchQueue.Push(messageEvent, coalesce);
+            }
+
+            // Whatever is left over stays queued for the next frame, as does time spent past the budget
+            f32 budgetMS = CVAR_NetworkMessageDispatchBudget.GetFloat();
+            f32 availableMS = budgetMS - networkState.messageDispatchOverrunMS;
+            bool isBudgeted = budgetMS > 0.0f;
+
+            Timer dispatchTimer;
+            u32 numDispatched = 0;
+
+            // At least one message goes through every frame so a long overrun can never stall the queue
+            while (!networkState.isLoadingMap && (!isBudgeted || numDispatched == 0 || dispatchTimer.GetLifeTime() * 1000.0f < availableMS) && messageDispatchQueue.TryPop(messageEvent))
             {
+                numDispatched++;
+
                 Network::MessageHeader messageHeader;
                 if (networkState.gameMessageRouter->GetMessageHeader(messageEvent.message, messageHeader))
                 {
@@ -2717,10 +2682,35 @@ namespace ECS::Systems
 
                 // Failed to Call Handler, Close Socket
                 {
+                    networkState.numRejectedMessages++;
                     networkState.client->Stop();
                     break;
                 }
             }
+
+            f32 spentMS = dispatchTimer.GetLifeTime() * 1000.0f;
+            networkState.messageDispatchOverrunMS = isBudgeted ? glm::clamp(spentMS - availableMS, 0.0f, budgetMS) : 0.0f;
+        }
+
+        // Listeners hear about the frame's changed fields in one go, after all of the frame's updates were applied
+        {
+            ZoneScopedN("ECS::NetworkConnection::NetFieldListeners");
+
+            networkState.objectNetFieldChanges.Flush([&](const auto& change)
+            {
+                if (!registry.valid(change.entity) || !registry.all_of<Components::ObjectFields>(change.entity))
+                    return;
+
+                networkState.objectNetFieldListener.NotifyFieldChanged(change.entity, change.guid, change.field);
+            });
+
+            networkState.unitNetFieldChanges.Flush([&](const auto& change)
+            {
+                if (!registry.valid(change.entity) || !registry.all_of<Components::UnitFields>(change.entity))
+                    return;
+
+                networkState.unitNetFieldListener.NotifyFieldChanged(change.entity, change.guid, change.field);
+            });
         }
 
     }
@@ -9,6 +9,7 @@
 #include "Game-Lib/ECS/Components/UI/Widget.h"
 #include "Game-Lib/ECS/Singletons/UISingleton.h"
 #include "Game-Lib/ECS/Util/CameraUtil.h"
+#include "Game-Lib/ECS/Util/UIHitGrid.h"
 #include "Game-Lib/ECS/Util/UIUtil.h"
 #include "Game-Lib/ECS/Util/UIInputUtil.h"
 #include "Game-Lib/ECS/Util/Transform2D.h"
@@ -31,15 +32,106 @@
 #include <tracy/Tracy.hpp>
 
 #include <algorithm>
+#include <limits>
 #include <numeric>
 
 AutoCVar_Int CVAR_UIInputDebugLevel(CVarCategory::Client | CVarCategory::Rendering, "uiInputDebugLevel", "UI input debug detail: 0=off, 1=accepted/hovered, 2=in-bounds candidates, 3=discarded elements", 0);
+AutoCVar_Int CVAR_UIHitTestGrid(CVarCategory::Client, "uiHitTestGrid", "Hit test UI input against a grid of widget rects instead of walking every canvas per lookup", 1, CVarFlags::EditCheckbox);
 
 namespace ECS::Systems::UI
 {
     using UIInputCandidate = Singletons::UIInputCandidate;
 
     void RecursivelyFindHoveredInCanvas(entt::registry& registry, entt::entity entity, const vec2& mousePos, std::vector<UIInputCandidate>& allHoveredEntities, const vec2& originWorldPos, const vec2& clipMax, std::vector<Singletons::UIInputDebugRecord>* discardedRecords);
+    void RecursivelyCollectHitEntries(entt::registry& registry, entt::entity entity, entt::entity canvasEntity, const vec2& originWorldPos, const vec2& clipMax, const vec2& regionMin, const vec2& regionMax, ECS::Util::UIInput::HitGrid& hitGrid);
+
+    void SortCandidates(std::vector<UIInputCandidate>& candidates)
+    {
+        std::sort(candidates.begin(), candidates.end(), [](const UIInputCandidate& lhs, const UIInputCandidate& rhs)
+        {
+            if (lhs.sortKey != rhs.sortKey)
+                return lhs.sortKey > rhs.sortKey;
+
+            if (lhs.distanceToMouse != rhs.distanceToMouse)
+                return lhs.distanceToMouse < rhs.distanceToMouse;
+
+            return entt::to_integral(lhs.entity) < entt::to_integral(rhs.entity);
+        });
+    }
+
+    template <typename T>
+    bool HasAny(entt::registry& registry)
+    {
+        auto view = registry.view<T>();
+        return view.begin() != view.end();
+    }
+
+    // Changes the canvas walk sees right away but the hit grid only hears about once UpdateBoundingRects or CanvasRenderer processed them
+    bool HasPendingLayoutChanges(entt::registry& registry)
+    {
+        if (ECS::Transform2DSystem::Get(registry).HasMovedEntities())
+            return true;
+
+        return HasAny<Components::UI::DirtyCanvasSort>(registry) || HasAny<Components::UI::DirtyWidgetFlags>(registry) || HasAny<Components::UI::DestroyWidget>(registry) ||
+               HasAny<Components::UI::DirtyChildClipper>(registry) || HasAny<Components::UI::DirtyClipper>(registry);
+    }
+
+    bool IsHitTestedCanvas(entt::registry& registry, entt::entity canvasEntity)
+    {
+        return registry.valid(canvasEntity) && registry.all_of<Components::UI::Canvas>(canvasEntity) && !registry.all_of<Components::UI::CanvasRenderTargetTag>(canvasEntity);
+    }
+
+    void UpdateHitGrid(entt::registry& registry, Singletons::UISingleton& uiSingleton, const vec2& referenceSize)
+    {
+        // The cursor canvas moves every frame the mouse does, it is walked per lookup instead of living in the grid
+        if (uiSingleton.hitGridCursorCanvasEntity != uiSingleton.cursorCanvasEntity)
+        {
+            uiSingleton.hitGridDirtyCanvases.insert(uiSingleton.hitGridCursorCanvasEntity);
+            uiSingleton.hitGridDirtyCanvases.insert(uiSingleton.cursorCanvasEntity);
+            uiSingleton.hitGridCursorCanvasEntity = uiSingleton.cursorCanvasEntity;
+        }
+
+        uiSingleton.hitGridDirtyCanvases.erase(entt::null);
+        uiSingleton.hitGridDirtyCanvases.erase(uiSingleton.cursorCanvasEntity);
+
+        if (!uiSingleton.hitGridFullyDirty && uiSingleton.hitGridDirtyCanvases.empty())
+            return;
+
+        ZoneScopedN("UI::HandleInput::UpdateHitGrid");
+
+        const vec2 unboundedMin(std::numeric_limits<f32>::lowest());
+        const vec2 unboundedMax(std::numeric_limits<f32>::max());
+
+        auto collectCanvas = [&](entt::entity canvasEntity)
+        {
+            if (canvasEntity == uiSingleton.cursorCanvasEntity || !IsHitTestedCanvas(registry, canvasEntity))
+                return;
+
+            vec2 canvasWorldPos = registry.get<Components::Transform2D>(canvasEntity).GetWorldPosition();
+            RecursivelyCollectHitEntries(registry, canvasEntity, canvasEntity, canvasWorldPos, referenceSize, unboundedMin, unboundedMax, uiSingleton.hitGrid);
+        };
+
+        if (uiSingleton.hitGridFullyDirty)
+        {
+            uiSingleton.hitGrid.Clear();
+            registry.view<Components::UI::Canvas>(entt::exclude<Components::UI::CanvasRenderTargetTag>).each([&](auto entity, auto& canvas)
+            {
+                collectCanvas(entity);
+            });
+        }
+        else
+        {
+            for (entt::entity canvasEntity : uiSingleton.hitGridDirtyCanvases)
+            {
+                uiSingleton.hitGrid.RemoveCanvas(canvasEntity);
+                collectCanvas(canvasEntity);
+            }
+        }
+
+        uiSingleton.hitGridDirtyCanvases.clear();
+        uiSingleton.hitGridFullyDirty = false;
+        uiSingleton.hitGridVersion++;
+    }
 
     bool RebuildCandidates(entt::registry& registry, const vec2& physicalMousePosition, Singletons::UISingleton& uiSingleton, vec2& outMousePosition, bool gatherDiscarded)
     {
@@ -51,27 +143,66 @@ namespace ECS::Systems::UI
         if (!ECS::Util::UIInput::PhysicalTopLeftToReference(physicalMousePosition, renderer->GetRenderSize(), referenceSize, outMousePosition))
         {
             uiSingleton.allHoveredEntities.clear();
+            uiSingleton.hoveredEntitiesFromHitGrid = false;
             return false;
         }
 
+        // The debug view wants to know why widgets were discarded, which only the walk can tell
+        const bool useHitGrid = !gatherDiscarded && CVAR_UIHitTestGrid.Get() != 0 && !HasPendingLayoutChanges(registry);
+        if (!useHitGrid)
+        {
+            uiSingleton.allHoveredEntities.clear();
+            uiSingleton.hoveredEntitiesFromHitGrid = false;
+
+            auto* discarded = gatherDiscarded ? &uiSingleton.inputDebugSnapshot.records : nullptr;
+            registry.view<Components::UI::Canvas>(entt::exclude<Components::UI::CanvasRenderTargetTag>).each([&](auto entity, auto& canvas)
+            {
+                vec2 canvasWorldPos = registry.get<Components::Transform2D>(entity).GetWorldPosition();
+                RecursivelyFindHoveredInCanvas(registry, entity, outMousePosition, uiSingleton.allHoveredEntities, canvasWorldPos, referenceSize, discarded);
+            });
+
+            SortCandidates(uiSingleton.allHoveredEntities);
+            return true;
+        }
+
+        UpdateHitGrid(registry, uiSingleton, referenceSize);
+
+        if (uiSingleton.hoveredEntitiesFromHitGrid && uiSingleton.hoveredEntitiesHitGridVersion == uiSingleton.hitGridVersion && uiSingleton.hoveredEntitiesMousePosition == outMousePosition)
+            return true;
+
+        ZoneScopedN("UI::HandleInput::QueryHitGrid");
         uiSingleton.allHoveredEntities.clear();
-        auto* discarded = gatherDiscarded ? &uiSingleton.inputDebugSnapshot.records : nullptr;
-        registry.view<Components::UI::Canvas>(entt::exclude<Components::UI::CanvasRenderTargetTag>).each([&](auto entity, auto& canvas)
+
+        std::vector<ECS::Util::UIInput::HitGrid::Hit> hits;
+        uiSingleton.hitGrid.Query(outMousePosition, hits);
+
+        for (const ECS::Util::UIInput::HitGrid::Hit& hit : hits)
         {
-            vec2 canvasWorldPos = registry.get<Components::Transform2D>(entity).GetWorldPosition();
-            RecursivelyFindHoveredInCanvas(registry, entity, outMousePosition, uiSingleton.allHoveredEntities, canvasWorldPos, referenceSize, discarded);
-        });
+            auto* rect = registry.valid(hit.entity) ? registry.try_get<Components::UI::BoundingRect>(hit.entity) : nullptr;
+            if (rect == nullptr)
+                continue;
+
+            // Retained for compatibility with existing hover inspection, same as the walk does
+            rect->hoveredMin = hit.min;
+            rect->hoveredMax = hit.max;
+
+            uiSingleton.allHoveredEntities.push_back({ hit.entity, hit.min, hit.max, hit.sortKey, hit.distanceToPoint });
+        }
 
-        std::sort(uiSingleton.allHoveredEntities.begin(), uiSingleton.allHoveredEntities.end(), [](const UIInputCandidate& lhs, const UIInputCandidate& rhs)
+        if (IsHitTestedCanvas(registry, uiSingleton.cursorCanvasEntity))
         {
-            if (lhs.sortKey != rhs.sortKey)
-                return lhs.sortKey > rhs.sortKey;
+            size_t numGridCandidates = uiSingleton.allHoveredEntities.size();
 
-            if (lhs.distanceToMouse != rhs.distanceToMouse)
-                return lhs.distanceToMouse < rhs.distanceToMouse;
+            vec2 cursorCanvasWorldPos = registry.get<Components::Transform2D>(uiSingleton.cursorCanvasEntity).GetWorldPosition();
+            RecursivelyFindHoveredInCanvas(registry, uiSingleton.cursorCanvasEntity, outMousePosition, uiSingleton.allHoveredEntities, cursorCanvasWorldPos, referenceSize, nullptr);
 
-            return entt::to_integral(lhs.entity) < entt::to_integral(rhs.entity);
-        });
+            if (uiSingleton.allHoveredEntities.size() != numGridCandidates)
+                SortCandidates(uiSingleton.allHoveredEntities);
+        }
+
+        uiSingleton.hoveredEntitiesFromHitGrid = true;
+        uiSingleton.hoveredEntitiesHitGridVersion = uiSingleton.hitGridVersion;
+        uiSingleton.hoveredEntitiesMousePosition = outMousePosition;
         return true;
     }
 
@@ -536,6 +667,79 @@ namespace ECS::Systems::UI
         });
     }
 
+    // Mirrors RecursivelyFindHoveredInCanvas without a cursor: every widget it could accept is added to the grid with the
+    // intersection of all clip regions the walk would test the cursor against, regionMin/regionMax being the ones
+    // inherited from clipChildren ancestors.
+    void RecursivelyCollectHitEntries(entt::registry& registry, entt::entity entity, entt::entity canvasEntity, const vec2& originWorldPos, const vec2& clipMax, const vec2& regionMin, const vec2& regionMax, ECS::Util::UIInput::HitGrid& hitGrid)
+    {
+        auto& transform2DSystem = ECS::Transform2DSystem::Get(registry);
+
+        if (auto* entityWidget = registry.try_get<Components::UI::Widget>(entity); entityWidget != nullptr && !entityWidget->IsVisible())
+            return;
+
+        transform2DSystem.IterateChildren(entity, [&](entt::entity childEntity)
+        {
+            auto& widget = registry.get<Components::UI::Widget>(childEntity);
+
+            if (!widget.IsVisible())
+                return;
+
+            auto& childTransform = registry.get<Components::Transform2D>(childEntity);
+            auto* rect = registry.try_get<Components::UI::BoundingRect>(childEntity);
+            auto* clipper = registry.try_get<Components::UI::Clipper>(childEntity);
+
+            bool is3D = widget.worldTransformIndex != std::numeric_limits<u32>::max();
+            vec2 size = childTransform.GetSize();
+            vec2 worldMin = is3D ? (rect != nullptr ? rect->min : originWorldPos)
+                                 : originWorldPos + childTransform.GetLocalTranslation();
+            vec2 cappedMax = glm::min(worldMin + size, clipMax);
+
+            vec2 childRegionMin = regionMin;
+            vec2 childRegionMax = regionMax;
+            if (clipper != nullptr && clipper->clipChildren)
+            {
+                childRegionMin = glm::max(childRegionMin, worldMin + size * clipper->clipRegionMin);
+                childRegionMax = glm::min(childRegionMax, worldMin + size * clipper->clipRegionMax);
+
+                // The walk never gets past a clip region the cursor is outside of
+                if (childRegionMax.x <= childRegionMin.x || childRegionMax.y <= childRegionMin.y)
+                    return;
+            }
+
+            if (widget.IsInteractable() && widget.type != Components::UI::WidgetType::Canvas && rect != nullptr)
+            {
+                vec2 hitMin = glm::max(worldMin, childRegionMin);
+                vec2 hitMax = glm::min(cappedMax, childRegionMax);
+
+                entt::entity clipAncestor = ECS::Util::UI::GetClippingAncestor(&registry, childEntity);
+                if (clipAncestor != entt::null)
+                {
+                    auto* clipRect = registry.try_get<Components::UI::BoundingRect>(clipAncestor);
+                    auto* ancestorClipper = registry.try_get<Components::UI::Clipper>(clipAncestor);
+                    if (clipRect != nullptr && ancestorClipper != nullptr)
+                    {
+                        vec2 clipSize = clipRect->max - clipRect->min;
+                        hitMin = glm::max(hitMin, clipRect->min + clipSize * ancestorClipper->clipRegionMin);
+                        hitMax = glm::min(hitMax, clipRect->min + clipSize * ancestorClipper->clipRegionMax);
+                    }
+                }
+
+                hitGrid.Add({ childEntity, canvasEntity, worldMin, cappedMax, hitMin, hitMax, widget.sortKey });
+            }
+
+            if (widget.type == Components::UI::WidgetType::Panel)
+            {
+                auto& panelTemplate = registry.get<Components::UI::PanelTemplate>(childEntity);
+                if (panelTemplate.setFlags.backgroundRT)
+                {
+                    RecursivelyCollectHitEntries(registry, panelTemplate.backgroundRTEntity, canvasEntity, worldMin, cappedMax, childRegionMin, childRegionMax, hitGrid);
+                }
+            }
+
+            RecursivelyCollectHitEntries(registry, childEntity, canvasEntity, worldMin, clipMax, childRegionMin, childRegionMax, hitGrid);
+        });
+    }
+
     void HandleInput::Update(entt::registry& registry, f32 deltaTime)
     {
         ZoneScopedN("UI::HandleInput::Update");
@@ -560,7 +764,10 @@ namespace ECS::Systems::UI
             transform2DSystem.SetWorldPosition(uiSingleton.cursorCanvasEntity, mousePos);
 
         if (!hasValidInputCandidates)
+        {
             uiSingleton.allHoveredEntities.clear();
+            uiSingleton.hoveredEntitiesFromHitGrid = false;
+        }
 
         DebugRenderer* debugRenderer = ServiceLocator::GetGameRenderer()->GetDebugRenderer();
 
@@ -31,6 +31,7 @@ namespace ECS::Systems::UI
                 return;
 
             movedEntities.insert(entity);
+            ECS::Util::UI::MarkHitGridDirty(&registry, entity);
 
             // Every chain participant re-uploads its matrix on move -- including rect-less containers, whose
             // slot anchors their children's GPU chain. The transform pass early-outs for canvas/3D widgets.
@@ -5,10 +5,12 @@
 #include "Game-Lib/ECS/Singletons/Database/ClientDBSingleton.h"
 #include "Game-Lib/ECS/Singletons/DayNightCycle.h"
 #include "Game-Lib/ECS/Singletons/FreeflyingCameraSettings.h"
+#include "Game-Lib/ECS/Singletons/RenderState.h"
 #include "Game-Lib/ECS/Util/Transforms.h"
 #include "Game-Lib/Gameplay/MapLoader.h"
 #include "Game-Lib/Rendering/GameRenderer.h"
 #include "Game-Lib/Rendering/Material/MaterialRenderer.h"
+#include "Game-Lib/Rendering/RenderSnapshot.h"
 #include "Game-Lib/Rendering/Skybox/SkyboxRenderer.h"
 #include "Game-Lib/Util/ServiceLocator.h"
 
@@ -322,33 +324,56 @@ namespace ECS::Systems
 
         areaLightInfo.finalColorData = lightColor;
 
-        MaterialRenderer* materialRenderer = ServiceLocator::GetGameRenderer()->GetMaterialRenderer();
-        
+        // The renderers are handed the lighting in EndTick, a pipelined render thread may still be reading them here
+        RenderSnapshot::Lighting& lighting = context.get<Singletons::RenderState>().snapshot->lighting;
+        lighting.isSet = true;
+
         vec3 direction = GetLightDirection(dayNightCycle.GetTimeInSecondsF32());
-        const vec3& diffuseColor = areaLightInfo.finalColorData.diffuseColor;
-        const vec3& ambientColor = areaLightInfo.finalColorData.ambientColor;
-        const vec3& shadowColor = areaLightInfo.finalColorData.shadowColor; // Per-area authored tint, multiplied onto the shadowed directional term
+        lighting.sunDirection = direction;
+        lighting.diffuseColor = areaLightInfo.finalColorData.diffuseColor;
+        lighting.ambientColor = areaLightInfo.finalColorData.ambientColor;
+        lighting.shadowColor = areaLightInfo.finalColorData.shadowColor; // Per-area authored tint, multiplied onto the shadowed directional term
+
+        lighting.skybandTopColor = areaLightInfo.finalColorData.skybandTopColor;
+        lighting.skybandMiddleColor = areaLightInfo.finalColorData.skybandMiddleColor;
+        lighting.skybandBottomColor = areaLightInfo.finalColorData.skybandBottomColor;
+        lighting.skybandAboveHorizonColor = areaLightInfo.finalColorData.skybandAboveHorizonColor;
+        lighting.skybandHorizonColor = areaLightInfo.finalColorData.skybandHorizonColor;
+
+        // Fade shadows out as the sun approaches the horizon, below it the shadow views would project the underside of the world
+        f32 sunElevationSin = direction.y; // Positive while the sun is above the horizon
+        lighting.shadowStrength = glm::clamp(sunElevationSin / 0.1f, 0.0f, 1.0f);
+
+        lighting.fogColor = areaLightInfo.finalColorData.fogColor;
+        lighting.fogBlendBegin = areaLightInfo.finalColorData.fogEnd * areaLightInfo.finalColorData.fogScaler;
+        lighting.fogBlendEnd = areaLightInfo.finalColorData.fogEnd;
+    }
+
+    void UpdateAreaLights::ApplyToRenderers(const RenderSnapshot& snapshot)
+    {
+        const RenderSnapshot::Lighting& lighting = snapshot.lighting;
+        if (!lighting.isSet)
+            return;
+
+        MaterialRenderer* materialRenderer = ServiceLocator::GetGameRenderer()->GetMaterialRenderer();
 
         constexpr f32 diffuseIntensity = 0.7f;
         constexpr f32 ambientIntensity = 1.1f;
-        
-        if (!materialRenderer->SetDirectionalLight(0, direction, diffuseColor, diffuseIntensity, ambientColor, ambientIntensity, ambientColor, ambientIntensity, shadowColor))
+
+        if (!materialRenderer->SetDirectionalLight(0, lighting.sunDirection, lighting.diffuseColor, diffuseIntensity, lighting.ambientColor, ambientIntensity, lighting.ambientColor, ambientIntensity, lighting.shadowColor))
         {
-            materialRenderer->AddDirectionalLight(direction, diffuseColor, diffuseIntensity, ambientColor, ambientIntensity, ambientColor, ambientIntensity, shadowColor);
+            materialRenderer->AddDirectionalLight(lighting.sunDirection, lighting.diffuseColor, diffuseIntensity, lighting.ambientColor, ambientIntensity, lighting.ambientColor, ambientIntensity, lighting.shadowColor);
         }
-        
+
         SkyboxRenderer* skyboxRenderer = ServiceLocator::GetGameRenderer()->GetSkyboxRenderer();
-        skyboxRenderer->SetSkybandColors(areaLightInfo.finalColorData.skybandTopColor, areaLightInfo.finalColorData.skybandMiddleColor, areaLightInfo.finalColorData.skybandBottomColor, areaLightInfo.finalColorData.skybandAboveHorizonColor, areaLightInfo.finalColorData.skybandHorizonColor);
-        skyboxRenderer->SetSunDirection(direction); // direction points toward the sun
+        skyboxRenderer->SetSkybandColors(lighting.skybandTopColor, lighting.skybandMiddleColor, lighting.skybandBottomColor, lighting.skybandAboveHorizonColor, lighting.skybandHorizonColor);
+        skyboxRenderer->SetSunDirection(lighting.sunDirection);
 
-        // Fade shadows out as the sun approaches the horizon, below it the shadow views would project the underside of the world
-        f32 sunElevationSin = direction.y; // Positive while the sun is above the horizon
-        f32 shadowStrength = glm::clamp(sunElevationSin / 0.1f, 0.0f, 1.0f);
-        *CVarSystem::Get()->GetFloatCVar(CVarCategory::Client | CVarCategory::Rendering, "shadowStrength"_h) = shadowStrength;
+        *CVarSystem::Get()->GetFloatCVar(CVarCategory::Client | CVarCategory::Rendering, "shadowStrength"_h) = lighting.shadowStrength;
 
-        *CVarSystem::Get()->GetVecFloatCVar(CVarCategory::Client | CVarCategory::Rendering, "fogColor"_h) = vec4(areaLightInfo.finalColorData.fogColor, 1.0f);
-        *CVarSystem::Get()->GetFloatCVar(CVarCategory::Client | CVarCategory::Rendering, "fogBlendBegin"_h) = areaLightInfo.finalColorData.fogEnd * areaLightInfo.finalColorData.fogScaler;
-        *CVarSystem::Get()->GetFloatCVar(CVarCategory::Client | CVarCategory::Rendering, "fogBlendEnd"_h) = areaLightInfo.finalColorData.fogEnd;
+        *CVarSystem::Get()->GetVecFloatCVar(CVarCategory::Client | CVarCategory::Rendering, "fogColor"_h) = vec4(lighting.fogColor, 1.0f);
+        *CVarSystem::Get()->GetFloatCVar(CVarCategory::Client | CVarCategory::Rendering, "fogBlendBegin"_h) = lighting.fogBlendBegin;
+        *CVarSystem::Get()->GetFloatCVar(CVarCategory::Client | CVarCategory::Rendering, "fogBlendEnd"_h) = lighting.fogBlendEnd;
     }
 
     struct CurveKey
@@ -2,6 +2,8 @@
 #include <Base/Types.h>
 #include <entt/fwd.hpp>
 
+struct RenderSnapshot;
+
 namespace ECS::Systems
 {
     // Quantizes the time of day used for the shadow sun direction, see shadowSunUpdateInterval
@@ -13,6 +15,9 @@ namespace ECS::Systems
         static void Init(entt::registry& registry);
         static void Update(entt::registry& registry, f32 deltaTime);
 
+        // Sets the lighting Update left in the snapshot on the material and skybox renderers, the shadows and the fog
+        static void ApplyToRenderers(const RenderSnapshot& snapshot);
+
         static vec3 GetLightDirection(f32 timeOfDay);
     };
 }
\ No newline at end of file
@@ -28,6 +28,8 @@ using namespace JPH::literals;
 
 AutoCVar_Int CVAR_PhysicsEnabled(CVarCategory::Client | CVarCategory::Physics, "enabled", "enables the physics engine", 1, CVarFlags::EditCheckbox);
 AutoCVar_Int CVAR_PhysicsOptimizeBP(CVarCategory::Client | CVarCategory::Physics, "optimizeBP", "enables automatically optimizing the broadphase during load", 1, CVarFlags::EditCheckbox);
+AutoCVar_Int CVAR_PhysicsBodyBatchSize(CVarCategory::Client | CVarCategory::Physics, "bodyBatchSize", "maximum static bodies inserted into the broadphase per batch while loading, 0 adds them one at a time", 1024, CVarFlags::None);
+AutoCVar_Int CVAR_PhysicsEnkiJobSystem(CVarCategory::Client | CVarCategory::Physics, "enkiJobSystem", "runs the physics jobs on the shared enkiTS workers instead of a thread pool of their own, applied at startup", 1, CVarFlags::EditCheckbox);
 
 namespace ECS::Systems
 {
@@ -61,6 +63,7 @@ namespace ECS::Systems
             // Add it to the world
             JPH::BodyID bodyID = body->GetID();
             bodyInterface.AddBody(bodyID, JPH::EActivation::DontActivate);
+            joltState.MarkStaticWorldChanged();
         }
     }
 
@@ -145,7 +148,8 @@ namespace ECS::Systems
 
         // We must initialize Jolt before creating the JoltState Singleton as it depends on Jolt
         auto& joltState = ctx.emplace<Singletons::JoltState>();
-        
+        joltState.CreateJobSystem(CVAR_PhysicsEnkiJobSystem.Get() ? ServiceLocator::GetTaskScheduler() : nullptr);
+
         joltState.physicsSystem.Init(Jolt::Settings::maxBodies, Jolt::Settings::numBodyMutexes, Jolt::Settings::maxBodyPairs, Jolt::Settings::maxContactConstraints, joltState.broadPhaseLayerInterface, joltState.objectVSBroadPhaseLayerFilter, joltState.objectVSObjectLayerFilter);
         joltState.physicsSystem.SetBodyActivationListener(&joltState.bodyActivationListener);
         joltState.physicsSystem.SetContactListener(&joltState.contactListener);
@@ -214,12 +218,9 @@ namespace ECS::Systems
         if (joltState.updateTimer < joltState.FixedDeltaTime)
             return;
 
-        GameRenderer* gameRenderer = ServiceLocator::GetGameRenderer();
-        DebugRenderer* debugRenderer = gameRenderer->GetDebugRenderer();
-
         // Step the world
         {
-            joltState.physicsSystem.Update(joltState.FixedDeltaTime, 4, &joltState.allocator, &joltState.scheduler);
+            joltState.physicsSystem.Update(joltState.FixedDeltaTime, 4, &joltState.allocator, joltState.jobSystem.get());
             joltState.RefreshPhysicsTelemetryHighWater();
         }
     }
@@ -151,7 +151,7 @@ namespace ECS::Systems
         }
 
         // Debug draw triggers
-        if (CVAR_DebugDrawTriggers.Get() == ShowFlag::ENABLED)
+        if (CVAR_DebugDrawTriggers.Get() == ShowFlag::ENABLED && ServiceLocator::GetGameRenderer())
         {
             DebugRenderer* debugRenderer = ServiceLocator::GetGameRenderer()->GetDebugRenderer();
 
@@ -22,7 +22,8 @@ namespace ECS::Systems
 
         auto& renderState = registry.ctx().get<ECS::Singletons::RenderState>();
 
-        Editor::TerrainEditSession* terrainEditSession = ServiceLocator::GetGameRenderer()->GetTerrainEditSession();
+        GameRenderer* gameRenderer = ServiceLocator::GetGameRenderer();
+        Editor::TerrainEditSession* terrainEditSession = gameRenderer ? gameRenderer->GetTerrainEditSession() : nullptr;
         if (terrainEditSession)
             terrainEditSession->Update(deltaTime);
 
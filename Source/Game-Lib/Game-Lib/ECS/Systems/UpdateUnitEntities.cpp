@@ -2,6 +2,7 @@
 
 #include "Game-Lib/ECS/Components/AnimationData.h"
 #include "Game-Lib/ECS/Components/AttachmentData.h"
+#include "Game-Lib/ECS/Components/CastInfo.h"
 #include "Game-Lib/ECS/Components/DisplayInfo.h"
 #include "Game-Lib/ECS/Components/Events.h"
 #include "Game-Lib/ECS/Components/Model.h"
@@ -11,15 +12,18 @@
 #include "Game-Lib/ECS/Components/Unit.h"
 #include "Game-Lib/ECS/Components/UnitCustomization.h"
 #include "Game-Lib/ECS/Components/UnitEquipment.h"
+#include "Game-Lib/ECS/Components/UnitMovementOverTime.h"
 #include "Game-Lib/ECS/Components/UnitPowersComponent.h"
 #include "Game-Lib/ECS/Components/UnitResistancesComponent.h"
 #include "Game-Lib/ECS/Components/UnitStatsComponent.h"
 #include "Game-Lib/ECS/Singletons/CharacterSingleton.h"
 #include "Game-Lib/ECS/Singletons/Database/ClientDBSingleton.h"
 #include "Game-Lib/ECS/Singletons/Database/UnitCustomizationSingleton.h"
-#include "Game-Lib/ECS/Singletons/Database/TextureSingleton.h"
+#include "Game-Lib/ECS/Singletons/RenderState.h"
+#include "Game-Lib/ECS/Singletons/UnitPoseSingleton.h"
 #include "Game-Lib/ECS/Util/RemoteUnitPresentation.h"
 #include "Game-Lib/ECS/Util/Transforms.h"
+#include "Game-Lib/ECS/Util/UnitPose.h"
 #include "Game-Lib/ECS/Util/Database/TextureUtil.h"
 #include "Game-Lib/ECS/Util/Database/UnitCustomizationUtil.h"
 #include "Game-Lib/Gameplay/Animation/Defines.h"
@@ -62,49 +66,36 @@ namespace ECS::Systems
         JPH::BodyID _bodyID;
     };
 
-    void UpdateUnitEntities::Init(entt::registry& registry)
-    {
-    }
-
-    void SetOrientation(vec4& settings, f32 orientation, f32 timeToChange = 0.15f)
+    static void OnUnitCustomizationDestroyed(entt::registry& registry, entt::entity entity)
     {
-        f32 currentOrientation = settings.x;
-        if (orientation == currentOrientation)
+        if (!ServiceLocator::GetGameRenderer())
             return;
 
-        settings.y = orientation;
-        settings.z = timeToChange;
-        settings.w = 0.0f;
-    };
+        auto& unitCustomization = registry.get<Components::UnitCustomization>(entity);
+        ::Util::Unit::ReleaseSkinTextures(unitCustomization);
+    }
 
-    bool HandleUpdateOrientation(vec4& settings, f32 deltaTime)
+    void UpdateUnitEntities::Init(entt::registry& registry)
     {
-        if (settings.x == settings.y)
-            return false;
-
-        settings.w += deltaTime;
-        settings.w = glm::clamp(settings.w, 0.0f, settings.z);
+        registry.on_destroy<Components::UnitCustomization>().connect<&OnUnitCustomizationDestroyed>();
 
-        f32 progress = settings.w / settings.z;
-        settings.x = glm::mix(settings.x, settings.y, progress);
-
-        return true;
-    };
+        registry.ctx().emplace<Singletons::UnitPoseSingleton>();
+        Util::RemoteUnitPresentation::Init(registry);
+    }
 
     void UpdateUnitEntities::Update(entt::registry& registry, f32 deltaTime)
     {
         ZoneScopedN("ECS::UpdateUnitEntities");
 
-        TransformSystem& transformSystem = TransformSystem::Get(registry);
         auto& characterSingleton = registry.ctx().get<Singletons::CharacterSingleton>();
 
         entt::registry* dbRegistry = ServiceLocator::GetEnttRegistries()->dbRegistry;
         auto& clientDBSingleton = dbRegistry->ctx().get<Singletons::ClientDBSingleton>();
         auto& unitCustomizationSingleton = dbRegistry->ctx().get<Singletons::UnitCustomizationSingleton>();
-        auto& textureSingleton = dbRegistry->ctx().get<Singletons::TextureSingleton>();
 
+        // Headless clients load models without a GameRenderer, they get skeletons and geosets but no skin textures
         GameRenderer* gameRenderer = ServiceLocator::GetGameRenderer();
-        ModelLoader* modelLoader = gameRenderer->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
 
         auto modelLoadedEventView = registry.view<Components::ModelLoadedEvent>();
         if (modelLoadedEventView.size() > 0)
@@ -172,7 +163,7 @@ namespace ECS::Systems
                             }
                         }
 
-                        if (unitCustomization->flags.useCustomSkin)
+                        if (unitCustomization->flags.useCustomSkin && gameRenderer)
                         {
                             unitCustomization->flags.forceRefresh = true;
                             registry.emplace_or_replace<ECS::Components::UnitRebuildSkinTexture>(entity);
@@ -236,120 +227,52 @@ namespace ECS::Systems
 
         Util::RemoteUnitPresentation::Update(registry, deltaTime);
 
+        // Units only touch their own components while their pose is updated, so that part runs in task ranges. Removing
+        // components and moving attachment entities is shared state, those are committed from this thread afterwards
+        auto& unitPoseSingleton = registry.ctx().get<Singletons::UnitPoseSingleton>();
+        Util::UnitPose::CommitList& unitCommits = unitPoseSingleton.commits;
+        unitCommits.Reset();
+
         auto unitView = registry.view<Components::Unit, Components::Model, Components::AnimationData, Components::MovementInfo>();
-        unitView.each([&](entt::entity entity, Components::Unit& unit, Components::Model& model, Components::AnimationData& animationData, Components::MovementInfo& movementInfo)
+        for (entt::entity entity : unitView)
         {
-            if (!registry.all_of<>(entity))
-                return;
+            unitCommits.Add(entity);
+        }
+
+        // try_get creates a missing storage, which must not happen from the task ranges
+        registry.storage<Components::AttachmentData>();
+        registry.storage<Components::CastInfo>();
+        registry.storage<Components::UnitMovementOverTime>();
+
+        u64 frameNumber = registry.ctx().get<Singletons::RenderState>().frameNumber;
+
+        Util::UnitPose::UpdateUnits(unitCommits, ServiceLocator::GetTaskScheduler(), [&](Util::UnitPose::Commit& commit)
+        {
+            auto [unit, model, animationData, movementInfo] = unitView.get(commit.entity);
 
             if (unit.overrideAnimation == ::Animation::Defines::Type::Invalid)
-                ::Util::Unit::UpdateAnimationState(registry, entity, model, deltaTime);
+                ::Util::Unit::UpdateAnimationState(registry, commit.entity, model, deltaTime, commit.removeCastInfo);
 
             const auto* modelInfo = modelLoader->GetModelInfo(model.modelHash);
 
-            if (auto* attachmentData = registry.try_get<Components::AttachmentData>(entity))
+            if (auto* attachmentData = registry.try_get<Components::AttachmentData>(commit.entity))
             {
                 if (modelInfo)
-                {
-                    for (auto& pair : attachmentData->attachmentToInstance)
-                    {
-                        ::Util::Attachment::CalculateAttachmentMatrix(modelInfo, animationData, pair.first, pair.second);
-                    }
-                }
+                    Util::UnitPose::CalculateAttachmentTransforms(modelInfo, animationData, *attachmentData, frameNumber, commit.attachmentTransforms);
             }
 
-            auto& unitPowersComponent = registry.get<Components::UnitPowersComponent>(entity);
+            auto& unitPowersComponent = registry.get<Components::UnitPowersComponent>(commit.entity);
             auto& healthPower = ::Util::Unit::GetPower(unitPowersComponent, MetaGen::Shared::Unit::PowerTypeEnum::Health);
 
             bool isAlive = healthPower.current > 0.0f;
             if (!isAlive)
                 return;
 
-            bool isMovingForward = movementInfo.movementFlags.forward;
-            bool isMovingBackward = movementInfo.movementFlags.backward;
-            bool isMovingLeft = movementInfo.movementFlags.left;
-            bool isMovingRight = movementInfo.movementFlags.right;
-            bool isGrounded = movementInfo.movementFlags.grounded;
-            bool isFlying = !isGrounded && movementInfo.movementFlags.flying;
-
-            if (isAlive && modelInfo && (isGrounded || isFlying /* || (canControlInAir && isMoving))*/))
-            {
-                f32 spineOrientation = 0.0f;
-                f32 headOrientation = 0.0f;
-                f32 waistOrientation = 0.0f;
-
-                if (!isFlying)
-                {
-                    if (isMovingForward)
-                    {
-                        if (isMovingRight)
-                        {
-                            spineOrientation = -30.0f;
-                            headOrientation = -30.0f;
-                            waistOrientation = 45.0f;
-                        }
-                        else if (isMovingLeft)
-                        {
-                            spineOrientation = 30.0f;
-                            headOrientation = 30.0f;
-                            waistOrientation = -45.0f;
-                        }
-                    }
-                    else if (isMovingBackward)
-                    {
-                        if (isMovingRight)
-                        {
-                            spineOrientation = 30.0f;
-                            headOrientation = 15.0f;
-                            waistOrientation = -45.0f;
-                        }
-                        else if (isMovingLeft)
-                        {
-                            spineOrientation = -30.0f;
-                            headOrientation = -15.0f;
-                            waistOrientation = 45.0f;
-                        }
-                    }
-                    else if (isMovingRight)
-                    {
-                        spineOrientation = -45.0f;
-                        headOrientation = -30.0f;
-                        waistOrientation = 90.0f;
-                    }
-                    else if (isMovingLeft)
-                    {
-                        spineOrientation = 45.0f;
-                        headOrientation = 30.0f;
-                        waistOrientation = -90.0f;
-                    }
-                }
-
-                f32 timeToChange = 0.1f;
-                if (!isMovingForward && !isMovingBackward && spineOrientation == 0.0f && headOrientation == 0.0f && waistOrientation == 0.0f)
-                    timeToChange = 0.35f;
-
-                SetOrientation(movementInfo.spineRotationSettings, spineOrientation, timeToChange);
-                SetOrientation(movementInfo.headRotationSettings, headOrientation, timeToChange);
-                SetOrientation(movementInfo.rootRotationSettings, waistOrientation, timeToChange);
-            }
-
-            if (HandleUpdateOrientation(movementInfo.spineRotationSettings, deltaTime))
-            {
-                quat rotation = glm::quat(glm::vec3(0.0f, glm::radians(movementInfo.spineRotationSettings.x), 0.0f));
-                ::Util::Animation::SetBoneRotation(modelInfo, animationData, ::Animation::Defines::Bone::SpineLow, rotation);
-            }
-            if (HandleUpdateOrientation(movementInfo.headRotationSettings, deltaTime))
-            {
-                quat rotation = glm::quat(glm::vec3(0.0f, glm::radians(movementInfo.headRotationSettings.x), 0.0f));
-                ::Util::Animation::SetBoneRotation(modelInfo, animationData, ::Animation::Defines::Bone::Head, rotation);
-            }
-            if (HandleUpdateOrientation(movementInfo.rootRotationSettings, deltaTime))
-            {
-                quat rotation = glm::quat(glm::vec3(0.0f, glm::radians(movementInfo.rootRotationSettings.x), 0.0f));
-                ::Util::Animation::SetBoneRotation(modelInfo, animationData, ::Animation::Defines::Bone::Default, rotation);
-            }
+            Util::UnitPose::UpdateOrientation(modelInfo, animationData, movementInfo, deltaTime);
         });
 
+        Util::UnitPose::ApplyCommits(registry, unitCommits);
+
         auto* itemStorage = clientDBSingleton.Get(ClientDBHash::Item);
 
         auto unitVisualEquipmentView = registry.view<const Components::Unit, const Components::DisplayInfo, const Components::Model, const Components::UnitCustomization, Components::UnitEquipment, Components::UnitVisualEquipmentDirty>();
@@ -456,142 +379,66 @@ namespace ECS::Systems
 
         registry.clear<Components::UnitRebuildGeosets>();
 
-        TextureRenderer* textureRenderer = ServiceLocator::GetGameRenderer()->GetTextureRenderer();
         auto& itemSingleton = dbRegistry->ctx().get<Singletons::ItemSingleton>();
 
+        // Units whose customization textures finished loading composite their skin again
+        auto unitSkinTexturesLoadingView = registry.view<const Components::UnitCustomization, Components::UnitSkinTexturesLoading>();
+        unitSkinTexturesLoadingView.each([&](entt::entity entity, const Components::UnitCustomization& unitCustomization)
+        {
+            if (::Util::Unit::IsLoadingSkinTextures(unitCustomization))
+                return;
+
+            registry.emplace_or_replace<Components::UnitRebuildSkinTexture>(entity);
+        });
+
+        // Items drawn over the skin, in the order they are written
+        std::vector<u32> skinItemDisplayIDs;
+        skinItemDisplayIDs.reserve(9);
+
         auto UnitRebuildSkinTextureView = registry.view<const Components::Unit, Components::UnitCustomization, const Components::Model, Components::DisplayInfo, ECS::Components::UnitRebuildSkinTexture>();
         UnitRebuildSkinTextureView.each([&](entt::entity entity, const Components::Unit& unit, Components::UnitCustomization& unitCustomization, const Components::Model& model, Components::DisplayInfo& displayInfo)
         {
-            if (!model.flags.loaded)
+            if (!gameRenderer || !model.flags.loaded)
                 return;
 
-            ::Util::Unit::RefreshSkinTexture(*dbRegistry, entity, clientDBSingleton, unitCustomizationSingleton, displayInfo, unitCustomization, model);
+            skinItemDisplayIDs.clear();
 
             if (auto* unitEquipment = registry.try_get<Components::UnitEquipment>(entity))
             {
-                if (!unitCustomization.flags.hasGloveModel)
-                {
-                    u32 glovesID = unitEquipment->equipmentSlotToVisualItemID[(u32)MetaGen::Shared::Unit::ItemEquipSlotEnum::Gloves];
-                    if (glovesID > 0)
-                    {
-                        if (itemStorage->Has(glovesID))
-                        {
-                            auto& item = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(glovesID);
-                            if (item.displayID > 0)
-                            {
-                                ECSUtil::UnitCustomization::WriteItemToSkin(textureSingleton, clientDBSingleton, itemSingleton, unitCustomizationSingleton, unitCustomization, item.displayID);
-                            }
-                        }
-                    }
-                }
-
-                u32 shirtID = unitEquipment->equipmentSlotToVisualItemID[(u32)MetaGen::Shared::Unit::ItemEquipSlotEnum::Shirt];
-                if (shirtID > 0)
-                {
-                    if (itemStorage->Has(shirtID))
-                    {
-                        auto& item = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(shirtID);
-                        if (item.displayID > 0)
-                        {
-                            ECSUtil::UnitCustomization::WriteItemToSkin(textureSingleton, clientDBSingleton, itemSingleton, unitCustomizationSingleton, unitCustomization, item.displayID);
-                        }
-                    }
-                }
-
-                u32 bracersID = unitEquipment->equipmentSlotToVisualItemID[(u32)MetaGen::Shared::Unit::ItemEquipSlotEnum::Bracers];
-                if (bracersID > 0)
+                auto addSkinItem = [&](MetaGen::Shared::Unit::ItemEquipSlotEnum equipSlot)
                 {
-                    if (itemStorage->Has(bracersID))
-                    {
-                        auto& item = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(bracersID);
-                        if (item.displayID > 0)
-                        {
-                            ECSUtil::UnitCustomization::WriteItemToSkin(textureSingleton, clientDBSingleton, itemSingleton, unitCustomizationSingleton, unitCustomization, item.displayID);
-                        }
-                    }
-                }
+                    u32 itemID = unitEquipment->equipmentSlotToVisualItemID[(u32)equipSlot];
+                    if (itemID == 0 || !itemStorage->Has(itemID))
+                        return;
 
-                u32 bootsID = unitEquipment->equipmentSlotToVisualItemID[(u32)MetaGen::Shared::Unit::ItemEquipSlotEnum::Boots];
-                if (bootsID > 0)
-                {
-                    if (itemStorage->Has(bootsID))
-                    {
-                        auto& item = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(bootsID);
-                        if (item.displayID > 0)
-                        {
-                            ECSUtil::UnitCustomization::WriteItemToSkin(textureSingleton, clientDBSingleton, itemSingleton, unitCustomizationSingleton, unitCustomization, item.displayID);
-                        }
-                    }
-                }
+                    auto& item = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(itemID);
+                    if (item.displayID > 0)
+                        skinItemDisplayIDs.push_back(item.displayID);
+                };
 
-                u32 pantsID = unitEquipment->equipmentSlotToVisualItemID[(u32)MetaGen::Shared::Unit::ItemEquipSlotEnum::Pants];
-                if (pantsID > 0)
-                {
-                    if (itemStorage->Has(pantsID))
-                    {
-                        auto& item = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(pantsID);
-                        if (item.displayID > 0)
-                        {
-                            ECSUtil::UnitCustomization::WriteItemToSkin(textureSingleton, clientDBSingleton, itemSingleton, unitCustomizationSingleton, unitCustomization, item.displayID);
-                        }
-                    }
-                }
+                if (!unitCustomization.flags.hasGloveModel)
+                    addSkinItem(MetaGen::Shared::Unit::ItemEquipSlotEnum::Gloves);
 
-                u32 chestID = unitEquipment->equipmentSlotToVisualItemID[(u32)MetaGen::Shared::Unit::ItemEquipSlotEnum::Chest];
-                if (chestID > 0)
-                {
-                    if (itemStorage->Has(chestID))
-                    {
-                        auto& item = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(chestID);
-                        if (item.displayID > 0)
-                        {
-                            ECSUtil::UnitCustomization::WriteItemToSkin(textureSingleton, clientDBSingleton, itemSingleton, unitCustomizationSingleton, unitCustomization, item.displayID);
-                        }
-                    }
-                }
+                addSkinItem(MetaGen::Shared::Unit::ItemEquipSlotEnum::Shirt);
+                addSkinItem(MetaGen::Shared::Unit::ItemEquipSlotEnum::Bracers);
+                addSkinItem(MetaGen::Shared::Unit::ItemEquipSlotEnum::Boots);
+                addSkinItem(MetaGen::Shared::Unit::ItemEquipSlotEnum::Pants);
+                addSkinItem(MetaGen::Shared::Unit::ItemEquipSlotEnum::Chest);
 
                 if (unitCustomization.flags.hasGloveModel)
-                {
-                    u32 glovesID = unitEquipment->equipmentSlotToVisualItemID[(u32)MetaGen::Shared::Unit::ItemEquipSlotEnum::Gloves];
-                    if (glovesID > 0)
-                    {
-                        if (itemStorage->Has(glovesID))
-                        {
-                            auto& item = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(glovesID);
-                            if (item.displayID > 0)
-                            {
-                                ECSUtil::UnitCustomization::WriteItemToSkin(textureSingleton, clientDBSingleton, itemSingleton, unitCustomizationSingleton, unitCustomization, item.displayID);
-                            }
-                        }
-                    }
-                }
+                    addSkinItem(MetaGen::Shared::Unit::ItemEquipSlotEnum::Gloves);
 
-                u32 beltID = unitEquipment->equipmentSlotToVisualItemID[(u32)MetaGen::Shared::Unit::ItemEquipSlotEnum::Belt];
-                if (beltID > 0)
-                {
-                    if (itemStorage->Has(beltID))
-                    {
-                        auto& item = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(beltID);
-                        if (item.displayID > 0)
-                        {
-                            ECSUtil::UnitCustomization::WriteItemToSkin(textureSingleton, clientDBSingleton, itemSingleton, unitCustomizationSingleton, unitCustomization, item.displayID);
-                        }
-                    }
-                }
+                addSkinItem(MetaGen::Shared::Unit::ItemEquipSlotEnum::Belt);
+                addSkinItem(MetaGen::Shared::Unit::ItemEquipSlotEnum::Tabard);
+            }
 
-                u32 tabardID = unitEquipment->equipmentSlotToVisualItemID[(u32)MetaGen::Shared::Unit::ItemEquipSlotEnum::Tabard];
-                if (tabardID > 0)
-                {
-                    if (itemStorage->Has(tabardID))
-                    {
-                        auto& item = itemStorage->Get<MetaGen::Shared::ClientDB::ItemRecord>(tabardID);
-                        if (item.displayID > 0)
-                        {
-                            ECSUtil::UnitCustomization::WriteItemToSkin(textureSingleton, clientDBSingleton, itemSingleton, unitCustomizationSingleton, unitCustomization, item.displayID);
-                        }
-                    }
-                }
+            if (!::Util::Unit::RefreshSkinTexture(*dbRegistry, entity, clientDBSingleton, itemSingleton, unitCustomizationSingleton, displayInfo, unitCustomization, model, skinItemDisplayIDs))
+            {
+                registry.emplace_or_replace<Components::UnitSkinTexturesLoading>(entity);
+                return;
             }
+
+            registry.remove<Components::UnitSkinTexturesLoading>(entity);
         });
 
         registry.clear<Components::UnitRebuildSkinTexture>();
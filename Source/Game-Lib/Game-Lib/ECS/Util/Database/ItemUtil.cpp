@@ -6,6 +6,7 @@
 #include "Game-Lib/Gameplay/Database/Item.h"
 #include "Game-Lib/Rendering/GameRenderer.h"
 #include "Game-Lib/Rendering/Model/ModelLoader.h"
+#include "Game-Lib/Util/ClientDBUtil.h"
 #include "Game-Lib/Util/ServiceLocator.h"
 
 #include <MetaGen/Shared/ClientDB/ClientDB.h>
@@ -14,16 +15,35 @@
 
 namespace ECSUtil::Item
 {
-    bool Refresh()
-    {
-        entt::registry* registry = ServiceLocator::GetEnttRegistries()->dbRegistry;
-        auto& ctx = registry->ctx();
+    static constexpr u32 LOOKUP_SNAPSHOT_SCHEMA_VERSION = 2;
 
-        if (!ctx.contains<ECS::Singletons::ItemSingleton>())
-            ctx.emplace<ECS::Singletons::ItemSingleton>();
+    static constexpr ClientDBHash LookupSourceDBs[] =
+    {
+        ClientDBHash::Item,
+        ClientDBHash::ItemStatTemplate,
+        ClientDBHash::ItemArmorTemplate,
+        ClientDBHash::ItemWeaponTemplate,
+        ClientDBHash::ItemShieldTemplate,
+        ClientDBHash::ItemEffects,
+        ClientDBHash::Spell
+    };
+
+    namespace LookupSnapshotSection
+    {
+        enum : u32
+        {
+            ItemIDs,
+            StatTemplateIDs,
+            ArmorTemplateIDs,
+            WeaponTemplateIDs,
+            ShieldTemplateIDs,
+            EffectMappings,
+            EffectIDs
+        };
+    }
 
-        auto& itemSingleton = ctx.get<ECS::Singletons::ItemSingleton>();
-        
+    static void ClearItemLookups(ECS::Singletons::ItemSingleton& itemSingleton)
+    {
         itemSingleton.itemIDs.clear();
         itemSingleton.itemIDToStatTemplateID.clear();
         itemSingleton.itemIDToArmorTemplateID.clear();
@@ -31,6 +51,122 @@ namespace ECSUtil::Item
         itemSingleton.itemIDToShieldTemplateID.clear();
         itemSingleton.itemIDToEffectMapping.clear();
         itemSingleton.itemEffectIDs.clear();
+    }
+
+    static void BuildItemLookups(ECS::Singletons::ItemSingleton& itemSingleton, ECS::Singletons::ClientDBSingleton& clientDBSingleton)
+    {
+        ClearItemLookups(itemSingleton);
+
+        auto* itemStorage = clientDBSingleton.Get(ClientDBHash::Item);
+        auto* itemStatTemplateStorage = clientDBSingleton.Get(ClientDBHash::ItemStatTemplate);
+        auto* itemArmorTemplateStorage = clientDBSingleton.Get(ClientDBHash::ItemArmorTemplate);
+        auto* itemWeaponTemplateStorage = clientDBSingleton.Get(ClientDBHash::ItemWeaponTemplate);
+        auto* itemShieldTemplateStorage = clientDBSingleton.Get(ClientDBHash::ItemShieldTemplate);
+
+        auto* spellStorage = clientDBSingleton.Get(ClientDBHash::Spell);
+        auto* itemEffectsStorage = clientDBSingleton.Get(ClientDBHash::ItemEffects);
+
+        u32 numItems = itemStorage->GetNumRows();
+        u32 numItemEffects = itemEffectsStorage->GetNumRows();
+
+        itemSingleton.itemIDs.reserve(numItems);
+        itemSingleton.itemIDToStatTemplateID.reserve(numItems);
+        itemSingleton.itemIDToArmorTemplateID.reserve(numItems);
+        itemSingleton.itemIDToWeaponTemplateID.reserve(numItems);
+        itemSingleton.itemIDToShieldTemplateID.reserve(numItems);
+        itemSingleton.itemIDToEffectMapping.reserve(numItems);
+        itemSingleton.itemEffectIDs.reserve(numItemEffects);
+
+        itemStorage->Each([&](u32 id, MetaGen::Shared::ClientDB::ItemRecord& item) -> bool
+        {
+            itemSingleton.itemIDs.insert(id);
+
+            if (item.statTemplateID > 0 && itemStatTemplateStorage->Has(item.statTemplateID))
+                itemSingleton.itemIDToStatTemplateID[id] = item.statTemplateID;
+
+            if (item.armorTemplateID > 0 && itemArmorTemplateStorage->Has(item.armorTemplateID))
+                itemSingleton.itemIDToArmorTemplateID[id] = item.armorTemplateID;
+
+            if (item.weaponTemplateID > 0 && itemWeaponTemplateStorage->Has(item.weaponTemplateID))
+                itemSingleton.itemIDToWeaponTemplateID[id] = item.weaponTemplateID;
+
+            if (item.shieldTemplateID > 0 && itemShieldTemplateStorage->Has(item.shieldTemplateID))
+                itemSingleton.itemIDToShieldTemplateID[id] = item.shieldTemplateID;
+
+            return true;
+        });
+
+        std::map<u32, std::vector<u32>> itemIDToEffectIDs;
+        itemEffectsStorage->Each([&](u32 id, MetaGen::Shared::ClientDB::ItemEffectRecord& itemEffect) -> bool
+        {
+            if (itemEffect.effectSpellID == 0)
+                return true;
+
+            itemIDToEffectIDs[itemEffect.itemID].push_back(id);
+            return true;
+        });
+
+        robin_hood::unordered_set<u8> itemEffectSlotSeen;
+        for (auto& pair : itemIDToEffectIDs)
+        {
+            u32 itemID = pair.first;
+
+            // Sort ItemEffectID based on Slot (Ascending)
+            {
+                std::ranges::sort(pair.second, [&itemEffectsStorage](const u32 itemEffectIDA, const u32 itemEffectIDB)
+                {
+                    const auto& itemEffectA = itemEffectsStorage->Get<MetaGen::Shared::ClientDB::ItemEffectRecord>(itemEffectIDA);
+                    const auto& itemEffectB = itemEffectsStorage->Get<MetaGen::Shared::ClientDB::ItemEffectRecord>(itemEffectIDB);
+
+                    return itemEffectA.effectSlot < itemEffectB.effectSlot;
+                });
+            }
+
+            // Check for Invalid ItemEffects
+            {
+                itemEffectSlotSeen.clear();
+
+                std::erase_if(pair.second, [&itemEffectsStorage, &spellStorage, &itemEffectSlotSeen](const u32 itemEffectID)
+                {
+                    const auto& itemEffect = itemEffectsStorage->Get<MetaGen::Shared::ClientDB::ItemEffectRecord>(itemEffectID);
+                    bool spellDoesNotExist = !spellStorage->Has(itemEffect.effectSpellID);
+                    if (spellDoesNotExist)
+                        return true;
+
+                    bool effectSlotInUse = itemEffectSlotSeen.contains(itemEffect.effectSlot);
+                    if (effectSlotInUse)
+                        return true;
+
+                    itemEffectSlotSeen.insert(itemEffect.effectSlot);
+                    return false;
+                });
+            }
+
+            u32 numEffectsToAdd = static_cast<u32>(pair.second.size());
+            if (numEffectsToAdd == 0)
+                continue;
+
+            u32 effectIndex = static_cast<u32>(itemSingleton.itemEffectIDs.size());
+            itemSingleton.itemIDToEffectMapping[itemID] = { .indexIntoMap = effectIndex, .count = numEffectsToAdd };
+
+            itemSingleton.itemEffectIDs.resize(effectIndex + numEffectsToAdd);
+            for (u32 i = 0; i < numEffectsToAdd; i++)
+            {
+                itemSingleton.itemEffectIDs[effectIndex + i] = pair.second[i];
+            }
+        }
+    }
+
+    bool Refresh()
+    {
+        entt::registry* registry = ServiceLocator::GetEnttRegistries()->dbRegistry;
+        auto& ctx = registry->ctx();
+
+        if (!ctx.contains<ECS::Singletons::ItemSingleton>())
+            ctx.emplace<ECS::Singletons::ItemSingleton>();
+
+        auto& itemSingleton = ctx.get<ECS::Singletons::ItemSingleton>();
+        ClearItemLookups(itemSingleton);
 
         auto& clientDBSingleton = ctx.get<ECS::Singletons::ClientDBSingleton>();
 
@@ -135,104 +271,39 @@ namespace ECSUtil::Item
             storage->MarkDirty();
         }
 
-        auto* itemStorage = clientDBSingleton.Get(ClientDBHash::Item);
-        auto* itemStatTemplateStorage = clientDBSingleton.Get(ClientDBHash::ItemStatTemplate);
-        auto* itemArmorTemplateStorage = clientDBSingleton.Get(ClientDBHash::ItemArmorTemplate);
-        auto* itemWeaponTemplateStorage = clientDBSingleton.Get(ClientDBHash::ItemWeaponTemplate);
-        auto* itemShieldTemplateStorage = clientDBSingleton.Get(ClientDBHash::ItemShieldTemplate);
-
-        auto* spellStorage = clientDBSingleton.Get(ClientDBHash::Spell);
-        auto* itemEffectsStorage = clientDBSingleton.Get(ClientDBHash::ItemEffects);
-
-        u32 numItems = itemStorage->GetNumRows();
-        u32 numItemEffects = itemEffectsStorage->GetNumRows();
-
-        itemSingleton.itemIDs.reserve(numItems);
-        itemSingleton.itemIDToStatTemplateID.reserve(numItems);
-        itemSingleton.itemIDToArmorTemplateID.reserve(numItems);
-        itemSingleton.itemIDToWeaponTemplateID.reserve(numItems);
-        itemSingleton.itemIDToShieldTemplateID.reserve(numItems);
-        itemSingleton.itemIDToEffectMapping.reserve(numItems);
-        itemSingleton.itemEffectIDs.reserve(numItemEffects);
-
-        itemStorage->Each([&](u32 id, MetaGen::Shared::ClientDB::ItemRecord& item) -> bool
-        {
-            itemSingleton.itemIDs.insert(id);
-
-            if (item.statTemplateID > 0 && itemStatTemplateStorage->Has(item.statTemplateID))
-                itemSingleton.itemIDToStatTemplateID[id] = item.statTemplateID;
-
-            if (item.armorTemplateID > 0 && itemArmorTemplateStorage->Has(item.armorTemplateID))
-                itemSingleton.itemIDToArmorTemplateID[id] = item.armorTemplateID;
-
-            if (item.weaponTemplateID > 0 && itemWeaponTemplateStorage->Has(item.weaponTemplateID))
-                itemSingleton.itemIDToWeaponTemplateID[id] = item.weaponTemplateID;
-
-            if (item.shieldTemplateID > 0 && itemShieldTemplateStorage->Has(item.shieldTemplateID))
-                itemSingleton.itemIDToShieldTemplateID[id] = item.shieldTemplateID;
-
-            return true;
-        });
-
-        std::map<u32, std::vector<u32>> itemIDToEffectIDs;
-        itemEffectsStorage->Each([&](u32 id, MetaGen::Shared::ClientDB::ItemEffectRecord& itemEffect) -> bool
-        {
-            if (itemEffect.effectSpellID == 0)
-                return true;
-
-            itemIDToEffectIDs[itemEffect.itemID].push_back(id);
-            return true;
-        });
-
-        robin_hood::unordered_set<u8> itemEffectSlotSeen;
-        for (auto& pair : itemIDToEffectIDs)
-        {
-            u32 itemID = pair.first;
-
-            // Sort ItemEffectID based on Slot (Ascending)
-            {
-                std::ranges::sort(pair.second, [&itemEffectsStorage](const u32 itemEffectIDA, const u32 itemEffectIDB)
-                {
-                    const auto& itemEffectA = itemEffectsStorage->Get<MetaGen::Shared::ClientDB::ItemEffectRecord>(itemEffectIDA);
-                    const auto& itemEffectB = itemEffectsStorage->Get<MetaGen::Shared::ClientDB::ItemEffectRecord>(itemEffectIDB);
-
-                    return itemEffectA.effectSlot < itemEffectB.effectSlot;
-                });
-            }
-
-            // Check for Invalid ItemEffects
+        Util::ClientDB::LookupSnapshotDesc lookupSnapshotDesc = { .name = "ItemLookups", .schemaVersion = LOOKUP_SNAPSHOT_SCHEMA_VERSION, .sourceDBs = LookupSourceDBs };
+        Util::ClientDB::LoadOrBuildLookups(clientDBSingleton, lookupSnapshotDesc,
+            [&itemSingleton](const Util::LookupSnapshot::Reader& reader)
             {
-                itemEffectSlotSeen.clear();
-
-                std::erase_if(pair.second, [&itemEffectsStorage, &spellStorage, &itemEffectSlotSeen](const u32 itemEffectID)
-                {
-                    const auto& itemEffect = itemEffectsStorage->Get<MetaGen::Shared::ClientDB::ItemEffectRecord>(itemEffectID);
-                    bool spellDoesNotExist = !spellStorage->Has(itemEffect.effectSpellID);
-                    if (spellDoesNotExist)
-                        return true;
-
-                    bool effectSlotInUse = itemEffectSlotSeen.contains(itemEffect.effectSlot);
-                    if (effectSlotInUse)
-                        return true;
-
-                    itemEffectSlotSeen.insert(itemEffect.effectSlot);
+                std::span<const u32> effectIDs;
+                bool didLoad = reader.ReadSet(LookupSnapshotSection::ItemIDs, itemSingleton.itemIDs) &&
+                               reader.ReadMap(LookupSnapshotSection::StatTemplateIDs, itemSingleton.itemIDToStatTemplateID) &&
+                               reader.ReadMap(LookupSnapshotSection::ArmorTemplateIDs, itemSingleton.itemIDToArmorTemplateID) &&
+                               reader.ReadMap(LookupSnapshotSection::WeaponTemplateIDs, itemSingleton.itemIDToWeaponTemplateID) &&
+                               reader.ReadMap(LookupSnapshotSection::ShieldTemplateIDs, itemSingleton.itemIDToShieldTemplateID) &&
+                               reader.ReadMap(LookupSnapshotSection::EffectMappings, itemSingleton.itemIDToEffectMapping) &&
+                               reader.GetArray(LookupSnapshotSection::EffectIDs, effectIDs);
+
+                if (!didLoad)
                     return false;
-                });
-            }
 
-            u32 numEffectsToAdd = static_cast<u32>(pair.second.size());
-            if (numEffectsToAdd == 0)
-                continue;
-
-            u32 effectIndex = static_cast<u32>(itemSingleton.itemEffectIDs.size());
-            itemSingleton.itemIDToEffectMapping[itemID] = { .indexIntoMap = effectIndex, .count = numEffectsToAdd };
-
-            itemSingleton.itemEffectIDs.resize(effectIndex + numEffectsToAdd);
-            for (u32 i = 0; i < numEffectsToAdd; i++)
+                itemSingleton.itemEffectIDs.assign(effectIDs.begin(), effectIDs.end());
+                return true;
+            },
+            [&itemSingleton, &clientDBSingleton]()
             {
-                itemSingleton.itemEffectIDs[effectIndex + i] = pair.second[i];
-            }
-        }
+                BuildItemLookups(itemSingleton, clientDBSingleton);
+            },
+            [&itemSingleton](Util::LookupSnapshot::Writer& writer)
+            {
+                writer.AddSet(LookupSnapshotSection::ItemIDs, itemSingleton.itemIDs);
+                writer.AddMap(LookupSnapshotSection::StatTemplateIDs, itemSingleton.itemIDToStatTemplateID);
+                writer.AddMap(LookupSnapshotSection::ArmorTemplateIDs, itemSingleton.itemIDToArmorTemplateID);
+                writer.AddMap(LookupSnapshotSection::WeaponTemplateIDs, itemSingleton.itemIDToWeaponTemplateID);
+                writer.AddMap(LookupSnapshotSection::ShieldTemplateIDs, itemSingleton.itemIDToShieldTemplateID);
+                writer.AddMap(LookupSnapshotSection::EffectMappings, itemSingleton.itemIDToEffectMapping);
+                writer.AddArray<u32>(LookupSnapshotSection::EffectIDs, itemSingleton.itemEffectIDs);
+            });
 
         auto* modelFileDataStorage = clientDBSingleton.Get(ClientDBHash::ModelFileData);
         itemSingleton.helmModelResourcesIDToModelMapping.clear();
@@ -1,6 +1,7 @@
 #include "SpellUtil.h"
 
 #include "Game-Lib/ECS/Singletons/Database/ClientDBSingleton.h"
+#include "Game-Lib/Util/ClientDBUtil.h"
 #include "Game-Lib/Util/ServiceLocator.h"
 
 #include <MetaGen/Shared/ClientDB/ClientDB.h>
@@ -10,6 +11,21 @@
 
 namespace ECSUtil::Spell
 {
+    static constexpr u32 LOOKUP_SNAPSHOT_SCHEMA_VERSION = 1;
+
+    static constexpr ClientDBHash LookupSourceDBs[] =
+    {
+        ClientDBHash::SpellEffects
+    };
+
+    namespace LookupSnapshotSection
+    {
+        enum : u32
+        {
+            SpellIDToEffectList
+        };
+    }
+
     bool Refresh()
     {
         entt::registry* registry = ServiceLocator::GetEnttRegistries()->dbRegistry;
@@ -24,7 +40,8 @@ namespace ECSUtil::Spell
 
         auto& clientDBSingleton = ctx.get<ECS::Singletons::ClientDBSingleton>();
 
-        if (clientDBSingleton.Register<MetaGen::Shared::ClientDB::SpellRecord>())
+        // Writing the default into a loaded DB would dirty it and invalidate the lookup snapshots built from it
+        if (!clientDBSingleton.Has(ClientDBHash::Spell) && clientDBSingleton.Register<MetaGen::Shared::ClientDB::SpellRecord>())
         {
             auto* storage = clientDBSingleton.Get(ClientDBHash::Spell);
 
@@ -53,19 +70,32 @@ namespace ECSUtil::Spell
             storage->Replace(0, defaultSpellEffect);
         }
 
-        auto* spellStorage = clientDBSingleton.Get(ClientDBHash::Spell);
-        auto* spellEffectsStorage = clientDBSingleton.Get(ClientDBHash::SpellEffects);
-
-        spellEffectsStorage->Each([&](u32 id, MetaGen::Shared::ClientDB::SpellEffectsRecord& spellEffect) -> bool
-        {
-            AddSpellEffect(spellSingleton, spellEffect.spellID, id);
-            return true;
-        });
-
-        for (auto& pair : spellSingleton.spellIDToEffectList)
-        {
-            SortSpellEffects(spellSingleton, spellEffectsStorage, pair.first);
-        }
+        Util::ClientDB::LookupSnapshotDesc lookupSnapshotDesc = { .name = "SpellLookups", .schemaVersion = LOOKUP_SNAPSHOT_SCHEMA_VERSION, .sourceDBs = LookupSourceDBs };
+        Util::ClientDB::LoadOrBuildLookups(clientDBSingleton, lookupSnapshotDesc,
+            [&spellSingleton](const Util::LookupSnapshot::Reader& reader)
+            {
+                return reader.ReadListMap(LookupSnapshotSection::SpellIDToEffectList, spellSingleton.spellIDToEffectList);
+            },
+            [&spellSingleton, &clientDBSingleton]()
+            {
+                spellSingleton.spellIDToEffectList.clear();
+
+                auto* spellEffectsStorage = clientDBSingleton.Get(ClientDBHash::SpellEffects);
+                spellEffectsStorage->Each([&](u32 id, MetaGen::Shared::ClientDB::SpellEffectsRecord& spellEffect) -> bool
+                {
+                    AddSpellEffect(spellSingleton, spellEffect.spellID, id);
+                    return true;
+                });
+
+                for (auto& pair : spellSingleton.spellIDToEffectList)
+                {
+                    SortSpellEffects(spellSingleton, spellEffectsStorage, pair.first);
+                }
+            },
+            [&spellSingleton](Util::LookupSnapshot::Writer& writer)
+            {
+                writer.AddListMap(LookupSnapshotSection::SpellIDToEffectList, spellSingleton.spellIDToEffectList);
+            });
 
         return true;
     }
@@ -2,6 +2,7 @@
 
 #include "Game-Lib/ECS/Singletons/Database/ClientDBSingleton.h"
 #include "Game-Lib/ECS/Singletons/Database/TextureSingleton.h"
+#include "Game-Lib/Util/ClientDBUtil.h"
 #include "Game-Lib/Util/ServiceLocator.h"
 
 #include <MetaGen/Shared/ClientDB/ClientDB.h>
@@ -10,6 +11,21 @@
 
 namespace ECSUtil::Texture
 {
+    static constexpr u32 LOOKUP_SNAPSHOT_SCHEMA_VERSION = 1;
+
+    static constexpr ClientDBHash LookupSourceDBs[] =
+    {
+        ClientDBHash::TextureFileData
+    };
+
+    namespace LookupSnapshotSection
+    {
+        enum : u32
+        {
+            MaterialResourcesIDToTextureHashes
+        };
+    }
+
     bool Refresh()
     {
         entt::registry* registry = ServiceLocator::GetEnttRegistries()->dbRegistry;
@@ -33,20 +49,33 @@ namespace ECSUtil::Texture
             itemDisplayModelMaterialResourcesStorage->Initialize<MetaGen::Shared::ClientDB::ItemDisplayInfoModelMaterialResourceRecord>();
         }
 
-        auto* textureFileDataStorage = clientDBSingleton.Get(ClientDBHash::TextureFileData);
-        u32 numRecords = textureFileDataStorage->GetNumRows();
+        Util::ClientDB::LookupSnapshotDesc lookupSnapshotDesc = { .name = "TextureLookups", .schemaVersion = LOOKUP_SNAPSHOT_SCHEMA_VERSION, .sourceDBs = LookupSourceDBs };
+        Util::ClientDB::LoadOrBuildLookups(clientDBSingleton, lookupSnapshotDesc,
+            [&textureSingleton](const Util::LookupSnapshot::Reader& reader)
+            {
+                return reader.ReadListMap(LookupSnapshotSection::MaterialResourcesIDToTextureHashes, textureSingleton.materialResourcesIDToTextureHashes);
+            },
+            [&textureSingleton, &clientDBSingleton]()
+            {
+                auto* textureFileDataStorage = clientDBSingleton.Get(ClientDBHash::TextureFileData);
+                u32 numRecords = textureFileDataStorage->GetNumRows();
 
-        textureSingleton.materialResourcesIDToTextureHashes.clear();
-        textureSingleton.materialResourcesIDToTextureHashes.reserve(numRecords);
+                textureSingleton.materialResourcesIDToTextureHashes.clear();
+                textureSingleton.materialResourcesIDToTextureHashes.reserve(numRecords);
 
-        textureFileDataStorage->Each([&textureFileDataStorage, &textureSingleton](u32 id, const MetaGen::Shared::ClientDB::TextureFileDataRecord& row)
-        {
-            if (id == 0) return true;
+                textureFileDataStorage->Each([&textureFileDataStorage, &textureSingleton](u32 id, const MetaGen::Shared::ClientDB::TextureFileDataRecord& row)
+                {
+                    if (id == 0) return true;
 
-            u64 textureHash = textureFileDataStorage->GetStringHash(row.texture);
-            textureSingleton.materialResourcesIDToTextureHashes[row.materialResourcesID].push_back(textureHash);
-            return true;
-        });
+                    u64 textureHash = textureFileDataStorage->GetStringHash(row.texture);
+                    textureSingleton.materialResourcesIDToTextureHashes[row.materialResourcesID].push_back(textureHash);
+                    return true;
+                });
+            },
+            [&textureSingleton](Util::LookupSnapshot::Writer& writer)
+            {
+                writer.AddListMap(LookupSnapshotSection::MaterialResourcesIDToTextureHashes, textureSingleton.materialResourcesIDToTextureHashes);
+            });
 
         return true;
     }
@@ -207,35 +207,6 @@ namespace ECSUtil::UnitCustomization
             return true;
         });
 
-        u32 numUnitCustomizationMaterialRows = unitCustomizationMaterialStorage->GetNumRows();
-        unitCustomizationSingleton.customizationMaterialIDToTextureID.clear();
-        unitCustomizationSingleton.customizationMaterialIDToTextureID.reserve(numUnitCustomizationMaterialRows);
-        unitCustomizationMaterialStorage->Each([&](u32 id, const MetaGen::Shared::ClientDB::UnitCustomizationMaterialRecord& unitCustomizationMaterial)
-        {
-            if (id == 0)
-                return true;
-
-            if (!textureSingleton.materialResourcesIDToTextureHashes.contains(unitCustomizationMaterial.materialResourcesID))
-                return true;
-
-            u64 textureHash = textureSingleton.materialResourcesIDToTextureHashes[unitCustomizationMaterial.materialResourcesID][0];
-
-            PACT::PactFileHandle fileHandle;
-            if (pactStorage->ReadFile(textureHash, fileHandle) != PACT::PactReadResult::Success)
-                return true;
-
-            Renderer::DataTextureDesc textureDesc =
-            {
-                .hash = textureHash,
-                .data = reinterpret_cast<const u8*>(fileHandle.GetData()),
-                .size = fileHandle.GetSize()
-            };
-
-            Renderer::TextureID texture = ServiceLocator::GetGameRenderer()->GetRenderer()->LoadDataTexture(textureDesc);
-            unitCustomizationSingleton.customizationMaterialIDToTextureID[id] = texture;
-            return true;
-        });
-
         u32 numCustomizationGeosetRows = unitCustomizationGeosetStorage->GetNumRows();
         unitCustomizationSingleton.geosetIDToGeosetKey.clear();
         unitCustomizationSingleton.geosetIDToGeosetKey.reserve(numCustomizationGeosetRows);
@@ -330,9 +301,6 @@ namespace ECSUtil::UnitCustomization
         unitCustomizationSingleton.unitCustomizationKeyToTextureHash.clear();
         unitCustomizationSingleton.unitCustomizationKeyToTextureHash.reserve(numUnitRaceCustomizationChoiceRows * 3);
 
-        unitCustomizationSingleton.unitCustomizationKeyToTextureID.clear();
-        unitCustomizationSingleton.unitCustomizationKeyToTextureID.reserve(numUnitRaceCustomizationChoiceRows * 3);
-
         std::string textureStrs[3] = { "", "", "" };
         textureStrs[0].reserve(256);
         textureStrs[1].reserve(256);
@@ -539,70 +507,50 @@ namespace ECSUtil::UnitCustomization
             }
         }
 
-        for (const auto& pair : unitCustomizationSingleton.unitCustomizationKeyToTextureHash)
-        {
-            u32 key = pair.first;
-            u64 textureHash = pair.second;
-
-            PACT::PactFileHandle fileHandle;
-            if (pactStorage->ReadFile(textureHash, fileHandle) != PACT::PactReadResult::Success)
-                continue;
-
-            Renderer::DataTextureDesc textureDesc =
-            {
-                .hash = textureHash,
-                .data = reinterpret_cast<const u8*>(fileHandle.GetData()),
-                .size = fileHandle.GetSize()
-            };
-
-            Renderer::TextureID texture = ServiceLocator::GetGameRenderer()->GetRenderer()->LoadDataTexture(textureDesc);
-            unitCustomizationSingleton.unitCustomizationKeyToTextureID[key] = texture;
-        }
-
         return true;
     }
 
-    bool GetBaseSkinTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, Renderer::TextureID& textureID)
+    bool GetBaseSkinTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, u64& textureHash)
     {
         u32 customizationKey = CreateCustomizationKey(race, gender, Database::Unit::CustomizationOption::Skin, 0, skinID, 0);
-        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureID.contains(customizationKey))
+        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureHash.contains(customizationKey))
             return false;
 
-        textureID = unitCustomizationSingleton.unitCustomizationKeyToTextureID[customizationKey];
+        textureHash = unitCustomizationSingleton.unitCustomizationKeyToTextureHash[customizationKey];
         return true;
     }
     
-    bool GetBaseSkinBraTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, Renderer::TextureID& textureID)
+    bool GetBaseSkinBraTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, u64& textureHash)
     {
         u32 customizationKey = CreateCustomizationKey(race, gender, Database::Unit::CustomizationOption::SkinBra, 0, skinID, 0);
-        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureID.contains(customizationKey))
+        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureHash.contains(customizationKey))
             return false;
 
-        textureID = unitCustomizationSingleton.unitCustomizationKeyToTextureID[customizationKey];
+        textureHash = unitCustomizationSingleton.unitCustomizationKeyToTextureHash[customizationKey];
         return true;
     }
 
-    bool GetBaseSkinUnderwearTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, Renderer::TextureID& textureID)
+    bool GetBaseSkinUnderwearTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, u64& textureHash)
     {
         u32 customizationKey = CreateCustomizationKey(race, gender, Database::Unit::CustomizationOption::SkinUnderwear, 0, skinID, 0);
-        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureID.contains(customizationKey))
+        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureHash.contains(customizationKey))
             return false;
 
-        textureID = unitCustomizationSingleton.unitCustomizationKeyToTextureID[customizationKey];
+        textureHash = unitCustomizationSingleton.unitCustomizationKeyToTextureHash[customizationKey];
         return true;
     }
 
-    bool GetBaseSkinFaceTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, u8 faceID, u8 variant, Renderer::TextureID& textureID)
+    bool GetBaseSkinFaceTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, u8 faceID, u8 variant, u64& textureHash)
     {
         u32 customizationKey = CreateCustomizationKey(race, gender, Database::Unit::CustomizationOption::Face, faceID, skinID, variant);
-        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureID.contains(customizationKey))
+        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureHash.contains(customizationKey))
             return false;
 
-        textureID = unitCustomizationSingleton.unitCustomizationKeyToTextureID[customizationKey];
+        textureHash = unitCustomizationSingleton.unitCustomizationKeyToTextureHash[customizationKey];
         return true;
     }
 
-    bool GetBaseSkinHairTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 hairStyle, u8 hairColor, u8 variant, Renderer::TextureID& textureID)
+    bool GetBaseSkinHairTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 hairStyle, u8 hairColor, u8 variant, u64& textureHash)
     {
         u32 choiceID;
         if (!ECSUtil::UnitCustomization::GetChoiceIDFromOptionValue(unitCustomizationSingleton, race, gender, Database::Unit::CustomizationOption::Hairstyle, hairStyle, choiceID))
@@ -615,10 +563,10 @@ namespace ECSUtil::UnitCustomization
         u8 hairTextureStyle = choiceData & 0xFFFF;
 
         u32 customizationKey = CreateCustomizationKey(race, gender, Database::Unit::CustomizationOption::HairColor, hairTextureStyle, hairColor, variant);
-        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureID.contains(customizationKey))
+        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureHash.contains(customizationKey))
             return false;
 
-        textureID = unitCustomizationSingleton.unitCustomizationKeyToTextureID[customizationKey];
+        textureHash = unitCustomizationSingleton.unitCustomizationKeyToTextureHash[customizationKey];
         return true;
     }
 
@@ -645,52 +593,52 @@ namespace ECSUtil::UnitCustomization
         textureRenderer->RequestRenderTextureToTexture(skinTextureID, destMin, destMax, textureID, srcMin, srcMax);
     }
 
-    void WriteItemToSkin(ECS::Singletons::TextureSingleton& textureSingleton, ECS::Singletons::ClientDBSingleton& clientDBSingleton, ECS::Singletons::ItemSingleton& itemSingleton, ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, ECS::Components::UnitCustomization& unitCustomization, u32 itemDisplayID)
+    void AddItemToSkinTextureDesc(ECS::Singletons::ItemSingleton& itemSingleton, ECS::Components::UnitCustomization& unitCustomization, u32 itemDisplayID, SkinTextureDesc& skinTextureDesc)
     {
-        PACT::PactStorage* pactStorage = ServiceLocator::GetPactStorage();
-        TextureRenderer* textureRenderer = ServiceLocator::GetGameRenderer()->GetTextureRenderer();
-
         if (!itemSingleton.itemDisplayInfoToComponentSectionData.contains(itemDisplayID))
             return;
 
-        auto* itemDisplayMaterialStorage = clientDBSingleton.Get(ClientDBHash::ItemDisplayMaterialResources);
-
         const auto& componentSectionData = itemSingleton.itemDisplayInfoToComponentSectionData[itemDisplayID];
         for (const auto& pair : componentSectionData.componentSectionToTextureHash)
         {
-            auto componentSection = static_cast<Database::Unit::TextureSectionType>(pair.first);
+            u8 componentSection = pair.first;
             u64 textureHash = pair.second;
 
-            Renderer::TextureID textureID = Renderer::TextureID::Invalid();
-            if (unitCustomizationSingleton.itemTextureHashToTextureID.contains(textureHash))
-            {
-                textureID = unitCustomizationSingleton.itemTextureHashToTextureID[textureHash];
-            }
-            else
-            {
-                PACT::PactFileHandle fileHandle;
-                if (pactStorage->ReadFile(textureHash, fileHandle) != PACT::PactReadResult::Success)
-                    continue;
-
-                Renderer::DataTextureDesc textureDesc =
-                {
-                    .hash = textureHash,
-                    .data = reinterpret_cast<const u8*>(fileHandle.GetData()),
-                    .size = fileHandle.GetSize()
-                };
-
-                textureID = ServiceLocator::GetGameRenderer()->GetRenderer()->LoadDataTexture(textureDesc);
-                unitCustomizationSingleton.itemTextureHashToTextureID[textureHash] = textureID;
-            }
-
             u16 componentSectionsInUseBits = *reinterpret_cast<u16*>(&unitCustomization.componentSectionsInUse);
             componentSectionsInUseBits |= 1 << static_cast<u16>(componentSection);
 
             unitCustomization.componentSectionsInUse = *reinterpret_cast<ECS::Components::UnitComponentSectionsInUse*>(&componentSectionsInUseBits);
-            WriteTextureToSkin(clientDBSingleton, unitCustomizationSingleton, unitCustomization.skinTextureID, textureID, componentSection);
+            skinTextureDesc.AddLayer(textureHash, componentSection);
         }
     }
 
+    bool GetItemTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, u64 textureHash, Renderer::TextureID& textureID)
+    {
+        if (unitCustomizationSingleton.itemTextureHashToTextureID.contains(textureHash))
+        {
+            textureID = unitCustomizationSingleton.itemTextureHashToTextureID[textureHash];
+            return true;
+        }
+
+        PACT::PactStorage* pactStorage = ServiceLocator::GetPactStorage();
+
+        PACT::PactFileHandle fileHandle;
+        if (pactStorage->ReadFile(textureHash, fileHandle) != PACT::PactReadResult::Success)
+            return false;
+
+        Renderer::DataTextureDesc textureDesc =
+        {
+            .hash = textureHash,
+            .data = reinterpret_cast<const u8*>(fileHandle.GetData()),
+            .size = fileHandle.GetSize()
+        };
+
+        textureID = ServiceLocator::GetGameRenderer()->GetRenderer()->LoadDataTexture(textureDesc);
+        unitCustomizationSingleton.itemTextureHashToTextureID[textureHash] = textureID;
+
+        return true;
+    }
+
     bool GetChoiceIDFromOptionValue(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, Database::Unit::CustomizationOption customizationOption, u8 customizationOptionValue, u32& choiceID)
     {
         u32 baseCustomizationKey = CreateCustomizationKey(race, gender, customizationOption);
@@ -726,7 +674,7 @@ namespace ECSUtil::UnitCustomization
         return true;
     }
 
-    bool GetHairTexture(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 hairStyle, u8 hairColor, Renderer::TextureID& textureID)
+    bool GetHairTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 hairStyle, u8 hairColor, u64& textureHash)
     {
         u32 choiceID;
         if (!ECSUtil::UnitCustomization::GetChoiceIDFromOptionValue(unitCustomizationSingleton, race, gender, Database::Unit::CustomizationOption::Hairstyle, hairStyle, choiceID))
@@ -739,10 +687,10 @@ namespace ECSUtil::UnitCustomization
         u8 hairTextureStyle = choiceData & 0xFFFF;
 
         u32 customizationKey = CreateCustomizationKey(race, gender, Database::Unit::CustomizationOption::HairColor, hairTextureStyle, hairColor, 0);
-        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureID.contains(customizationKey))
+        if (!unitCustomizationSingleton.unitCustomizationKeyToTextureHash.contains(customizationKey))
             return false;
 
-        textureID = unitCustomizationSingleton.unitCustomizationKeyToTextureID[customizationKey];
+        textureHash = unitCustomizationSingleton.unitCustomizationKeyToTextureHash[customizationKey];
         return true;
     }
 
@@ -10,6 +10,7 @@
 #include <entt/fwd.hpp>
 
 class TextureRenderer;
+struct SkinTextureDesc;
 
 namespace ECS
 {
@@ -31,19 +32,20 @@ namespace ECSUtil::UnitCustomization
 {
     bool Refresh();
 
-    bool GetBaseSkinTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, Renderer::TextureID& textureID);
-    bool GetBaseSkinBraTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, Renderer::TextureID& textureID);
-    bool GetBaseSkinUnderwearTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, Renderer::TextureID& textureID);
-    bool GetBaseSkinFaceTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, u8 faceID, u8 variant, Renderer::TextureID& textureID);
-    bool GetBaseSkinHairTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 hairStyle, u8 hairColor, u8 variant, Renderer::TextureID& textureID);
+    bool GetBaseSkinTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, u64& textureHash);
+    bool GetBaseSkinBraTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, u64& textureHash);
+    bool GetBaseSkinUnderwearTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, u64& textureHash);
+    bool GetBaseSkinFaceTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 skinID, u8 faceID, u8 variant, u64& textureHash);
+    bool GetBaseSkinHairTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 hairStyle, u8 hairColor, u8 variant, u64& textureHash);
 
     void WriteBaseSkin(ECS::Singletons::ClientDBSingleton& clientDBSingleton, ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, Renderer::TextureID skinTextureID, Renderer::TextureID baseSkinTextureID, vec2 srcMin = vec2(0.0f), vec2 srcMax = vec2(1.0f));
     void WriteTextureToSkin(ECS::Singletons::ClientDBSingleton& clientDBSingleton, ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, Renderer::TextureID skinTextureID, Renderer::TextureID textureID, Database::Unit::TextureSectionType textureSectionType, vec2 srcMin = vec2(0.0f), vec2 srcMax = vec2(1.0f));
-    void WriteItemToSkin(ECS::Singletons::TextureSingleton& textureSingleton, ECS::Singletons::ClientDBSingleton& clientDBSingleton, ECS::Singletons::ItemSingleton& itemSingleton, ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, ECS::Components::UnitCustomization& unitCustomization, u32 itemDisplayID);
+    void AddItemToSkinTextureDesc(ECS::Singletons::ItemSingleton& itemSingleton, ECS::Components::UnitCustomization& unitCustomization, u32 itemDisplayID, SkinTextureDesc& skinTextureDesc);
+    bool GetItemTextureID(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, u64 textureHash, Renderer::TextureID& textureID);
 
     bool GetChoiceIDFromOptionValue(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, ::Database::Unit::CustomizationOption customizationOption, u8 customizationOptionValue, u32& choiceID);
     bool GetGeosetFromOptionValue(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, ::Database::Unit::CustomizationOption customizationOption, u8 customizationOptionValue, u16& geoset);
-    bool GetHairTexture(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 hairStyle, u8 hairColor, Renderer::TextureID& textureID);
+    bool GetHairTextureHash(ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, GameDefine::UnitRace race, GameDefine::UnitGender gender, u8 hairStyle, u8 hairColor, u64& textureHash);
 
     u32 CreateCustomizationKey(GameDefine::UnitRace race, GameDefine::UnitGender gender, ::Database::Unit::CustomizationOption customizationOption, u8 choiceIndex = 255, u8 variationIndex = 255, u8 materialIndex = 255);
 }
\ No newline at end of file
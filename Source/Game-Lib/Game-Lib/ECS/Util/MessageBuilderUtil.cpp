@@ -15,6 +15,7 @@
 #include <entt/entt.hpp>
 
 #include <algorithm>
+#include <array>
 
 namespace ECS::Util::MessageBuilder
 {
@@ -117,6 +118,40 @@ namespace ECS::Util::MessageBuilder
 
             return result;
         }
+
+        bool BuildUnitNetFieldUpdateMessage(std::shared_ptr<Bytebuffer>& buffer, ObjectGUID guid, std::span<const std::pair<u16, u32>> fields)
+        {
+            if (fields.empty())
+                return false;
+
+            // A byte aligned window of the field mask followed by one u32 per set bit in bit order
+            u32 byteMaskOffset = fields.front().first / 8u;
+            u32 numMaskBytes = (fields.back().first / 8u) - byteMaskOffset + 1;
+            if (byteMaskOffset > std::numeric_limits<u8>().max() || numMaskBytes > std::numeric_limits<u8>().max())
+                return false;
+
+            std::array<u8, 256> maskBytes = {};
+            for (const auto& [fieldID, value] : fields)
+            {
+                u32 bit = fieldID - (byteMaskOffset * 8u);
+                maskBytes[bit / 8] |= static_cast<u8>(1u << (bit % 8));
+            }
+
+            bool result = CreatePacket(buffer, MetaGen::Shared::Packet::ServerUnitNetFieldUpdatePacket::PACKET_ID, [&]()
+            {
+                buffer->Serialize(guid);
+                buffer->PutU8(static_cast<u8>(byteMaskOffset));
+                buffer->PutU8(static_cast<u8>(numMaskBytes));
+                buffer->PutBytes(maskBytes.data(), numMaskBytes);
+
+                for (const auto& [fieldID, value] : fields)
+                {
+                    buffer->PutU32(value);
+                }
+            });
+
+            return result;
+        }
     }
 
     namespace Container
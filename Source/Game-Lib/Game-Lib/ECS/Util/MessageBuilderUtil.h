@@ -20,6 +20,8 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <span>
+#include <utility>
 
 namespace ClientDB
 {
@@ -54,6 +56,9 @@ namespace ECS
         {
             bool BuildUnitMoveMessage(std::shared_ptr<Bytebuffer>& buffer, const vec3& position, const vec2& pitchYaw, const Components::MovementFlags& movementFlags, f32 verticalVelocity);
             bool BuildUnitTargetUpdateMessage(std::shared_ptr<Bytebuffer>& buffer, ObjectGUID targetGUID);
+
+            // Server to client layout, used to replay and merge netfield updates locally. fields must be sorted by field ID without duplicates
+            bool BuildUnitNetFieldUpdateMessage(std::shared_ptr<Bytebuffer>& buffer, ObjectGUID guid, std::span<const std::pair<u16, u32>> fields);
         }
 
         namespace Container
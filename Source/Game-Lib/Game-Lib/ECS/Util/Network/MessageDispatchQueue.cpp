@@ -0,0 +1,196 @@
+#include "MessageDispatchQueue.h"
+
+#include "Game-Lib/ECS/Util/MessageBuilderUtil.h"
+#include "Game-Lib/ECS/Util/Network/NetFieldUpdate.h"
+
+#include <Base/Memory/Bytebuffer.h>
+
+#include <MetaGen/Shared/Packet/Packet.h>
+
+
+namespace ECS::Util::Network
+{
+    // Both messages start with the unit's GUID, the packet header is left in place so the router still sees the whole message
+    static bool PeekUnitGUID(const ::Network::Message& message, ::Network::OpcodeType& opcode, ObjectGUID& guid)
+    {
+        Bytebuffer* buffer = message.buffer.get();
+        size_t readData = buffer->readData;
+
+        ::Network::MessageHeader header;
+        bool result = buffer->Get(header) && buffer->Deserialize(guid);
+        opcode = header.opcode;
+
+        buffer->readData = readData;
+        return result;
+    }
+
+    void MessageDispatchQueue::Push(::Network::SocketMessageEvent& messageEvent, bool coalesce)
+    {
+        u64 sequence = _frontSequence + _entries.size();
+
+        Entry& entry = _entries.emplace_back();
+        entry.messageEvent = std::move(messageEvent);
+        _numQueued++;
+
+        ::Network::OpcodeType opcode = 0;
+        if (coalesce && PeekUnitGUID(entry.messageEvent.message, opcode, entry.guid))
+        {
+            if (opcode == MetaGen::Shared::Packet::ServerUnitMovePacket::PACKET_ID)
+                entry.kind = MessageKind::UnitMove;
+            else if (opcode == MetaGen::Shared::Packet::ServerUnitNetFieldUpdatePacket::PACKET_ID)
+                entry.kind = MessageKind::UnitNetFieldUpdate;
+        }
+
+        switch (entry.kind)
+        {
+            case MessageKind::UnitMove:
+            {
+                auto itr = _unitMoveSequence.find(entry.guid);
+                if (itr != _unitMoveSequence.end() && itr->second >= _coalesceBarrier)
+                {
+                    _entries[itr->second - _frontSequence].dropped = true;
+                    _numQueued--;
+                    _numCoalesced++;
+                }
+
+                _unitMoveSequence[entry.guid] = sequence;
+                break;
+            }
+
+            case MessageKind::UnitNetFieldUpdate:
+            {
+                auto itr = _unitNetFieldSequence.find(entry.guid);
+                if (itr != _unitNetFieldSequence.end() && itr->second >= _coalesceBarrier)
+                {
+                    Entry& older = _entries[itr->second - _frontSequence];
+                    if (MergeNetFieldUpdate(older, entry))
+                    {
+                        older.dropped = true;
+                        _numQueued--;
+                        _numCoalesced++;
+                    }
+                }
+
+                _unitNetFieldSequence[entry.guid] = sequence;
+                break;
+            }
+
+            default:
+            {
+                _coalesceBarrier = sequence + 1;
+                break;
+            }
+        }
+    }
+
+    bool MessageDispatchQueue::TryPop(::Network::SocketMessageEvent& messageEvent)
+    {
+        while (!_entries.empty())
+        {
+            Entry& entry = _entries.front();
+            u64 sequence = _frontSequence++;
+
+            bool dropped = entry.dropped;
+            if (!dropped)
+            {
+                if (entry.kind == MessageKind::UnitMove)
+                {
+                    auto itr = _unitMoveSequence.find(entry.guid);
+                    if (itr != _unitMoveSequence.end() && itr->second == sequence)
+                        _unitMoveSequence.erase(itr);
+                }
+                else if (entry.kind == MessageKind::UnitNetFieldUpdate)
+                {
+                    auto itr = _unitNetFieldSequence.find(entry.guid);
+                    if (itr != _unitNetFieldSequence.end() && itr->second == sequence)
+                        _unitNetFieldSequence.erase(itr);
+                }
+
+                messageEvent = std::move(entry.messageEvent);
+            }
+
+            _entries.pop_front();
+
+            if (!dropped)
+            {
+                _numQueued--;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void MessageDispatchQueue::Clear()
+    {
+        _frontSequence += _entries.size();
+        _entries.clear();
+
+        _unitMoveSequence.clear();
+        _unitNetFieldSequence.clear();
+        _coalesceBarrier = _frontSequence;
+
+        _numQueued = 0;
+    }
+
+    bool MessageDispatchQueue::PeekUnitNetFieldUpdate(const ::Network::Message& message, ObjectGUID& guid, std::vector<std::pair<u16, u32>>& fields)
+    {
+        Bytebuffer* buffer = message.buffer.get();
+        size_t readData = buffer->readData;
+
+        fields.clear();
+
+        // Same layout HandleOnUnitNetFieldUpdate reads
+        ::Network::MessageHeader header;
+        NetFieldMask fieldMask;
+
+        bool result = buffer->Get(header) && buffer->Deserialize(guid) && fieldMask.Read(*buffer);
+        result = result && fieldMask.ForEachField([&](u16 fieldID)
+        {
+            u32 data = 0;
+            if (!buffer->GetU32(data))
+                return false;
+
+            fields.push_back({ fieldID, data });
+            return true;
+        });
+
+        buffer->readData = readData;
+        return result;
+    }
+
+    bool MessageDispatchQueue::MergeNetFieldUpdate(Entry& older, Entry& newer)
+    {
+        ObjectGUID guid;
+        if (!PeekUnitNetFieldUpdate(older.messageEvent.message, guid, _olderFields) || !PeekUnitNetFieldUpdate(newer.messageEvent.message, guid, _newerFields))
+            return false;
+
+        // Both lists are sorted, the newer value wins when both set a field
+        std::vector<std::pair<u16, u32>> mergedFields;
+        mergedFields.reserve(_olderFields.size() + _newerFields.size());
+
+        size_t olderIndex = 0;
+        size_t newerIndex = 0;
+        while (olderIndex < _olderFields.size() || newerIndex < _newerFields.size())
+        {
+            if (newerIndex == _newerFields.size() || (olderIndex < _olderFields.size() && _olderFields[olderIndex].first < _newerFields[newerIndex].first))
+            {
+                mergedFields.push_back(_olderFields[olderIndex++]);
+                continue;
+            }
+
+            if (olderIndex < _olderFields.size() && _olderFields[olderIndex].first == _newerFields[newerIndex].first)
+                olderIndex++;
+
+            mergedFields.push_back(_newerFields[newerIndex++]);
+        }
+
+        size_t bufferSize = sizeof(::Network::MessageHeader) + sizeof(ObjectGUID) + (sizeof(u8) * 2) + NetFieldMask::MAX_MASK_BYTES + (mergedFields.size() * sizeof(u32));
+        std::shared_ptr<Bytebuffer> buffer = Bytebuffer::BorrowRuntime(bufferSize);
+        if (!MessageBuilder::Unit::BuildUnitNetFieldUpdateMessage(buffer, newer.guid, mergedFields))
+            return false;
+
+        newer.messageEvent.message.buffer = std::move(buffer);
+        return true;
+    }
+}
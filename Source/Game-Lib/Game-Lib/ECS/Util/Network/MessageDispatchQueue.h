@@ -0,0 +1,72 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <Gameplay/GameDefine.h>
+
+#include <Network/Define.h>
+
+#include <robinhood/robinhood.h>
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace ECS::Util::Network
+{
+    // Holds received messages until NetworkConnection gets around to dispatching them, which lets a frame stop early and
+    // carry the rest over. Superseded messages are coalesced when pushed:
+    // - Only the newest ServerUnitMove per unit is kept, older ones are dropped where they are.
+    // - Unit netfield updates are merged into the newest update for the unit.
+    // Neither happens across any other kind of message queued in between, since its handler (a teleport, a spell) may
+    // read the unit's transform or fields as they were at that point.
+    // Everything else is dispatched exactly once and in the order it was received.
+    class MessageDispatchQueue
+    {
+    public:
+        void Push(::Network::SocketMessageEvent& messageEvent, bool coalesce = true);
+        bool TryPop(::Network::SocketMessageEvent& messageEvent);
+        void Clear();
+
+        u32 GetNumQueued() const { return _numQueued; }
+        u64 GetNumCoalesced() const { return _numCoalesced; }
+
+        // Reads a netfield update without consuming it, fields come out sorted by field ID
+        static bool PeekUnitNetFieldUpdate(const ::Network::Message& message, ObjectGUID& guid, std::vector<std::pair<u16, u32>>& fields);
+
+    private:
+        enum class MessageKind : u8
+        {
+            Other,
+            UnitMove,
+            UnitNetFieldUpdate
+        };
+
+        struct Entry
+        {
+        public:
+            ::Network::SocketMessageEvent messageEvent;
+            ObjectGUID guid;
+            MessageKind kind = MessageKind::Other;
+            bool dropped = false;
+        };
+
+        bool MergeNetFieldUpdate(Entry& older, Entry& newer);
+
+    private:
+        std::deque<Entry> _entries;
+        u64 _frontSequence = 0; // Sequence number of _entries.front()
+
+        // Sequence of the newest pending message of that kind per unit, removed again once it is popped
+        robin_hood::unordered_map<ObjectGUID, u64> _unitMoveSequence;
+        robin_hood::unordered_map<ObjectGUID, u64> _unitNetFieldSequence;
+
+        // Moves and netfield updates queued before this sequence can no longer be coalesced
+        u64 _coalesceBarrier = 0;
+
+        u32 _numQueued = 0;
+        u64 _numCoalesced = 0;
+
+        std::vector<std::pair<u16, u32>> _olderFields;
+        std::vector<std::pair<u16, u32>> _newerFields;
+    };
+}
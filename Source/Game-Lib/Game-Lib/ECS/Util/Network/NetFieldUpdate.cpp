@@ -0,0 +1,45 @@
+#include "NetFieldUpdate.h"
+
+#include <Base/Memory/Bytebuffer.h>
+
+#include <cstring>
+
+namespace ECS::Util::Network
+{
+    bool NetFieldMask::Read(Bytebuffer& buffer)
+    {
+        u8 byteMaskOffset = 0;
+        u8 numMaskBytes = 0;
+
+        _numWords = 0;
+
+        if (!buffer.GetU8(byteMaskOffset))
+            return false;
+
+        if (!buffer.GetU8(numMaskBytes))
+            return false;
+
+        // Only the words the mask reaches into are cleared, the tail of the last one stays zero
+        u32 numWords = (static_cast<u32>(numMaskBytes) + sizeof(u64) - 1) / sizeof(u64);
+        std::memset(_words.data(), 0, numWords * sizeof(u64));
+
+        if (!buffer.GetBytes(reinterpret_cast<u8*>(_words.data()), numMaskBytes))
+            return false;
+
+        _numWords = numWords;
+        _firstFieldID = static_cast<u16>(byteMaskOffset) * 8;
+
+        return true;
+    }
+
+    u32 NetFieldMask::GetNumFields() const
+    {
+        u32 numFields = 0;
+        for (u32 i = 0; i < _numWords; i++)
+        {
+            numFields += static_cast<u32>(std::popcount(_words[i]));
+        }
+
+        return numFields;
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <Gameplay/GameDefine.h>
+
+#include <entt/entt.hpp>
+
+#include <array>
+#include <bit>
+#include <vector>
+
+class Bytebuffer;
+
+namespace ECS::Util::Network
+{
+    // The field mask at the start of a netfield update: a byte offset, a byte count and that many mask bytes, followed by
+    // one u32 per set bit in field order. The bytes are read straight into a fixed set of words so decoding never
+    // allocates, and set bits are found a word at a time.
+    class NetFieldMask
+    {
+    public:
+        static constexpr u32 MAX_MASK_BYTES = 256;
+        static constexpr u32 NUM_WORDS = MAX_MASK_BYTES / sizeof(u64);
+
+        static_assert(std::endian::native == std::endian::little, "Mask byte i has to land in bits [i * 8, i * 8 + 8) of the words");
+
+    public:
+        bool Read(Bytebuffer& buffer);
+
+        // Calls callback(fieldID) for every set bit in field order, stops early and returns false when the callback does
+        template <typename Callback>
+        bool ForEachField(Callback&& callback) const
+        {
+            for (u32 wordIndex = 0; wordIndex < _numWords; wordIndex++)
+            {
+                u64 word = _words[wordIndex];
+
+                while (word)
+                {
+                    u32 bitIndex = static_cast<u32>(std::countr_zero(word));
+                    word &= (word - 1);
+
+                    u16 fieldID = static_cast<u16>(_firstFieldID + wordIndex * 64 + bitIndex);
+                    if (!callback(fieldID))
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        u32 GetNumFields() const;
+
+    private:
+        std::array<u64, NUM_WORDS> _words;
+        u32 _numWords = 0;
+        u16 _firstFieldID = 0;
+    };
+
+    // Netfield changes received during a frame. Handlers apply the values right away and add the change here, the
+    // listeners are notified once the frame's messages were dispatched. The storage is kept between frames.
+    template <typename FieldEnum>
+    class NetFieldChangeBatch
+    {
+    public:
+        struct Change
+        {
+        public:
+            entt::entity entity;
+            ObjectGUID guid;
+            FieldEnum field;
+        };
+
+    public:
+        void Add(entt::entity entity, ObjectGUID guid, FieldEnum field)
+        {
+            _changes.push_back({ entity, guid, field });
+        }
+
+        // Calls callback(change) for every change in the order they were added and empties the batch
+        template <typename Callback>
+        void Flush(Callback&& callback)
+        {
+            for (const Change& change : _changes)
+            {
+                callback(change);
+            }
+
+            _changes.clear();
+        }
+
+        void Clear() { _changes.clear(); }
+        u32 GetNumChanges() const { return static_cast<u32>(_changes.size()); }
+
+    private:
+        std::vector<Change> _changes;
+    };
+}
@@ -6,17 +6,19 @@
 #include "Game-Lib/ECS/Components/UnitMovementOverTime.h"
 #include "Game-Lib/ECS/Singletons/CharacterSingleton.h"
 #include "Game-Lib/ECS/Singletons/JoltState.h"
+#include "Game-Lib/ECS/Singletons/RemoteUnitPresentationSingleton.h"
 #include "Game-Lib/ECS/Util/Transforms.h"
+#include "Game-Lib/Util/ServiceLocator.h"
+#include "Game-Lib/Util/TaskUtil.h"
 
 #include <Base/CVarSystem/CVarSystem.h>
 
 #include <entt/entt.hpp>
 #include <Jolt/Jolt.h>
-#include <Jolt/Physics/Body/BodyFilter.h>
-#include <Jolt/Physics/Body/BodyLock.h>
-#include <Jolt/Physics/Collision/CastResult.h>
-#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
-#include <Jolt/Physics/Collision/RayCast.h>
+#include <tracy/Tracy.hpp>
+
+#include <limits>
+#include <vector>
 
 AutoCVar_Int CVAR_NetworkRemoteGroundCorrection(CVarCategory::Network, "remoteGroundCorrection", "Snaps grounded remote units to static world collision", 1, CVarFlags::EditCheckbox | CVarFlags::DoNotSave);
 AutoCVar_Int CVAR_NetworkRemoteSlopeAlignment(CVarCategory::Network, "remoteSlopeAlignment", "Visually aligns grounded remote units to sampled slopes", 0, CVarFlags::EditCheckbox | CVarFlags::DoNotSave);
@@ -28,72 +30,12 @@ namespace
     constexpr f32 SPEED_SMOOTHING = 10.0f;
     const f32 MAX_SLOPE_PITCH = glm::radians(12.0f);
 
-    class StaticBroadPhaseFilter final : public JPH::BroadPhaseLayerFilter
-    {
-    public:
-        bool ShouldCollide(JPH::BroadPhaseLayer layer) const override
-        {
-            return layer == Jolt::BroadPhaseLayers::NON_MOVING;
-        }
-    };
-
-    class StaticObjectLayerFilter final : public JPH::ObjectLayerFilter
-    {
-    public:
-        bool ShouldCollide(JPH::ObjectLayer layer) const override
-        {
-            return layer == Jolt::Layers::NON_MOVING;
-        }
-    };
-
-    struct GroundSample
-    {
-        vec3 position;
-        vec3 normal;
-    };
-
-    bool TrySampleGround(ECS::Singletons::JoltState& joltState, const vec3& expectedPosition, GroundSample& outSample)
-    {
-        const StaticBroadPhaseFilter broadPhaseFilter;
-        const StaticObjectLayerFilter objectLayerFilter;
-        const JPH::BodyFilter bodyFilter;
-        const JPH::RRayCast ray(
-            JPH::RVec3(expectedPosition.x, expectedPosition.y + GROUND_SEARCH_RANGE, expectedPosition.z),
-            JPH::Vec3(0.0f, -2.0f * GROUND_SEARCH_RANGE, 0.0f));
-        JPH::AllHitCollisionCollector<JPH::CastRayCollector> collector;
-        joltState.physicsSystem.GetNarrowPhaseQuery().CastRay(
-            ray,
-            JPH::RayCastSettings(),
-            collector,
-            broadPhaseFilter,
-            objectLayerFilter,
-            bodyFilter);
-
-        bool foundSurface = false;
-        f32 closestDistance = GROUND_SEARCH_RANGE;
-        for (const JPH::RayCastResult& hit : collector.mHits)
-        {
-            const JPH::RVec3 hitPosition = ray.GetPointOnRay(hit.mFraction);
-            const f32 distance = glm::abs(static_cast<f32>(hitPosition.GetY()) - expectedPosition.y);
-            if (distance >= closestDistance)
-                continue;
+    // A unit that moved less than this since its last ground sample keeps the sampled height instead of casting again
+    constexpr f32 GROUND_REUSE_EPSILON = 0.01f;
 
-            JPH::BodyLockRead lock(joltState.physicsSystem.GetBodyLockInterface(), hit.mBodyID);
-            if (!lock.SucceededAndIsInBroadPhase())
-                continue;
+    constexpr u32 MIN_UNITS_PER_TASK = 64;
 
-            const JPH::Vec3 normal = lock.GetBody().GetWorldSpaceSurfaceNormal(hit.mSubShapeID2, hitPosition).NormalizedOr(JPH::Vec3::sAxisY());
-            if (normal.GetY() <= 0.05f)
-                continue;
-
-            closestDistance = distance;
-            outSample.position = vec3(static_cast<f32>(hitPosition.GetX()), static_cast<f32>(hitPosition.GetY()), static_cast<f32>(hitPosition.GetZ()));
-            outSample.normal = vec3(normal.GetX(), normal.GetY(), normal.GetZ());
-            foundSurface = true;
-        }
-
-        return foundSurface;
-    }
+    using PresentedUnit = ECS::Singletons::RemoteUnitPresentationSingleton::PresentedUnit;
 
     void UpdateDisplayedSpeed(ECS::Components::UnitMovementOverTime& movement, const vec3& position, bool isGrounded, f32 deltaTime)
     {
@@ -122,10 +64,10 @@ namespace
         ECS::TransformSystem& transformSystem,
         entt::entity entity,
         const ECS::Components::MovementInfo& movementInfo,
-        const GroundSample* groundSample,
+        const vec3* groundNormal,
         f32 deltaTime)
     {
-        if (!groundSample || CVAR_NetworkRemoteSlopeAlignment.Get() == 0)
+        if (!groundNormal || CVAR_NetworkRemoteSlopeAlignment.Get() == 0)
         {
             transformSystem.SetWorldRotation(entity, GetNetworkRotation(movementInfo));
             registry.remove<ECS::Components::RemoteGroundVisualAlignment>(entity);
@@ -134,7 +76,7 @@ namespace
 
         auto& alignment = registry.get_or_emplace<ECS::Components::RemoteGroundVisualAlignment>(entity);
         const f32 blend = 1.0f - glm::exp(-GROUND_NORMAL_SMOOTHING * deltaTime);
-        alignment.smoothedNormal = glm::normalize(glm::mix(alignment.smoothedNormal, groundSample->normal, blend));
+        alignment.smoothedNormal = glm::normalize(glm::mix(alignment.smoothedNormal, *groundNormal, blend));
 
         // Resolve the sampled normal in yaw-local space. Its Z component describes the slope
         // along the unit's facing direction; ignoring X deliberately prevents terrain-induced roll.
@@ -168,36 +110,106 @@ namespace
     }
 }
 
+void ECS::Util::RemoteUnitPresentation::Init(entt::registry& registry)
+{
+    registry.ctx().emplace<Singletons::RemoteUnitPresentationSingleton>(GROUND_SEARCH_RANGE);
+}
+
 void ECS::Util::RemoteUnitPresentation::Update(entt::registry& registry, f32 deltaTime)
 {
+    ZoneScopedN("ECS::RemoteUnitPresentation::Update");
+
     auto& characterSingleton = registry.ctx().get<Singletons::CharacterSingleton>();
     auto& joltState = registry.ctx().get<Singletons::JoltState>();
+    auto& presentationSingleton = registry.ctx().get<Singletons::RemoteUnitPresentationSingleton>();
     TransformSystem& transformSystem = TransformSystem::Get(registry);
+    enki::TaskScheduler* taskScheduler = ServiceLocator::GetTaskScheduler();
+
+    std::vector<PresentedUnit>& presentedUnits = presentationSingleton.presentedUnits;
+    ::Util::GroundRaycastBatch& groundRaycastBatch = presentationSingleton.groundRaycastBatch;
+    presentedUnits.clear();
+    groundRaycastBatch.Clear();
 
     auto view = registry.view<Components::Transform, Components::Unit, Components::MovementInfo, Components::UnitMovementOverTime>();
-    view.each([&](entt::entity entity, Components::Transform& transform, Components::Unit& unit, const Components::MovementInfo& movementInfo, Components::UnitMovementOverTime& movement)
+    for (entt::entity entity : view)
     {
-        if (entity == characterSingleton.moverEntity || !movement.hasSnapshot)
-            return;
+        if (entity == characterSingleton.moverEntity || !view.get<Components::UnitMovementOverTime>(entity).hasSnapshot)
+            continue;
+
+        presentedUnits.push_back({ .entity = entity });
+    }
+
+    const bool groundCorrection = CVAR_NetworkRemoteGroundCorrection.Get() != 0;
+
+    // Terrain or models streamed in or out, or the map changed. A cached sample may sit on ground that is gone now
+    const u64 staticWorldGeneration = joltState.staticWorldGeneration.load(std::memory_order_relaxed);
+    const bool staticWorldChanged = staticWorldGeneration != presentationSingleton.groundSampleGeneration;
+    presentationSingleton.groundSampleGeneration = staticWorldGeneration;
+
+    // Interpolation only touches the unit's own components, so it runs in task ranges
+    auto interpolateUnits = [&](u32 begin, u32 end)
+    {
+        for (u32 i = begin; i < end; i++)
+        {
+            PresentedUnit& presentedUnit = presentedUnits[i];
+            const auto& movementInfo = view.get<Components::MovementInfo>(presentedUnit.entity);
+            auto& movement = view.get<Components::UnitMovementOverTime>(presentedUnit.entity);
+
+            movement.elapsed = glm::min(movement.elapsed + deltaTime, movement.duration);
+            const f32 progress = movement.duration > 0.0f ? movement.elapsed / movement.duration : 1.0f;
+            presentedUnit.renderedPosition = glm::mix(movement.startPos, movement.endPos, progress);
+
+            presentedUnit.isGrounded = movementInfo.movementFlags.grounded &&
+                !movementInfo.movementFlags.flying &&
+                !movementInfo.movementFlags.jumping;
+
+            if (!presentedUnit.isGrounded || !groundCorrection)
+            {
+                movement.hasGroundSample = false;
+                continue;
+            }
 
-        movement.elapsed = glm::min(movement.elapsed + deltaTime, movement.duration);
-        const f32 progress = movement.duration > 0.0f ? movement.elapsed / movement.duration : 1.0f;
-        vec3 renderedPosition = glm::mix(movement.startPos, movement.endPos, progress);
+            const vec3 offset = presentedUnit.renderedPosition - movement.groundQueryPos;
+            presentedUnit.needsGroundSample = staticWorldChanged || !movement.hasGroundSample || glm::dot(offset, offset) > GROUND_REUSE_EPSILON * GROUND_REUSE_EPSILON;
+        }
+    };
 
-        const bool isGrounded = movementInfo.movementFlags.grounded &&
-            !movementInfo.movementFlags.flying &&
-            !movementInfo.movementFlags.jumping;
+    ::Util::Task::ForEachRange(taskScheduler, static_cast<u32>(presentedUnits.size()), MIN_UNITS_PER_TASK, interpolateUnits);
 
-        GroundSample groundSample;
-        const bool hasGroundSample = isGrounded &&
-            CVAR_NetworkRemoteGroundCorrection.Get() != 0 &&
-            TrySampleGround(joltState, renderedPosition, groundSample);
-        if (hasGroundSample)
-            renderedPosition.y = groundSample.position.y;
+    // Every unit that moved casts in one batch, nearby units share the broad phase query
+    for (PresentedUnit& presentedUnit : presentedUnits)
+    {
+        if (presentedUnit.needsGroundSample)
+            presentedUnit.groundRayIndex = groundRaycastBatch.Add(presentedUnit.renderedPosition);
+    }
+    groundRaycastBatch.Execute(joltState.physicsSystem, taskScheduler);
+
+    // Transforms, alignment components and bodies are shared state, they are written from this thread
+    for (const PresentedUnit& presentedUnit : presentedUnits)
+    {
+        entt::entity entity = presentedUnit.entity;
+        const auto& unit = view.get<Components::Unit>(entity);
+        const auto& movementInfo = view.get<Components::MovementInfo>(entity);
+        auto& movement = view.get<Components::UnitMovementOverTime>(entity);
 
-        UpdateDisplayedSpeed(movement, renderedPosition, isGrounded, deltaTime);
+        if (presentedUnit.needsGroundSample)
+        {
+            const ::Util::GroundRaycastBatch::Sample& groundSample = groundRaycastBatch.GetSample(presentedUnit.groundRayIndex);
+
+            // Misses are cast again next frame, the ground below may still be streaming in
+            movement.groundQueryPos = presentedUnit.renderedPosition;
+            movement.groundPos = groundSample.position;
+            movement.groundNormal = groundSample.normal;
+            movement.hasGroundSample = groundSample.hasHit;
+        }
+
+        vec3 renderedPosition = presentedUnit.renderedPosition;
+        if (movement.hasGroundSample)
+            renderedPosition.y = movement.groundPos.y;
+
+        UpdateDisplayedSpeed(movement, renderedPosition, presentedUnit.isGrounded, deltaTime);
         transformSystem.SetWorldPosition(entity, renderedPosition);
-        UpdateGroundAlignment(registry, transformSystem, entity, movementInfo, hasGroundSample ? &groundSample : nullptr, deltaTime);
+        UpdateGroundAlignment(registry, transformSystem, entity, movementInfo, movement.hasGroundSample ? &movement.groundNormal : nullptr, deltaTime);
         SynchronizeBody(joltState, unit, movementInfo, renderedPosition);
-    });
+    }
 }
@@ -6,5 +6,6 @@
 
 namespace ECS::Util::RemoteUnitPresentation
 {
+    void Init(entt::registry& registry);
     void Update(entt::registry& registry, f32 deltaTime);
 }
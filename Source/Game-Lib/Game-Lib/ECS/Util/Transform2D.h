@@ -77,6 +77,9 @@ namespace ECS
         template<typename F>
         void IterateChildrenRecursiveDepth(entt::entity node, F&& callback);
 
+        // Whether entities moved since the last ProcessMovedEntities, approximate if other threads are moving entities meanwhile
+        bool HasMovedEntities() const { return elements.size_approx() != 0; }
+
         template<typename F>
         void ProcessMovedEntities(F&& fn)
         {
@@ -0,0 +1,135 @@
+#include "UIHitGrid.h"
+#include "Game-Lib/ECS/Util/UIInputUtil.h"
+
+#include <algorithm>
+
+namespace ECS::Util::UIInput
+{
+    HitGrid::HitGrid(const vec2& size, f32 cellSize) : _cellSize(cellSize)
+    {
+        _numCells = glm::max(ivec2(glm::ceil(size / cellSize)), ivec2(1));
+        _cells.resize(static_cast<size_t>(_numCells.x) * _numCells.y);
+    }
+
+    void HitGrid::Add(const Entry& entry)
+    {
+        // Nothing can ever be inside an empty hit rect
+        if (entry.hitMax.x <= entry.hitMin.x || entry.hitMax.y <= entry.hitMin.y)
+            return;
+
+        u32 entryIndex;
+        if (!_freeEntries.empty())
+        {
+            entryIndex = _freeEntries.back();
+            _freeEntries.pop_back();
+            _entries[entryIndex] = entry;
+        }
+        else
+        {
+            entryIndex = static_cast<u32>(_entries.size());
+            _entries.push_back(entry);
+        }
+
+        _canvasToEntries[entry.canvasEntity].push_back(entryIndex);
+
+        ivec2 minCell, maxCell;
+        GetCellRange(entry.hitMin, entry.hitMax, minCell, maxCell);
+
+        for (i32 y = minCell.y; y <= maxCell.y; y++)
+        {
+            for (i32 x = minCell.x; x <= maxCell.x; x++)
+            {
+                std::vector<u32>& cell = _cells[static_cast<size_t>(y) * _numCells.x + x];
+                auto position = std::upper_bound(cell.begin(), cell.end(), entryIndex, [this](u32 lhs, u32 rhs) { return IsOrderedBefore(lhs, rhs); });
+                cell.insert(position, entryIndex);
+            }
+        }
+    }
+
+    void HitGrid::RemoveCanvas(entt::entity canvasEntity)
+    {
+        auto itr = _canvasToEntries.find(canvasEntity);
+        if (itr == _canvasToEntries.end())
+            return;
+
+        for (u32 entryIndex : itr->second)
+        {
+            Entry& entry = _entries[entryIndex];
+
+            ivec2 minCell, maxCell;
+            GetCellRange(entry.hitMin, entry.hitMax, minCell, maxCell);
+
+            for (i32 y = minCell.y; y <= maxCell.y; y++)
+            {
+                for (i32 x = minCell.x; x <= maxCell.x; x++)
+                {
+                    std::vector<u32>& cell = _cells[static_cast<size_t>(y) * _numCells.x + x];
+                    cell.erase(std::find(cell.begin(), cell.end(), entryIndex));
+                }
+            }
+
+            entry = Entry();
+            _freeEntries.push_back(entryIndex);
+        }
+
+        _canvasToEntries.erase(itr);
+    }
+
+    void HitGrid::Clear()
+    {
+        for (std::vector<u32>& cell : _cells)
+            cell.clear();
+
+        _entries.clear();
+        _freeEntries.clear();
+        _canvasToEntries.clear();
+    }
+
+    void HitGrid::Query(const vec2& point, std::vector<Hit>& outHits) const
+    {
+        // Points outside the grid land in the edge cells, which is also where entries outside it were clamped to
+        ivec2 cellPos = glm::clamp(ivec2(glm::floor(point / _cellSize)), ivec2(0), _numCells - 1);
+        const std::vector<u32>& cell = _cells[static_cast<size_t>(cellPos.y) * _numCells.x + cellPos.x];
+
+        size_t firstHit = outHits.size();
+        for (u32 entryIndex : cell)
+        {
+            const Entry& entry = _entries[entryIndex];
+            if (!IsWithin(point, entry.hitMin, entry.hitMax))
+                continue;
+
+            vec2 middlePoint = (entry.min + entry.max) * 0.5f;
+            outHits.push_back({ entry.entity, entry.min, entry.max, entry.sortKey, glm::distance(middlePoint, point) });
+        }
+
+        // The cell order already has sortKey and entity right, only widgets sharing a sortKey need the distance applied
+        auto runBegin = outHits.begin() + firstHit;
+        while (runBegin != outHits.end())
+        {
+            auto runEnd = std::find_if(runBegin, outHits.end(), [&](const Hit& hit) { return hit.sortKey != runBegin->sortKey; });
+            if (runEnd - runBegin > 1)
+            {
+                std::stable_sort(runBegin, runEnd, [](const Hit& lhs, const Hit& rhs) { return lhs.distanceToPoint < rhs.distanceToPoint; });
+            }
+
+            runBegin = runEnd;
+        }
+    }
+
+    void HitGrid::GetCellRange(const vec2& min, const vec2& max, ivec2& outMinCell, ivec2& outMaxCell) const
+    {
+        outMinCell = glm::clamp(ivec2(glm::floor(min / _cellSize)), ivec2(0), _numCells - 1);
+        outMaxCell = glm::clamp(ivec2(glm::floor(max / _cellSize)), ivec2(0), _numCells - 1);
+    }
+
+    bool HitGrid::IsOrderedBefore(u32 lhsIndex, u32 rhsIndex) const
+    {
+        const Entry& lhs = _entries[lhsIndex];
+        const Entry& rhs = _entries[rhsIndex];
+
+        if (lhs.sortKey != rhs.sortKey)
+            return lhs.sortKey > rhs.sortKey;
+
+        return entt::to_integral(lhs.entity) < entt::to_integral(rhs.entity);
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <robinhood/robinhood.h>
+#include <entt/entt.hpp>
+
+#include <vector>
+
+namespace ECS::Util::UIInput
+{
+    // Uniform grid over UI reference space holding the input rect of every interactable widget, grouped by the
+    // top level canvas they were collected from so a canvas can be replaced without touching the others.
+    // Each cell keeps its entries ordered by sortKey (highest first) so lookups come out in input order.
+    class HitGrid
+    {
+    public:
+        struct Entry
+        {
+        public:
+            entt::entity entity = entt::null;
+            entt::entity canvasEntity = entt::null;
+
+            // The widget's rect as reported to input handlers
+            vec2 min = vec2(0.0f);
+            vec2 max = vec2(0.0f);
+
+            // min/max intersected with every clip region the widget is subject to, a point must be inside to hit
+            vec2 hitMin = vec2(0.0f);
+            vec2 hitMax = vec2(0.0f);
+
+            u32 sortKey = 0;
+        };
+
+        struct Hit
+        {
+        public:
+            entt::entity entity = entt::null;
+            vec2 min = vec2(0.0f);
+            vec2 max = vec2(0.0f);
+            u32 sortKey = 0;
+            f32 distanceToPoint = 0.0f;
+        };
+
+        static constexpr f32 DEFAULT_CELL_SIZE = 64.0f;
+
+    public:
+        HitGrid(const vec2& size = vec2(1920.0f, 1080.0f), f32 cellSize = DEFAULT_CELL_SIZE);
+
+        void Add(const Entry& entry);
+        void RemoveCanvas(entt::entity canvasEntity);
+        void Clear();
+
+        // Appends every entry whose hit rect contains point, ordered by sortKey descending, then distance from the
+        // point to the rect's center and finally entity
+        void Query(const vec2& point, std::vector<Hit>& outHits) const;
+
+        u32 GetNumEntries() const { return static_cast<u32>(_entries.size() - _freeEntries.size()); }
+
+    private:
+        void GetCellRange(const vec2& min, const vec2& max, ivec2& outMinCell, ivec2& outMaxCell) const;
+        bool IsOrderedBefore(u32 lhsIndex, u32 rhsIndex) const;
+
+    private:
+        ivec2 _numCells;
+        f32 _cellSize;
+
+        std::vector<Entry> _entries;
+        std::vector<u32> _freeEntries;
+        std::vector<std::vector<u32>> _cells;
+        robin_hood::unordered_map<entt::entity, std::vector<u32>> _canvasToEntries;
+    };
+}
@@ -71,6 +71,23 @@ namespace ECS::Util
             registry->ctx().emplace<ECS::Components::UI::DirtyCanvasOrderFlag>();
         }
 
+        void MarkHitGridDirty(entt::registry* registry, entt::entity entity)
+        {
+            auto* uiSingleton = registry->ctx().find<ECS::Singletons::UISingleton>();
+            if (!uiSingleton || uiSingleton->hitGridFullyDirty)
+                return;
+
+            // Render target canvases are reached through whichever panels host them, so there is no single canvas to redo
+            entt::entity canvasEntity = registry->valid(entity) ? FindOwningCanvas(registry, entity) : entt::null;
+            if (canvasEntity == entt::null || registry->all_of<ECS::Components::UI::CanvasRenderTargetTag>(canvasEntity))
+            {
+                uiSingleton->hitGridFullyDirty = true;
+                return;
+            }
+
+            uiSingleton->hitGridDirtyCanvases.insert(canvasEntity);
+        }
+
         entt::entity GetOrEmplaceCanvas(Scripting::UI::Widget*& widget, entt::registry* registry, const char* name, vec2 pos, ivec2 size, bool isRenderTexture)
         {
             ECS::Singletons::UISingleton& uiSingleton = registry->ctx().get<ECS::Singletons::UISingleton>();
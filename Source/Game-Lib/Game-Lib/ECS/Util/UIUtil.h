@@ -48,6 +48,9 @@ namespace ECS::Util
         // changes (new canvas, canvas SetLayer) so that canvasOrder bits are refreshed everywhere.
         void MarkAllCanvasSortDirty(entt::registry* registry);
 
+        // Mark the canvas owning the given widget entity for re-collection into UISingleton::hitGrid before the next hit test.
+        void MarkHitGridDirty(entt::registry* registry, entt::entity entity);
+
         void RefreshText(entt::registry* registry, entt::entity entity, std::string_view newText);
         void RefreshTemplate(entt::registry* registry, entt::entity entity, ECS::Components::UI::EventInputInfo& eventInputInfo);
         void RefreshClipper(entt::registry* registry, entt::entity entity);
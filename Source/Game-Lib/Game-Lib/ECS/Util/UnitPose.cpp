@@ -0,0 +1,191 @@
+#include "UnitPose.h"
+
+#include "Game-Lib/ECS/Components/AnimationData.h"
+#include "Game-Lib/ECS/Components/AttachmentData.h"
+#include "Game-Lib/ECS/Components/CastInfo.h"
+#include "Game-Lib/ECS/Components/MovementInfo.h"
+#include "Game-Lib/ECS/Util/Transforms.h"
+#include "Game-Lib/Util/AnimationUtil.h"
+#include "Game-Lib/Util/AttachmentUtil.h"
+#include "Game-Lib/Util/TaskUtil.h"
+
+#include <FileFormat/Novus/Model/ComplexModel.h>
+
+#include <entt/entt.hpp>
+
+namespace
+{
+    constexpr u32 MIN_UNITS_PER_TASK = 64;
+
+    void SetOrientation(vec4& settings, f32 orientation, f32 timeToChange = 0.15f)
+    {
+        f32 currentOrientation = settings.x;
+        if (orientation == currentOrientation)
+            return;
+
+        settings.y = orientation;
+        settings.z = timeToChange;
+        settings.w = 0.0f;
+    }
+
+    bool HandleUpdateOrientation(vec4& settings, f32 deltaTime)
+    {
+        if (settings.x == settings.y)
+            return false;
+
+        settings.w += deltaTime;
+        settings.w = glm::clamp(settings.w, 0.0f, settings.z);
+
+        f32 progress = settings.w / settings.z;
+        settings.x = glm::mix(settings.x, settings.y, progress);
+
+        return true;
+    }
+}
+
+namespace ECS::Util::UnitPose
+{
+    Commit& CommitList::Add(entt::entity entity)
+    {
+        if (_numCommits == _commits.size())
+            _commits.emplace_back();
+
+        Commit& commit = _commits[_numCommits++];
+        commit.entity = entity;
+        commit.removeCastInfo = false;
+        commit.attachmentTransforms.clear();
+
+        return commit;
+    }
+
+    void UpdateUnits(CommitList& commits, enki::TaskScheduler* taskScheduler, const std::function<void(Commit& commit)>& updateUnit)
+    {
+        ::Util::Task::ForEachRange(taskScheduler, commits.GetNumCommits(), MIN_UNITS_PER_TASK, [&commits, &updateUnit](u32 begin, u32 end)
+        {
+            for (u32 i = begin; i < end; i++)
+            {
+                updateUnit(commits.GetCommit(i));
+            }
+        });
+    }
+
+    void ApplyCommits(entt::registry& registry, const CommitList& commits)
+    {
+        TransformSystem& transformSystem = TransformSystem::Get(registry);
+
+        for (u32 i = 0; i < commits.GetNumCommits(); i++)
+        {
+            const Commit& commit = commits.GetCommit(i);
+
+            if (commit.removeCastInfo)
+                registry.remove<Components::CastInfo>(commit.entity);
+
+            for (const AttachmentTransform& attachmentTransform : commit.attachmentTransforms)
+            {
+                transformSystem.SetLocalTransform(attachmentTransform.entity, attachmentTransform.translation, attachmentTransform.rotation, attachmentTransform.scale);
+            }
+        }
+    }
+
+    void UpdateOrientation(const Model::ComplexModel* modelInfo, Components::AnimationData& animationData, Components::MovementInfo& movementInfo, f32 deltaTime)
+    {
+        bool isMovingForward = movementInfo.movementFlags.forward;
+        bool isMovingBackward = movementInfo.movementFlags.backward;
+        bool isMovingLeft = movementInfo.movementFlags.left;
+        bool isMovingRight = movementInfo.movementFlags.right;
+        bool isGrounded = movementInfo.movementFlags.grounded;
+        bool isFlying = !isGrounded && movementInfo.movementFlags.flying;
+
+        if (modelInfo && (isGrounded || isFlying /* || (canControlInAir && isMoving))*/))
+        {
+            f32 spineOrientation = 0.0f;
+            f32 headOrientation = 0.0f;
+            f32 waistOrientation = 0.0f;
+
+            if (!isFlying)
+            {
+                if (isMovingForward)
+                {
+                    if (isMovingRight)
+                    {
+                        spineOrientation = -30.0f;
+                        headOrientation = -30.0f;
+                        waistOrientation = 45.0f;
+                    }
+                    else if (isMovingLeft)
+                    {
+                        spineOrientation = 30.0f;
+                        headOrientation = 30.0f;
+                        waistOrientation = -45.0f;
+                    }
+                }
+                else if (isMovingBackward)
+                {
+                    if (isMovingRight)
+                    {
+                        spineOrientation = 30.0f;
+                        headOrientation = 15.0f;
+                        waistOrientation = -45.0f;
+                    }
+                    else if (isMovingLeft)
+                    {
+                        spineOrientation = -30.0f;
+                        headOrientation = -15.0f;
+                        waistOrientation = 45.0f;
+                    }
+                }
+                else if (isMovingRight)
+                {
+                    spineOrientation = -45.0f;
+                    headOrientation = -30.0f;
+                    waistOrientation = 90.0f;
+                }
+                else if (isMovingLeft)
+                {
+                    spineOrientation = 45.0f;
+                    headOrientation = 30.0f;
+                    waistOrientation = -90.0f;
+                }
+            }
+
+            f32 timeToChange = 0.1f;
+            if (!isMovingForward && !isMovingBackward && spineOrientation == 0.0f && headOrientation == 0.0f && waistOrientation == 0.0f)
+                timeToChange = 0.35f;
+
+            SetOrientation(movementInfo.spineRotationSettings, spineOrientation, timeToChange);
+            SetOrientation(movementInfo.headRotationSettings, headOrientation, timeToChange);
+            SetOrientation(movementInfo.rootRotationSettings, waistOrientation, timeToChange);
+        }
+
+        // Without a model the orientation still eases, there are just no bones to rotate yet
+        if (HandleUpdateOrientation(movementInfo.spineRotationSettings, deltaTime) && modelInfo)
+        {
+            quat rotation = glm::quat(glm::vec3(0.0f, glm::radians(movementInfo.spineRotationSettings.x), 0.0f));
+            ::Util::Animation::SetBoneRotation(modelInfo, animationData, ::Animation::Defines::Bone::SpineLow, rotation);
+        }
+        if (HandleUpdateOrientation(movementInfo.headRotationSettings, deltaTime) && modelInfo)
+        {
+            quat rotation = glm::quat(glm::vec3(0.0f, glm::radians(movementInfo.headRotationSettings.x), 0.0f));
+            ::Util::Animation::SetBoneRotation(modelInfo, animationData, ::Animation::Defines::Bone::Head, rotation);
+        }
+        if (HandleUpdateOrientation(movementInfo.rootRotationSettings, deltaTime) && modelInfo)
+        {
+            quat rotation = glm::quat(glm::vec3(0.0f, glm::radians(movementInfo.rootRotationSettings.x), 0.0f));
+            ::Util::Animation::SetBoneRotation(modelInfo, animationData, ::Animation::Defines::Bone::Default, rotation);
+        }
+    }
+
+    void CalculateAttachmentTransforms(const Model::ComplexModel* modelInfo, const Components::AnimationData& animationData, Components::AttachmentData& attachmentData, u64 frameNumber, std::vector<AttachmentTransform>& attachmentTransforms)
+    {
+        for (auto& pair : attachmentData.attachmentToInstance)
+        {
+            AttachmentTransform attachmentTransform;
+            attachmentTransform.entity = pair.second.entity;
+
+            if (!::Util::Attachment::CalculateAttachmentTransform(modelInfo, animationData, pair.first, pair.second, frameNumber, attachmentTransform.translation, attachmentTransform.rotation, attachmentTransform.scale))
+                continue;
+
+            attachmentTransforms.push_back(attachmentTransform);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Base/Types.h>
+
+#include <entt/fwd.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace enki
+{
+    class TaskScheduler;
+}
+
+namespace ECS::Components
+{
+    struct AnimationData;
+    struct AttachmentData;
+    struct MovementInfo;
+}
+
+namespace Model
+{
+    struct ComplexModel;
+}
+
+namespace ECS::Util::UnitPose
+{
+    struct AttachmentTransform
+    {
+    public:
+        entt::entity entity;
+        vec3 translation;
+        quat rotation;
+        vec3 scale;
+    };
+
+    // What a unit's pose update changes outside of the unit's own components. Units are updated in task ranges and these
+    // are applied from one thread afterwards, in the same order the units were gathered in.
+    struct Commit
+    {
+    public:
+        entt::entity entity;
+        bool removeCastInfo = false;
+        std::vector<AttachmentTransform> attachmentTransforms;
+    };
+
+    // The commits of one update, kept between frames so their attachment buffers keep their capacity
+    class CommitList
+    {
+    public:
+        void Reset() { _numCommits = 0; }
+
+        // Reuses the commit an earlier frame left in this slot, cleared
+        Commit& Add(entt::entity entity);
+
+        u32 GetNumCommits() const { return _numCommits; }
+        Commit& GetCommit(u32 index) { return _commits[index]; }
+        const Commit& GetCommit(u32 index) const { return _commits[index]; }
+
+    private:
+        std::vector<Commit> _commits;
+        u32 _numCommits = 0;
+    };
+
+    // Calls updateUnit for every commit, in task ranges when a scheduler is given and there are enough units to be worth it.
+    // updateUnit may only touch the unit's own components and its commit
+    void UpdateUnits(CommitList& commits, enki::TaskScheduler* taskScheduler, const std::function<void(Commit& commit)>& updateUnit);
+
+    // Removes cast infos and moves attachment entities from the calling thread, in the order the units were added in
+    void ApplyCommits(entt::registry& registry, const CommitList& commits);
+
+    // Turns the spine, head and waist towards the strafe direction and eases the procedural bone rotations there
+    void UpdateOrientation(const Model::ComplexModel* modelInfo, Components::AnimationData& animationData, Components::MovementInfo& movementInfo, f32 deltaTime);
+
+    // Recalculates the matrix of every active attachment, the attachment entities' transforms are left to the commit
+    void CalculateAttachmentTransforms(const Model::ComplexModel* modelInfo, const Components::AnimationData& animationData, Components::AttachmentData& attachmentData, u64 frameNumber, std::vector<AttachmentTransform>& attachmentTransforms);
+}
@@ -5,6 +5,7 @@
 
 #include <Game-Lib/Util/ServiceLocator.h>
 #include <Game-Lib/Rendering/GameRenderer.h>
+#include <Game-Lib/Rendering/Model/ModelLoader.h>
 #include <Game-Lib/Rendering/Model/ModelRenderer.h>
 #include <Game-Lib/Rendering/Terrain/TerrainRenderer.h>
 #include <Game-Lib/Rendering/Liquid/LiquidRenderer.h>
@@ -216,6 +217,25 @@ namespace Editor
                 }
             }
 
+            // Model cache, hits are models a map reused from an earlier one
+            if (ModelLoader* modelLoader = gameRenderer->GetModelLoader())
+            {
+                ModelLoader::ModelCacheStats cacheStats = modelLoader->GetModelCacheStats();
+
+                constexpr f32 BYTES_PER_MB = 1024.0f * 1024.0f;
+                ImGui::Spacing();
+                ImGui::Text("Model Cache: %u models, %.1f / %.1f MB | %llu hits, %llu misses (%.1f%%) | %llu evicted", cacheStats.numEntries, static_cast<f32>(cacheStats.numBytes) / BYTES_PER_MB, static_cast<f32>(cacheStats.budgetBytes) / BYTES_PER_MB, cacheStats.numHits, cacheStats.numMisses, cacheStats.GetHitRate() * 100.0f, cacheStats.numEvictions);
+            }
+
+            // Streamed model textures, low is resident at the small mips only
+            if (ModelRenderer* streamingModelRenderer = gameRenderer->GetModelRenderer())
+            {
+                TextureStreamer::Stats streamerStats = streamingModelRenderer->GetTextureStreamerStats();
+
+                constexpr f32 BYTES_PER_MB = 1024.0f * 1024.0f;
+                ImGui::Text("Model Textures: %u textures, %u low, %u full, %u loading | %.1f (+%.1f) / %.1f MB | %llu evicted, %u retired slots", streamerStats.numTextures, streamerStats.numLowResident - streamerStats.numFullResident, streamerStats.numFullResident, streamerStats.numJobsInFlight, static_cast<f32>(streamerStats.residentBytes) / BYTES_PER_MB, static_cast<f32>(streamerStats.reservedBytes) / BYTES_PER_MB, static_cast<f32>(streamerStats.budgetBytes) / BYTES_PER_MB, streamerStats.numEvictions, streamingModelRenderer->GetNumRetiredTextureSlots());
+            }
+
             ImGui::Spacing();
 
             if (_showSurvivingDrawCalls || _showSurvivingTriangle)
@@ -0,0 +1,137 @@
+#include "Keyframes.h"
+
+#include <FileFormat/Novus/Model/ComplexModel.h>
+
+#include <algorithm>
+
+namespace Animation::Keyframes
+{
+    // How far the cursor walks forward before giving up and searching, covers a few keys skipped by a long frame
+    static constexpr u32 MaxCursorSteps = 4;
+
+    static Segment MakeSegment(std::span<const f32> timestamps, f32 progress, u32 index)
+    {
+        Segment segment;
+        segment.index0 = index - 1;
+        segment.index1 = index;
+
+        f32 timestamp0 = timestamps[index - 1];
+        f32 timestamp1 = timestamps[index];
+
+        f32 currentProgress = progress - timestamp0;
+        f32 currentFrameDuration = timestamp1 - timestamp0;
+
+        if (currentFrameDuration == 0.0f)
+        {
+            segment.index1 = segment.index0;
+            return segment;
+        }
+
+        segment.t = currentProgress / currentFrameDuration;
+        return segment;
+    }
+
+    Segment FindSegment(std::span<const f32> timestamps, f32 progress, u32& cursor)
+    {
+        u32 numTimestamps = static_cast<u32>(timestamps.size());
+        if (numTimestamps <= 1)
+            return Segment();
+
+        u32 lastIndex = numTimestamps - 1;
+        if (progress >= timestamps[lastIndex])
+        {
+            Segment segment;
+            segment.index0 = lastIndex;
+            segment.index1 = lastIndex;
+            return segment;
+        }
+
+        // We want the first key at or after progress, skipping key 0 so progress before the first key extrapolates from
+        // the first segment. The cursor is only a starting point if no key between it and progress was skipped.
+        u32 index = cursor;
+        bool isCursorBehind = index >= 1 && index <= lastIndex && (index == 1 || timestamps[index - 1] < progress);
+
+        if (isCursorBehind)
+        {
+            for (u32 i = 0; i < MaxCursorSteps && timestamps[index] < progress; i++)
+            {
+                index++;
+            }
+
+            if (timestamps[index] < progress)
+                index = static_cast<u32>(std::lower_bound(timestamps.begin() + index, timestamps.end(), progress) - timestamps.begin());
+        }
+        else
+        {
+            index = static_cast<u32>(std::lower_bound(timestamps.begin() + 1, timestamps.end(), progress) - timestamps.begin());
+        }
+
+        cursor = index;
+        return MakeSegment(timestamps, progress, index);
+    }
+
+    Segment FindSegment(std::span<const f32> timestamps, f32 progress)
+    {
+        u32 cursor = 0;
+        return FindSegment(timestamps, progress, cursor);
+    }
+
+    void ModelTrackTimes::Build(const Model::ComplexModel& model)
+    {
+        _timestamps.clear();
+        _tracks.clear();
+        _boneTrackStarts.clear();
+        _textureTransformTrackStarts.clear();
+
+        _boneTrackStarts.reserve((model.bones.size() * NumTrackComponents) + 1);
+        for (const Model::ComplexModel::Bone& bone : model.bones)
+        {
+            AddTracks(bone.translation.tracks, _boneTrackStarts);
+            AddTracks(bone.rotation.tracks, _boneTrackStarts);
+            AddTracks(bone.scale.tracks, _boneTrackStarts);
+        }
+        _boneTrackStarts.push_back(static_cast<u32>(_tracks.size()));
+
+        _textureTransformTrackStarts.reserve((model.textureTransforms.size() * NumTrackComponents) + 1);
+        for (const Model::ComplexModel::TextureTransform& textureTransform : model.textureTransforms)
+        {
+            AddTracks(textureTransform.translation.tracks, _textureTransformTrackStarts);
+            AddTracks(textureTransform.rotation.tracks, _textureTransformTrackStarts);
+            AddTracks(textureTransform.scale.tracks, _textureTransformTrackStarts);
+        }
+        _textureTransformTrackStarts.push_back(static_cast<u32>(_tracks.size()));
+    }
+
+    template <typename Track>
+    void ModelTrackTimes::AddTracks(const std::vector<Track>& tracks, std::vector<u32>& trackStarts)
+    {
+        trackStarts.push_back(static_cast<u32>(_tracks.size()));
+
+        for (const Track& track : tracks)
+        {
+            TrackRange& range = _tracks.emplace_back();
+            range.offset = static_cast<u32>(_timestamps.size());
+            range.count = static_cast<u32>(track.timestamps.size());
+
+            for (u32 timestamp : track.timestamps)
+            {
+                _timestamps.push_back(static_cast<f32>(timestamp / 1000.0f));
+            }
+        }
+    }
+
+    std::span<const f32> ModelTrackTimes::GetTrack(const std::vector<u32>& trackStarts, u32 index, TrackComponent component, u32 sequenceID) const
+    {
+        u32 startIndex = (index * NumTrackComponents) + static_cast<u32>(component);
+        if (startIndex + 1 >= trackStarts.size())
+            return {};
+
+        u32 firstTrack = trackStarts[startIndex];
+        u32 numTracks = trackStarts[startIndex + 1] - firstTrack;
+        if (sequenceID >= numTracks)
+            return {};
+
+        const TrackRange& range = _tracks[firstTrack + sequenceID];
+        return std::span<const f32>(_timestamps.data() + range.offset, range.count);
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <span>
+#include <vector>
+
+namespace Model
+{
+    struct ComplexModel;
+}
+
+namespace Animation::Keyframes
+{
+    enum class TrackComponent : u8
+    {
+        Translation,
+        Rotation,
+        Scale,
+        Count
+    };
+    static constexpr u32 NumTrackComponents = static_cast<u32>(TrackComponent::Count);
+
+    // The two keys to blend between, index0 == index1 means no blending is needed
+    struct Segment
+    {
+    public:
+        u32 index0 = 0;
+        u32 index1 = 0;
+        f32 t = 0.0f;
+    };
+
+    // Finds the keys surrounding progress. The cursor remembers the last segment so playing forward only has to look at
+    // the next key or two, seeks and loops fall back to a binary search
+    Segment FindSegment(std::span<const f32> timestamps, f32 progress, u32& cursor);
+    Segment FindSegment(std::span<const f32> timestamps, f32 progress);
+
+    // Keyframe timestamps of every track of a model, converted from milliseconds to seconds once when the model is first animated
+    class ModelTrackTimes
+    {
+    public:
+        void Build(const Model::ComplexModel& model);
+
+        std::span<const f32> GetBoneTrack(u32 boneIndex, TrackComponent component, u32 sequenceID) const
+        {
+            return GetTrack(_boneTrackStarts, boneIndex, component, sequenceID);
+        }
+
+        std::span<const f32> GetTextureTransformTrack(u32 textureTransformIndex, TrackComponent component, u32 sequenceID) const
+        {
+            return GetTrack(_textureTransformTrackStarts, textureTransformIndex, component, sequenceID);
+        }
+
+    private:
+        struct TrackRange
+        {
+        public:
+            u32 offset = 0;
+            u32 count = 0;
+        };
+
+        template <typename Track>
+        void AddTracks(const std::vector<Track>& tracks, std::vector<u32>& trackStarts);
+
+        std::span<const f32> GetTrack(const std::vector<u32>& trackStarts, u32 index, TrackComponent component, u32 sequenceID) const;
+
+    private:
+        std::vector<f32> _timestamps;
+        std::vector<TrackRange> _tracks;
+
+        // First track of every (bone or texture transform, component) pair, the next entry marks where it ends
+        std::vector<u32> _boneTrackStarts;
+        std::vector<u32> _textureTransformTrackStarts;
+    };
+}
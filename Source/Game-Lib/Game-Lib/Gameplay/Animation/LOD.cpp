@@ -0,0 +1,118 @@
+#include "LOD.h"
+
+#include <glm/gtx/matrix_decompose.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+namespace Animation::LOD
+{
+    static Level GetDistanceLevel(const Settings& settings, f32 distance)
+    {
+        if (distance <= settings.fullDistance)
+            return Level::Full;
+
+        if (distance <= settings.halfDistance)
+            return Level::Half;
+
+        if (distance <= settings.quarterDistance)
+            return Level::Quarter;
+
+        return Level::Distant;
+    }
+
+    Level GetLevel(const Settings& settings, Level previousLevel, f32 distance, bool isVisible)
+    {
+        if (!isVisible)
+            return Level::Offscreen;
+
+        Level level = GetDistanceLevel(settings, distance);
+
+        // Getting more detailed is immediate, getting less detailed has to clear the boundary by the hysteresis
+        if (previousLevel != Level::Offscreen && level > previousLevel)
+        {
+            Level hysteresisLevel = GetDistanceLevel(settings, distance - settings.hysteresis);
+            level = hysteresisLevel > previousLevel ? hysteresisLevel : previousLevel;
+        }
+
+        return level;
+    }
+
+    u8 GetUpdateInterval(const Settings& settings, Level level)
+    {
+        switch (level)
+        {
+            case Level::Full: return 1;
+            case Level::Half: return 2;
+            case Level::Quarter: return 4;
+            case Level::Distant: return glm::max<u8>(settings.distantInterval, 1);
+            case Level::Offscreen: return settings.offscreenInterval;
+        }
+
+        return 1;
+    }
+
+    Decision Step(const Settings& settings, State& state, Level level, u32 staggerOffset)
+    {
+        Decision decision;
+
+        u8 interval = GetUpdateInterval(settings, level);
+        decision.maxBoneDepth = level >= Level::Quarter ? settings.subsetBoneDepth : 0;
+
+        bool isFirstPose = !state.hasPose;
+        bool isMoreDetailed = level < state.level;
+        state.level = level;
+
+        if (isFirstPose || isMoreDetailed || interval == 1)
+        {
+            // Offset the first interval so entities that start together don't all update on the same frame
+            state.hasPose = true;
+            state.framesSinceUpdate = interval > 1 ? static_cast<u8>(staggerOffset % interval) : 0;
+
+            decision.evaluate = true;
+            return decision;
+        }
+
+        if (interval == 0)
+        {
+            decision.evaluate = false;
+            return decision;
+        }
+
+        state.framesSinceUpdate++;
+        if (state.framesSinceUpdate >= interval)
+            state.framesSinceUpdate = 0;
+
+        decision.evaluate = state.framesSinceUpdate == 0;
+        decision.interpolate = settings.interpolate;
+        decision.blendFactor = static_cast<f32>(state.framesSinceUpdate + 1) / static_cast<f32>(interval);
+
+        return decision;
+    }
+
+    mat4x4 BlendPose(const mat4x4& from, const mat4x4& to, f32 blendFactor)
+    {
+        vec3 fromScale;
+        quat fromRotation;
+        vec3 fromTranslation;
+        vec3 toScale;
+        quat toRotation;
+        vec3 toTranslation;
+        vec3 skew;
+        vec4 perspective;
+
+        // Bones scaled down to nothing have no rotation to recover, those are the only ones still lerped element wise
+        if (!glm::decompose(from, fromScale, fromRotation, fromTranslation, skew, perspective) || !glm::decompose(to, toScale, toRotation, toTranslation, skew, perspective))
+            return from + ((to - from) * blendFactor);
+
+        vec3 scale = glm::mix(fromScale, toScale, blendFactor);
+        quat rotation = glm::slerp(fromRotation, toRotation, blendFactor);
+        vec3 translation = glm::mix(fromTranslation, toTranslation, blendFactor);
+
+        mat4x4 result = glm::toMat4(rotation);
+        result[0] *= scale.x;
+        result[1] *= scale.y;
+        result[2] *= scale.z;
+        result[3] = vec4(translation, 1.0f);
+
+        return result;
+    }
+}
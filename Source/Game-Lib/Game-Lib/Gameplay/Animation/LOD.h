@@ -0,0 +1,65 @@
+#pragma once
+#include <Base/Types.h>
+
+namespace Animation::LOD
+{
+    // Ordered from most to least detailed
+    enum class Level : u8
+    {
+        Full,
+        Half,
+        Quarter,
+        Distant,
+        Offscreen
+    };
+
+    struct Settings
+    {
+    public:
+        f32 fullDistance = 40.0f;
+        f32 halfDistance = 90.0f;
+        f32 quarterDistance = 160.0f;
+
+        // How far back past a boundary an entity has to move before it drops to a coarser level, stops flickering on the edge
+        f32 hysteresis = 5.0f;
+
+        u8 distantInterval = 8;
+        u8 offscreenInterval = 0; // 0 freezes offscreen entities until they come back into view
+
+        // From Quarter and beyond bones deeper than this follow their parent rigidly, 0 evaluates every bone
+        u8 subsetBoneDepth = 4;
+
+        bool interpolate = true;
+    };
+
+    struct State
+    {
+    public:
+        Level level = Level::Full;
+        u8 framesSinceUpdate = 0;
+        bool hasPose = false;
+    };
+
+    struct Decision
+    {
+    public:
+        bool evaluate = true;
+
+        // Blend the displayed pose from the previous evaluated pose to the latest one by blendFactor
+        bool interpolate = false;
+        f32 blendFactor = 1.0f;
+
+        u8 maxBoneDepth = 0;
+    };
+
+    Level GetLevel(const Settings& settings, Level previousLevel, f32 distance, bool isVisible);
+
+    // Frames between evaluations, 0 means the pose is frozen
+    u8 GetUpdateInterval(const Settings& settings, Level level);
+
+    // Advances the state by one frame. The stagger offset spreads entities sharing an interval over different frames.
+    Decision Step(const Settings& settings, State& state, Level level, u32 staggerOffset);
+
+    // Blends one bone matrix of the pose by translation, rotation and scale, a plain lerp of the matrices would shrink and shear rotating bones
+    mat4x4 BlendPose(const mat4x4& from, const mat4x4& to, f32 blendFactor);
+}
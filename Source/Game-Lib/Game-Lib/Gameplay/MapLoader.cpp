@@ -15,6 +15,7 @@
 #include "Game-Lib/Util/ServiceLocator.h"
 #include "Game-Lib/Util/AssetPath.h"
 
+#include <Base/CVarSystem/CVarSystem.h>
 #include <Base/Memory/Bytebuffer.h>
 #include <Base/Memory/FileReader.h>
 
@@ -119,7 +120,8 @@ void MapLoader::Update(f32 deltaTime)
             _currentMapID = mapID;
 
             TerrainLoader::LoadDesc loadDesc;
-            loadDesc.loadType = TerrainLoader::LoadType::Full;
+            i32 terrainStreaming = *CVarSystem::Get()->GetIntCVar(CVarCategory::Client | CVarCategory::Rendering, "terrainStreaming"_h);
+            loadDesc.loadType = terrainStreaming ? TerrainLoader::LoadType::Streaming : TerrainLoader::LoadType::Full;
             loadDesc.mapName = mapInternalName;
         
             _terrainLoader->AddInstance(loadDesc);
@@ -147,6 +147,8 @@ void CanvasRenderer::Update(f32 deltaTime)
 
     uiRegistry->view<Widget, DestroyWidget>().each([&](entt::entity entity, Widget& widget)
     {
+        ECS::Util::UI::MarkHitGridDirty(uiRegistry, entity);
+
         if (widget.type == WidgetType::Canvas)
         {
             // RT canvases own retained GPU buffers (finalSortedArgs + finalCount). Destroy them
@@ -330,6 +332,8 @@ void CanvasRenderer::Update(f32 deltaTime)
     // Update clipper data
     uiRegistry->view<DirtyChildClipper>().each([&](entt::entity entity)
     {
+        ECS::Util::UI::MarkHitGridDirty(uiRegistry, entity);
+
         ZoneScopedN("CanvasRenderer::PropagateChildClipper");
         transformSystem2D.IterateChildrenRecursiveBreadth(entity, [&](entt::entity childEntity)
         {
@@ -474,6 +478,8 @@ void CanvasRenderer::Update(f32 deltaTime)
             bool mainBucketDirty = false;
             dirtySortView.each([&](entt::entity canvasEntity, Canvas&)
             {
+                ECS::Util::UI::MarkHitGridDirty(uiRegistry, canvasEntity);
+
                 u8 canvasOrder = _canvasOrderByEntity.at(canvasEntity);
                 u32 traversalIndex = 0;
                 u8 rootPriority = ResolvePriority(uiRegistry, canvasEntity);
@@ -496,6 +502,12 @@ void CanvasRenderer::Update(f32 deltaTime)
         }
     }
 
+    // Visibility and interactable changes take the widget in or out of input hit testing
+    uiRegistry->view<DirtyWidgetFlags>().each([&](entt::entity entity)
+    {
+        ECS::Util::UI::MarkHitGridDirty(uiRegistry, entity);
+    });
+
     uiRegistry->clear<DirtyWidgetData>();
     uiRegistry->clear<DirtyWidgetFlags>();
     uiRegistry->clear<DirtyChildClipper>();
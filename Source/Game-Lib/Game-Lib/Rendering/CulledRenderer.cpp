@@ -77,7 +77,7 @@ void CulledRenderer::Clear()
 // Finalize-written per-view group counts instead of covering every instance
 void CulledRenderer::DispatchInstancedFill(PassParams& params, const std::string& markerName, Renderer::DescriptorSetResource& fillSet, bool filtered, u32 currentBitmaskIndex, u32 bitmaskOffset, bool keepDynamic, u32 baseInstanceLookupOffset, u32 drawCallDataSize, Renderer::BufferResource indirectArgsBuffer, u32 indirectArgsByteOffset)
 {
-    const u32 numInstances = params.cullingResources->GetNumInstances();
+    const u32 numInstances = params.cullingResources->GetNumInstanceRefSlots();
 
     params.commandList->PushMarker(markerName, Color::White);
 
@@ -343,7 +343,7 @@ void CulledRenderer::OccluderPass(OccluderPassParams& params)
 // them before calling
 void CulledRenderer::RunInstancedCullingDispatch(CullingPassParams& params, bool useBitmasks, bool bindDepthPyramid)
 {
-    const u32 numInstances = params.cullingResources->GetNumInstances();
+    const u32 numInstances = params.cullingResources->GetNumInstanceRefSlots();
 
     Renderer::ComputePipelineID pipeline = _cullingInstancedPipeline[useBitmasks];
     params.commandList->BeginPipeline(pipeline);
@@ -1,4 +1,5 @@
 #pragma once
+#include "Game-Lib/Rendering/InstanceRefTable.h"
 
 #include <Base/Types.h>
 #include <Base/Util/DebugHandler.h>
@@ -9,14 +10,6 @@
 
 class CulledRenderer;
 
-struct InstanceRef
-{
-    u32 instanceID;
-    u32 drawID;
-    u32 extraID; // For example ModelRenderer uses this for TextureData
-    u32 padding;
-};
-
 class CullingResourcesBase
 {
 public:
@@ -75,6 +68,7 @@ public:
 
     // Instances stats
     u32 GetNumInstances() { return _numInstances; }
+    u32 GetNumInstanceRefSlots() { return static_cast<u32>(_instanceRefs.Count()); } // Tables that keep free slots between draws have more slots than instances
     u32 GetNumSurvivingOccluderInstances() { return _numSurvivingOccluderInstances; }
     u32 GetNumSurvivingInstances(u32 viewID) { return _numSurvivingInstances[viewID]; }
 
@@ -240,6 +240,13 @@ void DebugRenderer::Update(f32 deltaTime)
 
 void DebugRenderer::SyncToGPU()
 {
+    // The passes draw the counts synced here, the vertices can be cleared for the next frame while a pipelined Render records this one
+    _numSyncedVertices2D = static_cast<u32>(_debugVertices2D.Count());
+    _numSyncedVerticesSolid2D = static_cast<u32>(_debugVerticesSolid2D.Count());
+    _numSyncedVertices3D = static_cast<u32>(_debugVertices3D.Count());
+    _numSyncedVerticesSolid3D = static_cast<u32>(_debugVerticesSolid3D.Count());
+    _numSyncedVerticesSolid3DOverlay = static_cast<u32>(_debugVerticesSolid3DOverlay.Count());
+
     if (_debugVertices2D.SyncToGPU(_renderer))
     {
         _draw2DDescriptorSet.Bind("_vertices", _debugVertices2D.GetBuffer());
@@ -260,6 +267,12 @@ void DebugRenderer::SyncToGPU()
     {
         _drawSolid3DOverlayDescriptorSet.Bind("_vertices", _debugVerticesSolid3DOverlay.GetBuffer());
     }
+
+    _debugVertices2D.Clear();
+    _debugVerticesSolid2D.Clear();
+    _debugVertices3D.Clear();
+    _debugVerticesSolid3D.Clear();
+    _debugVerticesSolid3DOverlay.Clear();
 }
 
 void DebugRenderer::AddStartFramePass(Renderer::RenderGraph* renderGraph, RenderResources& resources, u8 frameIndex)
@@ -343,11 +356,10 @@ void DebugRenderer::Add2DPass(Renderer::RenderGraph* renderGraph, RenderResource
                     commandList.BindDescriptorSet(data.drawSolid2DSet, frameIndex);
 
                     // Draw
-                    commandList.Draw(static_cast<u32>(_debugVerticesSolid2D.Count()), 1, 0, 0);
+                    commandList.Draw(_numSyncedVerticesSolid2D, 1, 0, 0);
 
                     commandList.EndPipeline(pipeline);
                 }
-                _debugVerticesSolid2D.Clear();
             }
 
             // Wireframe
@@ -360,11 +372,10 @@ void DebugRenderer::Add2DPass(Renderer::RenderGraph* renderGraph, RenderResource
                     commandList.BindDescriptorSet(data.draw2DSet, frameIndex);
 
                     // Draw
-                    commandList.Draw(static_cast<u32>(_debugVertices2D.Count()), 1, 0, 0);
+                    commandList.Draw(_numSyncedVertices2D, 1, 0, 0);
 
                     commandList.EndPipeline(pipeline);
                 }
-                _debugVertices2D.Clear();
 
                 // GPU side debug rendering
                 {
@@ -456,11 +467,10 @@ void DebugRenderer::Add3DPass(Renderer::RenderGraph* renderGraph, RenderResource
                     commandList.BindDescriptorSet(data.drawSolid3DSet, frameIndex);
 
                     // Draw
-                    commandList.Draw(static_cast<u32>(_debugVerticesSolid3D.Count()), 1, 0, 0);
+                    commandList.Draw(_numSyncedVerticesSolid3D, 1, 0, 0);
 
                     commandList.EndPipeline(pipeline);
                 }
-                _debugVerticesSolid3D.Clear();
             }
 
             // Wireframe
@@ -475,11 +485,10 @@ void DebugRenderer::Add3DPass(Renderer::RenderGraph* renderGraph, RenderResource
                     commandList.BindDescriptorSet(data.draw3DSet, frameIndex);
 
                     // Draw
-                    commandList.Draw(static_cast<u32>(_debugVertices3D.Count()), 1, 0, 0);
+                    commandList.Draw(_numSyncedVertices3D, 1, 0, 0);
 
                     commandList.EndPipeline(pipeline);
                 }
-                _debugVertices3D.Clear();
 
                 // GPU side debug rendering
                 {
@@ -504,11 +513,9 @@ void DebugRenderer::Add3DPass(Renderer::RenderGraph* renderGraph, RenderResource
                 commandList.BindDescriptorSet(data.globalSet, frameIndex);
                 commandList.BindDescriptorSet(data.drawSolid3DOverlaySet, frameIndex);
 
-                commandList.Draw(static_cast<u32>(_debugVerticesSolid3DOverlay.Count()), 1, 0, 0);
+                commandList.Draw(_numSyncedVerticesSolid3DOverlay, 1, 0, 0);
 
                 commandList.EndPipeline(pipeline);
-
-                _debugVerticesSolid3DOverlay.Clear();
             }
 
             commandList.EndRenderPass(renderPassDesc);
@@ -119,6 +119,13 @@ private:
     Renderer::GPUVector<DebugVertexSolid3D> _debugVerticesSolid3D;
     Renderer::GPUVector<DebugVertexSolid3D> _debugVerticesSolid3DOverlay; // depth test disabled
 
+    // Vertex counts of the last SyncToGPU, the CPU vectors are already being filled with the next frame when the passes record
+    u32 _numSyncedVertices2D = 0;
+    u32 _numSyncedVerticesSolid2D = 0;
+    u32 _numSyncedVertices3D = 0;
+    u32 _numSyncedVerticesSolid3D = 0;
+    u32 _numSyncedVerticesSolid3DOverlay = 0;
+
     Renderer::DescriptorSet _drawSolid2DDescriptorSet;
     Renderer::DescriptorSet _drawSolid3DDescriptorSet;
     Renderer::DescriptorSet _drawSolid3DOverlayDescriptorSet;
@@ -241,6 +241,7 @@ GameRenderer::GameRenderer(bool enableRenderDoc)
     _lightRenderer = new LightRenderer(_renderer, this, _debugRenderer, _modelRenderer);
     _modelLoader = new ModelLoader(_modelRenderer, _lightRenderer);
     _modelLoader->Init();
+    ServiceLocator::SetModelLoader(_modelLoader);
 
     _liquidRenderer = new LiquidRenderer(_renderer, this, _debugRenderer);
     _liquidLoader = new LiquidLoader(_liquidRenderer);
@@ -307,18 +308,45 @@ void GameRenderer::UpdateRenderers(f32 deltaTime)
     _effectRenderer->Update(deltaTime);
     _shadowRenderer->Update(deltaTime, _resources);
 
+    // Synced here rather than in Render, the simulation writes the next frame's cameras while a pipelined Render runs
+    if (_resources.cameras.SyncToGPU(_renderer))
+    {
+        // Should never fire: the vector is prefilled to MAX_VIEWS at init. Kept as a safety net,
+        // note the rebinds only reach the shaders a frame-cycle later
+        _resources.globalDescriptorSet.Bind("_cameras", _resources.cameras.GetBuffer());
+        _shadowRenderer->BindCameraBuffers(_resources);
+    }
+
     // Last: uploads debug verts, so it must run after other renderers' debug draws and before FlipFrame.
     _debugRenderer->Update(deltaTime);
 }
 
-f32 GameRenderer::Render()
+void GameRenderer::EndImGuiFrame()
 {
-    // If the window is minimized we want to pause rendering
+    // A minimized window skips the editor but the ImGui frame still has to be closed
     if (_window->IsMinimized())
     {
         ImGui::End();
         ImGui::Render();
-        
+
+        return;
+    }
+
+    Editor::EditorHandler* editorHandler = ServiceLocator::GetEditorHandler();
+    editorHandler->DrawImGui();
+    editorHandler->EndEditor();
+    editorHandler->EndImGui();
+    ImGui::Render();
+}
+
+f32 GameRenderer::Render(bool endImGuiFrame)
+{
+    // If the window is minimized we want to pause rendering
+    if (_window->IsMinimized())
+    {
+        if (endImGuiFrame)
+            EndImGuiFrame();
+
         return 0.0f;
     }
 
@@ -351,14 +379,6 @@ f32 GameRenderer::Render()
         }
     }
 
-    if (_resources.cameras.SyncToGPU(_renderer))
-    {
-        // Should never fire: the vector is prefilled to MAX_VIEWS at init. Kept as a safety net,
-        // note the rebinds only reach the shaders a frame-cycle later
-        _resources.globalDescriptorSet.Bind("_cameras", _resources.cameras.GetBuffer());
-        _shadowRenderer->BindCameraBuffers(_resources);
-    }
-
     // Create rendergraph
     Renderer::RenderGraphDesc renderGraphDesc;
     renderGraphDesc.allocator = _frameAllocator[_frameIndex]; // We need to give our rendergraph an allocator to use
@@ -366,10 +386,8 @@ f32 GameRenderer::Render()
 
     f32 timeWaited = _renderer->FlipFrame(_frameIndex);
 
-    editorHandler->DrawImGui();
-    editorHandler->EndEditor();
-    editorHandler->EndImGui();
-    ImGui::Render();
+    if (endImGuiFrame)
+        EndImGuiFrame();
 
     _renderer->ResetTimeQueries(_frameIndex);
 
@@ -66,7 +66,11 @@ public:
 
     bool UpdateWindow(f32 deltaTime);
     void UpdateRenderers(f32 deltaTime);
-    f32 Render();
+
+    // Render ends the ImGui frame itself unless endImGuiFrame is false, pipelined rendering ends it on the simulation
+    // thread through EndImGuiFrame and records the frame on the render thread
+    void EndImGuiFrame();
+    f32 Render(bool endImGuiFrame = true);
 
     void ReloadShaders(bool forceRecompileAll);
 
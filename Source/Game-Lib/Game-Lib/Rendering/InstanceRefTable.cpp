@@ -0,0 +1,299 @@
+#include "InstanceRefTable.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr InstanceRef FreeInstanceRef = { 0, InstanceRefTable::FREE_SLOT_DRAW_ID, 0, 0 };
+
+    // Below this many slots culling the free ones costs next to nothing
+    constexpr u32 MIN_SLOTS_TO_REBUILD = 1024;
+
+    // Every draw with refs gets the same headroom, empty draws get their first block when they need it
+    u32 GetRebuiltCapacity(u32 count)
+    {
+        return count > 0 ? count + std::max(count / 2, 1u) : 0;
+    }
+}
+
+void InstanceRefTable::Clear()
+{
+    _draws.clear();
+    _refs.clear();
+    _numRefs = 0;
+    _freeBlocks.Clear();
+    _instanceSlots.clear();
+    _slotIndices.clear();
+
+    _isFullyDirty = false;
+    _dirtyRefSlots.clear();
+    _dirtyDraws.clear();
+    _isRefDirty.clear();
+    _isDrawDirty.clear();
+}
+
+void InstanceRefTable::SetNumDraws(u32 numDraws)
+{
+    u32 numExistingDraws = static_cast<u32>(_draws.size());
+    if (numDraws <= numExistingDraws)
+        return;
+
+    _draws.resize(numDraws);
+
+    for (u32 drawID = numExistingDraws; drawID < numDraws; drawID++)
+    {
+        SetDrawDirty(drawID);
+    }
+}
+
+void InstanceRefTable::SetInstanceRefs(u32 instanceID, std::span<const DrawRef> drawRefs)
+{
+    if (instanceID >= _instanceSlots.size())
+    {
+        if (drawRefs.empty())
+            return;
+
+        _instanceSlots.resize(instanceID + 1);
+    }
+
+    std::vector<u32>& slots = _instanceSlots[instanceID];
+
+    // Drop refs in draws the instance no longer uses and update the rest in place, Erase swap removes from slots
+    for (u32 i = 0; i < slots.size();)
+    {
+        u32 slot = slots[i];
+        InstanceRef& ref = _refs[slot];
+
+        auto drawRef = std::find_if(drawRefs.begin(), drawRefs.end(), [&ref](const DrawRef& drawRef) { return drawRef.drawID == ref.drawID; });
+        if (drawRef == drawRefs.end())
+        {
+            Erase(slot);
+            continue;
+        }
+
+        if (ref.extraID != drawRef->extraID)
+        {
+            ref.extraID = drawRef->extraID;
+            SetRefDirty(slot);
+        }
+
+        i++;
+    }
+
+    for (const DrawRef& drawRef : drawRefs)
+    {
+        bool hasRef = std::any_of(slots.begin(), slots.end(), [this, &drawRef](u32 slot) { return _refs[slot].drawID == drawRef.drawID; });
+        if (!hasRef)
+        {
+            Insert(drawRef.drawID, instanceID, drawRef.extraID);
+        }
+    }
+}
+
+void InstanceRefTable::Rebuild()
+{
+    u32 numSlots = 0;
+    for (const DrawRange& range : _draws)
+    {
+        numSlots += GetRebuiltCapacity(range.count);
+    }
+
+    _rebuiltRefs.assign(numSlots, FreeInstanceRef);
+
+    u32 offset = 0;
+    for (DrawRange& range : _draws)
+    {
+        for (u32 i = 0; i < range.count; i++)
+        {
+            const InstanceRef& ref = _refs[range.offset + i];
+            u32 slotIndex = _slotIndices[range.offset + i];
+
+            _rebuiltRefs[offset + i] = ref;
+            _instanceSlots[ref.instanceID][slotIndex] = offset + i;
+        }
+
+        range.capacity = GetRebuiltCapacity(range.count);
+        range.offset = range.capacity > 0 ? offset : 0;
+        offset += range.capacity;
+    }
+
+    _refs.swap(_rebuiltRefs);
+    _freeBlocks.Clear();
+
+    // Everything moved, so the slot indices are easier to write again from the instances than to carry over
+    _slotIndices.assign(numSlots, 0);
+    for (const std::vector<u32>& slots : _instanceSlots)
+    {
+        for (u32 i = 0; i < slots.size(); i++)
+        {
+            _slotIndices[slots[i]] = i;
+        }
+    }
+
+    ResetDirty();
+    _isFullyDirty = true;
+}
+
+bool InstanceRefTable::ShouldRebuild() const
+{
+    u32 numSlots = GetNumSlots();
+    if (numSlots < MIN_SLOTS_TO_REBUILD)
+        return false;
+
+    u32 numFreeSlots = numSlots - _numRefs;
+    return _dirtyRefSlots.size() > numSlots / 2 || numFreeSlots > _numRefs * 2;
+}
+
+void InstanceRefTable::ResetDirty()
+{
+    for (u32 slot : _dirtyRefSlots)
+    {
+        _isRefDirty[slot] = 0;
+    }
+
+    for (u32 drawID : _dirtyDraws)
+    {
+        _isDrawDirty[drawID] = 0;
+    }
+
+    _isFullyDirty = false;
+    _dirtyRefSlots.clear();
+    _dirtyDraws.clear();
+}
+
+void InstanceRefTable::Insert(u32 drawID, u32 instanceID, u32 extraID)
+{
+    if (_draws[drawID].count == _draws[drawID].capacity)
+    {
+        Grow(drawID);
+    }
+
+    DrawRange& range = _draws[drawID];
+    u32 slot = range.offset + range.count;
+
+    InstanceRef& ref = _refs[slot];
+    ref.instanceID = instanceID;
+    ref.drawID = drawID;
+    ref.extraID = extraID;
+    ref.padding = 0;
+
+    std::vector<u32>& slots = _instanceSlots[instanceID];
+    _slotIndices[slot] = static_cast<u32>(slots.size());
+    slots.push_back(slot);
+    SetRefDirty(slot);
+
+    range.count++;
+    _numRefs++;
+    SetDrawDirty(drawID);
+}
+
+void InstanceRefTable::Erase(u32 slot)
+{
+    const InstanceRef& ref = _refs[slot];
+    u32 drawID = ref.drawID;
+
+    std::vector<u32>& slots = _instanceSlots[ref.instanceID];
+    u32 slotIndex = _slotIndices[slot];
+    u32 lastSlot = slots.back();
+    slots[slotIndex] = lastSlot;
+    _slotIndices[lastSlot] = slotIndex;
+    slots.pop_back();
+
+    // Fill the hole with the last ref of the draw, the slot that ref leaves becomes free
+    DrawRange& range = _draws[drawID];
+    u32 lastRefSlot = range.offset + range.count - 1;
+    if (slot != lastRefSlot)
+    {
+        MoveRef(lastRefSlot, slot);
+    }
+
+    FreeSlot(lastRefSlot);
+
+    range.count--;
+    _numRefs--;
+    SetDrawDirty(drawID);
+}
+
+void InstanceRefTable::Grow(u32 drawID)
+{
+    DrawRange& range = _draws[drawID];
+    u32 capacity = std::max(range.capacity * 2, MIN_DRAW_CAPACITY);
+
+    u32 offset = 0;
+    if (!_freeBlocks.Allocate(capacity, offset))
+    {
+        offset = static_cast<u32>(_refs.size());
+        _refs.resize(offset + capacity, FreeInstanceRef);
+        _slotIndices.resize(offset + capacity);
+
+        // The buffer grows with whatever was in memory, the free slots have to be uploaded too
+        for (u32 slot = offset; slot < offset + capacity; slot++)
+        {
+            SetRefDirty(slot);
+        }
+    }
+
+    for (u32 i = 0; i < range.count; i++)
+    {
+        MoveRef(range.offset + i, offset + i);
+        FreeSlot(range.offset + i);
+    }
+
+    _freeBlocks.Free(range.offset, range.capacity);
+
+    range.offset = offset;
+    range.capacity = capacity;
+    SetDrawDirty(drawID);
+}
+
+void InstanceRefTable::MoveRef(u32 fromSlot, u32 toSlot)
+{
+    InstanceRef& ref = _refs[toSlot];
+    ref = _refs[fromSlot];
+
+    u32 slotIndex = _slotIndices[fromSlot];
+    _instanceSlots[ref.instanceID][slotIndex] = toSlot;
+    _slotIndices[toSlot] = slotIndex;
+
+    SetRefDirty(toSlot);
+}
+
+void InstanceRefTable::FreeSlot(u32 slot)
+{
+    _refs[slot] = FreeInstanceRef;
+    SetRefDirty(slot);
+}
+
+void InstanceRefTable::SetRefDirty(u32 slot)
+{
+    if (_isFullyDirty)
+        return;
+
+    if (slot >= _isRefDirty.size())
+    {
+        _isRefDirty.resize(_refs.size(), 0);
+    }
+
+    if (_isRefDirty[slot])
+        return;
+
+    _isRefDirty[slot] = 1;
+    _dirtyRefSlots.push_back(slot);
+}
+
+void InstanceRefTable::SetDrawDirty(u32 drawID)
+{
+    if (_isFullyDirty)
+        return;
+
+    if (drawID >= _isDrawDirty.size())
+    {
+        _isDrawDirty.resize(_draws.size(), 0);
+    }
+
+    if (_isDrawDirty[drawID])
+        return;
+
+    _isDrawDirty[drawID] = 1;
+    _dirtyDraws.push_back(drawID);
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "Game-Lib/Util/RangeAllocator.h"
+
+#include <Base/Types.h>
+
+#include <span>
+#include <vector>
+
+struct InstanceRef
+{
+    u32 instanceID;
+    u32 drawID;
+    u32 extraID; // For example ModelRenderer uses this for TextureData
+    u32 padding;
+};
+
+// CPU side of a culling resource's InstanceRefs. Every draw owns a block of slots with its refs packed at the start and
+// the rest kept free for refs it gets later, so adding or removing a ref only ever touches the draw it belongs to.
+// A draw that outgrows its block moves to one twice the size, reusing blocks other draws moved out of before growing
+// the table. Each instance keeps back-pointers to the slots holding its refs, and each slot its position among them,
+// so changing one instance never searches anything.
+class InstanceRefTable
+{
+public:
+    // Free slots hold this drawID, culling runs them as an empty draw
+    static constexpr u32 FREE_SLOT_DRAW_ID = 0xFFFFFFFF;
+    static constexpr u32 MIN_DRAW_CAPACITY = 4;
+
+    struct DrawRef
+    {
+    public:
+        u32 drawID;
+        u32 extraID;
+    };
+
+    struct DrawRange
+    {
+    public:
+        u32 offset = 0;
+        u32 count = 0;
+        u32 capacity = 0;
+    };
+
+    void Clear();
+
+    // Draws are only ever appended, new draws start out empty and without slots
+    void SetNumDraws(u32 numDraws);
+
+    // Makes the refs of instanceID exactly the given ones, refs already in the right draw are updated in place
+    void SetInstanceRefs(u32 instanceID, std::span<const DrawRef> drawRefs);
+    void RemoveInstance(u32 instanceID) { SetInstanceRefs(instanceID, {}); }
+
+    // Packs the draws back to back again with some room to grow each, afterwards the whole table is dirty
+    void Rebuild();
+
+    // When more than half the table changed uploading all of it is cheaper, and free slots cost culling threads
+    bool ShouldRebuild() const;
+
+    u32 GetNumDraws() const { return static_cast<u32>(_draws.size()); }
+    u32 GetNumRefs() const { return _numRefs; }
+    u32 GetNumSlots() const { return static_cast<u32>(_refs.size()); }
+
+    const DrawRange& GetDrawRange(u32 drawID) const { return _draws[drawID]; }
+    const std::vector<InstanceRef>& GetRefs() const { return _refs; }
+
+    // What changed since the last ResetDirty, each slot and draw listed once. Slots at or past GetNumSlots() are gone
+    // since a Rebuild shrunk the table and can be skipped. While fully dirty the lists are left empty.
+    bool IsFullyDirty() const { return _isFullyDirty; }
+    const std::vector<u32>& GetDirtyRefSlots() const { return _dirtyRefSlots; }
+    const std::vector<u32>& GetDirtyDraws() const { return _dirtyDraws; }
+    void ResetDirty();
+
+private:
+    void Insert(u32 drawID, u32 instanceID, u32 extraID);
+    void Erase(u32 slot);
+    void Grow(u32 drawID);
+    void MoveRef(u32 fromSlot, u32 toSlot);
+    void FreeSlot(u32 slot);
+
+    void SetRefDirty(u32 slot);
+    void SetDrawDirty(u32 drawID);
+
+private:
+    std::vector<DrawRange> _draws;
+    std::vector<InstanceRef> _refs;
+    u32 _numRefs = 0;
+
+    // Blocks draws moved out of when they grew
+    Util::RangeAllocator _freeBlocks;
+
+    // The slots holding each instance's refs, indexed by instanceID, and where each slot is in its instance's list
+    std::vector<std::vector<u32>> _instanceSlots;
+    std::vector<u32> _slotIndices;
+
+    bool _isFullyDirty = false;
+    std::vector<u32> _dirtyRefSlots;
+    std::vector<u32> _dirtyDraws;
+
+    // Only ever grow, so a removed slot that comes back while still listed isn't listed twice
+    std::vector<u8> _isRefDirty;
+    std::vector<u8> _isDrawDirty;
+
+    // Scratch space for Rebuild
+    std::vector<InstanceRef> _rebuiltRefs;
+};
@@ -34,30 +34,33 @@ void LiquidLoader::Update(f32 deltaTime)
     if (numDequeued == 0)
         return;
 
-    LiquidRenderer::ReserveInfo reserveInfo;
-
+    // Reserve one chunk at a time so each chunk gets ranges of its own that it can give back when it is unloaded
     for (u32 i = 0; i < numDequeued; i++)
     {
         LoadRequestInternal& request = _workingRequests[i];
+        if (request.numInstances == 0)
+            continue;
 
-        reserveInfo.numInstances += request.numInstances;
-        reserveInfo.numVertices += request.numVertices;
-        reserveInfo.numIndices += request.numIndices;
-    }
+        u32 chunkID = (request.chunkY * Terrain::CHUNK_NUM_PER_MAP_STRIDE) + request.chunkX;
+
+        LiquidRenderer::ReserveInfo reserveInfo;
+        reserveInfo.numInstances = request.numInstances;
+        reserveInfo.numVertices = request.numVertices;
+        reserveInfo.numIndices = request.numIndices;
 
-    // Have LiquidRenderer prepare all buffers for what we need to load
-    LiquidReserveOffsets reserveOffsets;
-    _liquidRenderer->Reserve(reserveInfo, reserveOffsets);
+        LiquidReserveOffsets reserveOffsets;
+        _liquidRenderer->ReserveChunk(chunkID, reserveInfo, reserveOffsets);
 
-    std::atomic<u32> instanceOffset = reserveOffsets.instanceStartOffset;
-    std::atomic<u32> vertexOffset = reserveOffsets.vertexStartOffset;
-    std::atomic<u32> indexOffset = reserveOffsets.indexStartOffset;
+        request.instanceStartOffset = reserveOffsets.instanceStartOffset;
+        request.vertexStartOffset = reserveOffsets.vertexStartOffset;
+        request.indexStartOffset = reserveOffsets.indexStartOffset;
+    }
 
 #if 0
     for (u32 i = 0; i < numDequeued; i++)
     {
         LoadRequestInternal& request = _workingRequests[i];
-        LoadRequest(request, instanceOffset, vertexOffset, indexOffset);
+        LoadRequest(request);
     }
 #else
     enki::TaskSet loadLiquidTask(numDequeued, [&](enki::TaskSetPartition range, u32 threadNum)
@@ -65,7 +68,7 @@ void LiquidLoader::Update(f32 deltaTime)
         for (u32 i = range.start; i < range.end; i++)
         {
             LoadRequestInternal& request = _workingRequests[i];
-            LoadRequest(request, instanceOffset, vertexOffset, indexOffset);
+            LoadRequest(request);
         }
     });
     
@@ -96,10 +99,10 @@ vec2 GetCellPosition(u32 chunkID, u32 cellID)
     return vec2(cellWorldPos.x, cellWorldPos.y);
 }
 
-void LiquidLoader::LoadFromChunk(u16 chunkX, u16 chunkY, std::shared_ptr<Bytebuffer>& buffer, const Map::Chunk::LiquidHeader& liquidHeader)
+u64 LiquidLoader::LoadFromChunk(u16 chunkX, u16 chunkY, std::shared_ptr<Bytebuffer>& buffer, const Map::Chunk::LiquidHeader& liquidHeader)
 {
     if (liquidHeader.numHeaders == 0)
-        return;
+        return 0;
 
     LoadRequestInternal request;
     request.chunkX = chunkX;
@@ -144,9 +147,23 @@ void LiquidLoader::LoadFromChunk(u16 chunkX, u16 chunkY, std::shared_ptr<Bytebuf
     request.numIndices = numIndices;
 
     _requests.enqueue(request);
+
+    LiquidRenderer::ReserveInfo reserveInfo;
+    reserveInfo.numInstances = request.numInstances;
+    reserveInfo.numVertices = request.numVertices;
+    reserveInfo.numIndices = request.numIndices;
+
+    return LiquidRenderer::GetGPUBytes(reserveInfo);
+}
+
+void LiquidLoader::UnloadChunk(u32 chunkID)
+{
+    // Chunks are evicted by TerrainLoader::Update, which runs before Update in the same frame and never while our load
+    // tasks are running, so the liquid of an evicted chunk has always been reserved already
+    _liquidRenderer->UnloadChunk(chunkID);
 }
 
-void LiquidLoader::LoadRequest(LoadRequestInternal& request, std::atomic<u32>& instanceOffset, std::atomic<u32>& vertexOffset, std::atomic<u32>& indexOffset)
+void LiquidLoader::LoadRequest(LoadRequestInternal& request)
 {
     u32 chunkID = (request.chunkY * Terrain::CHUNK_NUM_PER_MAP_STRIDE) + request.chunkX;
 
@@ -154,7 +171,9 @@ void LiquidLoader::LoadRequest(LoadRequestInternal& request, std::atomic<u32>& i
     if (numTotalInstances == 0)
         return;
 
-    u32 instanceStartIndex = instanceOffset.fetch_add(numTotalInstances);
+    u32 instanceStartIndex = request.instanceStartOffset;
+    u32 vertexOffset = request.vertexStartOffset;
+    u32 indexOffset = request.indexStartOffset;
 
     u32 instanceIndex = 0;
     for (u32 i = 0; i < request.liquidHeader.numHeaders; i++)
@@ -178,6 +197,10 @@ void LiquidLoader::LoadRequest(LoadRequestInternal& request, std::atomic<u32>& i
             u8 width = liquidInstance->packedSize & 0xF;
             u8 height = liquidInstance->packedSize >> 4;
 
+            // LoadFromChunk did not reserve anything for empty instances
+            if (width == 0 || height == 0)
+                continue;
+
             u32 vertexCount = (width + 1) * (height + 1);
             u32 bitMapBytes = (width * height + 7) / 8;
 
@@ -231,10 +254,12 @@ void LiquidLoader::LoadRequest(LoadRequestInternal& request, std::atomic<u32>& i
             desc.bitMap = bitMap;
 
             desc.vertexCount = (width + 1) * (height + 1);
-            desc.vertexOffset = vertexOffset.fetch_add(desc.vertexCount);
+            desc.vertexOffset = vertexOffset;
+            vertexOffset += desc.vertexCount;
 
             desc.indexCount = width * height * 6;
-            desc.indexOffset = indexOffset.fetch_add(desc.indexCount);
+            desc.indexOffset = indexOffset;
+            indexOffset += desc.indexCount;
 
             desc.instanceOffset = instanceStartIndex + j;
 
@@ -29,6 +29,10 @@ private:
         u32 numVertices;
         u32 numIndices;
 
+        u32 instanceStartOffset;
+        u32 vertexStartOffset;
+        u32 indexStartOffset;
+
         Map::Chunk::LiquidHeader liquidHeader;
         std::shared_ptr<Bytebuffer> buffer;
     };
@@ -40,10 +44,12 @@ public:
     void Clear();
     void Update(f32 deltaTime);
 
-    void LoadFromChunk(u16 chunkX, u16 chunkY, std::shared_ptr<Bytebuffer>& buffer, const Map::Chunk::LiquidHeader& liquidHeader);
+    // Returns how many bytes the liquid of the chunk will occupy on the GPU once loaded
+    u64 LoadFromChunk(u16 chunkX, u16 chunkY, std::shared_ptr<Bytebuffer>& buffer, const Map::Chunk::LiquidHeader& liquidHeader);
+    void UnloadChunk(u32 chunkID);
 
 private:
-    void LoadRequest(LoadRequestInternal& request, std::atomic<u32>& instanceOffset, std::atomic<u32>& vertexOffset, std::atomic<u32>& indexOffset);
+    void LoadRequest(LoadRequestInternal& request);
 
 private:
     LiquidRenderer* _liquidRenderer = nullptr;
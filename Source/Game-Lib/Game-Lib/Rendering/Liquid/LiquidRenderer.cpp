@@ -81,27 +81,94 @@ void LiquidRenderer::Clear()
 
     _vertices.Clear();
     _indices.Clear();
+
+    _chunkIDToAllocation.clear();
+    _freeInstances.Clear();
+    _freeVertices.Clear();
+    _freeIndices.Clear();
 }
 
-void LiquidRenderer::Reserve(const ReserveInfo& info, LiquidReserveOffsets& reserveOffsets)
+void LiquidRenderer::ReserveChunk(u32 chunkID, const ReserveInfo& info, LiquidReserveOffsets& reserveOffsets)
 {
-    u32 cullingResourcesStartIndex = _cullingResources.AddCount(info.numInstances);
-    u32 cullingDatasStartIndex = _cullingDatas.AddCount(info.numInstances);
+    if (_chunkIDToAllocation.contains(chunkID))
+        UnloadChunk(chunkID);
 
-#if NC_DEBUG
-    if (cullingResourcesStartIndex != cullingDatasStartIndex)
+    std::unique_lock lock(_addLiquidMutex);
+
+    if (_freeInstances.Allocate(info.numInstances, reserveOffsets.instanceStartOffset))
     {
-        NC_LOG_ERROR("LiquidRenderer::Reserve: Culling resources start index %u does not match culling data start index %u, this will probably result in weird liquid", cullingResourcesStartIndex, cullingDatasStartIndex);
+        _cullingResources.SetDirtyElements(reserveOffsets.instanceStartOffset, info.numInstances);
+        _cullingDatas.SetDirtyElements(reserveOffsets.instanceStartOffset, info.numInstances);
     }
+    else
+    {
+        u32 cullingResourcesStartIndex = _cullingResources.AddCount(info.numInstances);
+        u32 cullingDatasStartIndex = _cullingDatas.AddCount(info.numInstances);
+
+#if NC_DEBUG
+        if (cullingResourcesStartIndex != cullingDatasStartIndex)
+        {
+            NC_LOG_ERROR("LiquidRenderer::ReserveChunk: Culling resources start index %u does not match culling data start index %u, this will probably result in weird liquid", cullingResourcesStartIndex, cullingDatasStartIndex);
+        }
 #endif
 
-    reserveOffsets.instanceStartOffset = cullingResourcesStartIndex;
-    reserveOffsets.vertexStartOffset = _vertices.AddCount(info.numVertices);
-    reserveOffsets.indexStartOffset = _indices.AddCount(info.numIndices);
+        reserveOffsets.instanceStartOffset = cullingResourcesStartIndex;
+    }
+
+    if (_freeVertices.Allocate(info.numVertices, reserveOffsets.vertexStartOffset))
+        _vertices.SetDirtyElements(reserveOffsets.vertexStartOffset, info.numVertices);
+    else
+        reserveOffsets.vertexStartOffset = _vertices.AddCount(info.numVertices);
+
+    if (_freeIndices.Allocate(info.numIndices, reserveOffsets.indexStartOffset))
+        _indices.SetDirtyElements(reserveOffsets.indexStartOffset, info.numIndices);
+    else
+        reserveOffsets.indexStartOffset = _indices.AddCount(info.numIndices);
+
+    ChunkAllocation& allocation = _chunkIDToAllocation[chunkID];
+    allocation.info = info;
+    allocation.offsets = reserveOffsets;
+
+    _instancesIsDirty = true;
+}
+
+void LiquidRenderer::UnloadChunk(u32 chunkID)
+{
+    auto itr = _chunkIDToAllocation.find(chunkID);
+    if (itr == _chunkIDToAllocation.end())
+        return;
+
+    std::unique_lock lock(_addLiquidMutex);
+
+    const ChunkAllocation& allocation = itr->second;
+    const u32 instanceStartOffset = allocation.offsets.instanceStartOffset;
+    const u32 numInstances = allocation.info.numInstances;
+
+    // Vertices and indices are only read through the draw calls, so zeroing those is enough to hide the chunk
+    const Renderer::GPUVector<Renderer::IndexedIndirectDraw>& drawCalls = _cullingResources.GetDrawCalls();
+    for (u32 i = instanceStartOffset; i < instanceStartOffset + numInstances; i++)
+    {
+        drawCalls[i] = { };
+        _cullingDatas[i] = { };
+    }
+
+    _cullingResources.SetDirtyElements(instanceStartOffset, numInstances);
+    _cullingDatas.SetDirtyElements(instanceStartOffset, numInstances);
 
+    _freeInstances.Free(instanceStartOffset, numInstances);
+    _freeVertices.Free(allocation.offsets.vertexStartOffset, allocation.info.numVertices);
+    _freeIndices.Free(allocation.offsets.indexStartOffset, allocation.info.numIndices);
+
+    _chunkIDToAllocation.erase(itr);
     _instancesIsDirty = true;
 }
 
+u64 LiquidRenderer::GetGPUBytes(const ReserveInfo& info)
+{
+    const u64 instanceBytes = sizeof(Renderer::IndexedIndirectDraw) + sizeof(DrawCallData) + sizeof(Model::ComplexModel::CullingData);
+    return (info.numInstances * instanceBytes) + (info.numVertices * sizeof(Vertex)) + (info.numIndices * sizeof(u16));
+}
+
 void LiquidRenderer::Load(LoadDesc& desc)
 {
     if (desc.width == 0 || desc.height == 0)
@@ -116,6 +183,7 @@ void LiquidRenderer::Load(LoadDesc& desc)
     const Renderer::GPUVector<DrawCallData>& drawCallDatas = _cullingResources.GetDrawCallDatas();
 
     Renderer::IndexedIndirectDraw& drawCall = drawCalls[desc.instanceOffset];
+    drawCall.indexCount = 0;
     drawCall.instanceCount = 1;
     drawCall.vertexOffset = desc.vertexOffset;
     drawCall.firstIndex = desc.indexOffset;
@@ -1,5 +1,6 @@
 #pragma once
 #include <Game-Lib/Rendering/CulledRenderer.h>
+#include <Game-Lib/Util/RangeAllocator.h>
 
 #include <Base/Types.h>
 
@@ -72,6 +73,13 @@ private:
         u32 numFramesForTexture = 0;
     };
 
+    struct ChunkAllocation
+    {
+    public:
+        ReserveInfo info;
+        LiquidReserveOffsets offsets;
+    };
+
 public:
     LiquidRenderer(Renderer::Renderer* renderer, GameRenderer* gameRenderer, DebugRenderer* debugRenderer);
     ~LiquidRenderer();
@@ -79,7 +87,12 @@ public:
     void Update(f32 deltaTime);
     void Clear();
 
-    void Reserve(const ReserveInfo& info, LiquidReserveOffsets& reserveOffsets);
+    // Reuses ranges an unloaded chunk gave back when they fit, the buffers only grow when none does
+    void ReserveChunk(u32 chunkID, const ReserveInfo& info, LiquidReserveOffsets& reserveOffsets);
+    // Hides the instances of the chunk and frees its ranges for the next chunk that gets reserved
+    void UnloadChunk(u32 chunkID);
+
+    static u64 GetGPUBytes(const ReserveInfo& info);
 
     struct LoadDesc
     {
@@ -151,6 +164,11 @@ private:
 
     robin_hood::unordered_map<u32, LiquidTextureMap> _liquidTypeIDToLiquidTextureMap;
 
+    robin_hood::unordered_map<u32, ChunkAllocation> _chunkIDToAllocation;
+    Util::RangeAllocator _freeInstances;
+    Util::RangeAllocator _freeVertices;
+    Util::RangeAllocator _freeIndices;
+
     std::atomic_bool _instancesIsDirty = false;
     std::shared_mutex _addLiquidMutex; // Unique lock for operations that can reallocate, shared_lock if it only reads/modifies existing data
     std::mutex _textureMutex;
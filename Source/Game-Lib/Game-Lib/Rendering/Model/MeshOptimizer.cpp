@@ -0,0 +1,848 @@
+#include "MeshOptimizer.h"
+
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace MeshOptimizer
+{
+    namespace
+    {
+        // Forsyth's scoring, the simulated cache is larger than VERTEX_CACHE_SIZE so triangles keep getting pulled back in
+        constexpr u32 SCORING_CACHE_SIZE = 32;
+        constexpr f32 CACHE_DECAY_POWER = 1.5f;
+        constexpr f32 LAST_TRIANGLE_SCORE = 0.75f;
+        constexpr f32 VALENCE_BOOST_SCALE = 2.0f;
+        constexpr f32 VALENCE_BOOST_POWER = 0.5f;
+
+        constexpr u32 INVALID_TRIANGLE = 0xFFFFFFFF;
+
+        f32 GetVertexScore(i32 cachePosition, u32 numLiveTriangles)
+        {
+            if (numLiveTriangles == 0)
+                return -1.0f;
+
+            f32 score = 0.0f;
+            if (cachePosition >= 0)
+            {
+                // The vertices of the last triangle get a fixed score so the next one doesn't just reuse its edge
+                if (cachePosition < 3)
+                {
+                    score = LAST_TRIANGLE_SCORE;
+                }
+                else
+                {
+                    f32 scale = 1.0f / static_cast<f32>(SCORING_CACHE_SIZE - 3);
+                    score = std::pow(1.0f - static_cast<f32>(cachePosition - 3) * scale, CACHE_DECAY_POWER);
+                }
+            }
+
+            // Vertices with few triangles left get finished off before they fall out of the cache
+            score += VALENCE_BOOST_SCALE * std::pow(static_cast<f32>(numLiveTriangles), -VALENCE_BOOST_POWER);
+            return score;
+        }
+
+        // FIFO cache by timestamps, a vertex is in the cache while fewer than cacheSize vertices were added after it
+        u32 UpdateCache(const u16* triangle, u32 cacheSize, std::vector<u32>& timestamps, u32& timestamp)
+        {
+            u32 numMisses = 0;
+            for (u32 i = 0; i < 3; i++)
+            {
+                u32 vertex = triangle[i];
+                if (timestamp - timestamps[vertex] > cacheSize)
+                {
+                    timestamps[vertex] = timestamp++;
+                    numMisses++;
+                }
+            }
+
+            return numMisses;
+        }
+
+        // Sum of squared distances to a set of planes, symmetric 4x4 matrix. Doubles since positions far from the origin cancel
+        // out badly when evaluated in floats
+        struct Quadric
+        {
+        public:
+            f64 a00 = 0.0, a11 = 0.0, a22 = 0.0;
+            f64 a01 = 0.0, a02 = 0.0, a12 = 0.0;
+            f64 b0 = 0.0, b1 = 0.0, b2 = 0.0;
+            f64 c = 0.0;
+        };
+
+        void AddPlaneQuadric(Quadric& quadric, const vec3& normal, f32 distance)
+        {
+            f64 x = normal.x;
+            f64 y = normal.y;
+            f64 z = normal.z;
+            f64 d = distance;
+
+            quadric.a00 += x * x;
+            quadric.a11 += y * y;
+            quadric.a22 += z * z;
+            quadric.a01 += x * y;
+            quadric.a02 += x * z;
+            quadric.a12 += y * z;
+            quadric.b0 += x * d;
+            quadric.b1 += y * d;
+            quadric.b2 += z * d;
+            quadric.c += d * d;
+        }
+
+        void AddQuadric(Quadric& quadric, const Quadric& other)
+        {
+            quadric.a00 += other.a00;
+            quadric.a11 += other.a11;
+            quadric.a22 += other.a22;
+            quadric.a01 += other.a01;
+            quadric.a02 += other.a02;
+            quadric.a12 += other.a12;
+            quadric.b0 += other.b0;
+            quadric.b1 += other.b1;
+            quadric.b2 += other.b2;
+            quadric.c += other.c;
+        }
+
+        f32 EvaluateQuadric(const Quadric& quadric, const vec3& position)
+        {
+            f64 x = position.x;
+            f64 y = position.y;
+            f64 z = position.z;
+
+            f64 error = quadric.a00 * x * x + quadric.a11 * y * y + quadric.a22 * z * z;
+            error += 2.0 * (quadric.a01 * x * y + quadric.a02 * x * z + quadric.a12 * y * z);
+            error += 2.0 * (quadric.b0 * x + quadric.b1 * y + quadric.b2 * z);
+            error += quadric.c;
+
+            return static_cast<f32>(std::max(error, 0.0));
+        }
+
+        struct EdgeCollapse
+        {
+        public:
+            u32 vertex = 0;
+            u32 target = 0;
+            f32 error = 0.0f;
+        };
+
+        // Moving vertex onto target must not turn any of its other triangles over or into slivers
+        bool IsCollapseValid(const u16* indices, const u32* vertexTriangles, u32 numVertexTriangles, const vec3* positions, u32 vertex, u32 target)
+        {
+            // cos(75 degrees), how far a triangle may turn
+            constexpr f32 MIN_NORMAL_DOT = 0.25f;
+
+            for (u32 i = 0; i < numVertexTriangles; i++)
+            {
+                const u16* triangle = &indices[vertexTriangles[i] * 3];
+                if (triangle[0] == target || triangle[1] == target || triangle[2] == target)
+                    continue;
+
+                vec3 corners[3] = { positions[triangle[0]], positions[triangle[1]], positions[triangle[2]] };
+                vec3 normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    if (triangle[corner] == vertex)
+                        corners[corner] = positions[target];
+                }
+                vec3 newNormal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+
+                f32 normalLengths = glm::length(normal) * glm::length(newNormal);
+                if (normalLengths > 0.0f && glm::dot(normal, newNormal) < MIN_NORMAL_DOT * normalLengths)
+                    return false;
+
+                if (normalLengths <= 0.0f && glm::length(normal) > 0.0f)
+                    return false;
+            }
+
+            return true;
+        }
+
+        // Normal cones with their widest normal this close to perpendicular to the axis can't cull anything worth testing
+        constexpr f32 MESHLET_MIN_CONE_DOT = 0.1f;
+
+        // normals is scratch space reused between the meshlets of a mesh
+        void ComputeMeshletBounds(const u16* indices, const vec3* positions, Meshlet& meshlet, std::vector<vec3>& normals)
+        {
+            const u16* meshletIndices = &indices[meshlet.firstIndex];
+
+            vec3 min = positions[meshletIndices[0]];
+            vec3 max = min;
+            for (u32 i = 1; i < meshlet.indexCount; i++)
+            {
+                min = glm::min(min, positions[meshletIndices[i]]);
+                max = glm::max(max, positions[meshletIndices[i]]);
+            }
+
+            meshlet.center = (min + max) * 0.5f;
+
+            f32 radiusSquared = 0.0f;
+            for (u32 i = 0; i < meshlet.indexCount; i++)
+            {
+                vec3 offset = positions[meshletIndices[i]] - meshlet.center;
+                radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+            }
+            meshlet.radius = std::sqrt(radiusSquared);
+
+            // Degenerate triangles have no facing and are left out of the cone
+            normals.clear();
+
+            vec3 normalSum = vec3(0.0f);
+            for (u32 i = 0; i < meshlet.indexCount; i += 3)
+            {
+                const vec3& p0 = positions[meshletIndices[i + 0]];
+                const vec3& p1 = positions[meshletIndices[i + 1]];
+                const vec3& p2 = positions[meshletIndices[i + 2]];
+
+                vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                f32 length = glm::length(normal);
+                if (length <= 0.0f)
+                    continue;
+
+                normal /= length;
+                normals.push_back(normal);
+                normalSum += normal;
+            }
+
+            meshlet.coneAxis = vec3(0.0f, 0.0f, 1.0f);
+            meshlet.coneCutoff = 1.0f;
+
+            f32 normalSumLength = glm::length(normalSum);
+            if (normals.empty() || normalSumLength <= 0.0f)
+                return;
+
+            vec3 axis = normalSum / normalSumLength;
+
+            f32 minDot = 1.0f;
+            for (const vec3& normal : normals)
+            {
+                minDot = std::min(minDot, glm::dot(axis, normal));
+            }
+
+            meshlet.coneAxis = axis;
+            if (minDot <= MESHLET_MIN_CONE_DOT)
+                return;
+
+            // The cone around the axis containing every normal has a half angle of acos(minDot), the cutoff is its sine
+            meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+    }
+
+    f32 ComputeACMR(const u16* indices, size_t numIndices, u32 numVertices, u32 cacheSize)
+    {
+        const size_t numTriangles = numIndices / 3;
+        if (numTriangles == 0)
+            return 0.0f;
+
+        std::vector<u32> timestamps(numVertices, 0);
+        u32 timestamp = cacheSize + 1;
+
+        u32 numMisses = 0;
+        for (size_t triangle = 0; triangle < numTriangles; triangle++)
+        {
+            numMisses += UpdateCache(&indices[triangle * 3], cacheSize, timestamps, timestamp);
+        }
+
+        return static_cast<f32>(numMisses) / static_cast<f32>(numTriangles);
+    }
+
+    void OptimizeVertexCache(u16* indices, size_t numIndices, u32 numVertices)
+    {
+        ZoneScopedN("MeshOptimizer::OptimizeVertexCache");
+
+        const u32 numTriangles = static_cast<u32>(numIndices / 3);
+        if (numTriangles < 2)
+            return;
+
+        // Triangles of every vertex, the first numLiveTriangles[vertex] entries are the ones not emitted yet
+        std::vector<u32> numLiveTriangles(numVertices, 0);
+        for (size_t i = 0; i < numTriangles * 3; i++)
+        {
+            numLiveTriangles[indices[i]]++;
+        }
+
+        std::vector<u32> adjacencyOffsets(numVertices + 1, 0);
+        for (u32 vertex = 0; vertex < numVertices; vertex++)
+        {
+            adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + numLiveTriangles[vertex];
+        }
+
+        std::vector<u32> adjacency(numTriangles * 3);
+        {
+            std::vector<u32> adjacencyCursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (u32 triangle = 0; triangle < numTriangles; triangle++)
+            {
+                for (u32 i = 0; i < 3; i++)
+                {
+                    adjacency[adjacencyCursors[indices[triangle * 3 + i]]++] = triangle;
+                }
+            }
+        }
+
+        std::vector<i32> cachePositions(numVertices, -1);
+        std::vector<f32> vertexScores(numVertices);
+        for (u32 vertex = 0; vertex < numVertices; vertex++)
+        {
+            vertexScores[vertex] = GetVertexScore(-1, numLiveTriangles[vertex]);
+        }
+
+        std::vector<f32> triangleScores(numTriangles);
+        std::vector<bool> isEmitted(numTriangles, false);
+
+        u32 bestTriangle = 0;
+        for (u32 triangle = 0; triangle < numTriangles; triangle++)
+        {
+            const u16* vertices = &indices[triangle * 3];
+            triangleScores[triangle] = vertexScores[vertices[0]] + vertexScores[vertices[1]] + vertexScores[vertices[2]];
+
+            if (triangleScores[triangle] > triangleScores[bestTriangle])
+                bestTriangle = triangle;
+        }
+
+        std::vector<u16> output;
+        output.reserve(numTriangles * 3);
+
+        u32 cache[SCORING_CACHE_SIZE + 3];
+        u32 cacheSize = 0;
+        u32 inputCursor = 0;
+
+        for (u32 numEmitted = 0; numEmitted < numTriangles; numEmitted++)
+        {
+            // Nothing in the cache has triangles left, continue with the next one in input order
+            if (bestTriangle == INVALID_TRIANGLE)
+            {
+                while (isEmitted[inputCursor])
+                    inputCursor++;
+
+                bestTriangle = inputCursor;
+            }
+
+            const u16* triangleVertices = &indices[bestTriangle * 3];
+            output.insert(output.end(), triangleVertices, triangleVertices + 3);
+            isEmitted[bestTriangle] = true;
+
+            u32 newCache[SCORING_CACHE_SIZE + 3];
+            u32 newCacheSize = 0;
+
+            for (u32 i = 0; i < 3; i++)
+            {
+                u32 vertex = triangleVertices[i];
+
+                u32* liveTriangles = &adjacency[adjacencyOffsets[vertex]];
+                u32* liveTrianglesEnd = liveTriangles + numLiveTriangles[vertex];
+                u32* emittedTriangle = std::find(liveTriangles, liveTrianglesEnd, bestTriangle);
+                std::swap(*emittedTriangle, *(liveTrianglesEnd - 1));
+                numLiveTriangles[vertex]--;
+
+                // Degenerate triangles list a vertex more than once
+                if (std::find(newCache, newCache + newCacheSize, vertex) == newCache + newCacheSize)
+                    newCache[newCacheSize++] = vertex;
+            }
+
+            for (u32 i = 0; i < cacheSize; i++)
+            {
+                u32 vertex = cache[i];
+                if (std::find(newCache, newCache + newCacheSize, vertex) == newCache + newCacheSize)
+                    newCache[newCacheSize++] = vertex;
+            }
+
+            // Vertices pushed past the end fell out of the cache, they need their score updated too
+            for (u32 i = 0; i < newCacheSize; i++)
+            {
+                u32 vertex = newCache[i];
+                cachePositions[vertex] = i < SCORING_CACHE_SIZE ? static_cast<i32>(i) : -1;
+                vertexScores[vertex] = GetVertexScore(cachePositions[vertex], numLiveTriangles[vertex]);
+            }
+
+            cacheSize = std::min(newCacheSize, SCORING_CACHE_SIZE);
+            std::copy(newCache, newCache + cacheSize, cache);
+
+            bestTriangle = INVALID_TRIANGLE;
+            f32 bestScore = -1.0f;
+
+            for (u32 i = 0; i < newCacheSize; i++)
+            {
+                u32 vertex = newCache[i];
+                const u32* liveTriangles = &adjacency[adjacencyOffsets[vertex]];
+
+                for (u32 j = 0; j < numLiveTriangles[vertex]; j++)
+                {
+                    u32 triangle = liveTriangles[j];
+                    const u16* vertices = &indices[triangle * 3];
+
+                    f32 score = vertexScores[vertices[0]] + vertexScores[vertices[1]] + vertexScores[vertices[2]];
+                    triangleScores[triangle] = score;
+
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        bestTriangle = triangle;
+                    }
+                }
+            }
+        }
+
+        std::copy(output.begin(), output.end(), indices);
+    }
+
+    void OptimizeOverdraw(u16* indices, size_t numIndices, const vec3* positions, u32 numVertices, f32 threshold)
+    {
+        ZoneScopedN("MeshOptimizer::OptimizeOverdraw");
+
+        const u32 numTriangles = static_cast<u32>(numIndices / 3);
+        if (numTriangles < 2)
+            return;
+
+        std::vector<u32> timestamps(numVertices, 0);
+        u32 timestamp = VERTEX_CACHE_SIZE + 1;
+
+        // A triangle missing all three vertices usually starts a patch that is disjoint from the previous triangles
+        std::vector<u32> hardBoundaries;
+        for (u32 triangle = 0; triangle < numTriangles; triangle++)
+        {
+            u32 numMisses = UpdateCache(&indices[triangle * 3], VERTEX_CACHE_SIZE, timestamps, timestamp);
+            if (triangle == 0 || numMisses == 3)
+                hardBoundaries.push_back(triangle);
+        }
+
+        // Patches get split further wherever their ACMR so far is already within threshold of the whole patch's, cutting
+        // there costs at most that much of the vertex cache efficiency
+        std::vector<u32> clusters;
+        for (size_t i = 0; i < hardBoundaries.size(); i++)
+        {
+            u32 start = hardBoundaries[i];
+            u32 end = i + 1 < hardBoundaries.size() ? hardBoundaries[i + 1] : numTriangles;
+
+            timestamp += VERTEX_CACHE_SIZE + 1;
+            u32 numPatchMisses = 0;
+            for (u32 triangle = start; triangle < end; triangle++)
+            {
+                numPatchMisses += UpdateCache(&indices[triangle * 3], VERTEX_CACHE_SIZE, timestamps, timestamp);
+            }
+
+            f32 patchThreshold = threshold * static_cast<f32>(numPatchMisses) / static_cast<f32>(end - start);
+
+            clusters.push_back(start);
+            timestamp += VERTEX_CACHE_SIZE + 1;
+
+            u32 numRunningMisses = 0;
+            u32 numRunningTriangles = 0;
+            for (u32 triangle = start; triangle < end; triangle++)
+            {
+                numRunningMisses += UpdateCache(&indices[triangle * 3], VERTEX_CACHE_SIZE, timestamps, timestamp);
+                numRunningTriangles++;
+
+                if (triangle + 1 < end && static_cast<f32>(numRunningMisses) / static_cast<f32>(numRunningTriangles) <= patchThreshold)
+                {
+                    clusters.push_back(triangle + 1);
+                    timestamp += VERTEX_CACHE_SIZE + 1;
+
+                    numRunningMisses = 0;
+                    numRunningTriangles = 0;
+                }
+            }
+        }
+
+        if (clusters.size() < 2)
+            return;
+
+        vec3 meshCentroid = vec3(0.0f);
+        for (size_t i = 0; i < numTriangles * 3; i++)
+        {
+            meshCentroid += positions[indices[i]];
+        }
+        meshCentroid /= static_cast<f32>(numTriangles * 3);
+
+        // Clusters facing away from the center are the outside of the mesh, drawing those first lets depth testing reject
+        // the ones behind them
+        std::vector<f32> sortKeys(clusters.size());
+        for (size_t i = 0; i < clusters.size(); i++)
+        {
+            u32 start = clusters[i];
+            u32 end = i + 1 < clusters.size() ? clusters[i + 1] : numTriangles;
+
+            vec3 centroid = vec3(0.0f);
+            vec3 normal = vec3(0.0f);
+            f32 area = 0.0f;
+
+            for (u32 triangle = start; triangle < end; triangle++)
+            {
+                const vec3& p0 = positions[indices[triangle * 3 + 0]];
+                const vec3& p1 = positions[indices[triangle * 3 + 1]];
+                const vec3& p2 = positions[indices[triangle * 3 + 2]];
+
+                vec3 triangleNormal = glm::cross(p1 - p0, p2 - p0);
+                f32 triangleArea = glm::length(triangleNormal);
+
+                centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+                normal += triangleNormal;
+                area += triangleArea;
+            }
+
+            if (area > 0.0f)
+                centroid /= area;
+
+            f32 normalLength = glm::length(normal);
+            if (normalLength > 0.0f)
+                normal /= normalLength;
+
+            sortKeys[i] = glm::dot(centroid - meshCentroid, normal);
+        }
+
+        std::vector<u32> clusterOrder(clusters.size());
+        for (u32 i = 0; i < clusterOrder.size(); i++)
+        {
+            clusterOrder[i] = i;
+        }
+
+        std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&sortKeys](u32 a, u32 b)
+        {
+            return sortKeys[a] > sortKeys[b];
+        });
+
+        std::vector<u16> output;
+        output.reserve(numTriangles * 3);
+
+        for (u32 cluster : clusterOrder)
+        {
+            u32 start = clusters[cluster];
+            u32 end = cluster + 1 < clusters.size() ? clusters[cluster + 1] : numTriangles;
+
+            output.insert(output.end(), &indices[start * 3], &indices[end * 3]);
+        }
+
+        std::copy(output.begin(), output.end(), indices);
+    }
+
+    u32 AppendVertexFetchRemap(const u16* indices, size_t numIndices, u32* remap, u32 numRemapped)
+    {
+        for (size_t i = 0; i < numIndices; i++)
+        {
+            u32& newVertex = remap[indices[i]];
+            if (newVertex == INVALID_VERTEX)
+                newVertex = numRemapped++;
+        }
+
+        return numRemapped;
+    }
+
+    size_t Simplify(u16* destination, const u16* indices, size_t numIndices, const vec3* positions, u32 numVertices, size_t targetIndexCount, f32 targetError, f32* resultError)
+    {
+        ZoneScopedN("MeshOptimizer::Simplify");
+
+        std::vector<u16> result(indices, indices + (numIndices / 3) * 3);
+        f32 maxError = 0.0f;
+
+        std::vector<u8> isReferenced(numVertices, 0);
+        for (u16 index : result)
+        {
+            isReferenced[index] = 1;
+        }
+
+        // Vertices sharing a position are welded for finding borders, they are split by a UV or normal seam
+        std::vector<u32> sortedVertices;
+        sortedVertices.reserve(numVertices);
+        for (u32 vertex = 0; vertex < numVertices; vertex++)
+        {
+            if (isReferenced[vertex])
+                sortedVertices.push_back(vertex);
+        }
+
+        std::sort(sortedVertices.begin(), sortedVertices.end(), [positions](u32 a, u32 b)
+        {
+            const vec3& positionA = positions[a];
+            const vec3& positionB = positions[b];
+            if (positionA.x != positionB.x)
+                return positionA.x < positionB.x;
+            if (positionA.y != positionB.y)
+                return positionA.y < positionB.y;
+            if (positionA.z != positionB.z)
+                return positionA.z < positionB.z;
+            return a < b;
+        });
+
+        std::vector<u32> weldedVertices(numVertices, INVALID_VERTEX);
+        std::vector<u8> isLocked(numVertices, 0);
+        for (size_t i = 0; i < sortedVertices.size();)
+        {
+            size_t groupEnd = i + 1;
+            while (groupEnd < sortedVertices.size() && positions[sortedVertices[groupEnd]] == positions[sortedVertices[i]])
+                groupEnd++;
+
+            for (size_t j = i; j < groupEnd; j++)
+            {
+                weldedVertices[sortedVertices[j]] = sortedVertices[i];
+                isLocked[sortedVertices[j]] = groupEnd - i > 1;
+            }
+
+            i = groupEnd;
+        }
+
+        // Welded edges used by anything but exactly two triangles are open borders or non manifold
+        {
+            std::vector<u64> edges;
+            edges.reserve(result.size());
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    u32 a = weldedVertices[result[i + corner]];
+                    u32 b = weldedVertices[result[i + (corner + 1) % 3]];
+                    if (a != b)
+                        edges.push_back((static_cast<u64>(std::min(a, b)) << 32) | std::max(a, b));
+                }
+            }
+
+            std::sort(edges.begin(), edges.end());
+            for (size_t i = 0; i < edges.size();)
+            {
+                size_t edgeEnd = i + 1;
+                while (edgeEnd < edges.size() && edges[edgeEnd] == edges[i])
+                    edgeEnd++;
+
+                if (edgeEnd - i != 2)
+                {
+                    isLocked[static_cast<u32>(edges[i] >> 32)] = 1;
+                    isLocked[static_cast<u32>(edges[i] & 0xFFFFFFFF)] = 1;
+                }
+
+                i = edgeEnd;
+            }
+
+            // Borders are found on the welded vertices, the locks have to reach every vertex at their position
+            for (u32 vertex = 0; vertex < numVertices; vertex++)
+            {
+                if (weldedVertices[vertex] != INVALID_VERTEX)
+                    isLocked[vertex] |= isLocked[weldedVertices[vertex]];
+            }
+        }
+
+        std::vector<Quadric> quadrics(numVertices);
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            const vec3& p0 = positions[result[i + 0]];
+            const vec3& p1 = positions[result[i + 1]];
+            const vec3& p2 = positions[result[i + 2]];
+
+            vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            f32 length = glm::length(normal);
+            if (length <= 0.0f)
+                continue;
+
+            normal /= length;
+            f32 distance = -glm::dot(normal, p0);
+            for (u32 corner = 0; corner < 3; corner++)
+            {
+                AddPlaneQuadric(quadrics[result[i + corner]], normal, distance);
+            }
+        }
+
+        const f32 maxCollapseError = targetError * targetError;
+
+        std::vector<u32> vertexTriangleOffsets;
+        std::vector<u32> vertexTriangles;
+        std::vector<EdgeCollapse> collapses;
+        std::vector<u32> collapseTargets(numVertices, INVALID_VERTEX);
+        std::vector<u8> isTouched(numVertices, 0);
+
+        size_t targetTriangles = targetIndexCount / 3;
+        while (result.size() / 3 > targetTriangles)
+        {
+            size_t numTriangles = result.size() / 3;
+
+            // Triangles around each vertex
+            vertexTriangleOffsets.assign(numVertices + 1, 0);
+            for (u16 index : result)
+            {
+                vertexTriangleOffsets[index + 1]++;
+            }
+            for (u32 vertex = 0; vertex < numVertices; vertex++)
+            {
+                vertexTriangleOffsets[vertex + 1] += vertexTriangleOffsets[vertex];
+            }
+
+            vertexTriangles.resize(result.size());
+            {
+                std::vector<u32> fillOffsets(vertexTriangleOffsets.begin(), vertexTriangleOffsets.end() - 1);
+                for (size_t i = 0; i < result.size(); i++)
+                {
+                    vertexTriangles[fillOffsets[result[i]]++] = static_cast<u32>(i / 3);
+                }
+            }
+
+            // The cheaper direction of every edge that has a movable vertex
+            collapses.clear();
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    u32 a = result[i + corner];
+                    u32 b = result[i + (corner + 1) % 3];
+
+                    EdgeCollapse collapse;
+                    collapse.error = std::numeric_limits<f32>::max();
+
+                    if (!isLocked[a])
+                    {
+                        Quadric quadric = quadrics[a];
+                        AddQuadric(quadric, quadrics[b]);
+                        collapse = { a, b, EvaluateQuadric(quadric, positions[b]) };
+                    }
+
+                    if (!isLocked[b])
+                    {
+                        Quadric quadric = quadrics[b];
+                        AddQuadric(quadric, quadrics[a]);
+
+                        f32 error = EvaluateQuadric(quadric, positions[a]);
+                        if (error < collapse.error)
+                            collapse = { b, a, error };
+                    }
+
+                    if (collapse.error <= maxCollapseError)
+                        collapses.push_back(collapse);
+                }
+            }
+
+            if (collapses.empty())
+                break;
+
+            std::stable_sort(collapses.begin(), collapses.end(), [](const EdgeCollapse& a, const EdgeCollapse& b) { return a.error < b.error; });
+
+            // Every collapse removes up to two triangles, the triangles around a collapse stay untouched for the rest of the pass
+            // so the flip checks see their current positions
+            size_t maxCollapses = std::max<size_t>((numTriangles - targetTriangles + 1) / 2, 1);
+            size_t numCollapses = 0;
+
+            std::fill(isTouched.begin(), isTouched.end(), 0);
+            for (const EdgeCollapse& collapse : collapses)
+            {
+                if (numCollapses >= maxCollapses)
+                    break;
+
+                if (isTouched[collapse.vertex] || isTouched[collapse.target])
+                    continue;
+
+                const u32* collapseVertexTriangles = &vertexTriangles[vertexTriangleOffsets[collapse.vertex]];
+                u32 numCollapseVertexTriangles = vertexTriangleOffsets[collapse.vertex + 1] - vertexTriangleOffsets[collapse.vertex];
+
+                if (!IsCollapseValid(result.data(), collapseVertexTriangles, numCollapseVertexTriangles, positions, collapse.vertex, collapse.target))
+                    continue;
+
+                for (u32 i = 0; i < numCollapseVertexTriangles; i++)
+                {
+                    const u16* triangle = &result[collapseVertexTriangles[i] * 3];
+                    isTouched[triangle[0]] = 1;
+                    isTouched[triangle[1]] = 1;
+                    isTouched[triangle[2]] = 1;
+                }
+
+                collapseTargets[collapse.vertex] = collapse.target;
+                AddQuadric(quadrics[collapse.target], quadrics[collapse.vertex]);
+                maxError = std::max(maxError, collapse.error);
+                numCollapses++;
+            }
+
+            if (numCollapses == 0)
+                break;
+
+            // Triangles that lost a corner are gone, the rest keep their order
+            size_t numResultIndices = 0;
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                u16 triangle[3];
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    u32 vertex = result[i + corner];
+                    triangle[corner] = static_cast<u16>(collapseTargets[vertex] != INVALID_VERTEX ? collapseTargets[vertex] : vertex);
+                }
+
+                if (triangle[0] == triangle[1] || triangle[0] == triangle[2] || triangle[1] == triangle[2])
+                    continue;
+
+                result[numResultIndices++] = triangle[0];
+                result[numResultIndices++] = triangle[1];
+                result[numResultIndices++] = triangle[2];
+            }
+            result.resize(numResultIndices);
+
+            std::fill(collapseTargets.begin(), collapseTargets.end(), INVALID_VERTEX);
+        }
+
+        std::copy(result.begin(), result.end(), destination);
+
+        if (resultError)
+            *resultError = std::sqrt(maxError);
+
+        return result.size();
+    }
+
+    u32 BuildMeshlets(const u16* indices, size_t numIndices, const vec3* positions, u32 numVertices, std::vector<Meshlet>& meshlets)
+    {
+        ZoneScopedN("MeshOptimizer::BuildMeshlets");
+
+        size_t numTriangles = numIndices / 3;
+        if (numTriangles == 0)
+            return 0;
+
+        size_t firstMeshlet = meshlets.size();
+        meshlets.reserve(firstMeshlet + (numTriangles + MESHLET_MAX_TRIANGLES - 1) / MESHLET_MAX_TRIANGLES);
+
+        // The meshlet a vertex was last counted in, so the unique vertices of the current one are counted once
+        std::vector<u32> vertexMeshlet(numVertices, INVALID_VERTEX);
+
+        std::vector<vec3> normals;
+        normals.reserve(MESHLET_MAX_TRIANGLES);
+
+        Meshlet meshlet;
+        u32 meshletID = 0;
+
+        auto countNewVertices = [&vertexMeshlet, &meshletID](const u16* triangleIndices)
+        {
+            u32 numNewVertices = 0;
+            for (u32 i = 0; i < 3; i++)
+            {
+                u16 vertex = triangleIndices[i];
+                bool isRepeated = (i > 0 && triangleIndices[0] == vertex) || (i > 1 && triangleIndices[1] == vertex);
+                numNewVertices += vertexMeshlet[vertex] != meshletID && !isRepeated;
+            }
+
+            return numNewVertices;
+        };
+
+        for (size_t triangle = 0; triangle < numTriangles; triangle++)
+        {
+            const u16* triangleIndices = &indices[triangle * 3];
+            u32 numNewVertices = countNewVertices(triangleIndices);
+
+            bool isFull = meshlet.indexCount / 3 + 1 > MESHLET_MAX_TRIANGLES || meshlet.numVertices + numNewVertices > MESHLET_MAX_VERTICES;
+            if (isFull)
+            {
+                ComputeMeshletBounds(indices, positions, meshlet, normals);
+                meshlets.push_back(meshlet);
+
+                meshlet = Meshlet();
+                meshlet.firstIndex = static_cast<u32>(triangle * 3);
+                meshletID++;
+
+                numNewVertices = countNewVertices(triangleIndices);
+            }
+
+            for (u32 i = 0; i < 3; i++)
+            {
+                vertexMeshlet[triangleIndices[i]] = meshletID;
+            }
+
+            meshlet.indexCount += 3;
+            meshlet.numVertices += numNewVertices;
+        }
+
+        ComputeMeshletBounds(indices, positions, meshlet, normals);
+        meshlets.push_back(meshlet);
+
+        return static_cast<u32>(meshlets.size() - firstMeshlet);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <vector>
+
+// Triangle and vertex reordering for indexed triangle lists. Everything works on one index range at a time, with indices
+// relative to the start of the vertices they draw from, like the model render batches.
+namespace MeshOptimizer
+{
+    // The post-transform cache we optimize for and measure against, smaller than most hardware has so gains carry over
+    constexpr u32 VERTEX_CACHE_SIZE = 16;
+
+    // Overdraw reordering may make the ACMR this much worse in exchange for drawing outer clusters first
+    constexpr f32 OVERDRAW_THRESHOLD = 1.05f;
+
+    constexpr u32 INVALID_VERTEX = 0xFFFFFFFF;
+
+    // Meshlet bounds, the usual limits for mesh shaders so the same clusters can be drawn by them later
+    constexpr u32 MESHLET_MAX_VERTICES = 64;
+    constexpr u32 MESHLET_MAX_TRIANGLES = 124;
+
+    // A run of consecutive triangles with its bounding sphere and normal cone, this is also the GPU layout
+    struct Meshlet
+    {
+    public:
+        vec3 center = vec3(0.0f);
+        f32 radius = 0.0f;
+
+        // Every triangle faces away from cameraPosition when
+        // dot(center - cameraPosition, coneAxis) >= coneCutoff * length(center - cameraPosition) + radius
+        // A coneCutoff of 1 means the normals are too spread out for the cone to ever cull
+        vec3 coneAxis = vec3(0.0f, 0.0f, 1.0f);
+        f32 coneCutoff = 1.0f;
+
+        u32 firstIndex = 0;
+        u32 indexCount = 0;
+        u32 vertexOffset = 0;
+        u32 numVertices = 0;
+    };
+    static_assert(sizeof(Meshlet) == 48, "Meshlets must keep their 16 byte aligned GPU layout");
+
+    // Average cache miss ratio, vertex shader invocations per triangle for a FIFO cache of cacheSize entries
+    f32 ComputeACMR(const u16* indices, size_t numIndices, u32 numVertices, u32 cacheSize = VERTEX_CACHE_SIZE);
+
+    // Reorders triangles for vertex cache hits (Forsyth), the vertices and winding of every triangle stay the same
+    void OptimizeVertexCache(u16* indices, size_t numIndices, u32 numVertices);
+
+    // Splits vertex cache optimized triangles into clusters and sorts the clusters to draw outward facing ones first
+    // (Sander et al. 2007). Expects OptimizeVertexCache to have run first
+    void OptimizeOverdraw(u16* indices, size_t numIndices, const vec3* positions, u32 numVertices, f32 threshold = OVERDRAW_THRESHOLD);
+
+    // Numbers the vertices in the order indices first reference them, remap[oldVertex] = newVertex. remap has to start out
+    // filled with INVALID_VERTEX and can be carried over several index ranges drawing from the same vertices, vertices none of
+    // them reference stay INVALID_VERTEX. Returns the new number of remapped vertices
+    u32 AppendVertexFetchRemap(const u16* indices, size_t numIndices, u32* remap, u32 numRemapped);
+
+    // Collapses edges by quadric error (Garland and Heckbert 1997) until at most targetIndexCount indices are left or every
+    // remaining collapse would move the surface further than targetError. Vertices on open borders and on UV seams, vertices
+    // sharing their position with another one, never move so outlines and texture mapping hold there. The remaining triangles
+    // are written to destination in their original order, returns their index count. resultError gets the furthest the surface
+    // moved in the units of positions
+    size_t Simplify(u16* destination, const u16* indices, size_t numIndices, const vec3* positions, u32 numVertices, size_t targetIndexCount, f32 targetError, f32* resultError = nullptr);
+
+    // Cuts the triangles into consecutive runs of at most MESHLET_MAX_VERTICES unique vertices and MESHLET_MAX_TRIANGLES
+    // triangles, so every triangle ends up in exactly one meshlet and the index order stays as it is. The runs are only as
+    // tight as the triangle order, run OptimizeVertexCache first. firstIndex is relative to indices and vertexOffset is left
+    // at 0. Appends to meshlets and returns how many were added
+    u32 BuildMeshlets(const u16* indices, size_t numIndices, const vec3* positions, u32 numVertices, std::vector<Meshlet>& meshlets);
+}
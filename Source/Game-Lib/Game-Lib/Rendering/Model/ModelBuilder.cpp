@@ -1,9 +1,13 @@
 #include "ModelBuilder.h"
+#include "MeshOptimizer.h"
 
+#include <glm/gtc/packing.hpp>
 #include <tracy/Tracy.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <vector>
 
 namespace ModelLoading
 {
@@ -15,9 +19,448 @@ namespace ModelLoading
             result.error = error;
             return result;
         }
+
+        // The vertex layout is the one ModelShared.inc.slang unpacks, positions are the first three halfs
+        static_assert(sizeof(Model::ComplexModel::Vertex) == 24, "Model vertices must match PackedModelVertex");
+
+        vec3 UnpackVertexPosition(const Model::ComplexModel::Vertex& vertex)
+        {
+            u16 packedPosition[3];
+            std::memcpy(packedPosition, &vertex, sizeof(packedPosition));
+
+            return vec3(glm::unpackHalf1x16(packedPosition[0]), glm::unpackHalf1x16(packedPosition[1]), glm::unpackHalf1x16(packedPosition[2]));
+        }
+
+        // Render batches reference an index range drawing from the vertices at vertexOffset, several batches can share both
+        struct PreparedIndexRange
+        {
+        public:
+            u32 firstIndex = 0;
+            u32 indexCount = 0;
+            u32 vertexOffset = 0;
+            bool isTransparent = false;
+        };
+
+        struct PreparedVertexRange
+        {
+        public:
+            u32 vertexOffset = 0;
+            u32 numVertices = 0;
+            u32 newVertexOffset = 0;
+        };
+
+        // Reorders the triangles of every opaque index range for the vertex cache and overdraw, then packs the vertices in
+        // the order they are first drawn, merging identical ones and dropping the ones nothing draws. Transparent ranges keep
+        // their triangle order since it is their blending order. Models whose ranges partially overlap are left as they are,
+        // only identical ranges can be shared
+        void OptimizeMeshes(PreparedRenderModel& prepared)
+        {
+            ZoneScopedN("ModelBuilder::OptimizeMeshes");
+
+            std::vector<PreparedIndexRange> indexRanges;
+            indexRanges.reserve(prepared.drawCalls.size());
+
+            for (const PreparedDrawCall& drawCall : prepared.drawCalls)
+            {
+                if (drawCall.indexCount == 0)
+                    continue;
+
+                if (drawCall.indexCount % 3 != 0)
+                    return;
+
+                auto itr = std::find_if(indexRanges.begin(), indexRanges.end(), [&drawCall](const PreparedIndexRange& indexRange)
+                {
+                    return indexRange.firstIndex == drawCall.firstIndex && indexRange.indexCount == drawCall.indexCount;
+                });
+
+                if (itr == indexRanges.end())
+                {
+                    indexRanges.push_back({ drawCall.firstIndex, drawCall.indexCount, drawCall.vertexOffset, drawCall.isTransparent });
+                    continue;
+                }
+
+                if (itr->vertexOffset != drawCall.vertexOffset)
+                    return;
+
+                itr->isTransparent |= drawCall.isTransparent;
+            }
+
+            std::sort(indexRanges.begin(), indexRanges.end(), [](const PreparedIndexRange& a, const PreparedIndexRange& b) { return a.firstIndex < b.firstIndex; });
+            for (size_t i = 1; i < indexRanges.size(); i++)
+            {
+                if (indexRanges[i - 1].firstIndex + indexRanges[i - 1].indexCount > indexRanges[i].firstIndex)
+                    return;
+            }
+
+            std::vector<PreparedVertexRange> vertexRanges;
+            for (const PreparedIndexRange& indexRange : indexRanges)
+            {
+                const u16* indices = &prepared.indices[indexRange.firstIndex];
+                u32 numVertices = *std::max_element(indices, indices + indexRange.indexCount) + 1u;
+
+                if (indexRange.vertexOffset + numVertices > prepared.vertices.size())
+                    return;
+
+                auto itr = std::find_if(vertexRanges.begin(), vertexRanges.end(), [&indexRange](const PreparedVertexRange& vertexRange)
+                {
+                    return vertexRange.vertexOffset == indexRange.vertexOffset;
+                });
+
+                if (itr == vertexRanges.end())
+                    vertexRanges.push_back({ indexRange.vertexOffset, numVertices });
+                else
+                    itr->numVertices = std::max(itr->numVertices, numVertices);
+            }
+
+            std::sort(vertexRanges.begin(), vertexRanges.end(), [](const PreparedVertexRange& a, const PreparedVertexRange& b) { return a.vertexOffset < b.vertexOffset; });
+
+            bool canPackVertices = true;
+            for (size_t i = 1; i < vertexRanges.size(); i++)
+            {
+                canPackVertices &= vertexRanges[i - 1].vertexOffset + vertexRanges[i - 1].numVertices <= vertexRanges[i].vertexOffset;
+            }
+
+            std::vector<u32> vertexRemap;
+            std::vector<u32> sortedVertices;
+            std::vector<vec3> positions;
+            std::vector<u16> originalIndices;
+
+            for (const PreparedVertexRange& vertexRange : vertexRanges)
+            {
+                const Model::ComplexModel::Vertex* vertices = &prepared.vertices[vertexRange.vertexOffset];
+
+                // Identical vertices collapse into the first of them, which leaves more cache hits to find
+                sortedVertices.resize(vertexRange.numVertices);
+                for (u32 i = 0; i < vertexRange.numVertices; i++)
+                {
+                    sortedVertices[i] = i;
+                }
+
+                std::stable_sort(sortedVertices.begin(), sortedVertices.end(), [vertices](u32 a, u32 b)
+                {
+                    return std::memcmp(&vertices[a], &vertices[b], sizeof(Model::ComplexModel::Vertex)) < 0;
+                });
+
+                vertexRemap.resize(vertexRange.numVertices);
+                for (u32 i = 0; i < vertexRange.numVertices; i++)
+                {
+                    bool isDuplicate = i > 0 && std::memcmp(&vertices[sortedVertices[i - 1]], &vertices[sortedVertices[i]], sizeof(Model::ComplexModel::Vertex)) == 0;
+                    vertexRemap[sortedVertices[i]] = isDuplicate ? vertexRemap[sortedVertices[i - 1]] : sortedVertices[i];
+                }
+
+                positions.resize(vertexRange.numVertices);
+                for (u32 i = 0; i < vertexRange.numVertices; i++)
+                {
+                    positions[i] = UnpackVertexPosition(vertices[i]);
+                }
+
+                for (const PreparedIndexRange& indexRange : indexRanges)
+                {
+                    if (indexRange.vertexOffset != vertexRange.vertexOffset)
+                        continue;
+
+                    u16* indices = &prepared.indices[indexRange.firstIndex];
+                    for (u32 i = 0; i < indexRange.indexCount; i++)
+                    {
+                        indices[i] = static_cast<u16>(vertexRemap[indices[i]]);
+                    }
+
+                    if (indexRange.isTransparent)
+                        continue;
+
+                    originalIndices.assign(indices, indices + indexRange.indexCount);
+                    f32 originalACMR = MeshOptimizer::ComputeACMR(indices, indexRange.indexCount, vertexRange.numVertices);
+
+                    MeshOptimizer::OptimizeVertexCache(indices, indexRange.indexCount, vertexRange.numVertices);
+                    MeshOptimizer::OptimizeOverdraw(indices, indexRange.indexCount, positions.data(), vertexRange.numVertices);
+
+                    // Already well ordered meshes can come out slightly worse
+                    if (MeshOptimizer::ComputeACMR(indices, indexRange.indexCount, vertexRange.numVertices) > originalACMR)
+                        std::copy(originalIndices.begin(), originalIndices.end(), indices);
+                }
+            }
+
+            if (!canPackVertices)
+                return;
+
+            std::vector<Model::ComplexModel::Vertex> packedVertices;
+            packedVertices.reserve(prepared.vertices.size());
+
+            for (PreparedVertexRange& vertexRange : vertexRanges)
+            {
+                vertexRemap.assign(vertexRange.numVertices, MeshOptimizer::INVALID_VERTEX);
+
+                u32 numRemapped = 0;
+                for (const PreparedIndexRange& indexRange : indexRanges)
+                {
+                    if (indexRange.vertexOffset == vertexRange.vertexOffset)
+                        numRemapped = MeshOptimizer::AppendVertexFetchRemap(&prepared.indices[indexRange.firstIndex], indexRange.indexCount, vertexRemap.data(), numRemapped);
+                }
+
+                vertexRange.newVertexOffset = static_cast<u32>(packedVertices.size());
+                packedVertices.resize(packedVertices.size() + numRemapped);
+
+                for (u32 i = 0; i < vertexRange.numVertices; i++)
+                {
+                    if (vertexRemap[i] != MeshOptimizer::INVALID_VERTEX)
+                        packedVertices[vertexRange.newVertexOffset + vertexRemap[i]] = prepared.vertices[vertexRange.vertexOffset + i];
+                }
+
+                for (const PreparedIndexRange& indexRange : indexRanges)
+                {
+                    if (indexRange.vertexOffset != vertexRange.vertexOffset)
+                        continue;
+
+                    u16* indices = &prepared.indices[indexRange.firstIndex];
+                    for (u32 i = 0; i < indexRange.indexCount; i++)
+                    {
+                        indices[i] = static_cast<u16>(vertexRemap[indices[i]]);
+                    }
+                }
+            }
+
+            // Batches without indices draw nothing, any offset does for them
+            for (PreparedDrawCall& drawCall : prepared.drawCalls)
+            {
+                auto itr = std::find_if(vertexRanges.begin(), vertexRanges.end(), [&drawCall](const PreparedVertexRange& vertexRange)
+                {
+                    return vertexRange.vertexOffset == drawCall.vertexOffset;
+                });
+
+                drawCall.vertexOffset = itr != vertexRanges.end() ? itr->newVertexOffset : 0;
+            }
+
+            prepared.vertices = std::move(packedVertices);
+        }
+
+        // Every LOD aims for this share of the triangles of the one before, within an error relative to the model radius that
+        // doubles with every level
+        constexpr f32 LOD_TRIANGLE_RATIO = 0.5f;
+        constexpr f32 LOD_BASE_RELATIVE_ERROR = 0.01f;
+
+        // A level keeping more of the indices of the one before isn't worth its draw calls and memory
+        constexpr f32 LOD_MAX_INDEX_RATIO = 0.8f;
+
+        // Numbers every vertex of a range by the first vertex with the same contents, identical vertices are interchangeable
+        // and would otherwise look like seams to the simplifier
+        void GetCanonicalVertices(const PreparedRenderModel& prepared, u32 vertexOffset, u32 numVertices, std::vector<u32>& sortedVertices, std::vector<u32>& canonicalVertices)
+        {
+            constexpr size_t VERTEX_SIZE = sizeof(Model::ComplexModel::Vertex);
+            const Model::ComplexModel::Vertex* vertices = &prepared.vertices[vertexOffset];
+
+            sortedVertices.resize(numVertices);
+            for (u32 i = 0; i < numVertices; i++)
+            {
+                sortedVertices[i] = i;
+            }
+
+            std::sort(sortedVertices.begin(), sortedVertices.end(), [vertices](u32 a, u32 b)
+            {
+                i32 comparison = std::memcmp(&vertices[a], &vertices[b], VERTEX_SIZE);
+                return comparison != 0 ? comparison < 0 : a < b;
+            });
+
+            canonicalVertices.resize(numVertices);
+            for (u32 i = 0; i < numVertices; i++)
+            {
+                bool isDuplicate = i > 0 && std::memcmp(&vertices[sortedVertices[i - 1]], &vertices[sortedVertices[i]], VERTEX_SIZE) == 0;
+                canonicalVertices[sortedVertices[i]] = isDuplicate ? canonicalVertices[sortedVertices[i - 1]] : sortedVertices[i];
+            }
+        }
+
+        // Simplifies every opaque draw call level by level, each level from the one before, and appends the simplified indices
+        // after the model's own. Stops early once a level no longer pays for itself. Transparent draw calls are left alone, the
+        // renderer only switches opaque ones
+        void BuildLods(PreparedRenderModel& prepared, u32 numLods, bool optimizeLods)
+        {
+            ZoneScopedN("ModelBuilder::BuildLods");
+
+            if (prepared.vertices.empty())
+                return;
+
+            vec3 min = UnpackVertexPosition(prepared.vertices[0]);
+            vec3 max = min;
+            for (const Model::ComplexModel::Vertex& vertex : prepared.vertices)
+            {
+                vec3 position = UnpackVertexPosition(vertex);
+                min = glm::min(min, position);
+                max = glm::max(max, position);
+            }
+
+            f32 radius = glm::length(max - min) * 0.5f;
+            if (radius <= 0.0f)
+                return;
+
+            size_t numDrawCalls = prepared.drawCalls.size();
+            std::vector<PreparedDrawCallLod> sources(numDrawCalls);
+            std::vector<f32> errors(numDrawCalls, 0.0f);
+            for (size_t i = 0; i < numDrawCalls; i++)
+            {
+                sources[i] = { prepared.drawCalls[i].firstIndex, prepared.drawCalls[i].indexCount };
+            }
+
+            std::vector<vec3> positions;
+            std::vector<u32> sortedVertices;
+            std::vector<u32> canonicalVertices;
+            std::vector<u16> canonicalIndices;
+            std::vector<u16> simplifiedIndices;
+
+            numLods = std::min(numLods, MODEL_MAX_LODS);
+            for (u32 level = 0; level < numLods; level++)
+            {
+                size_t levelIndexOffset = prepared.indices.size();
+                f32 targetError = radius * LOD_BASE_RELATIVE_ERROR * static_cast<f32>(1u << level);
+                f32 indexRatio = std::pow(LOD_TRIANGLE_RATIO, static_cast<f32>(level + 1));
+
+                u64 numSourceIndices = 0;
+                u64 numLevelIndices = 0;
+                f32 levelError = 0.0f;
+
+                for (size_t drawCallIndex = 0; drawCallIndex < numDrawCalls; drawCallIndex++)
+                {
+                    PreparedDrawCall& drawCall = prepared.drawCalls[drawCallIndex];
+                    PreparedDrawCallLod& lod = drawCall.lods[level];
+                    lod = sources[drawCallIndex];
+
+                    if (drawCall.isTransparent || lod.indexCount == 0 || lod.indexCount % 3 != 0)
+                        continue;
+
+                    if (static_cast<size_t>(lod.firstIndex) + lod.indexCount > prepared.indices.size())
+                        continue;
+
+                    auto drawCallsEnd = prepared.drawCalls.begin() + drawCallIndex;
+                    auto itr = std::find_if(prepared.drawCalls.begin(), drawCallsEnd, [&drawCall](const PreparedDrawCall& other)
+                    {
+                        return !other.isTransparent && other.firstIndex == drawCall.firstIndex && other.indexCount == drawCall.indexCount && other.vertexOffset == drawCall.vertexOffset;
+                    });
+
+                    if (itr != drawCallsEnd)
+                    {
+                        lod = itr->lods[level];
+                        errors[drawCallIndex] = errors[itr - prepared.drawCalls.begin()];
+                        continue;
+                    }
+
+                    const u16* indices = &prepared.indices[lod.firstIndex];
+                    u32 numVertices = *std::max_element(indices, indices + lod.indexCount) + 1u;
+
+                    if (static_cast<size_t>(drawCall.vertexOffset) + numVertices > prepared.vertices.size())
+                        continue;
+
+                    positions.resize(numVertices);
+                    for (u32 i = 0; i < numVertices; i++)
+                    {
+                        positions[i] = UnpackVertexPosition(prepared.vertices[drawCall.vertexOffset + i]);
+                    }
+
+                    GetCanonicalVertices(prepared, drawCall.vertexOffset, numVertices, sortedVertices, canonicalVertices);
+
+                    canonicalIndices.resize(lod.indexCount);
+                    for (u32 i = 0; i < lod.indexCount; i++)
+                    {
+                        canonicalIndices[i] = static_cast<u16>(canonicalVertices[indices[i]]);
+                    }
+
+                    size_t targetIndexCount = static_cast<size_t>(static_cast<f32>(drawCall.indexCount) * indexRatio);
+                    f32 remainingError = std::max(targetError - errors[drawCallIndex], 0.0f);
+
+                    f32 error = 0.0f;
+                    simplifiedIndices.resize(lod.indexCount);
+                    size_t numSimplifiedIndices = MeshOptimizer::Simplify(simplifiedIndices.data(), canonicalIndices.data(), lod.indexCount, positions.data(), numVertices, targetIndexCount, remainingError, &error);
+
+                    if (optimizeLods)
+                        MeshOptimizer::OptimizeVertexCache(simplifiedIndices.data(), numSimplifiedIndices, numVertices);
+
+                    numSourceIndices += lod.indexCount;
+                    numLevelIndices += numSimplifiedIndices;
+
+                    lod.firstIndex = static_cast<u32>(prepared.indices.size());
+                    lod.indexCount = static_cast<u32>(numSimplifiedIndices);
+                    prepared.indices.insert(prepared.indices.end(), simplifiedIndices.begin(), simplifiedIndices.begin() + numSimplifiedIndices);
+
+                    errors[drawCallIndex] += error;
+                    levelError = std::max(levelError, errors[drawCallIndex]);
+                }
+
+                if (numSourceIndices == 0 || static_cast<f32>(numLevelIndices) > static_cast<f32>(numSourceIndices) * LOD_MAX_INDEX_RATIO)
+                {
+                    prepared.indices.resize(levelIndexOffset);
+                    for (PreparedDrawCall& drawCall : prepared.drawCalls)
+                    {
+                        drawCall.lods[level] = PreparedDrawCallLod();
+                    }
+
+                    break;
+                }
+
+                for (size_t i = 0; i < numDrawCalls; i++)
+                {
+                    sources[i] = prepared.drawCalls[i].lods[level];
+                }
+
+                prepared.numLods = level + 1;
+                prepared.lodErrors[level] = levelError / radius;
+            }
+        }
+
+        // Splits the index range of every draw call into meshlets in its current triangle order, so this runs after
+        // OptimizeMeshes. Draw calls whose indices don't make whole triangles or reach outside the model get no meshlets
+        void BuildMeshlets(PreparedRenderModel& prepared)
+        {
+            ZoneScopedN("ModelBuilder::BuildMeshlets");
+
+            std::vector<vec3> positions;
+
+            for (size_t drawCallIndex = 0; drawCallIndex < prepared.drawCalls.size(); drawCallIndex++)
+            {
+                PreparedDrawCall& drawCall = prepared.drawCalls[drawCallIndex];
+                drawCall.meshletOffset = static_cast<u32>(prepared.meshlets.size());
+                drawCall.numMeshlets = 0;
+
+                if (drawCall.indexCount == 0 || drawCall.indexCount % 3 != 0)
+                    continue;
+
+                if (static_cast<size_t>(drawCall.firstIndex) + drawCall.indexCount > prepared.indices.size())
+                    continue;
+
+                auto drawCallsEnd = prepared.drawCalls.begin() + drawCallIndex;
+                auto itr = std::find_if(prepared.drawCalls.begin(), drawCallsEnd, [&drawCall](const PreparedDrawCall& other)
+                {
+                    return other.firstIndex == drawCall.firstIndex && other.indexCount == drawCall.indexCount && other.vertexOffset == drawCall.vertexOffset;
+                });
+
+                if (itr != drawCallsEnd)
+                {
+                    drawCall.meshletOffset = itr->meshletOffset;
+                    drawCall.numMeshlets = itr->numMeshlets;
+                    continue;
+                }
+
+                const u16* indices = &prepared.indices[drawCall.firstIndex];
+                u32 numVertices = *std::max_element(indices, indices + drawCall.indexCount) + 1u;
+
+                if (static_cast<size_t>(drawCall.vertexOffset) + numVertices > prepared.vertices.size())
+                    continue;
+
+                positions.resize(numVertices);
+                for (u32 i = 0; i < numVertices; i++)
+                {
+                    positions[i] = UnpackVertexPosition(prepared.vertices[drawCall.vertexOffset + i]);
+                }
+
+                drawCall.numMeshlets = MeshOptimizer::BuildMeshlets(indices, drawCall.indexCount, positions.data(), numVertices, prepared.meshlets);
+
+                for (u32 i = 0; i < drawCall.numMeshlets; i++)
+                {
+                    PreparedMeshlet& meshlet = prepared.meshlets[drawCall.meshletOffset + i];
+                    meshlet.firstIndex += drawCall.firstIndex;
+                    meshlet.vertexOffset = drawCall.vertexOffset;
+                }
+            }
+        }
     }
 
-    ModelBuildResult BuildPreparedModel(const std::string& name, const Model::ComplexModel& model)
+    ModelBuildResult BuildPreparedModel(const std::string& name, const Model::ComplexModel& model, const ModelBuildOptions& options)
     {
         ZoneScopedN("ModelBuilder::BuildPreparedModel");
 
@@ -173,12 +616,31 @@ namespace ModelLoading
         if (header.numOpaqueRenderBatches != numOpaqueDrawCalls || header.numTransparentRenderBatches != numTransparentDrawCalls)
             return BuildFailure("opaque or transparent render batch count does not match the model header");
 
+        if (options.optimizeMeshes)
+        {
+            OptimizeMeshes(prepared);
+            prepared.reserveInfo.numVertices = static_cast<u32>(prepared.vertices.size());
+        }
+
+        if (options.numLods > 0)
+        {
+            BuildLods(prepared, options.numLods, options.optimizeMeshes);
+            prepared.reserveInfo.numIndices = static_cast<u32>(prepared.indices.size());
+        }
+
+        if (options.buildMeshlets)
+        {
+            BuildMeshlets(prepared);
+            prepared.reserveInfo.numMeshlets = static_cast<u32>(prepared.meshlets.size());
+        }
+
         prepared.reserveInfo.numTextureUnits = static_cast<u32>(prepared.textureUnits.size());
         prepared.reserveInfo.numOpaqueDrawCalls = numOpaqueDrawCalls;
         prepared.reserveInfo.numTransparentDrawCalls = numTransparentDrawCalls;
         prepared.estimatedCommitBytes =
             (prepared.vertices.size() * sizeof(Model::ComplexModel::Vertex)) +
             (prepared.indices.size() * sizeof(u16)) +
+            (prepared.meshlets.size() * sizeof(PreparedMeshlet)) +
             (prepared.textureUnits.size() * sizeof(PreparedTextureUnit)) +
             (prepared.drawCalls.size() * sizeof(PreparedDrawCall)) +
             (prepared.decorationSets.size() * sizeof(Model::ComplexModel::DecorationSet)) +
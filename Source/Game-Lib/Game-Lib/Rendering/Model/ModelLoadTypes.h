@@ -1,4 +1,5 @@
 #pragma once
+#include "Game-Lib/Rendering/Model/MeshOptimizer.h"
 
 #include <Base/Types.h>
 
@@ -13,6 +14,7 @@ constexpr u32 MODEL_INVALID_TEXTURE_ID = 0; // This refers to the debug texture
 constexpr u32 MODEL_INVALID_TEXTURE_TRANSFORM_ID = std::numeric_limits<u16>().max();
 constexpr u32 MODEL_INVALID_TEXTURE_DATA_ID = std::numeric_limits<u32>().max();
 constexpr u8 MODEL_INVALID_TEXTURE_UNIT_INDEX = std::numeric_limits<u8>().max();
+constexpr u32 MODEL_MAX_LODS = 3; // Simplified levels on top of the full detail one
 
 namespace ModelLoading
 {
@@ -41,6 +43,16 @@ namespace ModelLoading
         u64 textureHash = 0;
     };
 
+    // firstIndex and vertexOffset are relative to the model like the draw calls until the meshlets are committed
+    using PreparedMeshlet = MeshOptimizer::Meshlet;
+
+    struct PreparedDrawCallLod
+    {
+    public:
+        u32 firstIndex = 0;
+        u32 indexCount = 0;
+    };
+
     struct PreparedDrawCall
     {
     public:
@@ -48,6 +60,13 @@ namespace ModelLoading
         u32 firstIndex = 0;
         u32 vertexOffset = 0;
 
+        // Draw calls sharing an index range share its meshlets
+        u32 meshletOffset = 0;
+        u32 numMeshlets = 0;
+
+        // lods[i] is LOD i + 1 drawing from the same vertices, opaque draw calls have PreparedRenderModel::numLods of them
+        PreparedDrawCallLod lods[MODEL_MAX_LODS];
+
         u32 textureUnitOffset = 0;
         u16 numTextureUnits = 0;
         u16 numUnlitTextureUnits = 0;
@@ -64,6 +83,7 @@ namespace ModelLoading
         u32 numTransparentDrawCalls = 0;
         u32 numVertices = 0;
         u32 numIndices = 0;
+        u32 numMeshlets = 0;
         u32 numTextureUnits = 0;
         u32 numBones = 0;
         u32 numTextureTransforms = 0;
@@ -79,6 +99,7 @@ namespace ModelLoading
 
         std::vector<Model::ComplexModel::Vertex> vertices;
         std::vector<u16> indices;
+        std::vector<PreparedMeshlet> meshlets;
         std::vector<PreparedTextureUnit> textureUnits;
         std::vector<PreparedTextureLoadRequest> textureLoadRequests;
         std::vector<PreparedDrawCall> drawCalls;
@@ -86,11 +107,28 @@ namespace ModelLoading
         std::vector<Model::ComplexModel::DecorationSet> decorationSets;
         std::vector<Model::ComplexModel::Decoration> decorations;
 
+        // How far each LOD moves the surface relative to the bounding sphere radius, the most of any draw call
+        u32 numLods = 0;
+        f32 lodErrors[MODEL_MAX_LODS] = { 0.0f };
+
         PreparedModelReserveInfo reserveInfo;
         u64 estimatedCommitBytes = 0;
         bool isAnimated = false;
     };
 
+    struct ModelBuildOptions
+    {
+    public:
+        // Reorders triangles for the vertex cache and overdraw and packs the vertices in draw order, see MeshOptimizer
+        bool optimizeMeshes = false;
+
+        // Splits every draw call into meshlets with bounds for cluster culling, see MeshOptimizer::BuildMeshlets
+        bool buildMeshlets = false;
+
+        // Simplified levels built for opaque draw calls, up to MODEL_MAX_LODS, see MeshOptimizer::Simplify
+        u32 numLods = 0;
+    };
+
     struct ModelBuildResult
     {
     public:
@@ -21,6 +21,7 @@
 #include "Game-Lib/Rendering/Terrain/TerrainLoader.h"
 #include "Game-Lib/Util/AssetPath.h"
 #include "Game-Lib/Util/JoltStream.h"
+#include "Game-Lib/Util/PhysicsBodyBatcher.h"
 #include "Game-Lib/Util/ServiceLocator.h"
 
 #include <Base/CVarSystem/CVarSystem.h>
@@ -59,14 +60,48 @@ AutoCVar_Int CVAR_ModelAsyncPrepare(CVarCategory::Client | CVarCategory::Renderi
 AutoCVar_Int CVAR_ModelAsyncMaxInFlight(CVarCategory::Client | CVarCategory::Rendering, "modelAsyncMaxInFlight", "maximum in-flight model preparation jobs", 8, CVarFlags::None);
 AutoCVar_Int CVAR_ModelAsyncMaxCommitsPerFrame(CVarCategory::Client | CVarCategory::Rendering, "modelAsyncMaxCommitsPerFrame", "maximum prepared models committed per frame", 8, CVarFlags::None);
 AutoCVar_Int CVAR_ModelAsyncCommitBudgetMB(CVarCategory::Client | CVarCategory::Rendering, "modelAsyncCommitBudgetMB", "estimated prepared model bytes committed per frame", 32, CVarFlags::None);
+AutoCVar_Int CVAR_ModelOptimizeMeshes(CVarCategory::Client | CVarCategory::Rendering, "modelOptimizeMeshes", "reorder model triangles for the vertex cache and overdraw and pack their vertices in draw order when preparing them", 1, CVarFlags::EditCheckbox);
+AutoCVar_Int CVAR_ModelBuildMeshlets(CVarCategory::Client | CVarCategory::Rendering, "modelBuildMeshlets", "split model draw calls into meshlets with bounding spheres and normal cones when preparing them, nothing culls with them yet", 0, CVarFlags::EditCheckbox);
+AutoCVar_Int CVAR_ModelLodCount(CVarCategory::Client | CVarCategory::Rendering, "modelLodCount", "number of simplified LODs generated for opaque model draw calls when preparing them", 3, CVarFlags::None);
+AutoCVar_Int CVAR_ModelCacheBudgetMB(CVarCategory::Client | CVarCategory::Rendering, "modelCacheBudgetMB", "prepared models and physics shapes kept across map changes, 0 disables the cache", 512, CVarFlags::None);
+
+namespace
+{
+    // Read on the game thread, prepare jobs get a copy
+    ModelLoading::ModelBuildOptions GetModelBuildOptions()
+    {
+        ModelLoading::ModelBuildOptions buildOptions;
+        buildOptions.optimizeMeshes = CVAR_ModelOptimizeMeshes.Get() != 0;
+        buildOptions.buildMeshlets = CVAR_ModelBuildMeshlets.Get() != 0;
+        buildOptions.numLods = static_cast<u32>(std::clamp(CVAR_ModelLodCount.Get(), 0, static_cast<i32>(MODEL_MAX_LODS)));
+
+        return buildOptions;
+    }
+
+    void AddPreparedModelReserveInfo(ModelRenderer::ReserveInfo& reserveInfo, const ModelLoading::PreparedModelReserveInfo& preparedReserveInfo)
+    {
+        reserveInfo.numModels += preparedReserveInfo.numModels;
+        reserveInfo.numOpaqueDrawcalls += preparedReserveInfo.numOpaqueDrawCalls;
+        reserveInfo.numTransparentDrawcalls += preparedReserveInfo.numTransparentDrawCalls;
+        reserveInfo.numVertices += preparedReserveInfo.numVertices;
+        reserveInfo.numIndices += preparedReserveInfo.numIndices;
+        reserveInfo.numMeshlets += preparedReserveInfo.numMeshlets;
+        reserveInfo.numTextureUnits += preparedReserveInfo.numTextureUnits;
+        reserveInfo.numBones += preparedReserveInfo.numBones;
+        reserveInfo.numTextureTransforms += preparedReserveInfo.numTextureTransforms;
+        reserveInfo.numDecorationSets += preparedReserveInfo.numDecorationSets;
+        reserveInfo.numDecorations += preparedReserveInfo.numDecorations;
+    }
+}
 
 struct ActiveModelPrepareJob : enki::ITaskSet
 {
 public:
-    ActiveModelPrepareJob(u64 epoch, u64 modelHash, PACT::PactStorage* pactStorage, moodycamel::ConcurrentQueue<ModelLoading::PreparedModelResult>* completionQueue)
+    ActiveModelPrepareJob(u64 epoch, u64 modelHash, const ModelLoading::ModelBuildOptions& buildOptions, PACT::PactStorage* pactStorage, moodycamel::ConcurrentQueue<ModelLoading::PreparedModelResult>* completionQueue)
         : enki::ITaskSet(1)
         , _epoch(epoch)
         , _modelHash(modelHash)
+        , _buildOptions(buildOptions)
         , _pactStorage(pactStorage)
         , _completionQueue(completionQueue)
     {
@@ -126,7 +161,7 @@ public:
         {
             ZoneScopedN("Build Prepared Render Model");
 
-            ModelLoading::ModelBuildResult buildResult = ModelLoading::BuildPreparedModel(result.debugName, *result.model);
+            ModelLoading::ModelBuildResult buildResult = ModelLoading::BuildPreparedModel(result.debugName, *result.model, _buildOptions);
             if (!buildResult)
             {
                 result.error = std::move(buildResult.error);
@@ -143,6 +178,7 @@ public:
 private:
     u64 _epoch = 0;
     u64 _modelHash = std::numeric_limits<u64>().max();
+    ModelLoading::ModelBuildOptions _buildOptions;
     PACT::PactStorage* _pactStorage = nullptr;
     moodycamel::ConcurrentQueue<ModelLoading::PreparedModelResult>* _completionQueue = nullptr;
 };
@@ -180,6 +216,9 @@ void ModelLoader::Shutdown()
 
     _loaderEpoch++;
     CancelAndDrainPrepareJobs();
+
+    // Cached shapes have to be released before Jolt is
+    _modelCache.Clear();
 }
 
 void ModelLoader::Clear()
@@ -226,6 +265,12 @@ void ModelLoader::Clear()
 
     entt::registry* registry = ServiceLocator::GetEnttRegistries()->gameRegistry;
 
+    {
+        // Bodies still waiting to be added are in _instanceIDToBodyID too, get them into the broad phase so they can be removed with the rest
+        auto& joltState = registry->ctx().get<ECS::Singletons::JoltState>();
+        _staticBodyBatcher.Flush(joltState.physicsSystem.GetBodyInterface(), JPH::EActivation::DontActivate);
+    }
+
     u32 numInstanceIDToBodyIDs = static_cast<u32>(_instanceIDToBodyID.size());
     if (numInstanceIDToBodyIDs > 0)
     {
@@ -244,6 +289,7 @@ void ModelLoader::Clear()
 
         bodyInterface.RemoveBodies(bodyIDs.data(), numBodies);
         bodyInterface.DestroyBodies(bodyIDs.data(), numBodies);
+        joltState.MarkStaticWorldChanged();
 
         _instanceIDToBodyID.clear();
     }
@@ -255,14 +301,27 @@ void ModelLoader::Clear()
     _modelHashToJoltShape.clear();
 
     _uniqueIDToinstanceID.clear();
+    _cancelledPlacementUniqueIDs.clear();
+    _instanceIDToDecorationInstanceIDs.clear();
+    _entitiesToDestroy.clear();
     _instanceIDToModelID.clear();
     _modelIDToModelHash.clear();
     _entityToLatestRequestID.clear();
 
     _numTerrainModelsToLoad = 0;
     _numTerrainModelsLoaded = 0;
-    _modelRenderer->Clear();
-    _lightRenderer->Clear();
+
+    if (_modelRenderer)
+    {
+        _modelRenderer->Clear();
+        _lightRenderer->Clear();
+    }
+    else
+    {
+        _nextHeadlessModelID = 0;
+        _nextHeadlessInstanceID = 0;
+        _freeHeadlessInstanceIDs.clear();
+    }
 
     auto& tSystem = ECS::TransformSystem::Get(*registry);
     tSystem.ProcessMovedEntities([](entt::entity entity) {});
@@ -275,9 +334,11 @@ void ModelLoader::Update(f32 deltaTime)
 {
     ZoneScopedN("ModelLoader::Update");
 
-    if (_terrainLoader->IsLoading())
+    if (_terrainLoader && _terrainLoader->IsLoading())
         return;
 
+    _modelCache.SetBudget(static_cast<u64>(std::max(0, CVAR_ModelCacheBudgetMB.Get())) * 1024ull * 1024ull);
+
     TracyPlot("Model Load Requests Pending", static_cast<i64>(_pendingLoadRequests.size_approx() + _pendingTerrainLoadRequests.size_approx()));
     TracyPlot("Model Instance Requests Pending", static_cast<i64>(_internalLoadRequests.size_approx()));
     TracyPlot("Model Unload Requests Pending", static_cast<i64>(_unloadRequests.size_approx()));
@@ -290,7 +351,8 @@ void ModelLoader::Update(f32 deltaTime)
     TracyPlot("Model Prepare In Flight", static_cast<i64>(_activeModelPrepareJobs.size()));
     TracyPlot("Model Prepare Commit Backlog", static_cast<i64>(_pendingPreparedModelCommits.size() + _preparedModelResults.size_approx()));
 
-    const bool asyncPrepareEnabled = CVAR_ModelAsyncPrepare.Get() != 0;
+    // Prepare jobs only build GPU data, without a renderer models are always read on the game thread
+    const bool asyncPrepareEnabled = _modelRenderer && CVAR_ModelAsyncPrepare.Get() != 0;
     const bool drainingDisabledAsyncWork = !asyncPrepareEnabled && (!_activeModelPrepareJobs.empty() || !_pendingPreparedModelCommits.empty());
     u32 numTerrainLoadRequests = static_cast<u32>(_pendingTerrainLoadRequests.size_approx());
     moodycamel::ConcurrentQueue<LoadRequestInternal>* workQueue = numTerrainLoadRequests > 0 ? &_pendingTerrainLoadRequests : &_pendingLoadRequests;
@@ -393,7 +455,8 @@ void ModelLoader::Update(f32 deltaTime)
             _modelIDToAABB.reserve(_modelIDToAABB.size() + reserveInfo.numModels);
             _modelAssets.reserve(_modelAssets.size() + reserveInfo.numModels);
 
-            _modelRenderer->Reserve(reserveInfo);
+            if (_modelRenderer)
+                _modelRenderer->Reserve(reserveInfo);
         }
 
         //enki::TaskSet loadModelsTask(numDequeuedLoadRequests, [&](enki::TaskSetPartition range, uint32_t threadNum)
@@ -500,7 +563,8 @@ void ModelLoader::Update(f32 deltaTime)
                 registry->insert<ECS::Components::Transform>(begin, _createdEntities.end());
                 registry->insert<ECS::Components::WorldAABB>(begin, _createdEntities.end());
 
-                _modelRenderer->Reserve(reserveInfo);
+                if (_modelRenderer)
+                    _modelRenderer->Reserve(reserveInfo);
             }
 
             std::atomic<u32> numCreatedInstances = 0;
@@ -538,6 +602,9 @@ void ModelLoader::Update(f32 deltaTime)
                             if (hasUniqueID && uniqueIDExists)
                                 break;
 
+                            if (hasUniqueID && _cancelledPlacementUniqueIDs.erase(static_cast<u32>(loadRequest.extraData3)) > 0)
+                                break;
+
                             if (loadRequest.entity == entt::null)
                             {
                                 u32 index = static_cast<u32>(createdEntitiesOffset) + numCreatedInstances.fetch_add(1);
@@ -616,20 +683,57 @@ void ModelLoader::Update(f32 deltaTime)
 
                 JPH::BodyID bodyID = static_cast<JPH::BodyID>(_instanceIDToBodyID[unloadRequest.instanceID]);
 
-                bodyInterface.RemoveBody(bodyID);
-                bodyInterface.DestroyBody(bodyID);
-
+                _staticBodyBatcher.QueueRemove(bodyID);
                 _instanceIDToBodyID.erase(unloadRequest.instanceID);
             }
 
             if (_instanceIDToEntityID.contains(unloadRequest.instanceID))
                 _instanceIDToEntityID.erase(unloadRequest.instanceID);
 
-            _modelRenderer->RemoveInstance(unloadRequest.instanceID);
+            if (_modelRenderer)
+                _modelRenderer->RemoveInstance(unloadRequest.instanceID);
+            else
+                _freeHeadlessInstanceIDs.push_back(unloadRequest.instanceID);
+        }
+
+        // Entities owned by unloaded placements are destroyed after their instances are gone
+        if (!_entitiesToDestroy.empty())
+        {
+            ZoneScopedN("Destroy Unloaded Placement Entities");
+
+            robin_hood::unordered_set<entt::entity> destroyedEntities;
+            destroyedEntities.reserve(_entitiesToDestroy.size());
+
+            for (entt::entity entity : _entitiesToDestroy)
+            {
+                if (!registry->valid(entity))
+                    continue;
+
+                registry->destroy(entity);
+                destroyedEntities.insert(entity);
+            }
+            _entitiesToDestroy.clear();
+
+            std::erase_if(_createdEntities, [&destroyedEntities](entt::entity entity) { return destroyedEntities.contains(entity); });
         }
     }
     TracyPlot("Model Unloads Processed", static_cast<i64>(numUnloadsProcessed));
 
+    if (_staticBodyBatcher.HasPendingWork())
+    {
+        entt::registry* registry = ServiceLocator::GetEnttRegistries()->gameRegistry;
+        auto& joltState = registry->ctx().get<ECS::Singletons::JoltState>();
+        JPH::BodyInterface& bodyInterface = joltState.physicsSystem.GetBodyInterface();
+
+        i32 bodyBatchSize = *CVarSystem::Get()->GetIntCVar(CVarCategory::Client | CVarCategory::Physics, "bodyBatchSize"_h);
+        Util::PhysicsBodyBatcher::FlushStats flushStats = _staticBodyBatcher.Flush(bodyInterface, JPH::EActivation::Activate, static_cast<u32>(glm::max(bodyBatchSize, 0)));
+        TracyPlot("Model Physics Bodies Added", static_cast<i64>(flushStats.numAdded));
+        TracyPlot("Model Physics Bodies Removed", static_cast<i64>(flushStats.numRemoved));
+
+        if (flushStats.numAdded > 0 || flushStats.numRemoved > 0)
+            joltState.MarkStaticWorldChanged();
+    }
+
     {
         ZoneScopedN("Load Results");
 
@@ -742,6 +846,29 @@ void ModelLoader::LoadPlacement(const Terrain::Placement& placement)
     _pendingTerrainLoadRequests.enqueue(loadRequest);
 }
 
+void ModelLoader::UnloadPlacement(u32 uniqueID)
+{
+    ZoneScopedN("ModelLoader::UnloadPlacement");
+
+    u32 instanceID = std::numeric_limits<u32>().max();
+    {
+        std::scoped_lock lock(_instanceIDToModelIDMutex);
+
+        auto itr = _uniqueIDToinstanceID.find(uniqueID);
+        if (itr == _uniqueIDToinstanceID.end())
+        {
+            // The placement is still queued, drop it when it reaches AddStaticInstance
+            _cancelledPlacementUniqueIDs.insert(uniqueID);
+            return;
+        }
+
+        instanceID = itr->second;
+        _uniqueIDToinstanceID.erase(itr);
+    }
+
+    UnloadStaticInstance(instanceID);
+}
+
 void ModelLoader::LoadDecoration(u32 instanceID, const Model::ComplexModel::Decoration& decoration)
 {
     ZoneScopedN("ModelLoader::LoadDecoration");
@@ -913,7 +1040,7 @@ void ModelLoader::SetModelVisible(const ECS::Components::Model& model, bool visi
 {
     ZoneScopedN("ModelLoader::SetModelVisible");
 
-    if (model.instanceID == std::numeric_limits<u32>().max())
+    if (!_modelRenderer || model.instanceID == std::numeric_limits<u32>().max())
         return;
 
     _modelRenderer->RequestChangeVisibility(model.instanceID, visible);
@@ -933,7 +1060,7 @@ void ModelLoader::SetModelTransparent(const ECS::Components::Model& model, bool
 {
     ZoneScopedN("ModelLoader::SetModelTransparent");
 
-    if (model.instanceID == std::numeric_limits<u32>().max())
+    if (!_modelRenderer || model.instanceID == std::numeric_limits<u32>().max())
         return;
 
     _modelRenderer->RequestChangeTransparency(model.instanceID, transparent, opacity);
@@ -953,7 +1080,7 @@ void ModelLoader::SetModelHighlight(const ECS::Components::Model& model, f32 hig
 {
     ZoneScopedN("ModelLoader::SetModelHighlight");
 
-    if (model.instanceID == std::numeric_limits<u32>().max())
+    if (!_modelRenderer || model.instanceID == std::numeric_limits<u32>().max())
         return;
 
     _modelRenderer->RequestChangeHighlight(model.instanceID, highlightIntensity);
@@ -973,7 +1100,7 @@ void ModelLoader::EnableGroupForModel(const ECS::Components::Model& model, u32 g
 {
     ZoneScopedN("ModelLoader::EnableGroupForModel");
 
-    if (model.instanceID == std::numeric_limits<u32>().max())
+    if (!_modelRenderer || model.instanceID == std::numeric_limits<u32>().max())
         return;
 
     _modelRenderer->RequestChangeGroup(model.instanceID, groupID, 0, true);
@@ -993,7 +1120,7 @@ void ModelLoader::DisableGroupForModel(const ECS::Components::Model& model, u32
 {
     ZoneScopedN("ModelLoader::DisableGroupForModel");
 
-    if (model.instanceID == std::numeric_limits<u32>().max())
+    if (!_modelRenderer || model.instanceID == std::numeric_limits<u32>().max())
         return;
 
     _modelRenderer->RequestChangeGroup(model.instanceID, groupID, 0, false);
@@ -1013,7 +1140,7 @@ void ModelLoader::DisableGroupsForModel(const ECS::Components::Model& model, u32
 {
     ZoneScopedN("ModelLoader::DisableGroupsForModel");
 
-    if (model.instanceID == std::numeric_limits<u32>().max())
+    if (!_modelRenderer || model.instanceID == std::numeric_limits<u32>().max())
         return;
 
     _modelRenderer->RequestChangeGroup(model.instanceID, groupIDStart, groupIDEnd, false);
@@ -1033,7 +1160,7 @@ void ModelLoader::DisableAllGroupsForModel(const ECS::Components::Model& model)
 {
     ZoneScopedN("ModelLoader::DisableAllGroupsForModel");
 
-    if (model.instanceID == std::numeric_limits<u32>().max())
+    if (!_modelRenderer || model.instanceID == std::numeric_limits<u32>().max())
         return;
 
     _modelRenderer->RequestChangeGroup(model.instanceID, 1, std::numeric_limits<u32>().max(), false);
@@ -1052,7 +1179,7 @@ void ModelLoader::SetSkinTextureForModel(const ECS::Components::Model& model, Re
 {
     ZoneScopedN("ModelLoader::SetSkinTextureForModel");
 
-    if (model.instanceID == std::numeric_limits<u32>().max())
+    if (!_modelRenderer || model.instanceID == std::numeric_limits<u32>().max())
         return;
 
     _modelRenderer->RequestChangeSkinTexture(model.instanceID, textureID);
@@ -1071,7 +1198,7 @@ void ModelLoader::SetHairTextureForModel(const ECS::Components::Model& model, Re
 {
     ZoneScopedN("ModelLoader::SetHairTextureForModel");
 
-    if (model.instanceID == std::numeric_limits<u32>().max())
+    if (!_modelRenderer || model.instanceID == std::numeric_limits<u32>().max())
         return;
 
     _modelRenderer->RequestChangeHairTexture(model.instanceID, textureID);
@@ -1247,16 +1374,7 @@ void ModelLoader::ConsumePreparedModels()
         ZoneScopedN("Aggregate Prepared Model Reserve");
         for (const ModelLoading::PreparedModelResult& preparedResult : commitBatch)
         {
-            reserveInfo.numModels += preparedResult.preparedModel.reserveInfo.numModels;
-            reserveInfo.numOpaqueDrawcalls += preparedResult.preparedModel.reserveInfo.numOpaqueDrawCalls;
-            reserveInfo.numTransparentDrawcalls += preparedResult.preparedModel.reserveInfo.numTransparentDrawCalls;
-            reserveInfo.numVertices += preparedResult.preparedModel.reserveInfo.numVertices;
-            reserveInfo.numIndices += preparedResult.preparedModel.reserveInfo.numIndices;
-            reserveInfo.numTextureUnits += preparedResult.preparedModel.reserveInfo.numTextureUnits;
-            reserveInfo.numBones += preparedResult.preparedModel.reserveInfo.numBones;
-            reserveInfo.numTextureTransforms += preparedResult.preparedModel.reserveInfo.numTextureTransforms;
-            reserveInfo.numDecorationSets += preparedResult.preparedModel.reserveInfo.numDecorationSets;
-            reserveInfo.numDecorations += preparedResult.preparedModel.reserveInfo.numDecorations;
+            AddPreparedModelReserveInfo(reserveInfo, preparedResult.preparedModel.reserveInfo);
         }
     }
 
@@ -1290,6 +1408,8 @@ void ModelLoader::ConsumePreparedModels()
 
         _modelHashToDiscoveredModel[preparedResult.modelHash] = std::move(discoveredModel);
         const bool success = CommitPreparedModel(_modelHashToDiscoveredModel[preparedResult.modelHash], preparedResult.preparedModel);
+        if (success)
+            CacheModel(preparedResult.modelHash, std::move(preparedResult.preparedModel));
 
         asset.loadState = success ? LoadState::Loaded : LoadState::Failed;
         for (const LoadRequestInternal& request : asset.waitingRequests)
@@ -1314,10 +1434,15 @@ void ModelLoader::DispatchAsyncLoadRequests(moodycamel::ConcurrentQueue<LoadRequ
     enki::TaskScheduler* taskScheduler = ServiceLocator::GetTaskScheduler();
     auto* pactStorage = ServiceLocator::GetPactStorage();
     const u32 maxInFlight = static_cast<u32>(std::max(1, CVAR_ModelAsyncMaxInFlight.Get()));
+    const u64 commitBudgetBytes = static_cast<u64>(std::max(1, CVAR_ModelAsyncCommitBudgetMB.Get())) * 1024ull * 1024ull;
+    const ModelLoading::ModelBuildOptions buildOptions = GetModelBuildOptions();
     u32 numJobsDispatched = 0;
     u32 numRequestsCoalesced = 0;
     u32 numRequestsDeferred = 0;
 
+    std::vector<u64> cachedModelHashes;
+    u64 cachedCommitBytes = 0;
+
     for (u32 i = 0; i < numRequests; i++)
     {
         const LoadRequestInternal& request = _pendingLoadRequestsVector[i];
@@ -1342,6 +1467,27 @@ void ModelLoader::DispatchAsyncLoadRequests(moodycamel::ConcurrentQueue<LoadRequ
             continue;
         }
 
+        // Models kept from an earlier map skip the prepare job, they are committed below under the same byte budget
+        if (_modelHashToDiscoveredModel.contains(request.modelHash))
+        {
+            if (cachedCommitBytes >= commitBudgetBytes && _modelCache.Contains(request.modelHash))
+            {
+                workQueue.enqueue(request);
+                numRequestsDeferred++;
+                continue;
+            }
+
+            if (const CachedModel* cachedModel = _modelCache.Get(request.modelHash))
+            {
+                asset.loadState = LoadState::Requested;
+                asset.waitingRequests.push_back(request);
+
+                cachedCommitBytes += cachedModel->preparedModel.estimatedCommitBytes;
+                cachedModelHashes.push_back(request.modelHash);
+                continue;
+            }
+        }
+
         const size_t numOutstandingPrepares = _activeModelPrepareJobs.size() + _pendingPreparedModelCommits.size() + _preparedModelResults.size_approx();
         if (numOutstandingPrepares >= maxInFlight)
         {
@@ -1353,15 +1499,18 @@ void ModelLoader::DispatchAsyncLoadRequests(moodycamel::ConcurrentQueue<LoadRequ
         asset.loadState = LoadState::Requested;
         asset.waitingRequests.push_back(request);
 
-        auto job = std::make_unique<ActiveModelPrepareJob>(_loaderEpoch, request.modelHash, pactStorage, &_preparedModelResults);
+        auto job = std::make_unique<ActiveModelPrepareJob>(_loaderEpoch, request.modelHash, buildOptions, pactStorage, &_preparedModelResults);
         taskScheduler->AddTaskSetToPipe(job.get());
         _activeModelPrepareJobs.push_back(std::move(job));
         numJobsDispatched++;
     }
 
+    CommitCachedModels(cachedModelHashes);
+
     TracyPlot("Model Prepare Jobs Dispatched", static_cast<i64>(numJobsDispatched));
     TracyPlot("Model Prepare Requests Coalesced", static_cast<i64>(numRequestsCoalesced));
     TracyPlot("Model Prepare Requests Deferred", static_cast<i64>(numRequestsDeferred));
+    TracyPlot("Model Cache Hits", static_cast<i64>(cachedModelHashes.size()));
 }
 
 void ModelLoader::CancelAndDrainPrepareJobs()
@@ -1437,21 +1586,39 @@ bool ModelLoader::LoadRequest(DiscoveredModel& discoveredModel)
         return false;
     }
 
-    ModelLoading::ModelBuildResult buildResult = ModelLoading::BuildPreparedModel(discoveredModel.name, *discoveredModel.model);
+    // Headless clients keep the metadata, skeleton and collision shape and build nothing for the GPU
+    if (!_modelRenderer)
+        return CommitModelInfo(discoveredModel, _nextHeadlessModelID++);
+
+    if (const CachedModel* cachedModel = _modelCache.Get(discoveredModel.modelHash))
+        return CommitPreparedModel(discoveredModel, cachedModel->preparedModel, cachedModel->shape);
+
+    ModelLoading::ModelBuildResult buildResult = ModelLoading::BuildPreparedModel(discoveredModel.name, *discoveredModel.model, GetModelBuildOptions());
     if (!buildResult)
     {
         NC_LOG_ERROR("ModelLoader : Failed to prepare model ({0}): {1}", discoveredModel.name, buildResult.error);
         return false;
     }
 
-    return CommitPreparedModel(discoveredModel, buildResult.preparedModel);
+    if (!CommitPreparedModel(discoveredModel, buildResult.preparedModel))
+        return false;
+
+    CacheModel(discoveredModel.modelHash, std::move(buildResult.preparedModel));
+    return true;
 }
 
-bool ModelLoader::CommitPreparedModel(DiscoveredModel& discoveredModel, const ModelLoading::PreparedRenderModel& preparedModel)
+bool ModelLoader::CommitPreparedModel(DiscoveredModel& discoveredModel, const ModelLoading::PreparedRenderModel& preparedModel, const JPH::ShapeRefC& cachedShape)
 {
     ZoneScopedN("ModelLoader::CommitPreparedModel");
 
     u32 modelID = _modelRenderer->CommitPreparedModel(preparedModel);
+    return CommitModelInfo(discoveredModel, modelID, cachedShape);
+}
+
+bool ModelLoader::CommitModelInfo(DiscoveredModel& discoveredModel, u32 modelID, const JPH::ShapeRefC& cachedShape)
+{
+    ZoneScopedN("ModelLoader::CommitModelInfo");
+
     _modelHashToModelID[discoveredModel.modelHash] = modelID;
     _modelIDToModelHash[modelID] = discoveredModel.modelHash;
 
@@ -1466,22 +1633,27 @@ bool ModelLoader::CommitPreparedModel(DiscoveredModel& discoveredModel, const Mo
 
         if (physicsEnabled && numPhysicsBytes > 0)
         {
-            ZoneScopedN("Load Physics Shape");
+            JPH::ShapeRefC shape = cachedShape;
+            if (!shape)
+            {
+                ZoneScopedN("Load Physics Shape");
 
-            Bytebuffer physicsBuffer = Bytebuffer(discoveredModel.model->physicsData.data(), numPhysicsBytes);
-            physicsBuffer.SkipWrite(numPhysicsBytes);
+                Bytebuffer physicsBuffer = Bytebuffer(discoveredModel.model->physicsData.data(), numPhysicsBytes);
+                physicsBuffer.SkipWrite(numPhysicsBytes);
 
-            JoltStreamIn streamIn(&physicsBuffer);
+                JoltStreamIn streamIn(&physicsBuffer);
 
-            JPH::Shape::IDToShapeMap shapeMap;
-            JPH::Shape::IDToMaterialMap materialMap;
+                JPH::Shape::IDToShapeMap shapeMap;
+                JPH::Shape::IDToMaterialMap materialMap;
 
-            JPH::MeshShapeSettings::ShapeResult shapeResult = JPH::Shape::sRestoreWithChildren(streamIn, shapeMap, materialMap);
+                JPH::MeshShapeSettings::ShapeResult shapeResult = JPH::Shape::sRestoreWithChildren(streamIn, shapeMap, materialMap);
+                shape = shapeResult.Get();
+            }
             discoveredModel.hasShape = true;
 
             {
                 std::scoped_lock lock(_physicsSystemMutex);
-                _modelHashToJoltShape[discoveredModel.modelHash] = shapeResult.Get();
+                _modelHashToJoltShape[discoveredModel.modelHash] = shape;
             }
         }
     }
@@ -1489,6 +1661,61 @@ bool ModelLoader::CommitPreparedModel(DiscoveredModel& discoveredModel, const Mo
     return true;
 }
 
+void ModelLoader::CacheModel(u64 modelHash, ModelLoading::PreparedRenderModel&& preparedModel)
+{
+    ZoneScopedN("ModelLoader::CacheModel");
+
+    if (_modelCache.GetBudget() == 0)
+        return;
+
+    CachedModel cachedModel;
+    cachedModel.preparedModel = std::move(preparedModel);
+
+    u64 numBytes = sizeof(CachedModel) + cachedModel.preparedModel.estimatedCommitBytes + cachedModel.preparedModel.debugName.size();
+    numBytes += cachedModel.preparedModel.textureLoadRequests.size() * sizeof(ModelLoading::PreparedTextureLoadRequest);
+
+    auto shapeItr = _modelHashToJoltShape.find(modelHash);
+    if (shapeItr != _modelHashToJoltShape.end() && shapeItr->second != nullptr)
+    {
+        cachedModel.shape = shapeItr->second;
+        numBytes += cachedModel.shape->GetStats().mSizeBytes;
+    }
+
+    _modelCache.Put(modelHash, std::move(cachedModel), numBytes);
+}
+
+void ModelLoader::CommitCachedModels(const std::vector<u64>& modelHashes)
+{
+    ZoneScopedN("ModelLoader::CommitCachedModels");
+
+    if (modelHashes.empty())
+        return;
+
+    ModelRenderer::ReserveInfo reserveInfo;
+    for (u64 modelHash : modelHashes)
+    {
+        const CachedModel* cachedModel = _modelCache.Peek(modelHash);
+        AddPreparedModelReserveInfo(reserveInfo, cachedModel->preparedModel.reserveInfo);
+    }
+
+    _modelHashToModelID.reserve(_modelHashToModelID.size() + modelHashes.size());
+    _modelIDToModelHash.reserve(_modelIDToModelHash.size() + modelHashes.size());
+    _modelIDToAABB.reserve(_modelIDToAABB.size() + modelHashes.size());
+    _modelRenderer->Reserve(reserveInfo);
+
+    for (u64 modelHash : modelHashes)
+    {
+        const CachedModel* cachedModel = _modelCache.Peek(modelHash);
+        const bool success = CommitPreparedModel(_modelHashToDiscoveredModel[modelHash], cachedModel->preparedModel, cachedModel->shape);
+
+        ModelAssetRecord& asset = _modelAssets[modelHash];
+        asset.loadState = success ? LoadState::Loaded : LoadState::Failed;
+        for (const LoadRequestInternal& request : asset.waitingRequests)
+            CompletePreparedRequest(request, success);
+        asset.waitingRequests.clear();
+    }
+}
+
 void ModelLoader::AddStaticInstance(entt::entity entityID, const LoadRequestInternal& request)
 {
     ZoneScopedN("ModelLoader::AddStaticInstance");
@@ -1505,10 +1732,15 @@ void ModelLoader::AddStaticInstance(entt::entity entityID, const LoadRequestInte
     u32 modelID = _modelHashToModelID[request.modelHash];
     u32 doodadSet = request.type == LoadRequestType::Placement ? static_cast<u32>(request.extraData2) : std::numeric_limits<u32>().max();
     u32 instanceID;
+    if (_modelRenderer)
     {
         ZoneScopedN("Commit Static Renderer Instance");
         instanceID = _modelRenderer->AddPlacementInstance(entityID, modelID, request.modelHash, nullptr, request.spawnPosition, request.spawnRotation, request.scale, doodadSet, request.type == LoadRequestType::Placement);
     }
+    else
+    {
+        instanceID = GetNextHeadlessInstanceID();
+    }
 
     auto& model = registry->get<ECS::Components::Model>(entityID);
     model.flags.loaded = true;
@@ -1531,6 +1763,8 @@ void ModelLoader::AddStaticInstance(entt::entity entityID, const LoadRequestInte
         _instanceIDToEntityID[instanceID] = entityID;
 
         hasParent = parentInstanceID != std::numeric_limits<u32>().max() && _instanceIDToEntityID.contains(parentInstanceID);
+        if (hasParent && request.type == LoadRequestType::Decoration)
+            _instanceIDToDecorationInstanceIDs[parentInstanceID].push_back(instanceID);
     }
 
     {
@@ -1575,7 +1809,7 @@ void ModelLoader::AddStaticInstance(entt::entity entityID, const LoadRequestInte
             {
                 JPH::BodyID bodyID = body->GetID();
                 body->SetUserData(Jolt::PhysicsBodyUserData::Pack(entityID, Jolt::PhysicsSurfaceType::StaticModel, Jolt::PhysicsBodyFlags::CanSupport | Jolt::PhysicsBodyFlags::CanSnapTo | Jolt::PhysicsBodyFlags::CanStepOnto));
-                bodyInterface.AddBody(bodyID, JPH::EActivation::Activate);
+                _staticBodyBatcher.QueueAdd(bodyID, position);
 
                 {
                     std::scoped_lock lock(_physicsSystemMutex);
@@ -1589,6 +1823,35 @@ void ModelLoader::AddStaticInstance(entt::entity entityID, const LoadRequestInte
     animationInitData.flags.isDynamic = false;
 }
 
+void ModelLoader::UnloadStaticInstance(u32 instanceID)
+{
+    auto decorationItr = _instanceIDToDecorationInstanceIDs.find(instanceID);
+    if (decorationItr != _instanceIDToDecorationInstanceIDs.end())
+    {
+        std::vector<u32> decorationInstanceIDs = std::move(decorationItr->second);
+        _instanceIDToDecorationInstanceIDs.erase(decorationItr);
+
+        for (u32 decorationInstanceID : decorationInstanceIDs)
+        {
+            UnloadStaticInstance(decorationInstanceID);
+        }
+    }
+
+    auto entityItr = _instanceIDToEntityID.find(instanceID);
+    if (entityItr == _instanceIDToEntityID.end())
+        return;
+
+    entt::entity entity = entityItr->second;
+
+    UnloadRequest unloadRequest =
+    {
+        .entity = entity,
+        .instanceID = instanceID
+    };
+    _unloadRequests.enqueue(unloadRequest);
+    _entitiesToDestroy.push_back(entity);
+}
+
 void ModelLoader::AddDynamicInstance(entt::entity entityID, const LoadRequestInternal& request)
 {
     ZoneScopedN("ModelLoader::AddDynamicInstance");
@@ -1611,7 +1874,12 @@ void ModelLoader::AddDynamicInstance(entt::entity entityID, const LoadRequestInt
     auto& transform = registry->get<ECS::Components::Transform>(entityID);
     transformSystem.SetLocalScale(entityID, vec3(model.scale));
 
-    if (instanceID == std::numeric_limits<u32>().max())
+    if (!_modelRenderer)
+    {
+        if (instanceID == std::numeric_limits<u32>().max())
+            instanceID = GetNextHeadlessInstanceID();
+    }
+    else if (instanceID == std::numeric_limits<u32>().max())
     {
         ZoneScopedN("Commit New Dynamic Renderer Instance");
         instanceID = _modelRenderer->AddInstance(entityID, modelID, discoveredModel.model, transform.GetMatrix(), request.extraData1);
@@ -1651,3 +1919,13 @@ void ModelLoader::AddDynamicInstance(entt::entity entityID, const LoadRequestInt
         _modelRenderer->AddAnimationInstance(instanceID);
     }
 }
+
+u32 ModelLoader::GetNextHeadlessInstanceID()
+{
+    if (_freeHeadlessInstanceIDs.empty())
+        return _nextHeadlessInstanceID++;
+
+    u32 instanceID = _freeHeadlessInstanceIDs.back();
+    _freeHeadlessInstanceIDs.pop_back();
+    return instanceID;
+}
@@ -2,6 +2,8 @@
 #include "Game-Lib/ECS/Components/AABB.h"
 #include "Game-Lib/Gameplay/Database/Unit.h"
 #include "Game-Lib/Rendering/Model/ModelLoadTypes.h"
+#include "Game-Lib/Util/LRUCache.h"
+#include "Game-Lib/Util/PhysicsBodyBatcher.h"
 
 #include <Base/Types.h>
 #include <Base/Container/ConcurrentQueue.h>
@@ -105,6 +107,14 @@ private:
         std::vector<LoadRequestInternal> waitingRequests;
     };
 
+    // CPU side model data kept across map changes so models shared between maps skip parsing, preparing and shape restoring
+    struct CachedModel
+    {
+    public:
+        ModelLoading::PreparedRenderModel preparedModel;
+        JPH::ShapeRefC shape = nullptr;
+    };
+
     struct WorkRequest
     {
     public:
@@ -114,6 +124,10 @@ private:
     };
 
 public:
+    using ModelCacheStats = Util::LRUCache<u64, CachedModel>::Stats;
+
+public:
+    // Both renderers may be null on headless clients, models then load their metadata and skeletons but nothing for the GPU
     ModelLoader(ModelRenderer* modelRenderer, LightRenderer* lightRenderer);
 
     void Init();
@@ -131,6 +145,7 @@ public: // Load Request Helpers
     f32 GetLoadingProgress() const;
 
     void LoadPlacement(const Terrain::Placement& placement);
+    void UnloadPlacement(u32 uniqueID);
     void LoadDecoration(u32 instanceID, const Model::ComplexModel::Decoration& decoration);
     bool LoadModelForEntity(entt::entity entity, ECS::Components::Model& model, u64 modelNameHash);
     bool LoadDisplayIDForEntity(entt::entity entity, ECS::Components::Model& model, Database::Unit::DisplayInfoType displayInfoType, u32 displayID, u64 modelHash = std::numeric_limits<u64>().max(), u8 modelVariant = 0);
@@ -176,9 +191,14 @@ public:
     DiscoveredModel& GetDiscoveredModel(u64 modelHash);
     DiscoveredModel& GetDiscoveredModelFromModelID(u32 modelID);
 
+    ModelCacheStats GetModelCacheStats() const { return _modelCache.GetStats(); }
+
 private:
     bool LoadRequest(DiscoveredModel& discoveredModel);
-    bool CommitPreparedModel(DiscoveredModel& discoveredModel, const ModelLoading::PreparedRenderModel& preparedModel);
+    bool CommitPreparedModel(DiscoveredModel& discoveredModel, const ModelLoading::PreparedRenderModel& preparedModel, const JPH::ShapeRefC& cachedShape = nullptr);
+    bool CommitModelInfo(DiscoveredModel& discoveredModel, u32 modelID, const JPH::ShapeRefC& cachedShape = nullptr);
+    void CacheModel(u64 modelHash, ModelLoading::PreparedRenderModel&& preparedModel);
+    void CommitCachedModels(const std::vector<u64>& modelHashes);
     void ConsumePreparedModels();
     void ReapCompletedPrepareJobs();
     void DispatchAsyncLoadRequests(moodycamel::ConcurrentQueue<LoadRequestInternal>& workQueue, u32 numRequests);
@@ -188,7 +208,9 @@ private:
     ModelLoading::ModelLoadRequestID GetNextLoadRequestID();
     void EnqueueLoadResult(const LoadRequestInternal& request, bool success, bool isStatic);
     void AddStaticInstance(entt::entity entityID, const LoadRequestInternal& request);
+    void UnloadStaticInstance(u32 instanceID);
     void AddDynamicInstance(entt::entity entityID, const LoadRequestInternal& request);
+    u32 GetNextHeadlessInstanceID();
 
 private:
     TerrainLoader* _terrainLoader = nullptr;
@@ -217,10 +239,15 @@ private:
     robin_hood::unordered_map<u64, u32> _modelHashToModelID;
     robin_hood::unordered_map<u64, JPH::ShapeRefC> _modelHashToJoltShape;
     robin_hood::unordered_map<u64, DiscoveredModel> _modelHashToDiscoveredModel;
+    Util::LRUCache<u64, CachedModel> _modelCache; // Survives Clear, only instance and renderer state is per map
 
     robin_hood::unordered_map<u32, u32> _uniqueIDToinstanceID;
+    robin_hood::unordered_set<u32> _cancelledPlacementUniqueIDs; // Placements unloaded before their instance was committed
+    robin_hood::unordered_map<u32, std::vector<u32>> _instanceIDToDecorationInstanceIDs;
+    std::vector<entt::entity> _entitiesToDestroy;
     robin_hood::unordered_map<u32, u32> _instanceIDToModelID;
     robin_hood::unordered_map<u32, u32> _instanceIDToBodyID;
+    Util::PhysicsBodyBatcher _staticBodyBatcher; // Placement bodies are added to and removed from the broad phase once per Update
     robin_hood::unordered_map<u32, entt::entity> _instanceIDToEntityID;
     robin_hood::unordered_map<u32, ModelLoading::ModelLoadRequestID> _entityToLatestRequestID;
     std::mutex _instanceIDToModelIDMutex;
@@ -235,4 +262,9 @@ private:
     std::vector<std::unique_ptr<ActiveModelPrepareJob>> _activeModelPrepareJobs; // Game-thread-owned task lifetimes.
     std::atomic<ModelLoading::ModelLoadRequestID> _nextLoadRequestID = 1;
     u64 _loaderEpoch = 1;
+
+    // Without a ModelRenderer to hand out model and instance IDs they are counted here instead
+    u32 _nextHeadlessModelID = 0;
+    u32 _nextHeadlessInstanceID = 0;
+    std::vector<u32> _freeHeadlessInstanceIDs;
 };
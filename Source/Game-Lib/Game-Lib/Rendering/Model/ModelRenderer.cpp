@@ -1,6 +1,7 @@
 #include "ModelRenderer.h"
 
 #include "Game-Lib/Application/EnttRegistries.h"
+#include "Game-Lib/ECS/Components/Camera.h"
 #include "Game-Lib/ECS/Components/DisplayInfo.h"
 #include "Game-Lib/ECS/Components/Model.h"
 #include "Game-Lib/ECS/Singletons/ActiveCamera.h"
@@ -36,6 +37,7 @@
 #include <Renderer/RenderGraph.h>
 #include <Renderer/Descriptors/ImageDesc.h>
 
+#include <enkiTS/TaskScheduler.h>
 #include <imgui/imgui.h>
 #include <entt/entt.hpp>
 #include <glm/gtx/euler_angles.hpp>
@@ -45,7 +47,16 @@
 
 AutoCVar_Int CVAR_ModelRendererEnabled(CVarCategory::Client | CVarCategory::Rendering, "modelEnabled", "enable modelrendering", 1, CVarFlags::EditCheckbox);
 AutoCVar_Int CVAR_ModelCullingEnabled(CVarCategory::Client | CVarCategory::Rendering, "modelCulling", "enable model culling", 1, CVarFlags::EditCheckbox);
-AutoCVar_Int CVAR_ModelTextureLoadsPerFrame(CVarCategory::Client | CVarCategory::Rendering, "modelTextureLoadsPerFrame", "maximum model textures loaded on the render thread per frame", 32, CVarFlags::None);
+AutoCVar_Int CVAR_ModelTextureLoadsPerFrame(CVarCategory::Client | CVarCategory::Rendering, "modelTextureLoadsPerFrame", "maximum streamed model textures uploaded on the render thread per frame", 32, CVarFlags::None);
+AutoCVar_Int CVAR_ModelTextureStreamingBudgetMB(CVarCategory::Client | CVarCategory::Rendering, "modelTextureStreamingBudgetMB", "megabytes of model textures kept resident, full resolution versions are evicted by priority to stay below it", 1024, CVarFlags::None);
+AutoCVar_Int CVAR_ModelTextureStreamingLowMipSize(CVarCategory::Client | CVarCategory::Rendering, "modelTextureStreamingLowMipSize", "largest width and height of the low resolution version model textures are loaded with first", 64, CVarFlags::None);
+AutoCVar_Int CVAR_ModelTextureStreamingMaxInFlight(CVarCategory::Client | CVarCategory::Rendering, "modelTextureStreamingMaxInFlight", "maximum model texture loads in flight on the task workers", 32, CVarFlags::None);
+AutoCVar_Float CVAR_ModelTextureStreamingMinUpgradePriority(CVarCategory::Client | CVarCategory::Rendering, "modelTextureStreamingMinUpgradePriority", "smallest screen-space size (radius over distance) a model needs before its textures load at full resolution", 0.005f, CVarFlags::None);
+AutoCVar_Int CVAR_ModelTexturePriorityInstancesPerFrame(CVarCategory::Client | CVarCategory::Rendering, "modelTexturePriorityInstancesPerFrame", "instances visited per frame when refreshing model texture priorities", 8192, CVarFlags::None);
+AutoCVar_Int CVAR_ModelLodEnabled(CVarCategory::Client | CVarCategory::Rendering, "modelLodEnabled", "draw distant opaque models with their simplified LODs", 1, CVarFlags::EditCheckbox);
+AutoCVar_Float CVAR_ModelLodMaxPixelError(CVarCategory::Client | CVarCategory::Rendering, "modelLodMaxPixelError", "largest on screen error in pixels a model LOD may have before a more detailed one is drawn", 1.0f, CVarFlags::None);
+AutoCVar_Int CVAR_ModelLodInstancesPerFrame(CVarCategory::Client | CVarCategory::Rendering, "modelLodInstancesPerFrame", "instances visited per frame when picking model LODs", 16384, CVarFlags::None);
+AutoCVar_Int CVAR_ModelLodChangesPerFrame(CVarCategory::Client | CVarCategory::Rendering, "modelLodChangesPerFrame", "most model LOD switches applied per frame, the rest wait for the next frame", 512, CVarFlags::None);
 AutoCVar_Int CVAR_ModelOcclusionCullingEnabled(CVarCategory::Client | CVarCategory::Rendering, "modelOcclusionCulling", "enable model occlusion culling", 1, CVarFlags::EditCheckbox);
 
 AutoCVar_Int CVAR_ModelDisableTwoStepCulling(CVarCategory::Client | CVarCategory::Rendering, "modelDisableTwoStepCulling", "disable two step culling and force all drawcalls into the geometry pass", 0, CVarFlags::EditCheckbox);
@@ -60,6 +71,85 @@ AutoCVar_Int CVAR_ModelValidateTransfers(CVarCategory::Client | CVarCategory::Re
 
 AutoCVar_Int CVAR_ModelsCastShadow(CVarCategory::Client | CVarCategory::Rendering, "shadowModelsCastShadow", "should Models cast shadows", 1, CVarFlags::EditCheckbox);
 
+namespace
+{
+    // Coarser LODs have to fit this share of the pixel error, so instances near a threshold don't flip every sweep
+    constexpr f32 LOD_COARSEN_HYSTERESIS = 0.8f;
+
+    // Keeps the low resolution version of a texture from sharing the full version's slot in the renderer's hash lookup
+    constexpr u64 LOW_MIP_TEXTURE_HASH_SALT = 0x9E3779B97F4A7C15ull;
+
+    // Frames an evicted texture is kept loaded for, covers the frames in flight and the one being recorded
+    constexpr u32 STREAMED_TEXTURE_UNLOAD_DELAY_FRAMES = 3;
+}
+
+struct ModelTextureStreamTask : enki::ITaskSet
+{
+public:
+    ModelTextureStreamTask(u64 epoch, const std::vector<TextureStreamer::LoadJob>& jobs, u32 lowMipSize, PACT::PactStorage* pactStorage, moodycamel::ConcurrentQueue<ModelRenderer::TextureStreamResult>* completionQueue)
+        : enki::ITaskSet(static_cast<u32>(jobs.size()))
+        , _epoch(epoch)
+        , _jobs(jobs)
+        , _lowMipSize(lowMipSize)
+        , _pactStorage(pactStorage)
+        , _completionQueue(completionQueue)
+    {
+        m_Priority = enki::TASK_PRIORITY_LOW;
+    }
+
+    void ExecuteRange(enki::TaskSetPartition range, u32 threadNum) override
+    {
+        (void)threadNum;
+
+        for (u32 i = range.start; i < range.end; i++)
+        {
+            ZoneScopedN("Stream Model Texture Task");
+
+            ModelRenderer::TextureStreamResult result;
+            result.epoch = _epoch;
+            result.job = _jobs[i];
+
+            std::shared_ptr<PACT::PactFileHandle> fileHandle = std::make_shared<PACT::PactFileHandle>();
+            {
+                ZoneScopedN("Read Model Texture From PACT");
+                if (_pactStorage->ReadFile(result.job.textureHash, *fileHandle) != PACT::PactReadResult::Success)
+                {
+                    _completionQueue->enqueue(std::move(result));
+                    continue;
+                }
+            }
+
+            result.success = true;
+            result.fullSize = fileHandle->GetSize();
+
+            if (result.job.level == TextureStreamer::Level::Low)
+            {
+                ZoneScopedN("Build Low Mip Texture");
+
+                // The file is read again for the upgrade, holding on to every full texture until then defeats the budget
+                const u8* data = reinterpret_cast<const u8*>(fileHandle->GetData());
+                if (TextureStreaming::BuildLowMipTexture(data, fileHandle->GetSize(), _lowMipSize, result.lowTexture))
+                {
+                    _completionQueue->enqueue(std::move(result));
+                    continue;
+                }
+
+                result.isWholeTexture = true;
+            }
+
+            result.fileHandle = std::move(fileHandle);
+            _completionQueue->enqueue(std::move(result));
+        }
+    }
+
+private:
+    u64 _epoch = 0;
+    std::vector<TextureStreamer::LoadJob> _jobs;
+    u32 _lowMipSize = 0;
+    PACT::PactStorage* _pactStorage = nullptr;
+    moodycamel::ConcurrentQueue<ModelRenderer::TextureStreamResult>* _completionQueue = nullptr;
+};
+
 ModelRenderer::ModelRenderer(Renderer::Renderer* renderer, GameRenderer* gameRenderer, DebugRenderer* debugRenderer)
     : CulledRenderer(renderer, gameRenderer, debugRenderer)
     , _renderer(renderer)
@@ -80,6 +170,7 @@ ModelRenderer::ModelRenderer(Renderer::Renderer* renderer, GameRenderer* gameRen
     {
         _vertices.SetValidation(true);
         _indices.SetValidation(true);
+        _meshlets.SetValidation(true);
         _instanceDatas.SetValidation(true);
         _instanceMatrices.SetValidation(true);
         _textureUnits.SetValidation(true);
@@ -98,7 +189,7 @@ ModelRenderer::ModelRenderer(Renderer::Renderer* renderer, GameRenderer* gameRen
 
 ModelRenderer::~ModelRenderer()
 {
-
+    CancelTextureStreamTasks();
 }
 
 void ModelRenderer::Update(f32 deltaTime)
@@ -111,7 +202,6 @@ void ModelRenderer::Update(f32 deltaTime)
     TracyPlot("Model Instances Dirty", static_cast<i64>(_instancesDirty));
 
     entt::registry* gameRegistry = ServiceLocator::GetEnttRegistries()->gameRegistry;
-    entt::registry* dbRegistry = ServiceLocator::GetEnttRegistries()->dbRegistry;
 
     {
         ZoneScopedN("Update Transform Matrices");
@@ -374,84 +464,8 @@ void ModelRenderer::Update(f32 deltaTime)
         _transparentSkyboxCullingResources.Update(deltaTime, false);
     }
 
-    const u32 maxTextureLoadsPerFrame = static_cast<u32>(std::clamp(CVAR_ModelTextureLoadsPerFrame.Get(), 1, static_cast<i32>(_textureLoadWork.size())));
-    u32 numTextureLoads = static_cast<u32>(_textureLoadRequests.try_dequeue_bulk(_textureLoadWork.begin(), maxTextureLoadsPerFrame));
-    TracyPlot("Model Texture Loads Dequeued", static_cast<i64>(numTextureLoads));
-    u32 numTextureCacheHits = 0;
-    u32 numTexturePactReads = 0;
-    if (numTextureLoads > 0)
-    {
-        ZoneScopedN("Texture Load Requests");
-
-        auto* pactStorage = ServiceLocator::GetPactStorage();
-
-        auto& textureSingleton = dbRegistry->ctx().get<ECS::Singletons::TextureSingleton>();
-
-        //Renderer::TextureDesc textureDesc;
-        //textureDesc.path.reserve(128);
-
-        Renderer::DataTextureDesc textureDesc;
-
-        {
-            ZoneScopedN("Texture Loading");
-
-            for (u32 i = 0; i < numTextureLoads; i++)
-            {
-                ZoneScopedN("Texture Load");
-                const TextureLoadRequest& textureLoad = _textureLoadWork[i];
-                TextureUnit& textureUnit = _textureUnits[textureLoad.textureUnitOffset];
-
-                auto cachedTextureItr = _modelTextureHashToArrayIndex.find(textureLoad.textureHash);
-                if (cachedTextureItr != _modelTextureHashToArrayIndex.end())
-                {
-                    ZoneScopedN("Reuse Model Texture");
-                    textureUnit.textureIds[textureLoad.textureIndex] = cachedTextureItr->second;
-                    _dirtyTextureUnitOffsets.insert(textureLoad.textureUnitOffset);
-                    numTextureCacheHits++;
-                    continue;
-                }
-
-                PACT::PactFileHandle fileHandle;
-                {
-                    ZoneScopedN("Read Model Texture From PACT");
-                    if (pactStorage->ReadFile(textureLoad.textureHash, fileHandle) != PACT::PactReadResult::Success)
-                        continue;
-
-                    numTexturePactReads++;
-                }
-
-                textureDesc.hash = textureLoad.textureHash;
-                textureDesc.data = reinterpret_cast<const u8*>(fileHandle.GetData());
-                textureDesc.size = fileHandle.GetSize();
-
-                size_t textureArrayIndex = 0;
-                Renderer::TextureID textureID;
-                {
-                    ZoneScopedN("Upload Model Texture To Array");
-                    textureID = _renderer->LoadDataTextureIntoArray(textureDesc, _textures, textureArrayIndex);
-                    textureUnit.textureIds[textureLoad.textureIndex] = static_cast<u32>(textureArrayIndex);
-                }
-                NC_ASSERT(textureUnit.textureIds[textureLoad.textureIndex] < Renderer::Settings::MAX_TEXTURES, "ModelRenderer : LoadModel overflowed the {0} textures we have support for", Renderer::Settings::MAX_TEXTURES);
-
-                _modelTextureHashToArrayIndex[textureLoad.textureHash] = textureUnit.textureIds[textureLoad.textureIndex];
-    
-                _dirtyTextureUnitOffsets.insert(textureLoad.textureUnitOffset);
-            }
-        }
-    
-        {
-            ZoneScopedN("Set Dirty Texture Units");
-    
-            for (u32 textureUnitOffset : _dirtyTextureUnitOffsets)
-            {
-                _textureUnits.SetDirtyElement(textureUnitOffset);
-            }
-    
-            _dirtyTextureUnitOffsets.clear();
-        }
-    }
-    TracyPlot("Model Texture Cache Hits", static_cast<i64>(numTextureCacheHits));
-    TracyPlot("Model Texture PACT Reads", static_cast<i64>(numTexturePactReads));
+    UpdateTextureStreaming();
+    UpdateInstanceLods();
 
     u32 numChangeGroupRequests = static_cast<u32>(_changeGroupRequests.try_dequeue_bulk(_changeGroupWork.begin(), 256));
     if (numChangeGroupRequests > 0)
@@ -461,6 +475,7 @@ void ModelRenderer::Update(f32 deltaTime)
         for (u32 i = 0; i < numChangeGroupRequests; i++)
         {
             ChangeGroupRequest& changeGroupRequest = _changeGroupWork[i];
+            MarkInstanceRefsDirty(changeGroupRequest.instanceID);
 
             InstanceManifest& instanceManifest = _instanceManifests[changeGroupRequest.instanceID];
 
@@ -491,8 +506,6 @@ void ModelRenderer::Update(f32 deltaTime)
                 }
             }
         }
-
-        _instancesDirty = true;
     }
 
     u32 numChangeSkinTextureRequests = static_cast<u32>(_changeSkinTextureRequests.try_dequeue_bulk(_changeSkinTextureWork.begin(), 256));
@@ -566,8 +579,8 @@ void ModelRenderer::Update(f32 deltaTime)
             ChangeVisibilityRequest& changeVisibilityRequest = _changeVisibilityWork[i];
             InstanceManifest& instanceManifest = _instanceManifests[changeVisibilityRequest.instanceID];
             instanceManifest.visible = changeVisibilityRequest.visible;
+            MarkInstanceRefsDirty(changeVisibilityRequest.instanceID);
         }
-        _instancesDirty = true;
     }
 
     u32 numChangeTransparencyRequests = static_cast<u32>(_changeTransparencyRequests.try_dequeue_bulk(_changeTransparencyWork.begin(), 256));
@@ -589,8 +602,8 @@ void ModelRenderer::Update(f32 deltaTime)
             InstanceData& instanceData = _instanceDatas[changeTransparencyRequest.instanceID];
             instanceData.opacity = changeTransparencyRequest.opacity;
             _instanceDatas.SetDirtyElement(changeTransparencyRequest.instanceID);
+            MarkInstanceRefsDirty(changeTransparencyRequest.instanceID);
         }
-        _instancesDirty = true;
     }
 
     u32 numChangeHighlightRequests = static_cast<u32>(_changeHighlightRequests.try_dequeue_bulk(_changeHighlightWork.begin(), 256));
@@ -619,8 +632,8 @@ void ModelRenderer::Update(f32 deltaTime)
             instanceManifest.skybox = changeSkyboxRequest.skybox;
 
             MakeInstanceSkybox(changeSkyboxRequest.instanceID, instanceManifest, instanceManifest.skybox);
+            MarkInstanceRefsDirty(changeSkyboxRequest.instanceID);
         }
-        _instancesDirty = true;
     }
 
     CompactInstanceRefs();
@@ -639,6 +652,7 @@ void ModelRenderer::Clear()
     _cullingDatas.Clear();
     _vertices.Clear();
     _indices.Clear();
+    _meshlets.Clear();
 
     _instanceManifests.clear();
     _instanceDatas.Clear();
@@ -667,7 +681,19 @@ void ModelRenderer::Clear()
     TextureLoadRequest textureLoadRequest;
     while (_textureLoadRequests.try_dequeue(textureLoadRequest)) {}
     _dirtyTextureUnitOffsets.clear();
-    _modelTextureHashToArrayIndex.clear();
+
+    _textureStreamEpoch++;
+    CancelTextureStreamTasks();
+    _textureStreamer.Clear();
+    _streamedTextureUsers.clear();
+    _textureUnitAddressToStreamedTexture.clear();
+    _modelTexturePriorities.clear();
+    _modelTexturePrioritiesSweep.clear();
+    _texturePrioritySweepCursor = 0;
+    _streamedTextureIDs.clear();
+    _pendingStreamedTextureUnloads.clear();
+    _numRetiredTextureSlots = 0;
+    _lodSweepCursor = 0;
 
     ChangeGroupRequest changeGroupRequest;
     while (_changeGroupRequests.try_dequeue(changeGroupRequest)) {}
@@ -690,6 +716,14 @@ void ModelRenderer::Clear()
     ChangeSkyboxRequest changeSkyboxRequest;
     while (_changeSkyboxRequests.try_dequeue(changeSkyboxRequest)) {}
 
+    for (InstanceRefTable& instanceRefTable : _instanceRefTables)
+    {
+        instanceRefTable.Clear();
+    }
+    u32 dirtyInstanceID;
+    while (_dirtyInstanceRefQueue.try_dequeue(dirtyInstanceID)) {}
+    _dirtyInstanceRefIDs.clear();
+
     // Queued modelIDs/instanceIDs are invalid after a clear
     u32 drainedID;
     while (_uninstancedAnimatedModelQueue.try_dequeue(drainedID)) {}
@@ -725,6 +759,367 @@ void ModelRenderer::Clear()
     _instancesDirty = false;
 }
 
+void ModelRenderer::UpdateTextureStreaming()
+{
+    ZoneScopedN("ModelRenderer::UpdateTextureStreaming");
+
+    entt::registry* gameRegistry = ServiceLocator::GetEnttRegistries()->gameRegistry;
+
+    _textureStreamer.SetBudget(static_cast<u64>(std::max(CVAR_ModelTextureStreamingBudgetMB.Get(), 1)) * 1024 * 1024);
+    _textureStreamer.SetMinUpgradePriority(CVAR_ModelTextureStreamingMinUpgradePriority.GetFloat());
+
+    std::erase_if(_pendingStreamedTextureUnloads, [this](PendingTextureUnload& unload)
+    {
+        if (--unload.framesLeft > 0)
+            return false;
+
+        _renderer->UnloadTexture(unload.textureID);
+        return true;
+    });
+
+    // Requests only touch the streamer now, the reading and decoding happens on the task workers
+    u32 numTextureLoads = static_cast<u32>(_textureLoadRequests.try_dequeue_bulk(_textureLoadWork.begin(), _textureLoadWork.size()));
+    TracyPlot("Model Texture Loads Dequeued", static_cast<i64>(numTextureLoads));
+    u32 numTextureCacheHits = 0;
+    if (numTextureLoads > 0)
+    {
+        ZoneScopedN("Texture Load Requests");
+
+        for (u32 i = 0; i < numTextureLoads; i++)
+        {
+            const TextureLoadRequest& textureLoad = _textureLoadWork[i];
+            u64 textureUnitAddress = (static_cast<u64>(textureLoad.textureIndex) << 32) | textureLoad.textureUnitOffset;
+
+            auto [addressItr, isNewAddress] = _textureUnitAddressToStreamedTexture.try_emplace(textureUnitAddress, textureLoad.textureHash);
+            bool isNewUser = isNewAddress || addressItr->second != textureLoad.textureHash;
+            addressItr->second = textureLoad.textureHash;
+
+            StreamedTextureUsers& users = _streamedTextureUsers[textureLoad.textureHash];
+            if (isNewUser)
+                users.textureUnitAddresses.push_back(textureUnitAddress);
+
+            // A model's requests are enqueued back to back, a duplicate from interleaved commits only costs a lookup
+            if (users.modelIDs.empty() || users.modelIDs.back() != textureLoad.modelID)
+                users.modelIDs.push_back(textureLoad.modelID);
+
+            u32 arrayIndex = 0;
+            if (_textureStreamer.GetArrayIndex(textureLoad.textureHash, arrayIndex))
+            {
+                _textureUnits[textureLoad.textureUnitOffset].textureIds[textureLoad.textureIndex] = arrayIndex;
+                _dirtyTextureUnitOffsets.insert(textureLoad.textureUnitOffset);
+                numTextureCacheHits++;
+                continue;
+            }
+
+            f32 priority = textureLoad.modelID < _modelTexturePriorities.size() ? _modelTexturePriorities[textureLoad.modelID] : 0.0f;
+            _textureStreamer.Request(textureLoad.textureHash, priority);
+        }
+    }
+    TracyPlot("Model Texture Cache Hits", static_cast<i64>(numTextureCacheHits));
+
+    {
+        ZoneScopedN("Texture Stream Results");
+
+        std::erase_if(_activeTextureStreamTasks, [](const std::unique_ptr<ModelTextureStreamTask>& task)
+        {
+            return task->GetIsComplete();
+        });
+
+        const u32 maxTextureUploadsPerFrame = static_cast<u32>(std::max(CVAR_ModelTextureLoadsPerFrame.Get(), 1));
+        u32 numTextureUploads = 0;
+
+        TextureStreamResult result;
+        while (numTextureUploads < maxTextureUploadsPerFrame && _textureStreamResults.try_dequeue(result))
+        {
+            if (result.epoch != _textureStreamEpoch)
+                continue;
+
+            if (!result.success)
+            {
+                _textureStreamer.FailJob(result.job);
+                continue;
+            }
+
+            if (!result.lowTexture.empty())
+            {
+                _textureStreamer.CompleteJob(result.job, result.lowTexture.data(), result.lowTexture.size(), result.fullSize, false);
+            }
+            else
+            {
+                _textureStreamer.CompleteJob(result.job, result.fileHandle->GetData(), result.fileHandle->GetSize(), result.fullSize, result.isWholeTexture);
+            }
+
+            numTextureUploads++;
+        }
+        TracyPlot("Model Texture Uploads", static_cast<i64>(numTextureUploads));
+    }
+
+    if (auto* activeCamera = gameRegistry->ctx().find<ECS::Singletons::ActiveCamera>())
+    {
+        if (activeCamera->entity != entt::null && gameRegistry->all_of<ECS::Components::Transform>(activeCamera->entity))
+        {
+            vec3 cameraPos = gameRegistry->get<ECS::Components::Transform>(activeCamera->entity).GetWorldPosition();
+            UpdateTexturePriorities(cameraPos);
+        }
+    }
+
+    const u32 maxJobsInFlight = static_cast<u32>(std::max(CVAR_ModelTextureStreamingMaxInFlight.Get(), 1));
+    u32 numJobsInFlight = _textureStreamer.GetNumJobsInFlight();
+    if (numJobsInFlight < maxJobsInFlight)
+    {
+        ZoneScopedN("Dispatch Texture Stream Jobs");
+
+        _textureStreamJobs.clear();
+        _textureStreamer.CollectJobs(maxJobsInFlight - numJobsInFlight, _textureStreamJobs);
+
+        if (!_textureStreamJobs.empty())
+        {
+            const u32 lowMipSize = static_cast<u32>(std::max(CVAR_ModelTextureStreamingLowMipSize.Get(), 1));
+
+            auto task = std::make_unique<ModelTextureStreamTask>(_textureStreamEpoch, _textureStreamJobs, lowMipSize, ServiceLocator::GetPactStorage(), &_textureStreamResults);
+            ServiceLocator::GetTaskScheduler()->AddTaskSetToPipe(task.get());
+            _activeTextureStreamTasks.push_back(std::move(task));
+        }
+    }
+    TracyPlot("Model Texture Jobs In Flight", static_cast<i64>(_textureStreamer.GetNumJobsInFlight()));
+    TracyPlot("Model Texture Resident MB", static_cast<i64>(_textureStreamer.GetResidentBytes() / (1024 * 1024)));
+    TracyPlot("Model Texture Retired Slots", static_cast<i64>(_numRetiredTextureSlots));
+
+    if (!_dirtyTextureUnitOffsets.empty())
+    {
+        ZoneScopedN("Set Dirty Texture Units");
+
+        for (u32 textureUnitOffset : _dirtyTextureUnitOffsets)
+        {
+            _textureUnits.SetDirtyElement(textureUnitOffset);
+        }
+
+        _dirtyTextureUnitOffsets.clear();
+    }
+}
+
+void ModelRenderer::UpdateTexturePriorities(const vec3& cameraPos)
+{
+    ZoneScopedN("ModelRenderer::UpdateTexturePriorities");
+
+    const u32 numModels = static_cast<u32>(_modelManifests.size());
+    const u32 numInstances = static_cast<u32>(_instanceDatas.Count());
+
+    if (_modelTexturePrioritiesSweep.size() < numModels)
+    {
+        _modelTexturePriorities.resize(numModels, 0.0f);
+        _modelTexturePrioritiesSweep.resize(numModels, 0.0f);
+    }
+
+    // Removed instances keep their stale data until the slot is reused, at worst that keeps a texture sharp a little longer
+    const u32 maxInstancesPerFrame = static_cast<u32>(std::max(CVAR_ModelTexturePriorityInstancesPerFrame.Get(), 1));
+    const u32 sweepEnd = std::min(_texturePrioritySweepCursor + maxInstancesPerFrame, numInstances);
+    for (u32 instanceID = _texturePrioritySweepCursor; instanceID < sweepEnd; instanceID++)
+    {
+        u32 modelID = _instanceDatas[instanceID].modelID;
+        if (modelID >= numModels)
+            continue;
+
+        const mat4x4& transformMatrix = _instanceMatrices[instanceID];
+        const Model::ComplexModel::CullingData& cullingData = _cullingDatas[modelID];
+
+        f32 scale = glm::max(glm::length(vec3(transformMatrix[0])), glm::max(glm::length(vec3(transformMatrix[1])), glm::length(vec3(transformMatrix[2]))));
+        f32 radius = glm::length(vec3(cullingData.extents)) * scale;
+        vec3 center = vec3(transformMatrix * vec4(vec3(cullingData.center), 1.0f));
+
+        // Radius over distance to the bounding sphere approximates its size on screen
+        f32 distance = glm::max(glm::distance(center, cameraPos) - radius, 1.0f);
+        f32& priority = _modelTexturePrioritiesSweep[modelID];
+        priority = glm::max(priority, radius / distance);
+    }
+    _texturePrioritySweepCursor = sweepEnd;
+
+    if (_texturePrioritySweepCursor < numInstances)
+        return;
+
+    ZoneScopedN("Publish Texture Priorities");
+
+    _modelTexturePriorities.swap(_modelTexturePrioritiesSweep);
+    std::fill(_modelTexturePrioritiesSweep.begin(), _modelTexturePrioritiesSweep.end(), 0.0f);
+    _texturePrioritySweepCursor = 0;
+
+    for (const auto& [textureHash, users] : _streamedTextureUsers)
+    {
+        f32 priority = 0.0f;
+        for (u32 modelID : users.modelIDs)
+        {
+            if (modelID < _modelTexturePriorities.size())
+                priority = glm::max(priority, _modelTexturePriorities[modelID]);
+        }
+
+        _textureStreamer.SetPriority(textureHash, priority);
+    }
+}
+
+void ModelRenderer::UpdateInstanceLods()
+{
+    ZoneScopedN("ModelRenderer::UpdateInstanceLods");
+
+    entt::registry* gameRegistry = ServiceLocator::GetEnttRegistries()->gameRegistry;
+
+    auto* activeCamera = gameRegistry->ctx().find<ECS::Singletons::ActiveCamera>();
+    if (!activeCamera || activeCamera->entity == entt::null || !gameRegistry->all_of<ECS::Components::Transform, ECS::Components::Camera>(activeCamera->entity))
+        return;
+
+    vec3 cameraPos = gameRegistry->get<ECS::Components::Transform>(activeCamera->entity).GetWorldPosition();
+    const ECS::Components::Camera& camera = gameRegistry->get<ECS::Components::Camera>(activeCamera->entity);
+
+    // Pixels per world unit at a distance of one, the vertical fov is the one CalculateCameraMatrices builds the projection with
+    f32 fovY = glm::radians(camera.fov) * 0.6f;
+    f32 pixelsPerUnit = _renderer->GetRenderSize().y * 0.5f / glm::tan(fovY * 0.5f);
+
+    // The error is kept relative to the model radius, so it takes the projected radius to turn it into pixels
+    const bool lodEnabled = CVAR_ModelLodEnabled.Get() != 0;
+    const f32 maxPixelError = glm::max(CVAR_ModelLodMaxPixelError.GetFloat(), 0.0f);
+
+    const u32 numModels = static_cast<u32>(_modelManifests.size());
+    const u32 numInstances = static_cast<u32>(_instanceDatas.Count());
+    const u32 maxInstancesPerFrame = static_cast<u32>(std::max(CVAR_ModelLodInstancesPerFrame.Get(), 1));
+
+    // Every switch moves the instance's draw refs and invalidates its shadow pages, so a camera cut can't do all of them in one frame
+    const u32 maxLodChangesPerFrame = static_cast<u32>(std::max(CVAR_ModelLodChangesPerFrame.Get(), 1));
+
+    u32 numLodChanges = 0;
+    u32 sweepEnd = std::min(_lodSweepCursor + maxInstancesPerFrame, numInstances);
+    for (u32 instanceID = _lodSweepCursor; instanceID < sweepEnd; instanceID++)
+    {
+        InstanceData& instanceData = _instanceDatas[instanceID];
+        if (instanceData.modelID >= numModels)
+            continue;
+
+        const ModelManifest& manifest = _modelManifests[instanceData.modelID];
+
+        u32 lodLevel = 0;
+        if (lodEnabled && manifest.numLods > 0)
+        {
+            const mat4x4& transformMatrix = _instanceMatrices[instanceID];
+            const Model::ComplexModel::CullingData& cullingData = _cullingDatas[instanceData.modelID];
+
+            f32 scale = glm::max(glm::length(vec3(transformMatrix[0])), glm::max(glm::length(vec3(transformMatrix[1])), glm::length(vec3(transformMatrix[2]))));
+            f32 radius = glm::length(vec3(cullingData.extents)) * scale;
+            vec3 center = vec3(transformMatrix * vec4(vec3(cullingData.center), 1.0f));
+
+            f32 distance = glm::max(glm::distance(center, cameraPos) - radius, 1.0f);
+            f32 projectedRadius = radius / distance * pixelsPerUnit;
+
+            for (u32 level = 1; level <= manifest.numLods; level++)
+            {
+                f32 allowedPixelError = (level > instanceData.lodLevel) ? maxPixelError * LOD_COARSEN_HYSTERESIS : maxPixelError;
+                if (manifest.lodErrors[level - 1] * projectedRadius > allowedPixelError)
+                    break;
+
+                lodLevel = level;
+            }
+        }
+
+        if (lodLevel == instanceData.lodLevel)
+            continue;
+
+        instanceData.lodLevel = lodLevel;
+        _instanceDatas.SetDirtyElement(instanceID);
+        MarkInstanceRefsDirty(instanceID);
+
+        // Cached shadow pages still hold the previous LOD's silhouette
+        QueueShadowInvalidation(instanceID, _instanceMatrices[instanceID]);
+
+        numLodChanges++;
+        if (numLodChanges == maxLodChangesPerFrame)
+        {
+            // The next frame picks up the sweep right after this instance
+            sweepEnd = instanceID + 1;
+            break;
+        }
+    }
+
+    _lodSweepCursor = (sweepEnd < numInstances) ? sweepEnd : 0;
+    TracyPlot("Model LOD Changes", static_cast<i64>(numLodChanges));
+}
+
+void ModelRenderer::CancelTextureStreamTasks()
+{
+    ZoneScopedN("ModelRenderer::CancelTextureStreamTasks");
+
+    if (!_activeTextureStreamTasks.empty())
+    {
+        enki::TaskScheduler* taskScheduler = ServiceLocator::GetTaskScheduler();
+        for (const std::unique_ptr<ModelTextureStreamTask>& task : _activeTextureStreamTasks)
+            taskScheduler->WaitforTask(task.get());
+
+        _activeTextureStreamTasks.clear();
+    }
+
+    TextureStreamResult result;
+    while (_textureStreamResults.try_dequeue(result)) {}
+}
+
+bool ModelRenderer::UploadStreamedTexture(u64 textureHash, TextureStreamer::Level level, const void* data, size_t size, u32& arrayIndex)
+{
+    ZoneScopedN("Upload Model Texture");
+
+    Renderer::DataTextureDesc textureDesc;
+    textureDesc.hash = level == TextureStreamer::Level::Low ? textureHash ^ LOW_MIP_TEXTURE_HASH_SALT : textureHash;
+    textureDesc.data = reinterpret_cast<const u8*>(data);
+    textureDesc.size = size;
+
+    // Each version is a texture of its own so an evicted one can be unloaded, the array only points at it
+    Renderer::TextureID textureID = _renderer->LoadDataTexture(textureDesc);
+    if (textureID == Renderer::TextureID::Invalid())
+        return false;
+
+    size_t textureArrayIndex = _renderer->AddTextureToArray(textureID, _textures);
+    NC_ASSERT(textureArrayIndex < Renderer::Settings::MAX_TEXTURES, "ModelRenderer : Texture streaming overflowed the {0} textures we have support for", Renderer::Settings::MAX_TEXTURES);
+
+    arrayIndex = static_cast<u32>(textureArrayIndex);
+    _streamedTextureIDs[arrayIndex] = textureID;
+
+    return true;
+}
+
+void ModelRenderer::SetStreamedTextureArrayIndex(u64 textureHash, u32 arrayIndex)
+{
+    auto usersItr = _streamedTextureUsers.find(textureHash);
+    if (usersItr == _streamedTextureUsers.end())
+        return;
+
+    // Texture units that were since replaced with another texture are dropped here
+    std::vector<u64>& textureUnitAddresses = usersItr->second.textureUnitAddresses;
+    std::erase_if(textureUnitAddresses, [this, textureHash](u64 textureUnitAddress)
+    {
+        auto addressItr = _textureUnitAddressToStreamedTexture.find(textureUnitAddress);
+        return addressItr == _textureUnitAddressToStreamedTexture.end() || addressItr->second != textureHash;
+    });
+
+    for (u64 textureUnitAddress : textureUnitAddresses)
+    {
+        u32 textureUnitOffset = textureUnitAddress & 0xFFFFFFFF;
+        u32 textureIndex = (textureUnitAddress >> 32) & 0xFFFFFFFF;
+
+        _textureUnits[textureUnitOffset].textureIds[textureIndex] = arrayIndex;
+        _dirtyTextureUnitOffsets.insert(textureUnitOffset);
+    }
+}
+
+void ModelRenderer::ReleaseStreamedTexture(u64 textureHash, u32 arrayIndex)
+{
+    (void)textureHash;
+
+    auto itr = _streamedTextureIDs.find(arrayIndex);
+    if (itr == _streamedTextureIDs.end())
+        return;
+
+    // The texture units were repointed to the low version just before this, but frames still in flight may sample the
+    // full one. The array slot stays behind either way since the renderer only ever appends to an array
+    _pendingStreamedTextureUnloads.push_back({ itr->second, STREAMED_TEXTURE_UNLOAD_DELAY_FRAMES });
+    _streamedTextureIDs.erase(itr);
+
+    _numRetiredTextureSlots++;
+}
+
 void ModelRenderer::AddOccluderPass(Renderer::RenderGraph* renderGraph, RenderResources& resources, u8 frameIndex)
 {
     ZoneScoped;
@@ -1796,6 +2191,7 @@ void ModelRenderer::Reserve(const ReserveInfo& reserveInfo)
         ZoneScopedN("Reserve Model Geometry");
         _vertices.Reserve(reserveInfo.numVertices);
         _indices.Reserve(reserveInfo.numIndices);
+        _meshlets.Reserve(reserveInfo.numMeshlets);
     }
 
     {
@@ -1918,6 +2314,31 @@ u32 ModelRenderer::CommitPreparedModel(const ModelLoading::PreparedRenderModel&
         }
     }
 
+    // Add meshlets
+    {
+        ZoneScopedN("Add Meshlet Data");
+
+        modelManifest.numMeshlets = static_cast<u32>(preparedModel.meshlets.size());
+        modelManifest.meshletOffset = modelOffsets.meshletsStartIndex;
+
+        if (modelManifest.numMeshlets)
+        {
+            if (modelManifest.meshletOffset + preparedModel.meshlets.size() > _meshlets.Count())
+            {
+                NC_LOG_CRITICAL("ModelRenderer : Tried to copy meshlets outside array");
+            }
+
+            // Prepared meshlets are relative to the model like its draw calls
+            for (u32 i = 0; i < modelManifest.numMeshlets; i++)
+            {
+                ModelLoading::PreparedMeshlet& meshlet = _meshlets[modelManifest.meshletOffset + i];
+                meshlet = preparedModel.meshlets[i];
+                meshlet.firstIndex += modelManifest.indexOffset;
+                meshlet.vertexOffset += modelManifest.vertexOffset;
+            }
+        }
+    }
+
     // Add TextureUnits and DrawCalls
     {
         ZoneScopedN("Add TextureUnits and DrawCalls");
@@ -1925,11 +2346,15 @@ u32 ModelRenderer::CommitPreparedModel(const ModelLoading::PreparedRenderModel&
         modelManifest.numOpaqueDrawCalls = preparedModel.reserveInfo.numOpaqueDrawCalls;
         modelManifest.numTransparentDrawCalls = preparedModel.reserveInfo.numTransparentDrawCalls;
 
+        modelManifest.numLods = std::min(preparedModel.numLods, MODEL_MAX_LODS);
+        std::copy_n(preparedModel.lodErrors, MODEL_MAX_LODS, modelManifest.lodErrors);
+
         DrawCallOffsets drawCallOffsets;
         AllocateDrawCalls(modelOffsets.modelIndex, drawCallOffsets);
 
         modelManifest.opaqueDrawCallOffset = drawCallOffsets.opaqueDrawCallStartIndex;
         modelManifest.transparentDrawCallOffset = drawCallOffsets.transparentDrawCallStartIndex;
+        modelManifest.lodDrawCallOffset = drawCallOffsets.opaqueLodDrawCallStartIndex;
 
         const Renderer::GPUVector<Renderer::IndexedIndirectDraw>& opaqueDrawCalls = _opaqueCullingResources.GetDrawCalls();
         const Renderer::GPUVector<DrawCallData>& opaqueDrawCallDatas = _opaqueCullingResources.GetDrawCallDatas();
@@ -1966,6 +2391,7 @@ u32 ModelRenderer::CommitPreparedModel(const ModelLoading::PreparedRenderModel&
                 .textureUnitOffset = textureUnitsOffsets.textureUnitsStartIndex + preparedTextureLoadRequest.textureUnitOffset,
                 .textureIndex = preparedTextureLoadRequest.textureIndex,
                 .textureHash = preparedTextureLoadRequest.textureHash,
+                .modelID = modelOffsets.modelIndex,
             });
         }
 
@@ -1992,6 +2418,24 @@ u32 ModelRenderer::CommitPreparedModel(const ModelLoading::PreparedRenderModel&
             //drawCallData.baseInstanceLookupOffset = 0; // Is set during Compact
             drawCallData.modelID = modelOffsets.modelIndex;
 
+            // LOD draws only differ in their indices, the textures and group come from the full detail draw
+            if (!renderBatch.isTransparent)
+            {
+                for (u32 level = 0; level < modelManifest.numLods; level++)
+                {
+                    u32 lodDrawCallID = modelManifest.lodDrawCallOffset + (level * modelManifest.numOpaqueDrawCalls) + numAddedDrawCalls;
+
+                    Renderer::IndexedIndirectDraw& lodDrawCall = opaqueDrawCalls[lodDrawCallID];
+                    lodDrawCall.indexCount = renderBatch.lods[level].indexCount;
+                    lodDrawCall.firstIndex = modelManifest.indexOffset + renderBatch.lods[level].firstIndex;
+                    lodDrawCall.vertexOffset = drawCall.vertexOffset;
+                    lodDrawCall.firstInstance = 0;
+                    lodDrawCall.instanceCount = 0;
+
+                    opaqueDrawCallDatas[lodDrawCallID].modelID = modelOffsets.modelIndex;
+                }
+            }
+
             TextureDataOffsets textureDataOffsets;
             AllocateTextureData(1, textureDataOffsets);
 
@@ -2201,6 +2645,7 @@ u32 ModelRenderer::AddInstance(entt::entity entityID, u32 modelID, Model::Comple
         InstanceData& instanceData = _instanceDatas[instanceOffsets.instanceIndex];
         instanceData.modelID = modelID;
         instanceData.modelVertexOffset = manifest.vertexOffset;
+        instanceData.lodLevel = 0;
 
         if (manifest.isAnimated)
         {
@@ -2249,7 +2694,7 @@ u32 ModelRenderer::AddInstance(entt::entity entityID, u32 modelID, Model::Comple
     // A spawned static caster must invalidate the cached static shadow pages under it
     QueueShadowInvalidation(instanceOffsets.instanceIndex, transformMatrix);
 
-    _instancesDirty = true;
+    MarkInstanceRefsDirty(instanceOffsets.instanceIndex);
 
     return instanceOffsets.instanceIndex;
 }
@@ -2295,7 +2740,7 @@ void ModelRenderer::RemoveInstance(u32 instanceID)
     instanceManifest.transparent = false;
     instanceManifest.skybox = false;
     instanceManifest.enabledGroupIDs.clear();
-    _instancesDirty = true;
+    MarkInstanceRefsDirty(instanceID);
 }
 
 void ModelRenderer::ModifyInstance(entt::entity entityID, u32 instanceID, u32 modelID, Model::ComplexModel* model, const mat4x4& transformMatrix, u64 displayInfoPacked)
@@ -2338,6 +2783,7 @@ void ModelRenderer::ModifyInstance(entt::entity entityID, u32 instanceID, u32 mo
     {
         instanceData.modelID = modelID;
         instanceData.modelVertexOffset = newManifest.vertexOffset;
+        instanceData.lodLevel = 0;
 
         if (newManifest.isAnimated)
         {
@@ -2387,7 +2833,7 @@ void ModelRenderer::ModifyInstance(entt::entity entityID, u32 instanceID, u32 mo
         MakeInstanceSkybox(instanceID, instanceManifest, true);
     }
 
-    _instancesDirty = true;
+    MarkInstanceRefsDirty(instanceID);
 }
 
 void ModelRenderer::ReplaceTextureUnits(entt::entity entityID, u32 modelID, Model::ComplexModel* model, u32 instanceID, u64 displayInfoPacked)
@@ -2694,12 +3140,13 @@ void ModelRenderer::ReplaceTextureUnits(entt::entity entityID, u32 modelID, Mode
                         }
                         else if (creatureDisplayInfoExtra)
                         {
+                            // Streamed like the other model textures, nothing composites this hair so it skips the customization textures
                             if (unitRace != GameDefine::UnitRace::None && gender != GameDefine::UnitGender::None)
                             {
-                                Renderer::TextureID hairTextureID;
-                                if (ECSUtil::UnitCustomization::GetHairTexture(unitCustomizationSingleton, unitRace, gender, creatureDisplayInfoExtra->hairStyleID, creatureDisplayInfoExtra->hairColorID, hairTextureID))
+                                u64 hairTextureHash;
+                                if (ECSUtil::UnitCustomization::GetHairTextureHash(unitCustomizationSingleton, unitRace, gender, creatureDisplayInfoExtra->hairStyleID, creatureDisplayInfoExtra->hairColorID, hairTextureHash))
                                 {
-                                    _textureUnits[textureUnitOffset].textureIds[j] = static_cast<u32>(_renderer->AddTextureToArray(hairTextureID, _textures));
+                                    textureHash = hairTextureHash;
                                 }
                             }
                         }
@@ -2736,6 +3183,7 @@ void ModelRenderer::ReplaceTextureUnits(entt::entity entityID, u32 modelID, Mode
                             .textureUnitOffset = textureUnitOffset,
                             .textureIndex = j,
                             .textureHash = textureHash,
+                            .modelID = modelID,
                         };
 
                         _textureLoadRequests.enqueue(textureLoadRequest);
@@ -3293,6 +3741,9 @@ void ModelRenderer::CreatePermanentResources()
         _indices.SetDebugName("ModelIndexBuffer");
         _indices.SetUsage(Renderer::BufferUsage::INDEX_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER);
 
+        _meshlets.SetDebugName("ModelMeshletBuffer");
+        _meshlets.SetUsage(Renderer::BufferUsage::STORAGE_BUFFER);
+
         _textureDatas.SetDebugName("ModelTextureDataBuffer");
         _textureDatas.SetUsage(Renderer::BufferUsage::STORAGE_BUFFER);
 
@@ -3584,6 +4035,7 @@ void ModelRenderer::AllocateModel(const ModelLoading::PreparedRenderModel& prepa
 
     offsets.verticesStartIndex = _vertices.AddCount(static_cast<u32>(preparedModel.vertices.size()));
     offsets.indicesStartIndex = _indices.AddCount(static_cast<u32>(preparedModel.indices.size()));
+    offsets.meshletsStartIndex = _meshlets.AddCount(static_cast<u32>(preparedModel.meshlets.size()));
 
     offsets.decorationSetStartIndex = static_cast<u32>(_modelDecorationSets.size());
     _modelDecorationSets.resize(offsets.decorationSetStartIndex + preparedModel.decorationSets.size());
@@ -3651,6 +4103,11 @@ void ModelRenderer::AllocateDrawCalls(u32 modelID, DrawCallOffsets& offsets)
 
     offsets.opaqueDrawCallStartIndex = _opaqueCullingResources.AddCount(manifest.numOpaqueDrawCalls);
     offsets.transparentDrawCallStartIndex = _transparentCullingResources.AddCount(manifest.numTransparentDrawCalls);
+
+    if (manifest.numLods > 0)
+    {
+        offsets.opaqueLodDrawCallStartIndex = _opaqueCullingResources.AddCount(manifest.numOpaqueDrawCalls * manifest.numLods);
+    }
 }
 
 void ModelRenderer::DeallocateAnimation(u32 boneStartIndex, u32 numBones, u32 textureTransformStartIndex, u32 numTextureTransforms)
@@ -3697,6 +4154,12 @@ void ModelRenderer::MakeInstanceTransparent(u32 instanceID, InstanceManifest& in
         }
 
         modelManifest.hasTemporarilyTransparentDrawCalls = true;
+
+        // The temporarily transparent draws change which transparent draws every other instance of the model goes into
+        for (u32 modelInstanceID : modelManifest.instances)
+        {
+            MarkInstanceRefsDirty(modelInstanceID);
+        }
     }
 
     DisplayInfoManifest* displayInfoManifest = instanceManifest.isDynamic ? &_uniqueDisplayInfoManifests[instanceManifest.displayInfoPacked] : &_displayInfoManifests[instanceManifest.displayInfoPacked];
@@ -3831,173 +4294,254 @@ void ModelRenderer::MakeInstanceSkybox(u32 instanceID, InstanceManifest& instanc
     }
 }
 
-void ModelRenderer::CompactInstanceRefs()
+void ModelRenderer::MarkInstanceRefsDirty(u32 instanceID)
 {
-    ZoneScopedN("ModelRenderer::CompactInstanceRefs");
+    _dirtyInstanceRefQueue.enqueue(instanceID);
+    _instancesDirty = true;
+}
+
+void ModelRenderer::GatherInstanceDrawRefs(u32 cullingResourceIndex, u32 instanceID, std::vector<InstanceRefTable::DrawRef>& drawRefs)
+{
+    drawRefs.clear();
 
-    if (!_instancesDirty)
+    bool isTransparent = cullingResourceIndex == 1 || cullingResourceIndex == 3;
+    bool isSkybox = cullingResourceIndex >= 2;
+
+    const InstanceManifest& instanceManifest = _instanceManifests[instanceID];
+
+    // Check if this instance is visible
+    if (!instanceManifest.visible)
         return;
 
-    // Create array of culling resources that we can loop over
-    CullingResourcesIndexed<DrawCallData>* cullingResources[] = {
-        &_opaqueCullingResources,
-        &_transparentCullingResources,
-        &_opaqueSkyboxCullingResources,
-        &_transparentSkyboxCullingResources
-    };
+    // Don't draw transparent instances in opaque draw calls
+    if (instanceManifest.transparent && !isTransparent)
+        return;
 
-    static bool cullingResourcesIsTransparent[] = {
-        false,
-        true,
-        false,
-        true
-    };
+    if (instanceManifest.modelID >= _modelManifests.size())
+        return;
 
-    static bool cullingResourcesIsSkybox[] = {
-        false,
-        false,
-        true,
-        true
-    };
+    const ModelManifest& manifest = _modelManifests[instanceManifest.modelID];
 
-    static u32 reserveSizes[] = {
-        1000000,
-        100000,
-        1000,
-        1000
-    };
+    // Removed instances and instances on the other side of the skybox split have no refs in this culling resource
+    {
+        std::scoped_lock lock(*_modelManifestsInstancesMutexes[instanceManifest.modelID]);
+
+        auto& instances = (isSkybox) ? manifest.skyboxInstances : manifest.instances;
+        if (!instances.contains(instanceID))
+            return;
+    }
+
+    // Select the correct drawIDToTextureDataID and drawIDToGroupID based on isSkybox and isTransparent
+    const robin_hood::unordered_map<u32, u32>& opaqueDrawIDToTextureDataID = (isSkybox) ? manifest.opaqueSkyboxDrawIDToTextureDataID : manifest.opaqueDrawIDToTextureDataID;
+    const robin_hood::unordered_map<u32, u32>& transparentDrawIDToTextureDataID = (isSkybox) ? manifest.transparentSkyboxDrawIDToTextureDataID : manifest.transparentDrawIDToTextureDataID;
+    const robin_hood::unordered_map<u32, u32>& drawIDToTextureDataID = (isTransparent) ? transparentDrawIDToTextureDataID : opaqueDrawIDToTextureDataID;
+
+    const robin_hood::unordered_map<u32, u32>& opaqueDrawIDToGroupID = (isSkybox) ? manifest.opaqueSkyboxDrawIDToGroupID : manifest.opaqueDrawIDToGroupID;
+    const robin_hood::unordered_map<u32, u32>& transparentDrawIDToGroupID = (isSkybox) ? manifest.transparentSkyboxDrawIDToGroupID : manifest.transparentDrawIDToGroupID;
+    const robin_hood::unordered_map<u32, u32>& drawIDToGroupID = (isTransparent) ? transparentDrawIDToGroupID : opaqueDrawIDToGroupID;
 
-    // Loop over all the culling resources
-    for(u32 i = 0; i < 4; i++)
+    // Select the correct instanceDrawIDToTextureDataID based on isSkybox and isTransparent
+    const robin_hood::unordered_map<u32, u32>* instanceDrawIDToTextureDataID = nullptr;
+    if (instanceManifest.displayInfoPacked != std::numeric_limits<u64>().max())
     {
-        ZoneScopedN("CullingResource");
+        DisplayInfoManifest* displayInfoManifest = instanceManifest.isDynamic ? &_uniqueDisplayInfoManifests[instanceManifest.displayInfoPacked] : &_displayInfoManifests[instanceManifest.displayInfoPacked];
 
-        auto& cullingResource = cullingResources[i];
-        bool isTransparent = cullingResourcesIsTransparent[i];
-        bool isSkybox = cullingResourcesIsSkybox[i];
-        u32 numTotalInstances = 0;
+        const robin_hood::unordered_map<u32, u32>& displayInfoManifestOpaqueDrawIDToTextureDataID = (isSkybox) ? displayInfoManifest->opaqueSkyboxDrawIDToTextureDataID : displayInfoManifest->opaqueDrawIDToTextureDataID;
+        const robin_hood::unordered_map<u32, u32>& displayInfoManifestTransparentDrawIDToTextureDataID = (isSkybox) ? displayInfoManifest->transparentSkyboxDrawIDToTextureDataID : displayInfoManifest->transparentDrawIDToTextureDataID;
+
+        instanceDrawIDToTextureDataID = (isTransparent || instanceManifest.transparent) ? &displayInfoManifestTransparentDrawIDToTextureDataID : &displayInfoManifestOpaqueDrawIDToTextureDataID;
+    }
 
-        auto& instanceRefs = cullingResource->GetInstanceRefs();
+    // Only the regular opaque draws have LODs
+    u32 lodLevel = (!isSkybox && !isTransparent) ? std::min(_instanceDatas[instanceID].lodLevel, manifest.numLods) : 0;
+
+    auto addDraws = [&](u32 drawCallOffset, u32 numDrawCalls)
+    {
+        for (u32 drawID = drawCallOffset; drawID < drawCallOffset + numDrawCalls; drawID++)
         {
-            ZoneScopedN("Clear InstanceRefs");
-            instanceRefs.Clear();
-            instanceRefs.Reserve(reserveSizes[i]);
-        }
+            // Don't draw opaque instances in temporarily transparent draw calls
+            if (manifest.hasTemporarilyTransparentDrawCalls && isTransparent && !instanceManifest.transparent && drawID >= manifest.transparentDrawCallOffset)
+            {
+                if (!manifest.originallyTransparentDrawIDs.contains(drawID))
+                    continue;
+            }
 
-        const auto& draws = cullingResource->GetDrawCalls();
-        const auto& drawDatas = cullingResource->GetDrawCallDatas();
+            // Check if this instance has this draw enabled
+            u32 groupID = drawIDToGroupID.at(drawID);
+            if (groupID != 0 && !instanceManifest.enabledGroupIDs.contains(groupID))
+                continue;
 
-        u32 numDraws = draws.Count();
-        for (u32 drawID = 0; drawID < numDraws; drawID++)
+            InstanceRefTable::DrawRef& drawRef = drawRefs.emplace_back();
+            drawRef.drawID = (lodLevel > 0) ? manifest.lodDrawCallOffset + ((lodLevel - 1) * manifest.numOpaqueDrawCalls) + (drawID - drawCallOffset) : drawID;
+            drawRef.extraID = (instanceDrawIDToTextureDataID) ? instanceDrawIDToTextureDataID->at(drawID) : drawIDToTextureDataID.at(drawID);
+        }
+    };
+
+    if (!isSkybox)
+    {
+        if (!isTransparent)
         {
-            ZoneScopedN("Draw");
+            addDraws(manifest.opaqueDrawCallOffset, manifest.numOpaqueDrawCalls);
+        }
+        else
+        {
+            addDraws(manifest.transparentDrawCallOffset, manifest.numTransparentDrawCalls);
 
-            Renderer::IndexedIndirectDraw& draw = draws[drawID];
-            DrawCallData& drawData = drawDatas[drawID];
-            const ModelManifest& manifest = _modelManifests[drawData.modelID];
+            if (manifest.hasTemporarilyTransparentDrawCalls)
+            {
+                addDraws(manifest.temporarilyTransparentDrawCallOffset, manifest.numOpaqueDrawCalls);
+            }
+        }
+    }
+    else if (manifest.hasSkyboxDrawCalls)
+    {
+        if (!isTransparent)
+        {
+            addDraws(manifest.opaqueSkyboxDrawCallOffset, manifest.numOpaqueDrawCalls);
+        }
+        else
+        {
+            addDraws(manifest.transparentSkyboxDrawCallOffset, manifest.numTransparentDrawCalls);
+        }
+    }
+}
 
-            // Select the correct drawIDToTextureDataID and drawIDToGroupID based on isSkybox and isTransparent
-            const robin_hood::unordered_map<u32, u32>& opaqueDrawIDToTextureDataID = (isSkybox) ? manifest.opaqueSkyboxDrawIDToTextureDataID : manifest.opaqueDrawIDToTextureDataID;
-            const robin_hood::unordered_map<u32, u32>& transparentDrawIDToTextureDataID = (isSkybox) ? manifest.transparentSkyboxDrawIDToTextureDataID : manifest.transparentDrawIDToTextureDataID;
-            const robin_hood::unordered_map<u32, u32>& drawIDToTextureDataID = (isTransparent) ? transparentDrawIDToTextureDataID : opaqueDrawIDToTextureDataID;
+void ModelRenderer::UploadInstanceRefTable(InstanceRefTable& instanceRefTable, CullingResourcesIndexed<DrawCallData>& cullingResources)
+{
+    auto& instanceRefs = cullingResources.GetInstanceRefs();
 
-            const robin_hood::unordered_map<u32, u32>& opaqueDrawIDToGroupID = (isSkybox) ? manifest.opaqueSkyboxDrawIDToGroupID : manifest.opaqueDrawIDToGroupID;
-            const robin_hood::unordered_map<u32, u32>& transparentDrawIDToGroupID = (isSkybox) ? manifest.transparentSkyboxDrawIDToGroupID : manifest.transparentDrawIDToGroupID;
-            const robin_hood::unordered_map<u32, u32>& drawIDToGroupID = (isTransparent) ? transparentDrawIDToGroupID : opaqueDrawIDToGroupID;
+    u32 numSlots = instanceRefTable.GetNumSlots();
+    u32 numUploadedSlots = static_cast<u32>(instanceRefs.Count());
+    if (numSlots > numUploadedSlots)
+    {
+        instanceRefs.AddCount(numSlots - numUploadedSlots);
+    }
+    else if (numSlots < numUploadedSlots)
+    {
+        instanceRefs.Remove(numSlots, numUploadedSlots - numSlots);
+    }
 
-            u32 defaultTextureDataID = drawIDToTextureDataID.at(drawID);
+    const std::vector<InstanceRef>& refs = instanceRefTable.GetRefs();
+    auto& draws = cullingResources.GetDrawCalls();
+    auto& drawDatas = cullingResources.GetDrawCallDatas();
 
-            auto& instances = (isSkybox) ? manifest.skyboxInstances : manifest.instances;
+    auto uploadDraw = [&](u32 drawID)
+    {
+        const InstanceRefTable::DrawRange& drawRange = instanceRefTable.GetDrawRange(drawID);
 
-            u32 numTotalInstancesInModel = static_cast<u32>(instances.size());
-            {
-                ZoneScopedN("AddCount");
-                instanceRefs.AddCount(numTotalInstancesInModel);
-            }
+        Renderer::IndexedIndirectDraw& draw = draws[drawID];
+        draw.firstInstance = drawRange.offset;
+        draw.instanceCount = drawRange.count;
 
-            u32 numEnabledInstancesInDraw = 0;
+        DrawCallData& drawData = drawDatas[drawID];
+        drawData.baseInstanceLookupOffset = drawRange.offset;
+    };
 
-            // Models with default transparency
-            for(auto& instanceID : instances)
-            {
-                ZoneScopedN("Instance");
-                u32 textureDataID = defaultTextureDataID;
+    if (instanceRefTable.IsFullyDirty())
+    {
+        for (u32 slot = 0; slot < numSlots; slot++)
+        {
+            instanceRefs[slot] = refs[slot];
+        }
+        instanceRefs.SetDirty();
 
-                InstanceManifest& instanceManifest = _instanceManifests[instanceID];
+        u32 numDraws = instanceRefTable.GetNumDraws();
+        for (u32 drawID = 0; drawID < numDraws; drawID++)
+        {
+            uploadDraw(drawID);
+        }
+        cullingResources.SetDirty();
+    }
+    else
+    {
+        for (u32 slot : instanceRefTable.GetDirtyRefSlots())
+        {
+            if (slot >= numSlots)
+                continue;
 
-                // Check if this instance is visible
-                if (!instanceManifest.visible)
-                    continue;
+            instanceRefs[slot] = refs[slot];
+            instanceRefs.SetDirtyElement(slot);
+        }
 
-                // Don't draw transparent instances in opaque draw calls
-                if (instanceManifest.transparent && !isTransparent)
-                    continue;
+        for (u32 drawID : instanceRefTable.GetDirtyDraws())
+        {
+            uploadDraw(drawID);
+            cullingResources.SetDirtyElement(drawID);
+        }
+    }
 
-                // Don't draw opaque instances in temporarily transparent draw calls
-                if (manifest.hasTemporarilyTransparentDrawCalls)
-                {
-                    bool originallyTransparent = manifest.originallyTransparentDrawIDs.contains(drawID);
-                    if (!originallyTransparent)
-                    {
-                        if (!instanceManifest.transparent && isTransparent && !originallyTransparent && drawID >= manifest.transparentDrawCallOffset)
-                            continue;
-                    }
-                }
+    instanceRefTable.ResetDirty();
+}
 
-                // Check if this instance has this draw enabled
-                {
-                    u32 groupID = drawIDToGroupID.at(drawID);
+void ModelRenderer::CompactInstanceRefs()
+{
+    ZoneScopedN("ModelRenderer::CompactInstanceRefs");
 
-                    if (groupID != 0)
-                    {
-                        if (!instanceManifest.enabledGroupIDs.contains(groupID))
-                            continue;
-                    }
-                }
+    // Create array of culling resources that we can loop over, matches the order of _instanceRefTables
+    CullingResourcesIndexed<DrawCallData>* cullingResources[NumInstanceRefTables] = {
+        &_opaqueCullingResources,
+        &_transparentCullingResources,
+        &_opaqueSkyboxCullingResources,
+        &_transparentSkyboxCullingResources
+    };
 
-                {
-                    ZoneScopedN("Setup InstanceRef");
+    // Draws appended since last frame start out empty, copied draws still carry the counts of the draws they came from
+    bool hasNewDraws = false;
+    for (u32 i = 0; i < NumInstanceRefTables; i++)
+    {
+        u32 numDrawCalls = cullingResources[i]->GetDrawCallCount();
+        if (numDrawCalls != _instanceRefTables[i].GetNumDraws())
+        {
+            _instanceRefTables[i].SetNumDraws(numDrawCalls);
+            hasNewDraws = true;
+        }
+    }
 
-                    if (instanceManifest.displayInfoPacked != std::numeric_limits<u64>().max())
-                    {
-                        DisplayInfoManifest* displayInfoManifest = instanceManifest.isDynamic ? &_uniqueDisplayInfoManifests[instanceManifest.displayInfoPacked] : &_displayInfoManifests[instanceManifest.displayInfoPacked];
+    u32 dirtyInstanceID;
+    while (_dirtyInstanceRefQueue.try_dequeue(dirtyInstanceID))
+    {
+        _dirtyInstanceRefIDs.insert(dirtyInstanceID);
+    }
 
-                        // Select the correct instanceDrawIDToTextureDataID based on isSkybox and isTransparent
-                        const robin_hood::unordered_map<u32, u32>& displayInfoManifestOpaqueDrawIDToTextureDataID = (isSkybox) ? displayInfoManifest->opaqueSkyboxDrawIDToTextureDataID : displayInfoManifest->opaqueDrawIDToTextureDataID;
-                        const robin_hood::unordered_map<u32, u32>& displayInfoManifestTransparentDrawIDToTextureDataID = (isSkybox) ? displayInfoManifest->transparentSkyboxDrawIDToTextureDataID : displayInfoManifest->transparentDrawIDToTextureDataID;
+    if (!hasNewDraws && _dirtyInstanceRefIDs.empty())
+        return;
 
-                        const robin_hood::unordered_map<u32, u32>& instanceDrawIDToTextureDataID = (isTransparent || instanceManifest.transparent) ? displayInfoManifestTransparentDrawIDToTextureDataID : displayInfoManifestOpaqueDrawIDToTextureDataID;
-                        textureDataID = instanceDrawIDToTextureDataID.at(drawID);
-                    }
+    TracyPlot("Model Dirty InstanceRef Instances", static_cast<i64>(_dirtyInstanceRefIDs.size()));
 
-                    InstanceRef& instanceRef = instanceRefs[numTotalInstances + numEnabledInstancesInDraw];
-                    instanceRef.drawID = drawID;
-                    instanceRef.instanceID = instanceID;
-                    instanceRef.extraID = textureDataID;
-                    numEnabledInstancesInDraw++;
-                }
-            }
+    {
+        ZoneScopedN("Update InstanceRefs");
 
+        // Only the refs of instances that changed are touched, everything else keeps its slot
+        for (u32 instanceID : _dirtyInstanceRefIDs)
+        {
+            for (u32 i = 0; i < NumInstanceRefTables; i++)
             {
-                ZoneScopedN("Setup Draw");
-                draw.firstInstance = numTotalInstances;
-                draw.instanceCount = numEnabledInstancesInDraw;
-
-                drawData.baseInstanceLookupOffset = numTotalInstances;
-                numTotalInstances += numEnabledInstancesInDraw;
+                GatherInstanceDrawRefs(i, instanceID, _instanceDrawRefsWork);
+                _instanceRefTables[i].SetInstanceRefs(instanceID, _instanceDrawRefsWork);
             }
-
         }
 
-        u32 numInstanceRefs = instanceRefs.Count();
-        if (numInstanceRefs > numTotalInstances)
+        _dirtyInstanceRefIDs.clear();
+
+        // Map loads touch most of the table at once, uploading it whole is cheaper then and packs it again
+        for (u32 i = 0; i < NumInstanceRefTables; i++)
         {
-            ZoneScopedN("Remove InstanceRefs");
-            instanceRefs.Remove(numTotalInstances, numInstanceRefs - numTotalInstances);
+            if (_instanceRefTables[i].ShouldRebuild())
+                _instanceRefTables[i].Rebuild();
         }
+    }
 
-        cullingResource->SetDirty();
+    {
+        ZoneScopedN("Upload InstanceRefs");
+
+        for (u32 i = 0; i < NumInstanceRefTables; i++)
+        {
+            UploadInstanceRefTable(_instanceRefTables[i], *cullingResources[i]);
+        }
     }
+
+    // Draw instance counts changed, make SyncToGPU recount them
+    _instancesDirty = true;
 }
 
 void ModelRenderer::SyncToGPU()
@@ -4046,6 +4590,12 @@ void ModelRenderer::SyncToGPU()
         }
     }
 
+    // Sync Meshlet buffer to GPU, nothing reads it through the descriptor sets yet
+    {
+        ZoneScopedN("Sync Model Meshlets To GPU");
+        _meshlets.SyncToGPU(_renderer);
+    }
+
     // Sync TextureDatas buffer to GPU
     {
         ZoneScopedN("Sync Model Texture Data To GPU");
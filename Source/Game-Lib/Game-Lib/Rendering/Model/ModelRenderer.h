@@ -2,6 +2,7 @@
 #include "Game-Lib/Rendering/CulledRenderer.h"
 #include "Game-Lib/Rendering/CullingResources.h"
 #include "Game-Lib/Rendering/Model/ModelLoadTypes.h"
+#include "Game-Lib/Rendering/Model/TextureStreamer.h"
 
 #include <Base/Types.h>
 #include <Base/Container/ConcurrentQueue.h>
@@ -10,6 +11,8 @@
 #include <FileFormat/Shared.h>
 #include <FileFormat/Novus/Model/ComplexModel.h>
 
+#include <Filesystem/PactStorage.h>
+
 #include <Renderer/DescriptorSet.h>
 #include <Renderer/FrameResource.h>
 #include <Renderer/GPUBuffer.h>
@@ -18,6 +21,7 @@
 #include <entt/fwd.hpp>
 #include <robinhood/robinhood.h>
 
+#include <memory>
 #include <thread>
 
 class DebugRenderer;
@@ -34,8 +38,9 @@ namespace Renderer
 }
 
 struct DrawParams;
+struct ModelTextureStreamTask;
 
-class ModelRenderer : CulledRenderer
+class ModelRenderer : CulledRenderer, private TextureStreamer::Uploader
 {
 public:
     struct ReserveInfo
@@ -49,6 +54,7 @@ public:
 
         u32 numVertices = 0;
         u32 numIndices = 0;
+        u32 numMeshlets = 0;
 
         u32 numTextureUnits = 0;
 
@@ -83,6 +89,14 @@ public:
         u32 indexOffset = 0;
         u32 numIndices = 0;
 
+        u32 meshletOffset = 0;
+        u32 numMeshlets = 0;
+
+        // LOD draws live in the opaque culling resources, numOpaqueDrawCalls per level starting at lodDrawCallOffset
+        u32 numLods = 0;
+        u32 lodDrawCallOffset = 0;
+        f32 lodErrors[MODEL_MAX_LODS] = { 0.0f }; // Relative to the bounding sphere radius
+
         u32 numBones = 0;
         u32 numTextureTransforms = 0;
 
@@ -166,7 +180,7 @@ public:
         u32 animatedVertexOffset = InvalidID;
         f32 opacity = 1.0f;
         f32 highlightIntensity = 1.0f;
-        u32 padding0;
+        u32 lodLevel = 0; // 0 is full detail, picked by projected size in UpdateInstanceLods
     };
 
     struct InstanceDataCPU
@@ -191,6 +205,19 @@ public:
         u32 textureUnitOffset = 0;
         u32 textureIndex = 0;
         u64 textureHash = 0;
+        u32 modelID = 0;
+    };
+
+    struct TextureStreamResult
+    {
+    public:
+        u64 epoch = 0;
+        TextureStreamer::LoadJob job;
+        bool success = false;
+        bool isWholeTexture = false;
+        u64 fullSize = 0;
+        std::vector<u8> lowTexture;
+        std::shared_ptr<PACT::PactFileHandle> fileHandle;
     };
 
     struct ChangeGroupRequest
@@ -260,6 +287,7 @@ private:
             u32 modelIndex = 0;
             u32 verticesStartIndex = 0;
             u32 indicesStartIndex = 0;
+            u32 meshletsStartIndex = 0;
 
             u32 decorationSetStartIndex = 0;
             u32 decorationStartIndex = 0;
@@ -294,6 +322,7 @@ private:
         public:
             u32 opaqueDrawCallStartIndex = 0;
             u32 transparentDrawCallStartIndex = 0;
+            u32 opaqueLodDrawCallStartIndex = 0;
         };
 
 public:
@@ -349,6 +378,7 @@ public:
     void RegisterMaterialPassBufferUsage(Renderer::RenderGraphBuilder& builder);
 
     Renderer::GPUVector<mat4x4>& GetInstanceMatrices() { return _instanceMatrices; }
+    Renderer::GPUVector<ModelLoading::PreparedMeshlet>& GetMeshlets() { return _meshlets; }
     const std::vector<ModelManifest>& GetModelManifests() { return _modelManifests; }
 
     // SVSM: appends world (min, max) pairs of spawned/despawned instances, returns pairs appended
@@ -379,6 +409,10 @@ public:
     u32 GetNumOccluderTriangles() { return _numOccluderDrawCalls * Terrain::CELL_NUM_TRIANGLES; }
     u32 GetNumSurvivingGeometryTriangles(u32 viewID) { return _numSurvivingDrawCalls[viewID] * Terrain::CELL_NUM_TRIANGLES; }
 
+    // Texture streaming stats
+    TextureStreamer::Stats GetTextureStreamerStats() const { return _textureStreamer.GetStats(); }
+    u32 GetNumRetiredTextureSlots() const { return _numRetiredTextureSlots; }
+
 private:
     void CreatePermanentResources();
     void CreateModelPipelines();
@@ -402,6 +436,19 @@ private:
     void QueueShadowInvalidation(u32 instanceID, const mat4x4& transformMatrix);
     void QueueShadowInvalidation(const vec3& aabbMin, const vec3& aabbMax); // For callers holding a cached AABB
 
+    void UpdateTextureStreaming();
+    void UpdateTexturePriorities(const vec3& cameraPos);
+    void UpdateInstanceLods();
+    void CancelTextureStreamTasks();
+
+    // TextureStreamer::Uploader
+    bool UploadStreamedTexture(u64 textureHash, TextureStreamer::Level level, const void* data, size_t size, u32& arrayIndex) override;
+    void SetStreamedTextureArrayIndex(u64 textureHash, u32 arrayIndex) override;
+    void ReleaseStreamedTexture(u64 textureHash, u32 arrayIndex) override;
+
+    void MarkInstanceRefsDirty(u32 instanceID);
+    void GatherInstanceDrawRefs(u32 cullingResourceIndex, u32 instanceID, std::vector<InstanceRefTable::DrawRef>& drawRefs);
+    void UploadInstanceRefTable(InstanceRefTable& instanceRefTable, CullingResourcesIndexed<DrawCallData>& cullingResources);
     void CompactInstanceRefs();
     void SyncToGPU();
 
@@ -438,6 +485,7 @@ private:
 
     Renderer::GPUVector<Model::ComplexModel::Vertex> _vertices;
     Renderer::GPUVector<u16> _indices;
+    Renderer::GPUVector<ModelLoading::PreparedMeshlet> _meshlets;
 
     Renderer::GPUVector<InstanceData> _instanceDatas;
     Renderer::GPUVector<mat4x4> _instanceMatrices;
@@ -548,7 +596,41 @@ private:
     moodycamel::ConcurrentQueue<TextureLoadRequest> _textureLoadRequests;
     std::vector<TextureLoadRequest> _textureLoadWork;
     robin_hood::unordered_set<u32> _dirtyTextureUnitOffsets;
-    robin_hood::unordered_map<u64, u32> _modelTextureHashToArrayIndex;
+
+    // Model textures are streamed in on task workers, a texture unit points at the placeholder until the low resolution
+    // version arrives and is repointed whenever the streamer swaps versions. Texture unit addresses are packed like
+    // DisplayInfoManifest::skinTextureUnits
+    struct StreamedTextureUsers
+    {
+    public:
+        std::vector<u64> textureUnitAddresses;
+        std::vector<u32> modelIDs;
+    };
+
+    TextureStreamer _textureStreamer{ this };
+    robin_hood::unordered_map<u64, StreamedTextureUsers> _streamedTextureUsers;
+    robin_hood::unordered_map<u64, u64> _textureUnitAddressToStreamedTexture; // Replaced texture units stop following their old texture
+    moodycamel::ConcurrentQueue<TextureStreamResult> _textureStreamResults;
+    std::vector<std::unique_ptr<ModelTextureStreamTask>> _activeTextureStreamTasks; // Render-thread-owned task lifetimes
+    std::vector<TextureStreamer::LoadJob> _textureStreamJobs;
+    u64 _textureStreamEpoch = 1;
+    struct PendingTextureUnload
+    {
+    public:
+        Renderer::TextureID textureID;
+        u32 framesLeft = 0;
+    };
+
+    robin_hood::unordered_map<u32, Renderer::TextureID> _streamedTextureIDs; // By array index, unloaded when evicted
+    std::vector<PendingTextureUnload> _pendingStreamedTextureUnloads;
+    u32 _numRetiredTextureSlots = 0; // Array slots of evicted versions, their textures are unloaded but the slots stay until Clear
+
+    // Screen-space size of each model's largest instance, refreshed by a sweep over a slice of the instances every frame
+    std::vector<f32> _modelTexturePriorities;
+    std::vector<f32> _modelTexturePrioritiesSweep;
+    u32 _texturePrioritySweepCursor = 0;
+
+    u32 _lodSweepCursor = 0;
 
     moodycamel::ConcurrentQueue<ChangeGroupRequest> _changeGroupRequests;
     std::vector<ChangeGroupRequest> _changeGroupWork;
@@ -573,6 +655,13 @@ private:
 
     std::atomic_bool _instancesDirty = false;
 
+    // Opaque, transparent, opaque skybox and transparent skybox, in the same order as CompactInstanceRefs loops over the culling resources
+    static constexpr u32 NumInstanceRefTables = 4;
+    InstanceRefTable _instanceRefTables[NumInstanceRefTables];
+    moodycamel::ConcurrentQueue<u32> _dirtyInstanceRefQueue;
+    robin_hood::unordered_set<u32> _dirtyInstanceRefIDs;
+    std::vector<InstanceRefTable::DrawRef> _instanceDrawRefsWork;
+
     std::mutex _modelOffsetsMutex;
     std::mutex _textureDataOffsetsMutex;
     std::mutex _textureOffsetsMutex;
@@ -0,0 +1,476 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Highest priority first, the hash keeps the order stable between equal priorities
+    bool IsHigherPriority(const std::pair<f32, u64>& a, const std::pair<f32, u64>& b)
+    {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    }
+}
+
+bool TextureStreamer::Request(u64 textureHash, f32 priority)
+{
+    auto [itr, inserted] = _textures.try_emplace(textureHash);
+    if (inserted || priority > itr->second.priority)
+        itr->second.priority = priority;
+
+    return inserted;
+}
+
+void TextureStreamer::SetPriority(u64 textureHash, f32 priority)
+{
+    auto itr = _textures.find(textureHash);
+    if (itr == _textures.end())
+        return;
+
+    itr->second.priority = priority;
+}
+
+bool TextureStreamer::GetArrayIndex(u64 textureHash, u32& arrayIndex) const
+{
+    auto itr = _textures.find(textureHash);
+    if (itr == _textures.end())
+        return false;
+
+    const StreamedTexture& texture = itr->second;
+    arrayIndex = texture.fullArrayIndex != INVALID_ARRAY_INDEX ? texture.fullArrayIndex : texture.lowArrayIndex;
+
+    return arrayIndex != INVALID_ARRAY_INDEX;
+}
+
+void TextureStreamer::CollectJobs(u32 maxJobs, std::vector<LoadJob>& jobs)
+{
+    if (maxJobs == 0)
+        return;
+
+    _lowCandidates.clear();
+    _fullCandidates.clear();
+    _evictionCandidates.clear();
+
+    for (const auto& [textureHash, texture] : _textures)
+    {
+        if (texture.hasFailed)
+            continue;
+
+        if (texture.lowArrayIndex == INVALID_ARRAY_INDEX)
+        {
+            if (!texture.isLowInFlight)
+                _lowCandidates.push_back({ texture.priority, textureHash });
+
+            continue;
+        }
+
+        if (texture.fullArrayIndex != INVALID_ARRAY_INDEX)
+        {
+            _evictionCandidates.push_back({ texture.priority, textureHash });
+            continue;
+        }
+
+        if (texture.fullSize > 0 && !texture.isFullInFlight && texture.priority >= _minUpgradePriority)
+            _fullCandidates.push_back({ texture.priority, textureHash });
+    }
+
+    std::sort(_lowCandidates.begin(), _lowCandidates.end(), IsHigherPriority);
+
+    u32 numJobs = 0;
+    for (const auto& [priority, textureHash] : _lowCandidates)
+    {
+        if (numJobs == maxJobs)
+            return;
+
+        _textures[textureHash].isLowInFlight = true;
+        _numJobsInFlight++;
+
+        jobs.push_back({ textureHash, Level::Low });
+        numJobs++;
+    }
+
+    if (_fullCandidates.empty())
+        return;
+
+    std::sort(_fullCandidates.begin(), _fullCandidates.end(), IsHigherPriority);
+
+    // Lowest priority first, upgrades only evict textures with a lower priority than their own. Candidates come in
+    // descending priority so the evictable range only ever shrinks and evicted textures are never looked at again
+    std::sort(_evictionCandidates.begin(), _evictionCandidates.end(), [](const std::pair<f32, u64>& a, const std::pair<f32, u64>& b)
+    {
+        return IsHigherPriority(b, a);
+    });
+
+    _evictionSizePrefix.resize(_evictionCandidates.size() + 1);
+    _evictionSizePrefix[0] = 0;
+    for (u32 i = 0; i < _evictionCandidates.size(); i++)
+    {
+        _evictionSizePrefix[i + 1] = _evictionSizePrefix[i] + _textures[_evictionCandidates[i].second].fullSize;
+    }
+
+    u32 numEvicted = 0;
+    for (const auto& [priority, textureHash] : _fullCandidates)
+    {
+        if (numJobs == maxJobs)
+            return;
+
+        StreamedTexture& texture = _textures[textureHash];
+
+        u64 requiredBytes = _residentBytes + _reservedBytes + texture.fullSize;
+        if (requiredBytes > _budgetBytes)
+        {
+            u64 excessBytes = requiredBytes - _budgetBytes;
+
+            auto evictableEnd = std::lower_bound(_evictionCandidates.begin() + numEvicted, _evictionCandidates.end(), priority, [](const std::pair<f32, u64>& candidate, f32 priority)
+            {
+                return candidate.first < priority;
+            });
+            u32 numEvictable = static_cast<u32>(evictableEnd - _evictionCandidates.begin());
+
+            if (_evictionSizePrefix[numEvictable] - _evictionSizePrefix[numEvicted] < excessBytes)
+                continue;
+
+            u64 evictedBytes = 0;
+            while (evictedBytes < excessBytes)
+            {
+                u64 evictedHash = _evictionCandidates[numEvicted++].second;
+                StreamedTexture& evictedTexture = _textures[evictedHash];
+
+                evictedBytes += evictedTexture.fullSize;
+                Evict(evictedHash, evictedTexture);
+            }
+        }
+
+        texture.isFullInFlight = true;
+        _reservedBytes += texture.fullSize;
+        _numJobsInFlight++;
+
+        jobs.push_back({ textureHash, Level::Full });
+        numJobs++;
+    }
+}
+
+void TextureStreamer::CompleteJob(const LoadJob& job, const void* data, size_t size, u64 fullSize, bool isWholeTexture)
+{
+    auto itr = _textures.find(job.textureHash);
+    if (itr == _textures.end())
+        return;
+
+    StreamedTexture& texture = itr->second;
+    u32 arrayIndex = INVALID_ARRAY_INDEX;
+
+    if (job.level == Level::Low)
+    {
+        if (!texture.isLowInFlight)
+            return;
+
+        texture.isLowInFlight = false;
+        _numJobsInFlight--;
+
+        if (!_uploader->UploadStreamedTexture(job.textureHash, Level::Low, data, size, arrayIndex))
+        {
+            texture.hasFailed = true;
+            return;
+        }
+
+        texture.lowArrayIndex = arrayIndex;
+        texture.lowSize = size;
+        texture.fullSize = isWholeTexture ? 0 : fullSize;
+        _residentBytes += size;
+    }
+    else
+    {
+        if (!texture.isFullInFlight)
+            return;
+
+        texture.isFullInFlight = false;
+        _reservedBytes -= texture.fullSize;
+        _numJobsInFlight--;
+
+        if (!_uploader->UploadStreamedTexture(job.textureHash, Level::Full, data, size, arrayIndex))
+        {
+            // Keep the low version rather than retrying every frame
+            texture.fullSize = 0;
+            return;
+        }
+
+        texture.fullArrayIndex = arrayIndex;
+        texture.fullSize = size;
+        _residentBytes += size;
+    }
+
+    _numUploads++;
+    _uploader->SetStreamedTextureArrayIndex(job.textureHash, arrayIndex);
+}
+
+void TextureStreamer::FailJob(const LoadJob& job)
+{
+    auto itr = _textures.find(job.textureHash);
+    if (itr == _textures.end())
+        return;
+
+    StreamedTexture& texture = itr->second;
+    if (job.level == Level::Low)
+    {
+        if (!texture.isLowInFlight)
+            return;
+
+        texture.isLowInFlight = false;
+        texture.hasFailed = true;
+    }
+    else
+    {
+        if (!texture.isFullInFlight)
+            return;
+
+        texture.isFullInFlight = false;
+        _reservedBytes -= texture.fullSize;
+        texture.fullSize = 0;
+    }
+
+    _numJobsInFlight--;
+}
+
+void TextureStreamer::Clear()
+{
+    _textures.clear();
+
+    _residentBytes = 0;
+    _reservedBytes = 0;
+
+    _numJobsInFlight = 0;
+    _numUploads = 0;
+    _numEvictions = 0;
+}
+
+TextureStreamer::Stats TextureStreamer::GetStats() const
+{
+    Stats stats;
+    stats.numTextures = static_cast<u32>(_textures.size());
+    stats.numJobsInFlight = _numJobsInFlight;
+    stats.residentBytes = _residentBytes;
+    stats.reservedBytes = _reservedBytes;
+    stats.budgetBytes = _budgetBytes;
+    stats.numUploads = _numUploads;
+    stats.numEvictions = _numEvictions;
+
+    for (const auto& [textureHash, texture] : _textures)
+    {
+        stats.numLowResident += texture.lowArrayIndex != INVALID_ARRAY_INDEX;
+        stats.numFullResident += texture.fullArrayIndex != INVALID_ARRAY_INDEX;
+    }
+
+    return stats;
+}
+
+void TextureStreamer::Evict(u64 textureHash, StreamedTexture& texture)
+{
+    _uploader->SetStreamedTextureArrayIndex(textureHash, texture.lowArrayIndex);
+    _uploader->ReleaseStreamedTexture(textureHash, texture.fullArrayIndex);
+
+    _residentBytes -= texture.fullSize;
+    texture.fullArrayIndex = INVALID_ARRAY_INDEX;
+
+    _numEvictions++;
+}
+
+namespace TextureStreaming
+{
+    namespace
+    {
+        constexpr u32 DDS_MAGIC = 0x20534444; // "DDS "
+        constexpr u32 DDS_HEADER_SIZE = 124;
+        constexpr u32 DDS_DX10_HEADER_SIZE = 20;
+
+        constexpr u32 DDSD_PITCH = 0x8;
+        constexpr u32 DDSD_LINEARSIZE = 0x80000;
+        constexpr u32 DDPF_FOURCC = 0x4;
+        constexpr u32 DDSCAPS2_CUBEMAP = 0x200;
+        constexpr u32 DDSCAPS2_VOLUME = 0x200000;
+        constexpr u32 DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+        constexpr u32 DDS_DIMENSION_TEXTURE2D = 3;
+
+        // Offsets into the header, which starts after the magic
+        constexpr u32 OFFSET_FLAGS = 4;
+        constexpr u32 OFFSET_HEIGHT = 8;
+        constexpr u32 OFFSET_WIDTH = 12;
+        constexpr u32 OFFSET_PITCH_OR_LINEAR_SIZE = 16;
+        constexpr u32 OFFSET_MIP_COUNT = 24;
+        constexpr u32 OFFSET_PIXEL_FORMAT_FLAGS = 76;
+        constexpr u32 OFFSET_FOURCC = 80;
+        constexpr u32 OFFSET_RGB_BIT_COUNT = 84;
+        constexpr u32 OFFSET_CAPS2 = 108;
+
+        constexpr u32 MakeFourCC(char a, char b, char c, char d)
+        {
+            return static_cast<u32>(a) | (static_cast<u32>(b) << 8) | (static_cast<u32>(c) << 16) | (static_cast<u32>(d) << 24);
+        }
+
+        u32 ReadU32(const u8* data, u32 offset)
+        {
+            u32 value;
+            std::memcpy(&value, data + offset, sizeof(u32));
+            return value;
+        }
+
+        void WriteU32(u8* data, u32 offset, u32 value)
+        {
+            std::memcpy(data + offset, &value, sizeof(u32));
+        }
+
+        u32 GetDXGIBlockSize(u32 dxgiFormat)
+        {
+            switch (dxgiFormat)
+            {
+                case 70: case 71: case 72: // BC1
+                case 79: case 80: case 81: // BC4
+                    return 8;
+
+                case 73: case 74: case 75: // BC2
+                case 76: case 77: case 78: // BC3
+                case 82: case 83: case 84: // BC5
+                case 94: case 95: case 96: // BC6H
+                case 97: case 98: case 99: // BC7
+                    return 16;
+
+                default:
+                    return 0;
+            }
+        }
+
+        u32 GetFourCCBlockSize(u32 fourCC)
+        {
+            switch (fourCC)
+            {
+                case MakeFourCC('D', 'X', 'T', '1'):
+                case MakeFourCC('A', 'T', 'I', '1'):
+                case MakeFourCC('B', 'C', '4', 'U'):
+                    return 8;
+
+                case MakeFourCC('D', 'X', 'T', '2'):
+                case MakeFourCC('D', 'X', 'T', '3'):
+                case MakeFourCC('D', 'X', 'T', '4'):
+                case MakeFourCC('D', 'X', 'T', '5'):
+                case MakeFourCC('A', 'T', 'I', '2'):
+                case MakeFourCC('B', 'C', '5', 'U'):
+                    return 16;
+
+                default:
+                    return 0;
+            }
+        }
+
+        // Block compressed formats use blockSize bytes per 4x4 block, the others bytesPerPixel per pixel
+        u64 GetMipSize(u32 width, u32 height, u32 blockSize, u32 bytesPerPixel)
+        {
+            if (blockSize > 0)
+                return static_cast<u64>(std::max(1u, (width + 3) / 4)) * std::max(1u, (height + 3) / 4) * blockSize;
+
+            return static_cast<u64>(width) * height * bytesPerPixel;
+        }
+    }
+
+    bool BuildLowMipTexture(const u8* data, size_t size, u32 maxSize, std::vector<u8>& lowTexture)
+    {
+        if (data == nullptr || size < sizeof(u32) + DDS_HEADER_SIZE || ReadU32(data, 0) != DDS_MAGIC)
+            return false;
+
+        const u8* header = data + sizeof(u32);
+        if (ReadU32(header, 0) != DDS_HEADER_SIZE)
+            return false;
+
+        if (ReadU32(header, OFFSET_CAPS2) & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME))
+            return false;
+
+        u32 headerSize = sizeof(u32) + DDS_HEADER_SIZE;
+        u32 blockSize = 0;
+        u32 bytesPerPixel = 0;
+
+        if (ReadU32(header, OFFSET_PIXEL_FORMAT_FLAGS) & DDPF_FOURCC)
+        {
+            u32 fourCC = ReadU32(header, OFFSET_FOURCC);
+            if (fourCC == MakeFourCC('D', 'X', '1', '0'))
+            {
+                if (size < headerSize + DDS_DX10_HEADER_SIZE)
+                    return false;
+
+                const u8* dx10Header = data + headerSize;
+                u32 dxgiFormat = ReadU32(dx10Header, 0);
+                u32 resourceDimension = ReadU32(dx10Header, 4);
+                u32 miscFlag = ReadU32(dx10Header, 8);
+                u32 arraySize = ReadU32(dx10Header, 12);
+
+                if (resourceDimension != DDS_DIMENSION_TEXTURE2D || (miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE) || arraySize > 1)
+                    return false;
+
+                headerSize += DDS_DX10_HEADER_SIZE;
+                blockSize = GetDXGIBlockSize(dxgiFormat);
+            }
+            else
+            {
+                blockSize = GetFourCCBlockSize(fourCC);
+            }
+
+            if (blockSize == 0)
+                return false;
+        }
+        else
+        {
+            u32 bitCount = ReadU32(header, OFFSET_RGB_BIT_COUNT);
+            if (bitCount == 0 || bitCount % 8 != 0)
+                return false;
+
+            bytesPerPixel = bitCount / 8;
+        }
+
+        u32 width = ReadU32(header, OFFSET_WIDTH);
+        u32 height = ReadU32(header, OFFSET_HEIGHT);
+        u32 numMips = std::max(1u, ReadU32(header, OFFSET_MIP_COUNT));
+        if (width == 0 || height == 0 || numMips > 32)
+            return false;
+
+        // The first mip that fits within maxSize, it and every smaller mip go into the low texture
+        u32 firstMip = 0;
+        while (firstMip < numMips && std::max(width >> firstMip, height >> firstMip) > maxSize)
+        {
+            firstMip++;
+        }
+
+        if (firstMip == 0 || firstMip == numMips)
+            return false;
+
+        u64 firstMipOffset = 0;
+        u64 mipChainSize = 0;
+        for (u32 mip = 0; mip < numMips; mip++)
+        {
+            if (mip == firstMip)
+                firstMipOffset = mipChainSize;
+
+            mipChainSize += GetMipSize(std::max(1u, width >> mip), std::max(1u, height >> mip), blockSize, bytesPerPixel);
+        }
+
+        if (headerSize + mipChainSize > size)
+            return false;
+
+        u32 lowWidth = std::max(1u, width >> firstMip);
+        u32 lowHeight = std::max(1u, height >> firstMip);
+        u64 lowDataSize = mipChainSize - firstMipOffset;
+
+        lowTexture.resize(headerSize + lowDataSize);
+        std::memcpy(lowTexture.data(), data, headerSize);
+        std::memcpy(lowTexture.data() + headerSize, data + headerSize + firstMipOffset, lowDataSize);
+
+        u8* lowHeader = lowTexture.data() + sizeof(u32);
+        WriteU32(lowHeader, OFFSET_WIDTH, lowWidth);
+        WriteU32(lowHeader, OFFSET_HEIGHT, lowHeight);
+        WriteU32(lowHeader, OFFSET_MIP_COUNT, numMips - firstMip);
+
+        u32 flags = ReadU32(lowHeader, OFFSET_FLAGS);
+        if (flags & DDSD_LINEARSIZE)
+            WriteU32(lowHeader, OFFSET_PITCH_OR_LINEAR_SIZE, static_cast<u32>(GetMipSize(lowWidth, lowHeight, blockSize, bytesPerPixel)));
+        else if (flags & DDSD_PITCH)
+            WriteU32(lowHeader, OFFSET_PITCH_OR_LINEAR_SIZE, blockSize > 0 ? std::max(1u, (lowWidth + 3) / 4) * blockSize : lowWidth * bytesPerPixel);
+
+        return true;
+    }
+}
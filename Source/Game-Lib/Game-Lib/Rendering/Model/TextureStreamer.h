@@ -0,0 +1,135 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <robinhood/robinhood.h>
+
+#include <limits>
+#include <vector>
+
+// Decides which model textures get loaded, at which resolution and which ones get evicted, the loading and uploading
+// itself is left to the owner. A texture is first loaded as a low resolution version made from its smallest mips, the full
+// texture follows once its priority is high enough and it fits in the byte budget, evicting full textures with a lower
+// priority if it has to. Priorities are screen-space sizes, bigger means more important.
+class TextureStreamer
+{
+public:
+    static constexpr u32 INVALID_ARRAY_INDEX = std::numeric_limits<u32>().max();
+
+    enum class Level : u8
+    {
+        Low,
+        Full
+    };
+
+    struct LoadJob
+    {
+    public:
+        u64 textureHash = 0;
+        Level level = Level::Low;
+    };
+
+    // Owns the GPU side of each version, ModelRenderer keeps every upload as a texture of its own so a release frees it
+    class Uploader
+    {
+    public:
+        virtual ~Uploader() = default;
+
+        virtual bool UploadStreamedTexture(u64 textureHash, Level level, const void* data, size_t size, u32& arrayIndex) = 0;
+
+        // Everything that samples the texture should use arrayIndex from now on
+        virtual void SetStreamedTextureArrayIndex(u64 textureHash, u32 arrayIndex) = 0;
+
+        // Nothing samples arrayIndex anymore, its memory no longer counts against the budget
+        virtual void ReleaseStreamedTexture(u64 textureHash, u32 arrayIndex) = 0;
+    };
+
+    struct Stats
+    {
+    public:
+        u32 numTextures = 0;
+        u32 numLowResident = 0;
+        u32 numFullResident = 0;
+        u32 numJobsInFlight = 0;
+
+        u64 residentBytes = 0;
+        u64 reservedBytes = 0;
+        u64 budgetBytes = 0;
+
+        u64 numUploads = 0;
+        u64 numEvictions = 0;
+    };
+
+public:
+    explicit TextureStreamer(Uploader* uploader) : _uploader(uploader) { }
+
+    void SetBudget(u64 budgetBytes) { _budgetBytes = budgetBytes; }
+    void SetMinUpgradePriority(f32 priority) { _minUpgradePriority = priority; }
+
+    // Returns false if the texture was already known, its priority is raised to priority if it was lower
+    bool Request(u64 textureHash, f32 priority);
+    void SetPriority(u64 textureHash, f32 priority);
+
+    // The best resident version of the texture
+    bool GetArrayIndex(u64 textureHash, u32& arrayIndex) const;
+
+    // Low resolution versions first, then upgrades, both in priority order. Full jobs reserve their bytes until completed
+    void CollectJobs(u32 maxJobs, std::vector<LoadJob>& jobs);
+
+    // isWholeTexture is set when a Low job had no smaller version to load and got the full texture instead, fullSize is the
+    // size of the full texture for Low jobs
+    void CompleteJob(const LoadJob& job, const void* data, size_t size, u64 fullSize, bool isWholeTexture);
+    void FailJob(const LoadJob& job);
+
+    void Clear();
+
+    // GetStats walks every texture, these don't
+    u32 GetNumJobsInFlight() const { return _numJobsInFlight; }
+    u64 GetResidentBytes() const { return _residentBytes; }
+    Stats GetStats() const;
+
+private:
+    struct StreamedTexture
+    {
+    public:
+        f32 priority = 0.0f;
+
+        u64 lowSize = 0;
+        u64 fullSize = 0; // 0 when there is nothing to upgrade to
+
+        u32 lowArrayIndex = INVALID_ARRAY_INDEX;
+        u32 fullArrayIndex = INVALID_ARRAY_INDEX;
+
+        bool isLowInFlight = false;
+        bool isFullInFlight = false;
+        bool hasFailed = false;
+    };
+
+    void Evict(u64 textureHash, StreamedTexture& texture);
+
+private:
+    Uploader* _uploader = nullptr;
+
+    robin_hood::unordered_map<u64, StreamedTexture> _textures;
+
+    u64 _budgetBytes = 0;
+    u64 _residentBytes = 0;
+    u64 _reservedBytes = 0;
+    f32 _minUpgradePriority = 0.0f;
+
+    u32 _numJobsInFlight = 0;
+    u64 _numUploads = 0;
+    u64 _numEvictions = 0;
+
+    // Scratch space for CollectJobs
+    std::vector<std::pair<f32, u64>> _lowCandidates;
+    std::vector<std::pair<f32, u64>> _fullCandidates;
+    std::vector<std::pair<f32, u64>> _evictionCandidates;
+    std::vector<u64> _evictionSizePrefix;
+};
+
+namespace TextureStreaming
+{
+    // Builds a DDS file out of the mips of texture that are at most maxSize wide and high. Returns false if the texture
+    // is not a 2D DDS with smaller mips to take, or if it is malformed
+    bool BuildLowMipTexture(const u8* data, size_t size, u32 maxSize, std::vector<u8>& lowTexture);
+}
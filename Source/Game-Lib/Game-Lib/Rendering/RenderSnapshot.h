@@ -0,0 +1,75 @@
+#pragma once
+#include "Game-Lib/ECS/Singletons/EngineStats.h"
+
+#include <Base/Types.h>
+
+#include <entt/fwd.hpp>
+
+#include <vector>
+
+// What one simulated frame produced for the renderers. Systems leave their changes here through RenderState::snapshot
+// instead of touching the renderers, EndTick hands them over while no frame is rendering and UpdateRenderers syncs them.
+// In pipelined mode the snapshot then goes to the render thread, which reports its timings back through it
+struct RenderSnapshot
+{
+public:
+    struct Lighting
+    {
+    public:
+        bool isSet = false;
+
+        vec3 sunDirection = vec3(0.0f, 1.0f, 0.0f); // Points toward the sun
+        vec3 diffuseColor = vec3(1.0f);
+        vec3 ambientColor = vec3(1.0f);
+        vec3 shadowColor = vec3(1.0f);
+        f32 shadowStrength = 1.0f;
+
+        vec3 skybandTopColor = vec3(0.0f);
+        vec3 skybandMiddleColor = vec3(0.0f);
+        vec3 skybandBottomColor = vec3(0.0f);
+        vec3 skybandAboveHorizonColor = vec3(0.0f);
+        vec3 skybandHorizonColor = vec3(0.0f);
+
+        vec3 fogColor = vec3(0.0f);
+        f32 fogBlendBegin = 0.0f;
+        f32 fogBlendEnd = 0.0f;
+    };
+
+    // A placement drawing with the shared matrices of its model's AnimationStaticInstance entity
+    struct StaticAnimationInstance
+    {
+    public:
+        u32 instanceID;
+        entt::entity staticEntity;
+    };
+
+    struct AnimationChanges
+    {
+    public:
+        std::vector<u32> addedInstances; // Static placements that animate on their own from now on
+        std::vector<entt::entity> addedStaticEntities; // Need their shared matrices allocated before anything uses them
+        std::vector<StaticAnimationInstance> staticInstances;
+        std::vector<entt::entity> dirtyEntities; // Bone or texture transforms changed this frame
+    };
+
+    // The snapshots are reused, clearing keeps the capacity of the change lists
+    void ResetChanges()
+    {
+        lighting.isSet = false;
+
+        animation.addedInstances.clear();
+        animation.addedStaticEntities.clear();
+        animation.staticInstances.clear();
+        animation.dirtyEntities.clear();
+    }
+
+public:
+    u64 frameNumber = 0;
+    f32 deltaTime = 0.0f;
+
+    Lighting lighting;
+    AnimationChanges animation;
+
+    // The simulation fills in deltaTimeS and simulationFrameTimeS, the render thread the render times
+    ECS::Singletons::FrameTimes timings = {};
+};
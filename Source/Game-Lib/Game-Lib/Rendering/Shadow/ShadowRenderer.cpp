@@ -655,7 +655,7 @@ ShadowRenderer::SVSMUpdateRecorder::SVSMUpdateRecorder(ShadowRenderer& owner, SV
     constants->dynamicPhase = 0;
 
     // Finalize turns these record-time counts into same-frame per-view indirect dispatch args.
-    constants->fillInstanceCount = owner._modelRenderer->GetOpaqueCullingResources().GetNumInstances();
+    constants->fillInstanceCount = owner._modelRenderer->GetOpaqueCullingResources().GetNumInstanceRefSlots();
     constants->fillCellCount = owner._terrainRenderer->GetNumDrawCalls();
     constants->fillDrawCallCount = owner._modelRenderer->GetOpaqueCullingResources().GetDrawCallCount();
 }
@@ -78,8 +78,9 @@ void SkyboxRenderer::AddSkyboxPass(Renderer::RenderGraph* renderGraph, RenderRes
             commandList.BindDescriptorSet(data.globalSet, frameIndex);
 
             // Skyband Color Push Constant
-            _skybandColors.sunDirection.w = static_cast<f32>(CVAR_SkyboxDrawSun.Get());
-            commandList.PushConstant(&_skybandColors, 0, sizeof(SkybandColors));
+            SkybandColors skybandColors = _skybandColors;
+            skybandColors.sunDirection.w = static_cast<f32>(CVAR_SkyboxDrawSun.Get());
+            commandList.PushConstant(&skybandColors, 0, sizeof(SkybandColors));
 
             // NumVertices hardcoded as we use a Fullscreen Triangle (Check FullscreenTriangle.vs for more information)
             commandList.Draw(3, 1, 0, 0);
@@ -100,7 +101,7 @@ void SkyboxRenderer::SetSkybandColors(const vec3& skyTopColor, const vec3& skyMi
 
 void SkyboxRenderer::SetSunDirection(const vec3& directionToSun)
 {
-    // w is stomped from skyboxDrawSun in AddSkyboxPass every frame
+    // w is filled in from skyboxDrawSun when AddSkyboxPass pushes the colors
     _skybandColors.sunDirection = vec4(glm::normalize(directionToSun), 0.0f);
 }
 
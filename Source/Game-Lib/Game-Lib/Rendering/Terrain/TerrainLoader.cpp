@@ -7,6 +7,7 @@
 #include "Game-Lib/ECS/Components//Model.h"
 #include "Game-Lib/ECS/Singletons/AnimationSingleton.h"
 #include "Game-Lib/ECS/Singletons/ActiveCamera.h"
+#include "Game-Lib/ECS/Singletons/CharacterSingleton.h"
 #include "Game-Lib/ECS/Singletons/JoltState.h"
 #include "Game-Lib/ECS/Systems/CharacterController.h"
 #include "Game-Lib/ECS/Systems/Editor/EditorTools.h"
@@ -25,6 +26,7 @@
 #include "Game-Lib/Util/JoltStream.h"
 #include "Game-Lib/Util/MapUtil.h"
 #include "Game-Lib/Util/ServiceLocator.h"
+#include "Game-Lib/Util/TerrainPhysicsUtil.h"
 
 #include <Base/CVarSystem/CVarSystem.h>
 #include <Base/Memory/FileReader.h>
@@ -85,54 +87,15 @@ namespace
 
     bool BuildChunkPhysics(const Map::Chunk& chunk, std::vector<u8>& outPhysicsData)
     {
-        JPH::VertexList vertices;
-        JPH::IndexedTriangleList triangles;
-        vertices.reserve(Terrain::CHUNK_NUM_CELLS * Terrain::CELL_TOTAL_GRID_SIZE);
-        triangles.reserve(Terrain::CHUNK_NUM_CELLS * Terrain::CELL_NUM_TRIANGLES);
-
-        for (u32 cellID = 0; cellID < Terrain::CHUNK_NUM_CELLS; cellID++)
-        {
-            for (u32 vertexID = 0; vertexID < Terrain::CELL_TOTAL_GRID_SIZE; vertexID++)
-            {
-                const vec2 position = Util::Map::GetCellVertexPosition(cellID, vertexID);
-                vertices.push_back({ position.x, chunk.cellsData.heightField[cellID][vertexID], position.y });
-            }
-
-            const u32 cellVertexOffset = cellID * Terrain::CELL_TOTAL_GRID_SIZE;
-            for (u32 triangleID = 0; triangleID < Terrain::CELL_NUM_TRIANGLES; triangleID++)
-            {
-                const u32 patchID = triangleID / 4;
-                if ((chunk.cellsData.holes[cellID] & (1ull << patchID)) != 0)
-                    continue;
-
-                const u32 patchRow = patchID / 8;
-                const u32 patchColumn = patchID % 8;
-                const u32 patchVertices[5] = {
-                    patchColumn + patchRow * Terrain::CELL_GRID_ROW_SIZE,
-                    patchColumn + patchRow * Terrain::CELL_GRID_ROW_SIZE + 1,
-                    patchColumn + patchRow * Terrain::CELL_GRID_ROW_SIZE + Terrain::CELL_GRID_ROW_SIZE,
-                    patchColumn + patchRow * Terrain::CELL_GRID_ROW_SIZE + Terrain::CELL_GRID_ROW_SIZE + 1,
-                    patchColumn + patchRow * Terrain::CELL_GRID_ROW_SIZE + Terrain::CELL_OUTER_GRID_STRIDE
-                };
-                const u32 triangleWithinPatch = triangleID % 4;
-                const uvec2 componentOffsets(triangleWithinPatch > 1, triangleWithinPatch == 0 || triangleWithinPatch == 3);
-                const u32 vertexID1 = cellVertexOffset + patchVertices[4];
-                const u32 vertexID2 = cellVertexOffset + patchVertices[componentOffsets.x * 2 + componentOffsets.y];
-                const u32 vertexID3 = cellVertexOffset + patchVertices[(!componentOffsets.y) * 2 + componentOffsets.x];
-                triangles.push_back({ vertexID3, vertexID2, vertexID1 });
-            }
-        }
-
-        JPH::MeshShapeSettings shapeSettings(vertices, triangles);
-        JPH::ShapeSettings::ShapeResult shapeResult = shapeSettings.Create();
-        if (shapeResult.HasError())
+        JPH::ShapeRefC shape = Util::TerrainPhysics::CreateMeshShape(chunk);
+        if (!shape)
             return false;
 
         JPH::Shape::ShapeToIDMap shapeMap;
         JPH::Shape::MaterialToIDMap materialMap;
         std::shared_ptr<Bytebuffer> physicsBuffer = Bytebuffer::BorrowRuntime(16 * 1024 * 1024);
         JoltStreamOut stream(physicsBuffer.get());
-        shapeResult.Get()->SaveWithChildren(stream, shapeMap, materialMap);
+        shape->SaveWithChildren(stream, shapeMap, materialMap);
         if (stream.IsFailed() || physicsBuffer->writtenData == 0)
             return false;
 
@@ -234,6 +197,14 @@ namespace
 }
 
 AutoCVar_Int CVAR_TerrainChunkLoadsPerFrame(CVarCategory::Client | CVarCategory::Rendering, "terrainChunkLoadsPerFrame", "maximum terrain chunks prepared and committed per frame", 32, CVarFlags::None);
+AutoCVar_Int CVAR_TerrainStreaming(CVarCategory::Client | CVarCategory::Rendering, "terrainStreaming", "only keep terrain chunks around the player resident, takes effect on the next map load", 0, CVarFlags::EditCheckbox);
+AutoCVar_Float CVAR_TerrainStreamingLoadRadius(CVarCategory::Client | CVarCategory::Rendering, "terrainStreamingLoadRadius", "distance in chunks within which terrain chunks are streamed in", 6.0f, CVarFlags::EditFloatDrag);
+AutoCVar_Float CVAR_TerrainStreamingUnloadRadius(CVarCategory::Client | CVarCategory::Rendering, "terrainStreamingUnloadRadius", "distance in chunks beyond which terrain chunks are evicted, kept above the load radius to avoid thrashing", 8.0f, CVarFlags::EditFloatDrag);
+AutoCVar_Float CVAR_TerrainStreamingDirectionBias(CVarCategory::Client | CVarCategory::Rendering, "terrainStreamingDirectionBias", "how strongly chunks in the direction of travel are prioritized (0-1)", 0.5f, CVarFlags::EditFloatDrag);
+AutoCVar_Int CVAR_TerrainStreamingBudgetMB(CVarCategory::Client | CVarCategory::Rendering, "terrainStreamingBudgetMB", "memory budget in MB for resident streamed terrain chunks", 1024, CVarFlags::None);
+AutoCVar_Int CVAR_TerrainStreamingLoadsPerFrame(CVarCategory::Client | CVarCategory::Rendering, "terrainStreamingLoadsPerFrame", "maximum terrain chunks requested by streaming per frame", 8, CVarFlags::None);
+
+AutoCVar_Int CVAR_PhysicsTerrainHeightField(CVarCategory::Client | CVarCategory::Physics, "terrainHeightField", "builds terrain collision as height fields instead of the triangle meshes stored in the chunk files", 1, CVarFlags::EditCheckbox);
 
 TerrainLoader::TerrainLoader(TerrainRenderer* terrainRenderer, ModelLoader* modelLoader, LiquidLoader* liquidLoader)
     : _terrainRenderer(terrainRenderer)
@@ -281,6 +252,9 @@ void TerrainLoader::Clear()
     LoadRequestInternal loadRequest;
     while (_requests.try_dequeue(loadRequest)) { }
 
+    // Chunks still waiting to be added are in _chunkIDToBodyID too, get them into the broad phase so they can be removed with the rest
+    _chunkBodyBatcher.Flush(joltState.physicsSystem.GetBodyInterface(), JPH::EActivation::DontActivate);
+
     u32 numBodyIDs = static_cast<u32>(_chunkIDToBodyID.size());
     if (numBodyIDs > 0)
     {
@@ -297,6 +271,7 @@ void TerrainLoader::Clear()
 
         bodyInterface.RemoveBodies(&bodyIDs[0], numBodyIDs);
         bodyInterface.DestroyBodies(&bodyIDs[0], numBodyIDs);
+        joltState.MarkStaticWorldChanged();
     }
     
     _numChunksToLoad = 0;
@@ -310,7 +285,23 @@ void TerrainLoader::Clear()
     _chunkIDToLoadedID.clear();
     _chunkIDToBodyID.clear();
     _unlinkedChunkRendererIndices.clear();
+    _freeRendererChunkIndices.clear();
+    _chunkLoadBatch.clear();
     _mapHeader = {};
+
+    // Nothing of the unloaded map stays resident, pinned or in flight
+    _streamingPlanner.Reset({});
+    _streamingDecision.Clear();
+    _streamingChunkIDToWorkRequest.clear();
+    _isStreaming = false;
+    _isStreamingInitialLoad = false;
+    _hasStreamingFocus = false;
+
+    {
+        std::scoped_lock lock(_chunkOwnershipMutex);
+        _placementUniqueIDToRefCount.clear();
+        _chunkIDsWithLoadedLiquid.clear();
+    }
     _mapHeaderDirty = false;
 
     {
@@ -355,6 +346,9 @@ void TerrainLoader::Clear()
     }
     
     animationSingleton.staticModelIDToEntity.clear();
+
+    // Every AnimationData pointing into these was cleared above, the next map builds them again for the models it uses
+    animationSingleton.modelHashToTrackTimes.clear();
 }
 
 void TerrainLoader::Update(f32 deltaTime)
@@ -376,9 +370,9 @@ void TerrainLoader::Update(f32 deltaTime)
             // TODO : This needs to be implemented
             //LoadPartialMapRequest(loadRequest);
         }
-        else if (loadRequest.loadType == LoadType::Full)
+        else if (loadRequest.loadType == LoadType::Full || loadRequest.loadType == LoadType::Streaming)
         {
-            if (LoadFullMapRequest(loadRequest))
+            if (LoadMapRequest(loadRequest))
             {
                 _modelLoader->SetTerrainLoading(true);
             }
@@ -389,6 +383,9 @@ void TerrainLoader::Update(f32 deltaTime)
         }
     }
 
+    if (_isStreaming)
+        UpdateStreaming(deltaTime);
+
     u32 numChunksToLoad = _numChunksToLoad;
     u32 numChunksLoadedBefore = _numChunksLoaded;
 
@@ -405,24 +402,59 @@ void TerrainLoader::Update(f32 deltaTime)
 
         const u32 configuredChunkLoadsPerFrame = static_cast<u32>(std::max(1, CVAR_TerrainChunkLoadsPerFrame.Get()));
         u32 maxChunkLoadsThisTick = glm::min(numPendingRequests, configuredChunkLoadsPerFrame);
-        TracyPlot("Terrain Chunks Loaded This Frame", static_cast<i64>(maxChunkLoadsThisTick));
 
-        TerrainReserveOffsets reserveOffsets;
-        _terrainRenderer->AllocateChunks(maxChunkLoadsThisTick, reserveOffsets);
-        _chunkIDToLoadedID.reserve(_chunkIDToLoadedID.size() + maxChunkLoadsThisTick);
-        _chunkIDToBodyID.reserve(_chunkIDToBodyID.size() + maxChunkLoadsThisTick);
+        _chunkLoadBatch.resize(maxChunkLoadsThisTick);
+        u32 numChunkLoadsThisTick = static_cast<u32>(_pendingWorkRequests.try_dequeue_bulk(_chunkLoadBatch.data(), maxChunkLoadsThisTick));
+        _chunkLoadBatch.resize(numChunkLoadsThisTick);
+        TracyPlot("Terrain Chunks Loaded This Frame", static_cast<i64>(numChunkLoadsThisTick));
+
+        // Slots of evicted chunks are reused before the renderer buffers grow
+        _chunkLoadSlots.resize(numChunkLoadsThisTick);
+        _chunkLoadResults.clear();
+        _chunkLoadResults.resize(numChunkLoadsThisTick);
+
+        u32 numReusedSlots = glm::min(numChunkLoadsThisTick, static_cast<u32>(_freeRendererChunkIndices.size()));
+        for (u32 i = 0; i < numReusedSlots; i++)
+        {
+            ChunkLoadSlot& slot = _chunkLoadSlots[i];
+            slot.chunkDataIndex = _freeRendererChunkIndices.back();
+            slot.cellDataStartIndex = slot.chunkDataIndex * Terrain::CHUNK_NUM_CELLS;
+            slot.vertexDataStartIndex = slot.cellDataStartIndex * Terrain::CELL_NUM_VERTICES;
+            slot.reused = true;
+
+            _freeRendererChunkIndices.pop_back();
+        }
+
+        u32 numNewSlots = numChunkLoadsThisTick - numReusedSlots;
+        if (numNewSlots > 0)
+        {
+            TerrainReserveOffsets reserveOffsets;
+            _terrainRenderer->AllocateChunks(numNewSlots, reserveOffsets);
+
+            for (u32 i = 0; i < numNewSlots; i++)
+            {
+                ChunkLoadSlot& slot = _chunkLoadSlots[numReusedSlots + i];
+                slot.chunkDataIndex = reserveOffsets.chunkDataStartOffset + i;
+                slot.cellDataStartIndex = reserveOffsets.cellDataStartOffset + (i * Terrain::CHUNK_NUM_CELLS);
+                slot.vertexDataStartIndex = reserveOffsets.vertexDataStartOffset + (i * Terrain::CHUNK_NUM_CELLS * Terrain::CELL_NUM_VERTICES);
+                slot.reused = false;
+            }
+        }
 
-        enki::TaskSet loadChunksTask(maxChunkLoadsThisTick, [this, &reserveOffsets](enki::TaskSetPartition range, uint32_t threadNum)
+        _chunkIDToLoadedID.reserve(_chunkIDToLoadedID.size() + numChunkLoadsThisTick);
+        _chunkIDToBodyID.reserve(_chunkIDToBodyID.size() + numChunkLoadsThisTick);
+
+        enki::TaskSet loadChunksTask(numChunkLoadsThisTick, [this](enki::TaskSetPartition range, uint32_t threadNum)
         {
             ZoneScopedN("Load Chunk Task");
             u32 numProcessedLoads = 0;
             u32 numFailedLoads = 0;
 
-            WorkRequest workRequest;
             for (u32 i = range.start; i < range.end; i++)
             {
-                if (!_pendingWorkRequests.try_dequeue(workRequest))
-                    break;
+                WorkRequest& workRequest = _chunkLoadBatch[i];
+                ChunkLoadResult& result = _chunkLoadResults[i];
+                result.chunkID = workRequest.chunkID;
 
                 ZoneScopedN("Load Chunk Worker");
                 numProcessedLoads++;
@@ -467,14 +499,15 @@ void TerrainLoader::Update(f32 deltaTime)
                     continue;
                 }
 
+                result.residentBytes = workRequest.fileHandle->GetSize() + TerrainRenderer::GetChunkGPUBytes();
+                result.loaded = true;
+
                 // Load into Terrain Renderer
                 {
                     ZoneScopedN("Add Chunk To Renderer");
-                    u32 chunkDataIndex = reserveOffsets.chunkDataStartOffset + i;
-                    u32 cellDataStartIndex = reserveOffsets.cellDataStartOffset + (i * Terrain::CHUNK_NUM_CELLS);
-                    u32 vertexDataStartIndex = reserveOffsets.vertexDataStartOffset + (i * Terrain::CHUNK_NUM_CELLS * Terrain::CELL_NUM_VERTICES);
+                    const ChunkLoadSlot& slot = _chunkLoadSlots[i];
 
-                    u32 chunkDataID = _terrainRenderer->AddChunk(workRequest.chunkHash, chunk, ivec2(chunkX, chunkY), chunkDataIndex, cellDataStartIndex, vertexDataStartIndex);
+                    u32 chunkDataID = _terrainRenderer->AddChunk(workRequest.chunkHash, chunk, ivec2(chunkX, chunkY), slot.chunkDataIndex, slot.cellDataStartIndex, slot.vertexDataStartIndex);
                     
                     {
                         std::scoped_lock lock(_chunkLoadingMutex);
@@ -493,7 +526,8 @@ void TerrainLoader::Update(f32 deltaTime)
                         for (u32 placementIndex = 0; placementIndex < numPlacements; placementIndex++)
                         {
                             auto* placement = chunk->placementHeader.GetPlacement(workRequest.buffer, placementIndex);
-                            _modelLoader->LoadPlacement(*placement);
+                            if (!_isStreaming || AcquirePlacement(placement->uniqueID))
+                                _modelLoader->LoadPlacement(*placement);
                         }
                     }
 
@@ -507,10 +541,10 @@ void TerrainLoader::Update(f32 deltaTime)
                             NC_LOG_CRITICAL("LiquidHeader should always contain either 0 or 256 liquid headers, but it contained {0} liquid headers", numLiquidHeaders);
                         }
 
-                        if (numLiquidHeaders == 256)
+                        if (numLiquidHeaders == 256 && MarkChunkLiquidLoaded(workRequest.chunkID))
                         {
                             ZoneScopedN("Load Chunk Liquid");
-                            _liquidLoader->LoadFromChunk(chunkX, chunkY, workRequest.buffer, chunk->liquidHeader);
+                            result.residentBytes += _liquidLoader->LoadFromChunk(chunkX, chunkY, workRequest.buffer, chunk->liquidHeader);
                         }
                     }
                 }
@@ -524,8 +558,36 @@ void TerrainLoader::Update(f32 deltaTime)
         taskScheduler->AddTaskSetToPipe(&loadChunksTask);
         taskScheduler->WaitforTask(&loadChunksTask);
 
+        for (u32 i = 0; i < numChunkLoadsThisTick; i++)
+        {
+            const ChunkLoadSlot& slot = _chunkLoadSlots[i];
+            const ChunkLoadResult& result = _chunkLoadResults[i];
+
+            if (result.loaded)
+            {
+                if (slot.reused)
+                    _terrainRenderer->MarkChunkDirty(slot.chunkDataIndex);
+
+                if (_isStreaming)
+                    _streamingPlanner.OnChunkLoaded(result.chunkID, result.residentBytes);
+            }
+            else
+            {
+                // Keep the slot for the next chunk instead of leaving an uninitialized chunk in the buffers
+                _terrainRenderer->HideChunk(slot.chunkDataIndex);
+                _freeRendererChunkIndices.push_back(slot.chunkDataIndex);
+
+                if (_isStreaming)
+                    _streamingPlanner.OnChunkLoadFailed(result.chunkID);
+            }
+        }
+        _chunkLoadBatch.clear();
+
+        // The broadphase has to know about every chunk before it gets optimized
+        FlushChunkBodies();
+
         u32 numChunksLoadedAfter = _numChunksLoaded;
-        bool finishedLoadThisFrame = numChunksLoadedBefore < numChunksToLoad && numChunksLoadedAfter >= numChunksToLoad;
+        bool finishedLoadThisFrame = !_isStreaming && numChunksLoadedBefore < numChunksToLoad && numChunksLoadedAfter >= numChunksToLoad;
         if (finishedLoadThisFrame)
         {
             i32 physicsOptimizeBP = *CVarSystem::Get()->GetIntCVar(CVarCategory::Client | CVarCategory::Physics, "optimizeBP"_h);
@@ -538,6 +600,180 @@ void TerrainLoader::Update(f32 deltaTime)
             NC_LOG_INFO("TerrainLoader : Loaded {0}/{1} chunks ({2} failed)", numChunksLoadedAfter - numFailedChunks, numChunksLoadedAfter, numFailedChunks);
         }
     }
+
+    // Evicted chunks and the ones the editor rebuilt
+    FlushChunkBodies();
+}
+
+void TerrainLoader::UpdateStreaming(f32 deltaTime)
+{
+    ZoneScopedN("TerrainLoader::UpdateStreaming");
+
+    entt::registry* registry = ServiceLocator::GetEnttRegistries()->gameRegistry;
+
+    // Stream around the player when we have one, otherwise around the camera
+    entt::entity focusEntity = registry->ctx().get<ECS::Singletons::CharacterSingleton>().moverEntity;
+    if (focusEntity == entt::null || !registry->valid(focusEntity) || !registry->all_of<ECS::Components::Transform>(focusEntity))
+        focusEntity = registry->ctx().get<ECS::Singletons::ActiveCamera>().entity;
+
+    if (focusEntity == entt::null || !registry->valid(focusEntity))
+        return;
+
+    auto* focusTransform = registry->try_get<ECS::Components::Transform>(focusEntity);
+    if (!focusTransform)
+        return;
+
+    vec3 focusPosition = focusTransform->GetWorldPosition();
+    vec2 focusChunkGlobalPos = Util::Map::WorldPositionToChunkGlobalPos(focusPosition);
+    vec2 focusChunkPos = Util::Map::GetChunkIndicesFromAdtPosition(focusChunkGlobalPos);
+
+    // Only the direction is used, so a teleport showing up as a huge velocity for one tick is harmless
+    vec2 focusVelocity = vec2(0.0f);
+    if (_hasStreamingFocus && deltaTime > 0.0f)
+        focusVelocity = (focusChunkPos - _lastStreamingFocusPos) / deltaTime;
+
+    _lastStreamingFocusPos = focusChunkPos;
+    _hasStreamingFocus = true;
+
+    TerrainStreamingPlanner::Settings settings;
+    settings.loadRadius = glm::max(CVAR_TerrainStreamingLoadRadius.GetFloat(), 0.0f);
+    settings.unloadRadius = glm::max(CVAR_TerrainStreamingUnloadRadius.GetFloat(), settings.loadRadius);
+    settings.directionBias = glm::clamp(CVAR_TerrainStreamingDirectionBias.GetFloat(), 0.0f, 1.0f);
+    settings.memoryBudgetBytes = static_cast<u64>(glm::max(CVAR_TerrainStreamingBudgetMB.Get(), 1)) * 1024ull * 1024ull;
+    settings.maxLoadsPerTick = static_cast<u32>(glm::clamp(CVAR_TerrainStreamingLoadsPerFrame.Get(), 1, glm::max(1, CVAR_TerrainChunkLoadsPerFrame.Get())));
+    settings.maxInFlight = settings.maxLoadsPerTick;
+    _streamingPlanner.SetSettings(settings);
+
+    _streamingPlanner.Update(focusChunkPos, focusVelocity, _streamingDecision);
+
+    for (u32 chunkID : _streamingDecision.chunksToEvict)
+    {
+        EvictChunk(chunkID);
+    }
+
+    for (u32 chunkID : _streamingDecision.chunksToLoad)
+    {
+        // Chunks attached by the terrain editor are already resident
+        if (_chunkIDToLoadedID.contains(chunkID))
+        {
+            _streamingPlanner.OnChunkLoaded(chunkID, TerrainRenderer::GetChunkGPUBytes());
+            continue;
+        }
+
+        auto itr = _streamingChunkIDToWorkRequest.find(chunkID);
+        if (itr == _streamingChunkIDToWorkRequest.end())
+        {
+            _streamingPlanner.OnChunkLoadFailed(chunkID);
+            continue;
+        }
+
+        _requestedChunkHashes.insert(itr->second.chunkHash);
+        _pendingWorkRequests.enqueue(itr->second);
+        _numChunksToLoad++;
+    }
+
+    TracyPlot("Terrain Streaming Resident Chunks", static_cast<i64>(_streamingPlanner.GetNumLoadedChunks()));
+    TracyPlot("Terrain Streaming Resident MB", static_cast<f64>(_streamingPlanner.GetResidentBytes()) / (1024.0 * 1024.0));
+
+    // The map counts as loaded once everything inside the load radius is resident
+    if (_isStreamingInitialLoad && _streamingDecision.chunksToLoad.empty() && _streamingPlanner.GetNumInFlightChunks() == 0)
+    {
+        _isStreamingInitialLoad = false;
+
+        i32 physicsEnabled = *CVarSystem::Get()->GetIntCVar(CVarCategory::Client | CVarCategory::Physics, "enabled"_h);
+        i32 physicsOptimizeBP = *CVarSystem::Get()->GetIntCVar(CVarCategory::Client | CVarCategory::Physics, "optimizeBP"_h);
+        if (physicsEnabled && physicsOptimizeBP)
+        {
+            registry->ctx().get<ECS::Singletons::JoltState>().physicsSystem.OptimizeBroadPhase();
+        }
+
+        const u32 numFailedChunks = _numChunksFailed;
+        NC_LOG_INFO("TerrainLoader : Streamed in {0} chunks around the player ({1} failed)", _streamingPlanner.GetNumLoadedChunks(), numFailedChunks);
+    }
+}
+
+void TerrainLoader::EvictChunk(u32 chunkID)
+{
+    ZoneScopedN("TerrainLoader::EvictChunk");
+
+    auto loadedItr = _chunkIDToLoadedID.find(chunkID);
+    if (loadedItr == _chunkIDToLoadedID.end())
+        return;
+
+    const u32 rendererChunkIndex = loadedItr->second;
+
+    ChunkInfo chunkInfo;
+    {
+        std::scoped_lock lock(_chunkLoadingMutex);
+
+        auto chunkInfoItr = _chunkIDToChunkInfo.find(chunkID);
+        if (chunkInfoItr != _chunkIDToChunkInfo.end())
+        {
+            chunkInfo = std::move(chunkInfoItr->second);
+            _chunkIDToChunkInfo.erase(chunkInfoItr);
+        }
+
+        _chunkIDToLoadedID.erase(loadedItr);
+        _contentGeneration.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    _terrainRenderer->HideChunk(rendererChunkIndex);
+    _freeRendererChunkIndices.push_back(rendererChunkIndex);
+    RemoveChunkPhysics(chunkID);
+
+    if (chunkInfo.chunk && chunkInfo.buffer)
+    {
+        ZoneScopedN("Release Chunk Placements");
+
+        u32 numPlacements = chunkInfo.chunk->placementHeader.numPlacements;
+        for (u32 placementIndex = 0; placementIndex < numPlacements; placementIndex++)
+        {
+            auto* placement = chunkInfo.chunk->placementHeader.GetPlacement(chunkInfo.buffer, placementIndex);
+            if (ReleasePlacement(placement->uniqueID))
+                _modelLoader->UnloadPlacement(placement->uniqueID);
+        }
+    }
+
+    if (ReleaseChunkLiquid(chunkID))
+        _liquidLoader->UnloadChunk(chunkID);
+
+    // Allow the chunk to be requested again when the player comes back
+    auto workRequestItr = _streamingChunkIDToWorkRequest.find(chunkID);
+    if (workRequestItr != _streamingChunkIDToWorkRequest.end())
+        _requestedChunkHashes.erase(workRequestItr->second.chunkHash);
+}
+
+bool TerrainLoader::AcquirePlacement(u32 uniqueID)
+{
+    std::scoped_lock lock(_chunkOwnershipMutex);
+    return _placementUniqueIDToRefCount[uniqueID]++ == 0;
+}
+
+bool TerrainLoader::ReleasePlacement(u32 uniqueID)
+{
+    std::scoped_lock lock(_chunkOwnershipMutex);
+
+    auto itr = _placementUniqueIDToRefCount.find(uniqueID);
+    if (itr == _placementUniqueIDToRefCount.end())
+        return false;
+
+    if (--itr->second > 0)
+        return false;
+
+    _placementUniqueIDToRefCount.erase(itr);
+    return true;
+}
+
+bool TerrainLoader::MarkChunkLiquidLoaded(u32 chunkID)
+{
+    std::scoped_lock lock(_chunkOwnershipMutex);
+    return _chunkIDsWithLoadedLiquid.insert(chunkID).second;
+}
+
+bool TerrainLoader::ReleaseChunkLiquid(u32 chunkID)
+{
+    std::scoped_lock lock(_chunkOwnershipMutex);
+    return _chunkIDsWithLoadedLiquid.erase(chunkID) > 0;
 }
 
 void TerrainLoader::AddInstance(const LoadDesc& loadDesc)
@@ -588,6 +824,9 @@ bool TerrainLoader::GetEditableChunk(u32 chunkID, LoadedChunkView& outChunk)
     if (!chunkInfo.editableChunk)
     {
         chunkInfo.editableChunk = std::make_shared<Map::Chunk>(*chunkInfo.chunk);
+
+        // Edited chunks must not be streamed out, that would drop unsaved edits
+        _streamingPlanner.SetChunkPinned(chunkID, true);
         _contentGeneration.fetch_add(1, std::memory_order_relaxed);
     }
 
@@ -791,29 +1030,39 @@ bool TerrainLoader::CreateChunkPhysics(u32 chunkID, std::shared_ptr<Bytebuffer>&
     if (!physicsEnabled || chunk.physicsHeader.numBytes == 0)
         return true;
 
-    if (chunk.physicsHeader.numBytes > buffer->writtenData || chunk.physicsHeader.dataOffset > buffer->writtenData - chunk.physicsHeader.numBytes)
-        return false;
+    // The height field is built straight from the chunk heights, the cvar being off or it failing to build falls back to the baked mesh
+    JPH::ShapeRefC shape = nullptr;
+    if (CVAR_PhysicsTerrainHeightField.Get())
+        shape = Util::TerrainPhysics::CreateHeightFieldShape(chunk);
 
-    Bytebuffer physicsBuffer(chunk.physicsHeader.GetPhysicsData(buffer), chunk.physicsHeader.numBytes);
-    physicsBuffer.SkipWrite(chunk.physicsHeader.numBytes);
-    JoltStreamIn stream(&physicsBuffer);
-    JPH::Shape::IDToShapeMap shapeMap;
-    JPH::Shape::IDToMaterialMap materialMap;
-    JPH::ShapeSettings::ShapeResult shapeResult = JPH::Shape::sRestoreWithChildren(stream, shapeMap, materialMap);
-    if (shapeResult.HasError())
-        return false;
+    if (!shape)
+    {
+        if (chunk.physicsHeader.numBytes > buffer->writtenData || chunk.physicsHeader.dataOffset > buffer->writtenData - chunk.physicsHeader.numBytes)
+            return false;
+
+        Bytebuffer physicsBuffer(chunk.physicsHeader.GetPhysicsData(buffer), chunk.physicsHeader.numBytes);
+        physicsBuffer.SkipWrite(chunk.physicsHeader.numBytes);
+        JoltStreamIn stream(&physicsBuffer);
+        JPH::Shape::IDToShapeMap shapeMap;
+        JPH::Shape::IDToMaterialMap materialMap;
+        JPH::ShapeSettings::ShapeResult shapeResult = JPH::Shape::sRestoreWithChildren(stream, shapeMap, materialMap);
+        if (shapeResult.HasError())
+            return false;
+
+        shape = shapeResult.Get();
+    }
 
     auto& joltState = ServiceLocator::GetEnttRegistries()->gameRegistry->ctx().get<ECS::Singletons::JoltState>();
     JPH::BodyInterface& bodyInterface = joltState.physicsSystem.GetBodyInterface();
     const vec2 chunkPosition = Util::Map::GetChunkPosition(chunkID);
-    JPH::BodyCreationSettings bodySettings(shapeResult.Get(), JPH::RVec3(chunkPosition.x, 0.0f, chunkPosition.y), JPH::Quat::sIdentity(), JPH::EMotionType::Static, Jolt::Layers::NON_MOVING);
+    JPH::BodyCreationSettings bodySettings(shape, JPH::RVec3(chunkPosition.x, 0.0f, chunkPosition.y), JPH::Quat::sIdentity(), JPH::EMotionType::Static, Jolt::Layers::NON_MOVING);
     JPH::Body* body = bodyInterface.CreateBody(bodySettings);
     joltState.RecordBodyCreate(ECS::Singletons::JoltBodyTelemetrySource::TerrainChunk, body != nullptr);
     if (!body)
         return false;
 
     body->SetUserData(Jolt::PhysicsBodyUserData::Pack(entt::null, Jolt::PhysicsSurfaceType::Terrain, Jolt::PhysicsBodyFlags::CanSupport | Jolt::PhysicsBodyFlags::CanSnapTo));
-    bodyInterface.AddBody(body->GetID(), JPH::EActivation::Activate);
+    _chunkBodyBatcher.QueueAdd(body->GetID(), vec3(chunkPosition.x, 0.0f, chunkPosition.y));
     outBodyID = body->GetID().GetIndexAndSequenceNumber();
     return true;
 }
@@ -824,12 +1073,25 @@ void TerrainLoader::RemoveChunkPhysics(u32 chunkID)
     if (bodyItr == _chunkIDToBodyID.end())
         return;
 
+    _chunkBodyBatcher.QueueRemove(static_cast<JPH::BodyID>(bodyItr->second));
+    _chunkIDToBodyID.erase(bodyItr);
+}
+
+void TerrainLoader::FlushChunkBodies()
+{
+    if (!_chunkBodyBatcher.HasPendingWork())
+        return;
+
     auto& joltState = ServiceLocator::GetEnttRegistries()->gameRegistry->ctx().get<ECS::Singletons::JoltState>();
     JPH::BodyInterface& bodyInterface = joltState.physicsSystem.GetBodyInterface();
-    const JPH::BodyID bodyID = static_cast<JPH::BodyID>(bodyItr->second);
-    bodyInterface.RemoveBody(bodyID);
-    bodyInterface.DestroyBody(bodyID);
-    _chunkIDToBodyID.erase(bodyItr);
+
+    i32 bodyBatchSize = *CVarSystem::Get()->GetIntCVar(CVarCategory::Client | CVarCategory::Physics, "bodyBatchSize"_h);
+    Util::PhysicsBodyBatcher::FlushStats flushStats = _chunkBodyBatcher.Flush(bodyInterface, JPH::EActivation::Activate, static_cast<u32>(glm::max(bodyBatchSize, 0)));
+    TracyPlot("Terrain Physics Bodies Added", static_cast<i64>(flushStats.numAdded));
+    TracyPlot("Terrain Physics Bodies Removed", static_cast<i64>(flushStats.numRemoved));
+
+    if (flushStats.numAdded > 0 || flushStats.numRemoved > 0)
+        joltState.MarkStaticWorldChanged();
 }
 
 bool TerrainLoader::AttachChunk(u32 chunkID, bool replaceFileOnSave, std::shared_ptr<Bytebuffer> buffer, std::shared_ptr<PACT::PactFileHandle> fileHandle, std::shared_ptr<Map::Chunk> editableChunk)
@@ -872,6 +1134,7 @@ bool TerrainLoader::AttachChunk(u32 chunkID, bool replaceFileOnSave, std::shared
     };
     _chunkIDToChunkInfo[chunkID] = std::move(chunkInfo);
     _chunkIDToLoadedID[chunkID] = rendererChunkIndex;
+    _streamingPlanner.SetChunkPinned(chunkID, true);
     if (bodyID != JPH::BodyID::cInvalidBodyID)
         _chunkIDToBodyID[chunkID] = bodyID;
     return true;
@@ -976,6 +1239,7 @@ bool TerrainLoader::ResetChunk(u32 chunkID)
         .revision = 1,
         .replaceFileOnSave = true
     };
+    _streamingPlanner.SetChunkPinned(chunkID, true);
     if (bodyID != JPH::BodyID::cInvalidBodyID)
         _chunkIDToBodyID[chunkID] = bodyID;
     _contentGeneration.fetch_add(1, std::memory_order_relaxed);
@@ -1020,6 +1284,7 @@ bool TerrainLoader::ReplaceGeneratedChunk(u32 chunkID, std::shared_ptr<Map::Chun
             .revision = 1,
             .replaceFileOnSave = true
         };
+        _streamingPlanner.SetChunkPinned(chunkID, true);
         if (bodyID != JPH::BodyID::cInvalidBodyID)
             _chunkIDToBodyID[chunkID] = bodyID;
     }
@@ -1134,11 +1399,11 @@ void TerrainLoader::LoadPartialMapRequest(const LoadRequestInternal& request)
     }
 }
 
-bool TerrainLoader::LoadFullMapRequest(const LoadRequestInternal& request)
+bool TerrainLoader::LoadMapRequest(const LoadRequestInternal& request)
 {
     ZoneScoped;
 
-    assert(request.loadType == LoadType::Full);
+    assert(request.loadType == LoadType::Full || request.loadType == LoadType::Streaming);
     assert(request.mapName.size() > 0);
 
     std::string mapName = request.mapName;
@@ -1235,11 +1500,31 @@ bool TerrainLoader::LoadFullMapRequest(const LoadRequestInternal& request)
     _mapHeaderDirty = false;
     registry->ctx().get<ECS::Singletons::JoltState>().ResetPhysicsTelemetry(mapName);
     NotifyCurrentMapChanged();
-    _numChunksToLoad = numChunksToLoad;
+    _numChunksToLoad = request.loadType == LoadType::Streaming ? 0 : numChunksToLoad;
 
     Scripting::Zenith* zenith = Scripting::Util::Zenith::GetGlobal();
     zenith->CallEvent(MetaGen::Game::Lua::GameEvent::MapLoading, MetaGen::Game::Lua::GameEventDataMapLoading{ .mapInternalName = mapName });
 
+    if (request.loadType == LoadType::Streaming)
+    {
+        // Nothing is queued here, UpdateStreaming requests chunks as the player/camera moves
+        std::vector<u32> availableChunkIDs;
+        availableChunkIDs.reserve(workRequests.size());
+
+        for (WorkRequest& workRequest : workRequests)
+        {
+            availableChunkIDs.push_back(workRequest.chunkID);
+            _streamingChunkIDToWorkRequest[workRequest.chunkID] = std::move(workRequest);
+        }
+
+        _streamingPlanner.Reset(availableChunkIDs);
+        _isStreaming = true;
+        _isStreamingInitialLoad = true;
+
+        NC_LOG_INFO("TerrainLoader : Streaming {0} chunks", numChunksToLoad);
+        return true;
+    }
+
     NC_LOG_INFO("TerrainLoader : Started Chunk Queueing");
 
     auto& activeCamera = registry->ctx().get<ECS::Singletons::ActiveCamera>();
@@ -1,4 +1,7 @@
 #pragma once
+#include "TerrainStreamingPlanner.h"
+#include "Game-Lib/Util/PhysicsBodyBatcher.h"
+
 #include <Base/Types.h>
 #include <Base/Container/ConcurrentQueue.h>
 #include <Base/Container/SafeUnorderedMap.h>
@@ -31,7 +34,8 @@ public:
     enum LoadType
     {
         Partial,
-        Full
+        Full,
+        Streaming // Only chunks around the player/camera are resident, see TerrainStreamingPlanner
     };
 
     struct LoadDesc
@@ -81,6 +85,23 @@ private:
         std::shared_ptr<PACT::PactFileHandle> fileHandle;
     };
 
+    struct ChunkLoadSlot
+    {
+    public:
+        u32 chunkDataIndex = 0;
+        u32 cellDataStartIndex = 0;
+        u32 vertexDataStartIndex = 0;
+        bool reused = false;
+    };
+
+    struct ChunkLoadResult
+    {
+    public:
+        u32 chunkID = Terrain::CHUNK_INVALID_ID;
+        u64 residentBytes = 0;
+        bool loaded = false;
+    };
+
     struct ChunkInfo
     {
     public:
@@ -103,7 +124,8 @@ public:
 
     void AddInstance(const LoadDesc& loadDesc);
 
-    bool IsLoading() { return _numChunksToLoad != _numChunksLoaded; }
+    bool IsLoading() { return _numChunksToLoad != _numChunksLoaded || _isStreamingInitialLoad; }
+    bool IsStreaming() const { return _isStreaming; }
     f32 GetLoadingProgress() const;
 
     const std::string& GetCurrentMapInternalName() { return _currentMapInternalName; }
@@ -125,10 +147,17 @@ public:
 
 private:
     void LoadPartialMapRequest(const LoadRequestInternal& request);
-    bool LoadFullMapRequest(const LoadRequestInternal& request);
+    bool LoadMapRequest(const LoadRequestInternal& request);
+    void UpdateStreaming(f32 deltaTime);
+    void EvictChunk(u32 chunkID);
+    bool AcquirePlacement(u32 uniqueID);
+    bool ReleasePlacement(u32 uniqueID);
+    bool MarkChunkLiquidLoaded(u32 chunkID);
+    bool ReleaseChunkLiquid(u32 chunkID);
     bool AttachChunk(u32 chunkID, bool replaceFileOnSave, std::shared_ptr<Bytebuffer> buffer, std::shared_ptr<PACT::PactFileHandle> fileHandle, std::shared_ptr<Map::Chunk> editableChunk);
     bool CreateChunkPhysics(u32 chunkID, std::shared_ptr<Bytebuffer>& buffer, Map::Chunk& chunk, u32& outBodyID);
     void RemoveChunkPhysics(u32 chunkID);
+    void FlushChunkBodies();
     std::string GetChunkPath(u32 chunkID) const;
 
 private:
@@ -148,6 +177,7 @@ private:
 
     robin_hood::unordered_map<u32, u32> _chunkIDToLoadedID;
     robin_hood::unordered_map<u32, u32> _chunkIDToBodyID;
+    Util::PhysicsBodyBatcher _chunkBodyBatcher; // Filled by the chunk load tasks, flushed on the main thread
     robin_hood::unordered_map<u32, ChunkInfo> _chunkIDToChunkInfo;
     robin_hood::unordered_map<u32, u32> _unlinkedChunkRendererIndices;
 
@@ -156,4 +186,24 @@ private:
 
     mutable std::mutex _chunkLoadingMutex;
     std::atomic<u64> _contentGeneration = 1;
+
+    // Per tick load batch, dequeued on the main thread so renderer slots can be assigned before the workers run
+    std::vector<WorkRequest> _chunkLoadBatch;
+    std::vector<ChunkLoadSlot> _chunkLoadSlots;
+    std::vector<ChunkLoadResult> _chunkLoadResults;
+    std::vector<u32> _freeRendererChunkIndices; // Renderer slots of evicted or failed chunks
+
+    // Streaming
+    TerrainStreamingPlanner _streamingPlanner;
+    TerrainStreamingPlanner::Decision _streamingDecision;
+    robin_hood::unordered_map<u32, WorkRequest> _streamingChunkIDToWorkRequest;
+    bool _isStreaming = false;
+    bool _isStreamingInitialLoad = false;
+    bool _hasStreamingFocus = false;
+    vec2 _lastStreamingFocusPos = vec2(0.0f);
+
+    // Placements can be shared between neighbouring chunks, they are only unloaded once no loaded chunk references them
+    std::mutex _chunkOwnershipMutex;
+    robin_hood::unordered_map<u32, u32> _placementUniqueIDToRefCount;
+    robin_hood::unordered_set<u32> _chunkIDsWithLoadedLiquid;
 };
@@ -0,0 +1,350 @@
+#include "TerrainLod.h"
+
+#include <Base/Util/DebugHandler.h>
+
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace TerrainLod
+{
+    namespace
+    {
+        constexpr u32 GRID_SIZE = Terrain::CELL_INNER_GRID_STRIDE; // Patches along a cell side
+
+        enum QuadTriangle : u32
+        {
+            TRIANGLE_UP,
+            TRIANGLE_LEFT,
+            TRIANGLE_DOWN,
+            TRIANGLE_RIGHT,
+            NUM_QUAD_TRIANGLES
+        };
+
+        // Which triangle of a quad faces the edge, and which ones face the previous and next quad along it, indexed by Edge
+        constexpr QuadTriangle EDGE_OUTER_TRIANGLE[NUM_EDGES] = { TRIANGLE_UP, TRIANGLE_RIGHT, TRIANGLE_DOWN, TRIANGLE_LEFT };
+        constexpr QuadTriangle EDGE_PREVIOUS_TRIANGLE[NUM_EDGES] = { TRIANGLE_LEFT, TRIANGLE_UP, TRIANGLE_LEFT, TRIANGLE_UP };
+        constexpr QuadTriangle EDGE_NEXT_TRIANGLE[NUM_EDGES] = { TRIANGLE_RIGHT, TRIANGLE_DOWN, TRIANGLE_RIGHT, TRIANGLE_DOWN };
+
+        u16 GetOuterVertex(u32 x, u32 y)
+        {
+            return static_cast<u16>((y * Terrain::CELL_GRID_ROW_SIZE) + x);
+        }
+
+        // Level 0 quads are a single patch and use its inner vertex, coarser quads have an outer vertex in their center
+        u16 GetCenterVertex(u32 quadX, u32 quadY, u32 stride)
+        {
+            if (stride == 1)
+                return static_cast<u16>((quadY * Terrain::CELL_GRID_ROW_SIZE) + Terrain::CELL_OUTER_GRID_STRIDE + quadX);
+
+            return GetOuterVertex((quadX * stride) + (stride / 2), (quadY * stride) + (stride / 2));
+        }
+
+        // u runs along the edge and v goes into the cell
+        u16 GetEdgeVertex(u32 edge, u32 u, u32 v)
+        {
+            switch (edge)
+            {
+                case EDGE_TOP: return GetOuterVertex(u, v);
+                case EDGE_RIGHT: return GetOuterVertex(GRID_SIZE - v, u);
+                case EDGE_BOTTOM: return GetOuterVertex(u, GRID_SIZE - v);
+                default: return GetOuterVertex(v, u);
+            }
+        }
+
+        u32 GetEdgeQuad(u32 edge, u32 quadAlongEdge, u32 numQuadsPerSide)
+        {
+            switch (edge)
+            {
+                case EDGE_TOP: return quadAlongEdge;
+                case EDGE_RIGHT: return (quadAlongEdge * numQuadsPerSide) + (numQuadsPerSide - 1);
+                case EDGE_BOTTOM: return ((numQuadsPerSide - 1) * numQuadsPerSide) + quadAlongEdge;
+                default: return quadAlongEdge * numQuadsPerSide;
+            }
+        }
+
+        // Twice the signed area in patch units with rows growing downwards, inner vertices sit half a patch in
+        i32 GetDoubleSignedArea(u16 a, u16 b, u16 c)
+        {
+            auto getPosition = [](u16 vertexID, i32& x, i32& y)
+            {
+                const u32 row = vertexID / Terrain::CELL_GRID_ROW_SIZE;
+                const u32 column = vertexID % Terrain::CELL_GRID_ROW_SIZE;
+                const bool isInner = column >= Terrain::CELL_OUTER_GRID_STRIDE;
+
+                x = static_cast<i32>(isInner ? ((column - Terrain::CELL_OUTER_GRID_STRIDE) * 2) + 1 : column * 2);
+                y = static_cast<i32>(isInner ? (row * 2) + 1 : row * 2);
+            };
+
+            i32 ax, ay, bx, by, cx, cy;
+            getPosition(a, ax, ay);
+            getPosition(b, bx, by);
+            getPosition(c, cx, cy);
+
+            return ((bx - ax) * (cy - ay)) - ((by - ay) * (cx - ax));
+        }
+
+        // Stitched triangles are emitted in whatever order is convenient, this keeps the winding of the regular ones
+        void EmitTriangle(std::vector<u16>& indices, u16 a, u16 b, u16 c)
+        {
+            i32 doubleArea = GetDoubleSignedArea(a, b, c);
+            NC_ASSERT(doubleArea != 0, "TerrainLod : Stitched triangle ({0}, {1}, {2}) is degenerate", a, b, c);
+
+            if (doubleArea > 0)
+                std::swap(b, c);
+
+            indices.push_back(a);
+            indices.push_back(b);
+            indices.push_back(c);
+        }
+
+        void BuildPattern(u32 level, u32 stitchMask, std::vector<u16>& indices)
+        {
+            const u32 stride = 1u << level;
+            const u32 numQuadsPerSide = GRID_SIZE / stride;
+
+            std::vector<u8> skippedTriangles(numQuadsPerSide * numQuadsPerSide * NUM_QUAD_TRIANGLES, 0);
+
+            // Stitching decides which regular triangles to skip, but goes after them so the unstitched level 0 pattern
+            // comes out the same as the original cell index buffer
+            const size_t patternStart = indices.size();
+            std::vector<u16> stitchedIndices;
+
+            for (u32 edge = 0; edge < NUM_EDGES; edge++)
+            {
+                if ((stitchMask & (1u << edge)) == 0)
+                    continue;
+
+                NC_ASSERT(numQuadsPerSide >= 2, "TerrainLod : Level {0} can't be stitched to a coarser neighbour", level);
+
+                // Pairs of quads along the edge drop their shared edge vertex. The four triangles touching it are replaced
+                // by three fanning out from the first quad's center, the rest of the pair keeps its regular triangles
+                for (u32 quadAlongEdge = 0; quadAlongEdge + 1 < numQuadsPerSide; quadAlongEdge += 2)
+                {
+                    const u32 firstQuad = GetEdgeQuad(edge, quadAlongEdge, numQuadsPerSide);
+                    const u32 secondQuad = GetEdgeQuad(edge, quadAlongEdge + 1, numQuadsPerSide);
+
+                    skippedTriangles[(firstQuad * NUM_QUAD_TRIANGLES) + EDGE_OUTER_TRIANGLE[edge]] = 1;
+                    skippedTriangles[(firstQuad * NUM_QUAD_TRIANGLES) + EDGE_NEXT_TRIANGLE[edge]] = 1;
+                    skippedTriangles[(secondQuad * NUM_QUAD_TRIANGLES) + EDGE_PREVIOUS_TRIANGLE[edge]] = 1;
+                    skippedTriangles[(secondQuad * NUM_QUAD_TRIANGLES) + EDGE_OUTER_TRIANGLE[edge]] = 1;
+
+                    const u16 firstCenter = GetCenterVertex(firstQuad % numQuadsPerSide, firstQuad / numQuadsPerSide, stride);
+                    const u16 secondCenter = GetCenterVertex(secondQuad % numQuadsPerSide, secondQuad / numQuadsPerSide, stride);
+
+                    const u16 edgeStart = GetEdgeVertex(edge, quadAlongEdge * stride, 0);
+                    const u16 edgeEnd = GetEdgeVertex(edge, (quadAlongEdge + 2) * stride, 0);
+                    const u16 innerCorner = GetEdgeVertex(edge, (quadAlongEdge + 1) * stride, stride);
+
+                    EmitTriangle(stitchedIndices, firstCenter, edgeStart, edgeEnd);
+                    EmitTriangle(stitchedIndices, firstCenter, edgeEnd, secondCenter);
+                    EmitTriangle(stitchedIndices, firstCenter, secondCenter, innerCorner);
+                }
+            }
+
+            for (u32 quadY = 0; quadY < numQuadsPerSide; quadY++)
+            {
+                for (u32 quadX = 0; quadX < numQuadsPerSide; quadX++)
+                {
+                    const u8* skipped = &skippedTriangles[((quadY * numQuadsPerSide) + quadX) * NUM_QUAD_TRIANGLES];
+
+                    const u16 topLeftVertex = GetOuterVertex(quadX * stride, quadY * stride);
+                    const u16 topRightVertex = GetOuterVertex((quadX + 1) * stride, quadY * stride);
+                    const u16 bottomLeftVertex = GetOuterVertex(quadX * stride, (quadY + 1) * stride);
+                    const u16 bottomRightVertex = GetOuterVertex((quadX + 1) * stride, (quadY + 1) * stride);
+                    const u16 centerVertex = GetCenterVertex(quadX, quadY, stride);
+
+                    if (!skipped[TRIANGLE_UP])
+                    {
+                        indices.push_back(topLeftVertex);
+                        indices.push_back(centerVertex);
+                        indices.push_back(topRightVertex);
+                    }
+
+                    if (!skipped[TRIANGLE_LEFT])
+                    {
+                        indices.push_back(bottomLeftVertex);
+                        indices.push_back(centerVertex);
+                        indices.push_back(topLeftVertex);
+                    }
+
+                    if (!skipped[TRIANGLE_DOWN])
+                    {
+                        indices.push_back(bottomRightVertex);
+                        indices.push_back(centerVertex);
+                        indices.push_back(bottomLeftVertex);
+                    }
+
+                    if (!skipped[TRIANGLE_RIGHT])
+                    {
+                        indices.push_back(topRightVertex);
+                        indices.push_back(centerVertex);
+                        indices.push_back(bottomRightVertex);
+                    }
+                }
+            }
+
+            indices.insert(indices.end(), stitchedIndices.begin(), stitchedIndices.end());
+            NC_ASSERT((indices.size() - patternStart) % 3 == 0, "TerrainLod : Pattern for level {0} has a partial triangle", level);
+        }
+    }
+
+    u32 GetPatternID(u32 level, u32 stitchMask)
+    {
+        NC_ASSERT(level < NUM_LEVELS, "TerrainLod : Level {0} is out of range", level);
+
+        if (level == NUM_LEVELS - 1)
+            return NUM_PATTERNS - 1;
+
+        return (level * NUM_STITCH_MASKS) + (stitchMask & (NUM_STITCH_MASKS - 1));
+    }
+
+    void BuildPatterns(std::vector<u16>& outIndices, std::vector<Pattern>& outPatterns)
+    {
+        ZoneScopedN("TerrainLod::BuildPatterns");
+
+        outIndices.clear();
+        outPatterns.clear();
+        outPatterns.resize(NUM_PATTERNS);
+
+        for (u32 level = 0; level < NUM_LEVELS; level++)
+        {
+            const u32 numStitchMasks = (level == NUM_LEVELS - 1) ? 1 : NUM_STITCH_MASKS;
+
+            for (u32 stitchMask = 0; stitchMask < numStitchMasks; stitchMask++)
+            {
+                Pattern& pattern = outPatterns[GetPatternID(level, stitchMask)];
+                pattern.firstIndex = static_cast<u32>(outIndices.size());
+
+                BuildPattern(level, stitchMask, outIndices);
+                pattern.indexCount = static_cast<u32>(outIndices.size()) - pattern.firstIndex;
+            }
+        }
+    }
+
+    u32 GetCellGridIndex(u32 chunkID, u32 cellID)
+    {
+        const u32 chunkX = chunkID % Terrain::CHUNK_NUM_PER_MAP_STRIDE;
+        const u32 chunkY = chunkID / Terrain::CHUNK_NUM_PER_MAP_STRIDE;
+
+        const u32 cellX = (chunkX * Terrain::CHUNK_NUM_CELLS_PER_STRIDE) + (cellID % Terrain::CHUNK_NUM_CELLS_PER_STRIDE);
+        const u32 cellY = (chunkY * Terrain::CHUNK_NUM_CELLS_PER_STRIDE) + (cellID / Terrain::CHUNK_NUM_CELLS_PER_STRIDE);
+
+        return cellX + (cellY * CELL_GRID_STRIDE);
+    }
+
+    void BuildNeighbours(std::span<const u32> cellGridIndices, std::vector<CellNeighbours>& outNeighbours)
+    {
+        ZoneScopedN("TerrainLod::BuildNeighbours");
+
+        const u32 numCells = static_cast<u32>(cellGridIndices.size());
+
+        std::vector<std::pair<u32, u32>> sortedCells;
+        sortedCells.reserve(numCells);
+
+        for (u32 cellIndex = 0; cellIndex < numCells; cellIndex++)
+        {
+            if (cellGridIndices[cellIndex] != INVALID_CELL)
+                sortedCells.emplace_back(cellGridIndices[cellIndex], cellIndex);
+        }
+        std::sort(sortedCells.begin(), sortedCells.end());
+
+        auto findCell = [&sortedCells](u32 gridIndex) -> u32
+        {
+            auto itr = std::lower_bound(sortedCells.begin(), sortedCells.end(), std::pair<u32, u32>(gridIndex, 0));
+            return (itr != sortedCells.end() && itr->first == gridIndex) ? itr->second : INVALID_CELL;
+        };
+
+        outNeighbours.resize(numCells);
+        for (u32 cellIndex = 0; cellIndex < numCells; cellIndex++)
+        {
+            CellNeighbours& neighbours = outNeighbours[cellIndex];
+            neighbours.fill(INVALID_CELL);
+
+            const u32 gridIndex = cellGridIndices[cellIndex];
+            if (gridIndex == INVALID_CELL)
+                continue;
+
+            const u32 x = gridIndex % CELL_GRID_STRIDE;
+            const u32 y = gridIndex / CELL_GRID_STRIDE;
+
+            if (y > 0)
+                neighbours[EDGE_TOP] = findCell(gridIndex - CELL_GRID_STRIDE);
+
+            if (x + 1 < CELL_GRID_STRIDE)
+                neighbours[EDGE_RIGHT] = findCell(gridIndex + 1);
+
+            if (y + 1 < CELL_GRID_STRIDE)
+                neighbours[EDGE_BOTTOM] = findCell(gridIndex + CELL_GRID_STRIDE);
+
+            if (x > 0)
+                neighbours[EDGE_LEFT] = findCell(gridIndex - 1);
+        }
+    }
+
+    f32 GetLevelError(u32 level, f32 heightSpan)
+    {
+        if (level == 0)
+            return 0.0f;
+
+        // A coarse quad covers stride / GRID_SIZE of the cell, the surface under it can't leave the cell's height range
+        const u32 stride = 1u << level;
+        return heightSpan * static_cast<f32>(stride) / static_cast<f32>(GRID_SIZE);
+    }
+
+    u32 SelectLevel(f32 heightSpan, f32 distance, f32 pixelsPerUnit, f32 maxPixelError)
+    {
+        const f32 pixelsPerWorldUnit = pixelsPerUnit / std::max(distance, 1.0f);
+
+        u32 level = 0;
+        for (u32 nextLevel = 1; nextLevel < NUM_LEVELS; nextLevel++)
+        {
+            if (GetLevelError(nextLevel, heightSpan) * pixelsPerWorldUnit > maxPixelError)
+                break;
+
+            level = nextLevel;
+        }
+
+        return level;
+    }
+
+    void LimitNeighbourLevels(std::span<u8> levels, std::span<const CellNeighbours> neighbours)
+    {
+        ZoneScopedN("TerrainLod::LimitNeighbourLevels");
+
+        NC_ASSERT(levels.size() == neighbours.size(), "TerrainLod : Got {0} levels for {1} cells", levels.size(), neighbours.size());
+        const u32 numCells = static_cast<u32>(levels.size());
+
+        // Each pass spreads finer levels one more cell out. Done in place, no cell can be lowered any further after NUM_LEVELS - 2 passes
+        for (u32 pass = 0; pass + 2 < NUM_LEVELS; pass++)
+        {
+            for (u32 cellIndex = 0; cellIndex < numCells; cellIndex++)
+            {
+                u8 level = levels[cellIndex];
+
+                for (u32 neighbourIndex : neighbours[cellIndex])
+                {
+                    if (neighbourIndex != INVALID_CELL)
+                        level = std::min(level, static_cast<u8>(levels[neighbourIndex] + 1));
+                }
+
+                levels[cellIndex] = level;
+            }
+        }
+    }
+
+    u32 GetStitchMask(std::span<const u8> levels, const CellNeighbours& neighbours, u32 cellIndex)
+    {
+        u32 stitchMask = 0;
+
+        for (u32 edge = 0; edge < NUM_EDGES; edge++)
+        {
+            const u32 neighbourIndex = neighbours[edge];
+            if (neighbourIndex != INVALID_CELL && levels[neighbourIndex] > levels[cellIndex])
+                stitchMask |= 1u << edge;
+        }
+
+        return stitchMask;
+    }
+}
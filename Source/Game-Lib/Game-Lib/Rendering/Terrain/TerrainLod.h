@@ -0,0 +1,58 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <FileFormat/Shared.h>
+
+#include <array>
+#include <span>
+#include <vector>
+
+// Pure CPU side of the terrain geometry LOD, TerrainRenderer owns the buffers and draws.
+// Level 0 is the full CELL_NUM_TRIANGLES tessellation, every level after it doubles the patch stride. Each quad is
+// split into four triangles around its center like level 0, so an edge only has to match the neighbour's edge vertices.
+// Neighbouring cells are kept at most one level apart and the finer cell stitches its edge to the coarser one.
+namespace TerrainLod
+{
+    enum Edge : u32
+    {
+        EDGE_TOP, // Vertex row 0
+        EDGE_RIGHT, // Vertex column 8
+        EDGE_BOTTOM, // Vertex row 8
+        EDGE_LEFT, // Vertex column 0
+        NUM_EDGES
+    };
+
+    constexpr u32 NUM_LEVELS = 4;
+    constexpr u32 NUM_STITCH_MASKS = 1u << NUM_EDGES;
+
+    // The coarsest level is a single quad and no neighbour can be coarser than it, so it only has the unstitched pattern
+    constexpr u32 NUM_PATTERNS = ((NUM_LEVELS - 1) * NUM_STITCH_MASKS) + 1;
+
+    constexpr u32 CELL_GRID_STRIDE = Terrain::CHUNK_NUM_PER_MAP_STRIDE * Terrain::CHUNK_NUM_CELLS_PER_STRIDE;
+    constexpr u32 INVALID_CELL = 0xFFFFFFFF;
+
+    struct Pattern
+    {
+    public:
+        u32 firstIndex = 0;
+        u32 indexCount = 0;
+    };
+
+    using CellNeighbours = std::array<u32, NUM_EDGES>; // Indices of the neighbouring cells, INVALID_CELL if not loaded
+
+    // Pattern 0 is the unstitched level 0 pattern and matches the original cell index buffer
+    u32 GetPatternID(u32 level, u32 stitchMask);
+    void BuildPatterns(std::vector<u16>& outIndices, std::vector<Pattern>& outPatterns);
+
+    // Position of the cell in the map wide cell grid, rows grow with the vertex rows of the cell
+    u32 GetCellGridIndex(u32 chunkID, u32 cellID);
+    void BuildNeighbours(std::span<const u32> cellGridIndices, std::vector<CellNeighbours>& outNeighbours);
+
+    // World space error of drawing a cell at a level, the height the cell spans bounds how far a coarser grid can move the surface
+    f32 GetLevelError(u32 level, f32 heightSpan);
+    u32 SelectLevel(f32 heightSpan, f32 distance, f32 pixelsPerUnit, f32 maxPixelError);
+
+    // Refines cells until no neighbours are more than one level apart, then gets which edges need stitching
+    void LimitNeighbourLevels(std::span<u8> levels, std::span<const CellNeighbours> neighbours);
+    u32 GetStitchMask(std::span<const u8> levels, const CellNeighbours& neighbours, u32 cellIndex);
+}
@@ -1,6 +1,9 @@
 #include "TerrainRenderer.h"
 #include "Game-Lib/Application/EnttRegistries.h"
+#include "Game-Lib/ECS/Components/Camera.h"
+#include "Game-Lib/ECS/Singletons/ActiveCamera.h"
 #include "Game-Lib/ECS/Singletons/Database/TextureSingleton.h"
+#include "Game-Lib/ECS/Util/Transforms.h"
 #include "Game-Lib/Rendering/RenderUtils.h"
 #include "Game-Lib/Rendering/GameRenderer.h"
 #include "Game-Lib/Rendering/Shadow/ShadowRenderer.h"
@@ -35,6 +38,20 @@ AutoCVar_Int CVAR_TerrainValidateTransfers(CVarCategory::Client | CVarCategory::
 
 AutoCVar_Int CVAR_TerrainCastShadow(CVarCategory::Client | CVarCategory::Rendering, "shadowTerrainCastShadow", "should Terrain cast shadows", 1, CVarFlags::EditCheckbox);
 
+AutoCVar_Int CVAR_TerrainLodEnabled(CVarCategory::Client | CVarCategory::Rendering, "terrainLodEnabled", "draw distant terrain cells with coarser tessellations", 1, CVarFlags::EditCheckbox);
+AutoCVar_Float CVAR_TerrainLodMaxPixelError(CVarCategory::Client | CVarCategory::Rendering, "terrainLodMaxPixelError", "largest on screen error in pixels a terrain cell LOD may have before a finer one is drawn", 2.0f, CVarFlags::None);
+AutoCVar_Float CVAR_TerrainLodMinHeightSpan(CVarCategory::Client | CVarCategory::Rendering, "terrainLodMinHeightSpan", "smallest height span a cell is treated as having when picking its LOD, keeps flat cells from collapsing right in front of the camera", 1.0f, CVarFlags::None);
+AutoCVar_Float CVAR_TerrainLodUpdateDistance(CVarCategory::Client | CVarCategory::Rendering, "terrainLodUpdateDistance", "distance the camera has to move before terrain LODs are picked again", 4.0f, CVarFlags::None);
+
+// The argument buffer holds one draw per LOD pattern followed by one that only counts the surviving cells for the readbacks
+constexpr u32 TERRAIN_NUM_ARGUMENTS = TerrainLod::NUM_PATTERNS + 1;
+constexpr u32 TERRAIN_ARGUMENTS_SIZE = TERRAIN_NUM_ARGUMENTS * sizeof(Renderer::IndexedIndirectDraw);
+constexpr u32 TERRAIN_SURVIVOR_COUNT_OFFSET = (TerrainLod::NUM_PATTERNS * sizeof(Renderer::IndexedIndirectDraw)) + offsetof(Renderer::IndexedIndirectDraw, instanceCount);
+
+// Per cell pattern IDs sit in the low bits, the first index of the pattern above them for the material pass, see TERRAIN_LOD_PATTERN_ID_BITS in TerrainShared
+constexpr u32 TERRAIN_LOD_PATTERN_ID_BITS = 8;
+static_assert(TerrainLod::NUM_PATTERNS <= (1u << TERRAIN_LOD_PATTERN_ID_BITS));
+
 TerrainRenderer::TerrainRenderer(Renderer::Renderer* renderer, GameRenderer* gameRenderer, DebugRenderer* debugRenderer)
     : _renderer(renderer)
     , _gameRenderer(gameRenderer)
@@ -56,6 +73,8 @@ TerrainRenderer::TerrainRenderer(Renderer::Renderer* renderer, GameRenderer* gam
         _cellDatas.SetValidation(true);
         _chunkDatas.SetValidation(true);
         _cellHeightRanges.SetValidation(true);
+        _cellLodPatterns.SetValidation(true);
+        _lodDrawArguments.SetValidation(true);
     }
 
     CreatePermanentResources();
@@ -112,6 +131,7 @@ void TerrainRenderer::Update(f32 deltaTime)
         }
     }
 
+    UpdateCellLods();
     SyncToGPU();
 }
 
@@ -137,6 +157,7 @@ void TerrainRenderer::AddOccluderPass(Renderer::RenderGraph* renderGraph, Render
         Renderer::BufferMutableResource culledInstanceBuffer;
         Renderer::BufferMutableResource culledInstanceBitMaskBuffer;
         Renderer::BufferMutableResource argumentBuffer;
+        Renderer::BufferResource lodDrawArguments;
         Renderer::BufferMutableResource occluderDrawCountReadBackBuffer;
 
         Renderer::DescriptorSetResource globalSet;
@@ -157,11 +178,13 @@ void TerrainRenderer::AddOccluderPass(Renderer::RenderGraph* renderGraph, Render
             builder.Read(_cellDatas.GetBuffer(), BufferUsage::GRAPHICS);
             builder.Read(_chunkDatas.GetBuffer(), BufferUsage::GRAPHICS);
             builder.Read(resources.cameras.GetBuffer(), BufferUsage::GRAPHICS);
+            builder.Read(_cellLodPatterns.GetBuffer(), BufferUsage::COMPUTE);
 
             data.culledInstanceBuffer = builder.Write(_culledInstanceBuffer, BufferUsage::TRANSFER | BufferUsage::COMPUTE | BufferUsage::GRAPHICS);
             data.culledInstanceBitMaskBuffer = builder.Write(_culledInstanceBitMaskBuffer.Get(!frameIndex), BufferUsage::COMPUTE | BufferUsage::TRANSFER);
             builder.Write(_culledInstanceBitMaskBuffer.Get(frameIndex), BufferUsage::COMPUTE | BufferUsage::TRANSFER);
             data.argumentBuffer = builder.Write(_argumentBuffer, BufferUsage::TRANSFER | BufferUsage::GRAPHICS | BufferUsage::COMPUTE);
+            data.lodDrawArguments = builder.Read(_lodDrawArguments.GetBuffer(), BufferUsage::TRANSFER);
             data.occluderDrawCountReadBackBuffer = builder.Write(_occluderDrawCountReadBackBuffer, BufferUsage::TRANSFER);
 
             data.globalSet = builder.Use(resources.globalDescriptorSet);
@@ -186,7 +209,7 @@ void TerrainRenderer::AddOccluderPass(Renderer::RenderGraph* renderGraph, Render
             // Reset the counters
             {
                 commandList.BufferBarrier(data.argumentBuffer, Renderer::BufferPassUsage::TRANSFER);
-                commandList.FillBuffer(data.argumentBuffer, 4, 16, 0); // Reset everything but indexCount to 0
+                commandList.CopyBuffer(data.argumentBuffer, 0, data.lodDrawArguments, 0, TERRAIN_ARGUMENTS_SIZE); // Zeroed counts with the per pattern index and instance ranges
                 commandList.BufferBarrier(data.argumentBuffer, Renderer::BufferPassUsage::TRANSFER);
             }
 
@@ -225,7 +248,7 @@ void TerrainRenderer::AddOccluderPass(Renderer::RenderGraph* renderGraph, Render
             }
 
             // Copy drawn count
-            commandList.CopyBuffer(data.occluderDrawCountReadBackBuffer, 0, data.argumentBuffer, 4, 4);
+            commandList.CopyBuffer(data.occluderDrawCountReadBackBuffer, 0, data.argumentBuffer, TERRAIN_SURVIVOR_COUNT_OFFSET, 4);
         });
 }
 
@@ -345,6 +368,7 @@ void TerrainRenderer::AddGeometryPass(Renderer::RenderGraph* renderGraph, Render
         Renderer::BufferMutableResource culledInstanceBuffer;
 
         Renderer::BufferMutableResource argumentBuffer;
+        Renderer::BufferResource lodDrawArguments;
         Renderer::BufferMutableResource drawCountReadBackBuffer;
         Renderer::BufferMutableResource occluderDrawCountReadBackBuffer;
 
@@ -371,9 +395,11 @@ void TerrainRenderer::AddGeometryPass(Renderer::RenderGraph* renderGraph, Render
             if (cullingEnabled)
             {
                 builder.Read(_instanceDatas.GetBuffer(), BufferUsage::COMPUTE | BufferUsage::GRAPHICS);
+                builder.Read(_cellLodPatterns.GetBuffer(), BufferUsage::COMPUTE);
             }
 
             data.argumentBuffer = builder.Write(_argumentBuffer, BufferUsage::TRANSFER | BufferUsage::GRAPHICS | BufferUsage::COMPUTE);
+            data.lodDrawArguments = builder.Read(_lodDrawArguments.GetBuffer(), BufferUsage::TRANSFER);
             data.drawCountReadBackBuffer = builder.Write(_drawCountReadBackBuffer, BufferUsage::TRANSFER);
             data.occluderDrawCountReadBackBuffer = builder.Write(_occluderDrawCountReadBackBuffer, BufferUsage::TRANSFER);
 
@@ -390,7 +416,7 @@ void TerrainRenderer::AddGeometryPass(Renderer::RenderGraph* renderGraph, Render
             // Reset the counters
             {
                 commandList.BufferBarrier(data.argumentBuffer, Renderer::BufferPassUsage::TRANSFER);
-                commandList.FillBuffer(data.argumentBuffer, 4, 16, 0); // Reset everything but indexCount to 0
+                commandList.CopyBuffer(data.argumentBuffer, 0, data.lodDrawArguments, 0, TERRAIN_ARGUMENTS_SIZE); // Zeroed counts with the per pattern index and instance ranges
                 commandList.BufferBarrier(data.argumentBuffer, Renderer::BufferPassUsage::TRANSFER);
             }
 
@@ -431,7 +457,7 @@ void TerrainRenderer::AddGeometryPass(Renderer::RenderGraph* renderGraph, Render
 
             if (cullingEnabled)
             {
-                commandList.CopyBuffer(data.drawCountReadBackBuffer, 0, data.argumentBuffer, 4, 4);
+                commandList.CopyBuffer(data.drawCountReadBackBuffer, 0, data.argumentBuffer, TERRAIN_SURVIVOR_COUNT_OFFSET, 4);
             }
         });
 }
@@ -576,6 +602,7 @@ void TerrainRenderer::AddSVSMGeometryPass(Renderer::RenderGraph* renderGraph, Re
         Renderer::BufferMutableResource culledInstanceBuffer;
 
         Renderer::BufferMutableResource argumentBuffer;
+        Renderer::BufferResource lodDrawArguments;
         Renderer::BufferMutableResource drawCountReadBackBuffer;
 
         Renderer::DescriptorSetResource globalSet;
@@ -603,8 +630,10 @@ void TerrainRenderer::AddSVSMGeometryPass(Renderer::RenderGraph* renderGraph, Re
             builder.Read(_cellDatas.GetBuffer(), BufferUsage::GRAPHICS);
             builder.Read(_chunkDatas.GetBuffer(), BufferUsage::GRAPHICS);
             builder.Read(_instanceDatas.GetBuffer(), BufferUsage::COMPUTE | BufferUsage::GRAPHICS);
+            builder.Read(_cellLodPatterns.GetBuffer(), BufferUsage::COMPUTE);
 
             data.argumentBuffer = builder.Write(_argumentBuffer, BufferUsage::TRANSFER | BufferUsage::GRAPHICS | BufferUsage::COMPUTE);
+            data.lodDrawArguments = builder.Read(_lodDrawArguments.GetBuffer(), BufferUsage::TRANSFER);
             data.drawCountReadBackBuffer = builder.Write(_drawCountReadBackBuffer, BufferUsage::TRANSFER);
 
             data.globalSet = builder.Use(resources.globalDescriptorSet);
@@ -648,7 +677,7 @@ void TerrainRenderer::AddSVSMGeometryPass(Renderer::RenderGraph* renderGraph, Re
                 // and the fill wrote them in compute â€” the reset must wait on both (WAR/WAW)
                 {
                     commandList.BufferBarrier(data.argumentBuffer, Renderer::BufferPassUsage::GRAPHICS | Renderer::BufferPassUsage::COMPUTE | Renderer::BufferPassUsage::TRANSFER);
-                    commandList.FillBuffer(data.argumentBuffer, 4, 16, 0); // Reset everything but indexCount to 0
+                    commandList.CopyBuffer(data.argumentBuffer, 0, data.lodDrawArguments, 0, TERRAIN_ARGUMENTS_SIZE); // Zeroed counts with the per pattern index and instance ranges
                     commandList.BufferBarrier(data.argumentBuffer, Renderer::BufferPassUsage::TRANSFER);
                 }
 
@@ -692,7 +721,7 @@ void TerrainRenderer::AddSVSMGeometryPass(Renderer::RenderGraph* renderGraph, Re
                 // Copy drawn count
                 {
                     u32 dstOffset = i * sizeof(u32);
-                    commandList.CopyBuffer(data.drawCountReadBackBuffer, dstOffset, data.argumentBuffer, 4, 4);
+                    commandList.CopyBuffer(data.drawCountReadBackBuffer, dstOffset, data.argumentBuffer, TERRAIN_SURVIVOR_COUNT_OFFSET, 4);
                 }
 
                 commandList.PopMarker();
@@ -722,6 +751,13 @@ void TerrainRenderer::Clear()
     _cellBoundingBoxes.clear();
     _vertices.Clear();
 
+    _cellLodPatterns.Clear();
+    _cellNeighbours.clear();
+    _cellLodLevels.clear();
+    _cellNeighboursDirty = true;
+    _numLodCells = 0;
+    _numLodTriangles = 0;
+
     _renderer->UnloadTexturesInArray(_textures, 1);
     _renderer->UnloadTexturesInArray(_alphaTextures, 1);
 }
@@ -1004,6 +1040,7 @@ u32 TerrainRenderer::AddChunk(u32 chunkHash, const Map::Chunk* chunk, ivec2 chun
         }
     }
 
+    _cellNeighboursDirty = true;
     return chunkDataStartOffset;
 }
 
@@ -1023,6 +1060,7 @@ bool TerrainRenderer::HideChunk(u32 chunkDataIndex)
     }
 
     _cellDatas.SetDirtyElements(cellDataStartOffset, Terrain::CHUNK_NUM_CELLS);
+    _cellNeighboursDirty = true;
     return true;
 }
 
@@ -1035,14 +1073,32 @@ bool TerrainRenderer::ReplaceChunk(u32 chunkDataIndex, u32 chunkHash, const Map:
     const u32 vertexDataStartOffset = cellDataStartOffset * Terrain::CELL_NUM_VERTICES;
     AddChunk(chunkHash, &chunk, chunkGridPos, chunkDataIndex, cellDataStartOffset, vertexDataStartOffset);
 
+    return MarkChunkDirty(chunkDataIndex);
+}
+
+bool TerrainRenderer::MarkChunkDirty(u32 chunkDataIndex)
+{
+    if (chunkDataIndex >= _chunkDatas.Count())
+        return false;
+
+    const u32 cellDataStartOffset = chunkDataIndex * Terrain::CHUNK_NUM_CELLS;
+    const u32 vertexDataStartOffset = cellDataStartOffset * Terrain::CELL_NUM_VERTICES;
+
     _chunkDatas.SetDirtyElement(chunkDataIndex);
     _cellDatas.SetDirtyElements(cellDataStartOffset, Terrain::CHUNK_NUM_CELLS);
     _instanceDatas.SetDirtyElements(cellDataStartOffset, Terrain::CHUNK_NUM_CELLS);
     _cellHeightRanges.SetDirtyElements(cellDataStartOffset, Terrain::CHUNK_NUM_CELLS);
     _vertices.SetDirtyElements(vertexDataStartOffset, Terrain::CHUNK_NUM_CELLS * Terrain::CELL_NUM_VERTICES);
+    _cellNeighboursDirty = true;
     return true;
 }
 
+u64 TerrainRenderer::GetChunkGPUBytes()
+{
+    constexpr u64 cellBytes = sizeof(InstanceData) + sizeof(CellData) + sizeof(CellHeightRange) + (Terrain::CELL_NUM_VERTICES * sizeof(TerrainVertex));
+    return sizeof(ChunkData) + (Terrain::CHUNK_NUM_CELLS * cellBytes);
+}
+
 bool TerrainRenderer::UpdateChunkCells(u32 chunkDataIndex, const Map::Chunk& chunk, std::span<const u16> cellIDs)
 {
     if (chunkDataIndex >= _chunkDatas.Count())
@@ -1089,6 +1145,8 @@ bool TerrainRenderer::UpdateChunkCells(u32 chunkDataIndex, const Map::Chunk& chu
     Geometry::AABoundingBox& chunkBounds = _chunkBoundingBoxes[chunkDataIndex];
     chunkBounds.center.y = (chunk.heightHeader.gridMinHeight + chunk.heightHeader.gridMaxHeight) * 0.5f;
     chunkBounds.extents.y = (chunk.heightHeader.gridMaxHeight - chunk.heightHeader.gridMinHeight) * 0.5f;
+
+    _cellNeighboursDirty = true; // The height ranges the LODs are picked from changed
     return true;
 }
 
@@ -1215,6 +1273,8 @@ void TerrainRenderer::RegisterMaterialPassBufferUsage(Renderer::RenderGraphBuild
     builder.Read(_cellDatas.GetBuffer(), BufferUsage::COMPUTE);
     builder.Read(_chunkDatas.GetBuffer(), BufferUsage::COMPUTE);
     builder.Read(_culledInstanceBuffer, BufferUsage::COMPUTE);
+    builder.Read(_cellLodPatterns.GetBuffer(), BufferUsage::COMPUTE);
+    builder.Read(_cellIndices.GetBuffer(), BufferUsage::COMPUTE);
 }
 
 void TerrainRenderer::CreatePermanentResources()
@@ -1283,19 +1343,19 @@ void TerrainRenderer::CreatePermanentResources()
     _cullingPassDescriptorSet.Bind("_depthSampler"_h, _occlusionSampler);
 
     _cellIndices.SetDebugName("TerrainIndices");
-    _cellIndices.SetUsage(Renderer::BufferUsage::INDEX_BUFFER);
+    _cellIndices.SetUsage(Renderer::BufferUsage::INDEX_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER); // The material pass reads the triangles of LOD patterns from it
 
     // Argument buffers
     {
         Renderer::BufferDesc desc;
         desc.name = "TerrainArgumentBuffer";
-        desc.size = sizeof(Renderer::IndexedIndirectDraw);
+        desc.size = TERRAIN_ARGUMENTS_SIZE;
         desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION | Renderer::BufferUsage::TRANSFER_SOURCE;
         _argumentBuffer = _renderer->CreateBuffer(_argumentBuffer, desc);
 
+        // Every pass copies _lodDrawArguments over this before filling it, zeroed draws until then
         auto uploadBuffer = _renderer->CreateUploadBuffer(_argumentBuffer, 0, desc.size);
         memset(uploadBuffer->mappedMemory, 0, desc.size);
-        static_cast<u32*>(uploadBuffer->mappedMemory)[0] = Terrain::CELL_NUM_INDICES;
 
         _occluderFillPassDescriptorSet.Bind("_drawCount"_h, _argumentBuffer);
         _geometryFillPassDescriptorSet.Bind("_drawCount"_h, _argumentBuffer);
@@ -1308,51 +1368,21 @@ void TerrainRenderer::CreatePermanentResources()
         _occluderDrawCountReadBackBuffer = _renderer->CreateBuffer(_occluderDrawCountReadBackBuffer, desc);
     }
 
-    // Set up cell index buffer
+    // Set up cell index buffer, every LOD pattern gets its own range of it
     {
-        _cellIndices.AddCount(Terrain::CELL_NUM_INDICES);
-        u32 index = 0;
+        std::vector<u16> indices;
+        TerrainLod::BuildPatterns(indices, _lodPatterns);
+        NC_ASSERT(indices.size() < (1u << (32 - TERRAIN_LOD_PATTERN_ID_BITS)), "TerrainRenderer : The LOD patterns need {0} indices, more than the packed cell patterns can address", indices.size());
 
-        for (u32 row = 0; row < Terrain::CELL_INNER_GRID_STRIDE; row++)
+        _cellIndices.AddCount(static_cast<u32>(indices.size()));
+        for (u32 i = 0; i < indices.size(); i++)
         {
-            for (u32 col = 0; col < Terrain::CELL_INNER_GRID_STRIDE; col++)
-            {
-                const u32 baseVertex = (row * Terrain::CELL_GRID_ROW_SIZE + col);
-
-                //1     2
-                //   0
-                //3     4
-
-                const u32 topLeftVertex = baseVertex;
-                const u32 topRightVertex = baseVertex + 1;
-                const u32 bottomLeftVertex = baseVertex + Terrain::CELL_GRID_ROW_SIZE;
-                const u32 bottomRightVertex = bottomLeftVertex + 1;
-                const u32 centerVertex = baseVertex + Terrain::CELL_OUTER_GRID_STRIDE;
-
-                // Up triangle
-                _cellIndices[index++] = topLeftVertex;
-                _cellIndices[index++] = centerVertex;
-                _cellIndices[index++] = topRightVertex;
-
-                // Left triangle
-                _cellIndices[index++] = bottomLeftVertex;
-                _cellIndices[index++] = centerVertex;
-                _cellIndices[index++] = topLeftVertex;
-
-                // Down triangle
-                _cellIndices[index++] = bottomRightVertex;
-                _cellIndices[index++] = centerVertex;
-                _cellIndices[index++] = bottomLeftVertex;
-
-                // Right triangle
-                _cellIndices[index++] = topRightVertex;
-                _cellIndices[index++] = centerVertex;
-                _cellIndices[index++] = bottomRightVertex;
-            }
+            _cellIndices[i] = indices[i];
         }
     }
 
     _cellIndices.SyncToGPU(_renderer);
+    resources.terrainDescriptorSet.Bind("_cellIndices"_h, _cellIndices.GetBuffer());
 
     _vertices.SetDebugName("TerrainVertices");
     _vertices.SetUsage(Renderer::BufferUsage::STORAGE_BUFFER);
@@ -1365,6 +1395,13 @@ void TerrainRenderer::CreatePermanentResources()
 
     _chunkDatas.SetDebugName("TerrainChunkData");
     _chunkDatas.SetUsage(Renderer::BufferUsage::STORAGE_BUFFER);
+
+    _cellLodPatterns.SetDebugName("TerrainCellLodPatterns");
+    _cellLodPatterns.SetUsage(Renderer::BufferUsage::STORAGE_BUFFER);
+
+    _lodDrawArguments.SetDebugName("TerrainLodDrawArguments");
+    _lodDrawArguments.SetUsage(Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_SOURCE);
+    _lodDrawArguments.AddCount(TERRAIN_NUM_ARGUMENTS);
 }
 
 void TerrainRenderer::CreatePipelines()
@@ -1493,6 +1530,155 @@ void TerrainRenderer::InitDescriptorSets()
     _svsmDrawDescriptorSet.Init(_renderer);
 }
 
+void TerrainRenderer::UpdateCellLods()
+{
+    ZoneScopedN("TerrainRenderer::UpdateCellLods");
+
+    std::shared_lock lock(_addChunkMutex);
+
+    const u32 numCells = static_cast<u32>(_instanceDatas.Count());
+    const bool cellsChanged = _cellNeighboursDirty.exchange(false) || numCells != _numLodCells;
+    if (cellsChanged)
+    {
+        ZoneScopedN("Build Neighbours");
+
+        std::vector<u32> cellGridIndices(numCells);
+        for (u32 cellIndex = 0; cellIndex < numCells; cellIndex++)
+        {
+            // Hidden chunks are all holes, their neighbours are left free to pick any level
+            if (_cellDatas[cellIndex].hole == std::numeric_limits<u64>::max())
+            {
+                cellGridIndices[cellIndex] = TerrainLod::INVALID_CELL;
+                continue;
+            }
+
+            const u32 packedChunkCellID = _instanceDatas[cellIndex].packedChunkCellID;
+            cellGridIndices[cellIndex] = TerrainLod::GetCellGridIndex(packedChunkCellID >> 16, packedChunkCellID & 0xffff);
+        }
+
+        TerrainLod::BuildNeighbours(cellGridIndices, _cellNeighbours);
+    }
+
+    // Without culling there are no per pattern draws, every cell is drawn with the level 0 indices and has to use pattern 0
+    const bool cullingEnabled = true;//CVAR_TerrainCullingEnabled.Get();
+    bool lodEnabled = cullingEnabled && CVAR_TerrainLodEnabled.Get() != 0;
+    vec3 cameraPos = vec3(0.0f);
+    f32 pixelsPerUnit = 0.0f;
+
+    entt::registry* gameRegistry = ServiceLocator::GetEnttRegistries()->gameRegistry;
+    auto* activeCamera = gameRegistry->ctx().find<ECS::Singletons::ActiveCamera>();
+    if (activeCamera && activeCamera->entity != entt::null && gameRegistry->all_of<ECS::Components::Transform, ECS::Components::Camera>(activeCamera->entity))
+    {
+        cameraPos = gameRegistry->get<ECS::Components::Transform>(activeCamera->entity).GetWorldPosition();
+        const ECS::Components::Camera& camera = gameRegistry->get<ECS::Components::Camera>(activeCamera->entity);
+
+        // Pixels per world unit at a distance of one, same projection ModelRenderer picks its LODs with
+        f32 fovY = glm::radians(camera.fov) * 0.6f;
+        pixelsPerUnit = _renderer->GetRenderSize().y * 0.5f / glm::tan(fovY * 0.5f);
+    }
+    else
+    {
+        lodEnabled = false;
+    }
+
+    const f32 maxPixelError = lodEnabled ? glm::max(CVAR_TerrainLodMaxPixelError.GetFloat(), 0.0f) : 0.0f;
+    const f32 updateDistance = glm::max(CVAR_TerrainLodUpdateDistance.GetFloat(), 0.0f);
+
+    const bool cameraMoved = glm::distance(cameraPos, _lodCameraPosition) > updateDistance;
+    if (!cellsChanged && !cameraMoved && pixelsPerUnit == _lodPixelsPerUnit && maxPixelError == _lodMaxPixelError)
+        return;
+
+    _lodCameraPosition = cameraPos;
+    _lodPixelsPerUnit = pixelsPerUnit;
+    _lodMaxPixelError = maxPixelError;
+
+    // Pick the coarsest level each cell can afford on its own
+    const f32 minHeightSpan = glm::max(CVAR_TerrainLodMinHeightSpan.GetFloat(), 0.0f);
+    _cellLodLevels.resize(numCells);
+    for (u32 cellIndex = 0; cellIndex < numCells; cellIndex++)
+    {
+        if (!lodEnabled || _cellDatas[cellIndex].hole != 0)
+        {
+            _cellLodLevels[cellIndex] = 0;
+            continue;
+        }
+
+        const Geometry::AABoundingBox& bounds = _cellBoundingBoxes[cellIndex];
+        const vec3 offset = glm::max(glm::abs(cameraPos - bounds.center) - glm::abs(bounds.extents), vec3(0.0f));
+
+        const CellHeightRange& heightRange = _cellHeightRanges[cellIndex];
+        const f32 heightSpan = glm::max(heightRange.max - heightRange.min, minHeightSpan);
+
+        _cellLodLevels[cellIndex] = static_cast<u8>(TerrainLod::SelectLevel(heightSpan, glm::length(offset), pixelsPerUnit, maxPixelError));
+    }
+
+    // The vertex shader only removes hole patches through their center vertices, so cells with holes keep their
+    // neighbours at full detail too. That way they never stitch and always draw the unstitched level 0 pattern
+    for (u32 cellIndex = 0; cellIndex < numCells; cellIndex++)
+    {
+        if (_cellDatas[cellIndex].hole == 0 || _cellDatas[cellIndex].hole == std::numeric_limits<u64>::max())
+            continue;
+
+        for (u32 neighbourIndex : _cellNeighbours[cellIndex])
+        {
+            if (neighbourIndex != TerrainLod::INVALID_CELL)
+            {
+                _cellLodLevels[neighbourIndex] = 0;
+            }
+        }
+    }
+
+    TerrainLod::LimitNeighbourLevels(_cellLodLevels, _cellNeighbours);
+
+    // Count the cells per pattern, every pattern draw gets a range of the culled instance buffer big enough for all of them
+    std::array<u32, TerrainLod::NUM_PATTERNS> numPatternCells = {};
+    u32 numLodTriangles = 0;
+
+    if (_cellLodPatterns.Count() < numCells)
+    {
+        _cellLodPatterns.AddCount(numCells - _cellLodPatterns.Count());
+    }
+
+    for (u32 cellIndex = 0; cellIndex < numCells; cellIndex++)
+    {
+        const u32 stitchMask = TerrainLod::GetStitchMask(_cellLodLevels, _cellNeighbours[cellIndex], cellIndex);
+        const u32 patternID = TerrainLod::GetPatternID(_cellLodLevels[cellIndex], stitchMask);
+        const TerrainLod::Pattern& pattern = _lodPatterns[patternID];
+
+        const u32 packedPattern = patternID | (pattern.firstIndex << TERRAIN_LOD_PATTERN_ID_BITS);
+        if (_cellLodPatterns[cellIndex] != packedPattern)
+        {
+            _cellLodPatterns[cellIndex] = packedPattern;
+            _cellLodPatterns.SetDirtyElement(cellIndex);
+        }
+
+        numPatternCells[patternID]++;
+        numLodTriangles += pattern.indexCount / 3;
+    }
+
+    u32 firstInstance = 0;
+    for (u32 patternID = 0; patternID < TerrainLod::NUM_PATTERNS; patternID++)
+    {
+        const TerrainLod::Pattern& pattern = _lodPatterns[patternID];
+
+        Renderer::IndexedIndirectDraw& drawArguments = _lodDrawArguments[patternID];
+        drawArguments.indexCount = pattern.indexCount;
+        drawArguments.instanceCount = 0;
+        drawArguments.firstIndex = pattern.firstIndex;
+        drawArguments.vertexOffset = 0;
+        drawArguments.firstInstance = firstInstance;
+
+        firstInstance += numPatternCells[patternID];
+    }
+    _lodDrawArguments[TerrainLod::NUM_PATTERNS] = {};
+    _lodDrawArguments.SetDirtyElements(0, TERRAIN_NUM_ARGUMENTS);
+
+    _numLodCells = numCells;
+    _numLodTriangles = numLodTriangles;
+
+    TracyPlot("Terrain LOD Triangles", static_cast<i64>(numLodTriangles));
+}
+
 void TerrainRenderer::SyncToGPU()
 {
     ZoneScoped;
@@ -1569,6 +1755,14 @@ void TerrainRenderer::SyncToGPU()
             _cullingPassDescriptorSet.Bind("_heightRanges"_h, _cellHeightRanges.GetBuffer());
         }
     }
+
+    if (_cellLodPatterns.SyncToGPU(_renderer))
+    {
+        resources.terrainDescriptorSet.Bind("_cellLodPatterns"_h, _cellLodPatterns.GetBuffer());
+        _occluderFillPassDescriptorSet.Bind("_cellPatterns"_h, _cellLodPatterns.GetBuffer());
+        _geometryFillPassDescriptorSet.Bind("_cellPatterns"_h, _cellLodPatterns.GetBuffer());
+    }
+    _lodDrawArguments.SyncToGPU(_renderer);
 }
 
 void TerrainRenderer::Draw(const RenderResources& resources, u8 frameIndex, Renderer::RenderGraphResources& graphResources, Renderer::CommandList& commandList, DrawParams& params)
@@ -1624,7 +1818,7 @@ void TerrainRenderer::Draw(const RenderResources& resources, u8 frameIndex, Rend
 
     if (params.cullingEnabled)
     {
-        commandList.DrawIndexedIndirect(params.argumentBuffer, 0, 1);
+        commandList.DrawIndexedIndirect(params.argumentBuffer, 0, TerrainLod::NUM_PATTERNS);
     }
     else
     {
@@ -1650,10 +1844,12 @@ void TerrainRenderer::FillDrawCalls(u8 frameIndex, Renderer::RenderGraphResource
         u32 bitmaskOffset;
         u32 diffAgainstPrev;
         u32 currentBitmaskIndex;
+        u32 numLodCells;
     };
 
     FillDrawCallConstants* fillConstants = graphResources.FrameNew<FillDrawCallConstants>();
     fillConstants->numTotalInstances = params.cellCount;
+    fillConstants->numLodCells = _numLodCells; // Cells allocated since the LODs were last picked have no instance range yet
 
     u32 uintsNeededPerView = (params.cellCount + 31) / 32;
     fillConstants->bitmaskOffset = params.viewIndex * uintsNeededPerView;
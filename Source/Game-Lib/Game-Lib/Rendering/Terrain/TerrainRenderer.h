@@ -1,9 +1,12 @@
 #pragma once
+#include "Game-Lib/Rendering/Terrain/TerrainLod.h"
+
 #include <Base/Types.h>
 #include <Base/Math/Geometry.h>
 
 #include <FileFormat/Shared.h>
 
+#include <Renderer/Buffer.h>
 #include <Renderer/DescriptorSet.h>
 #include <Renderer/DescriptorSetResource.h>
 #include <Renderer/FrameResource.h>
@@ -66,6 +69,8 @@ public:
     u32 AddChunk(u32 chunkHash, const Map::Chunk* chunk, ivec2 chunkGridPos, u32 chunkDataStartOffset, u32 cellDataStartOffset, u32 vertexDataStartOffset);
     bool HideChunk(u32 chunkDataIndex);
     bool ReplaceChunk(u32 chunkDataIndex, u32 chunkHash, const Map::Chunk& chunk, ivec2 chunkGridPos);
+    bool MarkChunkDirty(u32 chunkDataIndex); // Re-uploads a chunk slot that was rewritten in place by AddChunk
+    static u64 GetChunkGPUBytes(); // Bytes one chunk slot occupies across the chunk, cell and vertex buffers
     bool UpdateChunkCells(u32 chunkDataIndex, const Map::Chunk& chunk, std::span<const u16> cellIDs);
     bool UpdateChunkTextureLayers(u32 chunkDataIndex, const Map::Chunk& chunk, std::span<const u16> cellIDs);
     bool CreateEditableAlphaMap(u32 chunkDataIndex, u64 alphaMapHash, std::span<const u8> rgbaData, Renderer::TextureID& outTextureID);
@@ -78,17 +83,20 @@ public:
     inline u32 GetNumOccluderDrawCalls(u32 viewID) { return _numOccluderDrawCalls[viewID]; }
     inline u32 GetNumSurvivingDrawCalls(u32 viewID) { return _numSurvivingDrawCalls[viewID]; }
 
-    // Triangle stats
-    inline u32 GetNumTriangles() { return GetNumDrawCalls() * Terrain::CELL_NUM_TRIANGLES; }
-    inline u32 GetNumOccluderTriangles(u32 viewID) { return GetNumOccluderDrawCalls(viewID) * Terrain::CELL_NUM_TRIANGLES; }
-    inline u32 GetNumSurvivingGeometryTriangles(u32 viewID) { return GetNumSurvivingDrawCalls(viewID) * Terrain::CELL_NUM_TRIANGLES; }
+    // Triangle stats, cells are drawn at different LODs so the culled counts use the average over all cells
+    inline u32 GetNumTriangles() { return GetNumCellTriangles(GetNumDrawCalls()); }
+    inline u32 GetNumOccluderTriangles(u32 viewID) { return GetNumCellTriangles(GetNumOccluderDrawCalls(viewID)); }
+    inline u32 GetNumSurvivingGeometryTriangles(u32 viewID) { return GetNumCellTriangles(GetNumSurvivingDrawCalls(viewID)); }
 
 private:
+    inline u32 GetNumCellTriangles(u32 numCells) { return (_numLodCells > 0) ? static_cast<u32>((static_cast<u64>(numCells) * _numLodTriangles) / _numLodCells) : numCells * Terrain::CELL_NUM_TRIANGLES; }
+
     bool ResolveTerrainTexture(u64 textureHash, u16& outArrayIndex);
     void CreatePermanentResources();
     void CreatePipelines();
     void InitDescriptorSets();
 
+    void UpdateCellLods();
     void SyncToGPU();
 
     struct DrawParams
@@ -104,7 +112,7 @@ private:
         uvec2 svsmExtent = uvec2(0, 0);
 
         Renderer::BufferResource instanceBuffer;
-        Renderer::BufferResource argumentBuffer;
+        Renderer::BufferResource argumentBuffer; // One draw per TerrainLod pattern
 
         Renderer::DescriptorSetResource globalDescriptorSet;
         Renderer::DescriptorSetResource drawDescriptorSet;
@@ -195,6 +203,19 @@ private:
 
     Renderer::GPUVector<CellHeightRange> _cellHeightRanges;
 
+    // Geometry LOD, see TerrainLod. The fill passes bucket the culled cells into one draw per pattern
+    Renderer::GPUVector<u32> _cellLodPatterns; // Pattern ID per cell
+    Renderer::GPUVector<Renderer::IndexedIndirectDraw> _lodDrawArguments; // Copied over the argument buffer to reset it, the last one only counts survivors
+    std::vector<TerrainLod::Pattern> _lodPatterns;
+    std::vector<TerrainLod::CellNeighbours> _cellNeighbours;
+    std::vector<u8> _cellLodLevels;
+    std::atomic<bool> _cellNeighboursDirty = true; // Set when cells are added, hidden or get new heights, picks every LOD again
+    vec3 _lodCameraPosition = vec3(0.0f);
+    f32 _lodPixelsPerUnit = 0.0f;
+    f32 _lodMaxPixelError = -1.0f;
+    u32 _numLodCells = 0;
+    u32 _numLodTriangles = 0;
+
     // GPU-only workbuffers
     Renderer::BufferID _occluderArgumentBuffer;
     Renderer::BufferID _argumentBuffer;
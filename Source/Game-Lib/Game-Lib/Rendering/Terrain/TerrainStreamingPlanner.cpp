@@ -0,0 +1,217 @@
+#include "TerrainStreamingPlanner.h"
+
+#include <Base/Util/DebugHandler.h>
+
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+
+TerrainStreamingPlanner::TerrainStreamingPlanner()
+{
+    _chunks.resize(NUM_CHUNKS);
+}
+
+void TerrainStreamingPlanner::Reset(const std::vector<u32>& availableChunkIDs)
+{
+    std::fill(_chunks.begin(), _chunks.end(), ChunkEntry());
+    _availableChunkIDs.clear();
+    _availableChunkIDs.reserve(availableChunkIDs.size());
+
+    for (u32 chunkID : availableChunkIDs)
+    {
+        NC_ASSERT(chunkID < NUM_CHUNKS, "TerrainStreamingPlanner : ChunkID {0} is outside of the map", chunkID);
+
+        if (_chunks[chunkID].state != ChunkState::Unavailable)
+            continue;
+
+        _chunks[chunkID].state = ChunkState::NotLoaded;
+        _availableChunkIDs.push_back(chunkID);
+    }
+
+    _residentBytes = 0;
+    _measuredBytes = 0;
+    _numMeasuredChunks = 0;
+    _numLoadedChunks = 0;
+    _numInFlightChunks = 0;
+}
+
+void TerrainStreamingPlanner::Update(const vec2& focusChunkPos, const vec2& focusVelocity, Decision& outDecision)
+{
+    ZoneScopedN("TerrainStreamingPlanner::Update");
+    outDecision.Clear();
+
+    f32 speed = glm::length(focusVelocity);
+    bool hasTravelDirection = speed > 0.01f;
+    vec2 travelDirection = hasTravelDirection ? focusVelocity / speed : vec2(0.0f);
+
+    f32 loadRadius = _settings.loadRadius;
+    f32 unloadRadius = glm::max(_settings.unloadRadius, loadRadius);
+
+    // Chunks that left the unload radius always go, the gap between the two radii keeps chunks on the edge from thrashing
+    _loadCandidates.clear();
+    _evictionCandidates.clear();
+
+    for (u32 chunkID : _availableChunkIDs)
+    {
+        ChunkEntry& chunk = _chunks[chunkID];
+        f32 distance = GetChunkDistance(chunkID, focusChunkPos);
+
+        if (chunk.state == ChunkState::Loaded)
+        {
+            if (chunk.pinned)
+                continue;
+
+            if (distance > unloadRadius)
+            {
+                Evict(chunkID, outDecision);
+                continue;
+            }
+
+            f32 score = GetChunkScore(chunkID, focusChunkPos, travelDirection, hasTravelDirection);
+            _evictionCandidates.push_back({ chunkID, score });
+        }
+        else if (chunk.state == ChunkState::NotLoaded && distance <= loadRadius)
+        {
+            f32 score = GetChunkScore(chunkID, focusChunkPos, travelDirection, hasTravelDirection);
+            _loadCandidates.push_back({ chunkID, score });
+        }
+    }
+
+    if (_loadCandidates.empty())
+        return;
+
+    // Lowest score first, ties are broken by chunkID so the order is stable between ticks
+    std::sort(_loadCandidates.begin(), _loadCandidates.end(), [](const Candidate& a, const Candidate& b)
+    {
+        return a.score != b.score ? a.score < b.score : a.chunkID < b.chunkID;
+    });
+
+    // Highest score (least important) last so we can pop from the back
+    std::sort(_evictionCandidates.begin(), _evictionCandidates.end(), [](const Candidate& a, const Candidate& b)
+    {
+        return a.score != b.score ? a.score < b.score : a.chunkID < b.chunkID;
+    });
+
+    u64 estimatedChunkBytes = GetEstimatedChunkBytes();
+    u32 numLoadsThisTick = 0;
+
+    for (const Candidate& candidate : _loadCandidates)
+    {
+        if (numLoadsThisTick >= _settings.maxLoadsPerTick || _numInFlightChunks >= _settings.maxInFlight)
+            break;
+
+        // In flight chunks have not reported their real size yet, count them with the estimate
+        u64 projectedBytes = _residentBytes + (static_cast<u64>(_numInFlightChunks) + 1) * estimatedChunkBytes;
+
+        // Make room by evicting chunks that matter less than this one, never the other way around
+        while (projectedBytes > _settings.memoryBudgetBytes && !_evictionCandidates.empty())
+        {
+            const Candidate& leastImportant = _evictionCandidates.back();
+            if (leastImportant.score <= candidate.score)
+                break;
+
+            u64 freedBytes = _chunks[leastImportant.chunkID].residentBytes;
+            Evict(leastImportant.chunkID, outDecision);
+            _evictionCandidates.pop_back();
+
+            projectedBytes -= glm::min(projectedBytes, freedBytes);
+        }
+
+        // Candidates are sorted, if this one doesn't fit nothing after it will either
+        if (projectedBytes > _settings.memoryBudgetBytes)
+            break;
+
+        _chunks[candidate.chunkID].state = ChunkState::InFlight;
+        _numInFlightChunks++;
+        numLoadsThisTick++;
+
+        outDecision.chunksToLoad.push_back(candidate.chunkID);
+    }
+}
+
+void TerrainStreamingPlanner::OnChunkLoaded(u32 chunkID, u64 residentBytes)
+{
+    NC_ASSERT(chunkID < NUM_CHUNKS, "TerrainStreamingPlanner : ChunkID {0} is outside of the map", chunkID);
+
+    ChunkEntry& chunk = _chunks[chunkID];
+    if (chunk.state != ChunkState::InFlight)
+        return;
+
+    chunk.state = ChunkState::Loaded;
+    chunk.residentBytes = residentBytes;
+
+    _numInFlightChunks--;
+    _numLoadedChunks++;
+    _residentBytes += residentBytes;
+
+    _measuredBytes += residentBytes;
+    _numMeasuredChunks++;
+}
+
+void TerrainStreamingPlanner::OnChunkLoadFailed(u32 chunkID)
+{
+    NC_ASSERT(chunkID < NUM_CHUNKS, "TerrainStreamingPlanner : ChunkID {0} is outside of the map", chunkID);
+
+    ChunkEntry& chunk = _chunks[chunkID];
+    if (chunk.state != ChunkState::InFlight)
+        return;
+
+    // Failed chunks are not retried until the next Reset, retrying a broken file every tick helps nobody
+    chunk.state = ChunkState::Failed;
+    _numInFlightChunks--;
+}
+
+void TerrainStreamingPlanner::SetChunkPinned(u32 chunkID, bool pinned)
+{
+    if (chunkID >= NUM_CHUNKS)
+        return;
+
+    _chunks[chunkID].pinned = pinned;
+}
+
+u64 TerrainStreamingPlanner::GetEstimatedChunkBytes() const
+{
+    if (_numMeasuredChunks == 0)
+        return _settings.defaultChunkBytes;
+
+    return _measuredBytes / _numMeasuredChunks;
+}
+
+f32 TerrainStreamingPlanner::GetChunkDistance(u32 chunkID, const vec2& focusChunkPos)
+{
+    u32 chunkX = chunkID % Terrain::CHUNK_NUM_PER_MAP_STRIDE;
+    u32 chunkY = chunkID / Terrain::CHUNK_NUM_PER_MAP_STRIDE;
+
+    vec2 chunkCenter = vec2(static_cast<f32>(chunkX) + 0.5f, static_cast<f32>(chunkY) + 0.5f);
+    return glm::distance(chunkCenter, focusChunkPos);
+}
+
+f32 TerrainStreamingPlanner::GetChunkScore(u32 chunkID, const vec2& focusChunkPos, const vec2& travelDirection, bool hasTravelDirection) const
+{
+    f32 distance = GetChunkDistance(chunkID, focusChunkPos);
+    if (!hasTravelDirection || distance < 0.0001f)
+        return distance;
+
+    u32 chunkX = chunkID % Terrain::CHUNK_NUM_PER_MAP_STRIDE;
+    u32 chunkY = chunkID / Terrain::CHUNK_NUM_PER_MAP_STRIDE;
+
+    vec2 chunkCenter = vec2(static_cast<f32>(chunkX) + 0.5f, static_cast<f32>(chunkY) + 0.5f);
+    vec2 toChunk = (chunkCenter - focusChunkPos) / distance;
+
+    // Chunks ahead look closer and chunks behind look further away, a bias of 1 would make chunks straight ahead free
+    f32 bias = glm::clamp(_settings.directionBias, 0.0f, 0.95f);
+    return distance * (1.0f - bias * glm::dot(travelDirection, toChunk));
+}
+
+void TerrainStreamingPlanner::Evict(u32 chunkID, Decision& outDecision)
+{
+    ChunkEntry& chunk = _chunks[chunkID];
+
+    _residentBytes -= glm::min(_residentBytes, chunk.residentBytes);
+    _numLoadedChunks--;
+
+    chunk.state = ChunkState::NotLoaded;
+    chunk.residentBytes = 0;
+
+    outDecision.chunksToEvict.push_back(chunkID);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <FileFormat/Shared.h>
+
+#include <vector>
+
+// Pure CPU streaming decisions for TerrainLoader. It only knows chunk IDs, positions in chunk grid space and byte
+// counts, the loader owns the actual files, renderer slots, physics bodies and placements.
+class TerrainStreamingPlanner
+{
+public:
+    static constexpr u32 NUM_CHUNKS = Terrain::CHUNK_NUM_PER_MAP_STRIDE * Terrain::CHUNK_NUM_PER_MAP_STRIDE;
+
+    enum class ChunkState : u8
+    {
+        Unavailable, // Not part of the current map
+        NotLoaded,
+        InFlight,
+        Loaded,
+        Failed
+    };
+
+    struct Settings
+    {
+    public:
+        f32 loadRadius = 6.0f; // In chunks, chunks closer than this get loaded
+        f32 unloadRadius = 8.0f; // In chunks, loaded chunks further away than this get evicted, must be >= loadRadius
+        f32 directionBias = 0.5f; // [0, 1], how much chunks in the direction of travel are preferred over chunks behind
+        u64 memoryBudgetBytes = 1024ull * 1024ull * 1024ull;
+        u64 defaultChunkBytes = 4ull * 1024ull * 1024ull; // Estimate used for chunks that have not been measured yet
+        u32 maxLoadsPerTick = 8;
+        u32 maxInFlight = 32;
+    };
+
+    struct Decision
+    {
+    public:
+        std::vector<u32> chunksToLoad; // Sorted by priority
+        std::vector<u32> chunksToEvict;
+
+        void Clear()
+        {
+            chunksToLoad.clear();
+            chunksToEvict.clear();
+        }
+    };
+
+public:
+    TerrainStreamingPlanner();
+
+    void Reset(const std::vector<u32>& availableChunkIDs);
+    void SetSettings(const Settings& settings) { _settings = settings; }
+    const Settings& GetSettings() const { return _settings; }
+
+    // focusChunkPos is in chunk grid space (chunk x, chunk y), velocity in chunks per second.
+    // Chunks returned for loading are marked InFlight and chunks returned for eviction are marked NotLoaded,
+    // the caller is expected to act on the whole decision.
+    void Update(const vec2& focusChunkPos, const vec2& focusVelocity, Decision& outDecision);
+
+    void OnChunkLoaded(u32 chunkID, u64 residentBytes);
+    void OnChunkLoadFailed(u32 chunkID);
+
+    // Pinned chunks (edited in the terrain editor for example) are never evicted
+    void SetChunkPinned(u32 chunkID, bool pinned);
+
+    ChunkState GetChunkState(u32 chunkID) const { return chunkID < NUM_CHUNKS ? _chunks[chunkID].state : ChunkState::Unavailable; }
+    u64 GetResidentBytes() const { return _residentBytes; }
+    u64 GetEstimatedChunkBytes() const;
+    u32 GetNumLoadedChunks() const { return _numLoadedChunks; }
+    u32 GetNumInFlightChunks() const { return _numInFlightChunks; }
+
+    static f32 GetChunkDistance(u32 chunkID, const vec2& focusChunkPos);
+
+private:
+    struct ChunkEntry
+    {
+    public:
+        ChunkState state = ChunkState::Unavailable;
+        bool pinned = false;
+        u64 residentBytes = 0;
+    };
+
+    struct Candidate
+    {
+    public:
+        u32 chunkID = 0;
+        f32 score = 0.0f;
+    };
+
+    f32 GetChunkScore(u32 chunkID, const vec2& focusChunkPos, const vec2& travelDirection, bool hasTravelDirection) const;
+    void Evict(u32 chunkID, Decision& outDecision);
+
+private:
+    Settings _settings;
+    std::vector<ChunkEntry> _chunks;
+    std::vector<u32> _availableChunkIDs;
+
+    u64 _residentBytes = 0;
+    u64 _measuredBytes = 0;
+    u32 _numMeasuredChunks = 0;
+    u32 _numLoadedChunks = 0;
+    u32 _numInFlightChunks = 0;
+
+    std::vector<Candidate> _loadCandidates;
+    std::vector<Candidate> _evictionCandidates;
+};
@@ -0,0 +1,188 @@
+#include "CustomizationTextureCache.h"
+
+void CustomizationTextureCache::Acquire(u64 textureHash)
+{
+    CachedTexture& texture = _textures[textureHash];
+    texture.numReferences++;
+    texture.unusedTime = 0.0f;
+
+    bool isResident = texture.textureID != Renderer::TextureID::Invalid();
+    if (isResident || texture.isQueued || texture.isInFlight || texture.hasFailed)
+        return;
+
+    texture.isQueued = true;
+    _queuedHashes.push_back(textureHash);
+}
+
+void CustomizationTextureCache::Release(u64 textureHash)
+{
+    auto itr = _textures.find(textureHash);
+    if (itr == _textures.end() || itr->second.numReferences == 0)
+        return;
+
+    // Update starts aging the texture from here
+    itr->second.numReferences--;
+}
+
+bool CustomizationTextureCache::GetTextureID(u64 textureHash, Renderer::TextureID& textureID) const
+{
+    auto itr = _textures.find(textureHash);
+    if (itr == _textures.end() || itr->second.textureID == Renderer::TextureID::Invalid())
+        return false;
+
+    textureID = itr->second.textureID;
+    return true;
+}
+
+bool CustomizationTextureCache::IsLoading(u64 textureHash) const
+{
+    auto itr = _textures.find(textureHash);
+    if (itr == _textures.end())
+        return false;
+
+    const CachedTexture& texture = itr->second;
+    return texture.isQueued || texture.isInFlight;
+}
+
+void CustomizationTextureCache::CollectJobs(u32 maxJobs, std::vector<u64>& jobs)
+{
+    u32 numJobs = 0;
+    u32 numVisited = 0;
+
+    for (; numVisited < _queuedHashes.size() && numJobs < maxJobs; numVisited++)
+    {
+        u64 textureHash = _queuedHashes[numVisited];
+
+        auto itr = _textures.find(textureHash);
+        if (itr == _textures.end())
+            continue;
+
+        CachedTexture& texture = itr->second;
+        texture.isQueued = false;
+
+        // Nothing wants it anymore and nothing was loaded yet, so there is nothing to keep around either
+        if (texture.numReferences == 0)
+        {
+            _textures.erase(itr);
+            continue;
+        }
+
+        texture.isInFlight = true;
+        _numJobsInFlight++;
+
+        jobs.push_back(textureHash);
+        numJobs++;
+    }
+
+    _queuedHashes.erase(_queuedHashes.begin(), _queuedHashes.begin() + numVisited);
+}
+
+void CustomizationTextureCache::CompleteJob(u64 textureHash, const void* data, size_t size)
+{
+    auto itr = _textures.find(textureHash);
+    if (itr == _textures.end() || !itr->second.isInFlight)
+        return;
+
+    CachedTexture& texture = itr->second;
+    texture.isInFlight = false;
+    _numJobsInFlight--;
+
+    Renderer::TextureID textureID = _uploader->UploadCustomizationTexture(textureHash, data, size);
+    if (textureID == Renderer::TextureID::Invalid())
+    {
+        texture.hasFailed = true;
+        _numFailures++;
+        return;
+    }
+
+    texture.textureID = textureID;
+    _numUploads++;
+}
+
+void CustomizationTextureCache::FailJob(u64 textureHash)
+{
+    auto itr = _textures.find(textureHash);
+    if (itr == _textures.end() || !itr->second.isInFlight)
+        return;
+
+    CachedTexture& texture = itr->second;
+    texture.isInFlight = false;
+    texture.hasFailed = true;
+
+    _numJobsInFlight--;
+    _numFailures++;
+}
+
+void CustomizationTextureCache::Update(f32 deltaTime)
+{
+    _evictedHashes.clear();
+
+    for (auto& [textureHash, texture] : _textures)
+    {
+        if (texture.numReferences > 0 || texture.isQueued || texture.isInFlight)
+            continue;
+
+        texture.unusedTime += deltaTime;
+        if (texture.unusedTime < _evictionDelay)
+            continue;
+
+        // Failed textures are forgotten as well, so a later Acquire tries them again
+        _evictedHashes.push_back(textureHash);
+    }
+
+    for (u64 textureHash : _evictedHashes)
+    {
+        auto itr = _textures.find(textureHash);
+        Evict(textureHash, itr->second);
+
+        _textures.erase(itr);
+    }
+}
+
+void CustomizationTextureCache::Clear()
+{
+    for (auto& [textureHash, texture] : _textures)
+    {
+        Evict(textureHash, texture);
+    }
+
+    _textures.clear();
+    _queuedHashes.clear();
+
+    // Jobs still running complete into textures that are no longer known and are ignored
+    _numJobsInFlight = 0;
+    _numUploads = 0;
+    _numEvictions = 0;
+    _numFailures = 0;
+}
+
+CustomizationTextureCache::Stats CustomizationTextureCache::GetStats() const
+{
+    Stats stats;
+    stats.numTextures = static_cast<u32>(_textures.size());
+    stats.numJobsInFlight = _numJobsInFlight;
+    stats.numUploads = _numUploads;
+    stats.numEvictions = _numEvictions;
+    stats.numFailures = _numFailures;
+
+    for (const auto& [textureHash, texture] : _textures)
+    {
+        bool isResident = texture.textureID != Renderer::TextureID::Invalid();
+
+        stats.numResident += isResident;
+        stats.numUnused += isResident && texture.numReferences == 0;
+    }
+
+    return stats;
+}
+
+void CustomizationTextureCache::Evict(u64 textureHash, CachedTexture& texture)
+{
+    if (texture.textureID == Renderer::TextureID::Invalid())
+        return;
+
+    _uploader->UnloadCustomizationTexture(textureHash, texture.textureID);
+    texture.textureID = Renderer::TextureID::Invalid();
+
+    _numEvictions++;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <Renderer/Descriptors/TextureDesc.h>
+
+#include <robinhood/robinhood.h>
+
+#include <vector>
+
+// Decides which unit customization textures get loaded and when they get unloaded, the loading and uploading itself is
+// left to the owner. A texture is loaded the first time a unit acquires it and stays resident while anything holds a
+// reference, once the last reference is released it is unloaded after the eviction delay unless it gets acquired again.
+class CustomizationTextureCache
+{
+public:
+    // Turns the bytes a load job read from disk into a texture, and destroys it again when the cache evicts it.
+    // TextureRenderer owns the actual textures
+    class Uploader
+    {
+    public:
+        virtual ~Uploader() = default;
+
+        virtual Renderer::TextureID UploadCustomizationTexture(u64 textureHash, const void* data, size_t size) = 0;
+        virtual void UnloadCustomizationTexture(u64 textureHash, Renderer::TextureID textureID) = 0;
+    };
+
+    struct Stats
+    {
+    public:
+        u32 numTextures = 0;
+        u32 numResident = 0;
+        u32 numUnused = 0;
+        u32 numJobsInFlight = 0;
+
+        u64 numUploads = 0;
+        u64 numEvictions = 0;
+        u64 numFailures = 0;
+    };
+
+public:
+    explicit CustomizationTextureCache(Uploader* uploader) : _uploader(uploader) { }
+
+    void SetEvictionDelay(f32 seconds) { _evictionDelay = seconds; }
+
+    void Acquire(u64 textureHash);
+    void Release(u64 textureHash);
+
+    // False while the texture is loading, and for textures that are unknown or failed to load
+    bool GetTextureID(u64 textureHash, Renderer::TextureID& textureID) const;
+
+    // Acquired textures that are neither resident nor failed yet
+    bool IsLoading(u64 textureHash) const;
+
+    // Textures in the order they were acquired, ones that were released again before their job started are dropped
+    void CollectJobs(u32 maxJobs, std::vector<u64>& jobs);
+    void CompleteJob(u64 textureHash, const void* data, size_t size);
+    void FailJob(u64 textureHash);
+
+    // Ages unused textures and unloads the ones that have been unused for longer than the eviction delay
+    void Update(f32 deltaTime);
+
+    // Unloads every resident texture and forgets all references
+    void Clear();
+
+    u32 GetNumJobsInFlight() const { return _numJobsInFlight; }
+    Stats GetStats() const;
+
+private:
+    struct CachedTexture
+    {
+    public:
+        Renderer::TextureID textureID = Renderer::TextureID::Invalid();
+
+        u32 numReferences = 0;
+        f32 unusedTime = 0.0f;
+
+        bool isQueued = false;
+        bool isInFlight = false;
+        bool hasFailed = false;
+    };
+
+    void Evict(u64 textureHash, CachedTexture& texture);
+
+private:
+    Uploader* _uploader = nullptr;
+
+    robin_hood::unordered_map<u64, CachedTexture> _textures;
+    std::vector<u64> _queuedHashes; // Acquired textures waiting for CollectJobs, oldest first
+
+    f32 _evictionDelay = 0.0f;
+
+    u32 _numJobsInFlight = 0;
+    u64 _numUploads = 0;
+    u64 _numEvictions = 0;
+    u64 _numFailures = 0;
+
+    // Scratch space for Update
+    std::vector<u64> _evictedHashes;
+};
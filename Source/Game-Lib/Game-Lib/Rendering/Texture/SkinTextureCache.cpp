@@ -0,0 +1,128 @@
+#include "SkinTextureCache.h"
+
+#include <xxhash/xxhash64.h>
+
+void SkinTextureDesc::Reset()
+{
+    race = 0;
+    gender = 0;
+    skinID = 0;
+    faceID = 0;
+
+    layers.clear();
+}
+
+void SkinTextureDesc::AddLayer(u64 textureHash, u8 section)
+{
+    if (textureHash == 0)
+        return;
+
+    layers.push_back({ textureHash, section });
+}
+
+u64 SkinTextureDesc::GetKey() const
+{
+    // Hashed field by field so padding never ends up in the key, each layer is chained onto the hash before it which
+    // makes the key depend on the layer order
+    u64 header[] = { race, gender, skinID, faceID, layers.size() };
+    u64 key = XXHash64::hash(header, sizeof(header), 0);
+
+    for (const Layer& layer : layers)
+    {
+        u64 values[] = { layer.textureHash, layer.section };
+        key = XXHash64::hash(values, sizeof(values), key);
+    }
+
+    return key;
+}
+
+SkinTextureCache::UnusedTexture::UnusedTexture(UnusedTexture&& other) noexcept : _backend(other._backend), _key(other._key), _textureID(other._textureID), _numBytes(other._numBytes)
+{
+    other._textureID = Renderer::TextureID::Invalid();
+}
+
+SkinTextureCache::UnusedTexture::~UnusedTexture()
+{
+    if (_textureID == Renderer::TextureID::Invalid())
+        return;
+
+    _backend->DestroySkinTexture(_key, _textureID);
+}
+
+Renderer::TextureID SkinTextureCache::UnusedTexture::Take()
+{
+    Renderer::TextureID textureID = _textureID;
+    _textureID = Renderer::TextureID::Invalid();
+
+    return textureID;
+}
+
+bool SkinTextureCache::Acquire(u64 key, Renderer::TextureID& textureID)
+{
+    auto itr = _referencedTextures.find(key);
+    if (itr != _referencedTextures.end())
+    {
+        itr->second.numReferences++;
+        textureID = itr->second.textureID;
+
+        _numHits++;
+        return true;
+    }
+
+    // Unused skins are taken back out of the LRU cache before it can evict them
+    if (UnusedTexture* unusedTexture = _unusedTextures.Get(key))
+    {
+        ReferencedTexture& texture = _referencedTextures[key];
+        texture.textureID = unusedTexture->Take();
+        texture.numReferences = 1;
+        texture.numBytes = unusedTexture->GetNumBytes();
+
+        _unusedTextures.Remove(key);
+        textureID = texture.textureID;
+
+        _numHits++;
+        return true;
+    }
+
+    _numMisses++;
+    return false;
+}
+
+void SkinTextureCache::Add(u64 key, Renderer::TextureID textureID, u64 numBytes)
+{
+    ReferencedTexture& texture = _referencedTextures[key];
+    texture.textureID = textureID;
+    texture.numReferences = 1;
+    texture.numBytes = numBytes;
+}
+
+void SkinTextureCache::Release(u64 key)
+{
+    auto itr = _referencedTextures.find(key);
+    if (itr == _referencedTextures.end())
+        return;
+
+    ReferencedTexture& texture = itr->second;
+    if (--texture.numReferences > 0)
+        return;
+
+    // Skins bigger than the whole budget are destroyed right away by the temporary going out of scope
+    _unusedTextures.Put(key, UnusedTexture(_backend, key, texture.textureID, texture.numBytes), texture.numBytes);
+    _referencedTextures.erase(itr);
+}
+
+SkinTextureCache::Stats SkinTextureCache::GetStats() const
+{
+    Util::LRUCache<u64, UnusedTexture>::Stats unusedStats = _unusedTextures.GetStats();
+
+    Stats stats;
+    stats.numReferenced = static_cast<u32>(_referencedTextures.size());
+    stats.numUnused = unusedStats.numEntries;
+    stats.unusedBytes = unusedStats.numBytes;
+    stats.budgetBytes = unusedStats.budgetBytes;
+    stats.numHits = _numHits;
+    stats.numMisses = _numMisses;
+    stats.numEvictions = unusedStats.numEvictions;
+
+    return stats;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include "Game-Lib/Util/LRUCache.h"
+
+#include <Base/Types.h>
+
+#include <Renderer/Descriptors/TextureDesc.h>
+
+#include <robinhood/robinhood.h>
+
+#include <vector>
+
+// Everything that ends up in a composited unit skin, layers are kept in the order they are written since later ones
+// draw over earlier ones. Units with the same key get the same skin
+struct SkinTextureDesc
+{
+public:
+    struct Layer
+    {
+    public:
+        u64 textureHash = 0;
+        u8 section = 0; // Database::Unit::TextureSectionType
+    };
+
+public:
+    void Reset();
+
+    // Layers without a texture are skipped, so a missing texture and an absent layer give the same key
+    void AddLayer(u64 textureHash, u8 section);
+    u64 GetKey() const;
+
+public:
+    u8 race = 0;
+    u8 gender = 0;
+    u8 skinID = 0;
+    u8 faceID = 0;
+
+    std::vector<Layer> layers;
+};
+
+// Shares composited unit skins between units with the same SkinTextureDesc key. Skins are reference counted, the ones no
+// unit uses anymore are kept within a byte budget and destroyed least recently used first. Creating and compositing
+// the skin on a miss is left to the owner.
+class SkinTextureCache
+{
+public:
+    // The cache only ever destroys skins, creating and compositing them stays with the owner that calls Add
+    class Backend
+    {
+    public:
+        virtual ~Backend() = default;
+
+        virtual void DestroySkinTexture(u64 key, Renderer::TextureID textureID) = 0;
+    };
+
+    struct Stats
+    {
+    public:
+        u32 numReferenced = 0;
+        u32 numUnused = 0;
+
+        u64 unusedBytes = 0;
+        u64 budgetBytes = 0;
+
+        u64 numHits = 0;
+        u64 numMisses = 0;
+        u64 numEvictions = 0;
+    };
+
+public:
+    explicit SkinTextureCache(Backend* backend) : _backend(backend) { }
+
+    void SetBudget(u64 budgetBytes) { _unusedTextures.SetBudget(budgetBytes); }
+
+    // Returns false on a miss, the owner then creates and composites the skin and hands it over with Add
+    bool Acquire(u64 key, Renderer::TextureID& textureID);
+
+    // The skin starts out with one reference, numBytes is what it costs the budget once it is unused
+    void Add(u64 key, Renderer::TextureID textureID, u64 numBytes);
+    void Release(u64 key);
+
+    Stats GetStats() const;
+
+private:
+    struct ReferencedTexture
+    {
+    public:
+        Renderer::TextureID textureID = Renderer::TextureID::Invalid();
+        u32 numReferences = 0;
+        u64 numBytes = 0;
+    };
+
+    // Destroys the skin when the LRU cache evicts it, unless it was taken back out to be used again
+    class UnusedTexture
+    {
+    public:
+        UnusedTexture(Backend* backend, u64 key, Renderer::TextureID textureID, u64 numBytes) : _backend(backend), _key(key), _textureID(textureID), _numBytes(numBytes) { }
+        UnusedTexture(UnusedTexture&& other) noexcept;
+        UnusedTexture(const UnusedTexture&) = delete;
+        UnusedTexture& operator=(const UnusedTexture&) = delete;
+        UnusedTexture& operator=(UnusedTexture&&) = delete;
+        ~UnusedTexture();
+
+        Renderer::TextureID Take();
+        u64 GetNumBytes() const { return _numBytes; }
+
+    private:
+        Backend* _backend = nullptr;
+        u64 _key = 0;
+        Renderer::TextureID _textureID = Renderer::TextureID::Invalid();
+        u64 _numBytes = 0;
+    };
+
+private:
+    Backend* _backend = nullptr;
+
+    robin_hood::unordered_map<u64, ReferencedTexture> _referencedTextures;
+    Util::LRUCache<u64, UnusedTexture> _unusedTextures;
+
+    u64 _numHits = 0;
+    u64 _numMisses = 0;
+};
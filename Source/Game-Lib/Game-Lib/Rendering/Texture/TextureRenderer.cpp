@@ -16,15 +16,62 @@
 #include "Game-Lib/Rendering/Downsampler/ffx_a.h"
 #include "Game-Lib/Rendering/Downsampler/ffx_spd.h"
 
+#include <Base/CVarSystem/CVarSystem.h>
+
 #include <Renderer/Renderer.h>
 #include <Renderer/RenderGraph.h>
 
+#include <enkiTS/TaskScheduler.h>
 #include <entt/entt.hpp>
 #include <imgui.h>
 
+AutoCVar_Float CVAR_UnitCustomizationTextureEvictSeconds(CVarCategory::Client | CVarCategory::Rendering, "unitCustomizationTextureEvictSeconds", "seconds a unit customization texture stays loaded after the last unit using it let go of it", 30.0f, CVarFlags::None);
+AutoCVar_Int CVAR_UnitCustomizationTextureLoadsPerFrame(CVarCategory::Client | CVarCategory::Rendering, "unitCustomizationTextureLoadsPerFrame", "maximum unit customization textures uploaded on the render thread per frame", 8, CVarFlags::None);
+AutoCVar_Int CVAR_UnitCustomizationTextureMaxInFlight(CVarCategory::Client | CVarCategory::Rendering, "unitCustomizationTextureMaxInFlight", "maximum unit customization texture loads in flight on the task workers", 16, CVarFlags::None);
+AutoCVar_Int CVAR_UnitSkinTextureCacheBudgetMB(CVarCategory::Client | CVarCategory::Rendering, "unitSkinTextureCacheBudgetMB", "megabytes of composited unit skins kept around after the last unit using them let go of them", 64, CVarFlags::None);
 
 using namespace ECS::Components::UI;
 
+struct CustomizationTextureLoadTask : enki::ITaskSet
+{
+public:
+    CustomizationTextureLoadTask(const std::vector<u64>& textureHashes, PACT::PactStorage* pactStorage, moodycamel::ConcurrentQueue<TextureRenderer::CustomizationTextureLoadResult>* completionQueue)
+        : enki::ITaskSet(static_cast<u32>(textureHashes.size()))
+        , _textureHashes(textureHashes)
+        , _pactStorage(pactStorage)
+        , _completionQueue(completionQueue)
+    {
+        m_Priority = enki::TASK_PRIORITY_LOW;
+    }
+
+    void ExecuteRange(enki::TaskSetPartition range, u32 threadNum) override
+    {
+        (void)threadNum;
+
+        for (u32 i = range.start; i < range.end; i++)
+        {
+            ZoneScopedN("Load Customization Texture Task");
+
+            TextureRenderer::CustomizationTextureLoadResult result;
+            result.textureHash = _textureHashes[i];
+
+            std::shared_ptr<PACT::PactFileHandle> fileHandle = std::make_shared<PACT::PactFileHandle>();
+            if (_pactStorage->ReadFile(result.textureHash, *fileHandle) == PACT::PactReadResult::Success)
+            {
+                result.success = true;
+                result.fileHandle = std::move(fileHandle);
+            }
+
+            _completionQueue->enqueue(std::move(result));
+        }
+    }
+
+private:
+    std::vector<u64> _textureHashes;
+    PACT::PactStorage* _pactStorage = nullptr;
+    moodycamel::ConcurrentQueue<TextureRenderer::CustomizationTextureLoadResult>* _completionQueue = nullptr;
+};
+
 void TextureRenderer::Clear()
 {
     RenderTextureToTextureRequest renderTextureToTextureRequest;
@@ -44,10 +91,25 @@ TextureRenderer::TextureRenderer(Renderer::Renderer* renderer, GameRenderer* gam
     CreatePermanentResources();
 }
 
+TextureRenderer::~TextureRenderer()
+{
+    CancelCustomizationTextureTasks();
+}
+
 void TextureRenderer::Update(f32 deltaTime)
 {
     ZoneScoped;
 
+    UpdateCustomizationTextures(deltaTime);
+
+    {
+        _skinTextureCache.SetBudget(static_cast<u64>(std::max(CVAR_UnitSkinTextureCacheBudgetMB.Get(), 0)) * 1024 * 1024);
+
+        SkinTextureCache::Stats skinTextureStats = _skinTextureCache.GetStats();
+        TracyPlot("Skin Textures Referenced", static_cast<i64>(skinTextureStats.numReferenced));
+        TracyPlot("Skin Textures Unused", static_cast<i64>(skinTextureStats.numUnused));
+    }
+
     if (ImGui::Begin("TextureRenderer Debug"))
     {
         entt::registry* gameRegistry = ServiceLocator::GetEnttRegistries()->gameRegistry;
@@ -231,6 +293,116 @@ void TextureRenderer::RequestRenderTextureToTexture(Renderer::TextureID dst, con
     _renderTextureToTextureRequests.enqueue(renderTextureToTextureRequest);
 }
 
+void TextureRenderer::UpdateCustomizationTextures(f32 deltaTime)
+{
+    ZoneScopedN("TextureRenderer::UpdateCustomizationTextures");
+
+    _customizationTextureCache.SetEvictionDelay(CVAR_UnitCustomizationTextureEvictSeconds.GetFloat());
+
+    {
+        ZoneScopedN("Customization Texture Load Results");
+
+        std::erase_if(_activeCustomizationTextureLoadTasks, [](const std::unique_ptr<CustomizationTextureLoadTask>& task)
+        {
+            return task->GetIsComplete();
+        });
+
+        const u32 maxTextureUploadsPerFrame = static_cast<u32>(std::max(CVAR_UnitCustomizationTextureLoadsPerFrame.Get(), 1));
+        u32 numTextureUploads = 0;
+
+        CustomizationTextureLoadResult result;
+        while (numTextureUploads < maxTextureUploadsPerFrame && _customizationTextureLoadResults.try_dequeue(result))
+        {
+            if (!result.success)
+            {
+                NC_LOG_ERROR("TextureRenderer : Failed to read unit customization texture {0}", result.textureHash);
+                _customizationTextureCache.FailJob(result.textureHash);
+                continue;
+            }
+
+            _customizationTextureCache.CompleteJob(result.textureHash, result.fileHandle->GetData(), result.fileHandle->GetSize());
+            numTextureUploads++;
+        }
+        TracyPlot("Customization Texture Uploads", static_cast<i64>(numTextureUploads));
+    }
+
+    _customizationTextureCache.Update(deltaTime);
+
+    const u32 maxJobsInFlight = static_cast<u32>(std::max(CVAR_UnitCustomizationTextureMaxInFlight.Get(), 1));
+    u32 numJobsInFlight = _customizationTextureCache.GetNumJobsInFlight();
+    if (numJobsInFlight < maxJobsInFlight)
+    {
+        _customizationTextureLoadJobs.clear();
+        _customizationTextureCache.CollectJobs(maxJobsInFlight - numJobsInFlight, _customizationTextureLoadJobs);
+
+        if (!_customizationTextureLoadJobs.empty())
+        {
+            ZoneScopedN("Dispatch Customization Texture Loads");
+
+            auto task = std::make_unique<CustomizationTextureLoadTask>(_customizationTextureLoadJobs, ServiceLocator::GetPactStorage(), &_customizationTextureLoadResults);
+            ServiceLocator::GetTaskScheduler()->AddTaskSetToPipe(task.get());
+            _activeCustomizationTextureLoadTasks.push_back(std::move(task));
+        }
+    }
+    TracyPlot("Customization Texture Loads In Flight", static_cast<i64>(_customizationTextureCache.GetNumJobsInFlight()));
+}
+
+void TextureRenderer::CancelCustomizationTextureTasks()
+{
+    ZoneScopedN("TextureRenderer::CancelCustomizationTextureTasks");
+
+    if (!_activeCustomizationTextureLoadTasks.empty())
+    {
+        enki::TaskScheduler* taskScheduler = ServiceLocator::GetTaskScheduler();
+        for (const std::unique_ptr<CustomizationTextureLoadTask>& task : _activeCustomizationTextureLoadTasks)
+            taskScheduler->WaitforTask(task.get());
+
+        _activeCustomizationTextureLoadTasks.clear();
+    }
+
+    CustomizationTextureLoadResult result;
+    while (_customizationTextureLoadResults.try_dequeue(result)) {}
+}
+
+Renderer::TextureID TextureRenderer::UploadCustomizationTexture(u64 textureHash, const void* data, size_t size)
+{
+    ZoneScopedN("Upload Customization Texture");
+
+    Renderer::DataTextureDesc textureDesc =
+    {
+        .hash = textureHash,
+        .data = reinterpret_cast<const u8*>(data),
+        .size = size
+    };
+
+    return _renderer->LoadDataTexture(textureDesc);
+}
+
+void TextureRenderer::UnloadCustomizationTexture(u64 textureHash, Renderer::TextureID textureID)
+{
+    (void)textureHash;
+
+    // Eviction waits for unitCustomizationTextureEvictSeconds, every composite that sampled it has long been rendered
+    _renderer->UnloadTexture(textureID);
+}
+
+void TextureRenderer::AddSkinTexture(u64 key, Renderer::TextureID textureID)
+{
+    // What the skin costs the budget once it is unused, including its mip chain
+    Renderer::TextureBaseDesc textureDesc = _renderer->GetDesc(textureID);
+    u64 numBytes = (static_cast<u64>(textureDesc.width) * textureDesc.height * textureDesc.layers * 4 * 4) / 3;
+
+    _skinTextureCache.Add(key, textureID, numBytes);
+}
+
+void TextureRenderer::DestroySkinTexture(u64 key, Renderer::TextureID textureID)
+{
+    (void)key;
+
+    // Only skins no unit has used for a while are evicted, nothing is still compositing into or sampling from them
+    _renderer->UnloadTexture(textureID);
+}
+
 void TextureRenderer::CreatePermanentResources()
 {
     ZoneScoped;
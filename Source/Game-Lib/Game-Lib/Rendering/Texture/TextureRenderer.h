@@ -1,16 +1,23 @@
 #pragma once
 #include "Game-Lib/ECS/Components/UI/Widget.h"
 #include "Game-Lib/Rendering/GameRenderer.h"
+#include "Game-Lib/Rendering/Texture/CustomizationTextureCache.h"
+#include "Game-Lib/Rendering/Texture/SkinTextureCache.h"
 
 #include <Base/Types.h>
 #include <Base/Container/ConcurrentQueue.h>
 
+#include <Filesystem/PactStorage.h>
+
 #include <Renderer/Descriptors/TextureDesc.h>
 #include <Renderer/DescriptorSet.h>
 #include <Renderer/GPUVector.h>
 
 #include <robinhood/robinhood.h>
 
+#include <memory>
+#include <vector>
+
 namespace Renderer
 {
     class RenderGraph;
@@ -21,11 +28,22 @@ struct RenderResources;
 class Window;
 class DebugRenderer;
 class GameRenderer;
+struct CustomizationTextureLoadTask;
 
-class TextureRenderer
+class TextureRenderer : private CustomizationTextureCache::Uploader, private SkinTextureCache::Backend
 {
+public:
+    struct CustomizationTextureLoadResult
+    {
+    public:
+        u64 textureHash = 0;
+        bool success = false;
+        std::shared_ptr<PACT::PactFileHandle> fileHandle;
+    };
+
 public:
     TextureRenderer(Renderer::Renderer* renderer, GameRenderer* gameRenderer, DebugRenderer* debugRenderer);
+    ~TextureRenderer();
     void Clear();
 
     void Update(f32 deltaTime);
@@ -40,7 +58,30 @@ public:
     // The region is specified in UV
     void RequestRenderTextureToTexture(Renderer::TextureID dst, const vec2& dstRectMin, const vec2& dstRectMax, Renderer::TextureID src, const vec2& srcRectMin, const vec2& srcRectMax);
 
+    // Unit customization textures are read on the task workers the first time they are acquired, and unloaded once
+    // nothing has held a reference to them for unitCustomizationTextureEvictSeconds
+    void AcquireCustomizationTexture(u64 textureHash) { _customizationTextureCache.Acquire(textureHash); }
+    void ReleaseCustomizationTexture(u64 textureHash) { _customizationTextureCache.Release(textureHash); }
+    bool GetCustomizationTextureID(u64 textureHash, Renderer::TextureID& textureID) const { return _customizationTextureCache.GetTextureID(textureHash, textureID); }
+    bool IsCustomizationTextureLoading(u64 textureHash) const { return _customizationTextureCache.IsLoading(textureHash); }
+
+    // Composited unit skins are shared by every unit with the same SkinTextureDesc key, on a miss the caller creates and
+    // composites the skin and hands it over with AddSkinTexture. Skins no unit uses are kept within unitSkinTextureCacheBudgetMB
+    bool AcquireSkinTexture(u64 key, Renderer::TextureID& textureID) { return _skinTextureCache.Acquire(key, textureID); }
+    void AddSkinTexture(u64 key, Renderer::TextureID textureID);
+    void ReleaseSkinTexture(u64 key) { _skinTextureCache.Release(key); }
+
 private:
+    void UpdateCustomizationTextures(f32 deltaTime);
+    void CancelCustomizationTextureTasks();
+
+    // CustomizationTextureCache::Uploader
+    Renderer::TextureID UploadCustomizationTexture(u64 textureHash, const void* data, size_t size) override;
+    void UnloadCustomizationTexture(u64 textureHash, Renderer::TextureID textureID) override;
+
+    // SkinTextureCache::Backend
+    void DestroySkinTexture(u64 key, Renderer::TextureID textureID) override;
+
     void CreatePermanentResources();
     void CreatePipelines();
     void InitDescriptorSets();
@@ -91,4 +132,11 @@ private:
     std::vector<u32> _renderTextureToTextureWorkTextureArrayIndex;
 
     robin_hood::unordered_set<Renderer::TextureID::type> _texturesNeedingMipResolve;
+
+    CustomizationTextureCache _customizationTextureCache{ this };
+    moodycamel::ConcurrentQueue<CustomizationTextureLoadResult> _customizationTextureLoadResults;
+    std::vector<std::unique_ptr<CustomizationTextureLoadTask>> _activeCustomizationTextureLoadTasks;
+    std::vector<u64> _customizationTextureLoadJobs;
+
+    SkinTextureCache _skinTextureCache{ this };
 };
\ No newline at end of file
@@ -77,7 +77,7 @@ namespace Scripting
         u64 cursorPathHash = Util::AssetPath::Hash(cursorPath);
 
         GameRenderer* gameRenderer = ServiceLocator::GetGameRenderer();
-        bool result = gameRenderer->AddCursor(cursorNameHash, cursorPathHash, cursorPath);
+        bool result = gameRenderer && gameRenderer->AddCursor(cursorNameHash, cursorPathHash, cursorPath);
 
         zenith->Push(result);
         return 1;
@@ -95,7 +95,7 @@ namespace Scripting
         u64 cursorNameHash = XXHash64::hash(cursorName, strlen(cursorName), 0);
 
         GameRenderer* gameRenderer = ServiceLocator::GetGameRenderer();
-        bool result = gameRenderer->SetCursor(cursorNameHash);
+        bool result = gameRenderer && gameRenderer->SetCursor(cursorNameHash);
 
         zenith->Push(result);
         return 1;
@@ -11,13 +11,18 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <limits>
+#include <unordered_map>
 #include <vector>
 
 namespace Scripting::Scheduler
 {
     namespace
     {
+        // Compact once at least this many cancelled callbacks are waiting and they outnumber the live ones
+        constexpr u32 MinCancelledBeforeCompact = 64;
+
         SchedulerHandler* GetSelf(Zenith* zenith)
         {
             zenith->GetGlobalKey("Zenith");
@@ -32,6 +37,17 @@ namespace Scripting::Scheduler
             return luaManager->GetLuaHandler<SchedulerHandler>(
                 static_cast<LuaHandlerID>(MetaGen::Game::Lua::LuaHandlerTypeEnum::Scheduler));
         }
+
+        template <typename Queue, typename T>
+        void PopDue(Queue& queue, const T& now, std::vector<u64>& dueCallbacks)
+        {
+            while (!queue.empty() && queue.front().due <= now)
+            {
+                std::pop_heap(queue.begin(), queue.end(), std::greater<>());
+                dueCallbacks.push_back(queue.back().handle);
+                queue.pop_back();
+            }
+        }
     }
 
     void SchedulerHandler::Register(Zenith* zenith)
@@ -41,46 +57,58 @@ namespace Scripting::Scheduler
 
     void SchedulerHandler::Clear(Zenith* zenith)
     {
-        for (auto iterator = _callbacks.begin(); iterator != _callbacks.end();)
+        auto ownerIterator = _owners.find(zenith);
+        if (ownerIterator != _owners.end())
         {
-            if (iterator->second.owner != zenith)
+            auto release = [&](u64 handle)
             {
-                ++iterator;
-                continue;
-            }
+                auto iterator = _callbacks.find(handle);
+                if (iterator == _callbacks.end() || iterator->second.owner != zenith)
+                    return;
+
+                Scripting::Util::Zenith::Unref(zenith, iterator->second.callbackRef);
+                _callbacks.erase(iterator);
+            };
+
+            for (const auto& queued : ownerIterator->second.secondsQueue)
+                release(queued.handle);
 
-            Scripting::Util::Zenith::Unref(zenith, iterator->second.callbackRef);
-            iterator = _callbacks.erase(iterator);
+            for (const auto& queued : ownerIterator->second.framesQueue)
+                release(queued.handle);
+
+            _owners.erase(ownerIterator);
         }
-        _frames.erase(zenith);
     }
 
     void SchedulerHandler::Update(Zenith* zenith, f32)
     {
-        const u64 currentFrame = ++_frames[zenith];
-        const Clock::time_point now = Clock::now();
-        std::vector<u64> dueCallbacks;
-        dueCallbacks.reserve(_callbacks.size());
+        OwnerState& ownerState = _owners[zenith];
+        const u64 currentFrame = ++ownerState.frame;
+        const Clock::time_point now = _now();
 
-        for (const auto& [handle, callback] : _callbacks)
-        {
-            if (callback.owner != zenith)
-                continue;
+        // Only what is due gets touched, the rest of the queues stay as they are
+        _dueCallbacks.clear();
+        PopDue(ownerState.secondsQueue, now, _dueCallbacks);
+        PopDue(ownerState.framesQueue, currentFrame, _dueCallbacks);
 
-            const bool isDue = callback.type == ScheduleType::Seconds
-                ? callback.deadline <= now
-                : callback.targetFrame <= currentFrame;
-            if (isDue)
-                dueCallbacks.push_back(handle);
-        }
+        if (_dueCallbacks.empty())
+            return;
 
-        std::sort(dueCallbacks.begin(), dueCallbacks.end());
+        // Handles are handed out in increasing order, so this runs everything due this frame in registration order
+        std::sort(_dueCallbacks.begin(), _dueCallbacks.end());
 
-        for (const u64 handle : dueCallbacks)
+        // Callbacks scheduled from inside a callback go into the queues and run on a later Update at the earliest
+        for (const u64 handle : _dueCallbacks)
         {
             auto iterator = _callbacks.find(handle);
             if (iterator == _callbacks.end() || iterator->second.owner != zenith)
+            {
+                // Cancelled, possibly by an earlier callback in this batch after a compaction already reset the count
+                if (ownerState.numCancelled > 0)
+                    ownerState.numCancelled--;
+
                 continue;
+            }
 
             const i32 callbackRef = iterator->second.callbackRef;
             zenith->GetRawI(LUA_REGISTRYINDEX, callbackRef);
@@ -105,15 +133,6 @@ namespace Scripting::Scheduler
             return 0;
         }
 
-        const Clock::time_point now = Clock::now();
-        const f64 maxSeconds = std::chrono::duration<f64>(
-            Clock::time_point::max() - now).count();
-        if (seconds > maxSeconds)
-        {
-            luaL_error(zenith->state, "Scheduler.AfterSeconds seconds exceed the supported clock range");
-            return 0;
-        }
-
         if (!zenith->IsFunction(2))
         {
             luaL_error(zenith->state, "Scheduler.AfterSeconds callback must be a function");
@@ -127,11 +146,20 @@ namespace Scripting::Scheduler
             return 0;
         }
 
+        const Clock::time_point now = self->_now();
+        const f64 maxSeconds = std::chrono::duration<f64>(
+            Clock::time_point::max() - now).count();
+        if (seconds > maxSeconds)
+        {
+            luaL_error(zenith->state, "Scheduler.AfterSeconds seconds exceed the supported clock range");
+            return 0;
+        }
+
         const auto duration = std::chrono::duration_cast<Clock::duration>(
             std::chrono::duration<f64>(seconds));
         const u64 handle = self->AllocateHandle();
         const i32 callbackRef = zenith->GetRef(2);
-        self->_callbacks.emplace(handle, PendingCallback{
+        self->Enqueue(zenith, handle, PendingCallback{
             .owner = zenith,
             .type = ScheduleType::Seconds,
             .deadline = now + duration,
@@ -174,7 +202,7 @@ namespace Scripting::Scheduler
         }
 
         const u64 frames = static_cast<u64>(frameValue);
-        const u64 currentFrame = self->_frames[zenith];
+        const u64 currentFrame = self->_owners[zenith].frame;
         if (frames > std::numeric_limits<u64>::max() - currentFrame)
         {
             luaL_error(zenith->state, "Scheduler.AfterFrames frames exceed the supported range");
@@ -183,7 +211,7 @@ namespace Scripting::Scheduler
 
         const u64 handle = self->AllocateHandle();
         const i32 callbackRef = zenith->GetRef(2);
-        self->_callbacks.emplace(handle, PendingCallback{
+        self->Enqueue(zenith, handle, PendingCallback{
             .owner = zenith,
             .type = ScheduleType::Frames,
             .targetFrame = currentFrame + frames,
@@ -219,6 +247,15 @@ namespace Scripting::Scheduler
 
         Scripting::Util::Zenith::Unref(zenith, iterator->second.callbackRef);
         self->_callbacks.erase(iterator);
+
+        // The queue entry is left behind and skipped once it comes due
+        OwnerState& ownerState = self->_owners[zenith];
+        ownerState.numCancelled++;
+
+        const size_t numQueued = ownerState.secondsQueue.size() + ownerState.framesQueue.size();
+        if (ownerState.numCancelled >= MinCancelledBeforeCompact && ownerState.numCancelled * 2 > numQueued)
+            self->CompactQueues(ownerState);
+
         zenith->Push(true);
         return 1;
     }
@@ -232,4 +269,34 @@ namespace Scripting::Scheduler
         } while (handle == 0 || _callbacks.contains(handle));
         return handle;
     }
+
+    void SchedulerHandler::Enqueue(Zenith* zenith, u64 handle, const PendingCallback& callback)
+    {
+        _callbacks.emplace(handle, callback);
+
+        OwnerState& ownerState = _owners[zenith];
+        if (callback.type == ScheduleType::Seconds)
+        {
+            ownerState.secondsQueue.push_back({ callback.deadline, handle });
+            std::push_heap(ownerState.secondsQueue.begin(), ownerState.secondsQueue.end(), std::greater<>());
+        }
+        else
+        {
+            ownerState.framesQueue.push_back({ callback.targetFrame, handle });
+            std::push_heap(ownerState.framesQueue.begin(), ownerState.framesQueue.end(), std::greater<>());
+        }
+    }
+
+    void SchedulerHandler::CompactQueues(OwnerState& ownerState)
+    {
+        auto isCancelled = [this](const auto& queued) { return !_callbacks.contains(queued.handle); };
+
+        std::erase_if(ownerState.secondsQueue, isCancelled);
+        std::make_heap(ownerState.secondsQueue.begin(), ownerState.secondsQueue.end(), std::greater<>());
+
+        std::erase_if(ownerState.framesQueue, isCancelled);
+        std::make_heap(ownerState.framesQueue.begin(), ownerState.framesQueue.end(), std::greater<>());
+
+        ownerState.numCancelled = 0;
+    }
 }
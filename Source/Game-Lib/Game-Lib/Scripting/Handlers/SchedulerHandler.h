@@ -5,12 +5,18 @@
 #include <Scripting/LuaMethodTable.h>
 
 #include <chrono>
+#include <functional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace Scripting::Scheduler
 {
     class SchedulerHandler : public LuaHandlerBase
     {
+    public:
+        using Clock = std::chrono::steady_clock;
+
     public:
         void Register(Zenith* zenith);
         void Clear(Zenith* zenith);
@@ -22,9 +28,10 @@ namespace Scripting::Scheduler
         static i32 AfterFrames(Zenith* zenith);
         static i32 Cancel(Zenith* zenith);
 
-    private:
-        using Clock = std::chrono::steady_clock;
+        // Lets tests drive AfterSeconds deadlines without waiting on the wall clock
+        void SetClock(std::function<Clock::time_point()> now) { _now = std::move(now); }
 
+    private:
         enum class ScheduleType : u8
         {
             Seconds,
@@ -40,11 +47,36 @@ namespace Scripting::Scheduler
             i32 callbackRef = -1;
         };
 
+        // Min-heap entries, ties on the due time are broken by handle so callbacks due together keep their registration order
+        template <typename T>
+        struct QueuedCallback
+        {
+            T due;
+            u64 handle = 0;
+
+            auto operator<=>(const QueuedCallback&) const = default;
+        };
+
+        struct OwnerState
+        {
+            u64 frame = 0;
+            std::vector<QueuedCallback<Clock::time_point>> secondsQueue;
+            std::vector<QueuedCallback<u64>> framesQueue;
+
+            // Cancelled callbacks stay in the queues until they come due or get compacted away
+            u32 numCancelled = 0;
+        };
+
         u64 AllocateHandle();
+        void Enqueue(Zenith* zenith, u64 handle, const PendingCallback& callback);
+        void CompactQueues(OwnerState& ownerState);
+
+        std::function<Clock::time_point()> _now = Clock::now;
 
         u64 _nextHandle = 1;
         std::unordered_map<u64, PendingCallback> _callbacks;
-        std::unordered_map<Zenith*, u64> _frames;
+        std::unordered_map<Zenith*, OwnerState> _owners;
+        std::vector<u64> _dueCallbacks;
     };
 
     static LuaRegister<> schedulerGlobalMethods[] =
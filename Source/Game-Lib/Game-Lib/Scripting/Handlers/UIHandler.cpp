@@ -317,6 +317,12 @@ namespace Scripting::UI
             uiSingleton.cursorCanvasEntity = entt::null;
             uiSingleton.allHoveredEntities.clear();
             uiSingleton.scriptWidgets.clear();
+
+            uiSingleton.hitGrid.Clear();
+            uiSingleton.hitGridDirtyCanvases.clear();
+            uiSingleton.hitGridFullyDirty = true;
+            uiSingleton.hitGridCursorCanvasEntity = entt::null;
+            uiSingleton.hoveredEntitiesFromHitGrid = false;
         }
 
         InputActionSystem* inputActions = ServiceLocator::GetInputActionSystem();
@@ -64,9 +64,26 @@ namespace Util::Animation
         return sequenceID;
     }
 
-    ::Animation::Defines::SequenceID GetSequenceIndexForAnimation(const Model::ComplexModel* modelInfo, ::Animation::Defines::Type animationType, i8& timesToRepeat)
+    static f32 NextVariationRandom(u32& randomState)
     {
-        i32 probability = static_cast<i32>((static_cast<f32>(rand()) / static_cast<f32>(RAND_MAX)) * static_cast<f32>(0x7FFF));
+        // xorshift32, rand() is shared between threads and would make the picked variation depend on update order
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+
+        return static_cast<f32>(randomState >> 8) / static_cast<f32>(0xFFFFFF);
+    }
+
+    u32 GetVariationRandomSeed(entt::entity entity)
+    {
+        // Spread consecutive entity ids apart, xorshift32 needs a non zero state
+        u32 seed = static_cast<u32>(entt::to_integral(entity)) * 0x9E3779B1u;
+        return seed != 0 ? seed : 1;
+    }
+
+    ::Animation::Defines::SequenceID GetSequenceIndexForAnimation(const Model::ComplexModel* modelInfo, ::Animation::Defines::Type animationType, i8& timesToRepeat, u32& randomState)
+    {
+        i32 probability = static_cast<i32>(NextVariationRandom(randomState) * static_cast<f32>(0x7FFF));
         i32 currentProbability = 0;
 
         u32 nextSequenceID = ::Animation::Defines::InvalidSequenceID;
@@ -88,7 +105,7 @@ namespace Util::Animation
         u32 minRepetitions = nextVariationSequence.repetitionRange.x;
         u32 maxRepetitions = nextVariationSequence.repetitionRange.y;
 
-        timesToRepeat = static_cast<i8>(minRepetitions + ((maxRepetitions - minRepetitions) * (static_cast<f32>(rand()) / static_cast<f32>(RAND_MAX)))) - 1;
+        timesToRepeat = static_cast<i8>(minRepetitions + ((maxRepetitions - minRepetitions) * NextVariationRandom(randomState))) - 1;
 
         return nextSequenceID;
     }
@@ -156,7 +173,7 @@ namespace Util::Animation
         if (boneIndex >= numBoneInstances)
             return false;
 
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
 
         if (animationType == ::Animation::Defines::Type::Invalid)
         {
@@ -293,7 +310,7 @@ namespace Util::Animation
         if (shouldBlend)
         {
             animationState.nextAnimation = animationType;
-            animationState.nextSequenceIndex = Util::Animation::GetSequenceIndexForAnimation(modelInfo, animType, animationState.timesToRepeat);
+            animationState.nextSequenceIndex = Util::Animation::GetSequenceIndexForAnimation(modelInfo, animType, animationState.timesToRepeat, animationData.variationRandomState);
             animationState.nextFlags = animationFlags | ::Animation::Defines::Flags::ForceTransition;
             animationState.timeToTransitionMS = blendTimeStartInMS;
             animationState.transitionTime = 0.0f;
@@ -301,7 +318,7 @@ namespace Util::Animation
         else
         {
             animationState.currentAnimation = animationType;
-            animationState.currentSequenceIndex = Util::Animation::GetSequenceIndexForAnimation(modelInfo, animType, animationState.timesToRepeat);
+            animationState.currentSequenceIndex = Util::Animation::GetSequenceIndexForAnimation(modelInfo, animType, animationState.timesToRepeat, animationData.variationRandomState);
             animationState.nextAnimation = ::Animation::Defines::Type::Invalid;
             animationState.nextSequenceIndex = ::Animation::Defines::InvalidSequenceID;
             animationState.currentFlags = animationFlags;
@@ -27,7 +27,8 @@ namespace Util::Animation
     const MetaGen::Shared::ClientDB::AnimationDataRecord* GetAnimationDataRec(::Animation::Defines::Type type);
     bool HasAnimationSequence(const Model::ComplexModel* modelInfo, ::Animation::Defines::Type animationType);
     ::Animation::Defines::SequenceID GetFirstSequenceForAnimation(const Model::ComplexModel* modelInfo, ::Animation::Defines::Type animationID);
-    ::Animation::Defines::SequenceID GetSequenceIndexForAnimation(const Model::ComplexModel* modelInfo, ::Animation::Defines::Type animationType, i8& timesToRepeat);
+    ::Animation::Defines::SequenceID GetSequenceIndexForAnimation(const Model::ComplexModel* modelInfo, ::Animation::Defines::Type animationType, i8& timesToRepeat, u32& randomState);
+    u32 GetVariationRandomSeed(entt::entity entity);
     i16 GetBoneIndexFromKeyBoneID(const Model::ComplexModel* modelInfo, ::Animation::Defines::Bone bone);
 
     bool SetBoneSequenceRaw(const Model::ComplexModel* modelInfo, ECS::Components::AnimationData& animationData, u32 boneIndex, ::Animation::Defines::Type animationType, bool propagateToChildren, ::Animation::Defines::Flags flags = ::Animation::Defines::Flags::None, ::Animation::Defines::BlendOverride blendOverride = ::Animation::Defines::BlendOverride::Auto, f32 speedModifier = 1.0f);
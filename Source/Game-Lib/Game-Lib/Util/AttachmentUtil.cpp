@@ -67,7 +67,7 @@ namespace Util::Attachment
 
     bool EnableAttachment(entt::entity parent, const ECS::Components::Model& model, ::ECS::Components::AttachmentData& attachmentData, ::ECS::Components::AnimationData& animationData, ::Attachment::Defines::Type attachment)
     {
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
 
         const auto* modelInfo = modelLoader->GetModelInfo(model.modelHash);
         if (!modelInfo)
@@ -126,19 +126,16 @@ namespace Util::Attachment
         return attachmentMatrix;
     }
 
-    void CalculateAttachmentMatrix(const Model::ComplexModel* modelInfo, const ECS::Components::AnimationData& animationData, ::Attachment::Defines::Type attachment, ECS::Components::AttachmentInstance& attachmentInstance)
+    bool CalculateAttachmentTransform(const Model::ComplexModel* modelInfo, const ECS::Components::AnimationData& animationData, ::Attachment::Defines::Type attachment, ECS::Components::AttachmentInstance& attachmentInstance, u64 frameNumber, vec3& translation, quat& rotation, vec3& scale)
     {
-        entt::registry* registry = ServiceLocator::GetEnttRegistries()->gameRegistry;
-        ECS::Singletons::RenderState& renderState = registry->ctx().get<ECS::Singletons::RenderState>();
-
-        if (attachmentInstance.lastUpdatedFrame == renderState.frameNumber)
-            return;
+        if (attachmentInstance.lastUpdatedFrame == frameNumber)
+            return false;
 
-        attachmentInstance.lastUpdatedFrame = renderState.frameNumber;
+        attachmentInstance.lastUpdatedFrame = frameNumber;
 
         u16 attachmentIndex = ::Attachment::Defines::InvalidAttachmentIndex;
         if (!::Util::Attachment::CanUseAttachment(modelInfo, attachment, attachmentIndex))
-            return;
+            return false;
 
         const Model::ComplexModel::Attachment& skeletonAttachment = modelInfo->attachments[attachmentIndex];
         u32 numBones = static_cast<u32>(modelInfo->bones.size());
@@ -151,12 +148,20 @@ namespace Util::Attachment
         mat4x4 attachmentMatrix = CalculateBaseAttachmentMatrix(skeletonAttachment);
         attachmentInstance.matrix = mul(attachmentMatrix, parentBoneMatrix);
 
+        vec3 skew;
+        vec4 perspective;
+        return glm::decompose(attachmentInstance.matrix, scale, rotation, translation, skew, perspective);
+    }
+
+    void CalculateAttachmentMatrix(const Model::ComplexModel* modelInfo, const ECS::Components::AnimationData& animationData, ::Attachment::Defines::Type attachment, ECS::Components::AttachmentInstance& attachmentInstance)
+    {
+        entt::registry* registry = ServiceLocator::GetEnttRegistries()->gameRegistry;
+        ECS::Singletons::RenderState& renderState = registry->ctx().get<ECS::Singletons::RenderState>();
+
         vec3 scale;
         quat rotation;
         vec3 translation;
-        vec3 skew;
-        vec4 perspective;
-        if (!glm::decompose(attachmentInstance.matrix, scale, rotation, translation, skew, perspective))
+        if (!CalculateAttachmentTransform(modelInfo, animationData, attachment, attachmentInstance, renderState.frameNumber, translation, rotation, scale))
             return;
 
         auto& transformSystem = registry->ctx().get<ECS::TransformSystem>();
@@ -165,7 +170,7 @@ namespace Util::Attachment
 
     const mat4x4* GetAttachmentMatrix(const ECS::Components::Model& model, const ECS::Components::AnimationData& animationData, ::ECS::Components::AttachmentData& attachmentData, ::Attachment::Defines::Type attachment)
     {
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
 
         const auto* modelInfo = modelLoader->GetModelInfo(model.modelHash);
         if (!modelInfo)
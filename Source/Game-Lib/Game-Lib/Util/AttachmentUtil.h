@@ -9,6 +9,7 @@ namespace ECS::Components
 {
     struct AnimationData;
     struct AttachmentData;
+    struct AttachmentInstance;
     struct Model;
 }
 
@@ -26,6 +27,10 @@ namespace Util::Attachment
     bool HasActiveAttachment(const Model::ComplexModel* modelInfo, ::ECS::Components::AttachmentData& attachmentData, ::Attachment::Defines::Type attachment);
     bool GetAttachmentEntity(const Model::ComplexModel* modelInfo, ::ECS::Components::AttachmentData& attachmentData, ::Attachment::Defines::Type attachment, entt::entity& entity);
     bool EnableAttachment(entt::entity parent, const ECS::Components::Model& model, ::ECS::Components::AttachmentData& attachmentData, ::ECS::Components::AnimationData& animationData, ::Attachment::Defines::Type attachment);
+
+    // Updates the attachment's matrix for this frame and decomposes it, without touching the attachment entity's transform.
+    // Returns false when the attachment was already updated this frame or has nothing to apply.
+    bool CalculateAttachmentTransform(const Model::ComplexModel* modelInfo, const ECS::Components::AnimationData& animationData, ::Attachment::Defines::Type attachment, ECS::Components::AttachmentInstance& attachmentInstance, u64 frameNumber, vec3& translation, quat& rotation, vec3& scale);
     void CalculateAttachmentMatrix(const Model::ComplexModel* modelInfo, const ECS::Components::AnimationData& animationData, ::Attachment::Defines::Type attachment, ECS::Components::AttachmentInstance& attachmentInstance);
     const mat4x4* GetAttachmentMatrix(const ECS::Components::Model& model, const ECS::Components::AnimationData& animationData, ::ECS::Components::AttachmentData& attachmentData, ::Attachment::Defines::Type attachment);
 }
@@ -2,6 +2,7 @@
 
 #include "Game-Lib/Application/EnttRegistries.h"
 #include "Game-Lib/ECS/Singletons/Database/ClientDBSingleton.h"
+#include "Game-Lib/Util/AssetWriter.h"
 #include "Game-Lib/Util/ServiceLocator.h"
 
 #include <Base/Util/DebugHandler.h>
@@ -10,8 +11,12 @@
 
 #include <Filesystem/PactStorage.h>
 
+#include <enkiTS/TaskScheduler.h>
+
 #include <entt/entt.hpp>
 
+#include <xxhash/xxhash64.h>
+
 #include <array>
 #include <filesystem>
 #include <string>
@@ -44,34 +49,139 @@ namespace Util::ClientDB
         u32 numLoadedClientDBs = 0;
         clientDBSingleton.Reserve(numTotalClientDBs);
 
+        // Registering touches the singleton's maps so it stays serial, every registered DB then reads only into its own storage
+        std::vector<::ClientDB::Data*> dbs(numTotalClientDBs, nullptr);
+        for (u32 i = 0; i < numTotalClientDBs; i++)
+        {
+            const auto& [dbHash, debugName] = clientDBs[i];
+            if (clientDBSingleton.Has(dbHash) || !clientDBSingleton.Register(dbHash, debugName))
+                continue;
+
+            dbs[i] = clientDBSingleton.Get(dbHash);
+        }
+
+        enum class LoadResult : u8
+        {
+            None,
+            FailedToRead,
+            FailedToParse,
+            Success
+        };
+
+        std::vector<LoadResult> loadResults(numTotalClientDBs, LoadResult::None);
+        std::vector<u64> contentHashes(numTotalClientDBs, 0);
+
         auto* pactStorage = ServiceLocator::GetPactStorage();
+        enki::TaskScheduler* taskScheduler = ServiceLocator::GetTaskScheduler();
 
-        for (const auto& [dbHash, debugName] : clientDBs)
+        enki::TaskSet loadTask(numTotalClientDBs, [&](enki::TaskSetPartition range, uint32_t threadNum)
         {
-            PACT::PactFileHandle fileHandle;
-            if (pactStorage->ReadFile(static_cast<u64>(dbHash), fileHandle) != PACT::PactReadResult::Success)
+            for (u32 i = range.start; i < range.end; i++)
             {
-                NC_LOG_ERROR("ClientDBLoader : Failed to load '{0}'. Could not read file.", debugName);
-                continue;
+                ::ClientDB::Data* db = dbs[i];
+                if (!db)
+                    continue;
+
+                ClientDBHash dbHash = clientDBs[i].first;
+
+                PACT::PactFileHandle fileHandle;
+                if (pactStorage->ReadFile(static_cast<u64>(dbHash), fileHandle) != PACT::PactReadResult::Success)
+                {
+                    loadResults[i] = LoadResult::FailedToRead;
+                    continue;
+                }
+
+                std::shared_ptr<Bytebuffer> buffer = std::make_shared<Bytebuffer>(const_cast<void*>(fileHandle.GetData()), fileHandle.GetSize());
+                buffer->writtenData = buffer->size;
+
+                if (!db->Read(buffer))
+                {
+                    loadResults[i] = LoadResult::FailedToParse;
+                    continue;
+                }
+
+                contentHashes[i] = XXHash64::hash(fileHandle.GetData(), fileHandle.GetSize(), 0);
+                loadResults[i] = LoadResult::Success;
             }
+        });
+        loadTask.m_MinRange = 1;
 
-            if (!clientDBSingleton.Register(dbHash, debugName))
-                continue;
+        taskScheduler->AddTaskSetToPipe(&loadTask);
+        taskScheduler->WaitforTask(&loadTask);
 
-            ::ClientDB::Data* db = clientDBSingleton.Get(dbHash);
-            std::shared_ptr<Bytebuffer> buffer = std::make_shared<Bytebuffer>(const_cast<void*>(fileHandle.GetData()), fileHandle.GetSize());
-            buffer->writtenData = buffer->size;
+        for (u32 i = 0; i < numTotalClientDBs; i++)
+        {
+            const auto& [dbHash, debugName] = clientDBs[i];
 
-            if (!db->Read(buffer))
+            switch (loadResults[i])
             {
-                NC_LOG_ERROR("ClientDBLoader : Failed to load '{0}'. Could not read ClientDB from Buffer.", debugName);
-                clientDBSingleton.Remove(dbHash);
-                continue;
+                case LoadResult::FailedToRead:
+                {
+                    NC_LOG_ERROR("ClientDBLoader : Failed to load '{0}'. Could not read file.", debugName);
+                    clientDBSingleton.Remove(dbHash);
+                    break;
+                }
+
+                case LoadResult::FailedToParse:
+                {
+                    NC_LOG_ERROR("ClientDBLoader : Failed to load '{0}'. Could not read ClientDB from Buffer.", debugName);
+                    clientDBSingleton.Remove(dbHash);
+                    break;
+                }
+
+                case LoadResult::Success:
+                {
+                    clientDBSingleton.SetContentHash(dbHash, contentHashes[i]);
+                    numLoadedClientDBs++;
+                    break;
+                }
+
+                default: break;
             }
-
-            numLoadedClientDBs++;
         }
 
         NC_LOG_INFO("Loaded {0}/{1} Client Database Files", numLoadedClientDBs, numTotalClientDBs);
     }
+
+    bool LoadOrBuildLookups(ECS::Singletons::ClientDBSingleton& clientDBSingleton, const LookupSnapshotDesc& desc,
+                            const std::function<bool(const LookupSnapshot::Reader&)>& load,
+                            const std::function<void()>& build,
+                            const std::function<void(LookupSnapshot::Writer&)>& save)
+    {
+        // Missing or edited sources have no content hash, the lookups are then built without touching the snapshot
+        bool hasSourceHash = true;
+        u64 sourceHash = desc.schemaVersion;
+        for (ClientDBHash dbHash : desc.sourceDBs)
+        {
+            u64 contentHash = 0;
+            if (!clientDBSingleton.TryGetContentHash(dbHash, contentHash))
+            {
+                hasSourceHash = false;
+                break;
+            }
+
+            sourceHash = LookupSnapshot::CombineHash(sourceHash, contentHash);
+        }
+
+        fs::path snapshotPath;
+        bool hasSnapshotPath = hasSourceHash && ServiceLocator::GetAssetWriter()->ResolvePath("Cache/" + std::string(desc.name) + ".snapshot", AssetWriteTarget::Disk, snapshotPath);
+
+        if (hasSnapshotPath)
+        {
+            LookupSnapshot::Reader reader;
+            if (reader.Load(snapshotPath, desc.schemaVersion, sourceHash) && load(reader))
+                return true;
+        }
+
+        build();
+
+        if (hasSnapshotPath)
+        {
+            LookupSnapshot::Writer writer(desc.schemaVersion, sourceHash);
+            save(writer);
+            writer.Save(snapshotPath);
+        }
+
+        return false;
+    }
 }
@@ -1,7 +1,32 @@
 #pragma once
+#include "Game-Lib/ECS/Singletons/Database/ClientDBSingleton.h"
+#include "Game-Lib/Util/LookupSnapshot.h"
+
 #include <Base/Types.h>
 
+#include <functional>
+#include <span>
+#include <string_view>
+
 namespace Util::ClientDB
 {
+    struct LookupSnapshotDesc
+    {
+    public:
+        std::string_view name;
+        u32 schemaVersion = 0;
+
+        // Every DB the lookups are derived from, editing any of them invalidates the snapshot
+        std::span<const ClientDBHash> sourceDBs;
+    };
+
     void DiscoverAll();
-}
\ No newline at end of file
+
+    // Loads lookups derived from ClientDBs out of Cache/<name>.snapshot in the data directory, or builds them and saves a new snapshot when it is missing or stale
+    // Build is also called when Load fails partway, so it has to start by clearing what Load may have filled in
+    // Returns true if the lookups came from the snapshot
+    bool LoadOrBuildLookups(ECS::Singletons::ClientDBSingleton& clientDBSingleton, const LookupSnapshotDesc& desc,
+                            const std::function<bool(const LookupSnapshot::Reader&)>& load,
+                            const std::function<void()>& build,
+                            const std::function<void(LookupSnapshot::Writer&)>& save);
+}
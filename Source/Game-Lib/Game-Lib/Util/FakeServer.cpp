@@ -0,0 +1,207 @@
+#include "FakeServer.h"
+
+#include "Game-Lib/ECS/Components/MovementInfo.h"
+#include "Game-Lib/ECS/Singletons/NetworkState.h"
+#include "Game-Lib/ECS/Util/MessageBuilderUtil.h"
+#include "Game-Lib/ECS/Util/Network/MessageDispatchQueue.h"
+#include "Game-Lib/ECS/Util/Network/NetworkUtil.h"
+#include "Game-Lib/Util/ServiceLocator.h"
+
+#include <Base/CVarSystem/CVarSystem.h>
+#include <Base/Memory/Bytebuffer.h>
+#include <Base/Util/DebugHandler.h>
+
+#include <Gameplay/ECS/Components/UnitFields.h>
+#include <Gameplay/Network/GameMessageRouter.h>
+
+#include <MetaGen/Shared/Packet/Packet.h>
+
+#include <Network/Define.h>
+
+#include <entt/entt.hpp>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <utility>
+
+namespace Util
+{
+    // Keeps the bots clear of any real characters a developer might have in the same database
+    static constexpr u64 FAKE_SERVER_GUID_COUNTER_BASE = 0x40000000;
+
+    FakeServer::FakeServer(const FakeServerSettings& settings) : _settings(settings)
+    {
+        _units.reserve(settings.numUnits);
+        _randomState = settings.seed != 0 ? settings.seed : 1;
+    }
+
+    bool FakeServer::Update(f32 deltaTime)
+    {
+        ZoneScopedN("Util::FakeServer::Update");
+        _time += deltaTime;
+
+        if (_units.size() < _settings.numUnits)
+        {
+            _spawnAccumulator += deltaTime * _settings.spawnsPerSecond;
+            while (_spawnAccumulator >= 1.0f && _units.size() < _settings.numUnits)
+            {
+                _spawnAccumulator -= 1.0f;
+                if (!SpawnUnit())
+                    return false;
+            }
+        }
+
+        u32 numUnits = static_cast<u32>(_units.size());
+        if (numUnits == 0)
+            return true;
+
+        _moveAccumulator += deltaTime * _settings.movesPerSecond * numUnits;
+        u32 numMoves = std::min(static_cast<u32>(_moveAccumulator), numUnits);
+        _moveAccumulator -= static_cast<f32>(static_cast<u32>(_moveAccumulator));
+
+        for (u32 i = 0; i < numMoves; i++)
+        {
+            if (!MoveUnit(_units[_nextMoveIndex]))
+                return false;
+
+            _nextMoveIndex = (_nextMoveIndex + 1) % numUnits;
+        }
+
+        _netFieldAccumulator += deltaTime * _settings.netFieldUpdatesPerSecond * numUnits;
+        u32 numNetFieldUpdates = std::min(static_cast<u32>(_netFieldAccumulator), numUnits);
+        _netFieldAccumulator -= static_cast<f32>(static_cast<u32>(_netFieldAccumulator));
+
+        for (u32 i = 0; i < numNetFieldUpdates; i++)
+        {
+            if (!UpdateUnitNetFields(_units[_nextNetFieldIndex]))
+                return false;
+
+            _nextNetFieldIndex = (_nextNetFieldIndex + 1) % numUnits;
+        }
+
+        return true;
+    }
+
+    bool FakeServer::SpawnUnit()
+    {
+        u32 index = static_cast<u32>(_units.size());
+
+        f32 angle = NextRandom() * glm::two_pi<f32>();
+        f32 distance = glm::sqrt(NextRandom()) * _settings.spawnRadius;
+
+        FakeUnit& unit = _units.emplace_back();
+        unit.guid = ObjectGUID::CreatePlayer(FAKE_SERVER_GUID_COUNTER_BASE + index);
+        unit.home = _settings.center + vec3(glm::cos(angle) * distance, 0.0f, glm::sin(angle) * distance);
+        unit.phase = NextRandom() * glm::two_pi<f32>();
+
+        MetaGen::Shared::Packet::ServerUnitAddPacket packet;
+        packet.guid = unit.guid;
+        packet.name = "Bot " + std::to_string(index);
+        packet.unitClass = 1;
+        packet.position = unit.home + vec3(glm::cos(unit.phase), 0.0f, glm::sin(unit.phase)) * _settings.walkRadius;
+        packet.scale = vec3(1.0f);
+        packet.pitchYaw = vec2(0.0f, unit.phase + glm::half_pi<f32>());
+
+        std::shared_ptr<Bytebuffer> buffer = ECS::Util::Network::CreatePacketBuffer(packet);
+        if (!Dispatch(buffer))
+            return false;
+
+        return UpdateUnitNetFields(unit);
+    }
+
+    bool FakeServer::MoveUnit(const FakeUnit& unit)
+    {
+        f32 angle = unit.phase + (_time * _settings.walkSpeed / glm::max(_settings.walkRadius, 0.01f));
+
+        ECS::Components::MovementFlags movementFlags;
+        movementFlags.forward = 1;
+        movementFlags.grounded = 1;
+
+        MetaGen::Shared::Packet::ServerUnitMovePacket packet;
+        packet.guid = unit.guid;
+        packet.position = unit.home + vec3(glm::cos(angle), 0.0f, glm::sin(angle)) * _settings.walkRadius;
+        packet.pitchYaw = vec2(0.0f, angle + glm::half_pi<f32>());
+        packet.movementFlags = *reinterpret_cast<u32*>(&movementFlags);
+        packet.verticalVelocity = 0.0f;
+
+        std::shared_ptr<Bytebuffer> buffer = ECS::Util::Network::CreatePacketBuffer(packet);
+        return Dispatch(buffer);
+    }
+
+    bool FakeServer::UpdateUnitNetFields(FakeUnit& unit)
+    {
+        using UnitNetField = MetaGen::Shared::NetField::UnitNetFieldEnum;
+
+        unit.level = (unit.level % 80) + 1;
+
+        // Level in the low 16 bits and race from bit 16, gender (bit 23) stays 0, matching what the DisplayID listener unpacks
+        u32 levelRaceGenderClassPacked = static_cast<u32>(unit.level) | (1u << 16);
+
+        std::array<std::pair<u16, u32>, 2> fields =
+        {
+            std::pair<u16, u32>{ static_cast<u16>(UnitNetField::LevelRaceGenderClassPacked), levelRaceGenderClassPacked },
+            std::pair<u16, u32>{ static_cast<u16>(UnitNetField::DisplayID), _settings.displayID }
+        };
+        std::sort(fields.begin(), fields.end());
+
+        std::shared_ptr<Bytebuffer> buffer = Bytebuffer::BorrowRuntime(sizeof(::Network::MessageHeader) + sizeof(ObjectGUID) + (sizeof(u8) * 2) + 256 + (fields.size() * sizeof(u32)));
+        if (!ECS::Util::MessageBuilder::Unit::BuildUnitNetFieldUpdateMessage(buffer, unit.guid, fields))
+            return false;
+
+        return Dispatch(buffer);
+    }
+
+    bool FakeServer::Dispatch(std::shared_ptr<Bytebuffer>& buffer)
+    {
+        entt::registry* registry = ServiceLocator::GetEnttRegistries()->gameRegistry;
+        auto& networkState = registry->ctx().get<ECS::Singletons::NetworkState>();
+
+        ::Network::SocketMessageEvent messageEvent;
+        messageEvent.message.buffer = buffer;
+
+        // A message the router can't take is a bug in the builder, not load, so it fails here instead of closing the connection
+        ::Network::MessageHeader messageHeader;
+        if (!networkState.gameMessageRouter->GetMessageHeader(messageEvent.message, messageHeader) || !networkState.gameMessageRouter->HasValidHandlerForHeader(messageHeader))
+        {
+            NC_LOG_ERROR("FakeServer : Built a message the router has no handler for");
+            return false;
+        }
+
+        // Queued like a received message, NetworkConnection::Update coalesces it and dispatches it within its frame budget
+        bool coalesce = *CVarSystem::Get()->GetIntCVar(CVarCategory::Network, "coalesceMessages") != 0;
+        networkState.messageDispatchQueue->Push(messageEvent, coalesce);
+
+        _numMessagesSent++;
+        return true;
+    }
+
+    u64 FakeServer::GetNumRejected() const
+    {
+        entt::registry* registry = ServiceLocator::GetEnttRegistries()->gameRegistry;
+        return registry->ctx().get<ECS::Singletons::NetworkState>().numRejectedMessages;
+    }
+
+    u32 FakeServer::GetNumQueued() const
+    {
+        entt::registry* registry = ServiceLocator::GetEnttRegistries()->gameRegistry;
+        return registry->ctx().get<ECS::Singletons::NetworkState>().messageDispatchQueue->GetNumQueued();
+    }
+
+    u64 FakeServer::GetNumCoalesced() const
+    {
+        entt::registry* registry = ServiceLocator::GetEnttRegistries()->gameRegistry;
+        return registry->ctx().get<ECS::Singletons::NetworkState>().messageDispatchQueue->GetNumCoalesced();
+    }
+
+    f32 FakeServer::NextRandom()
+    {
+        // xorshift32, std distributions differ between standard libraries and runs should match across CI machines
+        _randomState ^= _randomState << 13;
+        _randomState ^= _randomState >> 17;
+        _randomState ^= _randomState << 5;
+
+        return static_cast<f32>(_randomState >> 8) / static_cast<f32>(1u << 24);
+    }
+}
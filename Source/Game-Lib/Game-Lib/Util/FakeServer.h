@@ -0,0 +1,84 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <Gameplay/GameDefine.h>
+
+#include <memory>
+#include <vector>
+
+class Bytebuffer;
+
+namespace Util
+{
+    struct FakeServerSettings
+    {
+    public:
+        u32 numUnits = 5000;
+        f32 spawnsPerSecond = 1000.0f;
+        f32 movesPerSecond = 10.0f; // Per spawned unit, roughly the server's movement broadcast rate
+        f32 netFieldUpdatesPerSecond = 1.0f; // Per spawned unit
+
+        vec3 center = vec3(0.0f);
+        f32 spawnRadius = 250.0f;
+        f32 walkRadius = 10.0f;
+        f32 walkSpeed = 3.5f;
+
+        u32 displayID = 10045;
+
+        u32 seed = 1337;
+    };
+
+    // In process stand in for the game server, it builds the same messages the server sends and queues them on the
+    // NetworkState's MessageDispatchQueue, so they are coalesced, budgeted and dispatched by NetworkConnection::Update
+    // exactly like messages from a real connection. Units walk a fixed circle around their spawn point which keeps runs
+    // with the same settings comparable.
+    class FakeServer
+    {
+    public:
+        FakeServer(const FakeServerSettings& settings);
+
+        // Queues every message due in deltaTime, returns false if one of them has no handler
+        bool Update(f32 deltaTime);
+
+        u32 GetNumSpawned() const { return static_cast<u32>(_units.size()); }
+        u64 GetNumMessagesSent() const { return _numMessagesSent; }
+
+        // What happened to the queued messages once NetworkConnection got to them
+        u64 GetNumRejected() const;
+        u32 GetNumQueued() const;
+        u64 GetNumCoalesced() const;
+
+    private:
+        struct FakeUnit
+        {
+        public:
+            ObjectGUID guid;
+            vec3 home;
+            f32 phase = 0.0f;
+            u16 level = 1;
+        };
+
+        bool SpawnUnit();
+        bool MoveUnit(const FakeUnit& unit);
+        bool UpdateUnitNetFields(FakeUnit& unit);
+
+        bool Dispatch(std::shared_ptr<Bytebuffer>& buffer);
+        f32 NextRandom(); // [0, 1)
+
+    private:
+        FakeServerSettings _settings;
+        std::vector<FakeUnit> _units;
+
+        f32 _time = 0.0f;
+        f32 _spawnAccumulator = 0.0f;
+        f32 _moveAccumulator = 0.0f;
+        f32 _netFieldAccumulator = 0.0f;
+
+        // Round robin cursors so every unit gets its share of moves and updates regardless of the frame rate
+        u32 _nextMoveIndex = 0;
+        u32 _nextNetFieldIndex = 0;
+
+        u64 _numMessagesSent = 0;
+        u32 _randomState = 0;
+    };
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <tracy/Tracy.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Util
+{
+    // Hands frames from the simulation thread to a render thread through two snapshots, the simulation fills one while the
+    // render thread reads the other. Submit waits for the frame before it to finish rendering, so the render thread is
+    // never more than one frame behind and the latency stays fixed at one frame.
+    // Frame is the snapshot type, the render thread may write results into it that the simulation reads after WaitForRender.
+    template <typename Frame>
+    class FramePipeline
+    {
+    public:
+        using RenderFunction = std::function<void(Frame& frame)>;
+
+        FramePipeline() = default;
+        ~FramePipeline() { Stop(); }
+
+        FramePipeline(const FramePipeline&) = delete;
+        FramePipeline& operator=(const FramePipeline&) = delete;
+
+        void Start(const char* threadName, RenderFunction renderFunction)
+        {
+            if (_thread.joinable())
+                return;
+
+            _renderFunction = std::move(renderFunction);
+            _stopRequested = false;
+            _thread = std::thread([this, threadName]() { RenderThreadMain(threadName); });
+        }
+
+        // Renders the frame that is still in flight before joining the render thread
+        void Stop()
+        {
+            if (!_thread.joinable())
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopRequested = true;
+            }
+            _condition.notify_all();
+
+            _thread.join();
+        }
+
+        bool IsRunning() const { return _thread.joinable(); }
+
+        // The snapshot for the frame being simulated, the render thread does not look at it until Submit
+        Frame& GetSimulationFrame() { return _frames[_simulationIndex]; }
+
+        // Blocks until the last submitted frame has been rendered and returns it, nullptr before the first Submit
+        Frame* WaitForRender()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]() { return _numRendered == _numSubmitted; });
+
+            if (_numSubmitted == 0)
+                return nullptr;
+
+            return &_frames[_renderIndex];
+        }
+
+        // Hands the simulation frame to the render thread and switches the simulation to the other snapshot
+        void Submit()
+        {
+            WaitForRender();
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _renderIndex = _simulationIndex;
+                _numSubmitted++;
+            }
+            _condition.notify_all();
+
+            // The render thread finished with this one before the frame we just handed over was submitted
+            _simulationIndex = !_simulationIndex;
+        }
+
+    private:
+        void RenderThreadMain(const char* threadName)
+        {
+            tracy::SetThreadName(threadName);
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true)
+            {
+                _condition.wait(lock, [this]() { return _stopRequested || _numRendered != _numSubmitted; });
+                if (_numRendered == _numSubmitted)
+                    break;
+
+                Frame& frame = _frames[_renderIndex];
+
+                lock.unlock();
+                _renderFunction(frame);
+                lock.lock();
+
+                _numRendered++;
+                _condition.notify_all();
+            }
+        }
+
+    private:
+        std::array<Frame, 2> _frames;
+        u8 _simulationIndex = 0;
+        u8 _renderIndex = 0;
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        u64 _numSubmitted = 0;
+        u64 _numRendered = 0;
+        bool _stopRequested = false;
+
+        RenderFunction _renderFunction;
+        std::thread _thread;
+    };
+}
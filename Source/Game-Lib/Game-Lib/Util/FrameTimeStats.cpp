@@ -0,0 +1,79 @@
+#include "FrameTimeStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Util
+{
+    void FrameTimeStats::AddSample(const std::string& name, f32 durationMS)
+    {
+        auto itr = _nameToIndex.find(name);
+        if (itr == _nameToIndex.end())
+        {
+            u32 index = static_cast<u32>(_names.size());
+            itr = _nameToIndex.emplace(name, index).first;
+
+            _names.push_back(name);
+            _samples.emplace_back();
+        }
+
+        _samples[itr->second].push_back(durationMS);
+    }
+
+    void FrameTimeStats::Clear()
+    {
+        _nameToIndex.clear();
+        _names.clear();
+        _samples.clear();
+    }
+
+    std::vector<FrameTimeStats::Summary> FrameTimeStats::Summarize() const
+    {
+        std::vector<Summary> summaries;
+        summaries.reserve(_names.size());
+
+        std::vector<f32> sorted;
+        for (u32 i = 0; i < _names.size(); i++)
+        {
+            Summary& summary = summaries.emplace_back();
+            summary.name = _names[i];
+            summary.numSamples = static_cast<u32>(_samples[i].size());
+
+            if (summary.numSamples == 0)
+                continue;
+
+            sorted = _samples[i];
+            std::sort(sorted.begin(), sorted.end());
+
+            f64 total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+            summary.meanMS = static_cast<f32>(total / summary.numSamples);
+            summary.p50MS = Percentile(sorted, 50.0f);
+            summary.p95MS = Percentile(sorted, 95.0f);
+            summary.p99MS = Percentile(sorted, 99.0f);
+            summary.maxMS = sorted.back();
+
+            f64 mean = total / summary.numSamples;
+            f64 squaredDeviations = 0.0;
+            for (f32 sample : sorted)
+            {
+                f64 deviation = sample - mean;
+                squaredDeviations += deviation * deviation;
+            }
+            summary.stddevMS = static_cast<f32>(std::sqrt(squaredDeviations / summary.numSamples));
+        }
+
+        return summaries;
+    }
+
+    f32 FrameTimeStats::Percentile(std::span<const f32> sortedSamples, f32 percentile)
+    {
+        if (sortedSamples.empty())
+            return 0.0f;
+
+        f32 rank = std::ceil((percentile / 100.0f) * static_cast<f32>(sortedSamples.size()));
+        size_t index = static_cast<size_t>(std::max(rank, 1.0f)) - 1;
+
+        return sortedSamples[std::min(index, sortedSamples.size() - 1)];
+    }
+}
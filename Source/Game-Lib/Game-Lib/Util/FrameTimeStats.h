@@ -0,0 +1,47 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <robinhood/robinhood.h>
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Util
+{
+    // Collects one duration per frame for each named timer and summarizes the whole run as percentiles
+    class FrameTimeStats
+    {
+    public:
+        struct Summary
+        {
+        public:
+            std::string name;
+            u32 numSamples = 0;
+
+            f32 meanMS = 0.0f;
+            f32 p50MS = 0.0f;
+            f32 p95MS = 0.0f;
+            f32 p99MS = 0.0f;
+            f32 maxMS = 0.0f;
+
+            // Population standard deviation, how much the timer jitters from frame to frame
+            f32 stddevMS = 0.0f;
+        };
+
+    public:
+        void AddSample(const std::string& name, f32 durationMS);
+        void Clear();
+
+        // In the order the timers were first seen
+        std::vector<Summary> Summarize() const;
+
+        // Nearest rank percentile, sortedSamples must be sorted ascending and percentile is in [0, 100]
+        static f32 Percentile(std::span<const f32> sortedSamples, f32 percentile);
+
+    private:
+        robin_hood::unordered_map<std::string, u32> _nameToIndex;
+        std::vector<std::string> _names;
+        std::vector<std::vector<f32>> _samples;
+    };
+}
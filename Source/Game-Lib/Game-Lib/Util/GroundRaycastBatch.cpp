@@ -0,0 +1,247 @@
+#include "GroundRaycastBatch.h"
+
+#include "Game-Lib/ECS/Singletons/JoltState.h"
+
+#include <enkiTS/TaskScheduler.h>
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyFilter.h>
+#include <Jolt/Physics/Body/BodyLock.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/PhysicsSystem.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    class StaticBroadPhaseFilter final : public JPH::BroadPhaseLayerFilter
+    {
+    public:
+        bool ShouldCollide(JPH::BroadPhaseLayer layer) const override
+        {
+            return layer == Jolt::BroadPhaseLayers::NON_MOVING;
+        }
+    };
+
+    class StaticObjectLayerFilter final : public JPH::ObjectLayerFilter
+    {
+    public:
+        bool ShouldCollide(JPH::ObjectLayer layer) const override
+        {
+            return layer == Jolt::Layers::NON_MOVING;
+        }
+    };
+
+    JPH::RRayCast GetGroundRay(const vec3& expectedPosition, f32 searchRange)
+    {
+        return JPH::RRayCast(
+            JPH::RVec3(expectedPosition.x, expectedPosition.y + searchRange, expectedPosition.z),
+            JPH::Vec3(0.0f, -2.0f * searchRange, 0.0f));
+    }
+
+    // Keeps the hit closest in height to the expected position, surfaces facing sideways or down are not ground
+    void ConsiderHit(const JPH::PhysicsSystem& physicsSystem, const JPH::RRayCast& ray, const JPH::RayCastResult& hit, const vec3& expectedPosition, f32& closestDistance, Util::GroundRaycastBatch::Sample& outSample)
+    {
+        const JPH::RVec3 hitPosition = ray.GetPointOnRay(hit.mFraction);
+        const f32 distance = glm::abs(static_cast<f32>(hitPosition.GetY()) - expectedPosition.y);
+        if (distance >= closestDistance)
+            return;
+
+        JPH::BodyLockRead lock(physicsSystem.GetBodyLockInterface(), hit.mBodyID);
+        if (!lock.SucceededAndIsInBroadPhase())
+            return;
+
+        const JPH::Vec3 normal = lock.GetBody().GetWorldSpaceSurfaceNormal(hit.mSubShapeID2, hitPosition).NormalizedOr(JPH::Vec3::sAxisY());
+        if (normal.GetY() <= 0.05f)
+            return;
+
+        closestDistance = distance;
+        outSample.position = vec3(static_cast<f32>(hitPosition.GetX()), static_cast<f32>(hitPosition.GetY()), static_cast<f32>(hitPosition.GetZ()));
+        outSample.normal = vec3(normal.GetX(), normal.GetY(), normal.GetZ());
+        outSample.hasHit = true;
+    }
+
+    u32 GetCellKey(const vec3& position)
+    {
+        i32 cellX = static_cast<i32>(glm::floor(position.x / Util::GroundRaycastBatch::CELL_SIZE));
+        i32 cellZ = static_cast<i32>(glm::floor(position.z / Util::GroundRaycastBatch::CELL_SIZE));
+
+        return (static_cast<u32>(static_cast<u16>(cellX)) << 16) | static_cast<u32>(static_cast<u16>(cellZ));
+    }
+}
+
+namespace Util
+{
+    void GroundRaycastBatch::Clear()
+    {
+        _expectedPositions.clear();
+        _samples.clear();
+    }
+
+    u32 GroundRaycastBatch::Add(const vec3& expectedPosition)
+    {
+        u32 index = static_cast<u32>(_expectedPositions.size());
+        _expectedPositions.push_back(expectedPosition);
+
+        return index;
+    }
+
+    void GroundRaycastBatch::Execute(const JPH::PhysicsSystem& physicsSystem, enki::TaskScheduler* taskScheduler)
+    {
+        ZoneScopedN("GroundRaycastBatch::Execute");
+
+        u32 numRays = GetNumRays();
+        _samples.assign(numRays, Sample());
+
+        if (numRays == 0)
+            return;
+
+        _sortedRays.resize(numRays);
+        for (u32 i = 0; i < numRays; i++)
+        {
+            _sortedRays[i] = (static_cast<u64>(GetCellKey(_expectedPositions[i])) << 32) | i;
+        }
+        std::sort(_sortedRays.begin(), _sortedRays.end());
+
+        _cells.clear();
+        for (u32 i = 0; i < numRays; i++)
+        {
+            u32 cellKey = static_cast<u32>(_sortedRays[i] >> 32);
+            if (i == 0 || cellKey != static_cast<u32>(_sortedRays[i - 1] >> 32))
+            {
+                _cells.push_back({ i, 0 });
+            }
+
+            _cells.back().numRays++;
+        }
+
+        u32 numCells = static_cast<u32>(_cells.size());
+        if (!taskScheduler || numCells == 1)
+        {
+            if (_cellScratch.empty())
+                _cellScratch.resize(1);
+
+            for (const Cell& cell : _cells)
+            {
+                ExecuteCell(physicsSystem, cell, _cellScratch[0]);
+            }
+
+            return;
+        }
+
+        u32 numThreads = taskScheduler->GetNumTaskThreads();
+        if (_cellScratch.size() < numThreads)
+            _cellScratch.resize(numThreads);
+
+        enki::TaskSet executeCellsTask(numCells, [this, &physicsSystem](enki::TaskSetPartition range, u32 threadNum)
+        {
+            CellScratch& scratch = _cellScratch[threadNum];
+            for (u32 i = range.start; i < range.end; i++)
+            {
+                ExecuteCell(physicsSystem, _cells[i], scratch);
+            }
+        });
+
+        taskScheduler->AddTaskSetToPipe(&executeCellsTask);
+        taskScheduler->WaitforTask(&executeCellsTask);
+    }
+
+    bool GroundRaycastBatch::SampleGround(const JPH::PhysicsSystem& physicsSystem, const vec3& expectedPosition, f32 searchRange, Sample& outSample)
+    {
+        const StaticBroadPhaseFilter broadPhaseFilter;
+        const StaticObjectLayerFilter objectLayerFilter;
+        const JPH::BodyFilter bodyFilter;
+        const JPH::RRayCast ray = GetGroundRay(expectedPosition, searchRange);
+
+        JPH::AllHitCollisionCollector<JPH::CastRayCollector> collector;
+        physicsSystem.GetNarrowPhaseQuery().CastRay(ray, JPH::RayCastSettings(), collector, broadPhaseFilter, objectLayerFilter, bodyFilter);
+
+        f32 closestDistance = searchRange;
+        outSample = Sample();
+
+        for (const JPH::RayCastResult& hit : collector.mHits)
+        {
+            ConsiderHit(physicsSystem, ray, hit, expectedPosition, closestDistance, outSample);
+        }
+
+        return outSample.hasHit;
+    }
+
+    void GroundRaycastBatch::ExecuteCell(const JPH::PhysicsSystem& physicsSystem, const Cell& cell, CellScratch& scratch)
+    {
+        ZoneScopedN("GroundRaycastBatch::ExecuteCell");
+
+        // One box around every ray in the cell
+        vec3 boundsMin = vec3(std::numeric_limits<f32>::max());
+        vec3 boundsMax = vec3(std::numeric_limits<f32>::lowest());
+        for (u32 i = 0; i < cell.numRays; i++)
+        {
+            const vec3& expectedPosition = _expectedPositions[static_cast<u32>(_sortedRays[cell.firstRay + i])];
+            boundsMin = glm::min(boundsMin, expectedPosition);
+            boundsMax = glm::max(boundsMax, expectedPosition);
+        }
+        boundsMin.y -= _searchRange;
+        boundsMax.y += _searchRange;
+
+        const StaticBroadPhaseFilter broadPhaseFilter;
+        const StaticObjectLayerFilter objectLayerFilter;
+
+        JPH::AllHitCollisionCollector<JPH::CollideShapeBodyCollector>& bodyCollector = scratch.bodyCollector;
+        bodyCollector.Reset();
+        physicsSystem.GetBroadPhaseQuery().CollideAABox(JPH::AABox(JPH::Vec3(boundsMin.x, boundsMin.y, boundsMin.z), JPH::Vec3(boundsMax.x, boundsMax.y, boundsMax.z)), bodyCollector, broadPhaseFilter, objectLayerFilter);
+
+        // The same transformed shapes the narrow phase query would cast against, taken once for the whole cell
+        std::vector<JPH::TransformedShape>& shapes = scratch.shapes;
+        std::vector<JPH::AABox>& shapeBounds = scratch.shapeBounds;
+        shapes.clear();
+        shapeBounds.clear();
+
+        for (const JPH::BodyID& bodyID : bodyCollector.mHits)
+        {
+            JPH::BodyLockRead lock(physicsSystem.GetBodyLockInterface(), bodyID);
+            if (!lock.SucceededAndIsInBroadPhase())
+                continue;
+
+            const JPH::Body& body = lock.GetBody();
+            shapes.push_back(body.GetTransformedShape());
+            shapeBounds.push_back(body.GetWorldSpaceBounds());
+        }
+
+        JPH::AllHitCollisionCollector<JPH::CastRayCollector>& collector = scratch.rayCollector;
+        u32 numShapes = static_cast<u32>(shapes.size());
+
+        for (u32 i = 0; i < cell.numRays; i++)
+        {
+            u32 rayIndex = static_cast<u32>(_sortedRays[cell.firstRay + i]);
+            const vec3& expectedPosition = _expectedPositions[rayIndex];
+            const JPH::RRayCast ray = GetGroundRay(expectedPosition, _searchRange);
+
+            f32 rayMinY = expectedPosition.y - _searchRange;
+            f32 rayMaxY = expectedPosition.y + _searchRange;
+
+            collector.Reset();
+            for (u32 shapeIndex = 0; shapeIndex < numShapes; shapeIndex++)
+            {
+                // The rays are vertical, a column test is all the culling the broad phase would have done for it
+                const JPH::AABox& bounds = shapeBounds[shapeIndex];
+                if (expectedPosition.x < bounds.mMin.GetX() || expectedPosition.x > bounds.mMax.GetX() ||
+                    expectedPosition.z < bounds.mMin.GetZ() || expectedPosition.z > bounds.mMax.GetZ() ||
+                    rayMaxY < bounds.mMin.GetY() || rayMinY > bounds.mMax.GetY())
+                {
+                    continue;
+                }
+
+                shapes[shapeIndex].CastRay(ray, JPH::RayCastSettings(), collector);
+            }
+
+            f32 closestDistance = _searchRange;
+            Sample& sample = _samples[rayIndex];
+
+            for (const JPH::RayCastResult& hit : collector.mHits)
+            {
+                ConsiderHit(physicsSystem, ray, hit, expectedPosition, closestDistance, sample);
+            }
+        }
+    }
+}
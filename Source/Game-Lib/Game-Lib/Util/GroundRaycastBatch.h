@@ -0,0 +1,91 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Geometry/AABox.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/TransformedShape.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuery.h>
+
+#include <vector>
+
+namespace enki
+{
+    class TaskScheduler;
+}
+
+namespace JPH
+{
+    class PhysicsSystem;
+}
+
+namespace Util
+{
+    // Samples the static world below many positions at once. Rays are bucketed into cells on the ground plane and every cell
+    // asks the broad phase for the static bodies around all of its rays once, each ray is then cast against those bodies
+    // directly instead of walking the broad phase tree again. Cells run as enkiTS task ranges when a scheduler is given.
+    // A sample picks the same surface SampleGround does: the hit closest in height to the expected position whose normal
+    // points up, so the batch and the single ray path agree exactly.
+    class GroundRaycastBatch
+    {
+    public:
+        static constexpr f32 CELL_SIZE = 32.0f;
+
+        struct Sample
+        {
+        public:
+            vec3 position = vec3(0.0f);
+            vec3 normal = vec3(0.0f, 1.0f, 0.0f);
+            bool hasHit = false;
+        };
+
+    public:
+        // Rays start searchRange above the expected position and end searchRange below it
+        explicit GroundRaycastBatch(f32 searchRange) : _searchRange(searchRange) { }
+
+        void Clear();
+
+        // Returns the index to read the sample back with once Execute is done
+        u32 Add(const vec3& expectedPosition);
+        u32 GetNumRays() const { return static_cast<u32>(_expectedPositions.size()); }
+
+        void Execute(const JPH::PhysicsSystem& physicsSystem, enki::TaskScheduler* taskScheduler);
+        const Sample& GetSample(u32 index) const { return _samples[index]; }
+
+        // One narrow phase query per ray, what the batch replaces
+        static bool SampleGround(const JPH::PhysicsSystem& physicsSystem, const vec3& expectedPosition, f32 searchRange, Sample& outSample);
+
+    private:
+        struct Cell
+        {
+        public:
+            u32 firstRay = 0;
+            u32 numRays = 0;
+        };
+
+        // What a cell gathers while it runs, one per task thread so the buffers keep their capacity between cells and frames
+        struct CellScratch
+        {
+        public:
+            std::vector<JPH::TransformedShape> shapes;
+            std::vector<JPH::AABox> shapeBounds;
+            JPH::AllHitCollisionCollector<JPH::CollideShapeBodyCollector> bodyCollector;
+            JPH::AllHitCollisionCollector<JPH::CastRayCollector> rayCollector;
+        };
+
+        void ExecuteCell(const JPH::PhysicsSystem& physicsSystem, const Cell& cell, CellScratch& scratch);
+
+    private:
+        f32 _searchRange = 0.0f;
+
+        std::vector<vec3> _expectedPositions;
+        std::vector<Sample> _samples;
+
+        // Ray indices sorted by cell so the rays of a cell are contiguous
+        std::vector<u64> _sortedRays;
+        std::vector<Cell> _cells;
+
+        std::vector<CellScratch> _cellScratch;
+    };
+}
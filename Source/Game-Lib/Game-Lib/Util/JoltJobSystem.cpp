@@ -0,0 +1,141 @@
+#include "JoltJobSystem.h"
+
+#include <Base/Util/DebugHandler.h>
+
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+
+namespace Util
+{
+    JoltEnkiJobSystem::JoltEnkiJobSystem(enki::TaskScheduler* taskScheduler, u32 maxJobs, u32 maxBarriers) : _taskScheduler(taskScheduler)
+    {
+        NC_ASSERT(_taskScheduler, "JoltEnkiJobSystem : Created without a task scheduler");
+
+        JobSystemWithBarrier::Init(maxBarriers);
+        _jobs.Init(maxJobs, maxJobs);
+
+        for (DrainTask& drainTask : _drainTasks)
+        {
+            drainTask.jobSystem = this;
+            drainTask.m_Priority = enki::TASK_PRIORITY_HIGH;
+            drainTask.m_MinRange = 1;
+        }
+    }
+
+    JoltEnkiJobSystem::~JoltEnkiJobSystem()
+    {
+        for (DrainTask& drainTask : _drainTasks)
+        {
+            _taskScheduler->WaitforTask(&drainTask);
+        }
+
+        // Jobs that were queued but never picked up still hold a reference
+        DrainQueue();
+    }
+
+    int JoltEnkiJobSystem::GetMaxConcurrency() const
+    {
+        return static_cast<int>(_taskScheduler->GetNumTaskThreads());
+    }
+
+    JPH::JobHandle JoltEnkiJobSystem::CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies)
+    {
+        ZoneScopedN("JoltEnkiJobSystem::CreateJob");
+
+        u32 index = _jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+        if (index == JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex)
+        {
+            NC_LOG_WARNING("JoltEnkiJobSystem : Ran out of jobs, waiting for one to finish");
+        }
+
+        while (index == JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex)
+        {
+            // Helping out frees up jobs faster than waiting for the workers would
+            DrainQueue();
+            index = _jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+        }
+
+        Job* job = &_jobs.Get(index);
+
+        // The handle keeps the job alive, once queued it may complete before we return
+        JobHandle handle(job);
+
+        if (inNumDependencies == 0)
+            QueueJob(job);
+
+        return handle;
+    }
+
+    void JoltEnkiJobSystem::QueueJob(Job* inJob)
+    {
+        // Released by whoever takes the job out of the queue
+        inJob->AddRef();
+        _queuedJobs.enqueue(inJob);
+
+        LaunchDrainTask(1);
+    }
+
+    void JoltEnkiJobSystem::QueueJobs(Job** inJobs, JPH::uint inNumJobs)
+    {
+        NC_ASSERT(inNumJobs > 0, "JoltEnkiJobSystem : QueueJobs called without any jobs");
+
+        for (JPH::uint i = 0; i < inNumJobs; i++)
+        {
+            inJobs[i]->AddRef();
+        }
+        _queuedJobs.enqueue_bulk(inJobs, inNumJobs);
+
+        LaunchDrainTask(inNumJobs);
+    }
+
+    void JoltEnkiJobSystem::FreeJob(Job* inJob)
+    {
+        _jobs.DestructObject(inJob);
+    }
+
+    void JoltEnkiJobSystem::DrainTask::ExecuteRange(enki::TaskSetPartition range, u32 threadNum)
+    {
+        ZoneScopedN("JoltEnkiJobSystem::DrainTask");
+        jobSystem->DrainQueue();
+    }
+
+    void JoltEnkiJobSystem::LaunchDrainTask(u32 numJobs)
+    {
+        // One partition per job up to one per worker, every partition keeps taking jobs until the queue is empty
+        u32 setSize = std::min(numJobs, std::max(_taskScheduler->GetNumTaskThreads(), 1u));
+        u32 firstDrainTask = _nextDrainTask.fetch_add(1, std::memory_order_relaxed);
+
+        for (u32 i = 0; i < NumDrainTasks; i++)
+        {
+            DrainTask& drainTask = _drainTasks[(firstDrainTask + i) % NumDrainTasks];
+            if (drainTask.isReserved.exchange(true, std::memory_order_acquire))
+                continue;
+
+            if (!drainTask.GetIsComplete())
+            {
+                drainTask.isReserved.store(false, std::memory_order_release);
+                continue;
+            }
+
+            drainTask.m_SetSize = setSize;
+            _taskScheduler->AddTaskSetToPipe(&drainTask);
+
+            drainTask.isReserved.store(false, std::memory_order_release);
+            return;
+        }
+
+        DrainQueue();
+    }
+
+    void JoltEnkiJobSystem::DrainQueue()
+    {
+        Job* job = nullptr;
+        while (_queuedJobs.try_dequeue(job))
+        {
+            // A barrier may have run the job already, Execute does nothing in that case
+            job->Execute();
+            job->Release();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <Base/Types.h>
+#include <Base/Container/ConcurrentQueue.h>
+
+#include <enkiTS/TaskScheduler.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+#include <array>
+#include <atomic>
+
+namespace Util
+{
+    // Runs Jolt's jobs on the enkiTS workers so the physics step shares the one worker pool with the ECS systems and loaders
+    // instead of competing with them from a JobSystemThreadPool of its own.
+    // Jobs whose dependencies are met go into a single queue and each QueueJob(s) call launches a high priority task set that
+    // drains it. Jolt only queues a job once it can run so enkiTS never has to know about the dependencies between them, and
+    // the thread waiting on a barrier executes the barrier's jobs itself like it does with the thread pool.
+    class JoltEnkiJobSystem final : public JPH::JobSystemWithBarrier
+    {
+    public:
+        JoltEnkiJobSystem(enki::TaskScheduler* taskScheduler, u32 maxJobs, u32 maxBarriers);
+        ~JoltEnkiJobSystem() override;
+
+        int GetMaxConcurrency() const override;
+        JobHandle CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies = 0) override;
+
+    protected:
+        void QueueJob(Job* inJob) override;
+        void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+        void FreeJob(Job* inJob) override;
+
+    private:
+        struct DrainTask : public enki::ITaskSet
+        {
+        public:
+            void ExecuteRange(enki::TaskSetPartition range, u32 threadNum) override;
+
+            JoltEnkiJobSystem* jobSystem = nullptr;
+            std::atomic<bool> isReserved = false;
+        };
+
+        void LaunchDrainTask(u32 numJobs);
+        void DrainQueue();
+
+    private:
+        // A physics step queues most of its jobs one at a time as their dependencies finish, a drain task that is still running
+        // usually picks those up too. When every slot is still busy the queuing thread drains the queue itself.
+        static constexpr u32 NumDrainTasks = 64;
+
+        enki::TaskScheduler* _taskScheduler = nullptr;
+        JPH::FixedSizeFreeList<Job> _jobs;
+        moodycamel::ConcurrentQueue<Job*> _queuedJobs;
+
+        std::array<DrainTask, NumDrainTasks> _drainTasks;
+        std::atomic<u32> _nextDrainTask = 0;
+    };
+}
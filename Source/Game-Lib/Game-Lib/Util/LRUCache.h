@@ -0,0 +1,172 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <robinhood/robinhood.h>
+
+#include <list>
+#include <utility>
+
+namespace Util
+{
+    // Least recently used cache with a byte budget instead of an entry count. Every entry is put in with the number of bytes
+    // it keeps alive, and the least recently used entries are evicted until the total fits the budget again.
+    // Not thread safe, the owner is expected to touch it from one thread.
+    template <typename Key, typename Value>
+    class LRUCache
+    {
+    public:
+        struct Stats
+        {
+        public:
+            u64 numHits = 0;
+            u64 numMisses = 0;
+            u64 numEvictions = 0;
+
+            u32 numEntries = 0;
+            u64 numBytes = 0;
+            u64 budgetBytes = 0;
+
+            f32 GetHitRate() const
+            {
+                u64 numLookups = numHits + numMisses;
+                return numLookups > 0 ? static_cast<f32>(numHits) / static_cast<f32>(numLookups) : 0.0f;
+            }
+        };
+
+    public:
+        explicit LRUCache(u64 budgetBytes = 0) : _budgetBytes(budgetBytes) { }
+
+        // Returns the entry and marks it as the most recently used one, nullptr on a miss
+        Value* Get(const Key& key)
+        {
+            auto itr = _keyToEntry.find(key);
+            if (itr == _keyToEntry.end())
+            {
+                _numMisses++;
+                return nullptr;
+            }
+
+            _numHits++;
+            _entries.splice(_entries.begin(), _entries, itr->second);
+            return &itr->second->value;
+        }
+
+        // Looks at an entry without counting a lookup or changing its place in the order
+        const Value* Peek(const Key& key) const
+        {
+            auto itr = _keyToEntry.find(key);
+            return itr != _keyToEntry.end() ? &itr->second->value : nullptr;
+        }
+
+        bool Contains(const Key& key) const { return _keyToEntry.contains(key); }
+
+        // Replaces an existing entry with the same key. Returns false without storing anything if the entry alone is over budget
+        bool Put(const Key& key, Value&& value, u64 numBytes)
+        {
+            Remove(key);
+
+            if (numBytes > _budgetBytes)
+                return false;
+
+            _entries.push_front({ key, std::move(value), numBytes });
+            _keyToEntry[key] = _entries.begin();
+            _numBytes += numBytes;
+
+            EvictToBudget();
+            return true;
+        }
+
+        bool Remove(const Key& key)
+        {
+            auto itr = _keyToEntry.find(key);
+            if (itr == _keyToEntry.end())
+                return false;
+
+            _numBytes -= itr->second->numBytes;
+            _entries.erase(itr->second);
+            _keyToEntry.erase(itr);
+
+            return true;
+        }
+
+        void SetBudget(u64 budgetBytes)
+        {
+            _budgetBytes = budgetBytes;
+            EvictToBudget();
+        }
+
+        void Clear()
+        {
+            _entries.clear();
+            _keyToEntry.clear();
+            _numBytes = 0;
+        }
+
+        void ResetStats()
+        {
+            _numHits = 0;
+            _numMisses = 0;
+            _numEvictions = 0;
+        }
+
+        Stats GetStats() const
+        {
+            Stats stats;
+            stats.numHits = _numHits;
+            stats.numMisses = _numMisses;
+            stats.numEvictions = _numEvictions;
+            stats.numEntries = static_cast<u32>(_entries.size());
+            stats.numBytes = _numBytes;
+            stats.budgetBytes = _budgetBytes;
+
+            return stats;
+        }
+
+        u32 GetNumEntries() const { return static_cast<u32>(_entries.size()); }
+        u64 GetNumBytes() const { return _numBytes; }
+        u64 GetBudget() const { return _budgetBytes; }
+
+        // Calls callback(key, value) from the most to the least recently used entry without touching the order
+        template <typename Callback>
+        void ForEach(Callback&& callback) const
+        {
+            for (const Entry& entry : _entries)
+            {
+                callback(entry.key, entry.value);
+            }
+        }
+
+    private:
+        struct Entry
+        {
+        public:
+            Key key;
+            Value value;
+            u64 numBytes = 0;
+        };
+
+        void EvictToBudget()
+        {
+            while (_numBytes > _budgetBytes && !_entries.empty())
+            {
+                Entry& entry = _entries.back();
+                _numBytes -= entry.numBytes;
+                _keyToEntry.erase(entry.key);
+                _entries.pop_back();
+
+                _numEvictions++;
+            }
+        }
+
+    private:
+        std::list<Entry> _entries; // Most recently used first
+        robin_hood::unordered_map<Key, typename std::list<Entry>::iterator> _keyToEntry;
+
+        u64 _budgetBytes = 0;
+        u64 _numBytes = 0;
+
+        u64 _numHits = 0;
+        u64 _numMisses = 0;
+        u64 _numEvictions = 0;
+    };
+}
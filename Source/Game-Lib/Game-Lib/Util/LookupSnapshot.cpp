@@ -0,0 +1,150 @@
+#include "LookupSnapshot.h"
+
+#include <Base/Util/DebugHandler.h>
+
+#include <xxhash/xxhash64.h>
+
+#include <fstream>
+
+namespace Util::LookupSnapshot
+{
+    static constexpr u64 SECTION_ALIGNMENT = 8;
+
+    u64 CombineHash(u64 hash, u64 value)
+    {
+        u64 values[2] = { hash, value };
+        return XXHash64::hash(values, sizeof(values), 0);
+    }
+
+    void Writer::AddSection(u32 sectionID, u32 elementSize, const void* data, size_t size)
+    {
+        SectionHeader& section = _sections.emplace_back();
+        section.id = sectionID;
+        section.elementSize = elementSize;
+        section.offset = _payload.size();
+        section.size = size;
+
+        size_t alignedSize = (size + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+        _payload.resize(_payload.size() + alignedSize, 0);
+
+        if (size > 0)
+        {
+            memcpy(_payload.data() + section.offset, data, size);
+        }
+    }
+
+    bool Writer::Save(const std::filesystem::path& path) const
+    {
+        FileHeader header;
+        header.schemaVersion = _schemaVersion;
+        header.numSections = static_cast<u32>(_sections.size());
+        header.sourceHash = _sourceHash;
+        header.payloadHash = XXHash64::hash(_payload.data(), _payload.size(), 0);
+
+        std::error_code errorCode;
+        std::filesystem::create_directories(path.parent_path(), errorCode);
+
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += ".tmp";
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                NC_LOG_WARNING("LookupSnapshot : Failed to open '{0}' for writing", temporaryPath.string());
+                return false;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(_sections.data()), _sections.size() * sizeof(SectionHeader));
+            file.write(reinterpret_cast<const char*>(_payload.data()), _payload.size());
+
+            if (!file)
+            {
+                NC_LOG_WARNING("LookupSnapshot : Failed to write '{0}'", temporaryPath.string());
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, errorCode);
+        if (errorCode)
+        {
+            NC_LOG_WARNING("LookupSnapshot : Failed to replace '{0}' ({1})", path.string(), errorCode.message());
+            std::filesystem::remove(temporaryPath, errorCode);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool Reader::Load(const std::filesystem::path& path, u32 schemaVersion, u64 sourceHash)
+    {
+        _file.clear();
+        _payload = nullptr;
+        _payloadSize = 0;
+        _sections = {};
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+
+        u64 fileSize = static_cast<u64>(file.tellg());
+        if (fileSize < sizeof(FileHeader))
+            return false;
+
+        _file.resize((fileSize + sizeof(u64) - 1) / sizeof(u64));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(_file.data()), fileSize))
+            return false;
+
+        const u8* fileData = reinterpret_cast<const u8*>(_file.data());
+
+        FileHeader header;
+        memcpy(&header, fileData, sizeof(header));
+
+        if (header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.schemaVersion != schemaVersion || header.sourceHash != sourceHash)
+            return false;
+
+        u64 sectionsSize = static_cast<u64>(header.numSections) * sizeof(SectionHeader);
+        if (sizeof(FileHeader) + sectionsSize > fileSize)
+            return false;
+
+        const u8* payload = fileData + sizeof(FileHeader) + sectionsSize;
+        u64 payloadSize = fileSize - sizeof(FileHeader) - sectionsSize;
+        if (XXHash64::hash(payload, payloadSize, 0) != header.payloadHash)
+        {
+            NC_LOG_WARNING("LookupSnapshot : '{0}' is corrupt, ignoring it", path.string());
+            return false;
+        }
+
+        std::span<const SectionHeader> sections(reinterpret_cast<const SectionHeader*>(fileData + sizeof(FileHeader)), header.numSections);
+        for (const SectionHeader& section : sections)
+        {
+            if (section.offset > payloadSize || section.size > payloadSize - section.offset)
+                return false;
+        }
+
+        _payload = payload;
+        _payloadSize = payloadSize;
+        _sections = sections;
+        return true;
+    }
+
+    bool Reader::GetSection(u32 sectionID, u32 elementSize, const void*& data, u64& size) const
+    {
+        for (const SectionHeader& section : _sections)
+        {
+            if (section.id != sectionID)
+                continue;
+
+            if (section.elementSize != elementSize)
+                return false;
+
+            data = _payload + section.offset;
+            size = section.size;
+            return true;
+        }
+
+        return false;
+    }
+}
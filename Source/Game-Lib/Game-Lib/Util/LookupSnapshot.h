@@ -0,0 +1,250 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <robinhood/robinhood.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Util
+{
+    // Binary cache for lookup tables derived from ClientDBs so they don't have to be rebuilt on every boot.
+    // A snapshot is only accepted if its schema version and the hash of the sources it was built from both match,
+    // and the payload hash catches truncated or corrupted files.
+    namespace LookupSnapshot
+    {
+        static constexpr u32 FILE_MAGIC = 0x5350534C; // LSPS
+        static constexpr u32 FILE_VERSION = 2;
+
+        // The values of a list map live in their own section next to the keys and counts
+        static constexpr u32 LIST_VALUES_SECTION_BIT = 0x80000000;
+
+        struct FileHeader
+        {
+        public:
+            u32 magic = FILE_MAGIC;
+            u32 version = FILE_VERSION;
+            u32 schemaVersion = 0;
+            u32 numSections = 0;
+            u64 sourceHash = 0;
+            u64 payloadHash = 0;
+        };
+
+        struct SectionHeader
+        {
+        public:
+            u32 id = 0;
+            u32 elementSize = 0;
+            u64 offset = 0; // From the start of the payload
+            u64 size = 0;
+        };
+
+        u64 CombineHash(u64 hash, u64 value);
+
+        // Keys and values must not have padding, otherwise the same lookups could produce different files
+        template <typename T>
+        concept SnapshotElement = std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>;
+
+        class Writer
+        {
+        public:
+            Writer(u32 schemaVersion, u64 sourceHash) : _schemaVersion(schemaVersion), _sourceHash(sourceHash) { }
+
+            template <typename T>
+            void AddArray(u32 sectionID, std::span<const T> elements)
+            {
+                static_assert(std::is_trivially_copyable_v<T>, "LookupSnapshot sections must be trivially copyable");
+                AddSection(sectionID, sizeof(T), elements.data(), elements.size_bytes());
+            }
+
+            // Maps and sets are stored sorted by key so the same sources always produce the same file
+            template <SnapshotElement Key, SnapshotElement Value>
+            void AddMap(u32 sectionID, const robin_hood::unordered_map<Key, Value>& map)
+            {
+                std::vector<Key> keys = GetSortedKeys(map);
+
+                // All keys followed by all values, so neither side needs padding
+                std::vector<u8> data(keys.size() * (sizeof(Key) + sizeof(Value)));
+                u8* values = data.data() + (keys.size() * sizeof(Key));
+                for (size_t i = 0; i < keys.size(); i++)
+                {
+                    memcpy(data.data() + (i * sizeof(Key)), &keys[i], sizeof(Key));
+                    memcpy(values + (i * sizeof(Value)), &map.at(keys[i]), sizeof(Value));
+                }
+
+                AddSection(sectionID, sizeof(Key) + sizeof(Value), data.data(), data.size());
+            }
+
+            template <SnapshotElement Key>
+            void AddSet(u32 sectionID, const robin_hood::unordered_set<Key>& set)
+            {
+                std::vector<Key> values(set.begin(), set.end());
+                std::sort(values.begin(), values.end());
+
+                AddArray<Key>(sectionID, values);
+            }
+
+            // Lists keep their order, only the keys are sorted
+            template <SnapshotElement Key, SnapshotElement Value>
+            void AddListMap(u32 sectionID, const robin_hood::unordered_map<Key, std::vector<Value>>& map)
+            {
+                std::vector<Key> keys = GetSortedKeys(map);
+
+                std::vector<u8> data(keys.size() * (sizeof(Key) + sizeof(u32)));
+                u8* counts = data.data() + (keys.size() * sizeof(Key));
+                std::vector<Value> values;
+                for (size_t i = 0; i < keys.size(); i++)
+                {
+                    const std::vector<Value>& list = map.at(keys[i]);
+                    u32 count = static_cast<u32>(list.size());
+
+                    memcpy(data.data() + (i * sizeof(Key)), &keys[i], sizeof(Key));
+                    memcpy(counts + (i * sizeof(u32)), &count, sizeof(u32));
+                    values.insert(values.end(), list.begin(), list.end());
+                }
+
+                AddSection(sectionID, sizeof(Key) + sizeof(u32), data.data(), data.size());
+                AddArray<Value>(sectionID | LIST_VALUES_SECTION_BIT, values);
+            }
+
+            // Writes to a temporary file first so a crash mid write never leaves a snapshot that looks valid
+            bool Save(const std::filesystem::path& path) const;
+
+        private:
+            template <typename Key, typename Value>
+            static std::vector<Key> GetSortedKeys(const robin_hood::unordered_map<Key, Value>& map)
+            {
+                std::vector<Key> keys;
+                keys.reserve(map.size());
+                for (const auto& pair : map)
+                {
+                    keys.push_back(pair.first);
+                }
+
+                std::sort(keys.begin(), keys.end());
+                return keys;
+            }
+
+            void AddSection(u32 sectionID, u32 elementSize, const void* data, size_t size);
+
+        private:
+            u32 _schemaVersion = 0;
+            u64 _sourceHash = 0;
+
+            std::vector<SectionHeader> _sections;
+            std::vector<u8> _payload;
+        };
+
+        class Reader
+        {
+        public:
+            // The whole file is read with a single read and sections are used in place from that buffer
+            bool Load(const std::filesystem::path& path, u32 schemaVersion, u64 sourceHash);
+
+            template <typename T>
+            bool GetArray(u32 sectionID, std::span<const T>& elements) const
+            {
+                static_assert(std::is_trivially_copyable_v<T>, "LookupSnapshot sections must be trivially copyable");
+
+                const void* data = nullptr;
+                u64 size = 0;
+                if (!GetSection(sectionID, sizeof(T), data, size))
+                    return false;
+
+                elements = std::span<const T>(static_cast<const T*>(data), static_cast<size_t>(size / sizeof(T)));
+                return true;
+            }
+
+            template <SnapshotElement Key, SnapshotElement Value>
+            bool ReadMap(u32 sectionID, robin_hood::unordered_map<Key, Value>& map) const
+            {
+                const void* data = nullptr;
+                u64 size = 0;
+                if (!GetSection(sectionID, sizeof(Key) + sizeof(Value), data, size))
+                    return false;
+
+                const u8* keys = static_cast<const u8*>(data);
+                u64 numEntries = size / (sizeof(Key) + sizeof(Value));
+                const u8* values = keys + (numEntries * sizeof(Key));
+
+                map.clear();
+                map.reserve(static_cast<size_t>(numEntries));
+                for (u64 i = 0; i < numEntries; i++)
+                {
+                    Key key;
+                    Value value;
+                    memcpy(&key, keys + (i * sizeof(Key)), sizeof(Key));
+                    memcpy(&value, values + (i * sizeof(Value)), sizeof(Value));
+
+                    map[key] = value;
+                }
+
+                return true;
+            }
+
+            template <SnapshotElement Key>
+            bool ReadSet(u32 sectionID, robin_hood::unordered_set<Key>& set) const
+            {
+                std::span<const Key> values;
+                if (!GetArray(sectionID, values))
+                    return false;
+
+                set.clear();
+                set.reserve(values.size());
+                set.insert(values.begin(), values.end());
+                return true;
+            }
+
+            template <SnapshotElement Key, SnapshotElement Value>
+            bool ReadListMap(u32 sectionID, robin_hood::unordered_map<Key, std::vector<Value>>& map) const
+            {
+                const void* data = nullptr;
+                u64 size = 0;
+                std::span<const Value> values;
+                if (!GetSection(sectionID, sizeof(Key) + sizeof(u32), data, size) || !GetArray(sectionID | LIST_VALUES_SECTION_BIT, values))
+                    return false;
+
+                const u8* keys = static_cast<const u8*>(data);
+                u64 numEntries = size / (sizeof(Key) + sizeof(u32));
+                const u8* counts = keys + (numEntries * sizeof(Key));
+
+                map.clear();
+                map.reserve(static_cast<size_t>(numEntries));
+
+                u64 valueIndex = 0;
+                for (u64 i = 0; i < numEntries; i++)
+                {
+                    Key key;
+                    u32 count;
+                    memcpy(&key, keys + (i * sizeof(Key)), sizeof(Key));
+                    memcpy(&count, counts + (i * sizeof(u32)), sizeof(u32));
+
+                    if (count > values.size() - valueIndex)
+                    {
+                        map.clear();
+                        return false;
+                    }
+
+                    map[key].assign(values.begin() + valueIndex, values.begin() + valueIndex + count);
+                    valueIndex += count;
+                }
+
+                return true;
+            }
+
+        private:
+            bool GetSection(u32 sectionID, u32 elementSize, const void*& data, u64& size) const;
+
+        private:
+            // u64 storage keeps every section 8 byte aligned
+            std::vector<u64> _file;
+            const u8* _payload = nullptr;
+            u64 _payloadSize = 0;
+            std::span<const SectionHeader> _sections;
+        };
+    }
+}
@@ -0,0 +1,152 @@
+#include "PhysicsBodyBatcher.h"
+
+#include <FileFormat/Shared.h>
+
+#include <Jolt/Physics/Body/BodyInterface.h>
+
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+
+namespace Util
+{
+    static u32 SpreadBits(u32 value)
+    {
+        value &= 0x0000FFFF;
+        value = (value | (value << 8)) & 0x00FF00FF;
+        value = (value | (value << 4)) & 0x0F0F0F0F;
+        value = (value | (value << 2)) & 0x33333333;
+        value = (value | (value << 1)) & 0x55555555;
+        return value;
+    }
+
+    void PhysicsBodyBatcher::QueueAdd(JPH::BodyID bodyID, const vec3& position)
+    {
+        std::scoped_lock lock(_mutex);
+        _pendingAdds.push_back({ bodyID, GetMortonCode(position) });
+    }
+
+    void PhysicsBodyBatcher::QueueRemove(JPH::BodyID bodyID)
+    {
+        std::scoped_lock lock(_mutex);
+        _pendingRemoves.push_back(bodyID);
+    }
+
+    PhysicsBodyBatcher::FlushStats PhysicsBodyBatcher::Flush(JPH::BodyInterface& bodyInterface, JPH::EActivation activation, u32 maxBatchSize)
+    {
+        {
+            std::scoped_lock lock(_mutex);
+            std::swap(_pendingAdds, _flushAdds);
+            std::swap(_pendingRemoves, _flushRemoves);
+        }
+
+        FlushStats stats;
+        if (_flushAdds.empty() && _flushRemoves.empty())
+            return stats;
+
+        ZoneScopedN("PhysicsBodyBatcher::Flush");
+
+        // Bodies loaded and unloaded before they got the chance to be added only need destroying
+        if (!_flushAdds.empty() && !_flushRemoves.empty())
+        {
+            std::sort(_flushRemoves.begin(), _flushRemoves.end());
+
+            _flushBodyIDs.clear();
+            std::erase_if(_flushAdds, [&](const PendingAdd& pendingAdd)
+            {
+                if (!std::binary_search(_flushRemoves.begin(), _flushRemoves.end(), pendingAdd.bodyID))
+                    return false;
+
+                _flushBodyIDs.push_back(pendingAdd.bodyID);
+                return true;
+            });
+
+            if (!_flushBodyIDs.empty())
+            {
+                std::sort(_flushBodyIDs.begin(), _flushBodyIDs.end());
+                std::erase_if(_flushRemoves, [&](JPH::BodyID bodyID) { return std::binary_search(_flushBodyIDs.begin(), _flushBodyIDs.end(), bodyID); });
+
+                bodyInterface.DestroyBodies(_flushBodyIDs.data(), static_cast<i32>(_flushBodyIDs.size()));
+            }
+        }
+
+        stats.numRemoved = static_cast<u32>(_flushRemoves.size());
+        if (!_flushRemoves.empty())
+        {
+            ZoneScopedN("Remove Bodies");
+
+            if (maxBatchSize == 0)
+            {
+                for (JPH::BodyID bodyID : _flushRemoves)
+                {
+                    bodyInterface.RemoveBody(bodyID);
+                    bodyInterface.DestroyBody(bodyID);
+                }
+            }
+            else
+            {
+                bodyInterface.RemoveBodies(_flushRemoves.data(), static_cast<i32>(_flushRemoves.size()));
+                bodyInterface.DestroyBodies(_flushRemoves.data(), static_cast<i32>(_flushRemoves.size()));
+            }
+
+            _flushRemoves.clear();
+        }
+
+        stats.numAdded = static_cast<u32>(_flushAdds.size());
+        if (!_flushAdds.empty())
+        {
+            ZoneScopedN("Add Bodies");
+
+            if (maxBatchSize == 0)
+            {
+                for (const PendingAdd& pendingAdd : _flushAdds)
+                {
+                    bodyInterface.AddBody(pendingAdd.bodyID, activation);
+                }
+
+                stats.numBatches = stats.numAdded;
+            }
+            else
+            {
+                std::sort(_flushAdds.begin(), _flushAdds.end(), [](const PendingAdd& lhs, const PendingAdd& rhs) { return lhs.mortonCode < rhs.mortonCode; });
+
+                for (size_t batchStart = 0; batchStart < _flushAdds.size(); batchStart += maxBatchSize)
+                {
+                    size_t batchEnd = std::min(batchStart + maxBatchSize, _flushAdds.size());
+
+                    _flushBodyIDs.clear();
+                    for (size_t i = batchStart; i < batchEnd; i++)
+                    {
+                        _flushBodyIDs.push_back(_flushAdds[i].bodyID);
+                    }
+
+                    i32 numBodies = static_cast<i32>(_flushBodyIDs.size());
+                    JPH::BodyInterface::AddState addState = bodyInterface.AddBodiesPrepare(_flushBodyIDs.data(), numBodies);
+                    bodyInterface.AddBodiesFinalize(_flushBodyIDs.data(), numBodies, addState, activation);
+
+                    stats.numBatches++;
+                }
+            }
+
+            _flushAdds.clear();
+        }
+
+        return stats;
+    }
+
+    bool PhysicsBodyBatcher::HasPendingWork()
+    {
+        std::scoped_lock lock(_mutex);
+        return !_pendingAdds.empty() || !_pendingRemoves.empty();
+    }
+
+    u32 PhysicsBodyBatcher::GetMortonCode(const vec3& position)
+    {
+        static constexpr f32 MaxCoordinate = 65535.0f;
+
+        vec2 normalized = (vec2(position.x, position.z) + Terrain::MAP_HALF_SIZE) / (Terrain::MAP_HALF_SIZE * 2.0f);
+        vec2 quantized = glm::clamp(normalized, vec2(0.0f), vec2(1.0f)) * MaxCoordinate;
+
+        return SpreadBits(static_cast<u32>(quantized.x)) | (SpreadBits(static_cast<u32>(quantized.y)) << 1);
+    }
+}
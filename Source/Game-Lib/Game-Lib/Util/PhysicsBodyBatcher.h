@@ -0,0 +1,69 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <Jolt/Physics/EActivation.h>
+
+#include <mutex>
+#include <vector>
+
+namespace JPH
+{
+    class BodyInterface;
+}
+
+namespace Util
+{
+    // Collects bodies created while loading and hands them to the broad phase in one go per frame instead of one AddBody each.
+    // Bodies are sorted along a Morton curve over the map before being split into batches, AddBodiesPrepare builds a tree per
+    // batch so nearby bodies share a subtree rather than being inserted into the existing tree one by one.
+    // QueueAdd and QueueRemove can be called from any thread, Flush only from one.
+    class PhysicsBodyBatcher
+    {
+    public:
+        static constexpr u32 DEFAULT_MAX_BATCH_SIZE = 1024;
+
+        struct FlushStats
+        {
+        public:
+            u32 numAdded = 0;
+            u32 numRemoved = 0;
+            u32 numBatches = 0;
+        };
+
+    public:
+        // bodyID must be created but not yet added
+        void QueueAdd(JPH::BodyID bodyID, const vec3& position);
+
+        // Removes and destroys the body on the next Flush, bodies still waiting to be added are destroyed without ever
+        // reaching the broad phase
+        void QueueRemove(JPH::BodyID bodyID);
+
+        // maxBatchSize 0 adds and removes every body on its own, the way they were before batching
+        FlushStats Flush(JPH::BodyInterface& bodyInterface, JPH::EActivation activation, u32 maxBatchSize = DEFAULT_MAX_BATCH_SIZE);
+
+        bool HasPendingWork();
+
+        // 16 bits per horizontal axis over the whole map, positions outside of it are clamped to its edge
+        static u32 GetMortonCode(const vec3& position);
+
+    private:
+        struct PendingAdd
+        {
+        public:
+            JPH::BodyID bodyID;
+            u32 mortonCode = 0;
+        };
+
+    private:
+        std::mutex _mutex;
+        std::vector<PendingAdd> _pendingAdds;
+        std::vector<JPH::BodyID> _pendingRemoves;
+
+        // Only touched by Flush, swapped with the pending lists so queuing can continue while a flush runs
+        std::vector<PendingAdd> _flushAdds;
+        std::vector<JPH::BodyID> _flushRemoves;
+        std::vector<JPH::BodyID> _flushBodyIDs;
+    };
+}
@@ -0,0 +1,79 @@
+#include "RangeAllocator.h"
+
+#include <Base/Util/DebugHandler.h>
+
+#include <algorithm>
+
+namespace Util
+{
+    bool RangeAllocator::Allocate(u32 count, u32& outOffset)
+    {
+        if (count == 0)
+            return false;
+
+        for (auto itr = _freeRanges.begin(); itr != _freeRanges.end(); itr++)
+        {
+            if (itr->count < count)
+                continue;
+
+            outOffset = itr->offset;
+            _numFreeElements -= count;
+
+            if (itr->count == count)
+            {
+                _freeRanges.erase(itr);
+            }
+            else
+            {
+                itr->offset += count;
+                itr->count -= count;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    void RangeAllocator::Free(u32 offset, u32 count)
+    {
+        if (count == 0)
+            return;
+
+        auto next = std::lower_bound(_freeRanges.begin(), _freeRanges.end(), offset, [](const Range& range, u32 offset) { return range.offset < offset; });
+
+        NC_ASSERT(next == _freeRanges.end() || offset + count <= next->offset, "RangeAllocator : Freed a range that overlaps a free range");
+        NC_ASSERT(next == _freeRanges.begin() || std::prev(next)->offset + std::prev(next)->count <= offset, "RangeAllocator : Freed a range that overlaps a free range");
+
+        _numFreeElements += count;
+
+        bool mergesWithPrevious = next != _freeRanges.begin() && std::prev(next)->offset + std::prev(next)->count == offset;
+        bool mergesWithNext = next != _freeRanges.end() && offset + count == next->offset;
+
+        if (mergesWithPrevious && mergesWithNext)
+        {
+            auto previous = std::prev(next);
+            previous->count += count + next->count;
+            _freeRanges.erase(next);
+        }
+        else if (mergesWithPrevious)
+        {
+            std::prev(next)->count += count;
+        }
+        else if (mergesWithNext)
+        {
+            next->offset = offset;
+            next->count += count;
+        }
+        else
+        {
+            _freeRanges.insert(next, { offset, count });
+        }
+    }
+
+    void RangeAllocator::Clear()
+    {
+        _freeRanges.clear();
+        _numFreeElements = 0;
+    }
+}
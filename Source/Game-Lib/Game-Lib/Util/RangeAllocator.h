@@ -0,0 +1,35 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <vector>
+
+namespace Util
+{
+    // Hands out ranges of a buffer that only ever grows at the end, like a GPUVector filled through AddCount. Freed ranges
+    // are kept sorted by offset and merged with their neighbours, Allocate takes the first one that fits and leaves the
+    // rest of it free. When nothing fits it returns false and the owner grows the buffer instead.
+    // Not thread safe, the owner is expected to touch it from one thread.
+    class RangeAllocator
+    {
+    public:
+        struct Range
+        {
+        public:
+            u32 offset = 0;
+            u32 count = 0;
+        };
+
+    public:
+        bool Allocate(u32 count, u32& outOffset);
+        void Free(u32 offset, u32 count);
+        void Clear();
+
+        u32 GetNumFreeRanges() const { return static_cast<u32>(_freeRanges.size()); }
+        u64 GetNumFreeElements() const { return _numFreeElements; }
+        const std::vector<Range>& GetFreeRanges() const { return _freeRanges; }
+
+    private:
+        std::vector<Range> _freeRanges;
+        u64 _numFreeElements = 0;
+    };
+}
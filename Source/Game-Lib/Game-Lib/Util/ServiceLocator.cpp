@@ -6,6 +6,7 @@ Editor::EditorHandler* ServiceLocator::_editorHandler = nullptr;
 InputSystem* ServiceLocator::_inputSystem = nullptr;
 InputActionSystem* ServiceLocator::_inputActionSystem = nullptr;
 GameRenderer* ServiceLocator::_gameRenderer = nullptr;
+ModelLoader* ServiceLocator::_modelLoader = nullptr;
 enki::TaskScheduler* ServiceLocator::_taskScheduler = nullptr;
 EnttRegistries* ServiceLocator::_enttRegistries = nullptr;
 GameConsole* ServiceLocator::_gameConsole = nullptr;
@@ -48,6 +49,12 @@ void ServiceLocator::SetGameRenderer(GameRenderer* gameRenderer)
     _gameRenderer = gameRenderer;
 }
 
+void ServiceLocator::SetModelLoader(ModelLoader* modelLoader)
+{
+    assert(_modelLoader == nullptr);
+    _modelLoader = modelLoader;
+}
+
 void ServiceLocator::SetTaskScheduler(enki::TaskScheduler* taskScheduler)
 {
     assert(_taskScheduler == nullptr);
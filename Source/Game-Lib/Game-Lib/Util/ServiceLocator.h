@@ -15,6 +15,7 @@ namespace Editor
 class InputActionSystem;
 class InputSystem;
 class GameRenderer;
+class ModelLoader;
 
 namespace enki
 {
@@ -80,6 +81,13 @@ public:
     }
     static void SetGameRenderer(GameRenderer* gameRenderer);
 
+    static ModelLoader* GetModelLoader()
+    {
+        assert(_modelLoader != nullptr);
+        return _modelLoader;
+    }
+    static void SetModelLoader(ModelLoader* modelLoader);
+
     static enki::TaskScheduler* GetTaskScheduler()
     {
         assert(_taskScheduler != nullptr);
@@ -123,6 +131,7 @@ private:
     static InputSystem* _inputSystem;
     static InputActionSystem* _inputActionSystem;
     static GameRenderer* _gameRenderer;
+    static ModelLoader* _modelLoader;
     static enki::TaskScheduler* _taskScheduler;
     static EnttRegistries* _enttRegistries;
     static GameConsole* _gameConsole;
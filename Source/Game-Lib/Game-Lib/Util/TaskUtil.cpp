@@ -0,0 +1,27 @@
+#include "TaskUtil.h"
+
+#include <enkiTS/TaskScheduler.h>
+
+namespace Util::Task
+{
+    void ForEachRange(enki::TaskScheduler* taskScheduler, u32 count, u32 minRange, const std::function<void(u32 begin, u32 end)>& processRange)
+    {
+        if (count == 0)
+            return;
+
+        if (!taskScheduler || count <= minRange)
+        {
+            processRange(0, count);
+            return;
+        }
+
+        enki::TaskSet rangeTask(count, [&processRange](enki::TaskSetPartition range, u32 threadNum)
+        {
+            processRange(range.start, range.end);
+        });
+        rangeTask.m_MinRange = minRange;
+
+        taskScheduler->AddTaskSetToPipe(&rangeTask);
+        taskScheduler->WaitforTask(&rangeTask);
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <functional>
+
+namespace enki
+{
+    class TaskScheduler;
+}
+
+namespace Util::Task
+{
+    // Calls processRange over [0, count) split into enkiTS task ranges of at least minRange items and waits for all of them.
+    // Runs everything as one range on the calling thread when there is no scheduler or count doesn't exceed minRange,
+    // since below that the task set costs more than it saves
+    void ForEachRange(enki::TaskScheduler* taskScheduler, u32 count, u32 minRange, const std::function<void(u32 begin, u32 end)>& processRange);
+}
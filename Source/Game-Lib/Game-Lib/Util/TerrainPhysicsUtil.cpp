@@ -0,0 +1,250 @@
+#include "TerrainPhysicsUtil.h"
+#include "Game-Lib/Util/MapUtil.h"
+
+#include <FileFormat/Novus/Map/MapChunk.h>
+
+#include <Jolt/Geometry/Triangle.h>
+#include <Jolt/Geometry/IndexedTriangle.h>
+#include <Jolt/Physics/Collision/Shape/HeightFieldShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+
+#include <robinhood/robinhood.h>
+#include <tracy/Tracy.hpp>
+
+#include <array>
+#include <mutex>
+
+namespace Util
+{
+    namespace TerrainPhysics
+    {
+        static constexpr u32 HEIGHT_FIELD_BLOCK_SIZE = 4;
+        static constexpr f32 HEIGHT_FIELD_MAX_HEIGHT_ERROR = 0.01f;
+
+        // gx, gy are patch corner coordinates across the whole chunk in the range [0, 128]
+        static f32 GetOuterVertexHeight(const ::Map::Chunk& chunk, u32 gx, u32 gy)
+        {
+            u32 cellX = glm::min(gx / Terrain::CELL_NUM_PATCHES_PER_STRIDE, Terrain::CHUNK_NUM_CELLS_PER_STRIDE - 1);
+            u32 cellY = glm::min(gy / Terrain::CELL_NUM_PATCHES_PER_STRIDE, Terrain::CHUNK_NUM_CELLS_PER_STRIDE - 1);
+            u32 vertexX = gx - (cellX * Terrain::CELL_NUM_PATCHES_PER_STRIDE);
+            u32 vertexY = gy - (cellY * Terrain::CELL_NUM_PATCHES_PER_STRIDE);
+
+            u32 cellID = cellX + (cellY * Terrain::CHUNK_NUM_CELLS_PER_STRIDE);
+            u32 vertexID = vertexX + (vertexY * Terrain::CELL_GRID_ROW_SIZE);
+            return chunk.cellsData.heightField[cellID][vertexID];
+        }
+
+        // px, py are patch coordinates across the whole chunk in the range [0, 128)
+        static f32 GetCenterVertexHeight(const ::Map::Chunk& chunk, u32 px, u32 py)
+        {
+            u32 cellX = px / Terrain::CELL_NUM_PATCHES_PER_STRIDE;
+            u32 cellY = py / Terrain::CELL_NUM_PATCHES_PER_STRIDE;
+            u32 vertexX = px - (cellX * Terrain::CELL_NUM_PATCHES_PER_STRIDE);
+            u32 vertexY = py - (cellY * Terrain::CELL_NUM_PATCHES_PER_STRIDE);
+
+            u32 cellID = cellX + (cellY * Terrain::CHUNK_NUM_CELLS_PER_STRIDE);
+            u32 vertexID = vertexX + (vertexY * Terrain::CELL_GRID_ROW_SIZE) + Terrain::CELL_OUTER_GRID_STRIDE;
+            return chunk.cellsData.heightField[cellID][vertexID];
+        }
+
+        const TerrainPhysicsMaterial* GetLayerMaterial(u64 layerTextureID)
+        {
+            static std::mutex mutex;
+            static robin_hood::unordered_map<u64, JPH::RefConst<TerrainPhysicsMaterial>> layerTextureIDToMaterial;
+
+            std::scoped_lock lock(mutex);
+
+            auto itr = layerTextureIDToMaterial.find(layerTextureID);
+            if (itr != layerTextureIDToMaterial.end())
+                return itr->second.GetPtr();
+
+            JPH::RefConst<TerrainPhysicsMaterial> material = new TerrainPhysicsMaterial(layerTextureID);
+            layerTextureIDToMaterial[layerTextureID] = material;
+            return material.GetPtr();
+        }
+
+        JPH::ShapeRefC CreateMeshShape(const ::Map::Chunk& chunk)
+        {
+            ZoneScopedN("TerrainPhysics::CreateMeshShape");
+
+            JPH::VertexList vertices;
+            JPH::IndexedTriangleList triangles;
+            vertices.reserve(Terrain::CHUNK_NUM_CELLS * Terrain::CELL_TOTAL_GRID_SIZE);
+            triangles.reserve(Terrain::CHUNK_NUM_CELLS * Terrain::CELL_NUM_TRIANGLES);
+
+            for (u32 cellID = 0; cellID < Terrain::CHUNK_NUM_CELLS; cellID++)
+            {
+                for (u32 vertexID = 0; vertexID < Terrain::CELL_TOTAL_GRID_SIZE; vertexID++)
+                {
+                    const vec2 position = Util::Map::GetCellVertexPosition(cellID, vertexID);
+                    vertices.push_back({ position.x, chunk.cellsData.heightField[cellID][vertexID], position.y });
+                }
+
+                const u32 cellVertexOffset = cellID * Terrain::CELL_TOTAL_GRID_SIZE;
+                for (u32 triangleID = 0; triangleID < Terrain::CELL_NUM_TRIANGLES; triangleID++)
+                {
+                    const u32 patchID = triangleID / 4;
+                    if ((chunk.cellsData.holes[cellID] & (1ull << patchID)) != 0)
+                        continue;
+
+                    const u32 patchRow = patchID / 8;
+                    const u32 patchColumn = patchID % 8;
+                    const u32 patchVertices[5] = {
+                        patchColumn + patchRow * Terrain::CELL_GRID_ROW_SIZE,
+                        patchColumn + patchRow * Terrain::CELL_GRID_ROW_SIZE + 1,
+                        patchColumn + patchRow * Terrain::CELL_GRID_ROW_SIZE + Terrain::CELL_GRID_ROW_SIZE,
+                        patchColumn + patchRow * Terrain::CELL_GRID_ROW_SIZE + Terrain::CELL_GRID_ROW_SIZE + 1,
+                        patchColumn + patchRow * Terrain::CELL_GRID_ROW_SIZE + Terrain::CELL_OUTER_GRID_STRIDE
+                    };
+                    const u32 triangleWithinPatch = triangleID % 4;
+                    const uvec2 componentOffsets(triangleWithinPatch > 1, triangleWithinPatch == 0 || triangleWithinPatch == 3);
+                    const u32 vertexID1 = cellVertexOffset + patchVertices[4];
+                    const u32 vertexID2 = cellVertexOffset + patchVertices[componentOffsets.x * 2 + componentOffsets.y];
+                    const u32 vertexID3 = cellVertexOffset + patchVertices[(!componentOffsets.y) * 2 + componentOffsets.x];
+                    triangles.push_back({ vertexID3, vertexID2, vertexID1 });
+                }
+            }
+
+            JPH::MeshShapeSettings shapeSettings(vertices, triangles);
+            JPH::ShapeSettings::ShapeResult shapeResult = shapeSettings.Create();
+            if (shapeResult.HasError())
+                return nullptr;
+
+            return shapeResult.Get();
+        }
+
+        JPH::ShapeRefC CreateHeightFieldShape(const ::Map::Chunk& chunk)
+        {
+            ZoneScopedN("TerrainPhysics::CreateHeightFieldShape");
+
+            // Patch coordinates across the whole chunk in the range [0, 128), patches outside the chunk belong to another body
+            auto isHole = [&chunk](i32 px, i32 py)
+            {
+                constexpr i32 patchStride = Terrain::CHUNK_NUM_CELLS_PER_STRIDE * Terrain::CELL_NUM_PATCHES_PER_STRIDE;
+                if (px < 0 || py < 0 || px >= patchStride || py >= patchStride)
+                    return true;
+
+                u32 cellID = (px / Terrain::CELL_NUM_PATCHES_PER_STRIDE) + ((py / Terrain::CELL_NUM_PATCHES_PER_STRIDE) * Terrain::CHUNK_NUM_CELLS_PER_STRIDE);
+                u32 patchID = (px % Terrain::CELL_NUM_PATCHES_PER_STRIDE) + ((py % Terrain::CELL_NUM_PATCHES_PER_STRIDE) * Terrain::CELL_NUM_PATCHES_PER_STRIDE);
+                return (chunk.cellsData.holes[cellID] & (1ull << patchID)) != 0;
+            };
+
+            bool hasHoles = false;
+            for (u32 cellID = 0; cellID < Terrain::CHUNK_NUM_CELLS; cellID++)
+            {
+                hasHoles |= chunk.cellsData.holes[cellID] != 0;
+            }
+
+            // Sample (x, y) sits at (x, -y) half patches from the chunk origin, rows are flipped so the scale stays positive
+            // and the triangles keep facing up
+            constexpr u32 sampleCount = HEIGHT_FIELD_SAMPLE_COUNT;
+            constexpr u32 lastSample = HEIGHT_FIELD_QUADS_PER_CHUNK_STRIDE;
+
+            JPH::HeightFieldShapeSettings settings;
+            settings.mOffset = JPH::Vec3(0.0f, 0.0f, -Terrain::CHUNK_SIZE);
+            settings.mScale = JPH::Vec3(Terrain::PATCH_SIZE / HEIGHT_FIELD_SAMPLES_PER_PATCH, 1.0f, Terrain::PATCH_SIZE / HEIGHT_FIELD_SAMPLES_PER_PATCH);
+            settings.mSampleCount = sampleCount;
+            settings.mBlockSize = HEIGHT_FIELD_BLOCK_SIZE;
+            settings.mHeightSamples.resize(sampleCount * sampleCount);
+
+            for (u32 sampleY = 0; sampleY < sampleCount; sampleY++)
+            {
+                u32 hy = lastSample - sampleY;
+
+                for (u32 sampleX = 0; sampleX < sampleCount; sampleX++)
+                {
+                    u32 hx = sampleX;
+
+                    bool isOddX = (hx & 1) != 0;
+                    bool isOddY = (hy & 1) != 0;
+
+                    // A no collision sample takes out every triangle touching it. The center sample only touches its own
+                    // patch, the shared ones are only taken out when every patch around them in this chunk is a hole
+                    if (hasHoles)
+                    {
+                        i32 maxPatchX = static_cast<i32>(hx / 2);
+                        i32 maxPatchY = static_cast<i32>(hy / 2);
+                        i32 minPatchX = isOddX ? maxPatchX : maxPatchX - 1;
+                        i32 minPatchY = isOddY ? maxPatchY : maxPatchY - 1;
+
+                        bool isNoCollision = true;
+                        for (i32 py = minPatchY; py <= maxPatchY && isNoCollision; py++)
+                        {
+                            for (i32 px = minPatchX; px <= maxPatchX && isNoCollision; px++)
+                            {
+                                isNoCollision = isHole(px, py);
+                            }
+                        }
+
+                        if (isNoCollision)
+                        {
+                            settings.mHeightSamples[sampleX + (sampleY * sampleCount)] = JPH::HeightFieldShapeConstants::cNoCollisionValue;
+                            continue;
+                        }
+                    }
+
+                    f32 height = 0.0f;
+                    if (!isOddX && !isOddY)
+                    {
+                        height = GetOuterVertexHeight(chunk, hx / 2, hy / 2);
+                    }
+                    else if (isOddX && isOddY)
+                    {
+                        height = GetCenterVertexHeight(chunk, hx / 2, hy / 2);
+                    }
+                    else if (isOddX)
+                    {
+                        height = (GetOuterVertexHeight(chunk, hx / 2, hy / 2) + GetOuterVertexHeight(chunk, (hx / 2) + 1, hy / 2)) * 0.5f;
+                    }
+                    else
+                    {
+                        height = (GetOuterVertexHeight(chunk, hx / 2, hy / 2) + GetOuterVertexHeight(chunk, hx / 2, (hy / 2) + 1)) * 0.5f;
+                    }
+
+                    settings.mHeightSamples[sampleX + (sampleY * sampleCount)] = height;
+                }
+            }
+
+            std::array<u8, Terrain::CHUNK_NUM_CELLS> cellMaterialIndices;
+            for (u32 cellID = 0; cellID < Terrain::CHUNK_NUM_CELLS; cellID++)
+            {
+                // One material per distinct base layer, a chunk has at most 256 cells so the indices always fit in a u8
+                const TerrainPhysicsMaterial* material = GetLayerMaterial(chunk.cellsData.layerTextureIDs[cellID][0]);
+
+                u32 materialIndex = 0;
+                while (materialIndex < settings.mMaterials.size() && settings.mMaterials[materialIndex] != material)
+                {
+                    materialIndex++;
+                }
+
+                if (materialIndex == settings.mMaterials.size())
+                    settings.mMaterials.push_back(material);
+
+                cellMaterialIndices[cellID] = static_cast<u8>(materialIndex);
+            }
+
+            constexpr u32 quadCount = sampleCount - 1;
+            constexpr u32 quadsPerCell = Terrain::CELL_NUM_PATCHES_PER_STRIDE * HEIGHT_FIELD_SAMPLES_PER_PATCH;
+            settings.mMaterialIndices.resize(quadCount * quadCount);
+
+            for (u32 quadY = 0; quadY < quadCount; quadY++)
+            {
+                u32 cellY = (lastSample - quadY - 1) / quadsPerCell;
+
+                for (u32 quadX = 0; quadX < quadCount; quadX++)
+                {
+                    u32 cellX = quadX / quadsPerCell;
+                    settings.mMaterialIndices[quadX + (quadY * quadCount)] = cellMaterialIndices[cellX + (cellY * Terrain::CHUNK_NUM_CELLS_PER_STRIDE)];
+                }
+            }
+
+            settings.mBitsPerSample = settings.CalculateBitsPerSampleForError(HEIGHT_FIELD_MAX_HEIGHT_ERROR);
+
+            JPH::ShapeSettings::ShapeResult shapeResult = settings.Create();
+            if (shapeResult.HasError())
+                return nullptr;
+
+            return shapeResult.Get();
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <Base/Types.h>
+
+#include <FileFormat/Shared.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/PhysicsMaterial.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+
+namespace Map
+{
+    struct Chunk;
+}
+
+namespace Util
+{
+    namespace TerrainPhysics
+    {
+        // Height field samples per chunk side. Every patch gets 2x2 quads so the patch center vertex gets its own sample
+        static constexpr u32 HEIGHT_FIELD_SAMPLES_PER_PATCH = 2;
+        static constexpr u32 HEIGHT_FIELD_QUADS_PER_CHUNK_STRIDE = Terrain::CHUNK_NUM_CELLS_PER_STRIDE * Terrain::CELL_NUM_PATCHES_PER_STRIDE * HEIGHT_FIELD_SAMPLES_PER_PATCH;
+        static constexpr u32 HEIGHT_FIELD_SAMPLE_COUNT = HEIGHT_FIELD_QUADS_PER_CHUNK_STRIDE + 1;
+
+        // Material of a terrain triangle, identifies the base texture layer of the cell it belongs to
+        class TerrainPhysicsMaterial : public JPH::PhysicsMaterial
+        {
+        public:
+            TerrainPhysicsMaterial(u64 layerTextureID) : _layerTextureID(layerTextureID) { }
+
+            u64 GetLayerTextureID() const { return _layerTextureID; }
+
+        private:
+            u64 _layerTextureID = 0;
+        };
+
+        // Returns a shared material per base layer texture
+        const TerrainPhysicsMaterial* GetLayerMaterial(u64 layerTextureID);
+
+        // Triangle mesh matching the render geometry exactly, this is what gets baked into the chunk files
+        JPH::ShapeRefC CreateMeshShape(const ::Map::Chunk& chunk);
+
+        // The outer and center vertex of every patch are exact samples, edge midpoints are interpolated between the outer
+        // vertices. A height field always splits its quads along the same diagonal, so two quadrants of every patch differ
+        // from the render fan, by at most a quarter of how far the center vertex sits off the line between the two corners
+        // the quadrant doesn't touch.
+        // Hole patches lose their center sample, and shared samples with nothing but holes around them. Where a hole borders
+        // solid patches on two sides one corner triangle, an eighth of the patch, stays solid.
+        JPH::ShapeRefC CreateHeightFieldShape(const ::Map::Chunk& chunk);
+    }
+}
@@ -237,12 +237,14 @@ namespace Util::Unit
         return PlayAnimationRaw(modelInfo, animationData, boneIndex, animationID, propagateToChildren, flags, blendOverride, speedModifier, callback);
     }
 
-    bool UpdateAnimationState(entt::registry& registry, entt::entity entity, ::Components::Model& model, f32 deltaTime)
+    bool UpdateAnimationState(entt::registry& registry, entt::entity entity, ::Components::Model& model, f32 deltaTime, bool& castFinished)
     {
+        castFinished = false;
+
         if (model.instanceID == std::numeric_limits<u32>().max())
             return false;
 
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
 
         const auto* modelInfo = modelLoader->GetModelInfo(model.modelHash);
         if (!modelInfo)
@@ -332,7 +334,7 @@ namespace Util::Unit
                 {
                     if (::Animation::Defines::HasFlag(animationState.currentFlags, ::Animation::Defines::Flags::Finished))
                     {
-                        registry.erase<Components::CastInfo>(entity);
+                        castFinished = true;
                     }
                     else
                     {
@@ -341,7 +343,7 @@ namespace Util::Unit
                 }
                 else
                 {
-                    registry.erase<Components::CastInfo>(entity);
+                    castFinished = true;
                 }
             }
             else
@@ -498,7 +500,7 @@ namespace Util::Unit
         if (!registry.all_of<Components::AnimationData, Components::Model>(entity))
             return false;
 
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
         auto& model = registry.get<Components::Model>(entity);
         auto& animationData = registry.get<Components::AnimationData>(entity);
 
@@ -533,7 +535,7 @@ namespace Util::Unit
         if (!registry.all_of<Components::AnimationData, Components::Model>(entity))
             return false;
 
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
         auto& model = registry.get<Components::Model>(entity);
         auto& animationData = registry.get<Components::AnimationData>(entity);
 
@@ -559,7 +561,7 @@ namespace Util::Unit
         if (!registry.all_of<Components::AnimationData, Components::Model>(entity))
             return false;
 
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
         auto& model = registry.get<Components::Model>(entity);
         auto& animationData = registry.get<Components::AnimationData>(entity);
 
@@ -725,7 +727,7 @@ namespace Util::Unit
         if (!registry.all_of<Components::AttachmentData, Components::Model>(entity))
             return false;
 
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
         auto& model = registry.get<Components::Model>(entity);
 
         const auto* modelInfo = modelLoader->GetModelInfo(model.modelHash);
@@ -796,7 +798,7 @@ namespace Util::Unit
         if (!registry.all_of<Components::AttachmentData, Components::Model>(entity))
             return false;
 
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
         auto& model = registry.get<Components::Model>(entity);
 
         const auto* modelInfo = modelLoader->GetModelInfo(model.modelHash);
@@ -836,7 +838,7 @@ namespace Util::Unit
     {
         if (model.flags.loaded)
         {
-            auto* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+            auto* modelLoader = ServiceLocator::GetModelLoader();
             modelLoader->EnableGroupForModel(model, groupID);
         }
         else
@@ -850,7 +852,7 @@ namespace Util::Unit
     {
         if (model.flags.loaded)
         {
-            auto* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+            auto* modelLoader = ServiceLocator::GetModelLoader();
             modelLoader->DisableGroupsForModel(model, startGroupID, endGroupID);
         }
         else
@@ -883,7 +885,7 @@ namespace Util::Unit
     {
         if (model.flags.loaded)
         {
-            auto* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+            auto* modelLoader = ServiceLocator::GetModelLoader();
             modelLoader->DisableAllGroupsForModel(model);
         }
         else
@@ -1192,73 +1194,132 @@ namespace Util::Unit
         }
     }
 
-    void RefreshSkinTexture(entt::registry& registry, entt::entity entity, ECS::Singletons::ClientDBSingleton& clientDBSingleton, ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, const ::ECS::Components::DisplayInfo& displayInfo, ::ECS::Components::UnitCustomization& unitCustomization, const ::ECS::Components::Model& model)
+    static void ReleaseCustomizationTextures(TextureRenderer* textureRenderer, std::array<u64, ::ECS::Components::UnitCustomizationTexture::Count>& textureHashes)
+    {
+        for (u64& textureHash : textureHashes)
+        {
+            if (textureHash != 0)
+                textureRenderer->ReleaseCustomizationTexture(textureHash);
+
+            textureHash = 0;
+        }
+    }
+
+    bool RefreshSkinTexture(entt::registry& registry, entt::entity entity, ECS::Singletons::ClientDBSingleton& clientDBSingleton, ECS::Singletons::ItemSingleton& itemSingleton, ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, const ::ECS::Components::DisplayInfo& displayInfo, ::ECS::Components::UnitCustomization& unitCustomization, const ::ECS::Components::Model& model, const std::vector<u32>& itemDisplayIDs)
     {
+        namespace UnitCustomizationTexture = ::ECS::Components::UnitCustomizationTexture;
+
         // TODO : Get Customization Info from DisplayID if possible, otherwise use UnitCustomization
-        Renderer::TextureID baseSkinTextureID;
-        if (!ECSUtil::UnitCustomization::GetBaseSkinTextureID(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.skinID, baseSkinTextureID))
-            return;
+        std::array<u64, UnitCustomizationTexture::Count> textureHashes = {};
+        if (!ECSUtil::UnitCustomization::GetBaseSkinTextureHash(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.skinID, textureHashes[UnitCustomizationTexture::BaseSkin]))
+            return true;
+
+        bool hasCustomization = displayInfo.displayID != 0 && displayInfo.race != GameDefine::UnitRace::None && displayInfo.gender != GameDefine::UnitGender::None;
+        if (hasCustomization)
+        {
+            ECSUtil::UnitCustomization::GetBaseSkinBraTextureHash(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.skinID, textureHashes[UnitCustomizationTexture::Bra]);
+            ECSUtil::UnitCustomization::GetBaseSkinUnderwearTextureHash(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.skinID, textureHashes[UnitCustomizationTexture::Underwear]);
+            ECSUtil::UnitCustomization::GetBaseSkinFaceTextureHash(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.skinID, unitCustomization.faceID, 0, textureHashes[UnitCustomizationTexture::FaceLower]);
+            ECSUtil::UnitCustomization::GetBaseSkinFaceTextureHash(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.skinID, unitCustomization.faceID, 1, textureHashes[UnitCustomizationTexture::FaceUpper]);
+            ECSUtil::UnitCustomization::GetBaseSkinHairTextureHash(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.hairStyleID, unitCustomization.hairColorID, 2, textureHashes[UnitCustomizationTexture::HairUpper]);
+            ECSUtil::UnitCustomization::GetBaseSkinHairTextureHash(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.hairStyleID, unitCustomization.hairColorID, 1, textureHashes[UnitCustomizationTexture::HairLower]);
+            ECSUtil::UnitCustomization::GetHairTextureHash(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.hairStyleID, unitCustomization.hairColorID, textureHashes[UnitCustomizationTexture::HairModel]);
+        }
 
-        ModelLoader* modelLoader = ServiceLocator::GetGameRenderer()->GetModelLoader();
+        ModelLoader* modelLoader = ServiceLocator::GetModelLoader();
         TextureRenderer* textureRenderer = ServiceLocator::GetGameRenderer()->GetTextureRenderer();
 
-        bool justCreatedSkinTexture = false;
-        if (unitCustomization.skinTextureID == Renderer::TextureID::Invalid())
+        // Acquired before the previous ones are released, so the textures both use stay loaded
+        for (u64 textureHash : textureHashes)
         {
-            unitCustomization.skinTextureID = textureRenderer->MakeRenderableCopy(baseSkinTextureID, 512, 512);
-            justCreatedSkinTexture = true;
+            if (textureHash != 0)
+                textureRenderer->AcquireCustomizationTexture(textureHash);
         }
 
-        if (justCreatedSkinTexture || unitCustomization.flags.forceRefresh)
+        // The committed textures stay referenced and bound to the model until the new ones have loaded
+        ReleaseCustomizationTextures(textureRenderer, unitCustomization.pendingTextureHashes);
+        unitCustomization.pendingTextureHashes = textureHashes;
+
+        if (IsLoadingSkinTextures(unitCustomization))
+            return false;
+
+        // The hair texture stays bound to the model, so it has to be replaced before its reference goes away
+        bool hairTextureChanged = unitCustomization.textureHashes[UnitCustomizationTexture::HairModel] != textureHashes[UnitCustomizationTexture::HairModel];
+
+        Renderer::TextureID baseSkinTextureID;
+        if (!textureRenderer->GetCustomizationTextureID(textureHashes[UnitCustomizationTexture::BaseSkin], baseSkinTextureID))
         {
-            modelLoader->SetSkinTextureForModel(model, unitCustomization.skinTextureID);
+            ReleaseCustomizationTextures(textureRenderer, unitCustomization.pendingTextureHashes);
+            return true;
         }
 
-        if (displayInfo.displayID != 0 && displayInfo.race != GameDefine::UnitRace::None && displayInfo.gender != GameDefine::UnitGender::None)
+        // Layers in the order they are written into the skin, customization first and the items on top of it
+        SkinTextureDesc skinTextureDesc;
+        skinTextureDesc.race = static_cast<u8>(displayInfo.race);
+        skinTextureDesc.gender = static_cast<u8>(displayInfo.gender);
+        skinTextureDesc.skinID = unitCustomization.skinID;
+        skinTextureDesc.faceID = unitCustomization.faceID;
+
+        if (hasCustomization)
+        {
+            skinTextureDesc.AddLayer(textureHashes[UnitCustomizationTexture::Bra], static_cast<u8>(Database::Unit::TextureSectionType::TorsoUpper));
+            skinTextureDesc.AddLayer(textureHashes[UnitCustomizationTexture::Underwear], static_cast<u8>(Database::Unit::TextureSectionType::LegUpper));
+            skinTextureDesc.AddLayer(textureHashes[UnitCustomizationTexture::FaceLower], static_cast<u8>(Database::Unit::TextureSectionType::HeadLower));
+            skinTextureDesc.AddLayer(textureHashes[UnitCustomizationTexture::FaceUpper], static_cast<u8>(Database::Unit::TextureSectionType::HeadUpper));
+            skinTextureDesc.AddLayer(textureHashes[UnitCustomizationTexture::HairUpper], static_cast<u8>(Database::Unit::TextureSectionType::HeadUpper));
+            skinTextureDesc.AddLayer(textureHashes[UnitCustomizationTexture::HairLower], static_cast<u8>(Database::Unit::TextureSectionType::HeadLower));
+        }
+
+        u32 numCustomizationLayers = static_cast<u32>(skinTextureDesc.layers.size());
+        for (u32 itemDisplayID : itemDisplayIDs)
         {
-            if (!justCreatedSkinTexture)
-                ECSUtil::UnitCustomization::WriteBaseSkin(clientDBSingleton, unitCustomizationSingleton, unitCustomization.skinTextureID, baseSkinTextureID);
+            ECSUtil::UnitCustomization::AddItemToSkinTextureDesc(itemSingleton, unitCustomization, itemDisplayID, skinTextureDesc);
+        }
 
-            Renderer::TextureID skinBraTextureID;
-            if (ECSUtil::UnitCustomization::GetBaseSkinBraTextureID(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.skinID, skinBraTextureID))
+        u64 skinTextureKey = skinTextureDesc.GetKey();
+        bool skinTextureChanged = skinTextureKey != unitCustomization.skinTextureKey;
+        if (skinTextureChanged)
+        {
+            // Only composited when no other unit already has this exact skin
+            Renderer::TextureID skinTextureID;
+            if (!textureRenderer->AcquireSkinTexture(skinTextureKey, skinTextureID))
             {
-                ECSUtil::UnitCustomization::WriteTextureToSkin(clientDBSingleton, unitCustomizationSingleton, unitCustomization.skinTextureID, skinBraTextureID, Database::Unit::TextureSectionType::TorsoUpper);
-            }
+                skinTextureID = textureRenderer->MakeRenderableCopy(baseSkinTextureID, 512, 512);
 
-            Renderer::TextureID skinUnderwearTextureID;
-            if (ECSUtil::UnitCustomization::GetBaseSkinUnderwearTextureID(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.skinID, skinUnderwearTextureID))
-            {
-                ECSUtil::UnitCustomization::WriteTextureToSkin(clientDBSingleton, unitCustomizationSingleton, unitCustomization.skinTextureID, skinUnderwearTextureID, Database::Unit::TextureSectionType::LegUpper);
-            }
+                u32 numLayers = static_cast<u32>(skinTextureDesc.layers.size());
+                for (u32 i = 0; i < numLayers; i++)
+                {
+                    const SkinTextureDesc::Layer& layer = skinTextureDesc.layers[i];
 
-            Renderer::TextureID skinFaceTextureID1;
-            if (ECSUtil::UnitCustomization::GetBaseSkinFaceTextureID(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.skinID, unitCustomization.faceID, 0, skinFaceTextureID1))
-            {
-                ECSUtil::UnitCustomization::WriteTextureToSkin(clientDBSingleton, unitCustomizationSingleton, unitCustomization.skinTextureID, skinFaceTextureID1, Database::Unit::TextureSectionType::HeadLower);
-            }
+                    Renderer::TextureID layerTextureID;
+                    bool hasLayerTexture = i < numCustomizationLayers ? textureRenderer->GetCustomizationTextureID(layer.textureHash, layerTextureID) : ECSUtil::UnitCustomization::GetItemTextureID(unitCustomizationSingleton, layer.textureHash, layerTextureID);
+                    if (!hasLayerTexture)
+                        continue;
 
-            Renderer::TextureID skinFaceTextureID2;
-            if (ECSUtil::UnitCustomization::GetBaseSkinFaceTextureID(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.skinID, unitCustomization.faceID, 1, skinFaceTextureID2))
-            {
-                ECSUtil::UnitCustomization::WriteTextureToSkin(clientDBSingleton, unitCustomizationSingleton, unitCustomization.skinTextureID, skinFaceTextureID2, Database::Unit::TextureSectionType::HeadUpper);
-            }
+                    ECSUtil::UnitCustomization::WriteTextureToSkin(clientDBSingleton, unitCustomizationSingleton, skinTextureID, layerTextureID, static_cast<Database::Unit::TextureSectionType>(layer.section));
+                }
 
-            Renderer::TextureID skinHairTextureID2;
-            if (ECSUtil::UnitCustomization::GetBaseSkinHairTextureID(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.hairStyleID, unitCustomization.hairColorID, 2, skinHairTextureID2))
-            {
-                ECSUtil::UnitCustomization::WriteTextureToSkin(clientDBSingleton, unitCustomizationSingleton, unitCustomization.skinTextureID, skinHairTextureID2, Database::Unit::TextureSectionType::HeadUpper);
+                textureRenderer->AddSkinTexture(skinTextureKey, skinTextureID);
             }
 
-            Renderer::TextureID skinHairTextureID1;
-            if (ECSUtil::UnitCustomization::GetBaseSkinHairTextureID(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.hairStyleID, unitCustomization.hairColorID, 1, skinHairTextureID1))
-            {
-                ECSUtil::UnitCustomization::WriteTextureToSkin(clientDBSingleton, unitCustomizationSingleton, unitCustomization.skinTextureID, skinHairTextureID1, Database::Unit::TextureSectionType::HeadLower);
-            }
+            if (unitCustomization.skinTextureKey != 0)
+                textureRenderer->ReleaseSkinTexture(unitCustomization.skinTextureKey);
+
+            unitCustomization.skinTextureID = skinTextureID;
+            unitCustomization.skinTextureKey = skinTextureKey;
+        }
 
-            if (unitCustomization.flags.hairChanged || unitCustomization.flags.forceRefresh)
+        if (skinTextureChanged || unitCustomization.flags.forceRefresh)
+        {
+            modelLoader->SetSkinTextureForModel(model, unitCustomization.skinTextureID);
+        }
+
+        if (hasCustomization)
+        {
+            if (unitCustomization.flags.hairChanged || unitCustomization.flags.forceRefresh || hairTextureChanged)
             {
                 Renderer::TextureID hairTextureID;
-                if (ECSUtil::UnitCustomization::GetHairTexture(unitCustomizationSingleton, displayInfo.race, displayInfo.gender, unitCustomization.hairStyleID, unitCustomization.hairColorID, hairTextureID))
+                if (textureRenderer->GetCustomizationTextureID(textureHashes[UnitCustomizationTexture::HairModel], hairTextureID))
                 {
                     modelLoader->SetHairTextureForModel(model, hairTextureID);
                 }
@@ -1271,7 +1332,39 @@ namespace Util::Unit
             }
         }
 
+        // Only now that nothing is bound to the previous textures anymore can their references go
+        ReleaseCustomizationTextures(textureRenderer, unitCustomization.textureHashes);
+        unitCustomization.textureHashes = textureHashes;
+        unitCustomization.pendingTextureHashes = {};
+
         unitCustomization.flags.forceRefresh = false;
+        return true;
+    }
+
+    bool IsLoadingSkinTextures(const ::ECS::Components::UnitCustomization& unitCustomization)
+    {
+        TextureRenderer* textureRenderer = ServiceLocator::GetGameRenderer()->GetTextureRenderer();
+
+        for (u64 textureHash : unitCustomization.pendingTextureHashes)
+        {
+            if (textureHash != 0 && textureRenderer->IsCustomizationTextureLoading(textureHash))
+                return true;
+        }
+
+        return false;
+    }
+
+    void ReleaseSkinTextures(::ECS::Components::UnitCustomization& unitCustomization)
+    {
+        TextureRenderer* textureRenderer = ServiceLocator::GetGameRenderer()->GetTextureRenderer();
+        ReleaseCustomizationTextures(textureRenderer, unitCustomization.textureHashes);
+        ReleaseCustomizationTextures(textureRenderer, unitCustomization.pendingTextureHashes);
+
+        if (unitCustomization.skinTextureKey != 0)
+            textureRenderer->ReleaseSkinTexture(unitCustomization.skinTextureKey);
+
+        unitCustomization.skinTextureID = Renderer::TextureID::Invalid();
+        unitCustomization.skinTextureKey = 0;
     }
 
     ::Animation::Defines::Type GetIdleAnimation(bool isSwimming, bool stealthed)
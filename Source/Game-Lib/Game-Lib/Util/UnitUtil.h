@@ -12,6 +12,8 @@
 
 #include <entt/fwd.hpp>
 
+#include <vector>
+
 namespace ECS
 {
     struct UnitPower;
@@ -32,6 +34,7 @@ namespace ECS
     namespace Singletons
     {
         struct ClientDBSingleton;
+        struct ItemSingleton;
         struct UnitCustomizationSingleton;
     }
 }
@@ -61,7 +64,10 @@ namespace Util::Unit
     bool PlayAnimationRaw(const Model::ComplexModel* modelInfo, ::ECS::Components::AnimationData& animationData, u32 boneIndex, ::Animation::Defines::Type animationID, bool propagateToChildren = false, ::Animation::Defines::Flags flags = ::Animation::Defines::Flags::None, ::Animation::Defines::BlendOverride blendOverride = ::Animation::Defines::BlendOverride::Auto, f32 speedModifier = 1.0f, ::Animation::Defines::SequenceInterruptCallback callback = nullptr);
     bool PlayAnimation(const Model::ComplexModel* modelInfo, ::ECS::Components::AnimationData& animationData, ::Animation::Defines::Bone bone, ::Animation::Defines::Type animationID, bool propagateToChildren = false, ::Animation::Defines::Flags flags = ::Animation::Defines::Flags::None, ::Animation::Defines::BlendOverride blendOverride = ::Animation::Defines::BlendOverride::Auto, f32 speedModifier = 1.0f, ::Animation::Defines::SequenceInterruptCallback callback = nullptr);
     bool SetAutoAttackVisualState(entt::registry& registry, entt::entity entity, bool enabled);
-    bool UpdateAnimationState(entt::registry& registry, entt::entity entity, ::ECS::Components::Model& model, f32 deltaTime);
+
+    // Only touches the unit's own components so units can be updated in parallel, a finished cast is reported through
+    // castFinished and its CastInfo is left for the caller to remove
+    bool UpdateAnimationState(entt::registry& registry, entt::entity entity, ::ECS::Components::Model& model, f32 deltaTime, bool& castFinished);
 
     bool IsHandClosed(entt::registry& registry, entt::entity entity, bool isOffHand);
     bool CloseHand(entt::registry& registry, entt::entity entity, bool isOffHand);
@@ -78,7 +84,15 @@ namespace Util::Unit
     void DisableGeometryGroups(entt::registry& registry, entt::entity entity, const ::ECS::Components::Model& model, u32 startGroupID, u32 endGroupID = 0);
     void DisableAllGeometryGroups(entt::registry& registry, entt::entity entity, const ::ECS::Components::Model& model);
     void RefreshGeometryGroups(entt::registry& registry, entt::entity entity, ECS::Singletons::ClientDBSingleton& clientDBSingleton, ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, const ::ECS::Components::Model& model);
-    void RefreshSkinTexture(entt::registry& registry, entt::entity entity, ECS::Singletons::ClientDBSingleton& clientDBSingleton, ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, const ::ECS::Components::DisplayInfo& displayInfo, ::ECS::Components::UnitCustomization& unitCustomization, const ::ECS::Components::Model& model);
+
+    // Returns false while customization textures the skin needs are still loading, nothing is written until they all are.
+    // itemDisplayIDs are the items drawn over the skin in the order they are written, units with the same customization
+    // and items share one composited skin
+    bool RefreshSkinTexture(entt::registry& registry, entt::entity entity, ECS::Singletons::ClientDBSingleton& clientDBSingleton, ECS::Singletons::ItemSingleton& itemSingleton, ECS::Singletons::UnitCustomizationSingleton& unitCustomizationSingleton, const ::ECS::Components::DisplayInfo& displayInfo, ::ECS::Components::UnitCustomization& unitCustomization, const ::ECS::Components::Model& model, const std::vector<u32>& itemDisplayIDs);
+    bool IsLoadingSkinTextures(const ::ECS::Components::UnitCustomization& unitCustomization);
+
+    // Releases the customization textures and the composited skin
+    void ReleaseSkinTextures(::ECS::Components::UnitCustomization& unitCustomization);
 
     ::Animation::Defines::Type GetIdleAnimation(bool isSwimming, bool stealthed);
     ::Animation::Defines::Type GetMoveForwardAnimation(f32 speed, bool isSwimming, bool stealthed);
@@ -0,0 +1,201 @@
+#include "Game-Lib/Gameplay/Animation/Keyframes.h"
+
+#include <FileFormat/Novus/Model/ComplexModel.h>
+
+#include <catch2/catch2.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // The linear scan InterpolateKeyframe used before the cursors, kept here as the reference
+    ::Animation::Keyframes::Segment FindSegmentLinear(const std::vector<u32>& timestamps, f32 progress)
+    {
+        ::Animation::Keyframes::Segment segment;
+
+        u32 numTimeStamps = static_cast<u32>(timestamps.size());
+        if (numTimeStamps == 1)
+            return segment;
+
+        f32 lastTimestamp = static_cast<f32>(timestamps[numTimeStamps - 1] / 1000.0f);
+        if (progress >= lastTimestamp)
+        {
+            segment.index0 = numTimeStamps - 1;
+            segment.index1 = numTimeStamps - 1;
+            return segment;
+        }
+
+        f32 timestamp1 = static_cast<f32>(timestamps[0] / 1000.0f);
+        f32 timestamp2 = static_cast<f32>(timestamps[1] / 1000.0f);
+        u32 index1 = 0;
+        u32 index2 = 1;
+
+        for (u32 i = 1; i < numTimeStamps; i++)
+        {
+            f32 timestamp = static_cast<f32>(timestamps[i] / 1000.0f);
+
+            if (progress <= timestamp)
+            {
+                timestamp1 = static_cast<f32>(timestamps[i - 1] / 1000.0f);
+                timestamp2 = static_cast<f32>(timestamps[i] / 1000.0f);
+                index1 = i - 1;
+                index2 = i;
+                break;
+            }
+        }
+
+        segment.index0 = index1;
+        segment.index1 = index2;
+
+        f32 currentProgress = progress - timestamp1;
+        f32 currentFrameDuration = timestamp2 - timestamp1;
+
+        if (currentFrameDuration == 0.0f)
+        {
+            segment.index1 = index1;
+            return segment;
+        }
+
+        segment.t = currentProgress / currentFrameDuration;
+        return segment;
+    }
+
+    std::vector<u32> MakeRandomTrack(std::mt19937& rng, u32 numKeys)
+    {
+        std::uniform_int_distribution<u32> stepDistribution(0, 120);
+        std::uniform_int_distribution<u32> startDistribution(0, 50);
+
+        std::vector<u32> timestamps(numKeys);
+        u32 timestamp = startDistribution(rng);
+        for (u32 i = 0; i < numKeys; i++)
+        {
+            timestamps[i] = timestamp;
+
+            // Zero steps on purpose, duplicate keys show up in real tracks
+            timestamp += stepDistribution(rng);
+        }
+
+        return timestamps;
+    }
+
+    std::vector<f32> ToSeconds(const std::vector<u32>& timestamps)
+    {
+        std::vector<f32> seconds;
+        seconds.reserve(timestamps.size());
+
+        for (u32 timestamp : timestamps)
+        {
+            seconds.push_back(static_cast<f32>(timestamp / 1000.0f));
+        }
+
+        return seconds;
+    }
+
+    void CheckSameSegment(const ::Animation::Keyframes::Segment& a, const ::Animation::Keyframes::Segment& b)
+    {
+        CHECK(a.index0 == b.index0);
+        CHECK(a.index1 == b.index1);
+
+        if (a.index0 != a.index1)
+            CHECK(a.t == b.t);
+    }
+}
+
+TEST_CASE("Keyframe cursor matches the linear scan when playing forward", "[Animation][Keyframes]")
+{
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<u32> numKeysDistribution(1, 400);
+    std::uniform_real_distribution<f32> deltaDistribution(0.0f, 0.05f);
+
+    for (u32 trackIndex = 0; trackIndex < 200; trackIndex++)
+    {
+        std::vector<u32> timestamps = MakeRandomTrack(rng, numKeysDistribution(rng));
+        std::vector<f32> seconds = ToSeconds(timestamps);
+        f32 duration = seconds.back() + 0.1f;
+
+        u32 cursor = 0;
+        f32 progress = 0.0f;
+        for (u32 step = 0; step < 2000; step++)
+        {
+            // Wrap around like a looping sequence does
+            progress += deltaDistribution(rng);
+            if (progress > duration)
+                progress -= duration;
+
+            CheckSameSegment(::Animation::Keyframes::FindSegment(seconds, progress, cursor), FindSegmentLinear(timestamps, progress));
+        }
+    }
+}
+
+TEST_CASE("Keyframe cursor matches the linear scan when seeking", "[Animation][Keyframes]")
+{
+    std::mt19937 rng(777);
+    std::uniform_int_distribution<u32> numKeysDistribution(1, 400);
+
+    for (u32 trackIndex = 0; trackIndex < 200; trackIndex++)
+    {
+        std::vector<u32> timestamps = MakeRandomTrack(rng, numKeysDistribution(rng));
+        std::vector<f32> seconds = ToSeconds(timestamps);
+
+        // Covers progress before the first key, exactly on keys and past the end
+        std::uniform_real_distribution<f32> progressDistribution(-0.5f, seconds.back() + 0.5f);
+        std::uniform_int_distribution<u32> keyDistribution(0, static_cast<u32>(seconds.size()) - 1);
+
+        u32 cursor = 0;
+        for (u32 step = 0; step < 1000; step++)
+        {
+            f32 progress = (step % 3 == 0) ? seconds[keyDistribution(rng)] : progressDistribution(rng);
+
+            CheckSameSegment(::Animation::Keyframes::FindSegment(seconds, progress, cursor), FindSegmentLinear(timestamps, progress));
+            CheckSameSegment(::Animation::Keyframes::FindSegment(seconds, progress), FindSegmentLinear(timestamps, progress));
+        }
+    }
+}
+
+TEST_CASE("Keyframe cursor survives switching tracks", "[Animation][Keyframes]")
+{
+    std::mt19937 rng(99);
+    std::vector<u32> longTrack = MakeRandomTrack(rng, 300);
+    std::vector<u32> shortTrack = MakeRandomTrack(rng, 3);
+    std::vector<f32> longSeconds = ToSeconds(longTrack);
+    std::vector<f32> shortSeconds = ToSeconds(shortTrack);
+
+    // A cursor left deep in a long track must not index out of a shorter one when the sequence changes
+    u32 cursor = 0;
+    f32 progress = longSeconds[250];
+    CheckSameSegment(::Animation::Keyframes::FindSegment(longSeconds, progress, cursor), FindSegmentLinear(longTrack, progress));
+    CHECK(cursor > 2);
+
+    progress = shortSeconds[1] * 0.5f;
+    CheckSameSegment(::Animation::Keyframes::FindSegment(shortSeconds, progress, cursor), FindSegmentLinear(shortTrack, progress));
+}
+
+TEST_CASE("Model track times are converted to seconds per bone and component", "[Animation][Keyframes]")
+{
+    Model::ComplexModel model;
+    Model::ComplexModel::Bone& bone = model.bones.emplace_back();
+
+    Model::ComplexModel::AnimationTrack<vec3>& firstTrack = bone.translation.tracks.emplace_back();
+    firstTrack.timestamps = { 0, 500, 1500 };
+    Model::ComplexModel::AnimationTrack<vec3>& secondTrack = bone.translation.tracks.emplace_back();
+    secondTrack.timestamps = { 250 };
+
+    ::Animation::Keyframes::ModelTrackTimes trackTimes;
+    trackTimes.Build(model);
+
+    std::span<const f32> first = trackTimes.GetBoneTrack(0, ::Animation::Keyframes::TrackComponent::Translation, 0);
+    REQUIRE(first.size() == 3);
+    CHECK(first[1] == Catch::Approx(0.5f));
+    CHECK(first[2] == Catch::Approx(1.5f));
+
+    std::span<const f32> second = trackTimes.GetBoneTrack(0, ::Animation::Keyframes::TrackComponent::Translation, 1);
+    REQUIRE(second.size() == 1);
+    CHECK(second[0] == Catch::Approx(0.25f));
+
+    CHECK(trackTimes.GetBoneTrack(0, ::Animation::Keyframes::TrackComponent::Translation, 2).empty());
+    CHECK(trackTimes.GetBoneTrack(0, ::Animation::Keyframes::TrackComponent::Rotation, 0).empty());
+    CHECK(trackTimes.GetBoneTrack(1, ::Animation::Keyframes::TrackComponent::Translation, 0).empty());
+    CHECK(trackTimes.GetTextureTransformTrack(0, ::Animation::Keyframes::TrackComponent::Scale, 0).empty());
+}
@@ -0,0 +1,162 @@
+#include "Game-Lib/Gameplay/Animation/LOD.h"
+
+#include <catch2/catch2.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+
+using namespace Animation;
+
+TEST_CASE("Animation LOD buckets by distance and visibility", "[Animation][LOD]")
+{
+    LOD::Settings settings;
+    settings.fullDistance = 10.0f;
+    settings.halfDistance = 20.0f;
+    settings.quarterDistance = 30.0f;
+    settings.hysteresis = 2.0f;
+
+    CHECK(LOD::GetLevel(settings, LOD::Level::Full, 5.0f, true) == LOD::Level::Full);
+    CHECK(LOD::GetLevel(settings, LOD::Level::Full, 25.0f, true) == LOD::Level::Quarter);
+    CHECK(LOD::GetLevel(settings, LOD::Level::Full, 500.0f, true) == LOD::Level::Distant);
+    CHECK(LOD::GetLevel(settings, LOD::Level::Full, 5.0f, false) == LOD::Level::Offscreen);
+
+    SECTION("Dropping detail waits for the hysteresis")
+    {
+        CHECK(LOD::GetLevel(settings, LOD::Level::Full, 11.0f, true) == LOD::Level::Full);
+        CHECK(LOD::GetLevel(settings, LOD::Level::Full, 12.5f, true) == LOD::Level::Half);
+        CHECK(LOD::GetLevel(settings, LOD::Level::Half, 31.0f, true) == LOD::Level::Quarter);
+    }
+
+    SECTION("Gaining detail is immediate")
+    {
+        CHECK(LOD::GetLevel(settings, LOD::Level::Half, 9.9f, true) == LOD::Level::Full);
+        CHECK(LOD::GetLevel(settings, LOD::Level::Offscreen, 25.0f, true) == LOD::Level::Quarter);
+    }
+}
+
+TEST_CASE("Animation LOD evaluates at the level's update rate", "[Animation][LOD]")
+{
+    LOD::Settings settings;
+
+    for (LOD::Level level : { LOD::Level::Full, LOD::Level::Half, LOD::Level::Quarter, LOD::Level::Distant })
+    {
+        u8 interval = LOD::GetUpdateInterval(settings, level);
+        REQUIRE(interval > 0);
+
+        LOD::State state;
+        state.hasPose = true;
+        state.level = level;
+
+        u32 numEvaluations = 0;
+        for (u32 frame = 0; frame < 64u * interval; frame++)
+        {
+            numEvaluations += LOD::Step(settings, state, level, 0).evaluate;
+        }
+
+        CHECK(numEvaluations == 64);
+    }
+}
+
+TEST_CASE("Animation LOD blends towards the evaluated pose between updates", "[Animation][LOD]")
+{
+    LOD::Settings settings;
+
+    LOD::State state;
+    state.hasPose = true;
+    state.level = LOD::Level::Quarter;
+
+    // Line up with the next evaluation
+    while (!LOD::Step(settings, state, LOD::Level::Quarter, 0).evaluate) {}
+
+    std::vector<f32> blendFactors;
+    for (u32 frame = 0; frame < 4; frame++)
+    {
+        LOD::Decision decision = LOD::Step(settings, state, LOD::Level::Quarter, 0);
+        CHECK(decision.interpolate);
+        blendFactors.push_back(decision.blendFactor);
+    }
+
+    // The blend finishes right as the next evaluation comes in
+    CHECK(blendFactors == std::vector<f32>{ 0.5f, 0.75f, 1.0f, 0.25f });
+
+    settings.interpolate = false;
+    CHECK_FALSE(LOD::Step(settings, state, LOD::Level::Quarter, 0).interpolate);
+}
+
+TEST_CASE("Animation LOD freezes offscreen entities and wakes them when visible", "[Animation][LOD]")
+{
+    LOD::Settings settings;
+    settings.offscreenInterval = 0;
+
+    LOD::State state;
+    CHECK(LOD::Step(settings, state, LOD::Level::Offscreen, 0).evaluate); // Everyone gets one pose
+
+    for (u32 frame = 0; frame < 100; frame++)
+    {
+        LOD::Decision decision = LOD::Step(settings, state, LOD::Level::Offscreen, 0);
+        CHECK_FALSE(decision.evaluate);
+        CHECK_FALSE(decision.interpolate);
+    }
+
+    CHECK(LOD::Step(settings, state, LOD::Level::Distant, 0).evaluate);
+}
+
+TEST_CASE("Animation LOD staggers entities and limits bones at range", "[Animation][LOD]")
+{
+    LOD::Settings settings;
+    settings.subsetBoneDepth = 3;
+
+    std::vector<u32> evaluationsPerFrame(4, 0);
+    for (u32 entity = 0; entity < 64; entity++)
+    {
+        LOD::State state;
+        LOD::Step(settings, state, LOD::Level::Quarter, entity);
+
+        for (u32 frame = 0; frame < 4; frame++)
+        {
+            evaluationsPerFrame[frame] += LOD::Step(settings, state, LOD::Level::Quarter, entity).evaluate;
+        }
+    }
+
+    for (u32 evaluations : evaluationsPerFrame)
+    {
+        CHECK(evaluations == 16);
+    }
+
+    LOD::State state;
+    CHECK(LOD::Step(settings, state, LOD::Level::Half, 0).maxBoneDepth == 0);
+    CHECK(LOD::Step(settings, state, LOD::Level::Quarter, 0).maxBoneDepth == 3);
+    CHECK(LOD::Step(settings, state, LOD::Level::Distant, 0).maxBoneDepth == 3);
+}
+
+TEST_CASE("Animation LOD blends bone matrices by translation, rotation and scale", "[Animation][LOD]")
+{
+    const vec3 up = vec3(0.0f, 1.0f, 0.0f);
+
+    mat4x4 from = mat4x4(1.0f);
+    mat4x4 to = glm::translate(mat4x4(1.0f), vec3(2.0f, 0.0f, 0.0f)) * glm::rotate(mat4x4(1.0f), glm::radians(90.0f), up) * glm::scale(mat4x4(1.0f), vec3(3.0f));
+
+    // Halfway the bone has turned 45 degrees at twice the size, lerping the matrices would shrink the axes to about 0.7 of that
+    mat4x4 expected = glm::translate(mat4x4(1.0f), vec3(1.0f, 0.0f, 0.0f)) * glm::rotate(mat4x4(1.0f), glm::radians(45.0f), up) * glm::scale(mat4x4(1.0f), vec3(2.0f));
+    mat4x4 blended = LOD::BlendPose(from, to, 0.5f);
+
+    for (u32 column = 0; column < 4; column++)
+    {
+        for (u32 row = 0; row < 4; row++)
+        {
+            CHECK(blended[column][row] == Approx(expected[column][row]).margin(0.0001f));
+        }
+    }
+
+    mat4x4 start = LOD::BlendPose(from, to, 0.0f);
+    mat4x4 end = LOD::BlendPose(from, to, 1.0f);
+    for (u32 column = 0; column < 4; column++)
+    {
+        for (u32 row = 0; row < 4; row++)
+        {
+            CHECK(start[column][row] == Approx(from[column][row]).margin(0.0001f));
+            CHECK(end[column][row] == Approx(to[column][row]).margin(0.0001f));
+        }
+    }
+}
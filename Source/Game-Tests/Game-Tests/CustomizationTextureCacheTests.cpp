@@ -0,0 +1,302 @@
+#include "Game-Lib/Rendering/Texture/CustomizationTextureCache.h"
+
+#include <catch2/catch2.hpp>
+
+#include <vector>
+
+namespace
+{
+    class FakeUploader : public CustomizationTextureCache::Uploader
+    {
+    public:
+        Renderer::TextureID UploadCustomizationTexture(u64 textureHash, const void* data, size_t size) override
+        {
+            if (failUploads)
+                return Renderer::TextureID::Invalid();
+
+            uploads.push_back(textureHash);
+            return Renderer::TextureID(nextTextureID++);
+        }
+
+        void UnloadCustomizationTexture(u64 textureHash, Renderer::TextureID textureID) override
+        {
+            unloads.push_back(textureHash);
+        }
+
+    public:
+        Renderer::TextureID::type nextTextureID = 1;
+        bool failUploads = false;
+
+        std::vector<u64> uploads;
+        std::vector<u64> unloads;
+    };
+
+    // Runs the jobs like the renderer would
+    void CompleteJobs(CustomizationTextureCache& cache, const std::vector<u64>& jobs)
+    {
+        static const std::vector<u8> data(16, 0);
+
+        for (u64 textureHash : jobs)
+        {
+            cache.CompleteJob(textureHash, data.data(), data.size());
+        }
+    }
+}
+
+TEST_CASE("Customization texture cache loads nothing until a texture is acquired", "[Rendering][CustomizationTextureCache]")
+{
+    FakeUploader uploader;
+    CustomizationTextureCache cache(&uploader);
+
+    std::vector<u64> jobs;
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs.empty());
+
+    Renderer::TextureID textureID;
+    CHECK_FALSE(cache.GetTextureID(1, textureID));
+    CHECK_FALSE(cache.IsLoading(1));
+
+    cache.Acquire(1);
+    CHECK(cache.IsLoading(1));
+    CHECK_FALSE(cache.GetTextureID(1, textureID));
+
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs == std::vector<u64>{ 1 });
+    CHECK(cache.GetNumJobsInFlight() == 1);
+    CHECK(cache.IsLoading(1));
+
+    CompleteJobs(cache, jobs);
+    CHECK_FALSE(cache.IsLoading(1));
+    REQUIRE(cache.GetTextureID(1, textureID));
+    CHECK(textureID == Renderer::TextureID(1));
+    CHECK(uploader.uploads == std::vector<u64>{ 1 });
+}
+
+TEST_CASE("Customization texture cache loads a texture once however many units use it", "[Rendering][CustomizationTextureCache]")
+{
+    FakeUploader uploader;
+    CustomizationTextureCache cache(&uploader);
+
+    cache.Acquire(1);
+    cache.Acquire(1);
+
+    std::vector<u64> jobs;
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs.size() == 1);
+
+    // Acquired while the load is in flight
+    cache.Acquire(1);
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs.size() == 1);
+
+    CompleteJobs(cache, jobs);
+
+    // And after it is resident
+    cache.Acquire(1);
+    jobs.clear();
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs.empty());
+
+    CHECK(uploader.uploads.size() == 1);
+    CHECK(cache.GetStats().numResident == 1);
+}
+
+TEST_CASE("Customization texture cache hands out jobs in acquire order", "[Rendering][CustomizationTextureCache]")
+{
+    FakeUploader uploader;
+    CustomizationTextureCache cache(&uploader);
+
+    cache.Acquire(3);
+    cache.Acquire(1);
+    cache.Acquire(2);
+
+    std::vector<u64> jobs;
+    cache.CollectJobs(2, jobs);
+    CHECK(jobs == std::vector<u64>{ 3, 1 });
+
+    cache.CollectJobs(2, jobs);
+    CHECK(jobs == std::vector<u64>{ 3, 1, 2 });
+    CHECK(cache.GetNumJobsInFlight() == 3);
+}
+
+TEST_CASE("Customization texture cache drops textures released before their job started", "[Rendering][CustomizationTextureCache]")
+{
+    FakeUploader uploader;
+    CustomizationTextureCache cache(&uploader);
+
+    cache.Acquire(1);
+    cache.Acquire(2);
+    cache.Release(1);
+
+    std::vector<u64> jobs;
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs == std::vector<u64>{ 2 });
+    CHECK(cache.GetStats().numTextures == 1);
+}
+
+TEST_CASE("Customization texture cache evicts textures unused for the eviction delay", "[Rendering][CustomizationTextureCache]")
+{
+    FakeUploader uploader;
+    CustomizationTextureCache cache(&uploader);
+    cache.SetEvictionDelay(10.0f);
+
+    cache.Acquire(1);
+    cache.Acquire(2);
+
+    std::vector<u64> jobs;
+    cache.CollectJobs(16, jobs);
+    CompleteJobs(cache, jobs);
+
+    // Referenced textures never age
+    cache.Update(100.0f);
+    CHECK(uploader.unloads.empty());
+
+    cache.Release(1);
+    CHECK(cache.GetStats().numUnused == 1);
+
+    cache.Update(6.0f);
+    CHECK(uploader.unloads.empty());
+
+    cache.Update(6.0f);
+    CHECK(uploader.unloads == std::vector<u64>{ 1 });
+
+    Renderer::TextureID textureID;
+    CHECK_FALSE(cache.GetTextureID(1, textureID));
+    CHECK(cache.GetTextureID(2, textureID));
+
+    CustomizationTextureCache::Stats stats = cache.GetStats();
+    CHECK(stats.numTextures == 1);
+    CHECK(stats.numResident == 1);
+    CHECK(stats.numEvictions == 1);
+
+    // Evicted textures load again when a unit needs them
+    cache.Acquire(1);
+    jobs.clear();
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs == std::vector<u64>{ 1 });
+
+    CompleteJobs(cache, jobs);
+    CHECK(uploader.uploads.size() == 3);
+}
+
+TEST_CASE("Customization texture cache keeps a texture acquired again before it is evicted", "[Rendering][CustomizationTextureCache]")
+{
+    FakeUploader uploader;
+    CustomizationTextureCache cache(&uploader);
+    cache.SetEvictionDelay(10.0f);
+
+    cache.Acquire(1);
+
+    std::vector<u64> jobs;
+    cache.CollectJobs(16, jobs);
+    CompleteJobs(cache, jobs);
+
+    cache.Release(1);
+    cache.Update(8.0f);
+
+    // The unused time starts over
+    cache.Acquire(1);
+    cache.Release(1);
+    cache.Update(8.0f);
+    CHECK(uploader.unloads.empty());
+
+    jobs.clear();
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs.empty());
+    CHECK(uploader.uploads.size() == 1);
+
+    cache.Update(8.0f);
+    CHECK(uploader.unloads == std::vector<u64>{ 1 });
+}
+
+TEST_CASE("Customization texture cache keeps textures that finish loading after their last release until they age out", "[Rendering][CustomizationTextureCache]")
+{
+    FakeUploader uploader;
+    CustomizationTextureCache cache(&uploader);
+    cache.SetEvictionDelay(10.0f);
+
+    cache.Acquire(1);
+
+    std::vector<u64> jobs;
+    cache.CollectJobs(16, jobs);
+
+    cache.Release(1);
+    cache.Update(20.0f);
+    CHECK(cache.IsLoading(1));
+
+    CompleteJobs(cache, jobs);
+    CHECK(cache.GetStats().numUnused == 1);
+
+    cache.Update(20.0f);
+    CHECK(uploader.unloads == std::vector<u64>{ 1 });
+    CHECK(cache.GetStats().numTextures == 0);
+}
+
+TEST_CASE("Customization texture cache does not retry failed textures while they are referenced", "[Rendering][CustomizationTextureCache]")
+{
+    FakeUploader uploader;
+    CustomizationTextureCache cache(&uploader);
+    cache.SetEvictionDelay(1.0f);
+
+    cache.Acquire(1);
+    cache.Acquire(2);
+
+    std::vector<u64> jobs;
+    cache.CollectJobs(16, jobs);
+
+    cache.FailJob(1);
+    uploader.failUploads = true;
+    cache.CompleteJob(2, nullptr, 0);
+
+    CHECK_FALSE(cache.IsLoading(1));
+    CHECK_FALSE(cache.IsLoading(2));
+    CHECK(cache.GetNumJobsInFlight() == 0);
+    CHECK(cache.GetStats().numFailures == 2);
+
+    cache.Acquire(1);
+    jobs.clear();
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs.empty());
+
+    // Once nothing references them they are forgotten, a later acquire tries again
+    cache.Release(1);
+    cache.Release(1);
+    cache.Update(2.0f);
+    CHECK(uploader.unloads.empty());
+
+    uploader.failUploads = false;
+    cache.Acquire(1);
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs == std::vector<u64>{ 1 });
+}
+
+TEST_CASE("Customization texture cache clear unloads every resident texture", "[Rendering][CustomizationTextureCache]")
+{
+    FakeUploader uploader;
+    CustomizationTextureCache cache(&uploader);
+
+    cache.Acquire(1);
+    cache.Acquire(2);
+    cache.Acquire(3);
+
+    std::vector<u64> jobs;
+    cache.CollectJobs(2, jobs);
+    CompleteJobs(cache, jobs);
+
+    cache.Acquire(4);
+    std::vector<u64> inFlightJobs;
+    cache.CollectJobs(1, inFlightJobs);
+
+    cache.Clear();
+    CHECK(uploader.unloads.size() == 2);
+    CHECK(cache.GetNumJobsInFlight() == 0);
+    CHECK(cache.GetStats().numTextures == 0);
+
+    // Jobs that were running when it was cleared are ignored
+    CompleteJobs(cache, inFlightJobs);
+    CHECK(uploader.uploads.size() == 2);
+
+    jobs.clear();
+    cache.CollectJobs(16, jobs);
+    CHECK(jobs.empty());
+}
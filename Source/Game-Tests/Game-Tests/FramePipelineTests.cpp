@@ -0,0 +1,236 @@
+#include "Game-Lib/Rendering/RenderSnapshot.h"
+#include "Game-Lib/Util/FramePipeline.h"
+
+#include <catch2/catch2.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace
+{
+    // Every value is derived from the frame number, so a snapshot that was written to while being rendered shows up as a mismatch
+    void FillSnapshot(RenderSnapshot& snapshot, u64 frameNumber)
+    {
+        f32 value = static_cast<f32>(frameNumber);
+
+        snapshot.ResetChanges();
+        snapshot.frameNumber = frameNumber;
+        snapshot.deltaTime = value;
+
+        RenderSnapshot::Lighting& lighting = snapshot.lighting;
+        lighting.isSet = frameNumber % 3 != 0;
+        lighting.sunDirection = vec3(value, 1.0f, 0.0f);
+        lighting.diffuseColor = vec3(value);
+        lighting.ambientColor = vec3(value * 2.0f);
+        lighting.shadowColor = vec3(value * 3.0f);
+        lighting.shadowStrength = value;
+        lighting.skybandTopColor = vec3(value);
+        lighting.skybandHorizonColor = vec3(value * 4.0f);
+        lighting.fogColor = vec3(value * 5.0f);
+        lighting.fogBlendBegin = value;
+        lighting.fogBlendEnd = value * 2.0f;
+
+        // Vary the sizes too, the render thread must see whole change lists from one frame
+        u32 numDirtyEntities = 256 + static_cast<u32>(frameNumber % 7) * 32;
+        entt::entity entity = static_cast<entt::entity>(frameNumber);
+
+        RenderSnapshot::AnimationChanges& animation = snapshot.animation;
+        animation.addedInstances.assign(static_cast<u32>(frameNumber % 5), static_cast<u32>(frameNumber));
+        animation.addedStaticEntities.assign(static_cast<u32>(frameNumber % 3), entity);
+        animation.staticInstances.assign(static_cast<u32>(frameNumber % 4), { static_cast<u32>(frameNumber), entity });
+        animation.dirtyEntities.assign(numDirtyEntities, entity);
+
+        snapshot.timings = {};
+        snapshot.timings.deltaTimeS = value;
+    }
+
+    bool IsSnapshotConsistent(const RenderSnapshot& snapshot)
+    {
+        u64 frameNumber = snapshot.frameNumber;
+        f32 value = static_cast<f32>(frameNumber);
+
+        if (snapshot.deltaTime != value || snapshot.timings.deltaTimeS != value)
+            return false;
+
+        const RenderSnapshot::Lighting& lighting = snapshot.lighting;
+        if (lighting.isSet != (frameNumber % 3 != 0))
+            return false;
+
+        if (lighting.sunDirection.x != value || lighting.diffuseColor.x != value || lighting.ambientColor.y != value * 2.0f || lighting.shadowColor.z != value * 3.0f)
+            return false;
+
+        if (lighting.shadowStrength != value || lighting.skybandTopColor.x != value || lighting.skybandHorizonColor.y != value * 4.0f)
+            return false;
+
+        if (lighting.fogColor.z != value * 5.0f || lighting.fogBlendBegin != value || lighting.fogBlendEnd != value * 2.0f)
+            return false;
+
+        const RenderSnapshot::AnimationChanges& animation = snapshot.animation;
+        u32 numDirtyEntities = 256 + static_cast<u32>(frameNumber % 7) * 32;
+        if (animation.addedInstances.size() != frameNumber % 5 || animation.addedStaticEntities.size() != frameNumber % 3)
+            return false;
+
+        if (animation.staticInstances.size() != frameNumber % 4 || animation.dirtyEntities.size() != numDirtyEntities)
+            return false;
+
+        entt::entity entity = static_cast<entt::entity>(frameNumber);
+
+        for (u32 instanceID : animation.addedInstances)
+        {
+            if (instanceID != frameNumber)
+                return false;
+        }
+
+        for (entt::entity staticEntity : animation.addedStaticEntities)
+        {
+            if (staticEntity != entity)
+                return false;
+        }
+
+        for (const RenderSnapshot::StaticAnimationInstance& staticInstance : animation.staticInstances)
+        {
+            if (staticInstance.instanceID != frameNumber || staticInstance.staticEntity != entity)
+                return false;
+        }
+
+        for (entt::entity dirtyEntity : animation.dirtyEntities)
+        {
+            if (dirtyEntity != entity)
+                return false;
+        }
+
+        return true;
+    }
+}
+
+TEST_CASE("Pipelined frames reach the render thread whole, in order and one frame behind at most", "[Rendering][FramePipeline]")
+{
+    static constexpr u64 NumFrames = 500;
+
+    std::atomic<u64> simulatedFrame = 0;
+    std::atomic<u64> numRendered = 0;
+    std::atomic<u64> numInconsistent = 0;
+    std::atomic<u64> numOutOfOrder = 0;
+    std::atomic<u64> maxLatency = 0;
+
+    Util::FramePipeline<RenderSnapshot> pipeline;
+    pipeline.Start("Test Render Thread", [&](RenderSnapshot& snapshot)
+    {
+        // The simulation keeps writing the next frame while this one is being read
+        for (u32 pass = 0; pass < 4; pass++)
+        {
+            if (!IsSnapshotConsistent(snapshot))
+                numInconsistent++;
+
+            std::this_thread::yield();
+        }
+
+        if (snapshot.frameNumber != numRendered + 1)
+            numOutOfOrder++;
+
+        u64 latency = simulatedFrame.load() - snapshot.frameNumber;
+        if (latency > maxLatency)
+            maxLatency = latency;
+
+        snapshot.timings.renderFrameTimeS = static_cast<f32>(snapshot.frameNumber);
+        numRendered++;
+    });
+    REQUIRE(pipeline.IsRunning());
+    CHECK(pipeline.WaitForRender() == nullptr);
+
+    for (u64 frameNumber = 1; frameNumber <= NumFrames; frameNumber++)
+    {
+        simulatedFrame = frameNumber;
+
+        RenderSnapshot& snapshot = pipeline.GetSimulationFrame();
+        FillSnapshot(snapshot, frameNumber);
+
+        pipeline.Submit();
+
+        if (frameNumber % 50 == 0)
+        {
+            // Whatever the render thread wrote back is visible once the frame is done
+            RenderSnapshot* renderedFrame = pipeline.WaitForRender();
+            REQUIRE(renderedFrame != nullptr);
+            CHECK(renderedFrame->frameNumber == frameNumber);
+            CHECK(renderedFrame->timings.renderFrameTimeS == static_cast<f32>(frameNumber));
+        }
+    }
+
+    // The last frame is still rendered when stopping
+    pipeline.Stop();
+    CHECK_FALSE(pipeline.IsRunning());
+
+    CHECK(numRendered == NumFrames);
+    CHECK(numInconsistent == 0);
+    CHECK(numOutOfOrder == 0);
+    CHECK(maxLatency <= 1);
+}
+
+TEST_CASE("A stopped frame pipeline can be started again", "[Rendering][FramePipeline]")
+{
+    Util::FramePipeline<RenderSnapshot> pipeline;
+
+    u64 lastRenderedFrame = 0;
+    auto render = [&lastRenderedFrame](RenderSnapshot& snapshot) { lastRenderedFrame = snapshot.frameNumber; };
+
+    pipeline.Start("Test Render Thread", render);
+    FillSnapshot(pipeline.GetSimulationFrame(), 1);
+    pipeline.Submit();
+    pipeline.Stop();
+    CHECK(lastRenderedFrame == 1);
+
+    pipeline.Start("Test Render Thread", render);
+    FillSnapshot(pipeline.GetSimulationFrame(), 2);
+    pipeline.Submit();
+
+    RenderSnapshot* renderedFrame = pipeline.WaitForRender();
+    REQUIRE(renderedFrame != nullptr);
+    CHECK(renderedFrame->frameNumber == 2);
+    CHECK(lastRenderedFrame == 2);
+}
+
+TEST_CASE("The simulation ticks the next frame while the render thread records the previous one", "[Rendering][FramePipeline]")
+{
+    std::atomic<bool> releaseRender = false;
+    std::atomic<bool> isRendering = false;
+    std::atomic<bool> tickedWhileRendering = false;
+
+    Util::FramePipeline<RenderSnapshot> pipeline;
+    pipeline.Start("Test Render Thread", [&](RenderSnapshot& snapshot)
+    {
+        isRendering = true;
+        while (!releaseRender)
+        {
+            std::this_thread::yield();
+        }
+
+        snapshot.timings.renderFrameTimeS = static_cast<f32>(snapshot.frameNumber);
+        isRendering = false;
+    });
+
+    FillSnapshot(pipeline.GetSimulationFrame(), 1);
+    pipeline.Submit();
+
+    // Same order as Application::Run, the next Simulate happens before waiting on the render thread
+    while (!isRendering)
+    {
+        std::this_thread::yield();
+    }
+
+    RenderSnapshot& nextSnapshot = pipeline.GetSimulationFrame();
+    FillSnapshot(nextSnapshot, 2);
+    tickedWhileRendering = isRendering.load();
+
+    releaseRender = true;
+    RenderSnapshot* renderedFrame = pipeline.WaitForRender();
+    REQUIRE(renderedFrame != nullptr);
+
+    CHECK(tickedWhileRendering);
+    CHECK(renderedFrame->timings.renderFrameTimeS == 1.0f);
+    CHECK(IsSnapshotConsistent(nextSnapshot));
+    CHECK(nextSnapshot.frameNumber == 2);
+
+    pipeline.Submit();
+    pipeline.Stop();
+}
@@ -0,0 +1,62 @@
+#include "Game-Lib/Util/FrameTimeStats.h"
+
+#include <catch2/catch2.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE("Frame time percentiles use the nearest rank", "[Util][FrameTimeStats]")
+{
+    std::vector<f32> samples;
+    for (u32 i = 1; i <= 100; i++)
+        samples.push_back(static_cast<f32>(i));
+
+    CHECK(Util::FrameTimeStats::Percentile(samples, 50.0f) == 50.0f);
+    CHECK(Util::FrameTimeStats::Percentile(samples, 95.0f) == 95.0f);
+    CHECK(Util::FrameTimeStats::Percentile(samples, 99.0f) == 99.0f);
+    CHECK(Util::FrameTimeStats::Percentile(samples, 100.0f) == 100.0f);
+    CHECK(Util::FrameTimeStats::Percentile(samples, 0.0f) == 1.0f);
+
+    std::vector<f32> single = { 4.0f };
+    CHECK(Util::FrameTimeStats::Percentile(single, 99.0f) == 4.0f);
+    CHECK(Util::FrameTimeStats::Percentile({}, 50.0f) == 0.0f);
+}
+
+TEST_CASE("Frame time stats summarize each timer independently and in first seen order", "[Util][FrameTimeStats]")
+{
+    std::vector<f32> durations;
+    for (u32 i = 0; i < 1000; i++)
+        durations.push_back(static_cast<f32>(i % 100) + 1.0f);
+
+    // Insertion order must not matter for the percentiles
+    std::mt19937 rng(7);
+    std::shuffle(durations.begin(), durations.end(), rng);
+
+    Util::FrameTimeStats stats;
+    for (f32 duration : durations)
+    {
+        stats.AddSample("Physics", duration);
+        stats.AddSample("Network", 0.5f);
+    }
+
+    std::vector<Util::FrameTimeStats::Summary> summaries = stats.Summarize();
+    REQUIRE(summaries.size() == 2);
+
+    CHECK(summaries[0].name == "Physics");
+    CHECK(summaries[0].numSamples == 1000);
+    CHECK(summaries[0].p50MS == 50.0f);
+    CHECK(summaries[0].p95MS == 95.0f);
+    CHECK(summaries[0].p99MS == 99.0f);
+    CHECK(summaries[0].maxMS == 100.0f);
+    CHECK(summaries[0].meanMS == Approx(50.5f));
+    CHECK(summaries[0].stddevMS == Approx(28.866f).epsilon(0.001f));
+
+    CHECK(summaries[1].name == "Network");
+    CHECK(summaries[1].p99MS == 0.5f);
+    CHECK(summaries[1].maxMS == 0.5f);
+    CHECK(summaries[1].stddevMS == 0.0f);
+
+    stats.Clear();
+    CHECK(stats.Summarize().empty());
+}
@@ -0,0 +1,229 @@
+#include "Game-Lib/ECS/Singletons/JoltState.h"
+#include "Game-Lib/Util/GroundRaycastBatch.h"
+
+#include <catch2/catch2.hpp>
+
+#include <enkiTS/TaskScheduler.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/HeightFieldShape.h>
+#include <Jolt/RegisterTypes.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr f32 SEARCH_RANGE = 3.0f;
+    constexpr u32 NUM_TILES_PER_SIDE = 4;
+    constexpr u32 TILE_SAMPLE_COUNT = 32;
+    constexpr f32 TILE_SIZE = 62.0f;
+
+    void EnsureJoltInitialized()
+    {
+        if (JPH::Factory::sInstance != nullptr)
+            return;
+
+        JPH::RegisterDefaultAllocator();
+        JPH::Factory::sInstance = new JPH::Factory();
+        JPH::RegisterTypes();
+    }
+
+    f32 SampleTestHeight(f32 x, f32 z)
+    {
+        return 6.0f * std::sin(x / 17.0f) + 4.0f * std::cos(z / 23.0f);
+    }
+
+    // Rolling height field tiles with a few ledges on top, so some columns hit more than one surface, and a moving box
+    // that no ground sample may ever land on
+    std::unique_ptr<ECS::Singletons::JoltState> MakeTestWorld()
+    {
+        std::unique_ptr<ECS::Singletons::JoltState> joltState = std::make_unique<ECS::Singletons::JoltState>();
+        joltState->physicsSystem.Init(Jolt::Settings::maxBodies, Jolt::Settings::numBodyMutexes, Jolt::Settings::maxBodyPairs, Jolt::Settings::maxContactConstraints, joltState->broadPhaseLayerInterface, joltState->objectVSBroadPhaseLayerFilter, joltState->objectVSObjectLayerFilter);
+
+        JPH::BodyInterface& bodyInterface = joltState->physicsSystem.GetBodyInterface();
+        f32 sampleSpacing = TILE_SIZE / static_cast<f32>(TILE_SAMPLE_COUNT - 1);
+
+        for (u32 tileZ = 0; tileZ < NUM_TILES_PER_SIDE; tileZ++)
+        {
+            for (u32 tileX = 0; tileX < NUM_TILES_PER_SIDE; tileX++)
+            {
+                JPH::Vec3 tileOrigin(static_cast<f32>(tileX) * TILE_SIZE, 0.0f, static_cast<f32>(tileZ) * TILE_SIZE);
+
+                std::vector<f32> samples(TILE_SAMPLE_COUNT * TILE_SAMPLE_COUNT);
+                for (u32 sampleZ = 0; sampleZ < TILE_SAMPLE_COUNT; sampleZ++)
+                {
+                    for (u32 sampleX = 0; sampleX < TILE_SAMPLE_COUNT; sampleX++)
+                    {
+                        f32 x = tileOrigin.GetX() + static_cast<f32>(sampleX) * sampleSpacing;
+                        f32 z = tileOrigin.GetZ() + static_cast<f32>(sampleZ) * sampleSpacing;
+                        samples[sampleX + sampleZ * TILE_SAMPLE_COUNT] = SampleTestHeight(x, z);
+                    }
+                }
+
+                JPH::HeightFieldShapeSettings heightFieldSettings(samples.data(), JPH::Vec3::sZero(), JPH::Vec3(sampleSpacing, 1.0f, sampleSpacing), TILE_SAMPLE_COUNT);
+                JPH::BodyCreationSettings tileSettings(heightFieldSettings.Create().Get(), JPH::RVec3(tileOrigin), JPH::Quat::sIdentity(), JPH::EMotionType::Static, Jolt::Layers::NON_MOVING);
+                bodyInterface.CreateAndAddBody(tileSettings, JPH::EActivation::DontActivate);
+            }
+        }
+
+        for (u32 i = 0; i < 24; i++)
+        {
+            f32 x = 10.0f + static_cast<f32>(i % 6) * 38.0f;
+            f32 z = 10.0f + static_cast<f32>(i / 6) * 55.0f;
+
+            JPH::BodyCreationSettings ledgeSettings(new JPH::BoxShape(JPH::Vec3(4.0f, 0.25f, 4.0f)), JPH::RVec3(x, SampleTestHeight(x, z) + 1.0f, z), JPH::Quat::sRotation(JPH::Vec3::sAxisY(), 0.3f * static_cast<f32>(i)), JPH::EMotionType::Static, Jolt::Layers::NON_MOVING);
+            bodyInterface.CreateAndAddBody(ledgeSettings, JPH::EActivation::DontActivate);
+        }
+
+        JPH::BodyCreationSettings moverSettings(new JPH::BoxShape(JPH::Vec3(20.0f, 0.5f, 20.0f)), JPH::RVec3(60.0f, SampleTestHeight(60.0f, 60.0f) + 0.5f, 60.0f), JPH::Quat::sIdentity(), JPH::EMotionType::Kinematic, Jolt::Layers::MOVING);
+        bodyInterface.CreateAndAddBody(moverSettings, JPH::EActivation::DontActivate);
+
+        joltState->physicsSystem.OptimizeBroadPhase();
+
+        return joltState;
+    }
+}
+
+TEST_CASE("Batched ground samples match one narrow phase query per ray", "[Physics][GroundRaycast]")
+{
+    EnsureJoltInitialized();
+    std::unique_ptr<ECS::Singletons::JoltState> joltState = MakeTestWorld();
+
+    enki::TaskScheduler taskScheduler;
+    taskScheduler.Initialize(4);
+
+    // Spread over every cell of the world and a little past its edge, some above or below the search range
+    std::mt19937 random(5);
+    std::uniform_real_distribution<f32> horizontalDistribution(-8.0f, TILE_SIZE * NUM_TILES_PER_SIDE + 8.0f);
+    std::uniform_real_distribution<f32> verticalDistribution(-4.0f, 4.0f);
+
+    std::vector<vec3> positions;
+    for (u32 i = 0; i < 2000; i++)
+    {
+        f32 x = horizontalDistribution(random);
+        f32 z = horizontalDistribution(random);
+        positions.push_back(vec3(x, SampleTestHeight(x, z) + verticalDistribution(random), z));
+    }
+
+    for (enki::TaskScheduler* scheduler : { static_cast<enki::TaskScheduler*>(nullptr), &taskScheduler })
+    {
+        Util::GroundRaycastBatch batch(SEARCH_RANGE);
+        for (const vec3& position : positions)
+        {
+            batch.Add(position);
+        }
+        REQUIRE(batch.GetNumRays() == positions.size());
+
+        batch.Execute(joltState->physicsSystem, scheduler);
+
+        u32 numHits = 0;
+        u32 numMismatches = 0;
+        for (u32 i = 0; i < positions.size(); i++)
+        {
+            Util::GroundRaycastBatch::Sample serialSample;
+            bool serialHit = Util::GroundRaycastBatch::SampleGround(joltState->physicsSystem, positions[i], SEARCH_RANGE, serialSample);
+
+            const Util::GroundRaycastBatch::Sample& batchSample = batch.GetSample(i);
+            if (batchSample.hasHit != serialHit)
+            {
+                numMismatches++;
+                continue;
+            }
+
+            if (!serialHit)
+                continue;
+
+            numHits++;
+
+            // Bit for bit, the batch casts against the same transformed shapes
+            if (batchSample.position.x != serialSample.position.x || batchSample.position.y != serialSample.position.y || batchSample.position.z != serialSample.position.z ||
+                batchSample.normal.x != serialSample.normal.x || batchSample.normal.y != serialSample.normal.y || batchSample.normal.z != serialSample.normal.z)
+            {
+                numMismatches++;
+            }
+        }
+
+        INFO("threaded " << (scheduler != nullptr));
+        CHECK(numMismatches == 0);
+
+        // Most positions are within the search range of the terrain, the ones off the edge or too far above it miss
+        CHECK(numHits > positions.size() / 2);
+        CHECK(numHits < positions.size());
+    }
+}
+
+TEST_CASE("Ground samples ignore moving bodies and clear between batches", "[Physics][GroundRaycast]")
+{
+    EnsureJoltInitialized();
+    std::unique_ptr<ECS::Singletons::JoltState> joltState = MakeTestWorld();
+
+    Util::GroundRaycastBatch batch(SEARCH_RANGE);
+
+    // Right on top of the kinematic box, the terrain half a unit below it is what has to be found
+    vec3 aboveMover = vec3(60.0f, SampleTestHeight(60.0f, 60.0f) + 1.0f, 60.0f);
+    u32 moverRay = batch.Add(aboveMover);
+    u32 missRay = batch.Add(vec3(100.0f, 500.0f, 100.0f));
+    batch.Execute(joltState->physicsSystem, nullptr);
+
+    REQUIRE(batch.GetSample(moverRay).hasHit);
+    CHECK(batch.GetSample(moverRay).position.y == Approx(SampleTestHeight(60.0f, 60.0f)).margin(0.1f));
+    CHECK(batch.GetSample(moverRay).normal.y > 0.5f);
+    CHECK_FALSE(batch.GetSample(missRay).hasHit);
+
+    batch.Clear();
+    CHECK(batch.GetNumRays() == 0);
+
+    batch.Execute(joltState->physicsSystem, nullptr);
+    CHECK(batch.GetNumRays() == 0);
+}
+
+TEST_CASE("A reused batch does not keep bodies that left the world", "[Physics][GroundRaycast]")
+{
+    EnsureJoltInitialized();
+    std::unique_ptr<ECS::Singletons::JoltState> joltState = MakeTestWorld();
+
+    enki::TaskScheduler taskScheduler;
+    taskScheduler.Initialize(4);
+
+    Util::GroundRaycastBatch batch(SEARCH_RANGE);
+    auto runBatch = [&]()
+    {
+        batch.Clear();
+        for (u32 z = 0; z < 16; z++)
+        {
+            for (u32 x = 0; x < 16; x++)
+            {
+                f32 worldX = 4.0f + static_cast<f32>(x) * 15.0f;
+                f32 worldZ = 4.0f + static_cast<f32>(z) * 15.0f;
+                batch.Add(vec3(worldX, SampleTestHeight(worldX, worldZ), worldZ));
+            }
+        }
+
+        batch.Execute(joltState->physicsSystem, &taskScheduler);
+
+        u32 numHits = 0;
+        for (u32 i = 0; i < batch.GetNumRays(); i++)
+        {
+            numHits += batch.GetSample(i).hasHit;
+        }
+
+        return numHits;
+    };
+
+    CHECK(runBatch() == 256);
+
+    // The cell scratch is kept between frames, the shapes it held last time must not be cast against again
+    JPH::BodyIDVector bodyIDs;
+    joltState->physicsSystem.GetBodies(bodyIDs);
+    JPH::BodyInterface& bodyInterface = joltState->physicsSystem.GetBodyInterface();
+    bodyInterface.RemoveBodies(bodyIDs.data(), static_cast<i32>(bodyIDs.size()));
+    bodyInterface.DestroyBodies(bodyIDs.data(), static_cast<i32>(bodyIDs.size()));
+
+    CHECK(runBatch() == 0);
+}
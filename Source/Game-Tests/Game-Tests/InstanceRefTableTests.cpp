@@ -0,0 +1,308 @@
+#include "Game-Lib/Rendering/InstanceRefTable.h"
+
+#include <catch2/catch2.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using DrawRefs = std::vector<InstanceRefTable::DrawRef>;
+
+    // The rebuild CompactInstanceRefs used to do every time, kept here as the reference
+    std::vector<InstanceRef> RebuildRefs(const std::map<u32, DrawRefs>& instanceToDrawRefs, u32 numDraws, std::vector<InstanceRefTable::DrawRange>& outRanges)
+    {
+        std::vector<InstanceRef> refs;
+        outRanges.assign(numDraws, {});
+
+        for (u32 drawID = 0; drawID < numDraws; drawID++)
+        {
+            outRanges[drawID].offset = static_cast<u32>(refs.size());
+
+            for (const auto& [instanceID, drawRefs] : instanceToDrawRefs)
+            {
+                for (const InstanceRefTable::DrawRef& drawRef : drawRefs)
+                {
+                    if (drawRef.drawID != drawID)
+                        continue;
+
+                    refs.push_back({ instanceID, drawID, drawRef.extraID, 0 });
+                    outRanges[drawID].count++;
+                }
+            }
+        }
+
+        return refs;
+    }
+
+    std::vector<std::pair<u32, u32>> GetRangeContents(const std::vector<InstanceRef>& refs, const InstanceRefTable::DrawRange& range)
+    {
+        std::vector<std::pair<u32, u32>> contents;
+        for (u32 i = range.offset; i < range.offset + range.count; i++)
+        {
+            contents.push_back({ refs[i].instanceID, refs[i].extraID });
+        }
+
+        // Order within a draw is free, the GPU compacts per draw anyway
+        std::sort(contents.begin(), contents.end());
+        return contents;
+    }
+
+    DrawRefs MakeRandomDrawRefs(std::mt19937& rng, u32 numDraws)
+    {
+        std::uniform_int_distribution<u32> drawDistribution(0, numDraws - 1);
+        std::uniform_int_distribution<u32> countDistribution(0, 6);
+        std::uniform_int_distribution<u32> extraDistribution(0, 3);
+
+        DrawRefs drawRefs;
+        u32 numRefs = countDistribution(rng);
+        for (u32 i = 0; i < numRefs; i++)
+        {
+            u32 drawID = drawDistribution(rng);
+            bool isDuplicate = std::any_of(drawRefs.begin(), drawRefs.end(), [drawID](const InstanceRefTable::DrawRef& drawRef) { return drawRef.drawID == drawID; });
+            if (!isDuplicate)
+            {
+                drawRefs.push_back({ drawID, extraDistribution(rng) });
+            }
+        }
+
+        return drawRefs;
+    }
+}
+
+TEST_CASE("Instance ref table matches a full rebuild after random mutations", "[Rendering][InstanceRefTable]")
+{
+    std::mt19937 rng(4242);
+    std::uniform_int_distribution<u32> instanceDistribution(0, 199);
+    std::uniform_int_distribution<u32> operationDistribution(0, 19);
+
+    u32 numDraws = 8;
+
+    InstanceRefTable table;
+    table.SetNumDraws(numDraws);
+
+    std::map<u32, DrawRefs> instanceToDrawRefs;
+
+    // Mirrors the GPU buffer, only ever updated through the dirty slots and draws
+    std::vector<InstanceRef> uploadedRefs;
+    std::vector<InstanceRefTable::DrawRange> uploadedRanges;
+
+    for (u32 step = 0; step < 3000; step++)
+    {
+        u32 operation = operationDistribution(rng);
+        u32 instanceID = instanceDistribution(rng);
+
+        if (operation == 0)
+        {
+            // Models loading append draws
+            numDraws++;
+            table.SetNumDraws(numDraws);
+        }
+        else if (operation == 1)
+        {
+            table.Rebuild();
+        }
+        else if (operation <= 7)
+        {
+            instanceToDrawRefs.erase(instanceID);
+            table.RemoveInstance(instanceID);
+        }
+        else
+        {
+            DrawRefs drawRefs = MakeRandomDrawRefs(rng, numDraws);
+            instanceToDrawRefs[instanceID] = drawRefs;
+            table.SetInstanceRefs(instanceID, drawRefs);
+        }
+
+        uploadedRefs.resize(table.GetNumSlots());
+        uploadedRanges.resize(table.GetNumDraws());
+
+        if (table.IsFullyDirty())
+        {
+            uploadedRefs = table.GetRefs();
+            for (u32 drawID = 0; drawID < numDraws; drawID++)
+            {
+                uploadedRanges[drawID] = table.GetDrawRange(drawID);
+            }
+        }
+        else
+        {
+            for (u32 slot : table.GetDirtyRefSlots())
+            {
+                if (slot < table.GetNumSlots())
+                {
+                    uploadedRefs[slot] = table.GetRefs()[slot];
+                }
+            }
+
+            for (u32 drawID : table.GetDirtyDraws())
+            {
+                uploadedRanges[drawID] = table.GetDrawRange(drawID);
+            }
+        }
+
+        table.ResetDirty();
+
+        std::vector<InstanceRefTable::DrawRange> expectedRanges;
+        std::vector<InstanceRef> expectedRefs = RebuildRefs(instanceToDrawRefs, numDraws, expectedRanges);
+
+        REQUIRE(table.GetNumRefs() == expectedRefs.size());
+        REQUIRE(uploadedRanges.size() == numDraws);
+
+        for (u32 drawID = 0; drawID < numDraws; drawID++)
+        {
+            REQUIRE(uploadedRanges[drawID].count == expectedRanges[drawID].count);
+            REQUIRE(GetRangeContents(uploadedRefs, uploadedRanges[drawID]) == GetRangeContents(expectedRefs, expectedRanges[drawID]));
+        }
+
+        // Culling runs every slot, so anything outside the draw ranges has to be free
+        u32 numUsedSlots = 0;
+        for (const InstanceRef& ref : uploadedRefs)
+        {
+            if (ref.drawID == InstanceRefTable::FREE_SLOT_DRAW_ID)
+                continue;
+
+            const InstanceRefTable::DrawRange& range = uploadedRanges[ref.drawID];
+            REQUIRE(&ref - uploadedRefs.data() >= range.offset);
+            REQUIRE(&ref - uploadedRefs.data() < range.offset + range.count);
+            numUsedSlots++;
+        }
+        REQUIRE(numUsedSlots == expectedRefs.size());
+    }
+}
+
+TEST_CASE("Instance ref table updates refs in place when only the extra ID changes", "[Rendering][InstanceRefTable]")
+{
+    InstanceRefTable table;
+    table.SetNumDraws(4);
+
+    DrawRefs drawRefs = { { 1, 10 }, { 3, 30 } };
+    table.SetInstanceRefs(7, drawRefs);
+    table.SetInstanceRefs(8, drawRefs);
+    table.ResetDirty();
+
+    drawRefs[1].extraID = 31;
+    table.SetInstanceRefs(8, drawRefs);
+
+    // Nothing moved, so only the one ref and no draw ranges need uploading
+    REQUIRE(table.GetDirtyRefSlots().size() == 1);
+    CHECK(table.GetDirtyDraws().empty());
+    CHECK(table.GetRefs()[table.GetDirtyRefSlots()[0]].extraID == 31);
+}
+
+TEST_CASE("Instance ref table only touches the draw that changes", "[Rendering][InstanceRefTable]")
+{
+    InstanceRefTable table;
+    table.SetNumDraws(64);
+
+    for (u32 instanceID = 0; instanceID < 1000; instanceID++)
+    {
+        DrawRefs drawRefs = { { instanceID % 64, 0 } };
+        table.SetInstanceRefs(instanceID, drawRefs);
+    }
+    table.Rebuild();
+    table.ResetDirty();
+
+    // The rebuild left room to grow, so the new ref goes into a free slot of its own draw
+    u32 freeSlot = table.GetDrawRange(60).offset + table.GetDrawRange(60).count;
+
+    DrawRefs drawRefs = { { 60, 0 } };
+    table.SetInstanceRefs(5000, drawRefs);
+
+    CHECK(table.GetDirtyDraws() == std::vector<u32>{ 60 });
+    CHECK(table.GetDirtyRefSlots() == std::vector<u32>{ freeSlot });
+    table.ResetDirty();
+
+    table.RemoveInstance(5000);
+    CHECK(table.GetDirtyDraws() == std::vector<u32>{ 60 });
+    CHECK(table.GetDirtyRefSlots() == std::vector<u32>{ freeSlot });
+    CHECK(table.GetRefs()[freeSlot].drawID == InstanceRefTable::FREE_SLOT_DRAW_ID);
+    CHECK(table.GetDrawRange(60).count == 1000 / 64);
+    CHECK(table.GetNumRefs() == 1000);
+}
+
+TEST_CASE("Instance ref table only marks the slots it touches dirty", "[Rendering][InstanceRefTable]")
+{
+    InstanceRefTable table;
+    table.SetNumDraws(2);
+
+    for (u32 instanceID = 0; instanceID < 1000; instanceID++)
+    {
+        DrawRefs drawRefs = { { 0, 0 } };
+        table.SetInstanceRefs(instanceID, drawRefs);
+    }
+
+    DrawRefs drawRefs = { { 1, 0 } };
+    table.SetInstanceRefs(1000, drawRefs);
+    table.Rebuild();
+    table.ResetDirty();
+
+    // Removing a ref at the start of draw 0 swaps the last ref of draw 0 into it, the refs in between stay where they are
+    table.RemoveInstance(0);
+
+    std::vector<u32> dirtyRefSlots = table.GetDirtyRefSlots();
+    std::sort(dirtyRefSlots.begin(), dirtyRefSlots.end());
+    CHECK(dirtyRefSlots == std::vector<u32>{ 0, 999 });
+    CHECK(table.GetRefs()[0].instanceID == 999);
+    CHECK(table.GetRefs()[999].drawID == InstanceRefTable::FREE_SLOT_DRAW_ID);
+    CHECK(table.GetDirtyDraws() == std::vector<u32>{ 0 });
+
+    table.ResetDirty();
+    CHECK(table.GetDirtyRefSlots().empty());
+    CHECK(table.GetDirtyDraws().empty());
+
+    // A removed slot that comes back is listed once
+    u32 slot = table.GetDrawRange(1).offset + 1;
+    table.SetInstanceRefs(0, DrawRefs{ { 1, 0 } });
+    table.RemoveInstance(0);
+    table.SetInstanceRefs(0, DrawRefs{ { 1, 0 } });
+    CHECK(std::count(table.GetDirtyRefSlots().begin(), table.GetDirtyRefSlots().end(), slot) == 1);
+}
+
+TEST_CASE("Instance ref table moves a full draw into a block another draw left", "[Rendering][InstanceRefTable]")
+{
+    InstanceRefTable table;
+    table.SetNumDraws(3);
+
+    for (u32 instanceID = 0; instanceID < 8; instanceID++)
+    {
+        DrawRefs drawRefs = { { instanceID / 4, 0 } };
+        table.SetInstanceRefs(instanceID, drawRefs);
+    }
+
+    REQUIRE(table.GetDrawRange(0).offset == 0);
+    REQUIRE(table.GetDrawRange(0).capacity == InstanceRefTable::MIN_DRAW_CAPACITY);
+    REQUIRE(table.GetDrawRange(1).offset == 4);
+    table.ResetDirty();
+
+    // Draw 0 is full, it moves to a block twice the size at the end and leaves its old block free
+    table.SetInstanceRefs(100, DrawRefs{ { 0, 0 } });
+    CHECK(table.GetDirtyDraws() == std::vector<u32>{ 0 });
+    CHECK(table.GetDrawRange(0).offset == 8);
+    CHECK(table.GetDrawRange(0).count == 5);
+    CHECK(table.GetDrawRange(0).capacity == 8);
+    CHECK(table.GetDrawRange(1).offset == 4);
+
+    for (u32 slot = 0; slot < 4; slot++)
+    {
+        CHECK(table.GetRefs()[slot].drawID == InstanceRefTable::FREE_SLOT_DRAW_ID);
+    }
+
+    // Too small for draw 1 once it is full
+    table.SetInstanceRefs(101, DrawRefs{ { 1, 0 } });
+    CHECK(table.GetDrawRange(1).offset == 16);
+    CHECK(table.GetNumSlots() == 24);
+
+    // But a new draw fits, and so does the block draw 1 left right after it
+    table.SetInstanceRefs(102, DrawRefs{ { 2, 0 } });
+    CHECK(table.GetDrawRange(2).offset == 0);
+    CHECK(table.GetNumSlots() == 24);
+
+    table.Rebuild();
+    CHECK(table.IsFullyDirty());
+    CHECK(table.GetDrawRange(0).offset == 0);
+    CHECK(table.GetDrawRange(1).offset == table.GetDrawRange(0).capacity);
+    CHECK(table.GetNumRefs() == 11);
+}
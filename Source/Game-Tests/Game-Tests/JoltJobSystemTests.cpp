@@ -0,0 +1,134 @@
+#include "Game-Lib/ECS/Singletons/JoltState.h"
+#include "Game-Lib/Util/JoltJobSystem.h"
+
+#include <catch2/catch2.hpp>
+
+#include <enkiTS/TaskScheduler.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/RegisterTypes.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    void EnsureJoltInitialized()
+    {
+        if (JPH::Factory::sInstance != nullptr)
+            return;
+
+        JPH::RegisterDefaultAllocator();
+        JPH::Factory::sInstance = new JPH::Factory();
+        JPH::RegisterTypes();
+    }
+}
+
+TEST_CASE("Jolt jobs on enkiTS only run once their dependencies are done", "[Physics][JobSystem]")
+{
+    static constexpr u32 NumProducers = 64;
+
+    EnsureJoltInitialized();
+
+    enki::TaskScheduler taskScheduler;
+    taskScheduler.Initialize(4);
+
+    Util::JoltEnkiJobSystem jobSystem(&taskScheduler, JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
+    CHECK(jobSystem.GetMaxConcurrency() == 4);
+
+    for (u32 iteration = 0; iteration < 32; iteration++)
+    {
+        std::atomic<u32> numProduced = 0;
+        std::atomic<u32> numProducedWhenConsumed = 0;
+        std::atomic<u32> numConsumed = 0;
+
+        JPH::JobSystem::Barrier* barrier = jobSystem.CreateBarrier();
+
+        JPH::JobHandle consumer = jobSystem.CreateJob("Consumer", JPH::Color::sRed, [&]()
+        {
+            numProducedWhenConsumed = numProduced.load();
+            numConsumed++;
+        }, NumProducers);
+        barrier->AddJob(consumer);
+
+        std::vector<JPH::JobHandle> producers;
+        for (u32 i = 0; i < NumProducers; i++)
+        {
+            producers.push_back(jobSystem.CreateJob("Producer", JPH::Color::sGreen, [&numProduced, consumer]()
+            {
+                numProduced++;
+                consumer.RemoveDependency();
+            }));
+        }
+        barrier->AddJobs(producers.data(), static_cast<JPH::uint>(producers.size()));
+
+        jobSystem.WaitForJobs(barrier);
+        jobSystem.DestroyBarrier(barrier);
+
+        INFO("iteration " << iteration);
+        CHECK(numConsumed == 1);
+        CHECK(numProduced == NumProducers);
+        CHECK(numProducedWhenConsumed == NumProducers);
+        CHECK(consumer.IsDone());
+    }
+}
+
+TEST_CASE("Physics steps on enkiTS settle like they do on the thread pool", "[Physics][JobSystem]")
+{
+    EnsureJoltInitialized();
+
+    enki::TaskScheduler taskScheduler;
+    taskScheduler.Initialize(4);
+
+    // Boxes dropped on a floor have to come to rest on top of it whichever job system runs the step
+    auto dropBoxes = [&taskScheduler](bool useEnkiJobSystem)
+    {
+        std::unique_ptr<ECS::Singletons::JoltState> joltState = std::make_unique<ECS::Singletons::JoltState>();
+        joltState->CreateJobSystem(useEnkiJobSystem ? &taskScheduler : nullptr);
+        joltState->physicsSystem.Init(Jolt::Settings::maxBodies, Jolt::Settings::numBodyMutexes, Jolt::Settings::maxBodyPairs, Jolt::Settings::maxContactConstraints, joltState->broadPhaseLayerInterface, joltState->objectVSBroadPhaseLayerFilter, joltState->objectVSObjectLayerFilter);
+
+        JPH::BodyInterface& bodyInterface = joltState->physicsSystem.GetBodyInterface();
+
+        JPH::BodyCreationSettings floorSettings(new JPH::BoxShape(JPH::Vec3(100.0f, 1.0f, 100.0f)), JPH::RVec3(0.0f, -1.0f, 0.0f), JPH::Quat::sIdentity(), JPH::EMotionType::Static, Jolt::Layers::NON_MOVING);
+        bodyInterface.CreateAndAddBody(floorSettings, JPH::EActivation::DontActivate);
+
+        std::vector<JPH::BodyID> boxIDs;
+        for (u32 x = 0; x < 16; x++)
+        {
+            for (u32 z = 0; z < 16; z++)
+            {
+                JPH::BodyCreationSettings boxSettings(new JPH::BoxShape(JPH::Vec3(0.5f, 0.5f, 0.5f)), JPH::RVec3(static_cast<f32>(x) * 3.0f - 24.0f, 2.0f, static_cast<f32>(z) * 3.0f - 24.0f), JPH::Quat::sIdentity(), JPH::EMotionType::Dynamic, Jolt::Layers::MOVING);
+                boxIDs.push_back(bodyInterface.CreateAndAddBody(boxSettings, JPH::EActivation::Activate));
+            }
+        }
+
+        for (u32 step = 0; step < 120; step++)
+        {
+            JPH::EPhysicsUpdateError error = joltState->physicsSystem.Update(ECS::Singletons::JoltState::FixedDeltaTime, 1, &joltState->allocator, joltState->jobSystem.get());
+            REQUIRE(error == JPH::EPhysicsUpdateError::None);
+        }
+
+        std::vector<f32> heights;
+        for (JPH::BodyID boxID : boxIDs)
+        {
+            heights.push_back(bodyInterface.GetCenterOfMassPosition(boxID).GetY());
+        }
+
+        return heights;
+    };
+
+    std::vector<f32> threadPoolHeights = dropBoxes(false);
+    std::vector<f32> enkiHeights = dropBoxes(true);
+    REQUIRE(threadPoolHeights.size() == enkiHeights.size());
+
+    for (size_t i = 0; i < enkiHeights.size(); i++)
+    {
+        INFO("box " << i);
+        CHECK(threadPoolHeights[i] == Approx(0.5f).margin(0.02f));
+        CHECK(enkiHeights[i] == Approx(0.5f).margin(0.02f));
+    }
+}
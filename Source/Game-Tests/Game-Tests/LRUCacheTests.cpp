@@ -0,0 +1,120 @@
+#include "Game-Lib/Util/LRUCache.h"
+
+#include <catch2/catch2.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+    using Cache = Util::LRUCache<u64, std::unique_ptr<u32>>;
+
+    std::vector<u64> GetKeysInOrder(const Cache& cache)
+    {
+        std::vector<u64> keys;
+        cache.ForEach([&keys](u64 key, const std::unique_ptr<u32>&) { keys.push_back(key); });
+        return keys;
+    }
+}
+
+TEST_CASE("LRU cache evicts the least recently used entries first", "[Util][LRUCache]")
+{
+    Cache cache(300);
+
+    REQUIRE(cache.Put(1, std::make_unique<u32>(10), 100));
+    REQUIRE(cache.Put(2, std::make_unique<u32>(20), 100));
+    REQUIRE(cache.Put(3, std::make_unique<u32>(30), 100));
+    CHECK(GetKeysInOrder(cache) == std::vector<u64>{ 3, 2, 1 });
+
+    SECTION("A lookup moves the entry to the front")
+    {
+        REQUIRE(cache.Get(1) != nullptr);
+        CHECK(GetKeysInOrder(cache) == std::vector<u64>{ 1, 3, 2 });
+
+        REQUIRE(cache.Put(4, std::make_unique<u32>(40), 100));
+        CHECK(GetKeysInOrder(cache) == std::vector<u64>{ 4, 1, 3 });
+        CHECK_FALSE(cache.Contains(2));
+        CHECK(**cache.Get(1) == 10);
+    }
+
+    SECTION("Peek leaves the order alone")
+    {
+        REQUIRE(cache.Peek(1) != nullptr);
+        REQUIRE(cache.Put(4, std::make_unique<u32>(40), 100));
+        CHECK(GetKeysInOrder(cache) == std::vector<u64>{ 4, 3, 2 });
+    }
+
+    SECTION("A large entry evicts as many entries as it needs")
+    {
+        REQUIRE(cache.Put(4, std::make_unique<u32>(40), 250));
+        CHECK(GetKeysInOrder(cache) == std::vector<u64>{ 4 });
+        CHECK(cache.GetStats().numEvictions == 3);
+    }
+
+    SECTION("Putting an existing key replaces it")
+    {
+        REQUIRE(cache.Put(1, std::make_unique<u32>(11), 50));
+        CHECK(GetKeysInOrder(cache) == std::vector<u64>{ 1, 3, 2 });
+        CHECK(**cache.Get(1) == 11);
+        CHECK(cache.GetNumBytes() == 250);
+    }
+}
+
+TEST_CASE("LRU cache stays within its byte budget", "[Util][LRUCache]")
+{
+    Cache cache(1000);
+
+    for (u64 key = 0; key < 64; key++)
+    {
+        cache.Put(key, std::make_unique<u32>(static_cast<u32>(key)), 30 + (key % 7) * 20);
+        CHECK(cache.GetNumBytes() <= cache.GetBudget());
+    }
+
+    SECTION("Entries larger than the whole budget are not stored")
+    {
+        u32 numEntries = cache.GetNumEntries();
+        CHECK_FALSE(cache.Put(100, std::make_unique<u32>(100), 1001));
+        CHECK_FALSE(cache.Contains(100));
+        CHECK(cache.GetNumEntries() == numEntries);
+    }
+
+    SECTION("Lowering the budget evicts down to it")
+    {
+        cache.SetBudget(200);
+        CHECK(cache.GetNumBytes() <= 200);
+        CHECK(cache.Contains(63));
+
+        cache.SetBudget(0);
+        CHECK(cache.GetNumEntries() == 0);
+        CHECK(cache.GetNumBytes() == 0);
+    }
+
+    SECTION("Clear keeps the budget and the stats")
+    {
+        u64 numEvictions = cache.GetStats().numEvictions;
+        cache.Clear();
+
+        CHECK(cache.GetNumEntries() == 0);
+        CHECK(cache.GetBudget() == 1000);
+        CHECK(cache.GetStats().numEvictions == numEvictions);
+    }
+}
+
+TEST_CASE("LRU cache counts hits and misses", "[Util][LRUCache]")
+{
+    Cache cache(100);
+    cache.Put(1, std::make_unique<u32>(1), 10);
+
+    cache.Get(1);
+    cache.Get(1);
+    cache.Get(2);
+    cache.Peek(2);
+
+    Cache::Stats stats = cache.GetStats();
+    CHECK(stats.numHits == 2);
+    CHECK(stats.numMisses == 1);
+    CHECK(stats.GetHitRate() == Approx(2.0f / 3.0f));
+
+    cache.ResetStats();
+    CHECK(cache.GetStats().GetHitRate() == 0.0f);
+}
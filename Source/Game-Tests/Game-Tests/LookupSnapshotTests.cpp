@@ -0,0 +1,380 @@
+#include "Game-Lib/Application/EnttRegistries.h"
+#include "Game-Lib/ECS/Singletons/Database/ClientDBSingleton.h"
+#include "Game-Lib/ECS/Singletons/Database/SpellSingleton.h"
+#include "Game-Lib/ECS/Singletons/Database/TextureSingleton.h"
+#include "Game-Lib/ECS/Util/Database/SpellUtil.h"
+#include "Game-Lib/ECS/Util/Database/TextureUtil.h"
+#include "Game-Lib/Util/AssetWriter.h"
+#include "Game-Lib/Util/LookupSnapshot.h"
+#include "Game-Lib/Util/ServiceLocator.h"
+
+#include <MetaGen/Shared/ClientDB/ClientDB.h>
+
+#include <catch2/catch2.hpp>
+
+#include <entt/entt.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    static constexpr u32 SCHEMA_VERSION = 3;
+    static constexpr u64 SOURCE_HASH = 0x1234ABCD5678EF00;
+
+    struct EffectMapping
+    {
+    public:
+        u32 itemID;
+        u32 indexIntoMap;
+        u32 count;
+    };
+
+    class TemporarySnapshotPath
+    {
+    public:
+        TemporarySnapshotPath()
+        {
+            _directory = std::filesystem::temp_directory_path() /
+                ("novus-snapshot-" + std::to_string(
+                    std::chrono::steady_clock::now().time_since_epoch().count()));
+            _path = _directory / "Cache" / "Lookups.snapshot";
+        }
+
+        ~TemporarySnapshotPath()
+        {
+            std::error_code errorCode;
+            std::filesystem::remove_all(_directory, errorCode);
+        }
+
+        const std::filesystem::path& Get() const { return _path; }
+
+    private:
+        std::filesystem::path _directory;
+        std::filesystem::path _path;
+    };
+
+    // Stand in for the derivation a cold boot does from the ClientDBs
+    struct Lookups
+    {
+    public:
+        robin_hood::unordered_set<u32> itemIDs;
+        robin_hood::unordered_map<u32, u32> itemIDToTemplateID;
+        std::vector<EffectMapping> effectMappings;
+        std::vector<u32> effectIDs;
+    };
+
+    Lookups BuildLookups()
+    {
+        Lookups lookups;
+        for (u32 itemID = 1; itemID < 5000; itemID++)
+        {
+            lookups.itemIDs.insert(itemID);
+
+            if (itemID % 3 == 0)
+                lookups.itemIDToTemplateID[itemID] = itemID * 7;
+
+            if (itemID % 11 == 0)
+            {
+                u32 index = static_cast<u32>(lookups.effectIDs.size());
+                lookups.effectMappings.push_back({ itemID, index, 2 });
+                lookups.effectIDs.push_back(itemID * 2);
+                lookups.effectIDs.push_back(itemID * 2 + 1);
+            }
+        }
+
+        return lookups;
+    }
+
+    bool SaveLookups(const Lookups& lookups, const std::filesystem::path& path, u32 schemaVersion = SCHEMA_VERSION, u64 sourceHash = SOURCE_HASH)
+    {
+        Util::LookupSnapshot::Writer writer(schemaVersion, sourceHash);
+        writer.AddSet(0, lookups.itemIDs);
+        writer.AddMap(1, lookups.itemIDToTemplateID);
+        writer.AddArray<EffectMapping>(2, lookups.effectMappings);
+        writer.AddArray<u32>(3, lookups.effectIDs);
+        return writer.Save(path);
+    }
+
+    bool LoadLookups(Lookups& lookups, const std::filesystem::path& path, u32 schemaVersion = SCHEMA_VERSION, u64 sourceHash = SOURCE_HASH)
+    {
+        Util::LookupSnapshot::Reader reader;
+        if (!reader.Load(path, schemaVersion, sourceHash))
+            return false;
+
+        std::span<const EffectMapping> effectMappings;
+        std::span<const u32> effectIDs;
+        if (!reader.ReadSet(0, lookups.itemIDs) || !reader.ReadMap(1, lookups.itemIDToTemplateID) || !reader.GetArray(2, effectMappings) || !reader.GetArray(3, effectIDs))
+            return false;
+
+        lookups.effectMappings.assign(effectMappings.begin(), effectMappings.end());
+        lookups.effectIDs.assign(effectIDs.begin(), effectIDs.end());
+        return true;
+    }
+
+    // The Refresh functions find the DBs and the data directory through the ServiceLocator, which can only be set up once per process
+    class DatabaseEnvironment
+    {
+    public:
+        static DatabaseEnvironment& Get()
+        {
+            static DatabaseEnvironment environment;
+            return environment;
+        }
+
+        // Drops the lookups and DBs of the previous test along with any snapshots it wrote
+        ECS::Singletons::ClientDBSingleton& Reset()
+        {
+            auto& ctx = _dbRegistry.ctx();
+            ctx.erase<ECS::Singletons::SpellSingleton>();
+            ctx.erase<ECS::Singletons::TextureSingleton>();
+            ctx.erase<ECS::Singletons::ClientDBSingleton>();
+
+            std::error_code errorCode;
+            std::filesystem::remove_all(GetCacheDirectory(), errorCode);
+
+            return ctx.emplace<ECS::Singletons::ClientDBSingleton>();
+        }
+
+        entt::registry::context& GetContext() { return _dbRegistry.ctx(); }
+        std::filesystem::path GetCacheDirectory() const { return _snapshotDirectory.Get().parent_path(); }
+
+    private:
+        DatabaseEnvironment()
+        {
+            _registries.dbRegistry = &_dbRegistry;
+            ServiceLocator::SetEnttRegistries(&_registries);
+
+            // TemporarySnapshotPath points at <root>/Cache/Lookups.snapshot, so <root> stands in for the data directory
+            std::filesystem::path dataDirectory = GetCacheDirectory().parent_path();
+            _assetWriter.Init(Util::AssetWriterConfig{ .diskRoot = dataDirectory, .pactOverlayRoot = dataDirectory / "Overlay" });
+            ServiceLocator::SetAssetWriter(&_assetWriter);
+        }
+
+    private:
+        TemporarySnapshotPath _snapshotDirectory;
+        EnttRegistries _registries = { };
+        entt::registry _dbRegistry;
+        Util::AssetWriter _assetWriter;
+    };
+
+    // Registers a DB as if DiscoverAll had read it from a file with the given content
+    template <typename T>
+    ClientDB::Data* RegisterLoadedDB(ECS::Singletons::ClientDBSingleton& clientDBSingleton, ClientDBHash dbHash, u64 contentHash)
+    {
+        clientDBSingleton.Register<T>();
+        clientDBSingleton.SetContentHash(dbHash, contentHash);
+        return clientDBSingleton.Get(dbHash);
+    }
+
+    void MarkLoaded(ECS::Singletons::ClientDBSingleton& clientDBSingleton)
+    {
+        clientDBSingleton.Each([](ClientDBHash, ClientDB::Data* db)
+        {
+            db->ClearDirty();
+        });
+    }
+
+    void AddSpellEffect(ClientDB::Data* storage, u32 id, u32 spellID, u8 effectPriority)
+    {
+        MetaGen::Shared::ClientDB::SpellEffectsRecord spellEffect;
+        spellEffect.spellID = spellID;
+        spellEffect.effectPriority = effectPriority;
+        spellEffect.effectType = 0;
+        spellEffect.parameters = { 0 };
+
+        storage->Replace(id, spellEffect);
+    }
+
+    void SetupSpellDBs(ECS::Singletons::ClientDBSingleton& clientDBSingleton)
+    {
+        RegisterLoadedDB<MetaGen::Shared::ClientDB::SpellRecord>(clientDBSingleton, ClientDBHash::Spell, 1);
+        RegisterLoadedDB<MetaGen::Shared::ClientDB::SpellAuraRecord>(clientDBSingleton, ClientDBHash::SpellAura, 2);
+        ClientDB::Data* spellEffectsStorage = RegisterLoadedDB<MetaGen::Shared::ClientDB::SpellEffectsRecord>(clientDBSingleton, ClientDBHash::SpellEffects, 3);
+
+        u32 spellEffectID = 1;
+        for (u32 spellID = 1; spellID < 200; spellID++)
+        {
+            u32 numEffects = (spellID % 3) + 1;
+            for (u32 i = 0; i < numEffects; i++)
+            {
+                AddSpellEffect(spellEffectsStorage, spellEffectID++, spellID, static_cast<u8>((spellID * 7 + i * 5) % 4));
+            }
+        }
+
+        MarkLoaded(clientDBSingleton);
+    }
+
+    void SetupTextureDBs(ECS::Singletons::ClientDBSingleton& clientDBSingleton)
+    {
+        ClientDB::Data* textureFileDataStorage = RegisterLoadedDB<MetaGen::Shared::ClientDB::TextureFileDataRecord>(clientDBSingleton, ClientDBHash::TextureFileData, 4);
+
+        for (u32 id = 1; id < 600; id++)
+        {
+            MetaGen::Shared::ClientDB::TextureFileDataRecord textureFileData;
+            textureFileData.materialResourcesID = id / 3;
+            textureFileData.texture = textureFileDataStorage->AddString("textures/test/" + std::to_string(id) + ".dds");
+
+            textureFileDataStorage->Replace(id, textureFileData);
+        }
+
+        MarkLoaded(clientDBSingleton);
+    }
+
+    std::vector<char> ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void WriteFile(const std::filesystem::path& path, const std::vector<char>& data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), data.size());
+    }
+}
+
+TEST_CASE("Lookup snapshot loads back exactly what a cold build produced", "[Util][LookupSnapshot]")
+{
+    TemporarySnapshotPath path;
+    Lookups cold = BuildLookups();
+    REQUIRE(SaveLookups(cold, path.Get()));
+
+    Lookups warm;
+    REQUIRE(LoadLookups(warm, path.Get()));
+
+    CHECK(warm.itemIDs == cold.itemIDs);
+    CHECK(warm.itemIDToTemplateID == cold.itemIDToTemplateID);
+    CHECK(warm.effectIDs == cold.effectIDs);
+    REQUIRE(warm.effectMappings.size() == cold.effectMappings.size());
+    for (size_t i = 0; i < cold.effectMappings.size(); i++)
+    {
+        CHECK(warm.effectMappings[i].itemID == cold.effectMappings[i].itemID);
+        CHECK(warm.effectMappings[i].indexIntoMap == cold.effectMappings[i].indexIntoMap);
+        CHECK(warm.effectMappings[i].count == cold.effectMappings[i].count);
+    }
+}
+
+TEST_CASE("Lookup snapshot is deterministic for the same sources", "[Util][LookupSnapshot]")
+{
+    TemporarySnapshotPath first;
+    TemporarySnapshotPath second;
+
+    Lookups lookups = BuildLookups();
+    REQUIRE(SaveLookups(lookups, first.Get()));
+
+    // Rebuilding the sets in a different insertion order must not change the file
+    Lookups reordered;
+    for (auto it = lookups.itemIDs.begin(); it != lookups.itemIDs.end(); ++it)
+        reordered.itemIDs.insert(*it);
+    reordered.itemIDToTemplateID = lookups.itemIDToTemplateID;
+    reordered.effectMappings = lookups.effectMappings;
+    reordered.effectIDs = lookups.effectIDs;
+    REQUIRE(SaveLookups(reordered, second.Get()));
+
+    CHECK(ReadFile(first.Get()) == ReadFile(second.Get()));
+}
+
+TEST_CASE("Lookup snapshot rejects stale or damaged files", "[Util][LookupSnapshot]")
+{
+    TemporarySnapshotPath path;
+    REQUIRE(SaveLookups(BuildLookups(), path.Get()));
+
+    Lookups lookups;
+
+    SECTION("Missing file")
+    {
+        std::filesystem::remove(path.Get());
+        CHECK_FALSE(LoadLookups(lookups, path.Get()));
+    }
+
+    SECTION("Source DBs changed")
+    {
+        CHECK_FALSE(LoadLookups(lookups, path.Get(), SCHEMA_VERSION, SOURCE_HASH + 1));
+    }
+
+    SECTION("Schema changed")
+    {
+        CHECK_FALSE(LoadLookups(lookups, path.Get(), SCHEMA_VERSION + 1, SOURCE_HASH));
+    }
+
+    SECTION("Corrupted payload")
+    {
+        std::vector<char> data = ReadFile(path.Get());
+        data[data.size() - 16] ^= 0x5A;
+        WriteFile(path.Get(), data);
+
+        CHECK_FALSE(LoadLookups(lookups, path.Get()));
+    }
+
+    SECTION("Truncated file")
+    {
+        std::vector<char> data = ReadFile(path.Get());
+        data.resize(data.size() / 2);
+        WriteFile(path.Get(), data);
+
+        CHECK_FALSE(LoadLookups(lookups, path.Get()));
+    }
+
+    SECTION("Truncated header")
+    {
+        std::vector<char> data = ReadFile(path.Get());
+        data.resize(sizeof(Util::LookupSnapshot::FileHeader) - 4);
+        WriteFile(path.Get(), data);
+
+        CHECK_FALSE(LoadLookups(lookups, path.Get()));
+    }
+}
+
+TEST_CASE("Spell lookups reloaded from their snapshot match a cold Refresh", "[Util][LookupSnapshot]")
+{
+    DatabaseEnvironment& environment = DatabaseEnvironment::Get();
+    auto& clientDBSingleton = environment.Reset();
+    SetupSpellDBs(clientDBSingleton);
+
+    REQUIRE(ECSUtil::Spell::Refresh());
+    auto cold = environment.GetContext().get<ECS::Singletons::SpellSingleton>().spellIDToEffectList;
+    REQUIRE(cold.size() > 1);
+    REQUIRE(std::filesystem::exists(environment.GetCacheDirectory() / "SpellLookups.snapshot"));
+
+    // Reordering effects without touching the content hash would change a rebuild, so matching the cold boot proves the reload came from the snapshot
+    ClientDB::Data* spellEffectsStorage = clientDBSingleton.Get(ClientDBHash::SpellEffects);
+    AddSpellEffect(spellEffectsStorage, 2, 1, 200);
+    MarkLoaded(clientDBSingleton);
+
+    REQUIRE(ECSUtil::Spell::Refresh());
+    CHECK(environment.GetContext().get<ECS::Singletons::SpellSingleton>().spellIDToEffectList == cold);
+
+    SECTION("Edited sources are rebuilt instead of loaded")
+    {
+        spellEffectsStorage->MarkDirty();
+
+        REQUIRE(ECSUtil::Spell::Refresh());
+        CHECK(environment.GetContext().get<ECS::Singletons::SpellSingleton>().spellIDToEffectList != cold);
+    }
+}
+
+TEST_CASE("Texture lookups reloaded from their snapshot match a cold Refresh", "[Util][LookupSnapshot]")
+{
+    DatabaseEnvironment& environment = DatabaseEnvironment::Get();
+    auto& clientDBSingleton = environment.Reset();
+    SetupTextureDBs(clientDBSingleton);
+
+    auto& ctx = environment.GetContext();
+    ctx.emplace<ECS::Singletons::TextureSingleton>();
+
+    REQUIRE(ECSUtil::Texture::Refresh());
+    auto cold = ctx.get<ECS::Singletons::TextureSingleton>().materialResourcesIDToTextureHashes;
+    REQUIRE(cold.size() > 1);
+    REQUIRE(std::filesystem::exists(environment.GetCacheDirectory() / "TextureLookups.snapshot"));
+
+    // A fresh singleton so nothing from the cold Refresh can leak into the reload
+    ctx.erase<ECS::Singletons::TextureSingleton>();
+    ctx.emplace<ECS::Singletons::TextureSingleton>();
+
+    REQUIRE(ECSUtil::Texture::Refresh());
+    CHECK(ctx.get<ECS::Singletons::TextureSingleton>().materialResourcesIDToTextureHashes == cold);
+}
@@ -0,0 +1,326 @@
+#include "Game-Lib/ECS/Util/MessageBuilderUtil.h"
+#include "Game-Lib/ECS/Util/Network/MessageDispatchQueue.h"
+
+#include <Base/Memory/Bytebuffer.h>
+
+#include <MetaGen/Shared/Packet/Packet.h>
+
+#include <Network/Define.h>
+
+#include <catch2/catch2.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Fields = std::vector<std::pair<u16, u32>>;
+
+    constexpr u32 NUM_UNITS = 16;
+    constexpr ::Network::OpcodeType MOVE_OPCODE = MetaGen::Shared::Packet::ServerUnitMovePacket::PACKET_ID;
+    constexpr ::Network::OpcodeType NETFIELD_OPCODE = MetaGen::Shared::Packet::ServerUnitNetFieldUpdatePacket::PACKET_ID;
+    constexpr ::Network::OpcodeType TELEPORT_OPCODE = MetaGen::Shared::Packet::ServerUnitTeleportPacket::PACKET_ID;
+    constexpr ::Network::OpcodeType OTHER_OPCODE = MetaGen::Shared::Packet::ServerUnitAddPacket::PACKET_ID;
+
+    ObjectGUID GetUnitGUID(u32 unitIndex)
+    {
+        return ObjectGUID::CreatePlayer(unitIndex + 1);
+    }
+
+    u32 GetUnitIndex(const ObjectGUID& guid)
+    {
+        for (u32 i = 0; i < NUM_UNITS; i++)
+        {
+            if (GetUnitGUID(i) == guid)
+                return i;
+        }
+
+        FAIL("Unknown unit GUID");
+        return 0;
+    }
+
+    // Only the GUID leads like the real packets, the rest is whatever the model below needs
+    std::shared_ptr<Bytebuffer> BuildUnitMessage(::Network::OpcodeType opcode, u32 unitIndex, const std::vector<u32>& payload)
+    {
+        std::shared_ptr<Bytebuffer> buffer = Bytebuffer::BorrowRuntime(64);
+        bool result = ECS::Util::MessageBuilder::CreatePacket(buffer, opcode, [&]()
+        {
+            buffer->Serialize(GetUnitGUID(unitIndex));
+            for (u32 value : payload)
+            {
+                buffer->PutU32(value);
+            }
+        });
+
+        REQUIRE(result);
+        return buffer;
+    }
+
+    std::shared_ptr<Bytebuffer> BuildMoveMessage(u32 unitIndex, u32 position, u32 pitch, u32 yaw)
+    {
+        return BuildUnitMessage(MOVE_OPCODE, unitIndex, { position, pitch, yaw });
+    }
+
+    std::shared_ptr<Bytebuffer> BuildNetFieldMessage(u32 unitIndex, const Fields& fields)
+    {
+        std::shared_ptr<Bytebuffer> buffer = Bytebuffer::BorrowRuntime(512);
+        REQUIRE(ECS::Util::MessageBuilder::Unit::BuildUnitNetFieldUpdateMessage(buffer, GetUnitGUID(unitIndex), fields));
+        return buffer;
+    }
+
+    struct UnitState
+    {
+    public:
+        u32 position = 0;
+        u32 pitch = 0;
+        u32 yaw = 0;
+        std::map<u16, u32> fields;
+
+        bool operator==(const UnitState&) const = default;
+    };
+
+    // Stands in for the handlers. Moves set the whole transform, teleports set position and yaw but keep the pitch of
+    // the last move like HandleOnUnitTeleport does. Teleports and other messages record their unit as they saw it
+    struct ModelState
+    {
+    public:
+        void Apply(const ::Network::Message& message)
+        {
+            Bytebuffer* buffer = message.buffer.get();
+
+            ::Network::MessageHeader header;
+            REQUIRE(buffer->Get(header));
+
+            if (header.opcode == NETFIELD_OPCODE)
+            {
+                buffer->readData = 0;
+
+                ObjectGUID guid;
+                Fields fields;
+                REQUIRE(ECS::Util::Network::MessageDispatchQueue::PeekUnitNetFieldUpdate(message, guid, fields));
+
+                for (const auto& [fieldID, value] : fields)
+                {
+                    units[GetUnitIndex(guid)].fields[fieldID] = value;
+                }
+
+                return;
+            }
+
+            ObjectGUID guid;
+            REQUIRE(buffer->Deserialize(guid));
+
+            UnitState& unit = units[GetUnitIndex(guid)];
+            if (header.opcode == MOVE_OPCODE)
+            {
+                REQUIRE(buffer->GetU32(unit.position));
+                REQUIRE(buffer->GetU32(unit.pitch));
+                REQUIRE(buffer->GetU32(unit.yaw));
+                return;
+            }
+
+            u32 messageID = 0;
+            REQUIRE(buffer->GetU32(messageID));
+
+            if (header.opcode == TELEPORT_OPCODE)
+            {
+                REQUIRE(buffer->GetU32(unit.position));
+                REQUIRE(buffer->GetU32(unit.yaw));
+            }
+
+            observations.push_back({ messageID, unit });
+        }
+
+    public:
+        std::map<u32, UnitState> units;
+        std::vector<std::pair<u32, UnitState>> observations;
+    };
+
+    std::vector<std::shared_ptr<Bytebuffer>> BuildStream(u32 seed, u32 numMessages)
+    {
+        std::mt19937 random(seed);
+        std::vector<std::shared_ptr<Bytebuffer>> stream;
+        stream.reserve(numMessages);
+
+        for (u32 i = 0; i < numMessages; i++)
+        {
+            u32 unitIndex = random() % NUM_UNITS;
+            u32 kind = random() % 10;
+
+            if (kind < 5)
+            {
+                stream.push_back(BuildMoveMessage(unitIndex, random(), random(), random()));
+            }
+            else if (kind < 9)
+            {
+                Fields fields;
+                u32 numFields = 1 + (random() % 3);
+                for (u32 j = 0; j < numFields; j++)
+                {
+                    fields.push_back({ static_cast<u16>(random() % 64), static_cast<u32>(random()) });
+                }
+
+                std::sort(fields.begin(), fields.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+                fields.erase(std::unique(fields.begin(), fields.end(), [](const auto& a, const auto& b) { return a.first == b.first; }), fields.end());
+
+                stream.push_back(BuildNetFieldMessage(unitIndex, fields));
+            }
+            else if (random() % 2 == 0)
+            {
+                stream.push_back(BuildUnitMessage(TELEPORT_OPCODE, unitIndex, { i, static_cast<u32>(random()), static_cast<u32>(random()) }));
+            }
+            else
+            {
+                stream.push_back(BuildUnitMessage(OTHER_OPCODE, unitIndex, { i }));
+            }
+        }
+
+        return stream;
+    }
+
+    ::Network::SocketMessageEvent MakeEvent(std::shared_ptr<Bytebuffer> buffer)
+    {
+        ::Network::SocketMessageEvent messageEvent;
+        messageEvent.message.buffer = std::move(buffer);
+        return messageEvent;
+    }
+}
+
+TEST_CASE("Budgeted and coalesced dispatch ends in the same state as dispatching everything", "[Network][MessageDispatchQueue]")
+{
+    constexpr u32 NumMessages = 4000;
+    u32 seed = GENERATE(1u, 7u, 1337u);
+
+    ModelState expected;
+    for (std::shared_ptr<Bytebuffer>& buffer : BuildStream(seed, NumMessages))
+    {
+        expected.Apply(MakeEvent(buffer).message);
+    }
+
+    // Messages arrive in bursts while only a few are dispatched per frame, so plenty of them wait long enough to be coalesced
+    std::vector<std::shared_ptr<Bytebuffer>> stream = BuildStream(seed, NumMessages);
+    std::mt19937 frameRandom(seed ^ 0x5bd1e995u);
+
+    ECS::Util::Network::MessageDispatchQueue queue;
+    ModelState actual;
+
+    size_t nextMessage = 0;
+    ::Network::SocketMessageEvent messageEvent;
+    while (nextMessage < stream.size() || queue.GetNumQueued() > 0)
+    {
+        u32 numArrived = frameRandom() % 24;
+        for (u32 i = 0; i < numArrived && nextMessage < stream.size(); i++)
+        {
+            messageEvent = MakeEvent(stream[nextMessage++]);
+            queue.Push(messageEvent);
+        }
+
+        u32 budget = 1 + (frameRandom() % 8);
+        for (u32 i = 0; i < budget && queue.TryPop(messageEvent); i++)
+        {
+            actual.Apply(messageEvent.message);
+        }
+    }
+
+    CHECK_FALSE(queue.TryPop(messageEvent));
+    CHECK(queue.GetNumCoalesced() > 0);
+
+    CHECK(actual.units == expected.units);
+    CHECK(actual.observations == expected.observations);
+}
+
+TEST_CASE("Only the newest unit move is dispatched, at its own place in the queue", "[Network][MessageDispatchQueue]")
+{
+    ECS::Util::Network::MessageDispatchQueue queue;
+
+    ::Network::SocketMessageEvent messageEvent = MakeEvent(BuildMoveMessage(0, 1, 10, 100));
+    queue.Push(messageEvent);
+    messageEvent = MakeEvent(BuildMoveMessage(1, 2, 20, 200));
+    queue.Push(messageEvent);
+    messageEvent = MakeEvent(BuildMoveMessage(0, 3, 30, 300));
+    queue.Push(messageEvent);
+
+    CHECK(queue.GetNumQueued() == 2);
+    CHECK(queue.GetNumCoalesced() == 1);
+
+    ModelState state;
+    REQUIRE(queue.TryPop(messageEvent));
+    state.Apply(messageEvent.message);
+    CHECK(state.units.size() == 1);
+    CHECK(state.units[1] == UnitState{ .position = 2, .pitch = 20, .yaw = 200 });
+
+    REQUIRE(queue.TryPop(messageEvent));
+    state.Apply(messageEvent.message);
+    CHECK(state.units[0] == UnitState{ .position = 3, .pitch = 30, .yaw = 300 });
+
+    CHECK_FALSE(queue.TryPop(messageEvent));
+}
+
+TEST_CASE("Unit moves are not dropped across other messages", "[Network][MessageDispatchQueue]")
+{
+    ECS::Util::Network::MessageDispatchQueue queue;
+
+    // The teleport keeps the pitch of the move before it, dropping that move would change what it ends up with
+    ::Network::SocketMessageEvent messageEvent = MakeEvent(BuildMoveMessage(0, 1, 10, 100));
+    queue.Push(messageEvent);
+    messageEvent = MakeEvent(BuildUnitMessage(TELEPORT_OPCODE, 0, { 0, 5, 50 }));
+    queue.Push(messageEvent);
+    messageEvent = MakeEvent(BuildMoveMessage(0, 3, 30, 300));
+    queue.Push(messageEvent);
+
+    CHECK(queue.GetNumQueued() == 3);
+    CHECK(queue.GetNumCoalesced() == 0);
+
+    ModelState state;
+    while (queue.TryPop(messageEvent))
+    {
+        state.Apply(messageEvent.message);
+    }
+
+    REQUIRE(state.observations.size() == 1);
+    CHECK(state.observations[0].second == UnitState{ .position = 5, .pitch = 10, .yaw = 50 });
+    CHECK(state.units[0] == UnitState{ .position = 3, .pitch = 30, .yaw = 300 });
+}
+
+TEST_CASE("Unit netfield updates are not merged across other messages", "[Network][MessageDispatchQueue]")
+{
+    ECS::Util::Network::MessageDispatchQueue queue;
+
+    ::Network::SocketMessageEvent messageEvent = MakeEvent(BuildNetFieldMessage(0, { { 3, 10 }, { 40, 11 } }));
+    queue.Push(messageEvent);
+    messageEvent = MakeEvent(BuildNetFieldMessage(0, { { 3, 20 } }));
+    queue.Push(messageEvent);
+
+    CHECK(queue.GetNumQueued() == 1);
+
+    messageEvent = MakeEvent(BuildUnitMessage(OTHER_OPCODE, 0, { 0 }));
+    queue.Push(messageEvent);
+    messageEvent = MakeEvent(BuildNetFieldMessage(0, { { 5, 30 } }));
+    queue.Push(messageEvent);
+
+    CHECK(queue.GetNumQueued() == 3);
+    CHECK(queue.GetNumCoalesced() == 1);
+
+    ObjectGUID guid;
+    Fields fields;
+    REQUIRE(queue.TryPop(messageEvent));
+    REQUIRE(ECS::Util::Network::MessageDispatchQueue::PeekUnitNetFieldUpdate(messageEvent.message, guid, fields));
+    CHECK(guid == GetUnitGUID(0));
+    CHECK(fields == Fields{ { 3, 20 }, { 40, 11 } });
+
+    SECTION("Disabling coalescing keeps every message")
+    {
+        queue.Clear();
+        CHECK(queue.GetNumQueued() == 0);
+
+        messageEvent = MakeEvent(BuildMoveMessage(0, 1, 10, 100));
+        queue.Push(messageEvent, false);
+        messageEvent = MakeEvent(BuildMoveMessage(0, 2, 20, 200));
+        queue.Push(messageEvent, false);
+
+        CHECK(queue.GetNumQueued() == 2);
+        CHECK(queue.GetNumCoalesced() == 1);
+    }
+}
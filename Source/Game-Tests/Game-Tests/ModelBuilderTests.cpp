@@ -1,8 +1,18 @@
 #include "Game-Lib/Rendering/Model/ModelBuilder.h"
+#include "Game-Lib/Rendering/Model/MeshOptimizer.h"
+
+#include <Base/Util/DebugHandler.h>
 
 #include <catch2/catch2.hpp>
+#include <glm/gtc/packing.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <type_traits>
+#include <vector>
 
 static_assert(std::is_move_constructible_v<ModelLoading::PreparedModelResult>);
 static_assert(!std::is_copy_constructible_v<ModelLoading::PreparedModelResult>);
@@ -57,6 +67,140 @@ namespace
         model.textureTransforms.resize(1);
         return model;
     }
+
+    Model::ComplexModel::Vertex MakeVertex(f32 x, f32 y, f32 z, u16 uv)
+    {
+        // Half positions first, like PackedModelVertex, the rest only has to tell vertices apart
+        u16 packed[12] = { glm::packHalf1x16(x), glm::packHalf1x16(y), glm::packHalf1x16(z), 0, uv, static_cast<u16>(uv >> 4) };
+
+        Model::ComplexModel::Vertex vertex;
+        static_assert(sizeof(vertex) == sizeof(packed));
+        std::memcpy(&vertex, packed, sizeof(vertex));
+
+        return vertex;
+    }
+
+    // A bumpy gridSize x gridSize grid where every cell has its own four vertices and the triangles come in shuffled, the
+    // worst case for the vertex cache. Every render batch after the first draws the same triangles as the first one
+    Model::ComplexModel MakeGridModel(u32 gridSize, u32 numRenderBatches, bool isTransparent)
+    {
+        Model::ComplexModel model = MakeMinimalModel();
+        model.vertices.clear();
+        model.modelData.indices.clear();
+
+        std::vector<std::array<u16, 3>> triangles;
+        for (u32 y = 0; y < gridSize; y++)
+        {
+            for (u32 x = 0; x < gridSize; x++)
+            {
+                u16 firstVertex = static_cast<u16>(model.vertices.size());
+                for (u32 corner = 0; corner < 4; corner++)
+                {
+                    u32 vertexX = x + (corner & 1);
+                    u32 vertexY = y + (corner >> 1);
+                    f32 height = static_cast<f32>((vertexX * 7 + vertexY * 3) % 5);
+
+                    model.vertices.push_back(MakeVertex(static_cast<f32>(vertexX), height, static_cast<f32>(vertexY), static_cast<u16>(vertexY * (gridSize + 1) + vertexX)));
+                }
+
+                triangles.push_back({ firstVertex, static_cast<u16>(firstVertex + 2), static_cast<u16>(firstVertex + 1) });
+                triangles.push_back({ static_cast<u16>(firstVertex + 1), static_cast<u16>(firstVertex + 2), static_cast<u16>(firstVertex + 3) });
+            }
+        }
+
+        u32 seed = 12345;
+        for (size_t i = triangles.size() - 1; i > 0; i--)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            std::swap(triangles[i], triangles[seed % (i + 1)]);
+        }
+
+        for (const std::array<u16, 3>& triangle : triangles)
+        {
+            model.modelData.indices.insert(model.modelData.indices.end(), triangle.begin(), triangle.end());
+        }
+
+        Model::ComplexModel::RenderBatch renderBatch = model.modelData.renderBatches[0];
+        renderBatch.vertexCount = static_cast<u32>(model.vertices.size());
+        renderBatch.indexCount = static_cast<u32>(model.modelData.indices.size());
+        renderBatch.isTransparent = isTransparent;
+        model.modelData.renderBatches.assign(numRenderBatches, renderBatch);
+
+        model.modelHeader.numVertices = static_cast<u32>(model.vertices.size());
+        model.modelHeader.numIndices = static_cast<u32>(model.modelData.indices.size());
+        model.modelHeader.numRenderBatches = numRenderBatches;
+        model.modelHeader.numOpaqueRenderBatches = isTransparent ? 0 : numRenderBatches;
+        model.modelHeader.numTransparentRenderBatches = isTransparent ? numRenderBatches : 0;
+        model.modelHeader.numTextureUnits = numRenderBatches;
+
+        return model;
+    }
+
+    vec3 GetPosition(const Model::ComplexModel::Vertex& vertex)
+    {
+        u16 packed[3];
+        std::memcpy(packed, &vertex, sizeof(packed));
+
+        return vec3(glm::unpackHalf1x16(packed[0]), glm::unpackHalf1x16(packed[1]), glm::unpackHalf1x16(packed[2]));
+    }
+
+    // MakeGridModel with the bumps smoothed into rolling hills, simplifiable within a small error
+    Model::ComplexModel MakeHillModel(u32 gridSize, u32 numRenderBatches)
+    {
+        Model::ComplexModel model = MakeGridModel(gridSize, numRenderBatches, false);
+        for (Model::ComplexModel::Vertex& vertex : model.vertices)
+        {
+            u16 packed[3];
+            std::memcpy(packed, &vertex, sizeof(packed));
+
+            f32 x = glm::unpackHalf1x16(packed[0]);
+            f32 z = glm::unpackHalf1x16(packed[2]);
+            packed[1] = glm::packHalf1x16(std::sin(x * 0.2f) * std::cos(z * 0.15f) * 2.0f);
+            std::memcpy(&vertex, packed, sizeof(packed));
+        }
+
+        return model;
+    }
+
+    using TriangleBytes = std::array<u8, sizeof(Model::ComplexModel::Vertex) * 3>;
+
+    // The triangles a draw call draws by vertex contents, rotated to start at their smallest vertex so only the winding counts
+    std::vector<TriangleBytes> GetTriangles(const ModelLoading::PreparedRenderModel& prepared, const ModelLoading::PreparedDrawCall& drawCall)
+    {
+        constexpr size_t VERTEX_SIZE = sizeof(Model::ComplexModel::Vertex);
+
+        std::vector<TriangleBytes> triangles;
+        for (u32 i = 0; i < drawCall.indexCount; i += 3)
+        {
+            const u16* indices = &prepared.indices[drawCall.firstIndex + i];
+
+            u32 first = 0;
+            for (u32 corner = 1; corner < 3; corner++)
+            {
+                const auto& vertex = prepared.vertices[drawCall.vertexOffset + indices[corner]];
+                const auto& firstVertex = prepared.vertices[drawCall.vertexOffset + indices[first]];
+
+                if (std::memcmp(&vertex, &firstVertex, VERTEX_SIZE) < 0)
+                    first = corner;
+            }
+
+            TriangleBytes triangle;
+            for (u32 corner = 0; corner < 3; corner++)
+            {
+                const auto& vertex = prepared.vertices[drawCall.vertexOffset + indices[(first + corner) % 3]];
+                std::memcpy(&triangle[corner * VERTEX_SIZE], &vertex, VERTEX_SIZE);
+            }
+
+            triangles.push_back(triangle);
+        }
+
+        return triangles;
+    }
+
+    f32 ComputeACMR(const ModelLoading::PreparedRenderModel& prepared, const ModelLoading::PreparedDrawCall& drawCall)
+    {
+        return MeshOptimizer::ComputeACMR(&prepared.indices[drawCall.firstIndex], drawCall.indexCount, static_cast<u32>(prepared.vertices.size() - drawCall.vertexOffset));
+    }
 }
 
 TEST_CASE("Model builder prepares relative renderer data without live renderer state", "[Rendering][ModelBuilder]")
@@ -113,3 +257,544 @@ TEST_CASE("Model builder rejects inconsistent model header counts", "[Rendering]
     CHECK_FALSE(static_cast<bool>(result));
     CHECK_FALSE(result.error.empty());
 }
+
+TEST_CASE("Model builder mesh optimization keeps the geometry and improves the ACMR", "[Rendering][ModelBuilder]")
+{
+    Model::ComplexModel model = MakeGridModel(32, 2, false);
+
+    ModelLoading::ModelBuildOptions buildOptions;
+    buildOptions.optimizeMeshes = true;
+
+    ModelLoading::ModelBuildResult originalResult = ModelLoading::BuildPreparedModel("grid", model);
+    ModelLoading::ModelBuildResult optimizedResult = ModelLoading::BuildPreparedModel("grid", model, buildOptions);
+    REQUIRE(static_cast<bool>(originalResult));
+    REQUIRE(static_cast<bool>(optimizedResult));
+
+    const ModelLoading::PreparedRenderModel& original = originalResult.preparedModel;
+    const ModelLoading::PreparedRenderModel& optimized = optimizedResult.preparedModel;
+    REQUIRE(optimized.drawCalls.size() == 2);
+
+    // Every cell had its own corners, only the grid points are left
+    CHECK(optimized.vertices.size() == 33 * 33);
+    CHECK(optimized.reserveInfo.numVertices == optimized.vertices.size());
+    CHECK(optimized.indices.size() == original.indices.size());
+    CHECK(optimized.estimatedCommitBytes < original.estimatedCommitBytes);
+
+    // Batches drawing the same triangles still share them
+    CHECK(optimized.drawCalls[1].firstIndex == optimized.drawCalls[0].firstIndex);
+    CHECK(optimized.drawCalls[1].vertexOffset == optimized.drawCalls[0].vertexOffset);
+
+    std::vector<TriangleBytes> originalTriangles = GetTriangles(original, original.drawCalls[0]);
+    std::vector<TriangleBytes> optimizedTriangles = GetTriangles(optimized, optimized.drawCalls[0]);
+    std::sort(originalTriangles.begin(), originalTriangles.end());
+    std::sort(optimizedTriangles.begin(), optimizedTriangles.end());
+    CHECK(optimizedTriangles == originalTriangles);
+
+    // The vertices are fetched in draw order
+    u32 nextVertex = 0;
+    bool isInFetchOrder = true;
+    for (u16 index : optimized.indices)
+    {
+        isInFetchOrder &= index <= nextVertex;
+        nextVertex = std::max(nextVertex, index + 1u);
+    }
+    CHECK(isInFetchOrder);
+
+    f32 originalACMR = ComputeACMR(original, original.drawCalls[0]);
+    f32 optimizedACMR = ComputeACMR(optimized, optimized.drawCalls[0]);
+    CHECK(optimizedACMR < originalACMR);
+
+    NC_LOG_INFO("ModelBuilder : ACMR {0:.3f} -> {1:.3f}, {2} -> {3} vertices, {4} -> {5} commit bytes", originalACMR, optimizedACMR, original.vertices.size(), optimized.vertices.size(), original.estimatedCommitBytes, optimized.estimatedCommitBytes);
+}
+
+TEST_CASE("Model builder mesh optimization keeps the triangle order of transparent batches", "[Rendering][ModelBuilder]")
+{
+    Model::ComplexModel model = MakeGridModel(8, 1, true);
+
+    ModelLoading::ModelBuildOptions buildOptions;
+    buildOptions.optimizeMeshes = true;
+
+    ModelLoading::ModelBuildResult originalResult = ModelLoading::BuildPreparedModel("transparent-grid", model);
+    ModelLoading::ModelBuildResult optimizedResult = ModelLoading::BuildPreparedModel("transparent-grid", model, buildOptions);
+    REQUIRE(static_cast<bool>(originalResult));
+    REQUIRE(static_cast<bool>(optimizedResult));
+
+    const ModelLoading::PreparedRenderModel& original = originalResult.preparedModel;
+    const ModelLoading::PreparedRenderModel& optimized = optimizedResult.preparedModel;
+
+    // The vertices are still merged and packed, the triangles are drawn in the same order
+    CHECK(optimized.vertices.size() == 9 * 9);
+    CHECK(GetTriangles(optimized, optimized.drawCalls[0]) == GetTriangles(original, original.drawCalls[0]));
+}
+
+TEST_CASE("Mesh optimizer vertex cache ordering approaches one vertex per triangle on grids", "[Rendering][MeshOptimizer]")
+{
+    constexpr u32 GRID_SIZE = 64;
+    constexpr u32 NUM_VERTICES = (GRID_SIZE + 1) * (GRID_SIZE + 1);
+
+    // Row by row, each row misses the whole row below it again once the cache is smaller than a row
+    std::vector<u16> indices;
+    for (u32 y = 0; y < GRID_SIZE; y++)
+    {
+        for (u32 x = 0; x < GRID_SIZE; x++)
+        {
+            u16 v0 = static_cast<u16>(y * (GRID_SIZE + 1) + x);
+            u16 v1 = static_cast<u16>(v0 + 1);
+            u16 v2 = static_cast<u16>(v0 + GRID_SIZE + 1);
+            u16 v3 = static_cast<u16>(v2 + 1);
+
+            indices.insert(indices.end(), { v0, v2, v1, v1, v2, v3 });
+        }
+    }
+
+    std::vector<u16> optimizedIndices = indices;
+    MeshOptimizer::OptimizeVertexCache(optimizedIndices.data(), optimizedIndices.size(), NUM_VERTICES);
+
+    f32 originalACMR = MeshOptimizer::ComputeACMR(indices.data(), indices.size(), NUM_VERTICES);
+    f32 optimizedACMR = MeshOptimizer::ComputeACMR(optimizedIndices.data(), optimizedIndices.size(), NUM_VERTICES);
+    CHECK(originalACMR == Approx(1.0f).margin(0.05f));
+    CHECK(optimizedACMR < 0.8f);
+
+    NC_LOG_INFO("MeshOptimizer : Row by row grid ACMR {0:.3f} -> {1:.3f}", originalACMR, optimizedACMR);
+
+    SECTION("Overdraw ordering stays within its ACMR threshold")
+    {
+        std::vector<vec3> positions(NUM_VERTICES);
+        for (u32 vertex = 0; vertex < NUM_VERTICES; vertex++)
+        {
+            f32 x = static_cast<f32>(vertex % (GRID_SIZE + 1));
+            f32 z = static_cast<f32>(vertex / (GRID_SIZE + 1));
+            positions[vertex] = vec3(x, (x - 32.0f) * (z - 32.0f) * 0.01f, z);
+        }
+
+        std::vector<u16> overdrawIndices = optimizedIndices;
+        MeshOptimizer::OptimizeOverdraw(overdrawIndices.data(), overdrawIndices.size(), positions.data(), NUM_VERTICES);
+
+        f32 overdrawACMR = MeshOptimizer::ComputeACMR(overdrawIndices.data(), overdrawIndices.size(), NUM_VERTICES);
+        CHECK(overdrawACMR <= optimizedACMR * MeshOptimizer::OVERDRAW_THRESHOLD + 0.05f);
+
+        std::vector<u16> sortedOptimized = optimizedIndices;
+        std::vector<u16> sortedOverdraw = overdrawIndices;
+        std::sort(sortedOptimized.begin(), sortedOptimized.end());
+        std::sort(sortedOverdraw.begin(), sortedOverdraw.end());
+        CHECK(sortedOverdraw == sortedOptimized);
+    }
+}
+
+TEST_CASE("Model builder meshlets cover every triangle exactly once within their bounds", "[Rendering][ModelBuilder]")
+{
+    Model::ComplexModel model = MakeGridModel(32, 2, false);
+
+    ModelLoading::ModelBuildOptions buildOptions;
+    buildOptions.optimizeMeshes = true;
+    buildOptions.buildMeshlets = true;
+
+    ModelLoading::ModelBuildResult result = ModelLoading::BuildPreparedModel("meshlet-grid", model, buildOptions);
+    REQUIRE(static_cast<bool>(result));
+
+    const ModelLoading::PreparedRenderModel& prepared = result.preparedModel;
+    const ModelLoading::PreparedDrawCall& drawCall = prepared.drawCalls[0];
+    REQUIRE(drawCall.numMeshlets > 0);
+    CHECK(prepared.reserveInfo.numMeshlets == prepared.meshlets.size());
+
+    // Batches drawing the same triangles share their meshlets
+    CHECK(prepared.drawCalls[1].meshletOffset == drawCall.meshletOffset);
+    CHECK(prepared.drawCalls[1].numMeshlets == drawCall.numMeshlets);
+    CHECK(prepared.meshlets.size() == drawCall.numMeshlets);
+
+    std::vector<u32> numTriangleMeshlets(drawCall.indexCount / 3, 0);
+    for (u32 i = 0; i < drawCall.numMeshlets; i++)
+    {
+        const ModelLoading::PreparedMeshlet& meshlet = prepared.meshlets[drawCall.meshletOffset + i];
+        REQUIRE(meshlet.indexCount % 3 == 0);
+        REQUIRE(meshlet.firstIndex >= drawCall.firstIndex);
+        REQUIRE(meshlet.firstIndex + meshlet.indexCount <= drawCall.firstIndex + drawCall.indexCount);
+        CHECK(meshlet.vertexOffset == drawCall.vertexOffset);
+        CHECK(meshlet.indexCount / 3 <= MeshOptimizer::MESHLET_MAX_TRIANGLES);
+
+        std::vector<u16> meshletVertices(&prepared.indices[meshlet.firstIndex], &prepared.indices[meshlet.firstIndex + meshlet.indexCount]);
+        std::sort(meshletVertices.begin(), meshletVertices.end());
+        meshletVertices.erase(std::unique(meshletVertices.begin(), meshletVertices.end()), meshletVertices.end());
+        CHECK(meshlet.numVertices == meshletVertices.size());
+        CHECK(meshlet.numVertices <= MeshOptimizer::MESHLET_MAX_VERTICES);
+
+        for (u32 triangle = (meshlet.firstIndex - drawCall.firstIndex) / 3; triangle < (meshlet.firstIndex - drawCall.firstIndex + meshlet.indexCount) / 3; triangle++)
+        {
+            numTriangleMeshlets[triangle]++;
+        }
+
+        bool isInSphere = true;
+        bool isInCone = true;
+        f32 minConeDot = std::sqrt(1.0f - meshlet.coneCutoff * meshlet.coneCutoff);
+        for (u32 index = 0; index < meshlet.indexCount; index += 3)
+        {
+            vec3 positions[3];
+            for (u32 corner = 0; corner < 3; corner++)
+            {
+                positions[corner] = GetPosition(prepared.vertices[meshlet.vertexOffset + prepared.indices[meshlet.firstIndex + index + corner]]);
+                isInSphere &= glm::length(positions[corner] - meshlet.center) <= meshlet.radius + 0.001f;
+            }
+
+            vec3 normal = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+            if (meshlet.coneCutoff < 1.0f && glm::length(normal) > 0.0f)
+                isInCone &= glm::dot(glm::normalize(normal), meshlet.coneAxis) >= minConeDot - 0.001f;
+        }
+        CHECK(isInSphere);
+        CHECK(isInCone);
+    }
+
+    CHECK(std::all_of(numTriangleMeshlets.begin(), numTriangleMeshlets.end(), [](u32 numMeshlets) { return numMeshlets == 1; }));
+
+    // Building again gives the same meshlets
+    ModelLoading::ModelBuildResult rebuiltResult = ModelLoading::BuildPreparedModel("meshlet-grid", model, buildOptions);
+    REQUIRE(static_cast<bool>(rebuiltResult));
+
+    const std::vector<ModelLoading::PreparedMeshlet>& rebuiltMeshlets = rebuiltResult.preparedModel.meshlets;
+    REQUIRE(rebuiltMeshlets.size() == prepared.meshlets.size());
+    CHECK(std::memcmp(rebuiltMeshlets.data(), prepared.meshlets.data(), sizeof(ModelLoading::PreparedMeshlet) * rebuiltMeshlets.size()) == 0);
+
+    ModelLoading::ModelBuildResult withoutMeshletsResult = ModelLoading::BuildPreparedModel("meshlet-grid", model);
+    REQUIRE(static_cast<bool>(withoutMeshletsResult));
+    CHECK(withoutMeshletsResult.preparedModel.meshlets.empty());
+    CHECK(withoutMeshletsResult.preparedModel.drawCalls[0].numMeshlets == 0);
+}
+
+TEST_CASE("Mesh optimizer meshlets of flat surfaces can be cone culled from behind", "[Rendering][MeshOptimizer]")
+{
+    constexpr u32 GRID_SIZE = 16;
+    constexpr u32 NUM_VERTICES = (GRID_SIZE + 1) * (GRID_SIZE + 1);
+
+    std::vector<vec3> positions(NUM_VERTICES);
+    for (u32 vertex = 0; vertex < NUM_VERTICES; vertex++)
+    {
+        positions[vertex] = vec3(static_cast<f32>(vertex % (GRID_SIZE + 1)), 0.0f, static_cast<f32>(vertex / (GRID_SIZE + 1)));
+    }
+
+    // Counter clockwise seen from above, facing up
+    std::vector<u16> indices;
+    for (u32 y = 0; y < GRID_SIZE; y++)
+    {
+        for (u32 x = 0; x < GRID_SIZE; x++)
+        {
+            u16 vertex = static_cast<u16>(y * (GRID_SIZE + 1) + x);
+            u16 nextRowVertex = static_cast<u16>(vertex + GRID_SIZE + 1);
+            indices.insert(indices.end(), { vertex, nextRowVertex, static_cast<u16>(vertex + 1), static_cast<u16>(vertex + 1), nextRowVertex, static_cast<u16>(nextRowVertex + 1) });
+        }
+    }
+
+    std::vector<MeshOptimizer::Meshlet> meshlets;
+    u32 numMeshlets = MeshOptimizer::BuildMeshlets(indices.data(), indices.size(), positions.data(), NUM_VERTICES, meshlets);
+    REQUIRE(numMeshlets == meshlets.size());
+    CHECK(numMeshlets >= (GRID_SIZE * GRID_SIZE * 2 + MeshOptimizer::MESHLET_MAX_TRIANGLES - 1) / MeshOptimizer::MESHLET_MAX_TRIANGLES);
+
+    const vec3 cameraBelow = vec3(8.0f, -100.0f, 8.0f);
+    const vec3 cameraAbove = vec3(8.0f, 100.0f, 8.0f);
+    for (const MeshOptimizer::Meshlet& meshlet : meshlets)
+    {
+        CHECK(meshlet.coneAxis.y == Approx(1.0f));
+        CHECK(meshlet.coneCutoff == Approx(0.0f).margin(0.001f));
+
+        vec3 belowOffset = meshlet.center - cameraBelow;
+        vec3 aboveOffset = meshlet.center - cameraAbove;
+        CHECK(glm::dot(belowOffset, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(belowOffset) + meshlet.radius);
+        CHECK_FALSE(glm::dot(aboveOffset, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(aboveOffset) + meshlet.radius);
+    }
+}
+
+TEST_CASE("Model builder LODs shrink level by level within their error", "[Rendering][ModelBuilder]")
+{
+    Model::ComplexModel model = MakeHillModel(32, 2);
+
+    ModelLoading::ModelBuildOptions buildOptions;
+    buildOptions.optimizeMeshes = true;
+    buildOptions.numLods = MODEL_MAX_LODS;
+
+    SECTION("With optimized meshes")
+    {
+    }
+
+    SECTION("Without optimized meshes, identical vertices are merged for the simplifier")
+    {
+        buildOptions.optimizeMeshes = false;
+    }
+
+    ModelLoading::ModelBuildResult result = ModelLoading::BuildPreparedModel("lod-hills", model, buildOptions);
+    REQUIRE(static_cast<bool>(result));
+
+    const ModelLoading::PreparedRenderModel& prepared = result.preparedModel;
+    REQUIRE(prepared.numLods >= 2);
+    CHECK(prepared.reserveInfo.numIndices == prepared.indices.size());
+
+    const ModelLoading::PreparedDrawCall& drawCall = prepared.drawCalls[0];
+    std::vector<TriangleBytes> baseTriangles = GetTriangles(prepared, drawCall);
+
+    u32 previousIndexCount = drawCall.indexCount;
+    f32 previousError = 0.0f;
+    for (u32 level = 0; level < prepared.numLods; level++)
+    {
+        const ModelLoading::PreparedDrawCallLod& lod = drawCall.lods[level];
+        REQUIRE(lod.firstIndex + lod.indexCount <= prepared.indices.size());
+        CHECK(lod.indexCount % 3 == 0);
+        CHECK(lod.indexCount <= previousIndexCount * 0.8f);
+
+        // The error budget doubles every level and is shared by the levels before
+        CHECK(prepared.lodErrors[level] >= previousError);
+        CHECK(prepared.lodErrors[level] <= 0.01f * static_cast<f32>(1u << level) + 0.0001f);
+
+        // Batches drawing the same triangles share their LODs
+        CHECK(prepared.drawCalls[1].lods[level].firstIndex == lod.firstIndex);
+        CHECK(prepared.drawCalls[1].lods[level].indexCount == lod.indexCount);
+
+        bool isInVertexRange = true;
+        for (u32 i = 0; i < lod.indexCount; i++)
+        {
+            isInVertexRange &= drawCall.vertexOffset + prepared.indices[lod.firstIndex + i] < prepared.vertices.size();
+        }
+        CHECK(isInVertexRange);
+
+        previousIndexCount = lod.indexCount;
+        previousError = prepared.lodErrors[level];
+    }
+
+    CHECK(drawCall.lods[0].indexCount <= drawCall.indexCount / 2 + 3);
+
+    // The full detail level is untouched
+    ModelLoading::ModelBuildOptions baseOptions = buildOptions;
+    baseOptions.numLods = 0;
+
+    ModelLoading::ModelBuildResult baseResult = ModelLoading::BuildPreparedModel("lod-hills", model, baseOptions);
+    REQUIRE(static_cast<bool>(baseResult));
+    CHECK(GetTriangles(baseResult.preparedModel, baseResult.preparedModel.drawCalls[0]) == baseTriangles);
+    CHECK(baseResult.preparedModel.numLods == 0);
+
+    NC_LOG_INFO("ModelBuilder : {0} LODs of {1} -> {2} -> {3} -> {4} indices", prepared.numLods, drawCall.indexCount, drawCall.lods[0].indexCount, drawCall.lods[1].indexCount, drawCall.lods[2].indexCount);
+}
+
+TEST_CASE("Model builder skips LODs for transparent draw calls", "[Rendering][ModelBuilder]")
+{
+    Model::ComplexModel model = MakeGridModel(8, 1, true);
+
+    ModelLoading::ModelBuildOptions buildOptions;
+    buildOptions.numLods = MODEL_MAX_LODS;
+
+    ModelLoading::ModelBuildResult result = ModelLoading::BuildPreparedModel("transparent-grid", model, buildOptions);
+    REQUIRE(static_cast<bool>(result));
+    CHECK(result.preparedModel.numLods == 0);
+    CHECK(result.preparedModel.indices.size() == model.modelData.indices.size());
+}
+
+namespace
+{
+    constexpr u32 SIMPLIFY_GRID_SIZE = 32;
+    constexpr u32 SIMPLIFY_GRID_VERTICES = (SIMPLIFY_GRID_SIZE + 1) * (SIMPLIFY_GRID_SIZE + 1);
+
+    // Triangles facing +y, vertices row by row
+    std::vector<u16> MakeGridIndices()
+    {
+        std::vector<u16> indices;
+        for (u32 y = 0; y < SIMPLIFY_GRID_SIZE; y++)
+        {
+            for (u32 x = 0; x < SIMPLIFY_GRID_SIZE; x++)
+            {
+                u16 vertex = static_cast<u16>(y * (SIMPLIFY_GRID_SIZE + 1) + x);
+                u16 nextRowVertex = static_cast<u16>(vertex + SIMPLIFY_GRID_SIZE + 1);
+                indices.insert(indices.end(), { vertex, nextRowVertex, static_cast<u16>(vertex + 1), static_cast<u16>(vertex + 1), nextRowVertex, static_cast<u16>(nextRowVertex + 1) });
+            }
+        }
+
+        return indices;
+    }
+
+    bool IsBorderVertex(u32 vertex)
+    {
+        u32 x = vertex % (SIMPLIFY_GRID_SIZE + 1);
+        u32 y = vertex / (SIMPLIFY_GRID_SIZE + 1);
+        return x == 0 || y == 0 || x == SIMPLIFY_GRID_SIZE || y == SIMPLIFY_GRID_SIZE;
+    }
+
+    f32 GetPointTriangleDistance(const vec3& point, const vec3& a, const vec3& b, const vec3& c)
+    {
+        // Closest point on the triangle (Ericson, Real-Time Collision Detection 5.1.5)
+        vec3 ab = b - a;
+        vec3 ac = c - a;
+        vec3 ap = point - a;
+
+        f32 d1 = glm::dot(ab, ap);
+        f32 d2 = glm::dot(ac, ap);
+        if (d1 <= 0.0f && d2 <= 0.0f)
+            return glm::length(point - a);
+
+        vec3 bp = point - b;
+        f32 d3 = glm::dot(ab, bp);
+        f32 d4 = glm::dot(ac, bp);
+        if (d3 >= 0.0f && d4 <= d3)
+            return glm::length(point - b);
+
+        f32 vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+            return glm::length(point - (a + ab * (d1 / (d1 - d3))));
+
+        vec3 cp = point - c;
+        f32 d5 = glm::dot(ab, cp);
+        f32 d6 = glm::dot(ac, cp);
+        if (d6 >= 0.0f && d5 <= d6)
+            return glm::length(point - c);
+
+        f32 vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+            return glm::length(point - (a + ac * (d2 / (d2 - d6))));
+
+        f32 va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+            return glm::length(point - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))));
+
+        f32 denominator = 1.0f / (va + vb + vc);
+        return glm::length(point - (a + ab * (vb * denominator) + ac * (vc * denominator)));
+    }
+}
+
+TEST_CASE("Mesh optimizer simplification reaches its target on flat surfaces and keeps borders", "[Rendering][MeshOptimizer]")
+{
+    std::vector<vec3> positions(SIMPLIFY_GRID_VERTICES);
+    for (u32 vertex = 0; vertex < SIMPLIFY_GRID_VERTICES; vertex++)
+    {
+        positions[vertex] = vec3(static_cast<f32>(vertex % (SIMPLIFY_GRID_SIZE + 1)), 0.0f, static_cast<f32>(vertex / (SIMPLIFY_GRID_SIZE + 1)));
+    }
+
+    std::vector<u16> indices = MakeGridIndices();
+    size_t targetIndexCount = indices.size() / 4;
+
+    f32 error = 1.0f;
+    std::vector<u16> simplified(indices.size());
+    size_t numSimplifiedIndices = MeshOptimizer::Simplify(simplified.data(), indices.data(), indices.size(), positions.data(), SIMPLIFY_GRID_VERTICES, targetIndexCount, 0.01f, &error);
+    simplified.resize(numSimplifiedIndices);
+
+    CHECK(numSimplifiedIndices <= targetIndexCount);
+    CHECK(numSimplifiedIndices % 3 == 0);
+    CHECK(error == Approx(0.0f).margin(0.0001f));
+
+    std::vector<u8> isReferenced(SIMPLIFY_GRID_VERTICES, 0);
+    bool facesUp = true;
+    for (size_t i = 0; i < simplified.size(); i += 3)
+    {
+        vec3 normal = glm::cross(positions[simplified[i + 1]] - positions[simplified[i]], positions[simplified[i + 2]] - positions[simplified[i]]);
+        facesUp &= normal.y > 0.0f;
+
+        isReferenced[simplified[i + 0]] = 1;
+        isReferenced[simplified[i + 1]] = 1;
+        isReferenced[simplified[i + 2]] = 1;
+    }
+    CHECK(facesUp);
+
+    bool keepsBorders = true;
+    for (u32 vertex = 0; vertex < SIMPLIFY_GRID_VERTICES; vertex++)
+    {
+        if (IsBorderVertex(vertex))
+            keepsBorders &= isReferenced[vertex] != 0;
+    }
+    CHECK(keepsBorders);
+
+    // Without room for error nothing on a curved surface can go
+    for (u32 vertex = 0; vertex < SIMPLIFY_GRID_VERTICES; vertex++)
+    {
+        positions[vertex].y = positions[vertex].x * positions[vertex].x * 0.05f + positions[vertex].z * positions[vertex].z * 0.05f;
+    }
+
+    size_t numCurvedIndices = MeshOptimizer::Simplify(simplified.data(), indices.data(), indices.size(), positions.data(), SIMPLIFY_GRID_VERTICES, targetIndexCount, 0.0f);
+    CHECK(numCurvedIndices == indices.size());
+}
+
+TEST_CASE("Mesh optimizer simplification stays within its error and keeps UV seams", "[Rendering][MeshOptimizer]")
+{
+    // Rolling hills with a UV seam down the middle, the seam column is split into two vertices at the same position
+    constexpr u32 SEAM_X = SIMPLIFY_GRID_SIZE / 2;
+
+    std::vector<vec3> positions(SIMPLIFY_GRID_VERTICES);
+    for (u32 vertex = 0; vertex < SIMPLIFY_GRID_VERTICES; vertex++)
+    {
+        f32 x = static_cast<f32>(vertex % (SIMPLIFY_GRID_SIZE + 1));
+        f32 z = static_cast<f32>(vertex / (SIMPLIFY_GRID_SIZE + 1));
+        positions[vertex] = vec3(x, std::sin(x * 0.2f) * std::cos(z * 0.15f) * 2.0f, z);
+    }
+
+    std::vector<u16> indices = MakeGridIndices();
+
+    std::vector<u16> seamVertices;
+    for (u32 y = 0; y <= SIMPLIFY_GRID_SIZE; y++)
+    {
+        u32 vertex = y * (SIMPLIFY_GRID_SIZE + 1) + SEAM_X;
+        seamVertices.push_back(static_cast<u16>(positions.size()));
+        positions.push_back(positions[vertex]);
+    }
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        bool isRightOfSeam = false;
+        for (u32 corner = 0; corner < 3; corner++)
+        {
+            isRightOfSeam |= indices[i + corner] % (SIMPLIFY_GRID_SIZE + 1) > SEAM_X;
+        }
+
+        for (u32 corner = 0; isRightOfSeam && corner < 3; corner++)
+        {
+            u16& index = indices[i + corner];
+            if (index % (SIMPLIFY_GRID_SIZE + 1) == SEAM_X)
+                index = seamVertices[index / (SIMPLIFY_GRID_SIZE + 1)];
+        }
+    }
+
+    const u32 numVertices = static_cast<u32>(positions.size());
+    const f32 targetError = 0.1f;
+
+    f32 error = 0.0f;
+    std::vector<u16> simplified(indices.size());
+    size_t numSimplifiedIndices = MeshOptimizer::Simplify(simplified.data(), indices.data(), indices.size(), positions.data(), numVertices, 0, targetError, &error);
+    simplified.resize(numSimplifiedIndices);
+
+    CHECK(numSimplifiedIndices < indices.size() / 2);
+    CHECK(error <= targetError);
+
+    // Both sides of the seam are still there and no triangle crosses it
+    std::vector<u8> isReferenced(numVertices, 0);
+    bool crossesSeam = false;
+    for (size_t i = 0; i < simplified.size(); i += 3)
+    {
+        bool hasLeft = false;
+        bool hasRight = false;
+        for (u32 corner = 0; corner < 3; corner++)
+        {
+            u16 index = simplified[i + corner];
+            isReferenced[index] = 1;
+
+            bool isSeamCopy = index >= SIMPLIFY_GRID_VERTICES;
+            u32 x = isSeamCopy ? SEAM_X : index % (SIMPLIFY_GRID_SIZE + 1);
+            hasLeft |= x < SEAM_X || (x == SEAM_X && !isSeamCopy);
+            hasRight |= x > SEAM_X || isSeamCopy;
+        }
+        crossesSeam |= hasLeft && hasRight;
+    }
+    CHECK_FALSE(crossesSeam);
+
+    bool keepsSeam = true;
+    for (u32 y = 0; y <= SIMPLIFY_GRID_SIZE; y++)
+    {
+        keepsSeam &= isReferenced[y * (SIMPLIFY_GRID_SIZE + 1) + SEAM_X] != 0;
+        keepsSeam &= isReferenced[seamVertices[y]] != 0;
+    }
+    CHECK(keepsSeam);
+
+    // Every original vertex stays close to the simplified surface
+    f32 maxDistance = 0.0f;
+    for (u32 vertex = 0; vertex < numVertices; vertex++)
+    {
+        f32 distance = std::numeric_limits<f32>::max();
+        for (size_t i = 0; i < simplified.size(); i += 3)
+        {
+            distance = std::min(distance, GetPointTriangleDistance(positions[vertex], positions[simplified[i]], positions[simplified[i + 1]], positions[simplified[i + 2]]));
+        }
+        maxDistance = std::max(maxDistance, distance);
+    }
+    CHECK(maxDistance <= targetError);
+
+    NC_LOG_INFO("MeshOptimizer : Simplified {0} -> {1} indices, error {2:.4f}, max vertex distance {3:.4f}", indices.size(), numSimplifiedIndices, error, maxDistance);
+}
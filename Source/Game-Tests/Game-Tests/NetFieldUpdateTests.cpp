@@ -0,0 +1,247 @@
+#include "Game-Lib/ECS/Util/MessageBuilderUtil.h"
+#include "Game-Lib/ECS/Util/Network/NetFieldUpdate.h"
+
+#include <Base/Memory/Bytebuffer.h>
+
+#include <Network/Define.h>
+
+#include <catch2/catch2.hpp>
+
+#include <entt/entt.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Fields = std::vector<std::pair<u16, u32>>;
+
+    constexpr u32 NUM_UNITS = 64;
+    constexpr u32 MAX_FIELD_ID = 2040;
+
+    enum class TestField : u16 { };
+
+    std::shared_ptr<Bytebuffer> BuildNetFieldMessage(u32 unitIndex, const Fields& fields)
+    {
+        std::shared_ptr<Bytebuffer> buffer = Bytebuffer::BorrowRuntime(2048);
+        REQUIRE(ECS::Util::MessageBuilder::Unit::BuildUnitNetFieldUpdateMessage(buffer, ObjectGUID::CreatePlayer(unitIndex + 1), fields));
+        return buffer;
+    }
+
+    // Decodes like HandleOnUnitNetFieldUpdate, values go to fieldValues and the changes into the batch
+    bool DecodeNetFieldMessage(Bytebuffer& buffer, u32 unitIndex, std::vector<u32>& fieldValues, ECS::Util::Network::NetFieldChangeBatch<TestField>& changes)
+    {
+        buffer.readData = 0;
+
+        ::Network::MessageHeader header;
+        ObjectGUID guid;
+        if (!buffer.Get(header) || !buffer.Deserialize(guid))
+            return false;
+
+        ECS::Util::Network::NetFieldMask fieldMask;
+        if (!fieldMask.Read(buffer))
+            return false;
+
+        entt::entity entity = static_cast<entt::entity>(unitIndex);
+
+        return fieldMask.ForEachField([&](u16 fieldID)
+        {
+            u32 data = 0;
+            if (!buffer.GetU32(data))
+                return false;
+
+            fieldValues[unitIndex * MAX_FIELD_ID + fieldID] = data;
+            changes.Add(entity, guid, static_cast<TestField>(fieldID));
+            return true;
+        });
+    }
+
+    // What the handler did before, a mask vector per message and a second pass for the notifications
+    bool DecodeNetFieldMessageReference(Bytebuffer& buffer, u32 unitIndex, std::vector<u32>& fieldValues, std::vector<std::pair<u32, u16>>& changes)
+    {
+        buffer.readData = 0;
+
+        ::Network::MessageHeader header;
+        ObjectGUID guid;
+        u8 byteMaskOffset = 0;
+        u8 numMaskBytes = 0;
+        if (!buffer.Get(header) || !buffer.Deserialize(guid) || !buffer.GetU8(byteMaskOffset) || !buffer.GetU8(numMaskBytes))
+            return false;
+
+        std::vector<u8> maskBytes(numMaskBytes);
+        if (!buffer.GetBytes(maskBytes.data(), numMaskBytes))
+            return false;
+
+        for (u32 i = 0; i < numMaskBytes; i++)
+        {
+            u8 maskByte = maskBytes[i];
+            while (maskByte)
+            {
+                u16 bitIndex = static_cast<u16>(std::countr_zero(maskByte));
+                maskByte &= (maskByte - 1);
+
+                u32 data = 0;
+                if (!buffer.GetU32(data))
+                    return false;
+
+                fieldValues[unitIndex * MAX_FIELD_ID + (byteMaskOffset + i) * 8 + bitIndex] = data;
+            }
+        }
+
+        for (u32 i = 0; i < numMaskBytes; i++)
+        {
+            u8 maskByte = maskBytes[i];
+            while (maskByte)
+            {
+                u16 bitIndex = static_cast<u16>(std::countr_zero(maskByte));
+                maskByte &= (maskByte - 1);
+
+                changes.push_back({ unitIndex, static_cast<u16>((byteMaskOffset + i) * 8 + bitIndex) });
+            }
+        }
+
+        return true;
+    }
+
+    // Combat traffic: most updates touch a few health and power fields close together, some carry a wide spread
+    Fields MakeBurstFields(std::mt19937& random)
+    {
+        std::uniform_int_distribution<u32> kindDistribution(0, 9);
+        std::uniform_int_distribution<u32> valueDistribution;
+
+        u16 first = 0;
+        u16 span = 0;
+        u32 numFields = 0;
+
+        if (kindDistribution(random) < 8)
+        {
+            first = static_cast<u16>(std::uniform_int_distribution<u32>(16, 48)(random));
+            span = 24;
+            numFields = std::uniform_int_distribution<u32>(1, 4)(random);
+        }
+        else
+        {
+            first = static_cast<u16>(std::uniform_int_distribution<u32>(0, 600)(random));
+            span = 700;
+            numFields = std::uniform_int_distribution<u32>(4, 24)(random);
+        }
+
+        std::vector<u16> fieldIDs;
+        while (fieldIDs.size() < numFields)
+        {
+            u16 fieldID = first + static_cast<u16>(std::uniform_int_distribution<u32>(0, span - 1)(random));
+            if (std::find(fieldIDs.begin(), fieldIDs.end(), fieldID) == fieldIDs.end())
+                fieldIDs.push_back(fieldID);
+        }
+        std::sort(fieldIDs.begin(), fieldIDs.end());
+
+        Fields fields;
+        for (u16 fieldID : fieldIDs)
+        {
+            fields.push_back({ fieldID, valueDistribution(random) });
+        }
+
+        return fields;
+    }
+}
+
+TEST_CASE("Netfield masks decode every field the builder wrote", "[Network][NetField]")
+{
+    std::vector<u32> fieldValues(NUM_UNITS * MAX_FIELD_ID, 0);
+    ECS::Util::Network::NetFieldChangeBatch<TestField> changes;
+
+    SECTION("Fields past the first mask byte keep their byte's offset")
+    {
+        Fields fields = { { 17, 1 }, { 23, 2 }, { 24, 3 }, { 40, 4 }, { 95, 5 } };
+        std::shared_ptr<Bytebuffer> buffer = BuildNetFieldMessage(3, fields);
+        REQUIRE(DecodeNetFieldMessage(*buffer, 3, fieldValues, changes));
+
+        for (const auto& [fieldID, value] : fields)
+        {
+            CHECK(fieldValues[3 * MAX_FIELD_ID + fieldID] == value);
+        }
+        CHECK(changes.GetNumChanges() == fields.size());
+    }
+
+    SECTION("A window reaching into the last word of the mask")
+    {
+        Fields fields = { { 1600, 7 }, { 1663, 8 }, { 1664, 9 }, { 2039, 10 } };
+        std::shared_ptr<Bytebuffer> buffer = BuildNetFieldMessage(0, fields);
+        REQUIRE(DecodeNetFieldMessage(*buffer, 0, fieldValues, changes));
+
+        for (const auto& [fieldID, value] : fields)
+        {
+            CHECK(fieldValues[fieldID] == value);
+        }
+    }
+
+    SECTION("A truncated message fails instead of reading past its end")
+    {
+        Fields fields = { { 4, 1 }, { 5, 2 }, { 6, 3 } };
+        std::shared_ptr<Bytebuffer> buffer = BuildNetFieldMessage(0, fields);
+        buffer->writtenData -= sizeof(u32);
+
+        CHECK_FALSE(DecodeNetFieldMessage(*buffer, 0, fieldValues, changes));
+    }
+}
+
+TEST_CASE("Netfield change batches notify in arrival order", "[Network][NetField]")
+{
+    ECS::Util::Network::NetFieldChangeBatch<TestField> changes;
+
+    entt::entity first = static_cast<entt::entity>(2);
+    entt::entity second = static_cast<entt::entity>(1);
+
+    changes.Add(first, ObjectGUID::CreatePlayer(3), static_cast<TestField>(9));
+    changes.Add(second, ObjectGUID::CreatePlayer(2), static_cast<TestField>(4));
+    changes.Add(first, ObjectGUID::CreatePlayer(3), static_cast<TestField>(1));
+    changes.Add(first, ObjectGUID::CreatePlayer(3), static_cast<TestField>(9));
+    changes.Add(second, ObjectGUID::CreatePlayer(2), static_cast<TestField>(4));
+
+    std::vector<std::pair<u32, u16>> notified;
+    changes.Flush([&](const ECS::Util::Network::NetFieldChangeBatch<TestField>::Change& change)
+    {
+        notified.push_back({ entt::to_integral(change.entity), static_cast<u16>(change.field) });
+    });
+
+    std::vector<std::pair<u32, u16>> expected = { { 2, 9 }, { 1, 4 }, { 2, 1 }, { 2, 9 }, { 1, 4 } };
+    CHECK(notified == expected);
+    CHECK(changes.GetNumChanges() == 0);
+
+    u32 numNotified = 0;
+    changes.Flush([&](const auto&) { numNotified++; });
+    CHECK(numNotified == 0);
+}
+
+TEST_CASE("Netfield burst decodes like the two pass decoder", "[Network][NetField]")
+{
+    // Game-Bench netField times the two decoders on the same traffic
+    constexpr u32 NUM_MESSAGES = 2000;
+
+    std::mt19937 random(17);
+    std::vector<u32> fieldValues(NUM_UNITS * MAX_FIELD_ID, 0);
+    std::vector<u32> referenceFieldValues(NUM_UNITS * MAX_FIELD_ID, 0);
+
+    ECS::Util::Network::NetFieldChangeBatch<TestField> changes;
+    std::vector<std::pair<u32, u16>> referenceChanges;
+
+    for (u32 i = 0; i < NUM_MESSAGES; i++)
+    {
+        u32 unitIndex = std::uniform_int_distribution<u32>(0, NUM_UNITS - 1)(random);
+        std::shared_ptr<Bytebuffer> buffer = BuildNetFieldMessage(unitIndex, MakeBurstFields(random));
+
+        REQUIRE(DecodeNetFieldMessage(*buffer, unitIndex, fieldValues, changes));
+        REQUIRE(DecodeNetFieldMessageReference(*buffer, unitIndex, referenceFieldValues, referenceChanges));
+    }
+
+    CHECK(fieldValues == referenceFieldValues);
+
+    std::vector<std::pair<u32, u16>> notified;
+    changes.Flush([&notified](const ECS::Util::Network::NetFieldChangeBatch<TestField>::Change& change)
+    {
+        notified.push_back({ entt::to_integral(change.entity), static_cast<u16>(change.field) });
+    });
+    CHECK(notified == referenceChanges);
+}
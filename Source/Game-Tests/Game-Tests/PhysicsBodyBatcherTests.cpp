@@ -0,0 +1,142 @@
+#include "Game-Lib/ECS/Singletons/JoltState.h"
+#include "Game-Lib/Util/PhysicsBodyBatcher.h"
+
+#include <FileFormat/Shared.h>
+
+#include <catch2/catch2.hpp>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/RegisterTypes.h>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+    void EnsureJoltInitialized()
+    {
+        if (JPH::Factory::sInstance != nullptr)
+            return;
+
+        JPH::RegisterDefaultAllocator();
+        JPH::Factory::sInstance = new JPH::Factory();
+        JPH::RegisterTypes();
+    }
+
+    std::unique_ptr<ECS::Singletons::JoltState> CreateJoltState()
+    {
+        EnsureJoltInitialized();
+
+        std::unique_ptr<ECS::Singletons::JoltState> joltState = std::make_unique<ECS::Singletons::JoltState>();
+        joltState->physicsSystem.Init(Jolt::Settings::maxBodies, Jolt::Settings::numBodyMutexes, Jolt::Settings::maxBodyPairs, Jolt::Settings::maxContactConstraints, joltState->broadPhaseLayerInterface, joltState->objectVSBroadPhaseLayerFilter, joltState->objectVSObjectLayerFilter);
+        return joltState;
+    }
+
+    JPH::BodyID CreateBox(JPH::BodyInterface& bodyInterface, const vec3& position)
+    {
+        JPH::BodyCreationSettings bodySettings(new JPH::BoxShape(JPH::Vec3(1.0f, 1.0f, 1.0f)), JPH::RVec3(position.x, position.y, position.z), JPH::Quat::sIdentity(), JPH::EMotionType::Static, Jolt::Layers::NON_MOVING);
+        JPH::Body* body = bodyInterface.CreateBody(bodySettings);
+        REQUIRE(body != nullptr);
+
+        return body->GetID();
+    }
+
+    bool HitsBody(JPH::PhysicsSystem& physicsSystem, const vec3& position, JPH::BodyID& outBodyID)
+    {
+        JPH::RRayCast ray(JPH::RVec3(position.x, position.y + 10.0f, position.z), JPH::Vec3(0.0f, -20.0f, 0.0f));
+        JPH::RayCastResult hit;
+        if (!physicsSystem.GetNarrowPhaseQuery().CastRay(ray, hit))
+            return false;
+
+        outBodyID = hit.mBodyID;
+        return true;
+    }
+}
+
+TEST_CASE("Batched static bodies end up in the broad phase like individually added ones", "[Physics][BodyBatcher]")
+{
+    u32 batchSize = GENERATE(0u, 7u, Util::PhysicsBodyBatcher::DEFAULT_MAX_BATCH_SIZE);
+
+    std::unique_ptr<ECS::Singletons::JoltState> joltState = CreateJoltState();
+    JPH::PhysicsSystem& physicsSystem = joltState->physicsSystem;
+    JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
+
+    Util::PhysicsBodyBatcher batcher;
+
+    std::vector<vec3> positions;
+    std::vector<JPH::BodyID> bodyIDs;
+    for (u32 x = 0; x < 20; x++)
+    {
+        for (u32 z = 0; z < 20; z++)
+        {
+            vec3 position(static_cast<f32>(x) * 50.0f - 500.0f, 0.0f, static_cast<f32>(z) * 50.0f - 500.0f);
+            positions.push_back(position);
+            bodyIDs.push_back(CreateBox(bodyInterface, position));
+            batcher.QueueAdd(bodyIDs.back(), position);
+        }
+    }
+
+    // Nothing is visible to queries until the flush
+    JPH::BodyID hitBodyID;
+    CHECK_FALSE(HitsBody(physicsSystem, positions[0], hitBodyID));
+    CHECK(batcher.HasPendingWork());
+
+    // Unloaded before it was ever added
+    batcher.QueueRemove(bodyIDs[13]);
+
+    Util::PhysicsBodyBatcher::FlushStats stats = batcher.Flush(bodyInterface, JPH::EActivation::DontActivate, batchSize);
+    CHECK(stats.numAdded == bodyIDs.size() - 1);
+    CHECK(stats.numRemoved == 0);
+    CHECK_FALSE(batcher.HasPendingWork());
+    CHECK(physicsSystem.GetNumBodies() == bodyIDs.size() - 1);
+
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        INFO("body " << i);
+        if (i == 13)
+        {
+            CHECK_FALSE(HitsBody(physicsSystem, positions[i], hitBodyID));
+            continue;
+        }
+
+        REQUIRE(HitsBody(physicsSystem, positions[i], hitBodyID));
+        CHECK(hitBodyID == bodyIDs[i]);
+    }
+
+    for (size_t i = 0; i < bodyIDs.size(); i++)
+    {
+        if (i != 13)
+            batcher.QueueRemove(bodyIDs[i]);
+    }
+
+    stats = batcher.Flush(bodyInterface, JPH::EActivation::DontActivate, batchSize);
+    CHECK(stats.numRemoved == bodyIDs.size() - 1);
+    CHECK(physicsSystem.GetNumBodies() == 0);
+    CHECK_FALSE(HitsBody(physicsSystem, positions[0], hitBodyID));
+}
+
+TEST_CASE("Body batches follow a Morton curve over the map", "[Physics][BodyBatcher]")
+{
+    // Each quarter of the map is one contiguous run of codes
+    u32 minXMinZ = Util::PhysicsBodyBatcher::GetMortonCode(vec3(-1000.0f, 0.0f, -1000.0f));
+    u32 maxXMinZ = Util::PhysicsBodyBatcher::GetMortonCode(vec3(1000.0f, 0.0f, -1000.0f));
+    u32 minXMaxZ = Util::PhysicsBodyBatcher::GetMortonCode(vec3(-1000.0f, 0.0f, 1000.0f));
+    u32 maxXMaxZ = Util::PhysicsBodyBatcher::GetMortonCode(vec3(1000.0f, 100.0f, 1000.0f));
+    CHECK(minXMinZ < maxXMinZ);
+    CHECK(maxXMinZ < minXMaxZ);
+    CHECK(minXMaxZ < maxXMaxZ);
+    CHECK((minXMinZ >> 30) == 0);
+    CHECK((maxXMaxZ >> 30) == 3);
+
+    CHECK(Util::PhysicsBodyBatcher::GetMortonCode(vec3(-Terrain::MAP_HALF_SIZE, 0.0f, -Terrain::MAP_HALF_SIZE)) == 0);
+    CHECK(Util::PhysicsBodyBatcher::GetMortonCode(vec3(Terrain::MAP_HALF_SIZE, 0.0f, Terrain::MAP_HALF_SIZE)) == 0xFFFFFFFFu);
+
+    // Outside of the map clamps to its edge
+    CHECK(Util::PhysicsBodyBatcher::GetMortonCode(vec3(-1.0e6f, 0.0f, -1.0e6f)) == 0);
+    CHECK(Util::PhysicsBodyBatcher::GetMortonCode(vec3(1.0e6f, 0.0f, 1.0e6f)) == 0xFFFFFFFFu);
+}
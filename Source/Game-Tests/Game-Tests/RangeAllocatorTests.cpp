@@ -0,0 +1,97 @@
+#include "Game-Lib/Util/RangeAllocator.h"
+
+#include <catch2/catch2.hpp>
+
+TEST_CASE("Range allocator reuses freed ranges first fit", "[Util][RangeAllocator]")
+{
+    Util::RangeAllocator allocator;
+
+    u32 offset = 0;
+    CHECK_FALSE(allocator.Allocate(4, offset));
+
+    allocator.Free(0, 10);
+    allocator.Free(20, 5);
+    CHECK(allocator.GetNumFreeRanges() == 2);
+    CHECK(allocator.GetNumFreeElements() == 15);
+
+    SECTION("The first range that fits is split")
+    {
+        REQUIRE(allocator.Allocate(4, offset));
+        CHECK(offset == 0);
+        REQUIRE(allocator.Allocate(4, offset));
+        CHECK(offset == 4);
+        CHECK(allocator.GetNumFreeElements() == 7);
+
+        REQUIRE(allocator.Allocate(5, offset));
+        CHECK(offset == 20);
+        CHECK(allocator.GetNumFreeRanges() == 1);
+
+        CHECK_FALSE(allocator.Allocate(3, offset));
+        REQUIRE(allocator.Allocate(2, offset));
+        CHECK(offset == 8);
+        CHECK(allocator.GetNumFreeRanges() == 0);
+        CHECK(allocator.GetNumFreeElements() == 0);
+    }
+
+    SECTION("Ranges that do not fit are skipped")
+    {
+        REQUIRE(allocator.Allocate(10, offset));
+        CHECK(offset == 0);
+        CHECK_FALSE(allocator.Allocate(6, offset));
+    }
+
+    SECTION("Clear forgets every free range")
+    {
+        allocator.Clear();
+        CHECK(allocator.GetNumFreeRanges() == 0);
+        CHECK(allocator.GetNumFreeElements() == 0);
+        CHECK_FALSE(allocator.Allocate(1, offset));
+    }
+}
+
+TEST_CASE("Range allocator merges neighbouring free ranges", "[Util][RangeAllocator]")
+{
+    Util::RangeAllocator allocator;
+
+    allocator.Free(10, 5);
+    allocator.Free(30, 5);
+
+    SECTION("With the previous range")
+    {
+        allocator.Free(15, 5);
+        REQUIRE(allocator.GetNumFreeRanges() == 2);
+        CHECK(allocator.GetFreeRanges()[0].offset == 10);
+        CHECK(allocator.GetFreeRanges()[0].count == 10);
+    }
+
+    SECTION("With the next range")
+    {
+        allocator.Free(25, 5);
+        REQUIRE(allocator.GetNumFreeRanges() == 2);
+        CHECK(allocator.GetFreeRanges()[1].offset == 25);
+        CHECK(allocator.GetFreeRanges()[1].count == 10);
+    }
+
+    SECTION("With both ranges")
+    {
+        allocator.Free(15, 15);
+        REQUIRE(allocator.GetNumFreeRanges() == 1);
+        CHECK(allocator.GetFreeRanges()[0].offset == 10);
+        CHECK(allocator.GetFreeRanges()[0].count == 25);
+
+        u32 offset = 0;
+        REQUIRE(allocator.Allocate(25, offset));
+        CHECK(offset == 10);
+    }
+
+    SECTION("Ranges that do not touch stay apart and sorted")
+    {
+        allocator.Free(0, 5);
+        allocator.Free(20, 5);
+        REQUIRE(allocator.GetNumFreeRanges() == 4);
+        CHECK(allocator.GetFreeRanges()[0].offset == 0);
+        CHECK(allocator.GetFreeRanges()[1].offset == 10);
+        CHECK(allocator.GetFreeRanges()[2].offset == 20);
+        CHECK(allocator.GetFreeRanges()[3].offset == 30);
+    }
+}
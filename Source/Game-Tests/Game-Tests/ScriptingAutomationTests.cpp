@@ -12,7 +12,6 @@
 #include <chrono>
 #include <memory>
 #include <string>
-#include <thread>
 
 namespace
 {
@@ -26,6 +25,7 @@ namespace
 
             _gameHandler = std::make_unique<Scripting::Game::GameHandler>();
             _schedulerHandler = std::make_unique<Scripting::Scheduler::SchedulerHandler>();
+            _schedulerHandler->SetClock([this]() { return _now; });
             _luaManager.SetLuaHandler(
                 static_cast<Scripting::LuaHandlerID>(MetaGen::Game::Lua::LuaHandlerTypeEnum::Game),
                 _gameHandler.get());
@@ -78,6 +78,12 @@ namespace
             return value;
         }
 
+        // AfterSeconds deadlines only come due when the test moves this clock forward
+        void AdvanceClock(std::chrono::milliseconds duration)
+        {
+            _now += duration;
+        }
+
         Scripting::Game::GameHandler& GameHandler() { return *_gameHandler; }
         Scripting::Scheduler::SchedulerHandler& SchedulerHandler() { return *_schedulerHandler; }
         Scripting::Zenith* Zenith() { return _zenith; }
@@ -88,6 +94,7 @@ namespace
         std::unique_ptr<Scripting::Game::GameHandler> _gameHandler;
         std::unique_ptr<Scripting::Scheduler::SchedulerHandler> _schedulerHandler;
         Scripting::Zenith* _zenith = nullptr;
+        Scripting::Scheduler::SchedulerHandler::Clock::time_point _now = { };
     };
 }
 
@@ -133,7 +140,11 @@ TEST_CASE("Native automation primitives support deterministic script execution")
     harness.SchedulerHandler().Update(harness.Zenith(), 0.0f);
     CHECK_FALSE(harness.GetGlobalBoolean("delayedFired"));
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    harness.AdvanceClock(std::chrono::milliseconds(49));
+    harness.SchedulerHandler().Update(harness.Zenith(), 0.0f);
+    CHECK_FALSE(harness.GetGlobalBoolean("delayedFired"));
+
+    harness.AdvanceClock(std::chrono::milliseconds(1));
     harness.SchedulerHandler().Update(harness.Zenith(), 0.0f);
     CHECK(harness.GetGlobalBoolean("delayedFired"));
 
@@ -183,3 +194,65 @@ TEST_CASE("Native automation primitives support deterministic script execution")
     REQUIRE(harness.Execute("gameLoadedAfterClear = Game.IsLoaded()"));
     CHECK_FALSE(harness.GetGlobalBoolean("gameLoadedAfterClear"));
 }
+
+TEST_CASE("Scheduler keeps registration order with 100k pending timers", "[Scripting][Scheduler]")
+{
+    ScriptingAutomationHarness harness;
+
+    // Cancelling four out of five timers makes the queues compact several times before anything comes due
+    REQUIRE(harness.Execute(R"(
+        fired = 0
+        outOfOrder = 0
+        lastFired = 0
+        handles = {}
+
+        for i = 1, 100000 do
+            handles[i] = Scheduler.AfterFrames((i % 50) + 1, function()
+                if i < lastFired then
+                    outOfOrder += 1
+                end
+                lastFired = i
+                fired += 1
+            end)
+        end
+
+        cancelled = 0
+        for i = 1, 100000 do
+            if i % 5 ~= 0 and Scheduler.Cancel(handles[i]) then
+                cancelled += 1
+            end
+        end
+
+        hourFired = 0
+        for i = 1, 100000 do
+            Scheduler.AfterSeconds(3600, function()
+                hourFired += 1
+            end)
+        end
+    )"));
+
+    CHECK(harness.GetGlobalInteger("cancelled") == 80000);
+
+    for (u32 frame = 0; frame < 50; frame++)
+    {
+        REQUIRE(harness.Execute("lastFired = 0"));
+        harness.SchedulerHandler().Update(harness.Zenith(), 0.0f);
+    }
+
+    CHECK(harness.GetGlobalInteger("fired") == 20000);
+    CHECK(harness.GetGlobalInteger("outOfOrder") == 0);
+
+    // Nothing is due for the next hour, Game-Bench scheduler times these idle updates
+    for (u32 frame = 0; frame < 1000; frame++)
+    {
+        harness.AdvanceClock(std::chrono::milliseconds(1000));
+        harness.SchedulerHandler().Update(harness.Zenith(), 0.0f);
+    }
+
+    CHECK(harness.GetGlobalInteger("fired") == 20000);
+    CHECK(harness.GetGlobalInteger("hourFired") == 0);
+
+    harness.AdvanceClock(std::chrono::milliseconds(2600 * 1000));
+    harness.SchedulerHandler().Update(harness.Zenith(), 0.0f);
+    CHECK(harness.GetGlobalInteger("hourFired") == 100000);
+}
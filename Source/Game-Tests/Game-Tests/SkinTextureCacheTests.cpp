@@ -0,0 +1,183 @@
+#include "Game-Lib/Rendering/Texture/SkinTextureCache.h"
+
+#include <catch2/catch2.hpp>
+
+#include <vector>
+
+namespace
+{
+    class FakeBackend : public SkinTextureCache::Backend
+    {
+    public:
+        void DestroySkinTexture(u64 key, Renderer::TextureID textureID) override
+        {
+            destroyedKeys.push_back(key);
+        }
+
+    public:
+        std::vector<u64> destroyedKeys;
+    };
+
+    SkinTextureDesc MakeDesc()
+    {
+        SkinTextureDesc desc;
+        desc.race = 1;
+        desc.gender = 0;
+        desc.skinID = 3;
+        desc.faceID = 2;
+
+        desc.AddLayer(100, 0);
+        desc.AddLayer(200, 5);
+        desc.AddLayer(300, 4);
+
+        return desc;
+    }
+}
+
+TEST_CASE("Skin texture desc gives the same key for the same customization", "[Rendering][SkinTextureCache]")
+{
+    SkinTextureDesc a = MakeDesc();
+    SkinTextureDesc b = MakeDesc();
+    CHECK(a.GetKey() == b.GetKey());
+
+    // Layers without a texture do not change what ends up in the skin
+    b.AddLayer(0, 6);
+    CHECK(a.GetKey() == b.GetKey());
+
+    b.Reset();
+    CHECK(b.layers.empty());
+    CHECK(b.GetKey() == SkinTextureDesc().GetKey());
+}
+
+TEST_CASE("Skin texture desc key changes with every part of the customization", "[Rendering][SkinTextureCache]")
+{
+    u64 key = MakeDesc().GetKey();
+
+    SkinTextureDesc desc = MakeDesc();
+    desc.race = 2;
+    CHECK(desc.GetKey() != key);
+
+    desc = MakeDesc();
+    desc.gender = 1;
+    CHECK(desc.GetKey() != key);
+
+    desc = MakeDesc();
+    desc.skinID = 4;
+    CHECK(desc.GetKey() != key);
+
+    desc = MakeDesc();
+    desc.faceID = 1;
+    CHECK(desc.GetKey() != key);
+
+    desc = MakeDesc();
+    desc.layers[1].textureHash = 201;
+    CHECK(desc.GetKey() != key);
+
+    desc = MakeDesc();
+    desc.layers[1].section = 6;
+    CHECK(desc.GetKey() != key);
+
+    desc = MakeDesc();
+    desc.AddLayer(400, 7);
+    CHECK(desc.GetKey() != key);
+}
+
+TEST_CASE("Skin texture desc key depends on the layer order", "[Rendering][SkinTextureCache]")
+{
+    SkinTextureDesc a = MakeDesc();
+
+    SkinTextureDesc b = MakeDesc();
+    std::swap(b.layers[1], b.layers[2]);
+
+    CHECK(a.GetKey() != b.GetKey());
+}
+
+TEST_CASE("Skin texture cache shares a skin between everything that acquires its key", "[Rendering][SkinTextureCache]")
+{
+    FakeBackend backend;
+    SkinTextureCache cache(&backend);
+    cache.SetBudget(1024);
+
+    Renderer::TextureID textureID;
+    CHECK_FALSE(cache.Acquire(1, textureID));
+    cache.Add(1, Renderer::TextureID(7), 256);
+
+    REQUIRE(cache.Acquire(1, textureID));
+    CHECK(textureID == Renderer::TextureID(7));
+
+    SkinTextureCache::Stats stats = cache.GetStats();
+    CHECK(stats.numReferenced == 1);
+    CHECK(stats.numHits == 1);
+    CHECK(stats.numMisses == 1);
+
+    // Still in use by the second reference
+    cache.Release(1);
+    CHECK(cache.GetStats().numUnused == 0);
+
+    cache.Release(1);
+    stats = cache.GetStats();
+    CHECK(stats.numReferenced == 0);
+    CHECK(stats.numUnused == 1);
+    CHECK(stats.unusedBytes == 256);
+    CHECK(backend.destroyedKeys.empty());
+}
+
+TEST_CASE("Skin texture cache hands unused skins back out without recreating them", "[Rendering][SkinTextureCache]")
+{
+    FakeBackend backend;
+    SkinTextureCache cache(&backend);
+    cache.SetBudget(1024);
+
+    Renderer::TextureID textureID;
+    CHECK_FALSE(cache.Acquire(1, textureID));
+    cache.Add(1, Renderer::TextureID(7), 256);
+    cache.Release(1);
+
+    REQUIRE(cache.Acquire(1, textureID));
+    CHECK(textureID == Renderer::TextureID(7));
+
+    SkinTextureCache::Stats stats = cache.GetStats();
+    CHECK(stats.numReferenced == 1);
+    CHECK(stats.numUnused == 0);
+    CHECK(stats.unusedBytes == 0);
+
+    // Shrinking the budget never touches skins that are in use
+    cache.SetBudget(0);
+    CHECK(backend.destroyedKeys.empty());
+
+    cache.Release(1);
+    CHECK(backend.destroyedKeys == std::vector<u64>{ 1 });
+}
+
+TEST_CASE("Skin texture cache destroys the least recently used unused skins over budget", "[Rendering][SkinTextureCache]")
+{
+    FakeBackend backend;
+    SkinTextureCache cache(&backend);
+    cache.SetBudget(512);
+
+    Renderer::TextureID textureID;
+    for (u64 key = 1; key <= 3; key++)
+    {
+        CHECK_FALSE(cache.Acquire(key, textureID));
+        cache.Add(key, Renderer::TextureID(static_cast<Renderer::TextureID::type>(key)), 256);
+    }
+
+    cache.Release(1);
+    cache.Release(2);
+    CHECK(backend.destroyedKeys.empty());
+
+    cache.Release(3);
+    CHECK(backend.destroyedKeys == std::vector<u64>{ 1 });
+    CHECK_FALSE(cache.Acquire(1, textureID));
+
+    // Reusing a skin and releasing it again makes it the most recently used one
+    REQUIRE(cache.Acquire(2, textureID));
+    cache.Release(2);
+
+    cache.SetBudget(256);
+    CHECK(backend.destroyedKeys == std::vector<u64>{ 1, 3 });
+
+    SkinTextureCache::Stats stats = cache.GetStats();
+    CHECK(stats.numUnused == 1);
+    CHECK(stats.numEvictions == 2);
+}
@@ -0,0 +1,261 @@
+#include "Game-Lib/ECS/SystemGraph.h"
+
+#include <catch2/catch2.hpp>
+
+#include <enkiTS/TaskScheduler.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct ResourceA {};
+    struct ResourceB {};
+    struct ResourceC {};
+    struct ResourceD {};
+
+    constexpr u32 NumSyntheticResources = 6;
+
+    // Tracks how many systems currently read or write each resource, any overlap with a writer is a data race
+    struct RaceTracker
+    {
+    public:
+        std::array<std::atomic<i32>, NumSyntheticResources> readers = {};
+        std::array<std::atomic<i32>, NumSyntheticResources> writers = {};
+        std::atomic<bool> raceDetected = false;
+
+        void Begin(const std::vector<u32>& reads, const std::vector<u32>& writes)
+        {
+            for (u32 resource : writes)
+            {
+                if (writers[resource].fetch_add(1) != 0 || readers[resource].load() != 0)
+                    raceDetected = true;
+            }
+
+            for (u32 resource : reads)
+            {
+                readers[resource].fetch_add(1);
+                if (writers[resource].load() != 0)
+                    raceDetected = true;
+            }
+        }
+
+        void End(const std::vector<u32>& reads, const std::vector<u32>& writes)
+        {
+            for (u32 resource : reads)
+                readers[resource].fetch_sub(1);
+
+            for (u32 resource : writes)
+                writers[resource].fetch_sub(1);
+        }
+    };
+
+    struct SyntheticSystem
+    {
+    public:
+        std::vector<u32> reads;
+        std::vector<u32> writes;
+        bool mainThread = false;
+    };
+
+    std::vector<SyntheticSystem> MakeRandomSystems(u32 seed, u32 numSystems)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<u32> resourceDist(0, NumSyntheticResources - 1);
+        std::uniform_int_distribution<u32> countDist(0, 2);
+
+        std::vector<SyntheticSystem> systems(numSystems);
+        for (SyntheticSystem& system : systems)
+        {
+            u32 numReads = countDist(rng);
+            for (u32 i = 0; i < numReads; i++)
+                system.reads.push_back(resourceDist(rng));
+
+            u32 numWrites = countDist(rng);
+            for (u32 i = 0; i < numWrites; i++)
+            {
+                u32 resource = resourceDist(rng);
+                if (std::find(system.writes.begin(), system.writes.end(), resource) == system.writes.end())
+                    system.writes.push_back(resource);
+            }
+
+            // A resource that is both read and written is only tracked as a write
+            std::erase_if(system.reads, [&system](u32 resource)
+            {
+                return std::find(system.writes.begin(), system.writes.end(), resource) != system.writes.end();
+            });
+            std::sort(system.reads.begin(), system.reads.end());
+            system.reads.erase(std::unique(system.reads.begin(), system.reads.end()), system.reads.end());
+
+            system.mainThread = countDist(rng) == 0;
+        }
+
+        return systems;
+    }
+
+    void SpinFor(std::chrono::microseconds duration)
+    {
+        auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+TEST_CASE("System graph orders conflicting systems and leaves independent ones unordered", "[ECS][SystemGraph]")
+{
+    ECS::SystemGraph graph;
+
+    u32 writerA = graph.AddSystem("WriterA", ECS::SystemAccess().Write<ResourceA>(), [](f32) {});
+    u32 readerA = graph.AddSystem("ReaderA", ECS::SystemAccess().Read<ResourceA>(), [](f32) {});
+    u32 readerA2 = graph.AddSystem("ReaderA2", ECS::SystemAccess().Read<ResourceA>(), [](f32) {});
+    u32 writerB = graph.AddSystem("WriterB", ECS::SystemAccess().Write<ResourceB>(), [](f32) {});
+    u32 writerAB = graph.AddSystem("WriterAB", ECS::SystemAccess().Write<ResourceA, ResourceB>(), [](f32) {});
+    u32 readerC = graph.AddSystem("ReaderC", ECS::SystemAccess().Read<ResourceC>(), [](f32) {});
+    graph.Build();
+
+    REQUIRE(graph.IsBuilt());
+    CHECK(graph.GetSystem(writerA).dependencies.empty());
+    CHECK(graph.GetSystem(readerA).dependencies == std::vector<u32>{ writerA });
+    CHECK(graph.GetSystem(readerA2).dependencies == std::vector<u32>{ writerA });
+    CHECK(graph.GetSystem(writerB).dependencies.empty());
+    CHECK(graph.GetSystem(writerAB).dependencies == std::vector<u32>{ readerA, readerA2, writerB });
+    CHECK(graph.GetSystem(readerC).dependencies.empty());
+
+    // WriterA -> ReaderA -> WriterAB
+    CHECK(graph.GetCriticalPathLength() == 3);
+}
+
+TEST_CASE("System graph removes dependencies that are already implied", "[ECS][SystemGraph]")
+{
+    ECS::SystemGraph graph;
+
+    u32 first = graph.AddSystem("First", ECS::SystemAccess().Write<ResourceA, ResourceB>(), [](f32) {});
+    u32 second = graph.AddSystem("Second", ECS::SystemAccess().Write<ResourceA>(), [](f32) {});
+    u32 third = graph.AddSystem("Third", ECS::SystemAccess().Write<ResourceA>().Read<ResourceB>(), [](f32) {});
+    graph.Build();
+
+    CHECK(graph.GetSystem(second).dependencies == std::vector<u32>{ first });
+    CHECK(graph.GetSystem(third).dependencies == std::vector<u32>{ second });
+    CHECK(graph.GetSystem(first).dependents == std::vector<u32>{ second });
+}
+
+TEST_CASE("System graph serial fallback runs systems in registration order", "[ECS][SystemGraph]")
+{
+    ECS::SystemGraph graph;
+
+    std::vector<u32> executionOrder;
+    for (u32 i = 0; i < 8; i++)
+    {
+        graph.AddSystem("System", ECS::SystemAccess().Read<ResourceD>(), [i, &executionOrder](f32 deltaTime)
+        {
+            CHECK(deltaTime == 0.5f);
+            executionOrder.push_back(i);
+        });
+    }
+    graph.Build();
+
+    graph.Execute(nullptr, 0.5f);
+    CHECK(executionOrder == std::vector<u32>{ 0, 1, 2, 3, 4, 5, 6, 7 });
+
+    executionOrder.clear();
+    enki::TaskScheduler taskScheduler;
+    taskScheduler.Initialize(4);
+    graph.Execute(&taskScheduler, 0.5f, true);
+    CHECK(executionOrder == std::vector<u32>{ 0, 1, 2, 3, 4, 5, 6, 7 });
+}
+
+TEST_CASE("System graph parallel execution respects dependencies and is free of data races", "[ECS][SystemGraph]")
+{
+    enki::TaskScheduler taskScheduler;
+    taskScheduler.Initialize(4);
+
+    std::thread::id mainThreadID = std::this_thread::get_id();
+
+    for (u32 seed = 0; seed < 16; seed++)
+    {
+        std::vector<SyntheticSystem> syntheticSystems = MakeRandomSystems(seed, 24);
+        u32 numSystems = static_cast<u32>(syntheticSystems.size());
+
+        RaceTracker raceTracker;
+        std::atomic<u32> sequence = 0;
+        std::vector<u32> startSequence(numSystems, 0);
+        std::vector<u32> endSequence(numSystems, 0);
+        std::atomic<bool> mainThreadViolated = false;
+
+        ECS::SystemGraph graph;
+        for (u32 i = 0; i < numSystems; i++)
+        {
+            const SyntheticSystem& synthetic = syntheticSystems[i];
+
+            ECS::SystemAccess access;
+            for (u32 resource : synthetic.reads)
+                access.AddRead(resource);
+            for (u32 resource : synthetic.writes)
+                access.AddWrite(resource);
+            if (synthetic.mainThread)
+                access.MainThread();
+
+            graph.AddSystem("Synthetic", access, [&, i](f32)
+            {
+                const SyntheticSystem& system = syntheticSystems[i];
+                if (system.mainThread && std::this_thread::get_id() != mainThreadID)
+                    mainThreadViolated = true;
+
+                startSequence[i] = sequence.fetch_add(1);
+                raceTracker.Begin(system.reads, system.writes);
+                SpinFor(std::chrono::microseconds(100));
+                raceTracker.End(system.reads, system.writes);
+                endSequence[i] = sequence.fetch_add(1);
+            });
+        }
+        graph.Build();
+
+        for (u32 frame = 0; frame < 4; frame++)
+        {
+            std::fill(startSequence.begin(), startSequence.end(), 0);
+            std::fill(endSequence.begin(), endSequence.end(), 0);
+            sequence = 1;
+
+            graph.Execute(&taskScheduler, 1.0f / 60.0f);
+
+            CHECK_FALSE(raceTracker.raceDetected);
+            CHECK_FALSE(mainThreadViolated);
+
+            for (u32 i = 0; i < numSystems; i++)
+            {
+                // Every system ran exactly once this frame
+                REQUIRE(startSequence[i] != 0);
+                REQUIRE(endSequence[i] != 0);
+
+                for (u32 dependency : graph.GetSystem(i).dependencies)
+                {
+                    CHECK(endSequence[dependency] < startSequence[i]);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("System graph records how long each system took", "[ECS][SystemGraph]")
+{
+    ECS::SystemGraph graph;
+    u32 slow = graph.AddSystem("Slow", ECS::SystemAccess().Write<ResourceA>(), [](f32) { SpinFor(std::chrono::milliseconds(5)); });
+    u32 fast = graph.AddSystem("Fast", ECS::SystemAccess().Write<ResourceB>(), [](f32) {});
+    graph.Build();
+
+    CHECK(graph.GetSystem(slow).lastDurationMS == 0.0f);
+
+    enki::TaskScheduler taskScheduler;
+    taskScheduler.Initialize(4);
+    graph.Execute(&taskScheduler, 1.0f / 60.0f);
+
+    CHECK(graph.GetSystem(slow).lastDurationMS >= 5.0f);
+    CHECK(graph.GetSystem(fast).lastDurationMS < graph.GetSystem(slow).lastDurationMS);
+}
@@ -0,0 +1,352 @@
+#include "Game-Lib/Rendering/Terrain/TerrainLod.h"
+
+#include <catch2/catch2.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // Cell positions in half patches, so inner vertices land on whole numbers
+    constexpr i32 CELL_HALF_PATCHES = Terrain::CELL_INNER_GRID_STRIDE * 2;
+
+    std::pair<i32, i32> GetVertexPosition(u16 vertexID)
+    {
+        const u32 row = vertexID / Terrain::CELL_GRID_ROW_SIZE;
+        const u32 column = vertexID % Terrain::CELL_GRID_ROW_SIZE;
+
+        if (column >= Terrain::CELL_OUTER_GRID_STRIDE)
+            return { static_cast<i32>((column - Terrain::CELL_OUTER_GRID_STRIDE) * 2) + 1, static_cast<i32>(row * 2) + 1 };
+
+        return { static_cast<i32>(column * 2), static_cast<i32>(row * 2) };
+    }
+
+    i32 GetDoubleSignedArea(u16 a, u16 b, u16 c)
+    {
+        auto [ax, ay] = GetVertexPosition(a);
+        auto [bx, by] = GetVertexPosition(b);
+        auto [cx, cy] = GetVertexPosition(c);
+
+        return ((bx - ax) * (cy - ay)) - ((by - ay) * (cx - ax));
+    }
+
+    // Position along the edge if the vertex lies on it, -1 otherwise
+    i32 GetEdgePosition(u32 edge, u16 vertexID)
+    {
+        auto [x, y] = GetVertexPosition(vertexID);
+
+        switch (edge)
+        {
+            case TerrainLod::EDGE_TOP: return (y == 0) ? x : -1;
+            case TerrainLod::EDGE_RIGHT: return (x == CELL_HALF_PATCHES) ? y : -1;
+            case TerrainLod::EDGE_BOTTOM: return (y == CELL_HALF_PATCHES) ? x : -1;
+            default: return (x == 0) ? y : -1;
+        }
+    }
+
+    u32 GetOppositeEdge(u32 edge)
+    {
+        return (edge + 2) % TerrainLod::NUM_EDGES;
+    }
+
+    std::map<std::pair<u16, u16>, u32> GetDirectedEdges(const std::vector<u16>& indices, const TerrainLod::Pattern& pattern)
+    {
+        std::map<std::pair<u16, u16>, u32> directedEdges;
+
+        for (u32 i = pattern.firstIndex; i < pattern.firstIndex + pattern.indexCount; i += 3)
+        {
+            const u16 triangle[3] = { indices[i], indices[i + 1], indices[i + 2] };
+
+            for (u32 corner = 0; corner < 3; corner++)
+            {
+                directedEdges[{ triangle[corner], triangle[(corner + 1) % 3] }]++;
+            }
+        }
+
+        return directedEdges;
+    }
+
+    // The vertices the pattern puts on one of the cell edges, a neighbour has to put the same ones on its side
+    std::vector<i32> GetEdgeVertexPositions(const std::vector<u16>& indices, const TerrainLod::Pattern& pattern, u32 edge)
+    {
+        std::vector<i32> positions;
+
+        for (u32 i = pattern.firstIndex; i < pattern.firstIndex + pattern.indexCount; i++)
+        {
+            i32 position = GetEdgePosition(edge, indices[i]);
+            if (position >= 0)
+                positions.push_back(position);
+        }
+
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+        return positions;
+    }
+
+    u32 GetNumStitchMasks(u32 level)
+    {
+        return (level == TerrainLod::NUM_LEVELS - 1) ? 1 : TerrainLod::NUM_STITCH_MASKS;
+    }
+}
+
+TEST_CASE("Terrain LOD pattern 0 matches the original cell index buffer", "[Rendering][TerrainLod]")
+{
+    std::vector<u16> indices;
+    std::vector<TerrainLod::Pattern> patterns;
+    TerrainLod::BuildPatterns(indices, patterns);
+
+    REQUIRE(patterns.size() == TerrainLod::NUM_PATTERNS);
+
+    const TerrainLod::Pattern& fullPattern = patterns[TerrainLod::GetPatternID(0, 0)];
+    REQUIRE(fullPattern.firstIndex == 0);
+    REQUIRE(fullPattern.indexCount == Terrain::CELL_NUM_INDICES);
+
+    u32 index = 0;
+    for (u32 row = 0; row < Terrain::CELL_INNER_GRID_STRIDE; row++)
+    {
+        for (u32 col = 0; col < Terrain::CELL_INNER_GRID_STRIDE; col++)
+        {
+            const u16 topLeftVertex = static_cast<u16>((row * Terrain::CELL_GRID_ROW_SIZE) + col);
+            const u16 topRightVertex = topLeftVertex + 1;
+            const u16 bottomLeftVertex = topLeftVertex + Terrain::CELL_GRID_ROW_SIZE;
+            const u16 bottomRightVertex = bottomLeftVertex + 1;
+            const u16 centerVertex = topLeftVertex + Terrain::CELL_OUTER_GRID_STRIDE;
+
+            const u16 expected[12] = { topLeftVertex, centerVertex, topRightVertex, bottomLeftVertex, centerVertex, topLeftVertex, bottomRightVertex, centerVertex, bottomLeftVertex, topRightVertex, centerVertex, bottomRightVertex };
+            for (u16 expectedIndex : expected)
+            {
+                REQUIRE(indices[index++] == expectedIndex);
+            }
+        }
+    }
+}
+
+TEST_CASE("Terrain LOD patterns cover the whole cell without gaps or overlaps", "[Rendering][TerrainLod]")
+{
+    std::vector<u16> indices;
+    std::vector<TerrainLod::Pattern> patterns;
+    TerrainLod::BuildPatterns(indices, patterns);
+
+    for (u32 level = 0; level < TerrainLod::NUM_LEVELS; level++)
+    {
+        for (u32 stitchMask = 0; stitchMask < GetNumStitchMasks(level); stitchMask++)
+        {
+            CAPTURE(level, stitchMask);
+
+            const TerrainLod::Pattern& pattern = patterns[TerrainLod::GetPatternID(level, stitchMask)];
+            REQUIRE(pattern.indexCount % 3 == 0);
+
+            if (stitchMask == 0)
+            {
+                CHECK(pattern.indexCount / 3 == Terrain::CELL_NUM_TRIANGLES >> (2 * level));
+            }
+
+            // Same winding as the full detail triangles and together exactly the area of the cell
+            i32 totalDoubleArea = 0;
+            for (u32 i = pattern.firstIndex; i < pattern.firstIndex + pattern.indexCount; i += 3)
+            {
+                REQUIRE(indices[i] < Terrain::CELL_NUM_VERTICES);
+                REQUIRE(indices[i + 1] < Terrain::CELL_NUM_VERTICES);
+                REQUIRE(indices[i + 2] < Terrain::CELL_NUM_VERTICES);
+
+                i32 doubleArea = GetDoubleSignedArea(indices[i], indices[i + 1], indices[i + 2]);
+                REQUIRE(doubleArea < 0);
+                totalDoubleArea -= doubleArea;
+            }
+            CHECK(totalDoubleArea == 2 * CELL_HALF_PATCHES * CELL_HALF_PATCHES);
+
+            // Inside the cell every edge is shared by exactly two triangles, only the cell border has open edges
+            std::map<std::pair<u16, u16>, u32> directedEdges = GetDirectedEdges(indices, pattern);
+            for (const auto& [directedEdge, count] : directedEdges)
+            {
+                REQUIRE(count == 1);
+
+                if (directedEdges.contains({ directedEdge.second, directedEdge.first }))
+                    continue;
+
+                bool onBorder = false;
+                for (u32 edge = 0; edge < TerrainLod::NUM_EDGES; edge++)
+                {
+                    onBorder |= GetEdgePosition(edge, directedEdge.first) >= 0 && GetEdgePosition(edge, directedEdge.second) >= 0;
+                }
+                REQUIRE(onBorder);
+            }
+        }
+    }
+}
+
+TEST_CASE("Terrain LOD patterns line up with a neighbour one level coarser or finer", "[Rendering][TerrainLod]")
+{
+    std::vector<u16> indices;
+    std::vector<TerrainLod::Pattern> patterns;
+    TerrainLod::BuildPatterns(indices, patterns);
+
+    for (u32 level = 0; level < TerrainLod::NUM_LEVELS; level++)
+    {
+        for (u32 neighbourLevel = (level > 0) ? level - 1 : 0; neighbourLevel <= level + 1 && neighbourLevel < TerrainLod::NUM_LEVELS; neighbourLevel++)
+        {
+            for (u32 edge = 0; edge < TerrainLod::NUM_EDGES; edge++)
+            {
+                const u32 oppositeEdge = GetOppositeEdge(edge);
+
+                // The other edges can be stitched to anything, it must not change the shared one
+                for (u32 otherMask = 0; otherMask < GetNumStitchMasks(level); otherMask++)
+                {
+                    CAPTURE(level, neighbourLevel, edge, otherMask);
+
+                    u32 stitchMask = otherMask & ~(1u << edge);
+                    if (neighbourLevel > level)
+                        stitchMask |= 1u << edge;
+
+                    u32 neighbourStitchMask = (level > neighbourLevel) ? (1u << oppositeEdge) : 0;
+
+                    const TerrainLod::Pattern& pattern = patterns[TerrainLod::GetPatternID(level, stitchMask)];
+                    const TerrainLod::Pattern& neighbourPattern = patterns[TerrainLod::GetPatternID(neighbourLevel, neighbourStitchMask)];
+
+                    std::vector<i32> edgeVertices = GetEdgeVertexPositions(indices, pattern, edge);
+                    std::vector<i32> neighbourEdgeVertices = GetEdgeVertexPositions(indices, neighbourPattern, oppositeEdge);
+
+                    REQUIRE(edgeVertices == neighbourEdgeVertices);
+
+                    // The coarser side decides the spacing
+                    const i32 coarserStride = 2 << std::max(level, neighbourLevel);
+                    REQUIRE(edgeVertices.size() == static_cast<size_t>(CELL_HALF_PATCHES / coarserStride) + 1);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Terrain LOD finds neighbours across chunk borders", "[Rendering][TerrainLod]")
+{
+    const u32 firstChunkID = 0;
+    const u32 secondChunkID = 1; // To the right of the first one
+
+    std::vector<u32> cellGridIndices;
+    for (u32 chunkID : { firstChunkID, secondChunkID })
+    {
+        for (u32 cellID = 0; cellID < Terrain::CHUNK_NUM_CELLS; cellID++)
+        {
+            cellGridIndices.push_back(TerrainLod::GetCellGridIndex(chunkID, cellID));
+        }
+    }
+
+    // Hidden cells are not neighbours of anything
+    const u32 hiddenCellIndex = Terrain::CHUNK_NUM_CELLS + 17;
+    cellGridIndices[hiddenCellIndex] = TerrainLod::INVALID_CELL;
+
+    std::vector<TerrainLod::CellNeighbours> neighbours;
+    TerrainLod::BuildNeighbours(cellGridIndices, neighbours);
+    REQUIRE(neighbours.size() == cellGridIndices.size());
+
+    const u32 lastCellInFirstRow = Terrain::CHUNK_NUM_CELLS_PER_STRIDE - 1;
+    CHECK(neighbours[lastCellInFirstRow][TerrainLod::EDGE_RIGHT] == Terrain::CHUNK_NUM_CELLS);
+    CHECK(neighbours[Terrain::CHUNK_NUM_CELLS][TerrainLod::EDGE_LEFT] == lastCellInFirstRow);
+    CHECK(neighbours[0][TerrainLod::EDGE_TOP] == TerrainLod::INVALID_CELL);
+    CHECK(neighbours[0][TerrainLod::EDGE_LEFT] == TerrainLod::INVALID_CELL);
+    CHECK(neighbours[0][TerrainLod::EDGE_BOTTOM] == Terrain::CHUNK_NUM_CELLS_PER_STRIDE);
+
+    CHECK(neighbours[hiddenCellIndex - 1][TerrainLod::EDGE_RIGHT] == TerrainLod::INVALID_CELL);
+    CHECK(neighbours[hiddenCellIndex + 1][TerrainLod::EDGE_LEFT] == TerrainLod::INVALID_CELL);
+    for (u32 neighbourIndex : neighbours[hiddenCellIndex])
+    {
+        CHECK(neighbourIndex == TerrainLod::INVALID_CELL);
+    }
+}
+
+TEST_CASE("Terrain LOD keeps neighbours within one level and stitches the finer side", "[Rendering][TerrainLod]")
+{
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<u32> levelDistribution(0, TerrainLod::NUM_LEVELS - 1);
+    std::uniform_int_distribution<u32> hiddenDistribution(0, 9);
+
+    // Four chunks so the grid crosses chunk borders both ways
+    std::vector<u32> cellGridIndices;
+    for (u32 chunkID : { 0u, 1u, Terrain::CHUNK_NUM_PER_MAP_STRIDE, Terrain::CHUNK_NUM_PER_MAP_STRIDE + 1 })
+    {
+        for (u32 cellID = 0; cellID < Terrain::CHUNK_NUM_CELLS; cellID++)
+        {
+            cellGridIndices.push_back(hiddenDistribution(rng) == 0 ? TerrainLod::INVALID_CELL : TerrainLod::GetCellGridIndex(chunkID, cellID));
+        }
+    }
+
+    std::vector<TerrainLod::CellNeighbours> neighbours;
+    TerrainLod::BuildNeighbours(cellGridIndices, neighbours);
+
+    const u32 numCells = static_cast<u32>(cellGridIndices.size());
+    for (u32 iteration = 0; iteration < 8; iteration++)
+    {
+        std::vector<u8> selectedLevels(numCells);
+        for (u8& level : selectedLevels)
+        {
+            level = static_cast<u8>(levelDistribution(rng));
+        }
+
+        std::vector<u8> levels = selectedLevels;
+        TerrainLod::LimitNeighbourLevels(levels, neighbours);
+
+        for (u32 cellIndex = 0; cellIndex < numCells; cellIndex++)
+        {
+            CAPTURE(iteration, cellIndex);
+            REQUIRE(levels[cellIndex] <= selectedLevels[cellIndex]);
+
+            // Only refined as far as a finer neighbour forces it
+            bool forcedByNeighbour = false;
+            for (u32 edge = 0; edge < TerrainLod::NUM_EDGES; edge++)
+            {
+                const u32 neighbourIndex = neighbours[cellIndex][edge];
+                if (neighbourIndex == TerrainLod::INVALID_CELL)
+                    continue;
+
+                REQUIRE(std::abs(static_cast<i32>(levels[cellIndex]) - static_cast<i32>(levels[neighbourIndex])) <= 1);
+                forcedByNeighbour |= levels[neighbourIndex] + 1 == levels[cellIndex];
+            }
+            REQUIRE((levels[cellIndex] == selectedLevels[cellIndex] || forcedByNeighbour));
+
+            const u32 stitchMask = TerrainLod::GetStitchMask(levels, neighbours[cellIndex], cellIndex);
+            for (u32 edge = 0; edge < TerrainLod::NUM_EDGES; edge++)
+            {
+                const u32 neighbourIndex = neighbours[cellIndex][edge];
+                const bool neighbourIsCoarser = neighbourIndex != TerrainLod::INVALID_CELL && levels[neighbourIndex] > levels[cellIndex];
+                REQUIRE(((stitchMask >> edge) & 1) == static_cast<u32>(neighbourIsCoarser));
+            }
+
+            if (levels[cellIndex] == TerrainLod::NUM_LEVELS - 1)
+            {
+                REQUIRE(stitchMask == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("Terrain LOD picks coarser levels for distant and flat cells", "[Rendering][TerrainLod]")
+{
+    const f32 pixelsPerUnit = 1000.0f;
+    const f32 maxPixelError = 2.0f;
+    const f32 heightSpan = 20.0f;
+
+    CHECK(TerrainLod::SelectLevel(heightSpan, 0.0f, pixelsPerUnit, maxPixelError) == 0);
+    CHECK(TerrainLod::SelectLevel(0.0f, 0.0f, pixelsPerUnit, maxPixelError) == TerrainLod::NUM_LEVELS - 1);
+    CHECK(TerrainLod::SelectLevel(heightSpan, 1000000.0f, pixelsPerUnit, maxPixelError) == TerrainLod::NUM_LEVELS - 1);
+
+    u32 previousLevel = 0;
+    for (f32 distance = 1.0f; distance < 100000.0f; distance *= 1.5f)
+    {
+        CAPTURE(distance);
+
+        const u32 level = TerrainLod::SelectLevel(heightSpan, distance, pixelsPerUnit, maxPixelError);
+        REQUIRE(level >= previousLevel);
+        REQUIRE(TerrainLod::GetLevelError(level, heightSpan) * pixelsPerUnit / distance <= maxPixelError);
+
+        if (level + 1 < TerrainLod::NUM_LEVELS)
+        {
+            REQUIRE(TerrainLod::GetLevelError(level + 1, heightSpan) * pixelsPerUnit / distance > maxPixelError);
+        }
+
+        previousLevel = level;
+    }
+    CHECK(previousLevel == TerrainLod::NUM_LEVELS - 1);
+}
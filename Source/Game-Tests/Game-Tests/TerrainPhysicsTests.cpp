@@ -0,0 +1,297 @@
+#include "Game-Lib/Util/TerrainPhysicsUtil.h"
+
+#include <Base/Util/DebugHandler.h>
+
+#include <FileFormat/Novus/Map/MapChunk.h>
+
+#include <catch2/catch2.hpp>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/Shape/SubShapeID.h>
+#include <Jolt/RegisterTypes.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr f32 RAY_TOP = 1000.0f;
+    constexpr f32 RAY_LENGTH = 2000.0f;
+
+    // The height field is built for this quantization error
+    constexpr f32 QUANTIZATION_TOLERANCE = 0.0125f;
+
+    void EnsureJoltInitialized()
+    {
+        if (JPH::Factory::sInstance != nullptr)
+            return;
+
+        JPH::RegisterDefaultAllocator();
+        JPH::Factory::sInstance = new JPH::Factory();
+        JPH::RegisterTypes();
+    }
+
+    f32 SampleTestHeight(f32 x, f32 z)
+    {
+        return 12.0f * std::sin(x / 45.0f) + 8.0f * std::cos(z / 38.0f) + 0.01f * x;
+    }
+
+    std::unique_ptr<Map::Chunk> MakeTestChunk(bool withHoles)
+    {
+        std::unique_ptr<Map::Chunk> chunk = std::make_unique<Map::Chunk>();
+
+        for (u32 cellID = 0; cellID < Terrain::CHUNK_NUM_CELLS; cellID++)
+        {
+            u32 cellX = cellID % Terrain::CHUNK_NUM_CELLS_PER_STRIDE;
+            u32 cellY = cellID / Terrain::CHUNK_NUM_CELLS_PER_STRIDE;
+
+            for (u32 vertexID = 0; vertexID < Terrain::CELL_TOTAL_GRID_SIZE; vertexID++)
+            {
+                u32 vertexX = vertexID % Terrain::CELL_GRID_ROW_SIZE;
+                u32 vertexY = vertexID / Terrain::CELL_GRID_ROW_SIZE;
+                bool isInner = vertexX >= Terrain::CELL_OUTER_GRID_STRIDE;
+
+                f32 gx = static_cast<f32>(cellX * Terrain::CELL_NUM_PATCHES_PER_STRIDE) + (isInner ? static_cast<f32>(vertexX - Terrain::CELL_OUTER_GRID_STRIDE) + 0.5f : static_cast<f32>(vertexX));
+                f32 gy = static_cast<f32>(cellY * Terrain::CELL_NUM_PATCHES_PER_STRIDE + vertexY) + (isInner ? 0.5f : 0.0f);
+
+                chunk->cellsData.heightField[cellID][vertexID] = SampleTestHeight(gx * Terrain::PATCH_SIZE, -gy * Terrain::PATCH_SIZE);
+            }
+
+            if (withHoles && cellID % 7 == 3)
+                chunk->cellsData.holes[cellID] = 0x00000000FF00FF00ull;
+
+            // A few distinct base layers spread over the chunk
+
+            chunk->cellsData.layerTextureIDs[cellID][0] = 1000 + ((cellX / 4) + (cellY / 4) * 4);
+        }
+
+        return chunk;
+    }
+
+    bool CastDown(const JPH::Shape& shape, f32 x, f32 z, f32& outHeight, JPH::SubShapeID& outSubShapeID)
+    {
+        JPH::RayCast ray{ JPH::Vec3(x, RAY_TOP, z), JPH::Vec3(0.0f, -RAY_LENGTH, 0.0f) };
+        JPH::RayCastResult hit;
+        if (!shape.CastRay(ray, JPH::SubShapeIDCreator(), hit))
+            return false;
+
+        outHeight = RAY_TOP - hit.mFraction * RAY_LENGTH;
+        outSubShapeID = hit.mSubShapeID2;
+        return true;
+    }
+
+    // Two quadrants of every patch are split along the other diagonal than the render fan. The error peaks at their
+    // centers, a quarter of how far the patch center sits off the line between the two corners the quadrant doesn't touch
+    f32 GetMaxTriangulationError(const Map::Chunk& chunk)
+    {
+        f32 maxError = 0.0f;
+
+        for (u32 cellID = 0; cellID < Terrain::CHUNK_NUM_CELLS; cellID++)
+        {
+            const auto& heights = chunk.cellsData.heightField[cellID];
+
+            for (u32 patchID = 0; patchID < Terrain::CELL_NUM_PATCHES_PER_STRIDE * Terrain::CELL_NUM_PATCHES_PER_STRIDE; patchID++)
+            {
+                u32 corner = (patchID % Terrain::CELL_NUM_PATCHES_PER_STRIDE) + ((patchID / Terrain::CELL_NUM_PATCHES_PER_STRIDE) * Terrain::CELL_GRID_ROW_SIZE);
+                f32 center = heights[corner + Terrain::CELL_OUTER_GRID_STRIDE];
+                f32 a = heights[corner];
+                f32 b = heights[corner + 1];
+                f32 c = heights[corner + Terrain::CELL_GRID_ROW_SIZE + 1];
+                f32 d = heights[corner + Terrain::CELL_GRID_ROW_SIZE];
+
+                maxError = glm::max(maxError, std::abs(2.0f * center - a - c) * 0.25f);
+                maxError = glm::max(maxError, std::abs(2.0f * center - b - d) * 0.25f);
+            }
+        }
+
+        return maxError;
+    }
+}
+
+TEST_CASE("Terrain height field matches the chunk mesh", "[Physics][TerrainPhysics]")
+{
+    EnsureJoltInitialized();
+
+    std::unique_ptr<Map::Chunk> chunk = MakeTestChunk(false);
+    JPH::ShapeRefC meshShape = Util::TerrainPhysics::CreateMeshShape(*chunk);
+    JPH::ShapeRefC heightFieldShape = Util::TerrainPhysics::CreateHeightFieldShape(*chunk);
+    REQUIRE(meshShape != nullptr);
+    REQUIRE(heightFieldShape != nullptr);
+
+    constexpr u32 patchStride = Terrain::CHUNK_NUM_CELLS_PER_STRIDE * Terrain::CELL_NUM_PATCHES_PER_STRIDE;
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<u32> patchDistribution(0, patchStride - 1);
+    std::uniform_real_distribution<f32> offsetDistribution(0.05f, 0.95f);
+
+    const f32 heightTolerance = GetMaxTriangulationError(*chunk) + QUANTIZATION_TOLERANCE;
+
+    u32 numHits = 0;
+    f32 maxHeightError = 0.0f;
+
+    for (u32 i = 0; i < 20000; i++)
+    {
+        u32 patchX = patchDistribution(rng);
+        u32 patchY = patchDistribution(rng);
+        f32 x = (static_cast<f32>(patchX) + offsetDistribution(rng)) * Terrain::PATCH_SIZE;
+        f32 z = -(static_cast<f32>(patchY) + offsetDistribution(rng)) * Terrain::PATCH_SIZE;
+
+        f32 meshHeight = 0.0f;
+        f32 heightFieldHeight = 0.0f;
+        JPH::SubShapeID meshSubShapeID;
+        JPH::SubShapeID heightFieldSubShapeID;
+        bool meshHit = CastDown(*meshShape, x, z, meshHeight, meshSubShapeID);
+        bool heightFieldHit = CastDown(*heightFieldShape, x, z, heightFieldHeight, heightFieldSubShapeID);
+
+        REQUIRE(meshHit);
+        REQUIRE(heightFieldHit);
+
+        numHits++;
+        maxHeightError = glm::max(maxHeightError, std::abs(meshHeight - heightFieldHeight));
+        CHECK(std::abs(meshHeight - heightFieldHeight) <= heightTolerance);
+
+        u32 cellID = (patchX / Terrain::CELL_NUM_PATCHES_PER_STRIDE) + (patchY / Terrain::CELL_NUM_PATCHES_PER_STRIDE) * Terrain::CHUNK_NUM_CELLS_PER_STRIDE;
+        const auto* material = static_cast<const Util::TerrainPhysics::TerrainPhysicsMaterial*>(heightFieldShape->GetMaterial(heightFieldSubShapeID));
+        REQUIRE(material != nullptr);
+        CHECK(material->GetLayerTextureID() == chunk->cellsData.layerTextureIDs[cellID][0]);
+    }
+
+    NC_LOG_INFO("TerrainPhysics : {0} rays, max height error {1}, tolerance {2}", numHits, maxHeightError, heightTolerance);
+}
+
+TEST_CASE("Terrain height field cuts out hole patches", "[Physics][TerrainPhysics]")
+{
+    EnsureJoltInitialized();
+
+    std::unique_ptr<Map::Chunk> chunk = MakeTestChunk(true);
+    JPH::ShapeRefC meshShape = Util::TerrainPhysics::CreateMeshShape(*chunk);
+    JPH::ShapeRefC heightFieldShape = Util::TerrainPhysics::CreateHeightFieldShape(*chunk);
+    REQUIRE(meshShape != nullptr);
+    REQUIRE(heightFieldShape != nullptr);
+
+    // Cell 3 has its second and fourth patch rows cut out
+    f32 height = 0.0f;
+    JPH::SubShapeID subShapeID;
+    f32 cellOffsetX = 3.0f * Terrain::CELL_SIZE;
+    CHECK_FALSE(CastDown(*heightFieldShape, cellOffsetX + 2.5f * Terrain::PATCH_SIZE, -1.5f * Terrain::PATCH_SIZE, height, subShapeID));
+    CHECK(CastDown(*heightFieldShape, cellOffsetX + 2.5f * Terrain::PATCH_SIZE, -2.5f * Terrain::PATCH_SIZE, height, subShapeID));
+
+    // Compare against the mesh on a grid over every patch of the chunk
+    constexpr u32 patchStride = Terrain::CHUNK_NUM_CELLS_PER_STRIDE * Terrain::CELL_NUM_PATCHES_PER_STRIDE;
+    constexpr u32 raysPerPatchStride = 8;
+
+    u32 numHoleRays = 0;
+    u32 numHoleHits = 0;
+    u32 numSolidMisses = 0;
+
+    for (u32 patchY = 0; patchY < patchStride; patchY++)
+    {
+        for (u32 patchX = 0; patchX < patchStride; patchX++)
+        {
+            for (u32 rayY = 0; rayY < raysPerPatchStride; rayY++)
+            {
+                for (u32 rayX = 0; rayX < raysPerPatchStride; rayX++)
+                {
+                    f32 x = (static_cast<f32>(patchX) + (static_cast<f32>(rayX) + 0.5f) / raysPerPatchStride) * Terrain::PATCH_SIZE;
+                    f32 z = -(static_cast<f32>(patchY) + (static_cast<f32>(rayY) + 0.5f) / raysPerPatchStride) * Terrain::PATCH_SIZE;
+
+                    f32 meshHeight = 0.0f;
+                    f32 heightFieldHeight = 0.0f;
+                    JPH::SubShapeID meshSubShapeID;
+                    JPH::SubShapeID heightFieldSubShapeID;
+                    bool meshHit = CastDown(*meshShape, x, z, meshHeight, meshSubShapeID);
+                    bool heightFieldHit = CastDown(*heightFieldShape, x, z, heightFieldHeight, heightFieldSubShapeID);
+
+                    if (meshHit)
+                    {
+                        numSolidMisses += !heightFieldHit;
+                    }
+                    else
+                    {
+                        numHoleRays++;
+                        numHoleHits += heightFieldHit;
+                    }
+                }
+            }
+        }
+    }
+
+    NC_LOG_INFO("TerrainPhysics : {0} hole rays, {1} hit the height field, {2} solid rays missed", numHoleRays, numHoleHits, numSolidMisses);
+    CHECK(numHoleRays > 0);
+    CHECK(numSolidMisses == 0);
+
+    // Each hole row keeps one corner triangle at two of its corners, an eighth of a patch each
+    CHECK(numHoleHits * 30 <= numHoleRays);
+}
+
+TEST_CASE("Terrain height field is exact at patch corners and centers", "[Physics][TerrainPhysics]")
+{
+    EnsureJoltInitialized();
+
+    std::unique_ptr<Map::Chunk> chunk = MakeTestChunk(false);
+    JPH::ShapeRefC heightFieldShape = Util::TerrainPhysics::CreateHeightFieldShape(*chunk);
+    REQUIRE(heightFieldShape != nullptr);
+
+    // Sample a corner and the center of every patch in the first cell
+    for (u32 patchY = 0; patchY < Terrain::CELL_NUM_PATCHES_PER_STRIDE; patchY++)
+    {
+        for (u32 patchX = 0; patchX < Terrain::CELL_NUM_PATCHES_PER_STRIDE; patchX++)
+        {
+            u32 cornerVertexID = patchX + (patchY * Terrain::CELL_GRID_ROW_SIZE);
+            u32 centerVertexID = cornerVertexID + Terrain::CELL_OUTER_GRID_STRIDE;
+
+            f32 height = 0.0f;
+            JPH::SubShapeID subShapeID;
+
+            // Nudge into the patch so the ray hits a triangle belonging to it
+            REQUIRE(CastDown(*heightFieldShape, (patchX + 0.001f) * Terrain::PATCH_SIZE, -(patchY + 0.001f) * Terrain::PATCH_SIZE, height, subShapeID));
+            CHECK(height == Approx(chunk->cellsData.heightField[0][cornerVertexID]).margin(0.02f));
+
+            REQUIRE(CastDown(*heightFieldShape, (patchX + 0.5f) * Terrain::PATCH_SIZE, -(patchY + 0.5f) * Terrain::PATCH_SIZE, height, subShapeID));
+            CHECK(height == Approx(chunk->cellsData.heightField[0][centerVertexID]).margin(0.02f));
+        }
+    }
+}
+
+TEST_CASE("Terrain height field uses less memory than the chunk mesh", "[Physics][TerrainPhysics]")
+{
+    EnsureJoltInitialized();
+
+    std::unique_ptr<Map::Chunk> chunk = MakeTestChunk(false);
+    JPH::ShapeRefC meshShape = Util::TerrainPhysics::CreateMeshShape(*chunk);
+    JPH::ShapeRefC heightFieldShape = Util::TerrainPhysics::CreateHeightFieldShape(*chunk);
+    REQUIRE(meshShape != nullptr);
+    REQUIRE(heightFieldShape != nullptr);
+
+    u64 meshBytes = meshShape->GetStats().mSizeBytes;
+    u64 heightFieldBytes = heightFieldShape->GetStats().mSizeBytes;
+    CHECK(heightFieldBytes < meshBytes);
+
+    // Angled rays so the traversal has to walk more than one block, Game-Bench terrainPhysics times the same casts
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<f32> positionDistribution(0.0f, Terrain::CHUNK_SIZE);
+    std::uniform_real_distribution<f32> slopeDistribution(-40.0f, 40.0f);
+
+    constexpr u32 numRays = 5000;
+
+    u32 meshHits = 0;
+    u32 heightFieldHits = 0;
+    for (u32 i = 0; i < numRays; i++)
+    {
+        JPH::Vec3 origin(positionDistribution(rng), 200.0f, -positionDistribution(rng));
+        JPH::RayCast ray{ origin, JPH::Vec3(slopeDistribution(rng), -400.0f, slopeDistribution(rng)) };
+
+        JPH::RayCastResult meshHit;
+        meshHits += meshShape->CastRay(ray, JPH::SubShapeIDCreator(), meshHit);
+
+        JPH::RayCastResult heightFieldHit;
+        heightFieldHits += heightFieldShape->CastRay(ray, JPH::SubShapeIDCreator(), heightFieldHit);
+    }
+
+    // Rays leaving through the chunk border can end up on either side of an edge, but the two should agree almost everywhere
+    CHECK(std::abs(static_cast<i32>(meshHits) - static_cast<i32>(heightFieldHits)) < static_cast<i32>(numRays / 100));
+}
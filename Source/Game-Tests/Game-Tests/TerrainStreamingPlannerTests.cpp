@@ -0,0 +1,317 @@
+#include "Game-Lib/Rendering/Terrain/TerrainStreamingPlanner.h"
+
+#include <catch2/catch2.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    u32 ChunkID(u32 x, u32 y)
+    {
+        return x + (y * Terrain::CHUNK_NUM_PER_MAP_STRIDE);
+    }
+
+    vec2 ChunkCenter(u32 x, u32 y)
+    {
+        return vec2(static_cast<f32>(x) + 0.5f, static_cast<f32>(y) + 0.5f);
+    }
+
+    std::vector<u32> MakeSquareMap(u32 size)
+    {
+        std::vector<u32> chunkIDs;
+        chunkIDs.reserve(size * size);
+
+        for (u32 y = 0; y < size; y++)
+        {
+            for (u32 x = 0; x < size; x++)
+            {
+                chunkIDs.push_back(ChunkID(x, y));
+            }
+        }
+
+        return chunkIDs;
+    }
+
+    TerrainStreamingPlanner::Settings MakeSettings(f32 loadRadius, f32 unloadRadius)
+    {
+        TerrainStreamingPlanner::Settings settings;
+        settings.loadRadius = loadRadius;
+        settings.unloadRadius = unloadRadius;
+        settings.directionBias = 0.0f;
+        settings.memoryBudgetBytes = 1024ull * 1024ull * 1024ull;
+        settings.defaultChunkBytes = 100;
+        settings.maxLoadsPerTick = 1024;
+        settings.maxInFlight = 1024;
+        return settings;
+    }
+
+    void CompleteLoads(TerrainStreamingPlanner& planner, const TerrainStreamingPlanner::Decision& decision, u64 bytesPerChunk)
+    {
+        for (u32 chunkID : decision.chunksToLoad)
+        {
+            planner.OnChunkLoaded(chunkID, bytesPerChunk);
+        }
+    }
+}
+
+TEST_CASE("Terrain streaming loads the chunks inside the load radius, closest first", "[Rendering][TerrainStreaming]")
+{
+    TerrainStreamingPlanner planner;
+    planner.SetSettings(MakeSettings(2.0f, 4.0f));
+    planner.Reset(MakeSquareMap(20));
+
+    vec2 focus = ChunkCenter(10, 10);
+    TerrainStreamingPlanner::Decision decision;
+    planner.Update(focus, vec2(0.0f), decision);
+
+    // Every chunk whose center is within two chunks, that is the center chunk plus a radius 2 disc
+    REQUIRE(decision.chunksToLoad.size() == 13);
+    CHECK(decision.chunksToLoad.front() == ChunkID(10, 10));
+    CHECK(decision.chunksToEvict.empty());
+
+    for (size_t i = 1; i < decision.chunksToLoad.size(); i++)
+    {
+        f32 previousDistance = TerrainStreamingPlanner::GetChunkDistance(decision.chunksToLoad[i - 1], focus);
+        f32 distance = TerrainStreamingPlanner::GetChunkDistance(decision.chunksToLoad[i], focus);
+        CHECK(previousDistance <= distance);
+        CHECK(distance <= 2.0f);
+    }
+
+    for (u32 chunkID : decision.chunksToLoad)
+    {
+        CHECK(planner.GetChunkState(chunkID) == TerrainStreamingPlanner::ChunkState::InFlight);
+    }
+
+    // In flight chunks are not requested twice
+    planner.Update(focus, vec2(0.0f), decision);
+    CHECK(decision.chunksToLoad.empty());
+}
+
+TEST_CASE("Terrain streaming respects the per tick and in flight limits", "[Rendering][TerrainStreaming]")
+{
+    TerrainStreamingPlanner::Settings settings = MakeSettings(2.0f, 4.0f);
+    settings.maxLoadsPerTick = 4;
+    settings.maxInFlight = 6;
+
+    TerrainStreamingPlanner planner;
+    planner.SetSettings(settings);
+    planner.Reset(MakeSquareMap(20));
+
+    vec2 focus = ChunkCenter(10, 10);
+    TerrainStreamingPlanner::Decision decision;
+
+    planner.Update(focus, vec2(0.0f), decision);
+    CHECK(decision.chunksToLoad.size() == 4);
+
+    planner.Update(focus, vec2(0.0f), decision);
+    CHECK(decision.chunksToLoad.size() == 2);
+    CHECK(planner.GetNumInFlightChunks() == 6);
+
+    planner.OnChunkLoaded(decision.chunksToLoad[0], 100);
+    planner.Update(focus, vec2(0.0f), decision);
+    CHECK(decision.chunksToLoad.size() == 1);
+}
+
+TEST_CASE("Terrain streaming prefers chunks in the direction of travel", "[Rendering][TerrainStreaming]")
+{
+    vec2 focus = ChunkCenter(10, 10);
+    u32 behind = ChunkID(8, 10);
+    u32 ahead = ChunkID(12, 10);
+
+    auto GetLoadOrder = [&](f32 directionBias, vec2 velocity)
+    {
+        TerrainStreamingPlanner::Settings settings = MakeSettings(3.0f, 5.0f);
+        settings.directionBias = directionBias;
+
+        TerrainStreamingPlanner planner;
+        planner.SetSettings(settings);
+        planner.Reset(MakeSquareMap(20));
+
+        TerrainStreamingPlanner::Decision decision;
+        planner.Update(focus, velocity, decision);
+        return decision.chunksToLoad;
+    };
+
+    auto IndexOf = [](const std::vector<u32>& chunkIDs, u32 chunkID)
+    {
+        return std::distance(chunkIDs.begin(), std::find(chunkIDs.begin(), chunkIDs.end(), chunkID));
+    };
+
+    // Without a bias the tie is broken by chunkID
+    std::vector<u32> unbiased = GetLoadOrder(0.0f, vec2(5.0f, 0.0f));
+    CHECK(IndexOf(unbiased, behind) < IndexOf(unbiased, ahead));
+
+    std::vector<u32> biased = GetLoadOrder(0.5f, vec2(5.0f, 0.0f));
+    CHECK(IndexOf(biased, ahead) < IndexOf(biased, behind));
+
+    // Standing still ignores the bias
+    std::vector<u32> stationary = GetLoadOrder(0.5f, vec2(0.0f));
+    CHECK(stationary == unbiased);
+
+    // The bias only reorders, the same chunks get loaded
+    std::sort(unbiased.begin(), unbiased.end());
+    std::sort(biased.begin(), biased.end());
+    CHECK(unbiased == biased);
+}
+
+TEST_CASE("Terrain streaming keeps chunks between the load and unload radius", "[Rendering][TerrainStreaming]")
+{
+    TerrainStreamingPlanner planner;
+    planner.SetSettings(MakeSettings(2.0f, 4.0f));
+    planner.Reset(MakeSquareMap(40));
+
+    TerrainStreamingPlanner::Decision decision;
+    planner.Update(ChunkCenter(10, 10), vec2(0.0f), decision);
+    CompleteLoads(planner, decision, 100);
+    std::vector<u32> initialChunks = decision.chunksToLoad;
+
+    // Moving one chunk back and forth across the edge of the load radius never evicts anything
+    for (u32 i = 0; i < 4; i++)
+    {
+        planner.Update(ChunkCenter(11, 10), vec2(1.0f, 0.0f), decision);
+        CHECK(decision.chunksToEvict.empty());
+        CompleteLoads(planner, decision, 100);
+
+        planner.Update(ChunkCenter(10, 10), vec2(-1.0f, 0.0f), decision);
+        CHECK(decision.chunksToEvict.empty());
+        CompleteLoads(planner, decision, 100);
+    }
+
+    // Moving far away evicts everything that was loaded around the old position
+    u32 numLoadedChunks = planner.GetNumLoadedChunks();
+    planner.Update(ChunkCenter(30, 30), vec2(0.0f), decision);
+    CHECK(decision.chunksToEvict.size() == numLoadedChunks);
+
+    for (u32 chunkID : initialChunks)
+    {
+        CHECK(planner.GetChunkState(chunkID) == TerrainStreamingPlanner::ChunkState::NotLoaded);
+    }
+}
+
+TEST_CASE("Terrain streaming stays within the memory budget and only evicts less important chunks", "[Rendering][TerrainStreaming]")
+{
+    TerrainStreamingPlanner::Settings settings = MakeSettings(3.0f, 8.0f);
+    settings.memoryBudgetBytes = 500;
+    settings.defaultChunkBytes = 100;
+
+    TerrainStreamingPlanner planner;
+    planner.SetSettings(settings);
+    planner.Reset(MakeSquareMap(30));
+
+    vec2 focus = ChunkCenter(10, 10);
+    TerrainStreamingPlanner::Decision decision;
+    planner.Update(focus, vec2(0.0f), decision);
+
+    // In flight chunks count towards the budget with the estimate
+    REQUIRE(decision.chunksToLoad.size() == 5);
+    CompleteLoads(planner, decision, 100);
+    CHECK(planner.GetResidentBytes() == 500);
+
+    // Full and nothing less important than the candidates to evict
+    planner.Update(focus, vec2(0.0f), decision);
+    CHECK(decision.chunksToLoad.empty());
+    CHECK(decision.chunksToEvict.empty());
+
+    // Walk away slowly, the budget must make room by evicting the chunks that are now furthest away
+    for (u32 step = 1; step <= 6; step++)
+    {
+        focus = ChunkCenter(10 + step, 10);
+        planner.Update(focus, vec2(0.0f), decision);
+
+        for (u32 evictedChunkID : decision.chunksToEvict)
+        {
+            f32 evictedDistance = TerrainStreamingPlanner::GetChunkDistance(evictedChunkID, focus);
+            for (u32 loadedChunkID : decision.chunksToLoad)
+            {
+                CHECK(TerrainStreamingPlanner::GetChunkDistance(loadedChunkID, focus) <= evictedDistance);
+            }
+        }
+
+        CompleteLoads(planner, decision, 100);
+        CHECK(planner.GetResidentBytes() <= settings.memoryBudgetBytes);
+        CHECK(planner.GetChunkState(ChunkID(10 + step, 10)) == TerrainStreamingPlanner::ChunkState::Loaded);
+    }
+}
+
+TEST_CASE("Terrain streaming never evicts pinned chunks and does not retry failed ones", "[Rendering][TerrainStreaming]")
+{
+    TerrainStreamingPlanner planner;
+    planner.SetSettings(MakeSettings(1.0f, 2.0f));
+    planner.Reset(MakeSquareMap(30));
+
+    TerrainStreamingPlanner::Decision decision;
+    planner.Update(ChunkCenter(5, 5), vec2(0.0f), decision);
+    REQUIRE(decision.chunksToLoad.size() == 5);
+
+    u32 pinnedChunkID = ChunkID(5, 5);
+    u32 failedChunkID = ChunkID(6, 5);
+    for (u32 chunkID : decision.chunksToLoad)
+    {
+        if (chunkID == failedChunkID)
+            planner.OnChunkLoadFailed(chunkID);
+        else
+            planner.OnChunkLoaded(chunkID, 100);
+    }
+    planner.SetChunkPinned(pinnedChunkID, true);
+
+    CHECK(planner.GetChunkState(failedChunkID) == TerrainStreamingPlanner::ChunkState::Failed);
+    CHECK(planner.GetNumLoadedChunks() == 4);
+
+    planner.Update(ChunkCenter(20, 20), vec2(0.0f), decision);
+    CHECK(decision.chunksToEvict.size() == 3);
+    CHECK(std::find(decision.chunksToEvict.begin(), decision.chunksToEvict.end(), pinnedChunkID) == decision.chunksToEvict.end());
+    CHECK(planner.GetChunkState(pinnedChunkID) == TerrainStreamingPlanner::ChunkState::Loaded);
+    CompleteLoads(planner, decision, 100);
+
+    planner.Update(ChunkCenter(5, 5), vec2(0.0f), decision);
+    CHECK(std::find(decision.chunksToLoad.begin(), decision.chunksToLoad.end(), failedChunkID) == decision.chunksToLoad.end());
+    CHECK(std::find(decision.chunksToLoad.begin(), decision.chunksToLoad.end(), pinnedChunkID) == decision.chunksToLoad.end());
+
+    // Unavailable chunks are never requested
+    planner.Update(ChunkCenter(50, 50), vec2(0.0f), decision);
+    CHECK(decision.chunksToLoad.empty());
+}
+
+TEST_CASE("Terrain streaming estimates unmeasured chunks from the measured average", "[Rendering][TerrainStreaming]")
+{
+    TerrainStreamingPlanner planner;
+    planner.SetSettings(MakeSettings(1.0f, 2.0f));
+    planner.Reset(MakeSquareMap(10));
+    CHECK(planner.GetEstimatedChunkBytes() == 100);
+
+    TerrainStreamingPlanner::Decision decision;
+    planner.Update(ChunkCenter(5, 5), vec2(0.0f), decision);
+    REQUIRE(decision.chunksToLoad.size() >= 2);
+
+    planner.OnChunkLoaded(decision.chunksToLoad[0], 200);
+    planner.OnChunkLoaded(decision.chunksToLoad[1], 400);
+    CHECK(planner.GetEstimatedChunkBytes() == 300);
+    CHECK(planner.GetResidentBytes() == 600);
+}
+
+TEST_CASE("Terrain streaming forgets everything about the previous map when reset", "[Rendering][TerrainStreaming]")
+{
+    TerrainStreamingPlanner planner;
+    planner.SetSettings(MakeSettings(2.0f, 4.0f));
+    planner.Reset(MakeSquareMap(20));
+
+    vec2 focus = ChunkCenter(10, 10);
+    TerrainStreamingPlanner::Decision decision;
+    planner.Update(focus, vec2(0.0f), decision);
+    CompleteLoads(planner, decision, 100);
+    planner.SetChunkPinned(ChunkID(10, 10), true);
+    planner.Update(ChunkCenter(5, 5), vec2(0.0f), decision);
+    REQUIRE(planner.GetNumInFlightChunks() > 0);
+
+    // What TerrainLoader::Clear does when the map is unloaded
+    planner.Reset({});
+    CHECK(planner.GetNumLoadedChunks() == 0);
+    CHECK(planner.GetNumInFlightChunks() == 0);
+    CHECK(planner.GetResidentBytes() == 0);
+    CHECK(planner.GetChunkState(ChunkID(10, 10)) == TerrainStreamingPlanner::ChunkState::Unavailable);
+
+    planner.Update(focus, vec2(0.0f), decision);
+    CHECK(decision.chunksToLoad.empty());
+    CHECK(decision.chunksToEvict.empty());
+}
@@ -0,0 +1,398 @@
+#include "Game-Lib/Rendering/Model/TextureStreamer.h"
+
+#include <catch2/catch2.hpp>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    class FakeUploader : public TextureStreamer::Uploader
+    {
+    public:
+        bool UploadStreamedTexture(u64 textureHash, TextureStreamer::Level level, const void* data, size_t size, u32& arrayIndex) override
+        {
+            if (failUploads)
+                return false;
+
+            arrayIndex = nextArrayIndex++;
+            uploads.push_back({ textureHash, level });
+            liveSizes[arrayIndex] = size;
+            return true;
+        }
+
+        void SetStreamedTextureArrayIndex(u64 textureHash, u32 arrayIndex) override
+        {
+            boundArrayIndices[textureHash] = arrayIndex;
+        }
+
+        void ReleaseStreamedTexture(u64 textureHash, u32 arrayIndex) override
+        {
+            CHECK(boundArrayIndices[textureHash] != arrayIndex);
+            CHECK(liveSizes.erase(arrayIndex) == 1);
+            releases.push_back(textureHash);
+        }
+
+        // What the renderer still holds, released versions are unloaded
+        u64 GetLiveBytes() const
+        {
+            u64 liveBytes = 0;
+            for (const auto& [arrayIndex, size] : liveSizes)
+            {
+                liveBytes += size;
+            }
+
+            return liveBytes;
+        }
+
+    public:
+        u32 nextArrayIndex = 2;
+        bool failUploads = false;
+
+        std::vector<std::pair<u64, TextureStreamer::Level>> uploads;
+        std::vector<u64> releases;
+        robin_hood::unordered_map<u64, u32> boundArrayIndices;
+        robin_hood::unordered_map<u32, u64> liveSizes;
+    };
+
+    constexpr u64 LOW_SIZE = 1024;
+
+    // Runs the jobs like the renderer would, every low texture has a full version of fullSize bytes
+    void CompleteJobs(TextureStreamer& streamer, const std::vector<TextureStreamer::LoadJob>& jobs, u64 fullSize)
+    {
+        static const std::vector<u8> data(1, 0);
+
+        for (const TextureStreamer::LoadJob& job : jobs)
+        {
+            u64 size = job.level == TextureStreamer::Level::Low ? LOW_SIZE : fullSize;
+            streamer.CompleteJob(job, data.data(), size, fullSize, false);
+        }
+    }
+
+    std::vector<u64> GetHashes(const std::vector<TextureStreamer::LoadJob>& jobs, TextureStreamer::Level level)
+    {
+        std::vector<u64> hashes;
+        for (const TextureStreamer::LoadJob& job : jobs)
+        {
+            if (job.level == level)
+                hashes.push_back(job.textureHash);
+        }
+
+        return hashes;
+    }
+
+    // A DXT1 texture with a full mip chain, every mip filled with its own index
+    std::vector<u8> MakeDDS(u32 width, u32 height, u32 numMips, u32 caps2 = 0)
+    {
+        std::vector<u8> dds(4 + 124, 0);
+        auto write = [&dds](u32 offset, u32 value) { std::memcpy(dds.data() + offset, &value, sizeof(u32)); };
+
+        write(0, 0x20534444);
+        write(4 + 0, 124);
+        write(4 + 4, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000);
+        write(4 + 8, height);
+        write(4 + 12, width);
+        write(4 + 16, std::max(1u, (width + 3) / 4) * std::max(1u, (height + 3) / 4) * 8);
+        write(4 + 24, numMips);
+        write(4 + 72, 32);
+        write(4 + 76, 0x4);
+        write(4 + 80, 0x31545844); // DXT1
+        write(4 + 108, caps2);
+
+        for (u32 mip = 0; mip < numMips; mip++)
+        {
+            u32 mipWidth = std::max(1u, width >> mip);
+            u32 mipHeight = std::max(1u, height >> mip);
+            size_t mipSize = std::max(1u, (mipWidth + 3) / 4) * std::max(1u, (mipHeight + 3) / 4) * 8;
+            dds.insert(dds.end(), mipSize, static_cast<u8>(mip));
+        }
+
+        return dds;
+    }
+
+    u32 ReadU32(const std::vector<u8>& data, u32 offset)
+    {
+        u32 value;
+        std::memcpy(&value, data.data() + offset, sizeof(u32));
+        return value;
+    }
+}
+
+TEST_CASE("Texture streamer loads low versions first in priority order", "[Rendering][TextureStreamer]")
+{
+    FakeUploader uploader;
+    TextureStreamer streamer(&uploader);
+    streamer.SetBudget(1024 * 1024);
+
+    CHECK(streamer.Request(1, 0.1f));
+    CHECK(streamer.Request(2, 0.5f));
+    CHECK(streamer.Request(3, 0.3f));
+    CHECK_FALSE(streamer.Request(1, 0.2f));
+
+    u32 arrayIndex = 0;
+    CHECK_FALSE(streamer.GetArrayIndex(2, arrayIndex));
+
+    std::vector<TextureStreamer::LoadJob> jobs;
+    streamer.CollectJobs(2, jobs);
+    CHECK(GetHashes(jobs, TextureStreamer::Level::Low) == std::vector<u64>{ 2, 3 });
+
+    // Jobs in flight are not handed out twice
+    std::vector<TextureStreamer::LoadJob> moreJobs;
+    streamer.CollectJobs(8, moreJobs);
+    CHECK(GetHashes(moreJobs, TextureStreamer::Level::Low) == std::vector<u64>{ 1 });
+    CHECK(streamer.GetStats().numJobsInFlight == 3);
+
+    CompleteJobs(streamer, jobs, 4096);
+    CompleteJobs(streamer, moreJobs, 4096);
+
+    // The placeholder is swapped for the low version as soon as it arrives
+    REQUIRE(streamer.GetArrayIndex(2, arrayIndex));
+    CHECK(uploader.boundArrayIndices[2] == arrayIndex);
+
+    // Upgrades follow, also by priority
+    jobs.clear();
+    streamer.CollectJobs(8, jobs);
+    CHECK(GetHashes(jobs, TextureStreamer::Level::Full) == std::vector<u64>{ 2, 3, 1 });
+    CHECK(streamer.GetStats().reservedBytes == 3 * 4096);
+
+    CompleteJobs(streamer, jobs, 4096);
+    REQUIRE(streamer.GetArrayIndex(2, arrayIndex));
+    CHECK(uploader.boundArrayIndices[2] == arrayIndex);
+
+    TextureStreamer::Stats stats = streamer.GetStats();
+    CHECK(stats.numFullResident == 3);
+    CHECK(stats.residentBytes == 3 * (LOW_SIZE + 4096));
+    CHECK(stats.reservedBytes == 0);
+    CHECK(stats.numJobsInFlight == 0);
+}
+
+TEST_CASE("Texture streamer upgrades stay within the budget", "[Rendering][TextureStreamer]")
+{
+    constexpr u64 FULL_SIZE = 64 * 1024;
+
+    FakeUploader uploader;
+    TextureStreamer streamer(&uploader);
+    streamer.SetBudget(8 * LOW_SIZE + 3 * FULL_SIZE);
+
+    for (u64 textureHash = 1; textureHash <= 8; textureHash++)
+    {
+        streamer.Request(textureHash, static_cast<f32>(textureHash) * 0.1f);
+    }
+
+    std::vector<TextureStreamer::LoadJob> jobs;
+    streamer.CollectJobs(64, jobs);
+    CompleteJobs(streamer, jobs, FULL_SIZE);
+
+    // Only the three most important textures fit at full resolution
+    jobs.clear();
+    streamer.CollectJobs(64, jobs);
+    CHECK(GetHashes(jobs, TextureStreamer::Level::Full) == std::vector<u64>{ 8, 7, 6 });
+    CompleteJobs(streamer, jobs, FULL_SIZE);
+    CHECK(streamer.GetStats().residentBytes <= streamer.GetStats().budgetBytes);
+
+    SECTION("A texture gaining priority evicts the least important full texture")
+    {
+        streamer.SetPriority(2, 1.0f);
+
+        jobs.clear();
+        streamer.CollectJobs(64, jobs);
+        CHECK(GetHashes(jobs, TextureStreamer::Level::Full) == std::vector<u64>{ 2 });
+        CHECK(uploader.releases == std::vector<u64>{ 6 });
+
+        // The evicted texture falls back to its low version right away
+        u32 arrayIndex = 0;
+        REQUIRE(streamer.GetArrayIndex(6, arrayIndex));
+        CHECK(uploader.boundArrayIndices[6] == arrayIndex);
+
+        CompleteJobs(streamer, jobs, FULL_SIZE);
+
+        TextureStreamer::Stats stats = streamer.GetStats();
+        CHECK(stats.numFullResident == 3);
+        CHECK(stats.numEvictions == 1);
+        CHECK(stats.residentBytes <= stats.budgetBytes);
+    }
+
+    SECTION("Textures never evict more important ones")
+    {
+        streamer.SetPriority(1, 0.65f);
+
+        jobs.clear();
+        streamer.CollectJobs(64, jobs);
+        CHECK(GetHashes(jobs, TextureStreamer::Level::Full) == std::vector<u64>{ 1 });
+        CHECK(uploader.releases == std::vector<u64>{ 6 });
+
+        // 3 is more important than the low textures but nothing full is less important than it
+        CompleteJobs(streamer, jobs, FULL_SIZE);
+        streamer.SetPriority(3, 0.64f);
+
+        jobs.clear();
+        streamer.CollectJobs(64, jobs);
+        CHECK(jobs.empty());
+    }
+
+    SECTION("A lower budget keeps further upgrades out without evicting")
+    {
+        streamer.SetBudget(8 * LOW_SIZE);
+        streamer.SetPriority(5, 0.55f);
+
+        jobs.clear();
+        streamer.CollectJobs(64, jobs);
+        CHECK(jobs.empty());
+        CHECK(uploader.releases.empty());
+    }
+}
+
+TEST_CASE("Texture streamer frees evicted textures as priorities move", "[Rendering][TextureStreamer]")
+{
+    constexpr u64 FULL_SIZE = 64 * 1024;
+    constexpr u32 NUM_TEXTURES = 64;
+
+    FakeUploader uploader;
+    TextureStreamer streamer(&uploader);
+    streamer.SetBudget(NUM_TEXTURES * LOW_SIZE + 10 * FULL_SIZE);
+
+    std::mt19937 rng(1919);
+    std::uniform_real_distribution<f32> priorityDistribution(0.0f, 1.0f);
+
+    for (u64 textureHash = 1; textureHash <= NUM_TEXTURES; textureHash++)
+    {
+        streamer.Request(textureHash, priorityDistribution(rng));
+    }
+
+    // The camera moving around, a few textures change priority every frame and at most 8 loads finish per frame
+    std::vector<TextureStreamer::LoadJob> jobs;
+    for (u32 frame = 0; frame < 200; frame++)
+    {
+        for (u32 i = 0; i < 4; i++)
+        {
+            u64 textureHash = 1 + rng() % NUM_TEXTURES;
+            streamer.SetPriority(textureHash, priorityDistribution(rng));
+        }
+
+        jobs.clear();
+        streamer.CollectJobs(8, jobs);
+        CompleteJobs(streamer, jobs, FULL_SIZE);
+
+        TextureStreamer::Stats stats = streamer.GetStats();
+        REQUIRE(stats.reservedBytes == 0);
+        REQUIRE(stats.residentBytes <= stats.budgetBytes);
+        REQUIRE(uploader.GetLiveBytes() == stats.residentBytes);
+    }
+
+    TextureStreamer::Stats stats = streamer.GetStats();
+    CHECK(stats.numLowResident == NUM_TEXTURES);
+    CHECK(stats.numEvictions > 0);
+    CHECK(stats.numEvictions == uploader.releases.size());
+    CHECK(stats.numFullResident == 10);
+}
+
+TEST_CASE("Texture streamer handles whole textures and failures", "[Rendering][TextureStreamer]")
+{
+    FakeUploader uploader;
+    TextureStreamer streamer(&uploader);
+    streamer.SetBudget(1024 * 1024);
+    streamer.SetMinUpgradePriority(0.25f);
+
+    streamer.Request(1, 1.0f);
+    streamer.Request(2, 1.0f);
+    streamer.Request(3, 0.1f);
+
+    std::vector<TextureStreamer::LoadJob> jobs;
+    streamer.CollectJobs(8, jobs);
+    REQUIRE(jobs.size() == 3);
+
+    static const std::vector<u8> data(1, 0);
+    for (const TextureStreamer::LoadJob& job : jobs)
+    {
+        if (job.textureHash == 1)
+            streamer.CompleteJob(job, data.data(), 2048, 2048, true);
+        else if (job.textureHash == 2)
+            streamer.FailJob(job);
+        else
+            streamer.CompleteJob(job, data.data(), LOW_SIZE, 4096, false);
+    }
+
+    // 1 came whole, 2 failed and 3 is below the upgrade priority
+    jobs.clear();
+    streamer.CollectJobs(8, jobs);
+    CHECK(jobs.empty());
+
+    u32 arrayIndex = 0;
+    CHECK(streamer.GetArrayIndex(1, arrayIndex));
+    CHECK_FALSE(streamer.GetArrayIndex(2, arrayIndex));
+
+    SECTION("A failed upload keeps the low version")
+    {
+        streamer.SetPriority(3, 0.5f);
+        streamer.CollectJobs(8, jobs);
+        REQUIRE(jobs.size() == 1);
+
+        uploader.failUploads = true;
+        CompleteJobs(streamer, jobs, 4096);
+
+        REQUIRE(streamer.GetArrayIndex(3, arrayIndex));
+        CHECK(uploader.boundArrayIndices[3] == arrayIndex);
+        CHECK(streamer.GetStats().reservedBytes == 0);
+
+        jobs.clear();
+        streamer.CollectJobs(8, jobs);
+        CHECK(jobs.empty());
+    }
+
+    SECTION("Clear forgets every texture and late jobs are ignored")
+    {
+        streamer.SetPriority(3, 0.5f);
+        streamer.CollectJobs(8, jobs);
+        REQUIRE(jobs.size() == 1);
+
+        streamer.Clear();
+        CompleteJobs(streamer, jobs, 4096);
+
+        TextureStreamer::Stats stats = streamer.GetStats();
+        CHECK(stats.numTextures == 0);
+        CHECK(stats.residentBytes == 0);
+        CHECK(stats.numJobsInFlight == 0);
+    }
+}
+
+TEST_CASE("Low mip textures are cut from the end of the mip chain", "[Rendering][TextureStreamer]")
+{
+    std::vector<u8> lowTexture;
+
+    SECTION("The mips at most maxSize wide and high are kept")
+    {
+        std::vector<u8> dds = MakeDDS(256, 128, 9);
+        REQUIRE(TextureStreaming::BuildLowMipTexture(dds.data(), dds.size(), 64, lowTexture));
+
+        CHECK(ReadU32(lowTexture, 4 + 12) == 64);
+        CHECK(ReadU32(lowTexture, 4 + 8) == 32);
+        CHECK(ReadU32(lowTexture, 4 + 24) == 7);
+        CHECK(ReadU32(lowTexture, 4 + 16) == 16 * 8 * 8);
+
+        // 64x32, 32x16, 16x8, 8x4, 4x2, 2x1 and 1x1 in blocks of 8 bytes
+        size_t expectedDataSize = (128 + 32 + 8 + 2 + 1 + 1 + 1) * 8;
+        REQUIRE(lowTexture.size() == 128 + expectedDataSize);
+        CHECK(lowTexture[128] == 2);
+        CHECK(lowTexture.back() == 8);
+    }
+
+    SECTION("Textures that already fit or have no mips are loaded whole")
+    {
+        std::vector<u8> small = MakeDDS(64, 64, 7);
+        CHECK_FALSE(TextureStreaming::BuildLowMipTexture(small.data(), small.size(), 64, lowTexture));
+
+        std::vector<u8> noMips = MakeDDS(512, 512, 1);
+        CHECK_FALSE(TextureStreaming::BuildLowMipTexture(noMips.data(), noMips.size(), 64, lowTexture));
+    }
+
+    SECTION("Cube maps and truncated files are rejected")
+    {
+        std::vector<u8> cube = MakeDDS(256, 256, 9, 0x200);
+        CHECK_FALSE(TextureStreaming::BuildLowMipTexture(cube.data(), cube.size(), 64, lowTexture));
+
+        std::vector<u8> truncated = MakeDDS(256, 256, 9);
+        truncated.resize(truncated.size() - 1);
+        CHECK_FALSE(TextureStreaming::BuildLowMipTexture(truncated.data(), truncated.size(), 64, lowTexture));
+    }
+}
@@ -0,0 +1,160 @@
+#include "Game-Lib/ECS/Util/UIHitGrid.h"
+#include "Game-Lib/ECS/Util/UIInputUtil.h"
+
+#include <catch2/catch2.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using HitGrid = ECS::Util::UIInput::HitGrid;
+
+    constexpr u32 NUM_CANVASES = 4;
+
+    f32 RandomRange(std::mt19937& random, f32 min, f32 max)
+    {
+        return std::uniform_real_distribution<f32>(min, max)(random);
+    }
+
+    // Widgets in random places with few distinct sortKeys so ties are common, some partly or fully outside the grid
+    std::vector<HitGrid::Entry> BuildEntries(u32 seed, u32 numEntries)
+    {
+        std::mt19937 random(seed);
+        std::vector<HitGrid::Entry> entries;
+        entries.reserve(numEntries);
+
+        for (u32 i = 0; i < numEntries; i++)
+        {
+            HitGrid::Entry& entry = entries.emplace_back();
+            entry.entity = static_cast<entt::entity>(i + NUM_CANVASES);
+            entry.canvasEntity = static_cast<entt::entity>(random() % NUM_CANVASES);
+
+            entry.min = vec2(RandomRange(random, -200.0f, 2000.0f), RandomRange(random, -200.0f, 1200.0f));
+            entry.max = entry.min + vec2(RandomRange(random, 1.0f, 400.0f), RandomRange(random, 1.0f, 300.0f));
+
+            // Roughly half of them sit inside a clip region that cuts them down
+            entry.hitMin = entry.min;
+            entry.hitMax = entry.max;
+            if (random() % 2 == 0)
+            {
+                entry.hitMin = entry.hitMin + vec2(RandomRange(random, 0.0f, 100.0f), RandomRange(random, 0.0f, 100.0f));
+                entry.hitMax = entry.hitMax - vec2(RandomRange(random, 0.0f, 100.0f), RandomRange(random, 0.0f, 100.0f));
+            }
+
+            entry.sortKey = random() % 8;
+        }
+
+        return entries;
+    }
+
+    // What RebuildCandidates got from walking every canvas and sorting the candidates afterwards
+    std::vector<HitGrid::Hit> BruteForceQuery(const std::vector<HitGrid::Entry>& entries, const vec2& point)
+    {
+        std::vector<HitGrid::Hit> hits;
+        for (const HitGrid::Entry& entry : entries)
+        {
+            if (!ECS::Util::UIInput::IsWithin(point, entry.hitMin, entry.hitMax))
+                continue;
+
+            vec2 middlePoint = (entry.min + entry.max) * 0.5f;
+            hits.push_back({ entry.entity, entry.min, entry.max, entry.sortKey, glm::distance(middlePoint, point) });
+        }
+
+        std::sort(hits.begin(), hits.end(), [](const HitGrid::Hit& lhs, const HitGrid::Hit& rhs)
+        {
+            if (lhs.sortKey != rhs.sortKey)
+                return lhs.sortKey > rhs.sortKey;
+
+            if (lhs.distanceToPoint != rhs.distanceToPoint)
+                return lhs.distanceToPoint < rhs.distanceToPoint;
+
+            return entt::to_integral(lhs.entity) < entt::to_integral(rhs.entity);
+        });
+
+        return hits;
+    }
+
+    std::vector<entt::entity> GetEntities(const std::vector<HitGrid::Hit>& hits)
+    {
+        std::vector<entt::entity> entities;
+        entities.reserve(hits.size());
+
+        for (const HitGrid::Hit& hit : hits)
+        {
+            entities.push_back(hit.entity);
+        }
+
+        return entities;
+    }
+
+    void CheckMatchesBruteForce(const HitGrid& hitGrid, const std::vector<HitGrid::Entry>& entries, u32 seed)
+    {
+        std::mt19937 random(seed);
+        std::vector<HitGrid::Hit> hits;
+
+        for (u32 i = 0; i < 2000; i++)
+        {
+            vec2 point(RandomRange(random, -300.0f, 2200.0f), RandomRange(random, -300.0f, 1400.0f));
+
+            hits.clear();
+            hitGrid.Query(point, hits);
+
+            INFO("point " << point.x << ", " << point.y);
+            REQUIRE(GetEntities(hits) == GetEntities(BruteForceQuery(entries, point)));
+        }
+    }
+}
+
+TEST_CASE("UI hit grid returns the same ordered hits as the brute-force walk", "[UI][HitGrid]")
+{
+    u32 seed = GENERATE(3u, 42u, 9001u);
+    std::vector<HitGrid::Entry> entries = BuildEntries(seed, 600);
+
+    HitGrid hitGrid;
+    for (const HitGrid::Entry& entry : entries)
+    {
+        hitGrid.Add(entry);
+    }
+
+    CheckMatchesBruteForce(hitGrid, entries, seed + 1);
+
+    SECTION("Replacing a canvas only changes that canvas' entries")
+    {
+        const entt::entity replacedCanvas = static_cast<entt::entity>(1);
+        hitGrid.RemoveCanvas(replacedCanvas);
+
+        std::vector<HitGrid::Entry> remaining;
+        std::copy_if(entries.begin(), entries.end(), std::back_inserter(remaining), [&](const HitGrid::Entry& entry) { return entry.canvasEntity != replacedCanvas; });
+        CheckMatchesBruteForce(hitGrid, remaining, seed + 2);
+
+        // The canvas comes back with its layout moved, reusing the freed entries
+        std::mt19937 random(seed + 3);
+        for (HitGrid::Entry& entry : entries)
+        {
+            if (entry.canvasEntity != replacedCanvas)
+                continue;
+
+            vec2 offset(RandomRange(random, -50.0f, 50.0f), RandomRange(random, -50.0f, 50.0f));
+            entry.min = entry.min + offset;
+            entry.max = entry.max + offset;
+            entry.hitMin = entry.hitMin + offset;
+            entry.hitMax = entry.hitMax + offset;
+
+            hitGrid.Add(entry);
+        }
+
+        CheckMatchesBruteForce(hitGrid, entries, seed + 4);
+    }
+
+    SECTION("Clearing removes everything")
+    {
+        hitGrid.Clear();
+        CHECK(hitGrid.GetNumEntries() == 0);
+
+        std::vector<HitGrid::Hit> hits;
+        hitGrid.Query(vec2(960.0f, 540.0f), hits);
+        CHECK(hits.empty());
+    }
+}
@@ -0,0 +1,313 @@
+#include "Game-Lib/ECS/Components/AnimationData.h"
+#include "Game-Lib/ECS/Components/AttachmentData.h"
+#include "Game-Lib/ECS/Components/CastInfo.h"
+#include "Game-Lib/ECS/Components/MovementInfo.h"
+#include "Game-Lib/ECS/Util/Transforms.h"
+#include "Game-Lib/ECS/Util/UnitPose.h"
+#include "Game-Lib/Util/AnimationUtil.h"
+
+#include <catch2/catch2.hpp>
+
+#include <enkiTS/TaskScheduler.h>
+#include <entt/entt.hpp>
+#include <FileFormat/Novus/Model/ComplexModel.h>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    constexpr u32 NUM_UNITS = 2048;
+    constexpr u32 NUM_FRAMES = 60;
+    constexpr u32 NUM_BONES = 8;
+    constexpr f32 DELTA_TIME = 1.0f / 60.0f;
+
+    // Drives the movement input and remembers the variations picked, kept apart from the unit's components
+    struct TestUnitInput
+    {
+    public:
+        u32 inputState = 0;
+        std::vector<::Animation::Defines::SequenceID> pickedSequences;
+    };
+
+    struct TestWorld
+    {
+    public:
+        entt::registry registry;
+        std::vector<TestUnitInput> inputs;
+        std::vector<entt::entity> attachmentEntities;
+        ECS::Util::UnitPose::CommitList commits;
+    };
+
+    u32 NextInput(u32& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        return state;
+    }
+
+    Model::ComplexModel MakeTestModel()
+    {
+        Model::ComplexModel model;
+        model.bones.resize(NUM_BONES);
+
+        model.keyBoneIDToBoneIndex[static_cast<i16>(::Animation::Defines::Bone::Root)] = 0;
+        model.keyBoneIDToBoneIndex[static_cast<i16>(::Animation::Defines::Bone::SpineLow)] = 3;
+        model.keyBoneIDToBoneIndex[static_cast<i16>(::Animation::Defines::Bone::Head)] = 5;
+
+        Model::ComplexModel::Attachment& handAttachment = model.attachments.emplace_back();
+        handAttachment.bone = 7;
+        handAttachment.position = vec3(0.2f, 0.0f, 0.1f);
+        model.attachmentIDToIndex[static_cast<i16>(::Attachment::Defines::Type::HandRight)] = 0;
+
+        Model::ComplexModel::Attachment& helmAttachment = model.attachments.emplace_back();
+        helmAttachment.bone = 5;
+        helmAttachment.position = vec3(0.0f, 0.5f, 0.0f);
+        model.attachmentIDToIndex[static_cast<i16>(::Attachment::Defines::Type::Helm)] = 1;
+
+        // Three equally likely variations of the stand animation
+        for (i32 i = 0; i < 3; i++)
+        {
+            Model::ComplexModel::AnimationSequence& sequence = model.sequences.emplace_back();
+            sequence.frequency = 0x7FFF / 3 + 1;
+            sequence.nextVariationID = i < 2 ? i + 1 : -1;
+            sequence.repetitionRange.x = 1;
+            sequence.repetitionRange.y = 4;
+        }
+        model.animationIDToFirstSequenceID[static_cast<i16>(::Animation::Defines::Type::Stand)] = 0;
+
+        return model;
+    }
+
+    // Units are created first so a unit's entity is its index into the inputs, every third unit starts out casting
+    void MakeTestUnits(TestWorld& world)
+    {
+        entt::registry& registry = world.registry;
+        world.inputs.resize(NUM_UNITS);
+
+        for (u32 i = 0; i < NUM_UNITS; i++)
+        {
+            entt::entity entity = registry.create();
+            REQUIRE(entt::to_integral(entity) == i);
+
+            world.inputs[i].inputState = 0x9E3779B1u * (i + 1);
+
+            auto& animationData = registry.emplace<ECS::Components::AnimationData>(entity);
+            animationData.variationRandomState = Util::Animation::GetVariationRandomSeed(entity);
+            animationData.boneInstances.resize(NUM_BONES);
+
+            for (u32 boneIndex = 0; boneIndex < NUM_BONES; boneIndex++)
+            {
+                f32 angle = static_cast<f32>(i * NUM_BONES + boneIndex) * 0.01f;
+                mat4x4 boneTransform = glm::mat4_cast(glm::angleAxis(angle, vec3(0.0f, 1.0f, 0.0f)));
+                boneTransform[3] = vec4(static_cast<f32>(boneIndex) * 0.1f, static_cast<f32>(i) * 0.001f, 0.0f, 1.0f);
+                animationData.boneTransforms.push_back(boneTransform);
+            }
+
+            registry.emplace<ECS::Components::AttachmentData>(entity);
+            registry.emplace<ECS::Components::MovementInfo>(entity);
+
+            if (i % 3 == 0)
+                registry.emplace<ECS::Components::CastInfo>(entity);
+        }
+
+        for (u32 i = 0; i < NUM_UNITS; i++)
+        {
+            entt::entity handEntity = registry.create();
+            entt::entity helmEntity = registry.create();
+            registry.emplace<ECS::Components::Transform>(handEntity);
+            registry.emplace<ECS::Components::Transform>(helmEntity);
+
+            world.attachmentEntities.push_back(handEntity);
+            world.attachmentEntities.push_back(helmEntity);
+
+            auto& attachmentData = registry.get<ECS::Components::AttachmentData>(static_cast<entt::entity>(i));
+            attachmentData.attachmentToInstance[::Attachment::Defines::Type::HandRight] = { 0, handEntity, mat4x4(1.0f) };
+            attachmentData.attachmentToInstance[::Attachment::Defines::Type::Helm] = { 0, helmEntity, mat4x4(1.0f) };
+        }
+    }
+
+    // What UpdateUnitEntities does for a unit, minus the parts that need the game's services
+    void UpdateTestUnit(const Model::ComplexModel& model, TestWorld& world, ECS::Util::UnitPose::Commit& commit, u32 frame)
+    {
+        TestUnitInput& testInput = world.inputs[entt::to_integral(commit.entity)];
+        auto& animationData = world.registry.get<ECS::Components::AnimationData>(commit.entity);
+        auto& attachmentData = world.registry.get<ECS::Components::AttachmentData>(commit.entity);
+        auto& movementInfo = world.registry.get<ECS::Components::MovementInfo>(commit.entity);
+
+        u32 input = NextInput(testInput.inputState);
+
+        ECS::Components::MovementFlags& movementFlags = movementInfo.movementFlags;
+        movementFlags.forward = (input >> 0) & 1;
+        movementFlags.backward = !movementFlags.forward && ((input >> 1) & 1);
+        movementFlags.left = (input >> 2) & 1;
+        movementFlags.right = !movementFlags.left && ((input >> 3) & 1);
+        movementFlags.grounded = ((input >> 4) & 7) != 0;
+        movementFlags.flying = !movementFlags.grounded && ((input >> 7) & 1);
+
+        // Stands in for a cast finishing in the animation state update
+        commit.removeCastInfo = ((input >> 8) & 15) == 0;
+
+        if (frame % 8 == 0)
+        {
+            i8 timesToRepeat = 0;
+            testInput.pickedSequences.push_back(Util::Animation::GetSequenceIndexForAnimation(&model, ::Animation::Defines::Type::Stand, timesToRepeat, animationData.variationRandomState));
+        }
+
+        ECS::Util::UnitPose::CalculateAttachmentTransforms(&model, animationData, attachmentData, frame + 1, commit.attachmentTransforms);
+        ECS::Util::UnitPose::UpdateOrientation(&model, animationData, movementInfo, DELTA_TIME);
+    }
+
+    // Gathers, updates and commits every unit the way UpdateUnitEntities does
+    void UpdateTestWorld(const Model::ComplexModel& model, TestWorld& world, enki::TaskScheduler* taskScheduler, u32 frame)
+    {
+        world.commits.Reset();
+
+        auto view = world.registry.view<ECS::Components::AnimationData, ECS::Components::MovementInfo>();
+        for (entt::entity entity : view)
+        {
+            world.commits.Add(entity);
+        }
+
+        ECS::Util::UnitPose::UpdateUnits(world.commits, taskScheduler, [&](ECS::Util::UnitPose::Commit& commit)
+        {
+            UpdateTestUnit(model, world, commit, frame);
+        });
+
+        ECS::Util::UnitPose::ApplyCommits(world.registry, world.commits);
+    }
+
+    template <typename T>
+    bool IsBitwiseEqual(const T& a, const T& b)
+    {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    }
+
+    template <typename T>
+    bool IsBitwiseEqual(const std::vector<T>& a, const std::vector<T>& b)
+    {
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+    }
+
+    bool IsUnitBitwiseEqual(TestWorld& a, TestWorld& b, u32 unitIndex)
+    {
+        entt::entity entity = static_cast<entt::entity>(unitIndex);
+
+        const auto& movementInfoA = a.registry.get<ECS::Components::MovementInfo>(entity);
+        const auto& movementInfoB = b.registry.get<ECS::Components::MovementInfo>(entity);
+        if (!IsBitwiseEqual(movementInfoA.spineRotationSettings, movementInfoB.spineRotationSettings) ||
+            !IsBitwiseEqual(movementInfoA.headRotationSettings, movementInfoB.headRotationSettings) ||
+            !IsBitwiseEqual(movementInfoA.rootRotationSettings, movementInfoB.rootRotationSettings))
+        {
+            return false;
+        }
+
+        const auto& animationDataA = a.registry.get<ECS::Components::AnimationData>(entity);
+        const auto& animationDataB = b.registry.get<ECS::Components::AnimationData>(entity);
+        if (animationDataA.variationRandomState != animationDataB.variationRandomState || a.inputs[unitIndex].pickedSequences != b.inputs[unitIndex].pickedSequences)
+            return false;
+
+        if (!IsBitwiseEqual(animationDataA.proceduralRotationOffsets, animationDataB.proceduralRotationOffsets))
+            return false;
+
+        for (u32 i = 0; i < NUM_BONES; i++)
+        {
+            if (animationDataA.boneInstances[i].proceduralRotationOffsetIndex != animationDataB.boneInstances[i].proceduralRotationOffsetIndex)
+                return false;
+        }
+
+        return a.registry.all_of<ECS::Components::CastInfo>(entity) == b.registry.all_of<ECS::Components::CastInfo>(entity);
+    }
+
+    bool IsAttachmentBitwiseEqual(TestWorld& a, TestWorld& b, u32 attachmentIndex)
+    {
+        const auto& transformA = a.registry.get<ECS::Components::Transform>(a.attachmentEntities[attachmentIndex]);
+        const auto& transformB = b.registry.get<ECS::Components::Transform>(b.attachmentEntities[attachmentIndex]);
+
+        return IsBitwiseEqual(transformA.GetLocalPosition(), transformB.GetLocalPosition()) &&
+            IsBitwiseEqual(transformA.GetLocalRotation(), transformB.GetLocalRotation()) &&
+            IsBitwiseEqual(transformA.GetLocalScale(), transformB.GetLocalScale());
+    }
+}
+
+TEST_CASE("Unit poses updated in task ranges match the single threaded update", "[Unit][Pose]")
+{
+    const Model::ComplexModel model = MakeTestModel();
+
+    enki::TaskScheduler taskScheduler;
+    taskScheduler.Initialize(4);
+
+    TestWorld serialWorld;
+    TestWorld parallelWorld;
+    MakeTestUnits(serialWorld);
+    MakeTestUnits(parallelWorld);
+
+    u32 numAttachmentMismatches = 0;
+    for (u32 frame = 0; frame < NUM_FRAMES; frame++)
+    {
+        UpdateTestWorld(model, serialWorld, nullptr, frame);
+        UpdateTestWorld(model, parallelWorld, &taskScheduler, frame);
+
+        REQUIRE(serialWorld.commits.GetNumCommits() == NUM_UNITS);
+        REQUIRE(parallelWorld.commits.GetNumCommits() == NUM_UNITS);
+
+        for (u32 i = 0; i < NUM_UNITS * 2; i++)
+        {
+            numAttachmentMismatches += !IsAttachmentBitwiseEqual(serialWorld, parallelWorld, i);
+        }
+    }
+
+    u32 numMismatches = 0;
+    u32 numTurnedUnits = 0;
+    for (u32 i = 0; i < NUM_UNITS; i++)
+    {
+        numMismatches += !IsUnitBitwiseEqual(serialWorld, parallelWorld, i);
+        numTurnedUnits += !serialWorld.registry.get<ECS::Components::AnimationData>(static_cast<entt::entity>(i)).proceduralRotationOffsets.empty();
+    }
+
+    CHECK(numMismatches == 0);
+    CHECK(numAttachmentMismatches == 0);
+
+    // Make sure the comparison covered real work, most units strafed at some point, casts finished and attachments moved
+    CHECK(numTurnedUnits > NUM_UNITS / 2);
+    CHECK(serialWorld.registry.view<ECS::Components::CastInfo>().size() < NUM_UNITS / 3 / 2);
+    CHECK(serialWorld.registry.get<ECS::Components::Transform>(serialWorld.attachmentEntities[0]).GetLocalPosition() != vec3(0.0f));
+}
+
+TEST_CASE("Animation variations are picked per instance", "[Unit][Pose]")
+{
+    const Model::ComplexModel model = MakeTestModel();
+
+    u32 numPicks[3] = { 0, 0, 0 };
+    u32 numSamePicks = 0;
+
+    ::Animation::Defines::SequenceID previousPick = ::Animation::Defines::InvalidSequenceID;
+    for (u32 i = 0; i < 300; i++)
+    {
+        u32 randomState = Util::Animation::GetVariationRandomSeed(static_cast<entt::entity>(i));
+
+        i8 timesToRepeat = 0;
+        ::Animation::Defines::SequenceID pick = Util::Animation::GetSequenceIndexForAnimation(&model, ::Animation::Defines::Type::Stand, timesToRepeat, randomState);
+        REQUIRE(pick < 3);
+
+        numPicks[pick]++;
+        numSamePicks += pick == previousPick;
+        previousPick = pick;
+
+        CHECK(timesToRepeat >= 0);
+        CHECK(timesToRepeat <= 3);
+
+        // Starting from the same seed picks the same variation again
+        u32 repeatedState = Util::Animation::GetVariationRandomSeed(static_cast<entt::entity>(i));
+        CHECK(Util::Animation::GetSequenceIndexForAnimation(&model, ::Animation::Defines::Type::Stand, timesToRepeat, repeatedState) == pick);
+    }
+
+    // Neighbouring entities should not all play the same variation
+    CHECK(numPicks[0] > 50);
+    CHECK(numPicks[1] > 50);
+    CHECK(numPicks[2] > 50);
+    CHECK(numSamePicks < 200);
+}
@@ -13,7 +13,8 @@ local modules =
     "ShaderCookerStandalone/ShaderCookerStandalone.lua",
     "Shaders/Shaders.lua",
     "Game-Lib/Game-Lib.lua",
-    "Game-App/Game-App.lua"
+    "Game-App/Game-App.lua",
+    "Game-Bench/Game-Bench.lua"
 }
 
 for _, v in pairs(modules) do